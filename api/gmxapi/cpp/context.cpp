@@ -286,37 +286,41 @@ std::shared_ptr<Session> ContextImpl::launch(const Workflow& work)
          *       Ref: https://gitlab.com/gromacs/gromacs/-/issues/3652
          */
 
+        // Work on a copy of the client arguments, so that the Context can be
+        // reused to launch further sessions without re-setting its arguments.
+        MDArgs mdArgs = mdArgs_;
+
         // Set input TPR name
-        if (std::any_of(mdArgs_.cbegin(), mdArgs_.cend(), [](const std::string& arg) {
+        if (std::any_of(mdArgs.cbegin(), mdArgs.cend(), [](const std::string& arg) {
                 return arg == "-s";
             }))
         {
             throw UsageError("gmxapi must control the simulation input, but caller provided '-s'.");
         }
-        mdArgs_.emplace_back("-s");
-        mdArgs_.emplace_back(filename);
+        mdArgs.emplace_back("-s");
+        mdArgs.emplace_back(filename);
 
         // Set checkpoint file name(s) (if not already set by user).
-        if (std::none_of(mdArgs_.cbegin(), mdArgs_.cend(), [](const std::string& arg) {
+        if (std::none_of(mdArgs.cbegin(), mdArgs.cend(), [](const std::string& arg) {
                 return arg == "-cpi";
             }))
         {
-            mdArgs_.emplace_back("-cpi");
-            mdArgs_.emplace_back("state.cpt");
+            mdArgs.emplace_back("-cpi");
+            mdArgs.emplace_back("state.cpt");
         }
-        if (std::none_of(mdArgs_.cbegin(), mdArgs_.cend(), [](const std::string& arg) {
+        if (std::none_of(mdArgs.cbegin(), mdArgs.cend(), [](const std::string& arg) {
                 return arg == "-cpo";
             }))
         {
-            mdArgs_.emplace_back("-cpo");
-            mdArgs_.emplace_back("state.cpt");
+            mdArgs.emplace_back("-cpo");
+            mdArgs.emplace_back("state.cpt");
         }
-        if (std::none_of(mdArgs_.cbegin(), mdArgs_.cend(), [](const std::string& arg) {
+        if (std::none_of(mdArgs.cbegin(), mdArgs.cend(), [](const std::string& arg) {
                 return arg == "-o";
             }))
         {
-            mdArgs_.emplace_back("-o");
-            mdArgs_.emplace_back("traj.trr");
+            mdArgs.emplace_back("-o");
+            mdArgs.emplace_back("traj.trr");
         }
         /* Note: we normalize the file names, but not the full paths.
          * A future gmxapi version should manage files (paths) in an absolute and
@@ -327,14 +331,14 @@ std::shared_ptr<Session> ContextImpl::launch(const Workflow& work)
 
         // Create a mock argv. Note that argv[0] is expected to hold the program name.
         const int  offset = 1;
-        const auto argc   = static_cast<size_t>(mdArgs_.size() + offset);
+        const auto argc   = static_cast<size_t>(mdArgs.size() + offset);
         auto       argv   = std::vector<char*>(argc, nullptr);
         // argv[0] is ignored, but should be a valid string (e.g. null terminated array of char)
         argv[0]  = new char[1];
         *argv[0] = '\0';
         for (size_t argvIndex = offset; argvIndex < argc; ++argvIndex)
         {
-            const auto& mdArg = mdArgs_[argvIndex - offset];
+            const auto& mdArg = mdArgs[argvIndex - offset];
             argv[argvIndex]   = new char[mdArg.length() + 1];
             strcpy(argv[argvIndex], mdArg.c_str());
         }
@@ -50,4 +50,9 @@ std::shared_ptr<::gmx::IRestraintPotential> MDModule::getRestraint()
     return nullptr;
 }
 
+std::shared_ptr<::gmx::IForceProvider> MDModule::getForceProvider()
+{
+    return nullptr;
+}
+
 } // end namespace gmxapi
@@ -174,12 +174,21 @@ Status SessionImpl::addRestraint(std::shared_ptr<gmxapi::MDModule> module)
     if (module != nullptr)
     {
         const auto& name = module->name();
-        if (restraints_.find(name) == restraints_.end())
+        if (restraints_.find(name) == restraints_.end()
+            && forceProviders_.find(name) == forceProviders_.end())
         {
-            auto restraint = module->getRestraint();
-            if (restraint != nullptr)
+            auto restraint     = module->getRestraint();
+            auto forceProvider = module->getForceProvider();
+            if (restraint != nullptr || forceProvider != nullptr)
             {
-                restraints_.emplace(std::make_pair(name, restraint));
+                if (restraint != nullptr)
+                {
+                    restraints_.emplace(std::make_pair(name, restraint));
+                }
+                if (forceProvider != nullptr)
+                {
+                    forceProviders_.emplace(std::make_pair(name, forceProvider));
+                }
                 auto sessionResources = createResources(module);
                 if (!sessionResources)
                 {
@@ -187,7 +196,14 @@ Status SessionImpl::addRestraint(std::shared_ptr<gmxapi::MDModule> module)
                 }
                 else
                 {
-                    runner_->addPotential(restraint, module->name());
+                    if (restraint != nullptr)
+                    {
+                        runner_->addPotential(restraint, module->name());
+                    }
+                    if (forceProvider != nullptr)
+                    {
+                        runner_->addForceProvider(forceProvider, module->name());
+                    }
                     status = true;
                 }
             }
@@ -129,6 +129,8 @@ public:
     /*!
      * \brief Add a restraint to the simulation.
      *
+     * Registers the restraint and / or the force provider offered by \p module.
+     *
      * \param module
      * \return
      */
@@ -250,6 +252,14 @@ private:
      * which the runner can get objects at run time can encapsulate object management.
      */
     std::map<std::string, std::weak_ptr<gmx::IRestraintPotential>> restraints_;
+
+    /*!
+     * \brief Force providers active in this session.
+     *
+     * Shared with the runner, which registers them with the force calculation
+     * of each PP rank and keeps them alive for the duration of the simulation.
+     */
+    std::map<std::string, std::shared_ptr<gmx::IForceProvider>> forceProviders_;
 };
 
 } // end namespace gmxapi
@@ -43,6 +43,8 @@
 #include "gmxapi/md/mdmodule.h"
 
 #include "gromacs/math/vectypes.h"
+#include "gromacs/mdtypes/forceoutput.h"
+#include "gromacs/mdtypes/iforceprovider.h"
 #include "gromacs/restraint/restraintpotential.h"
 #include "gromacs/utility/arrayref.h"
 
@@ -145,6 +147,93 @@ TEST_F(GmxApiTest, ApiRunnerRestrainedMD)
     }
 }
 
+/*!
+ * \brief Force provider that checks it sees the local arrays of the simulation.
+ */
+class ArrayForceProvider : public gmx::IForceProvider
+{
+public:
+    //! \cond Implement IForceProvider
+    void calculateForces(const gmx::ForceProviderInput& forceProviderInput,
+                         gmx::ForceProviderOutput*      forceProviderOutput) override
+    {
+        auto force = forceProviderOutput->forceWithVirial_.force_;
+        // The provider gets the home atoms and a force buffer covering at least those
+        if (forceProviderInput.homenr_ > 0 && forceProviderInput.x_.ssize() >= forceProviderInput.homenr_
+            && force.ssize() >= forceProviderInput.homenr_)
+        {
+            sawLocalArrays_ = true;
+        }
+        ++numCalls_;
+    }
+    //! \endcond
+
+    //! Number of times calculateForces() was called
+    int numCalls() const { return numCalls_; }
+
+    //! Whether the coordinate and force arrays covered the home atoms in each call
+    bool sawLocalArrays() const { return sawLocalArrays_; }
+
+private:
+    int  numCalls_       = 0;
+    bool sawLocalArrays_ = false;
+};
+
+/*!
+ * \brief Wrap an ArrayForceProvider for testing purposes.
+ */
+class ForceProviderApiModule : public gmxapi::MDModule
+{
+public:
+    /*! \cond
+     * Implement gmxapi::MDModule interface.
+     */
+    ForceProviderApiModule() : forceProvider_(std::make_shared<ArrayForceProvider>()) {}
+
+    const char* name() const override { return "ForceProviderApiModule"; }
+
+    std::shared_ptr<gmx::IForceProvider> getForceProvider() override { return forceProvider_; }
+    //! \endcond
+
+    //! Access the wrapped force provider
+    const ArrayForceProvider& forceProvider() const { return *forceProvider_; }
+
+private:
+    //! force provider to provide to the MD simulator
+    std::shared_ptr<ArrayForceProvider> forceProvider_;
+};
+
+/*!
+ * \brief Check that we can attach a force provider and have it called with the local arrays.
+ */
+TEST_F(GmxApiTest, ApiRunnerForceProviderMD)
+{
+    makeTprFile(2);
+    auto system = gmxapi::fromTprFile(runner_.tprFileName_);
+
+    {
+        auto           context = std::make_shared<gmxapi::Context>(gmxapi::createContext());
+        gmxapi::MDArgs args    = makeMdArgs();
+
+        context->setMDArgs(args);
+
+        auto module = std::make_shared<ForceProviderApiModule>();
+
+        auto session = system.launch(context);
+        EXPECT_TRUE(session != nullptr);
+
+        gmxapi::Status status = gmxapi::addSessionRestraint(session.get(), module);
+        EXPECT_TRUE(status.success());
+        ASSERT_NO_THROW(status = session->run());
+        EXPECT_TRUE(status.success());
+        EXPECT_GT(module->forceProvider().numCalls(), 0);
+        EXPECT_TRUE(module->forceProvider().sawLocalArrays());
+
+        status = session->close();
+        EXPECT_TRUE(status.success());
+    }
+}
+
 } // end anonymous namespace
 
 } // end namespace testing
@@ -142,6 +142,29 @@ TEST_F(GmxApiTest, RunnerReinitialize)
     }
 }
 
+/*!
+ * \brief Check that a Context can launch several sessions with the same arguments.
+ */
+TEST_F(GmxApiTest, RunnerRelaunchSameContext)
+{
+    makeTprFile(2);
+    auto           context = std::make_shared<gmxapi::Context>(gmxapi::createContext());
+    gmxapi::MDArgs args    = makeMdArgs();
+    context->setMDArgs(args);
+
+    for (int launch = 0; launch < 2; launch++)
+    {
+        auto system  = gmxapi::fromTprFile(runner_.tprFileName_);
+        auto session = system.launch(context);
+        EXPECT_TRUE(session != nullptr);
+        gmxapi::Status status;
+        ASSERT_NO_THROW(status = session->run());
+        EXPECT_TRUE(status.success());
+        status = session->close();
+        EXPECT_TRUE(status.success());
+    }
+}
+
 /*!
  * \brief Test chained trajectory segments.
  *
@@ -75,7 +75,7 @@ public:
         mtop_{ std::make_unique<gmx_mtop_t>() },
         state_{ std::make_unique<t_state>() }
     {
-        read_tpx_state(infile.c_str(), irInstance_.get(), state_.get(), mtop_.get());
+        read_tpx_state_no_broadcast(infile.c_str(), irInstance_.get(), state_.get(), mtop_.get());
     }
     ~TprContents()                             = default;
     TprContents(TprContents&& source) noexcept = default;
@@ -762,7 +762,7 @@ bool rewrite_tprfile(const std::string& inFile, const std::string& outFile, doub
     t_inputrec irInstance;
     gmx_mtop_t mtop;
     t_state    state;
-    read_tpx_state(top_fn, &irInstance, &state, &mtop);
+    read_tpx_state_no_broadcast(top_fn, &irInstance, &state, &mtop);
 
     /* set program name, command line, and default values for output options */
     gmx_output_env_t* oenv;
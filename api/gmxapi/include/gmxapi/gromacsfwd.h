@@ -65,6 +65,9 @@ struct t_inputrec;
 namespace gmx
 {
 
+// Forward declaration for libgromacs header gromacs/mdtypes/iforceprovider.h
+class IForceProvider;
+
 // Forward declaration for libgromacs header gromacs/restraint/restraintpotential.h
 class IRestraintPotential;
 
@@ -97,6 +97,26 @@ public:
      * place this git repository is found.
      */
     virtual std::shared_ptr<::gmx::IRestraintPotential> getRestraint();
+
+    /*!
+     * \brief Allows module to provide a force provider operating on whole local arrays.
+     *
+     * To implement a force provider, override this function.
+     * \return shared ownership of a force provider implementation or nullptr if not implemented.
+     *
+     * Whereas a restraint is evaluated for one pair of sites at a time from
+     * positions gathered by the library, a gmx::IForceProvider is registered
+     * directly with the force calculation of each PP rank. Its
+     * calculateForces() receives ArrayRefs to the home-atom coordinates
+     * and to the force buffer of that rank, so collective-variable or
+     * machine-learned force plugins can read and write per-atom data in place
+     * without any per-step copies. As with any force provider, contributions
+     * to the virial must be added by the provider itself.
+     *
+     * With thread-MPI, all ranks of the process call the same object
+     * concurrently, each with its own local data.
+     */
+    virtual std::shared_ptr<::gmx::IForceProvider> getForceProvider();
 };
 
 
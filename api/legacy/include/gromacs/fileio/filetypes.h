@@ -87,6 +87,7 @@ enum GromacsFileType
     efRND,
     efCSV,
     efQMI,
+    efJSON,
     efNR
 };
 
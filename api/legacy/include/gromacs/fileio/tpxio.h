@@ -191,6 +191,22 @@ PbcType completeTprDeserialization(PartialDeserializedTprFile* partialDeserializ
  */
 PartialDeserializedTprFile read_tpx_state(const char* fn, t_inputrec* ir, t_state* state, gmx_mtop_t* mtop);
 
+/*! \brief
+ * Read a file to populate the simulation data structures and close it after reading.
+ *
+ * Same as read_tpx_state(), but for callers that only use the data
+ * on this rank. No serialized copy of \p ir and \p mtop is prepared
+ * for communication to other nodes, which saves a second pass over the
+ * whole topology and a buffer the size of the file body.
+ *
+ * \param[in] fn Input file name.
+ * \param[out] ir Input parameters to be set, or nullptr.
+ * \param[out] state State variables for the simulation.
+ * \param[out] mtop Global simulation topology, or nullptr.
+ * \returns PBC flag.
+ */
+PbcType read_tpx_state_no_broadcast(const char* fn, t_inputrec* ir, t_state* state, gmx_mtop_t* mtop);
+
 /*! \brief
  * Read a file and close it again.
  *
@@ -0,0 +1,475 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2020,2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief Implements a batched force calculator based on GROMACS data structures.
+ */
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "gromacs/mdtypes/atominfo.h"
+#include "gromacs/mdtypes/enerdata.h"
+#include "gromacs/mdtypes/interaction_const.h"
+#include "gromacs/nbnxm/atomdata.h"
+#include "gromacs/nbnxm/nbnxm.h"
+#include "gromacs/nbnxm/pairlistset.h"
+#include "gromacs/nbnxm/pairlistsets.h"
+#include "gromacs/nbnxm/pairsearch.h"
+#include "gromacs/utility/listoflists.h"
+#include "gromacs/utility/range.h"
+#include "nblib/box.h"
+#include "nblib/exception.h"
+#include "nblib/gmxbackenddata.h"
+#include "nblib/gmxcalculatorbatchcpu.h"
+#include "nblib/kerneloptions.h"
+#include "nblib/nbnxmsetuphelpers.h"
+#include "nblib/systemdescription.h"
+#include "nblib/topology.h"
+
+namespace nblib
+{
+
+namespace
+{
+
+/*! \brief Maximum number of systems that share one pairlist and kernel dispatch
+ *
+ * Each system is an energy group. The nbnxm kernels support at most 64 energy
+ * groups, and the temporary energy buffers of the SIMD kernels grow with the
+ * cube of the number of groups, so we stay well below that.
+ */
+constexpr int c_maxNumSystemsPerDispatch = 16;
+
+} // namespace
+
+class GmxNBForceCalculatorBatchCpu::BatchImpl final
+{
+public:
+    BatchImpl(gmx::ArrayRef<int>       particleTypeIdOfAllParticles,
+              gmx::ArrayRef<real>      nonBondedParams,
+              gmx::ArrayRef<real>      charges,
+              gmx::ArrayRef<int>       exclusionRanges,
+              gmx::ArrayRef<int>       exclusionElements,
+              gmx::ArrayRef<const int> systemRanges,
+              const NBKernelOptions&   options);
+
+    //! Returns the number of systems in the batch
+    int numSystems() const { return int(systemRanges_.size()) - 1; }
+
+    //! calculates new pair lists based on new coordinates (for every NS step)
+    void updatePairlist(gmx::ArrayRef<const gmx::RVec> coordinates);
+
+    //! Compute forces and, when energyOutput is not empty, the energies per system
+    void compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                 gmx::ArrayRef<gmx::RVec>       forceOutput,
+                 gmx::ArrayRef<real>            energyOutput);
+
+private:
+    //! \brief A group of systems that share a box, a pairlist and a kernel dispatch
+    struct Dispatch
+    {
+        Dispatch(int                    firstSystemIndex,
+                 int                    numSystemsInDispatch,
+                 gmx::Range<int>        particleRange,
+                 gmx::ArrayRef<int>     particleTypeIdOfAllParticles,
+                 gmx::ArrayRef<real>    nonBondedParams,
+                 gmx::ArrayRef<real>    charges,
+                 gmx::ArrayRef<int64_t> particleInteractionFlags,
+                 gmx::ArrayRef<int>     exclusionRanges,
+                 gmx::ArrayRef<int>     exclusionElements,
+                 const NBKernelOptions& options) :
+            firstSystem(firstSystemIndex),
+            numSystems(numSystemsInDispatch),
+            particles(particleRange),
+            system(particleTypeIdOfAllParticles, nonBondedParams, charges, particleInteractionFlags),
+            backend(options, numSystemsInDispatch, exclusionRanges, exclusionElements),
+            shifts(numSystemsInDispatch),
+            coordinates(particleRange.size())
+        {
+            backend.nbv_ = createNbnxmCPU(
+                    system.numParticleTypes_, options, numSystems, system.nonBondedParams_);
+        }
+
+        //! Index of the first system
+        int firstSystem;
+        //! Number of systems
+        int numSystems;
+        //! Range of the particles of all systems in the batch arrays
+        gmx::Range<int> particles;
+        //! \brief client-side provided system description data
+        SystemDescription system;
+        //! \brief Gmx backend objects, employed for calculating the forces
+        GmxBackendData backend;
+        //! Translation of each system into its cell of the box, set with the pairlist
+        std::vector<gmx::RVec> shifts;
+        //! The translated coordinates of all systems
+        std::vector<gmx::RVec> coordinates;
+    };
+
+    //! Copies the coordinates of the systems of \p dispatch into their cells
+    void translateCoordinates(Dispatch* dispatch, gmx::ArrayRef<const gmx::RVec> coordinates) const;
+
+    //! Offsets of the systems in the particle arrays
+    std::vector<int> systemRanges_;
+
+    //! Pairlist cutoff, used for the spacing of the systems
+    real pairlistCutoff_;
+
+    //! All dispatches, covering the systems in order
+    std::vector<std::unique_ptr<Dispatch>> dispatches_;
+
+    //! Keep track of whether updatePairlist has been called at least once
+    bool updatePairlistCalled_ = false;
+};
+
+GmxNBForceCalculatorBatchCpu::BatchImpl::BatchImpl(gmx::ArrayRef<int>       particleTypeIdOfAllParticles,
+                                                   gmx::ArrayRef<real>      nonBondedParams,
+                                                   gmx::ArrayRef<real>      charges,
+                                                   gmx::ArrayRef<int>       exclusionRanges,
+                                                   gmx::ArrayRef<int>       exclusionElements,
+                                                   gmx::ArrayRef<const int> systemRanges,
+                                                   const NBKernelOptions&   options) :
+    systemRanges_(systemRanges.begin(), systemRanges.end()), pairlistCutoff_(options.pairlistCutoff)
+{
+    const int numParticles = particleTypeIdOfAllParticles.ssize();
+    if (systemRanges_.size() < 2 || systemRanges_.front() != 0
+        || systemRanges_.back() != numParticles
+        || std::adjacent_find(systemRanges_.begin(), systemRanges_.end(), std::greater_equal<>())
+                   != systemRanges_.end())
+    {
+        throw InputException(
+                "System ranges must start at zero, end at the number of particles and contain "
+                "at least one particle per system");
+    }
+    if (charges.ssize() != numParticles || exclusionRanges.ssize() != numParticles + 1)
+    {
+        throw InputException("input array size inconsistent");
+    }
+
+    for (int firstSystem = 0; firstSystem < numSystems(); firstSystem += c_maxNumSystemsPerDispatch)
+    {
+        const int             numSystemsInDispatch =
+                std::min(c_maxNumSystemsPerDispatch, numSystems() - firstSystem);
+        const gmx::Range<int> particles(systemRanges_[firstSystem],
+                                        systemRanges_[firstSystem + numSystemsInDispatch]);
+        const int             particleOffset = *particles.begin();
+
+        // Each system is its own energy group
+        std::vector<int64_t> particleInteractionFlags = createParticleInfoAllVdw(particles.size());
+        std::vector<int>     localExclusionRanges     = { 0 };
+        std::vector<int>     localExclusionElements;
+        for (int s = 0; s < numSystemsInDispatch; s++)
+        {
+            const int systemBegin = systemRanges_[firstSystem + s];
+            const int systemEnd   = systemRanges_[firstSystem + s + 1];
+            for (int i = systemBegin; i < systemEnd; i++)
+            {
+                particleInteractionFlags[i - particleOffset] |= s;
+                for (int e = exclusionRanges[i]; e < exclusionRanges[i + 1]; e++)
+                {
+                    const int j = exclusionElements[e];
+                    if (j < systemBegin || j >= systemEnd)
+                    {
+                        throw InputException(
+                                "Exclusions between different systems of a batch are not "
+                                "supported");
+                    }
+                    localExclusionElements.push_back(j - particleOffset);
+                }
+                localExclusionRanges.push_back(localExclusionElements.size());
+            }
+        }
+
+        dispatches_.push_back(std::make_unique<Dispatch>(
+                firstSystem,
+                numSystemsInDispatch,
+                particles,
+                particleTypeIdOfAllParticles.subArray(particleOffset, particles.size()),
+                nonBondedParams,
+                charges.subArray(particleOffset, particles.size()),
+                particleInteractionFlags,
+                localExclusionRanges,
+                localExclusionElements,
+                options));
+    }
+}
+
+void GmxNBForceCalculatorBatchCpu::BatchImpl::translateCoordinates(Dispatch* dispatch,
+                                                                   gmx::ArrayRef<const gmx::RVec> coordinates) const
+{
+    const int particleOffset = *dispatch->particles.begin();
+    for (int s = 0; s < dispatch->numSystems; s++)
+    {
+        for (int i = systemRanges_[dispatch->firstSystem + s];
+             i < systemRanges_[dispatch->firstSystem + s + 1];
+             i++)
+        {
+            dispatch->coordinates[i - particleOffset] = coordinates[i] + dispatch->shifts[s];
+        }
+    }
+}
+
+void GmxNBForceCalculatorBatchCpu::BatchImpl::updatePairlist(gmx::ArrayRef<const gmx::RVec> coordinates)
+{
+    if (coordinates.ssize() != systemRanges_.back())
+    {
+        throw InputException(
+                "Coordinate array containing different number of entries than particles in the "
+                "batch");
+    }
+
+    for (auto& dispatch : dispatches_)
+    {
+        // Find the bounding box of each system and the largest extent, which sets the cell size
+        std::vector<gmx::RVec> lowerCorners(dispatch->numSystems);
+        real                   maxExtent = 0;
+        for (int s = 0; s < dispatch->numSystems; s++)
+        {
+            gmx::RVec lower = coordinates[systemRanges_[dispatch->firstSystem + s]];
+            gmx::RVec upper = lower;
+            for (int i = systemRanges_[dispatch->firstSystem + s];
+                 i < systemRanges_[dispatch->firstSystem + s + 1];
+                 i++)
+            {
+                for (int d = 0; d < DIM; d++)
+                {
+                    lower[d] = std::min(lower[d], coordinates[i][d]);
+                    upper[d] = std::max(upper[d], coordinates[i][d]);
+                }
+            }
+            lowerCorners[s] = lower;
+            for (int d = 0; d < DIM; d++)
+            {
+                maxExtent = std::max(maxExtent, upper[d] - lower[d]);
+            }
+        }
+
+        // Arrange the cells on a grid that is as close to cubic as possible
+        const int  numSystemsInDispatch = dispatch->numSystems;
+        const real cellSize             = maxExtent + 2 * pairlistCutoff_;
+        const int  numCellsX            = int(std::ceil(std::cbrt(real(numSystemsInDispatch))));
+        const int  numRowsOfCells       = (numSystemsInDispatch + numCellsX - 1) / numCellsX;
+        const int  numCellsY            = std::min(numCellsX, numRowsOfCells);
+        const int  numCellsZ            = (numRowsOfCells + numCellsY - 1) / numCellsY;
+        for (int s = 0; s < numSystemsInDispatch; s++)
+        {
+            const gmx::RVec cellIndex(
+                    s % numCellsX, (s / numCellsX) % numCellsY, s / (numCellsX * numCellsY));
+            for (int d = 0; d < DIM; d++)
+            {
+                // Leave a cutoff to the lower cell boundary, and at least that to the upper one
+                dispatch->shifts[s][d] =
+                        cellIndex[d] * cellSize + pairlistCutoff_ - lowerCorners[s][d];
+            }
+        }
+        const Box box(numCellsX * cellSize, numCellsY * cellSize, numCellsZ * cellSize);
+
+        translateCoordinates(dispatch.get(), coordinates);
+
+        GmxBackendData&    backend   = dispatch->backend;
+        SystemDescription& system    = dispatch->system;
+        const auto*        legacyBox = box.legacyMatrix();
+        system.box_                  = box;
+        updateForcerec(&backend.forcerec_, box.legacyMatrix());
+
+        const rvec lowerCorner = { 0, 0, 0 };
+        const rvec upperCorner = { legacyBox[dimX][dimX], legacyBox[dimY][dimY], legacyBox[dimZ][dimZ] };
+
+        const real particleDensity = static_cast<real>(dispatch->coordinates.size()) / det(legacyBox);
+
+        // Put particles on a grid based on bounds specified by the box
+        nbnxn_put_on_grid(backend.nbv_.get(),
+                          legacyBox,
+                          0,
+                          lowerCorner,
+                          upperCorner,
+                          nullptr,
+                          { 0, int(dispatch->coordinates.size()) },
+                          particleDensity,
+                          system.particleInfo_,
+                          dispatch->coordinates,
+                          0,
+                          nullptr);
+
+        backend.nbv_->constructPairlist(
+                gmx::InteractionLocality::Local, backend.exclusions_, 0, &backend.nrnb_);
+
+        // Set Particle Types and Charges and VdW params
+        backend.nbv_->setAtomProperties(gmx::AtomLocality::Local,
+                                        system.particleTypeIdOfAllParticles_,
+                                        system.charges_,
+                                        system.particleInfo_);
+    }
+    updatePairlistCalled_ = true;
+}
+
+void GmxNBForceCalculatorBatchCpu::BatchImpl::compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                                                      gmx::ArrayRef<gmx::RVec>       forceOutput,
+                                                      gmx::ArrayRef<real>            energyOutput)
+{
+    if (coordinateInput.size() != forceOutput.size()
+        || coordinateInput.ssize() != systemRanges_.back())
+    {
+        throw InputException("coordinate array and force buffer size mismatch");
+    }
+
+    if (!updatePairlistCalled_)
+    {
+        throw InputException("compute called without updating pairlist at least once");
+    }
+
+    constexpr int numEnergyTerms  = static_cast<int>(NonBondedEnergyTerms::Count);
+    const bool    computeEnergies = !energyOutput.empty();
+    if (computeEnergies && energyOutput.ssize() != numEnergyTerms * numSystems())
+    {
+        throw InputException("Array size for energy output is wrong\n");
+    }
+
+    for (auto& dispatch : dispatches_)
+    {
+        GmxBackendData& backend         = dispatch->backend;
+        backend.stepWork_.computeVirial = false;
+        backend.stepWork_.computeEnergy = computeEnergies;
+
+        // Move the systems into the cells used for the pairlist
+        translateCoordinates(dispatch.get(), coordinateInput);
+        backend.nbv_->convertCoordinates(gmx::AtomLocality::Local, dispatch->coordinates);
+
+        // The kernels accumulate the energies
+        for (auto& terms : backend.enerd_.grpp.energyGroupPairTerms)
+        {
+            std::fill(terms.begin(), terms.end(), 0);
+        }
+
+        backend.nbv_->dispatchNonbondedKernel(
+                gmx::InteractionLocality::Local,
+                backend.interactionConst_,
+                backend.stepWork_,
+                enbvClearFYes,
+                backend.forcerec_.shift_vec,
+                backend.enerd_.grpp.energyGroupPairTerms[backend.forcerec_.haveBuckingham ? NonBondedEnergyTerms::BuckinghamSR
+                                                                                          : NonBondedEnergyTerms::LJSR],
+                backend.enerd_.grpp.energyGroupPairTerms[NonBondedEnergyTerms::CoulombSR],
+                &backend.nrnb_);
+
+        backend.nbv_->atomdata_add_nbat_f_to_f(
+                gmx::AtomLocality::All,
+                forceOutput.subArray(*dispatch->particles.begin(), dispatch->particles.size()));
+
+        // The systems are out of range of each other, so only the diagonal group pairs contribute
+        if (computeEnergies)
+        {
+            const int numGroups = dispatch->numSystems;
+            for (int s = 0; s < numGroups; s++)
+            {
+                for (int eg = 0; eg < numEnergyTerms; ++eg)
+                {
+                    energyOutput[(dispatch->firstSystem + s) * numEnergyTerms + eg] =
+                            backend.enerd_.grpp.energyGroupPairTerms[eg][s * numGroups + s];
+                }
+            }
+        }
+    }
+}
+
+GmxNBForceCalculatorBatchCpu::GmxNBForceCalculatorBatchCpu(gmx::ArrayRef<int>  particleTypeIdOfAllParticles,
+                                                           gmx::ArrayRef<real> nonBondedParams,
+                                                           gmx::ArrayRef<real> charges,
+                                                           gmx::ArrayRef<int>  exclusionRanges,
+                                                           gmx::ArrayRef<int>  exclusionElements,
+                                                           gmx::ArrayRef<const int> systemRanges,
+                                                           const NBKernelOptions&   options)
+{
+    if (options.useGpu)
+    {
+        throw InputException("The batched force calculator only supports the CPU");
+    }
+
+    impl_ = std::make_unique<BatchImpl>(particleTypeIdOfAllParticles,
+                                        nonBondedParams,
+                                        charges,
+                                        exclusionRanges,
+                                        exclusionElements,
+                                        systemRanges,
+                                        options);
+}
+
+GmxNBForceCalculatorBatchCpu::~GmxNBForceCalculatorBatchCpu() = default;
+
+int GmxNBForceCalculatorBatchCpu::numSystems() const
+{
+    return impl_->numSystems();
+}
+
+//! calculates new pair lists based on new coordinates (for every NS step)
+void GmxNBForceCalculatorBatchCpu::updatePairlist(gmx::ArrayRef<const gmx::RVec> coordinates)
+{
+    impl_->updatePairlist(coordinates);
+}
+
+//! Compute forces of all systems
+void GmxNBForceCalculatorBatchCpu::compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                                           gmx::ArrayRef<gmx::RVec>       forceOutput)
+{
+    impl_->compute(coordinateInput, forceOutput, gmx::ArrayRef<real>{});
+}
+
+//! Compute forces and potential energies of all systems
+void GmxNBForceCalculatorBatchCpu::compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                                           gmx::ArrayRef<gmx::RVec>       forceOutput,
+                                           gmx::ArrayRef<real>            energyOutput)
+{
+    impl_->compute(coordinateInput, forceOutput, energyOutput);
+}
+
+std::unique_ptr<GmxNBForceCalculatorBatchCpu>
+setupGmxForceCalculatorBatchCpu(const Topology&          topology,
+                                gmx::ArrayRef<const int> systemRanges,
+                                const NBKernelOptions&   options)
+{
+    std::vector<real> nonBondedParameters = createNonBondedParameters(
+            topology.getParticleTypes(), topology.getNonBondedInteractionMap());
+
+    return std::make_unique<GmxNBForceCalculatorBatchCpu>(topology.getParticleTypeIdOfAllParticles(),
+                                                          nonBondedParameters,
+                                                          topology.getCharges(),
+                                                          topology.exclusionLists().ListRanges,
+                                                          topology.exclusionLists().ListElements,
+                                                          systemRanges,
+                                                          options);
+}
+
+} // namespace nblib
@@ -0,0 +1,132 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2020,2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \libinternal \file
+ * \brief
+ * Implements a force calculator that evaluates a batch of small, independent
+ * systems with shared pairlists and kernel dispatches.
+ */
+
+#ifndef NBLIB_GMXCALCULATORBATCHCPU_H
+#define NBLIB_GMXCALCULATORBATCHCPU_H
+
+#include <memory>
+#include <vector>
+
+#include "nblib/vector.h"
+
+namespace gmx
+{
+template<typename T>
+class ArrayRef;
+} // namespace gmx
+
+namespace nblib
+{
+struct NBKernelOptions;
+class Topology;
+
+/*! \brief Evaluates the non-bonded forces of many independent systems at once
+ *
+ * For systems of a few hundred to a few thousand particles, e.g. conformers of
+ * a ligand or clusters for ML data sets, the per-call overhead of
+ * GmxNBForceCalculatorCpu dominates. This calculator places groups of systems
+ * into separate cells of one box, so that each group shares one pairlist search
+ * and one kernel dispatch. Each system of a group is its own energy group, which
+ * provides the energies per system.
+ *
+ * The systems are isolated: a system interacts neither with the other systems
+ * nor with periodic images of itself. The cells leave twice the pairlist cutoff
+ * between systems, so the particles can move by up to a cutoff between
+ * pairlist updates without systems coming within range of each other.
+ *
+ * All particle arrays hold the systems one after another, as given by the
+ * system ranges.
+ */
+class GmxNBForceCalculatorBatchCpu final
+{
+public:
+    /*! \brief Sets up the batch
+     *
+     * \param[in] systemRanges  numSystems + 1 offsets into the particle arrays;
+     *                          system s holds the particles systemRanges[s] up to,
+     *                          but not including, systemRanges[s + 1]
+     *
+     * The other arguments are those of GmxNBForceCalculatorCpu for all particles
+     * of the batch. Exclusions must not connect particles of different systems.
+     */
+    GmxNBForceCalculatorBatchCpu(gmx::ArrayRef<int>       particleTypeIdOfAllParticles,
+                                 gmx::ArrayRef<real>      nonBondedParams,
+                                 gmx::ArrayRef<real>      charges,
+                                 gmx::ArrayRef<int>       exclusionRanges,
+                                 gmx::ArrayRef<int>       exclusionElements,
+                                 gmx::ArrayRef<const int> systemRanges,
+                                 const NBKernelOptions&   options);
+
+    ~GmxNBForceCalculatorBatchCpu();
+
+    //! Returns the number of systems in the batch
+    int numSystems() const;
+
+    //! calculates new pair lists based on new coordinates of all systems (for every NS step)
+    void updatePairlist(gmx::ArrayRef<const gmx::RVec> coordinates);
+
+    //! Compute forces of all systems and add them to the output
+    void compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                 gmx::ArrayRef<gmx::RVec>       forceOutput);
+
+    /*! \brief Compute forces and potential energies of all systems
+     *
+     * \p energyOutput holds the NonBondedEnergyTerms::Count energy terms of
+     * each system, system after system.
+     */
+    void compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                 gmx::ArrayRef<gmx::RVec>       forceOutput,
+                 gmx::ArrayRef<real>            energyOutput);
+
+private:
+    //! Private implementation
+    class BatchImpl;
+    std::unique_ptr<BatchImpl> impl_;
+};
+
+//! Sets up and returns a batch force calculator for the systems of a Topology
+std::unique_ptr<GmxNBForceCalculatorBatchCpu>
+setupGmxForceCalculatorBatchCpu(const Topology&          topology,
+                                gmx::ArrayRef<const int> systemRanges,
+                                const NBKernelOptions&   options);
+
+} // namespace nblib
+
+#endif // NBLIB_GMXCALCULATORBATCHCPU_H
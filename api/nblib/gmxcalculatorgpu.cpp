@@ -0,0 +1,500 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2020,2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief Implements a GPU force calculator based on GROMACS data structures.
+ */
+#include <algorithm>
+#include <vector>
+
+#include "gromacs/gpu_utils/device_stream.h"
+#include "gromacs/gpu_utils/device_stream_manager.h"
+#include "gromacs/gpu_utils/gpueventsynchronizer.h"
+#include "gromacs/hardware/device_management.h"
+#include "gromacs/mdlib/gpuforcereduction.h"
+#include "gromacs/mdtypes/enerdata.h"
+#include "gromacs/mdtypes/interaction_const.h"
+#include "gromacs/nbnxm/atomdata.h"
+#include "gromacs/nbnxm/gpu_data_mgmt.h"
+#include "gromacs/nbnxm/nbnxm.h"
+#include "gromacs/nbnxm/nbnxm_gpu.h"
+#include "gromacs/nbnxm/pairlistset.h"
+#include "gromacs/nbnxm/pairlistsets.h"
+#include "gromacs/nbnxm/pairsearch.h"
+#include "gromacs/utility/listoflists.h"
+#include "gromacs/utility/range.h"
+#include "nblib/exception.h"
+#include "nblib/gmxbackenddata.h"
+#include "nblib/gmxcalculatorgpu.h"
+#include "nblib/nbnxmsetuphelpers.h"
+#include "nblib/pbc.hpp"
+#include "nblib/systemdescription.h"
+#include "nblib/topology.h"
+#include "nblib/tpr.h"
+#include "nblib/virials.h"
+
+namespace nblib
+{
+
+class GmxNBForceCalculatorGpu::GpuImpl final
+{
+public:
+    GpuImpl(gmx::ArrayRef<int>       particleTypeIdOfAllParticles,
+            gmx::ArrayRef<real>      nonBondedParams,
+            gmx::ArrayRef<real>      charges,
+            gmx::ArrayRef<int64_t>   particleInteractionFlags,
+            gmx::ArrayRef<int>       exclusionRanges,
+            gmx::ArrayRef<int>       exclusionElements,
+            const NBKernelOptions&   options,
+            const DeviceInformation& deviceInfo);
+
+    //! calculates a new pair list based on new coordinates (for every NS step)
+    void updatePairlist(gmx::ArrayRef<gmx::RVec> coordinates, const Box& box);
+
+    //! Compute forces, virial tensor and potential energies with host input and output
+    void compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                 const Box&                     box,
+                 gmx::ArrayRef<gmx::RVec>       forceOutput,
+                 gmx::ArrayRef<real>            virialOutput,
+                 gmx::ArrayRef<real>            energyOutput);
+
+    //! Compute forces and potential energies with device input and output
+    void computeOnDevice(const gmx::RVec*    deviceCoordinates,
+                         const Box&          box,
+                         gmx::RVec*          deviceForces,
+                         gmx::ArrayRef<real> energyOutput);
+
+private:
+    //! Checks the call order and applies a changed box
+    void prepareStep(const Box& box, bool computeVirial, gmx::ArrayRef<real> energyOutput);
+
+    //! Launches the non-bonded kernel, waits for it and collects the energies
+    void launchAndWait(gmx::ArrayRef<gmx::RVec> shiftForces, gmx::ArrayRef<real> energyOutput);
+
+    //! \brief client-side provided system description data
+    SystemDescription system_;
+
+    //! \brief Device streams, must outlive the GPU data in the backend
+    std::shared_ptr<gmx::DeviceStreamManager> deviceStreamManager_;
+
+    //! \brief Gmx backend objects, employed for calculating the forces
+    GmxBackendData backend_;
+
+    //! \brief Reduces the nbnxm-layout device forces into the caller's device buffer
+    std::unique_ptr<gmx::GpuForceReduction> forceReduction_;
+
+    //! \brief Marks the caller's device coordinates as ready for the layout conversion
+    GpuEventSynchronizer xReadyOnDevice_;
+
+    //! \brief Device force buffer the reduction was set up for, reset on every pairlist update
+    gmx::RVec* reductionTarget_ = nullptr;
+};
+
+GmxNBForceCalculatorGpu::GpuImpl::GpuImpl(gmx::ArrayRef<int>       particleTypeIdOfAllParticles,
+                                          gmx::ArrayRef<real>      nonBondedParams,
+                                          gmx::ArrayRef<real>      charges,
+                                          gmx::ArrayRef<int64_t>   particleInteractionFlags,
+                                          gmx::ArrayRef<int>       exclusionRanges,
+                                          gmx::ArrayRef<int>       exclusionElements,
+                                          const NBKernelOptions&   options,
+                                          const DeviceInformation& deviceInfo) :
+    system_(SystemDescription(particleTypeIdOfAllParticles, nonBondedParams, charges, particleInteractionFlags)),
+    backend_(GmxBackendData(options, findNumEnergyGroups(particleInteractionFlags), exclusionRanges, exclusionElements))
+{
+    if (findNumEnergyGroups(particleInteractionFlags) > 1)
+    {
+        throw InputException("Multiple energy groups are not supported on the GPU");
+    }
+
+    setActiveDevice(deviceInfo);
+    backend_.simulationWork_ = createSimulationWorkloadGpu();
+    deviceStreamManager_     = createDeviceStreamManager(deviceInfo, backend_.simulationWork_);
+
+    // Set up non-bonded verlet on the GPU in the backend
+    backend_.nbv_ = createNbnxmGPU(system_.numParticleTypes_,
+                                   options,
+                                   system_.nonBondedParams_,
+                                   backend_.interactionConst_,
+                                   *deviceStreamManager_);
+
+    forceReduction_ = std::make_unique<gmx::GpuForceReduction>(
+            deviceStreamManager_->context(),
+            deviceStreamManager_->stream(gmx::DeviceStreamType::NonBondedLocal),
+            nullptr);
+}
+
+void GmxNBForceCalculatorGpu::GpuImpl::updatePairlist(gmx::ArrayRef<gmx::RVec> coordinates, const Box& box)
+{
+    if (coordinates.size() != system_.numParticles_)
+    {
+        throw InputException(
+                "Coordinate array containing different number of entries than particles in the "
+                "system");
+    }
+
+    const auto* legacyBox = box.legacyMatrix();
+    system_.box_          = box;
+    updateForcerec(&backend_.forcerec_, box.legacyMatrix());
+    if (TRICLINIC(legacyBox))
+    {
+        throw InputException("Only rectangular unit-cells are supported here");
+    }
+
+    const rvec lowerCorner = { 0, 0, 0 };
+    const rvec upperCorner = { legacyBox[dimX][dimX], legacyBox[dimY][dimY], legacyBox[dimZ][dimZ] };
+
+    const real particleDensity = static_cast<real>(coordinates.size()) / det(legacyBox);
+
+    // If particles are too far outside the box, the grid setup can fail
+    put_atoms_in_box_omp(PbcType::Xyz, box.legacyMatrix(), coordinates, backend_.numThreads_);
+
+    // Put particles on a grid based on bounds specified by the box
+    nbnxn_put_on_grid(backend_.nbv_.get(),
+                      legacyBox,
+                      0,
+                      lowerCorner,
+                      upperCorner,
+                      nullptr,
+                      { 0, int(coordinates.size()) },
+                      particleDensity,
+                      system_.particleInfo_,
+                      coordinates,
+                      0,
+                      nullptr);
+
+    // Also uploads the pairlist to the GPU
+    backend_.nbv_->constructPairlist(
+            gmx::InteractionLocality::Local, backend_.exclusions_, 0, &backend_.nrnb_);
+    backend_.nbv_->setupGpuShortRangeWork(nullptr, gmx::InteractionLocality::Local);
+
+    // Set Particle Types and Charges and VdW params
+    backend_.nbv_->setAtomProperties(gmx::AtomLocality::Local,
+                                     system_.particleTypeIdOfAllParticles_,
+                                     system_.charges_,
+                                     system_.particleInfo_);
+
+    // Upload the atom data that only changes with the pairlist and clear the output buffers
+    NbnxmGpu* nbnxmGpu = backend_.nbv_->gpu_nbv;
+    Nbnxm::gpu_init_atomdata(nbnxmGpu, backend_.nbv_->nbat.get());
+    nbnxn_atomdata_copy_shiftvec(true, backend_.forcerec_.shift_vec, backend_.nbv_->nbat.get());
+    Nbnxm::gpu_upload_shiftvec(nbnxmGpu, backend_.nbv_->nbat.get());
+    Nbnxm::gpu_clear_outputs(nbnxmGpu, true);
+
+    // The charges are only uploaded with the coordinates; the device-side coordinate
+    // conversion of later steps only overwrites the positions.
+    backend_.nbv_->convertCoordinates(gmx::AtomLocality::Local, coordinates);
+    Nbnxm::gpu_copy_xq_to_gpu(nbnxmGpu, backend_.nbv_->nbat.get(), gmx::AtomLocality::Local);
+    backend_.nbv_->atomdata_init_copy_x_to_nbat_x_gpu();
+
+    // The grid indices of the particles changed, so the force reduction must be set up again
+    reductionTarget_ = nullptr;
+
+    backend_.updatePairlistCalled = true;
+}
+
+void GmxNBForceCalculatorGpu::GpuImpl::prepareStep(const Box&          box,
+                                                   bool                computeVirial,
+                                                   gmx::ArrayRef<real> energyOutput)
+{
+    if (!backend_.updatePairlistCalled)
+    {
+        throw InputException("compute called without updating pairlist at least once");
+    }
+
+    const int numEnergyGroupPairs = backend_.enerd_.grpp.nener;
+    if (!energyOutput.empty()
+        && int(energyOutput.size()) != int(NonBondedEnergyTerms::Count) * numEnergyGroupPairs)
+    {
+        throw InputException("Array size for energy output is wrong\n");
+    }
+
+    // update the box if changed, the shift vectors are only uploaded again in that case
+    const bool boxChanged = !(system_.box_ == box);
+    if (boxChanged)
+    {
+        system_.box_ = box;
+        updateForcerec(&backend_.forcerec_, box.legacyMatrix());
+    }
+    nbnxn_atomdata_copy_shiftvec(
+            boxChanged, backend_.forcerec_.shift_vec, backend_.nbv_->nbat.get());
+    Nbnxm::gpu_upload_shiftvec(backend_.nbv_->gpu_nbv, backend_.nbv_->nbat.get());
+
+    backend_.stepWork_.computeVirial = computeVirial;
+    backend_.stepWork_.computeEnergy = !energyOutput.empty();
+}
+
+void GmxNBForceCalculatorGpu::GpuImpl::launchAndWait(gmx::ArrayRef<gmx::RVec> shiftForces,
+                                                     gmx::ArrayRef<real>      energyOutput)
+{
+    NbnxmGpu* nbnxmGpu = backend_.nbv_->gpu_nbv;
+
+    backend_.nbv_->dispatchNonbondedKernel(
+            gmx::InteractionLocality::Local,
+            backend_.interactionConst_,
+            backend_.stepWork_,
+            enbvClearFYes,
+            backend_.forcerec_.shift_vec,
+            backend_.enerd_.grpp.energyGroupPairTerms[NonBondedEnergyTerms::LJSR],
+            backend_.enerd_.grpp.energyGroupPairTerms[NonBondedEnergyTerms::CoulombSR],
+            &backend_.nrnb_);
+
+    Nbnxm::gpu_launch_cpyback(
+            nbnxmGpu, backend_.nbv_->nbat.get(), backend_.stepWork_, gmx::AtomLocality::Local);
+
+    if (backend_.stepWork_.useGpuFBufferOps)
+    {
+        forceReduction_->execute();
+    }
+
+    real energyLJ      = 0;
+    real energyCoulomb = 0;
+    Nbnxm::gpu_wait_finish_task(nbnxmGpu,
+                                backend_.stepWork_,
+                                gmx::AtomLocality::Local,
+                                &energyLJ,
+                                &energyCoulomb,
+                                shiftForces,
+                                nullptr);
+
+    // With device-resident forces the wait above can be skipped by the module
+    if (backend_.stepWork_.useGpuFBufferOps)
+    {
+        deviceStreamManager_->stream(gmx::DeviceStreamType::NonBondedLocal).synchronize();
+    }
+
+    // The kernel accumulates into the device output buffers
+    Nbnxm::gpu_clear_outputs(nbnxmGpu, backend_.stepWork_.computeVirial);
+
+    if (!energyOutput.empty())
+    {
+        // multiple energy groups are not supported on the GPU, so there is a single group pair
+        std::fill(energyOutput.begin(), energyOutput.end(), 0);
+        energyOutput[static_cast<int>(NonBondedEnergyTerms::LJSR)]      = energyLJ;
+        energyOutput[static_cast<int>(NonBondedEnergyTerms::CoulombSR)] = energyCoulomb;
+    }
+}
+
+void GmxNBForceCalculatorGpu::GpuImpl::compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                                               const Box&                     box,
+                                               gmx::ArrayRef<gmx::RVec>       forceOutput,
+                                               gmx::ArrayRef<real>            virialOutput,
+                                               gmx::ArrayRef<real>            energyOutput)
+{
+    if (coordinateInput.size() != forceOutput.size())
+    {
+        throw InputException("coordinate array and force buffer size mismatch");
+    }
+
+    const bool computeVirial = !virialOutput.empty();
+    prepareStep(box, computeVirial, energyOutput);
+    backend_.stepWork_.useGpuXBufferOps = false;
+    backend_.stepWork_.useGpuFBufferOps = false;
+
+    // update the coordinates in the backend and upload them
+    backend_.nbv_->convertCoordinates(gmx::AtomLocality::Local, coordinateInput);
+    Nbnxm::gpu_copy_xq_to_gpu(
+            backend_.nbv_->gpu_nbv, backend_.nbv_->nbat.get(), gmx::AtomLocality::Local);
+
+    std::vector<Vec3> shiftForcesVector(gmx::c_numShiftVectors, Vec3(0.0, 0.0, 0.0));
+    launchAndWait(shiftForcesVector, energyOutput);
+
+    // the forces were copied back into the nbnxm layout on the host
+    backend_.nbv_->atomdata_add_nbat_f_to_f(gmx::AtomLocality::All, forceOutput);
+
+    if (computeVirial)
+    {
+        auto shiftForcesRef = constArrayRefFromArray(shiftForcesVector.data(), shiftForcesVector.size());
+
+        std::vector<Vec3> shiftVectorsArray(gmx::c_numShiftVectors);
+
+        // copy shift vectors from ForceRec
+        std::copy(backend_.forcerec_.shift_vec.begin(),
+                  backend_.forcerec_.shift_vec.end(),
+                  shiftVectorsArray.begin());
+
+        computeVirialTensor(
+                coordinateInput, forceOutput, shiftVectorsArray, shiftForcesRef, box, virialOutput);
+    }
+}
+
+void GmxNBForceCalculatorGpu::GpuImpl::computeOnDevice(const gmx::RVec*    deviceCoordinates,
+                                                       const Box&          box,
+                                                       gmx::RVec*          deviceForces,
+                                                       gmx::ArrayRef<real> energyOutput)
+{
+    if (deviceCoordinates == nullptr || deviceForces == nullptr)
+    {
+        throw InputException("computeOnDevice needs valid device coordinate and force buffers");
+    }
+
+    prepareStep(box, false, energyOutput);
+    backend_.stepWork_.useGpuXBufferOps = true;
+    backend_.stepWork_.useGpuFBufferOps = true;
+
+    const DeviceStream& localStream =
+            deviceStreamManager_->stream(gmx::DeviceStreamType::NonBondedLocal);
+
+    // Convert the caller's coordinates into the nbnxm layout directly on the device
+    xReadyOnDevice_.markEvent(localStream);
+    backend_.nbv_->convertCoordinatesGpu(gmx::AtomLocality::Local,
+                                         const_cast<gmx::RVec*>(deviceCoordinates),
+                                         &xReadyOnDevice_);
+
+    if (deviceForces != reductionTarget_)
+    {
+        // as on the host, the forces are added to the caller buffer in the original particle order
+        forceReduction_->reinit(deviceForces,
+                                backend_.nbv_->getNumAtoms(gmx::AtomLocality::Local),
+                                backend_.nbv_->getGridIndices(),
+                                0,
+                                true);
+        forceReduction_->registerNbnxmForce(Nbnxm::gpu_get_f(backend_.nbv_->gpu_nbv));
+        reductionTarget_ = deviceForces;
+    }
+
+    launchAndWait(gmx::ArrayRef<gmx::RVec>{}, energyOutput);
+}
+
+GmxNBForceCalculatorGpu::GmxNBForceCalculatorGpu(gmx::ArrayRef<int>  particleTypeIdOfAllParticles,
+                                                 gmx::ArrayRef<real> nonBondedParams,
+                                                 gmx::ArrayRef<real> charges,
+                                                 gmx::ArrayRef<int64_t>   particleInteractionFlags,
+                                                 gmx::ArrayRef<int>       exclusionRanges,
+                                                 gmx::ArrayRef<int>       exclusionElements,
+                                                 const NBKernelOptions&   options,
+                                                 const DeviceInformation& deviceInfo)
+{
+    if (!options.useGpu)
+    {
+        throw InputException("Use GmxNBForceCalculatorCpu for CPU support");
+    }
+
+    impl_ = std::make_unique<GpuImpl>(particleTypeIdOfAllParticles,
+                                      nonBondedParams,
+                                      charges,
+                                      particleInteractionFlags,
+                                      exclusionRanges,
+                                      exclusionElements,
+                                      options,
+                                      deviceInfo);
+}
+
+GmxNBForceCalculatorGpu::~GmxNBForceCalculatorGpu() = default;
+
+//! calculates a new pair list based on new coordinates (for every NS step)
+void GmxNBForceCalculatorGpu::updatePairlist(gmx::ArrayRef<gmx::RVec> coordinates, const Box& box)
+{
+    impl_->updatePairlist(coordinates, box);
+}
+
+//! Compute forces and return
+void GmxNBForceCalculatorGpu::compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                                      const Box&                     box,
+                                      gmx::ArrayRef<gmx::RVec>       forceOutput)
+{
+    impl_->compute(coordinateInput, box, forceOutput, gmx::ArrayRef<real>{}, gmx::ArrayRef<real>{});
+}
+
+//! Compute forces and virial tensor
+void GmxNBForceCalculatorGpu::compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                                      const Box&                     box,
+                                      gmx::ArrayRef<gmx::RVec>       forceOutput,
+                                      gmx::ArrayRef<real>            virialOutput)
+{
+    impl_->compute(coordinateInput, box, forceOutput, virialOutput, gmx::ArrayRef<real>{});
+}
+
+//! Compute forces, virial tensor and potential energies
+void GmxNBForceCalculatorGpu::compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                                      const Box&                     box,
+                                      gmx::ArrayRef<gmx::RVec>       forceOutput,
+                                      gmx::ArrayRef<real>            virialOutput,
+                                      gmx::ArrayRef<real>            energyOutput)
+{
+    impl_->compute(coordinateInput, box, forceOutput, virialOutput, energyOutput);
+}
+
+//! Compute forces from device-resident coordinates into device-resident forces
+void GmxNBForceCalculatorGpu::computeOnDevice(const gmx::RVec* deviceCoordinates,
+                                              const Box&       box,
+                                              gmx::RVec*       deviceForces)
+{
+    impl_->computeOnDevice(deviceCoordinates, box, deviceForces, gmx::ArrayRef<real>{});
+}
+
+//! Compute forces and potential energies from device-resident coordinates
+void GmxNBForceCalculatorGpu::computeOnDevice(const gmx::RVec*    deviceCoordinates,
+                                              const Box&          box,
+                                              gmx::RVec*          deviceForces,
+                                              gmx::ArrayRef<real> energyOutput)
+{
+    impl_->computeOnDevice(deviceCoordinates, box, deviceForces, energyOutput);
+}
+
+std::unique_ptr<GmxNBForceCalculatorGpu>
+setupGmxForceCalculatorGpu(const Topology&          topology,
+                           const NBKernelOptions&   options,
+                           const DeviceInformation& deviceInfo)
+{
+    std::vector<real> nonBondedParameters = createNonBondedParameters(
+            topology.getParticleTypes(), topology.getNonBondedInteractionMap());
+
+    std::vector<int64_t> particleInteractionFlags = createParticleInfoAllVdw(topology.numParticles());
+
+    return std::make_unique<GmxNBForceCalculatorGpu>(topology.getParticleTypeIdOfAllParticles(),
+                                                     nonBondedParameters,
+                                                     topology.getCharges(),
+                                                     particleInteractionFlags,
+                                                     topology.exclusionLists().ListRanges,
+                                                     topology.exclusionLists().ListElements,
+                                                     options,
+                                                     deviceInfo);
+}
+
+std::unique_ptr<GmxNBForceCalculatorGpu>
+setupGmxForceCalculatorGpu(TprReader&               tprReader,
+                           const NBKernelOptions&   options,
+                           const DeviceInformation& deviceInfo)
+{
+    return std::make_unique<GmxNBForceCalculatorGpu>(tprReader.particleTypeIdOfAllParticles_,
+                                                     tprReader.nonbondedParameters_,
+                                                     tprReader.charges_,
+                                                     tprReader.particleInteractionFlags_,
+                                                     tprReader.exclusionListRanges_,
+                                                     tprReader.exclusionListElements_,
+                                                     options,
+                                                     deviceInfo);
+}
+
+} // namespace nblib
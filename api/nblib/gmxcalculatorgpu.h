@@ -0,0 +1,140 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2020,2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \libinternal \file
+ * \brief
+ * Implements a GPU force calculator based on GROMACS data structures.
+ *
+ * Only available in CUDA and HIP builds.
+ */
+
+#ifndef NBLIB_GMXCALCULATORGPU_H
+#define NBLIB_GMXCALCULATORGPU_H
+
+#include <memory>
+#include <vector>
+
+#include "nblib/box.h"
+#include "nblib/vector.h"
+
+struct DeviceInformation;
+
+namespace gmx
+{
+template<typename T>
+class ArrayRef;
+} // namespace gmx
+
+namespace nblib
+{
+struct NBKernelOptions;
+class Topology;
+struct TprReader;
+
+class GmxNBForceCalculatorGpu final
+{
+public:
+    GmxNBForceCalculatorGpu(gmx::ArrayRef<int>       particleTypeIdOfAllParticles,
+                            gmx::ArrayRef<real>      nonBondedParams,
+                            gmx::ArrayRef<real>      charges,
+                            gmx::ArrayRef<int64_t>   particleInteractionFlags,
+                            gmx::ArrayRef<int>       exclusionRanges,
+                            gmx::ArrayRef<int>       exclusionElements,
+                            const NBKernelOptions&   options,
+                            const DeviceInformation& deviceInfo);
+
+    ~GmxNBForceCalculatorGpu();
+
+    //! calculates a new pair list based on new coordinates (for every NS step)
+    void updatePairlist(gmx::ArrayRef<gmx::RVec> coordinates, const Box& box);
+
+    //! Compute forces and return
+    void compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                 const Box&                     box,
+                 gmx::ArrayRef<gmx::RVec>       forceOutput);
+
+    //! Compute forces and virial tensor
+    void compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                 const Box&                     box,
+                 gmx::ArrayRef<gmx::RVec>       forceOutput,
+                 gmx::ArrayRef<real>            virialOutput);
+
+    //! Compute forces, virial tensor and potential energies
+    void compute(gmx::ArrayRef<const gmx::RVec> coordinateInput,
+                 const Box&                     box,
+                 gmx::ArrayRef<gmx::RVec>       forceOutput,
+                 gmx::ArrayRef<real>            virialOutput,
+                 gmx::ArrayRef<real>            energyOutput);
+
+    /*! \brief Compute forces from device-resident coordinates into device-resident forces
+     *
+     * \p deviceCoordinates and \p deviceForces are device pointers to numParticles
+     * packed RVec entries in the same particle order as used for updatePairlist,
+     * e.g. the data pointer of a DLPack tensor or of a \c __cuda_array_interface__.
+     * No host copies of coordinates or forces are made. As with compute(), the forces
+     * are added to \p deviceForces. The coordinates must be ready on the device when
+     * this is called, the forces are ready on return.
+     * Virials are not available with device-resident output.
+     */
+    void computeOnDevice(const gmx::RVec* deviceCoordinates,
+                         const Box&       box,
+                         gmx::RVec*       deviceForces);
+
+    //! Compute forces and potential energies from device-resident coordinates
+    void computeOnDevice(const gmx::RVec*    deviceCoordinates,
+                         const Box&          box,
+                         gmx::RVec*          deviceForces,
+                         gmx::ArrayRef<real> energyOutput);
+
+private:
+    //! Private implementation
+    class GpuImpl;
+    std::unique_ptr<GpuImpl> impl_;
+};
+
+//! Sets up and returns a GmxForceCalculatorGpu based on a Topology as input
+std::unique_ptr<GmxNBForceCalculatorGpu>
+setupGmxForceCalculatorGpu(const Topology&          topology,
+                           const NBKernelOptions&   options,
+                           const DeviceInformation& deviceInfo);
+
+//! Sets up and returns a GmxForceCalculatorGpu based on a TPR file as input
+std::unique_ptr<GmxNBForceCalculatorGpu>
+setupGmxForceCalculatorGpu(TprReader&               tprReader,
+                           const NBKernelOptions&   options,
+                           const DeviceInformation& deviceInfo);
+
+} // namespace nblib
+
+#endif // NBLIB_GMXCALCULATORGPU_H
@@ -168,20 +168,15 @@ void ListedForceCalculator::computeForcesAndEnergies(gmx::ArrayRef<const Vec3> x
 #pragma omp parallel for num_threads(numThreads) schedule(static)
     for (int thread = 0; thread < numThreads; ++thread)
     {
-        auto& thisBuffer = threadedForceBuffers_[thread];
-        // access outliers from other threads
+        const auto& thisBuffer = threadedForceBuffers_[thread];
+        // add the outliers of the other threads that fall within the range of <thread>,
+        // visiting only the blocks they have touched
         for (int otherThread = 0; otherThread < numThreads; ++otherThread)
         {
-            auto& otherBuffer = threadedForceBuffers_[otherThread];
-            for (const auto& outlier : otherBuffer)
+            if (otherThread != thread)
             {
-                int index = outlier.first;
-                // check whether this outlier falls within the range of <thread>
-                if (thisBuffer.inRange(index))
-                {
-                    auto force = outlier.second;
-                    forces[index] += force;
-                }
+                threadedForceBuffers_[otherThread].addOutliers(
+                        forces, thisBuffer.rangeStart(), thisBuffer.rangeEnd());
             }
         }
     }
@@ -47,7 +47,8 @@
 #ifndef NBLIB_LISTEDFORCSES_HELPERS_HPP
 #define NBLIB_LISTEDFORCSES_HELPERS_HPP
 
-#include <unordered_map>
+#include <algorithm>
+#include <vector>
 
 #include "gromacs/utility/arrayref.h"
 
@@ -82,20 +83,41 @@ inline void gmxRVecZeroWorkaround<gmx::RVec>(gmx::RVec& value)
  * Depending on the index, either the underlying master buffer, or local
  * storage for outliers is accessed. This object does not own the master buffer.
  *
+ * Outliers are stored in a dense buffer of the same size as the master buffer,
+ * divided into blocks of 2^c_blockSizeLog2 atoms. Like the reduction of the
+ * GROMACS listed forces (setup_bonded_threading), only the blocks that were
+ * touched by the kernels are cleared and reduced, which avoids both hashing
+ * in the inner kernel loops and a scan over the full buffer.
  */
 template<class T>
 class ForceBufferProxy
 {
-    using HashMap = std::unordered_map<int, T>;
-
 public:
+    //! log2 of the number of atoms per reduction block
+    static constexpr int c_blockSizeLog2 = 5;
+    //! the number of atoms per reduction block
+    static constexpr int c_blockSize = 1 << c_blockSizeLog2;
+
     ForceBufferProxy() : rangeStart_(0), rangeEnd_(0) { }
 
     ForceBufferProxy(int rangeStart, int rangeEnd) : rangeStart_(rangeStart), rangeEnd_(rangeEnd)
     {
     }
 
-    void clearOutliers() { outliers.clear(); }
+    //! zero the outliers of all blocks that were touched since the last call
+    void clearOutliers()
+    {
+        const T zero = zeroValue();
+        for (int block = 0; block < int(blockTouched_.size()); ++block)
+        {
+            if (blockTouched_[block])
+            {
+                int blockEnd = std::min((block + 1) * c_blockSize, int(outliers_.size()));
+                std::fill(outliers_.begin() + block * c_blockSize, outliers_.begin() + blockEnd, zero);
+                blockTouched_[block] = false;
+            }
+        }
+    }
 
     inline NBLIB_ALWAYS_INLINE T& operator[](int i)
     {
@@ -105,30 +127,70 @@ public:
         }
         else
         {
-            if (outliers.count(i) == 0)
+            blockTouched_[i >> c_blockSizeLog2] = true;
+            return outliers_[i];
+        }
+    }
+
+    /*! \brief add the outliers stored in this buffer that fall into [rangeStart, rangeEnd) to \p target
+     *
+     * Only blocks that were touched since the last call to clearOutliers() are visited.
+     */
+    void addOutliers(gmx::ArrayRef<T> target, int rangeStart, int rangeEnd) const
+    {
+        if (rangeStart >= rangeEnd)
+        {
+            return;
+        }
+        int blockBegin = rangeStart >> c_blockSizeLog2;
+        int blockEnd   = std::min(((rangeEnd - 1) >> c_blockSizeLog2) + 1, int(blockTouched_.size()));
+        for (int block = blockBegin; block < blockEnd; ++block)
+        {
+            if (blockTouched_[block])
             {
-                T zero = T();
-                // if T = gmx::RVec, need to explicitly initialize it to zeros
-                detail::gmxRVecZeroWorkaround(zero);
-                outliers[i] = zero;
+                int begin = std::max(block * c_blockSize, rangeStart);
+                int end   = std::min((block + 1) * c_blockSize, rangeEnd);
+                for (int i = begin; i < end; ++i)
+                {
+                    target[i] += outliers_[i];
+                }
             }
-            return outliers[i];
         }
     }
 
-    typename HashMap::const_iterator begin() { return outliers.begin(); }
-    typename HashMap::const_iterator end() { return outliers.end(); }
-
     [[nodiscard]] bool inRange(int index) const { return (index >= rangeStart_ && index < rangeEnd_); }
 
-    void setMasterBuffer(gmx::ArrayRef<T> buffer) { masterForceBuffer = buffer; }
+    [[nodiscard]] int rangeStart() const { return rangeStart_; }
+    [[nodiscard]] int rangeEnd() const { return rangeEnd_; }
+
+    //! set the master buffer, the outlier storage is resized to match on first use
+    void setMasterBuffer(gmx::ArrayRef<T> buffer)
+    {
+        masterForceBuffer = buffer;
+        if (outliers_.size() != buffer.size())
+        {
+            outliers_.assign(buffer.size(), zeroValue());
+            blockTouched_.assign((buffer.size() + c_blockSize - 1) / c_blockSize, false);
+        }
+    }
 
 private:
+    static T zeroValue()
+    {
+        T zero = T();
+        // if T = gmx::RVec, need to explicitly initialize it to zeros
+        detail::gmxRVecZeroWorkaround(zero);
+        return zero;
+    }
+
     gmx::ArrayRef<T> masterForceBuffer;
-    int rangeStart_;
-    int rangeEnd_;
+    int              rangeStart_;
+    int              rangeEnd_;
 
-    HashMap outliers;
+    //! dense storage for forces on atoms outside [rangeStart_, rangeEnd_)
+    std::vector<T> outliers_;
+    //! whether any outlier in a block of c_blockSize atoms was written
+    std::vector<char> blockTouched_;
 };
 
 namespace detail
@@ -144,6 +144,46 @@ TEST(NBlibTest, ListedForceBuffer)
     }
 }
 
+TEST(NBlibTest, ListedForceBufferReducesTouchedOutliers)
+{
+    using T     = gmx::RVec;
+    int ncoords = 100;
+
+    T              vzero{ 0, 0, 0 };
+    std::vector<T> masterBuffer(ncoords, vzero);
+    std::vector<T> reducedBuffer(ncoords, vzero);
+
+    ForceBufferProxy<T> forceBuffer(40, 60);
+    forceBuffer.setMasterBuffer(masterBuffer);
+
+    T outlier1{ 1, 2, 3 };
+    T outlier2{ 4, 5, 6 };
+    forceBuffer[3]  += outlier1;
+    forceBuffer[3]  += outlier1;
+    forceBuffer[90] += outlier2;
+
+    // only the outliers within the requested range are added
+    forceBuffer.addOutliers(reducedBuffer, 0, 40);
+    for (size_t m = 0; m < dimSize; ++m)
+    {
+        EXPECT_REAL_EQ_TOL(2 * outlier1[m], reducedBuffer[3][m], gmx::test::defaultRealTolerance());
+        EXPECT_REAL_EQ_TOL(vzero[m], reducedBuffer[90][m], gmx::test::defaultRealTolerance());
+    }
+
+    // after clearing, no outliers remain
+    forceBuffer.clearOutliers();
+    std::vector<T> clearedBuffer(ncoords, vzero);
+    forceBuffer.addOutliers(clearedBuffer, 0, ncoords);
+    for (size_t i = 0; i < clearedBuffer.size(); ++i)
+    {
+        for (size_t m = 0; m < dimSize; ++m)
+        {
+            EXPECT_REAL_EQ_TOL(vzero[m], clearedBuffer[i][m], gmx::test::defaultRealTolerance());
+            EXPECT_REAL_EQ_TOL(vzero[m], masterBuffer[i][m], gmx::test::defaultRealTolerance());
+        }
+    }
+}
+
 } // namespace
 } // namespace test
 } // namespace nblib
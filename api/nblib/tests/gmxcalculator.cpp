@@ -43,6 +43,8 @@
  */
 #include <gtest/gtest.h>
 
+#include "nblib/exception.h"
+#include "nblib/gmxcalculatorbatchcpu.h"
 #include "nblib/gmxcalculatorcpu.h"
 #include "nblib/kerneloptions.h"
 #include "nblib/simulationstate.h"
@@ -50,6 +52,8 @@
 #include "nblib/tests/testsystems.h"
 #include "gromacs/utility/arrayref.h"
 
+#include "testutils/testasserts.h"
+
 namespace nblib
 {
 namespace test
@@ -128,6 +132,88 @@ TEST(NBlibTest, SpcMethanolEnergiesAreCorrect)
     energiesOutputTest.testArrays<real>(energies, "SPC-methanol energies");
 }
 
+TEST(NBlibTest, BatchedSystemsMatchSeparateEvaluations)
+{
+    // Each system is a pair of SPC water molecules
+    WaterTopologyBuilder waterTopologyBuilder;
+    Topology             pairTopology  = waterTopologyBuilder.buildTopology(2);
+    Topology             batchTopology = waterTopologyBuilder.buildTopology(4);
+
+    const std::vector<std::vector<Vec3>> systemCoordinates = {
+        { { 1.555, 1.511, 0.703 },
+          { 1.498, 1.495, 0.784 },
+          { 1.496, 1.521, 0.623 },
+          { 1.805, 1.611, 0.753 },
+          { 1.748, 1.595, 0.834 },
+          { 1.746, 1.621, 0.673 } },
+        { { 1.555, 1.511, 0.703 },
+          { 1.498, 1.495, 0.784 },
+          { 1.496, 1.521, 0.623 },
+          { 1.455, 1.811, 0.703 },
+          { 1.398, 1.795, 0.784 },
+          { 1.396, 1.821, 0.623 } },
+    };
+    constexpr int numEnergyTerms = 5;
+
+    NBKernelOptions options = NBKernelOptions();
+    options.nbnxmSimd       = SimdKernels::SimdNo;
+
+    // The reference box is large enough that no periodic images are in range
+    const Box         box(5.0);
+    std::vector<Vec3> referenceForces;
+    std::vector<real> referenceEnergies;
+    std::vector<Vec3> batchCoordinates;
+    for (const auto& coordinates : systemCoordinates)
+    {
+        std::unique_ptr<GmxNBForceCalculatorCpu> gmxForceCalculator =
+                setupGmxForceCalculatorCpu(pairTopology, options);
+        std::vector<Vec3> pairlistCoordinates = coordinates;
+        gmxForceCalculator->updatePairlist(pairlistCoordinates, box);
+
+        std::vector<Vec3> forces(coordinates.size(), Vec3(0, 0, 0));
+        std::vector<real> energies(numEnergyTerms, 0.0);
+        gmxForceCalculator->compute(coordinates, box, forces, gmx::ArrayRef<real>{}, energies);
+
+        referenceForces.insert(referenceForces.end(), forces.begin(), forces.end());
+        referenceEnergies.insert(referenceEnergies.end(), energies.begin(), energies.end());
+        batchCoordinates.insert(batchCoordinates.end(), coordinates.begin(), coordinates.end());
+    }
+
+    const std::vector<int> systemRanges = { 0, 6, 12 };
+    std::unique_ptr<GmxNBForceCalculatorBatchCpu> batchCalculator =
+            setupGmxForceCalculatorBatchCpu(batchTopology, systemRanges, options);
+    EXPECT_EQ(batchCalculator->numSystems(), 2);
+    batchCalculator->updatePairlist(batchCoordinates);
+
+    std::vector<Vec3> forces(batchCoordinates.size(), Vec3(0, 0, 0));
+    std::vector<real> energies(numEnergyTerms * batchCalculator->numSystems(), 0.0);
+    batchCalculator->compute(batchCoordinates, forces, energies);
+
+    const auto tolerance = gmx::test::relativeToleranceAsFloatingPoint(1.0, 5e-5);
+    for (size_t i = 0; i < forces.size(); i++)
+    {
+        for (int m = 0; m < DIM; m++)
+        {
+            EXPECT_REAL_EQ_TOL(referenceForces[i][m], forces[i][m], tolerance)
+                    << "for particle " << i << " dimension " << m;
+        }
+    }
+    for (size_t i = 0; i < energies.size(); i++)
+    {
+        EXPECT_REAL_EQ_TOL(referenceEnergies[i], energies[i], tolerance) << "for energy term " << i;
+    }
+}
+
+TEST(NBlibTest, BatchedSystemsRejectExclusionsBetweenSystems)
+{
+    // The exclusions within a water molecule connect particles 0 to 2
+    Topology               topology     = WaterTopologyBuilder().buildTopology(2);
+    const std::vector<int> systemRanges = { 0, 2, 6 };
+    NBKernelOptions        options      = NBKernelOptions();
+    options.nbnxmSimd                   = SimdKernels::SimdNo;
+    EXPECT_THROW(setupGmxForceCalculatorBatchCpu(topology, systemRanges, options), InputException);
+}
+
 } // namespace
 } // namespace test
 } // namespace nblib
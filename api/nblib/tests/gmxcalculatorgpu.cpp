@@ -0,0 +1,185 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2020,2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * This implements tests of the nblib GPU force calculator
+ */
+#include <gtest/gtest.h>
+
+#include "config.h"
+
+#if GMX_GPU_CUDA || GMX_GPU_HIP
+
+#    include "gromacs/gpu_utils/device_context.h"
+#    include "gromacs/gpu_utils/device_stream.h"
+#    include "gromacs/gpu_utils/devicebuffer.h"
+#    include "gromacs/hardware/device_management.h"
+#    include "gromacs/mdtypes/enerdata.h"
+#    include "gromacs/utility/arrayref.h"
+#    include "nblib/gmxcalculatorcpu.h"
+#    include "nblib/gmxcalculatorgpu.h"
+#    include "nblib/kerneloptions.h"
+#    include "nblib/simulationstate.h"
+#    include "nblib/tests/testsystems.h"
+
+#    include "testutils/testasserts.h"
+#    include "testutils/test_hardware_environment.h"
+
+namespace nblib
+{
+namespace test
+{
+namespace
+{
+
+//! Returns the forces of the SPC-methanol system computed on the CPU
+std::vector<Vec3> computeReferenceForces(SimulationState* simState)
+{
+    NBKernelOptions options = NBKernelOptions();
+    options.nbnxmSimd       = SimdKernels::SimdNo;
+
+    std::unique_ptr<GmxNBForceCalculatorCpu> gmxForceCalculator =
+            setupGmxForceCalculatorCpu(simState->topology(), options);
+    gmxForceCalculator->updatePairlist(simState->coordinates(), simState->box());
+
+    std::vector<Vec3> forces(simState->topology().numParticles(), Vec3(0, 0, 0));
+    gmxForceCalculator->compute(simState->coordinates(), simState->box(), forces);
+    return forces;
+}
+
+//! Compares forces computed on the GPU to the CPU reference
+void compareForces(gmx::ArrayRef<const Vec3> reference, gmx::ArrayRef<const Vec3> forces)
+{
+    ASSERT_EQ(reference.size(), forces.size());
+    const auto tolerance = gmx::test::relativeToleranceAsFloatingPoint(1.0, 5e-5);
+    for (size_t i = 0; i < reference.size(); i++)
+    {
+        for (int m = 0; m < DIM; m++)
+        {
+            EXPECT_REAL_EQ_TOL(reference[i][m], forces[i][m], tolerance)
+                    << "for particle " << i << " dimension " << m;
+        }
+    }
+}
+
+TEST(NBlibTest, GmxForceCalculatorGpuMatchesCpu)
+{
+    for (const auto& testDevice : gmx::test::getTestHardwareEnvironment()->getTestDeviceList())
+    {
+        const DeviceInformation& deviceInfo = testDevice->deviceInfo();
+        setActiveDevice(deviceInfo);
+
+        SpcMethanolSimulationStateBuilder spcMethanolSystemBuilder;
+        SimulationState   simState        = spcMethanolSystemBuilder.setupSimulationState();
+        std::vector<Vec3> referenceForces = computeReferenceForces(&simState);
+
+        NBKernelOptions options = NBKernelOptions();
+        options.useGpu          = true;
+        std::unique_ptr<GmxNBForceCalculatorGpu> gmxForceCalculator =
+                setupGmxForceCalculatorGpu(simState.topology(), options, deviceInfo);
+        gmxForceCalculator->updatePairlist(simState.coordinates(), simState.box());
+
+        std::vector<Vec3> forces(simState.topology().numParticles(), Vec3(0, 0, 0));
+        gmxForceCalculator->compute(simState.coordinates(), simState.box(), forces);
+
+        compareForces(referenceForces, forces);
+    }
+}
+
+TEST(NBlibTest, GmxForceCalculatorGpuComputesOnDeviceResidentData)
+{
+    for (const auto& testDevice : gmx::test::getTestHardwareEnvironment()->getTestDeviceList())
+    {
+        const DeviceInformation& deviceInfo    = testDevice->deviceInfo();
+        const DeviceContext&     deviceContext = testDevice->deviceContext();
+        const DeviceStream&      deviceStream  = testDevice->deviceStream();
+        setActiveDevice(deviceInfo);
+
+        SpcMethanolSimulationStateBuilder spcMethanolSystemBuilder;
+        SimulationState   simState        = spcMethanolSystemBuilder.setupSimulationState();
+        std::vector<Vec3> referenceForces = computeReferenceForces(&simState);
+
+        NBKernelOptions options = NBKernelOptions();
+        options.useGpu          = true;
+        std::unique_ptr<GmxNBForceCalculatorGpu> gmxForceCalculator =
+                setupGmxForceCalculatorGpu(simState.topology(), options, deviceInfo);
+        gmxForceCalculator->updatePairlist(simState.coordinates(), simState.box());
+
+        const int               numParticles = simState.topology().numParticles();
+        DeviceBuffer<gmx::RVec> d_coordinates;
+        DeviceBuffer<gmx::RVec> d_forces;
+        allocateDeviceBuffer(&d_coordinates, numParticles, deviceContext);
+        allocateDeviceBuffer(&d_forces, numParticles, deviceContext);
+        copyToDeviceBuffer(&d_coordinates,
+                           simState.coordinates().data(),
+                           0,
+                           numParticles,
+                           deviceStream,
+                           GpuApiCallBehavior::Sync,
+                           nullptr);
+        clearDeviceBufferAsync(&d_forces, 0, numParticles, deviceStream);
+        deviceStream.synchronize();
+
+        // Compute twice to check that the reduction set up on the first call is reused
+        // and accumulates into the buffer
+        std::vector<real> energies(5, 0.0);
+        gmxForceCalculator->computeOnDevice(d_coordinates, simState.box(), d_forces);
+        gmxForceCalculator->computeOnDevice(d_coordinates, simState.box(), d_forces, energies);
+
+        std::vector<Vec3> forces(numParticles);
+        copyFromDeviceBuffer(forces.data(),
+                             &d_forces,
+                             0,
+                             numParticles,
+                             deviceStream,
+                             GpuApiCallBehavior::Sync,
+                             nullptr);
+        for (auto& force : forces)
+        {
+            force /= 2;
+        }
+        compareForces(referenceForces, forces);
+        EXPECT_NE(energies[static_cast<int>(NonBondedEnergyTerms::CoulombSR)], 0);
+
+        freeDeviceBuffer(&d_coordinates);
+        freeDeviceBuffer(&d_forces);
+    }
+}
+
+} // namespace
+} // namespace test
+} // namespace nblib
+
+#endif // GMX_GPU_CUDA || GMX_GPU_HIP
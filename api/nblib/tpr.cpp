@@ -73,8 +73,7 @@ TprReader::TprReader(std::string filename)
     gmx::SimulationWorkload simulationWorkload;
 
     // If the file does not exist, this function will throw
-    PartialDeserializedTprFile partialDeserializedTpr =
-            read_tpx_state(filename.c_str(), &inputRecord, &globalState, &molecularTopology);
+    read_tpx_state_no_broadcast(filename.c_str(), &inputRecord, &globalState, &molecularTopology);
 
     // init forcerec
     t_forcerec          forceRecord;
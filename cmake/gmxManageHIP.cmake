@@ -152,4 +152,7 @@ endif()
 option(GMX_HIP_NB_SINGLE_COMPILATION_UNIT "Whether to compile the HIP non-bonded module using a single compilation unit." OFF)
 mark_as_advanced(GMX_HIP_NB_SINGLE_COMPILATION_UNIT)
 
+option(GMX_HIP_NB_DPP_REDUCTION "Use the DPP/ds_swizzle based i-force reduction in the HIP non-bonded kernels instead of the shuffle-based one." ON)
+mark_as_advanced(GMX_HIP_NB_DPP_REDUCTION)
+
 option(GMX_NAVI_BUILD "Navi build with Warp Size 32 and Pairsplit 2" OFF)
@@ -158,6 +158,11 @@ Doxygen documentation file for directories in the source tree.
 \dir src/programs/view
 \brief Source code specific to `gmx view`, including all X11-dependent code.
  */
+/*!
+\libinternal
+\dir src/microbenchmarks
+\brief Microbenchmarks of performance-critical compute kernels.
+ */
 
 /*!
 \libinternal
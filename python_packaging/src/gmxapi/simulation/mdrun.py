@@ -148,6 +148,109 @@ def scoped_communicator(original_comm, requested_size: int = None):
             communicator.Free()
 
 
+def _prepare_working_directory(workdir: str, source_file, parameters: dict, runtime_args: dict) -> str:
+    """Create the working directory and input file of an ensemble member, or check an existing one.
+
+    Returns:
+        Path of the TPR file for the member.
+    """
+    import gmxapi._gmxapi as _gmxapi
+    # TODO: We should really name this file with a useful input-dependent tag.
+    tprfile = os.path.join(workdir, 'topol.tpr')
+
+    expected_working_files = [tprfile]
+
+    if os.path.exists(workdir):
+        if os.path.isdir(workdir):
+            # Confirm that this is a restarted simulation.
+            # It is unspecified by the API, but at least through gmxapi 0.1,
+            # all simulations are initialized with a checkpoint file named state.cpt
+            # (see src/api/cpp/context.cpp)
+            checkpoint_file = runtime_args.get('-cpi', 'state.cpt')
+            if not os.path.isabs(checkpoint_file):
+                checkpoint_file = os.path.join(workdir, checkpoint_file)
+            expected_working_files.append(checkpoint_file)
+
+            for file in expected_working_files:
+                if not os.path.exists(file):
+                    raise exceptions.ApiError(
+                        'Cannot determine working directory state: {}'.format(workdir))
+        else:
+            raise exceptions.ApiError(
+                'Chosen working directory path exists but is not a directory: {}'.format(workdir))
+    else:
+        # Build the working directory and input files.
+        os.mkdir(workdir)
+        sim_input = fileio.read_tpr(source_file)
+        # TODO(#3295): insertion point for updated positions and velocities.
+        for key, value in parameters.items():
+            try:
+                sim_input.parameters.set(key=key, value=value)
+            except _gmxapi.Exception as e:
+                raise exceptions.ApiError(
+                    'Bug encountered. Unknown error when trying to set simulation '
+                    'parameter {} to {}'.format(key, value)
+                ) from e
+
+        fileio.write_tpr_file(output=tprfile, input=sim_input)
+    return tprfile
+
+
+class _MemberQueue(object):
+    """Queue of ensemble member indices shared by the ranks of a communicator.
+
+    Each rank claims the next unclaimed member as soon as it is free, so ranks that
+    finish a short member start another one instead of waiting for the slowest member
+    of a lock-step wave. With MPI, the queue is a counter in an RMA window on rank 0
+    that is advanced with an atomic fetch-and-add. Without MPI, or on a single rank,
+    members are simply handed out in order.
+
+    ``free()`` is collective and must be called on all ranks of the communicator
+    once they have exhausted the queue.
+    """
+
+    def __init__(self, communicator, size: int):
+        self._size = size
+        self._next = 0
+        self._window = None
+        try:
+            from mpi4py import MPI
+        except ImportError:
+            MPI = None
+        if MPI is not None and isinstance(communicator, MPI.Comm) and communicator.Get_size() > 1:
+            import numpy
+            self._numpy = numpy
+            self._MPI = MPI
+            # Only the counter of rank 0 is used, but every rank exposes one.
+            self._counter = numpy.zeros(1, dtype='i')
+            self._window = MPI.Win.Create(self._counter,
+                                          disp_unit=self._counter.itemsize,
+                                          comm=communicator)
+
+    def _claim(self) -> int:
+        if self._window is None:
+            member = self._next
+            self._next += 1
+            return member
+        increment = self._numpy.ones(1, dtype='i')
+        claimed = self._numpy.zeros(1, dtype='i')
+        self._window.Lock(0)
+        self._window.Fetch_and_op(increment, claimed, 0, 0, self._MPI.SUM)
+        self._window.Unlock(0)
+        return int(claimed[0])
+
+    def __iter__(self):
+        member = self._claim()
+        while member < self._size:
+            yield member
+            member = self._claim()
+
+    def free(self):
+        if self._window is not None:
+            self._window.Free()
+            self._window = None
+
+
 class LegacyImplementationSubscription(object):
     """Input type representing a subscription to 0.0.7 implementation in gmxapi.operation.
 
@@ -203,6 +306,14 @@ class LegacyImplementationSubscription(object):
         # TODO: Allow user to provide communicator instead of implicitly getting COMM_WORLD
         with scoped_communicator(None) as context_comm:
             context_rank = context_comm.Get_rank()
+            if ensemble_width > context_comm.Get_size():
+                # More members than ranks: members are pulled from a shared queue instead.
+                workdir_list, parameters_dict_list, runtime_args_list = self._run_queued(
+                    resource_manager, context_comm, workdir_list)
+                self.workdir = list(workdir_list)
+                self.parameters = list(parameters_dict_list)
+                self.runtime_args = runtime_args_list
+                return
             with scoped_communicator(context_comm, ensemble_width) as ensemble_comm:
                 # Note that in the current implementation, extra ranks have nothing to do,
                 # but they may have a dummy communicator, so be sure to skip those members
@@ -221,44 +332,7 @@ class LegacyImplementationSubscription(object):
                         # If there are any other key word arguments to process from the gmxapi.mdrun
                         # factory call, do it here.
 
-                    # TODO: We should really name this file with a useful input-dependent tag.
-                    tprfile = os.path.join(workdir, 'topol.tpr')
-
-                    expected_working_files = [tprfile]
-
-                    if os.path.exists(workdir):
-                        if os.path.isdir(workdir):
-                            # Confirm that this is a restarted simulation.
-                            # It is unspecified by the API, but at least through gmxapi 0.1,
-                            # all simulations are initialized with a checkpoint file named state.cpt
-                            # (see src/api/cpp/context.cpp)
-                            checkpoint_file = runtime_args.get('-cpi', 'state.cpt')
-                            if not os.path.isabs(checkpoint_file):
-                                checkpoint_file = os.path.join(workdir, checkpoint_file)
-                            expected_working_files.append(checkpoint_file)
-
-                            for file in expected_working_files:
-                                if not os.path.exists(file):
-                                    raise exceptions.ApiError(
-                                        'Cannot determine working directory state: {}'.format(workdir))
-                        else:
-                            raise exceptions.ApiError(
-                                'Chosen working directory path exists but is not a directory: {}'.format(workdir))
-                    else:
-                        # Build the working directory and input files.
-                        os.mkdir(workdir)
-                        sim_input = fileio.read_tpr(source_file)
-                        # TODO(#3295): insertion point for updated positions and velocities.
-                        for key, value in parameters.items():
-                            try:
-                                sim_input.parameters.set(key=key, value=value)
-                            except _gmxapi.Exception as e:
-                                raise exceptions.ApiError(
-                                    'Bug encountered. Unknown error when trying to set simulation '
-                                    'parameter {} to {}'.format(key, value)
-                                ) from e
-
-                        fileio.write_tpr_file(output=tprfile, input=sim_input)
+                    tprfile = _prepare_working_directory(workdir, source_file, parameters, runtime_args)
                     logger.info('Created {} on rank {}'.format(tprfile, context_rank))
 
                     # Gather the actual outputs from the ensemble members.
@@ -343,6 +417,59 @@ class LegacyImplementationSubscription(object):
         self.parameters = list(parameters_dict_list)
         self.runtime_args = runtime_args_list
 
+    def _run_queued(self, resource_manager: _op.ResourceManager, context_comm, workdir_list: list):
+        """Run an ensemble that is wider than the communicator through a work queue.
+
+        Every rank repeatedly claims the next member that has not been started, prepares
+        its working directory and runs it as a single simulation. Members thus start as
+        soon as a rank is free, and ranks stay busy even when member run times differ.
+        Per-member resources, such as ``-gpu_id`` or ``-ntomp``, follow from the
+        member's own *runtime_args*, so an ensemble of *runtime_args* places each
+        member independently of the rank that happens to run it.
+
+        Returns:
+            Lists of working directories, simulation parameters and runtime arguments
+            for all members, valid on all ranks.
+        """
+        from .context import Context as LegacyContext
+        from .context import _DummyCommunicator
+
+        ensemble_width = resource_manager.ensemble_width
+        completed = {}
+        queue = _MemberQueue(context_comm, ensemble_width)
+        try:
+            for member in queue:
+                workdir = os.path.abspath(workdir_list[member])
+                with resource_manager.local_input(member=member) as input_pack:
+                    source_file = input_pack.kwargs['_simulation_input']
+                    parameters = input_pack.kwargs['parameters']
+                    runtime_args = input_pack.kwargs['runtime_args']
+                tprfile = _prepare_working_directory(workdir, source_file, parameters, runtime_args)
+                logger.info('Rank {} starts queued ensemble member {} in {}'.format(
+                    context_comm.Get_rank(), member, workdir))
+
+                work = workflow.from_tpr([tprfile], **runtime_args)
+                context = LegacyContext(work=work.workspec,
+                                        workdir_list=[workdir],
+                                        communicator=_DummyCommunicator())
+                with context as session:
+                    session.run()
+                completed[member] = (workdir,
+                                     fileio.read_tpr(tprfile).parameters.extract(),
+                                     runtime_args)
+        finally:
+            queue.free()
+
+        if hasattr(context_comm, 'allgather'):
+            for rank_completed in context_comm.allgather(completed):
+                completed.update(rank_completed)
+        assert len(completed) == ensemble_width
+
+        members = range(ensemble_width)
+        return ([completed[member][0] for member in members],
+                [completed[member][1] for member in members],
+                [completed[member][2] for member in members])
+
 
 class SubscriptionSessionResources(object):
     """Input and output run-time resources for a MDRun subscription.
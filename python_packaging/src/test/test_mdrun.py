@@ -236,6 +236,29 @@ def test_run_trivial_ensemble(spc_water_box, caplog, mdrun_kwargs):
                 assert os.path.exists(md.output.trajectory.result()[rank_number])
 
 
+@pytest.mark.usefixtures('cleandir')
+def test_run_queued_ensemble(spc_water_box, caplog, mdrun_kwargs):
+    """An ensemble wider than the communicator runs its members through a work queue."""
+    with caplog.at_level(logging.DEBUG):
+        with caplog.at_level(logging.WARNING, 'gmxapi'), \
+                caplog.at_level(logging.DEBUG, 'gmxapi.mdrun'), \
+                caplog.at_level(logging.DEBUG, 'gmxapi.simulation'):
+
+            ensemble_width = comm_size + 1
+            simulation_input = gmx.read_tpr([spc_water_box] * ensemble_width)
+            md = gmx.mdrun(simulation_input, runtime_args=mdrun_kwargs)
+            assert md.output.ensemble_width == ensemble_width
+            md.run()
+
+            output_directory = md.output._work_dir.result()
+            assert len(output_directory) == ensemble_width
+            assert len(set(output_directory)) == ensemble_width
+            if comm_size == 1:
+                for member in range(ensemble_width):
+                    assert os.path.exists(output_directory[member])
+                    assert os.path.exists(md.output.trajectory.result()[member])
+
+
 @pytest.mark.usefixtures('cleandir')
 def test_run_from_read_tpr_op(spc_water_box, caplog, mdrun_kwargs):
     with caplog.at_level(logging.DEBUG):
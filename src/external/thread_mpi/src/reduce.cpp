@@ -281,6 +281,99 @@ int tMPI_Reduce(void* sendbuf, void* recvbuf, int count,
     return ret;
 }
 
+/* Get the range of elements [start, end) that a thread reduces in the
+   segmented allreduce. The segment boundaries are aligned to cache lines
+   (as far as the alignment of the buffers allows) so that threads don't
+   write to the same cache line. */
+static void tMPI_Allreduce_segment(int count, size_t typesize, int N, int rank,
+                                   int *start, int *end)
+{
+    int line_count = TMPI_ALLREDUCE_SEGMENT_ALIGN/typesize;
+    int Nlines;
+
+    if (line_count < 1)
+    {
+        line_count = 1;
+    }
+    Nlines = (count + line_count - 1)/line_count;
+    *start = (int)((((long)Nlines)*rank/N)*line_count);
+    *end   = (int)((((long)Nlines)*(rank + 1)/N)*line_count);
+    if (*start > count)
+    {
+        *start = count;
+    }
+    if (*end > count || rank == N - 1)
+    {
+        *end = count;
+    }
+}
+
+/* An allreduce for large buffers where all threads reduce a segment of the
+   buffer directly from the send buffers of all threads into their own
+   receive buffer, after which each thread copies the other segments from
+   the receive buffers of their owners. Compared to the tree reduction, the
+   work is spread over all threads, and every element is only reduced once.
+   This also works with TMPI_IN_PLACE, because the segments are disjoint: a
+   thread only overwrites the segment of its own buffer that nobody else reads
+   during the reduction. */
+static int tMPI_Allreduce_segmented(void* sendbuf, void* recvbuf, int count,
+                                    tMPI_Datatype datatype, tMPI_Op op,
+                                    tMPI_Comm comm, int myrank)
+{
+    int    N = tMPI_Comm_N(comm);
+    size_t typesize = datatype->size;
+    int    start, end;
+    int    i, other;
+    int    ret = TMPI_SUCCESS;
+
+    /* post our buffers and wait until all threads have posted theirs */
+    tMPI_Atomic_ptr_set(&(comm->reduce_sendbuf[myrank]), sendbuf);
+    tMPI_Atomic_ptr_set(&(comm->reduce_recvbuf[myrank]), recvbuf);
+    tMPI_Barrier_wait( &(comm->barrier));
+
+    /* reduce our segment, starting with our own send buffer because that is
+       the only one that might be the same as our receive buffer */
+    tMPI_Allreduce_segment(count, typesize, N, myrank, &start, &end);
+    if (end > start)
+    {
+        char *dest  = (char*)recvbuf + start*typesize;
+        char *src_a = (char*)sendbuf + start*typesize;
+
+        for (i = 1; i < N && ret == TMPI_SUCCESS; i++)
+        {
+            char *src_b;
+
+            other = (myrank + i)%N;
+            src_b = (char*)tMPI_Atomic_ptr_get(&(comm->reduce_sendbuf[other])) +
+                start*typesize;
+            ret   = tMPI_Reduce_run_op(dest, src_a, src_b, datatype, end - start,
+                                       op, comm);
+            src_a = dest;
+        }
+    }
+    tMPI_Barrier_wait( &(comm->barrier));
+
+    /* collect the segments of the other threads */
+    for (i = 1; i < N; i++)
+    {
+        int ostart, oend;
+
+        other = (myrank + i)%N;
+        tMPI_Allreduce_segment(count, typesize, N, other, &ostart, &oend);
+        if (oend > ostart)
+        {
+            char *src = (char*)tMPI_Atomic_ptr_get(&(comm->reduce_recvbuf[other]));
+
+            memcpy((char*)recvbuf + ostart*typesize, src + ostart*typesize,
+                   (oend - ostart)*typesize);
+        }
+    }
+    /* nobody may change their buffers before everybody has copied */
+    tMPI_Barrier_wait( &(comm->barrier));
+
+    return ret;
+}
+
 int tMPI_Allreduce(void* sendbuf, void* recvbuf, int count,
                    tMPI_Datatype datatype, tMPI_Op op, tMPI_Comm comm)
 {
@@ -309,6 +402,26 @@ int tMPI_Allreduce(void* sendbuf, void* recvbuf, int count,
         sendbuf = recvbuf;
     }
 
+    if (datatype->size*count >=
+        (size_t)TMPI_ALLREDUCE_SEGMENT_MIN_SIZE*tMPI_Comm_N(comm) &&
+        tMPI_Comm_N(comm) > 1)
+    {
+        if ( (!datatype->op_functions) || (!datatype->op_functions[op]) )
+        {
+            return tMPI_Error(comm, TMPI_ERR_OP_FN);
+        }
+#if defined(TMPI_PROFILE)
+        tMPI_Profile_wait_start(cur);
+#endif
+        ret = tMPI_Allreduce_segmented(sendbuf, recvbuf, count, datatype, op,
+                                       comm, myrank);
+#if defined(TMPI_PROFILE)
+        tMPI_Profile_wait_stop(cur, TMPIWAIT_Reduce);
+        tMPI_Profile_count_stop(cur, TMPIFN_Allreduce);
+#endif
+        return ret;
+    }
+
     ret = tMPI_Reduce_fast(sendbuf, recvbuf, count, datatype, op, 0, comm);
 #if defined(TMPI_PROFILE)
     tMPI_Profile_wait_start(cur);
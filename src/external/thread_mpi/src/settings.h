@@ -118,6 +118,17 @@
 #endif
 
 
+/* The minimum size (in bytes) per thread of an allreduce for which the
+   segmented allreduce is used, where all threads reduce part of the buffer
+   in parallel. Smaller allreduces use the tree reduction, which has a
+   lower latency. */
+#define TMPI_ALLREDUCE_SEGMENT_MIN_SIZE 1024
+
+/* The alignment (in bytes) of the segments of the segmented allreduce,
+   i.e. the size of a cache line. */
+#define TMPI_ALLREDUCE_SEGMENT_ALIGN 64
+
+
 /* Whether to do profiling of the number of MPI communication calls. A
     report with the total number of calls for each communication function
     will be generated at MPI_Finalize().
@@ -61,6 +61,7 @@
 #include "gromacs/gmxlib/network.h"
 #include "gromacs/math/units.h"
 #include "gromacs/math/utilities.h"
+#include "gromacs/mdlib/gmx_omp_nthreads.h"
 #include "gromacs/mdrunutility/multisim.h"
 #include "gromacs/mdtypes/awh_history.h"
 #include "gromacs/mdtypes/awh_params.h"
@@ -70,6 +71,7 @@
 #include "gromacs/utility/arrayref.h"
 #include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/smalloc.h"
 #include "gromacs/utility/stringutil.h"
 
@@ -80,6 +82,25 @@
 namespace gmx
 {
 
+namespace
+{
+
+//! The minimum number of grid points per thread in loops over points.
+constexpr int c_minNumPointsPerThread = 1000;
+
+/*! \brief Returns the number of OpenMP threads to use for a loop over \p numPoints grid points.
+ *
+ * Small grids are updated serially, since the threading overhead would dominate.
+ */
+int numThreadsForPointLoop(size_t numPoints)
+{
+    const int maxNumThreads = std::max(gmx_omp_nthreads_get(ModuleMultiThread::Default), 1);
+
+    return std::min(maxNumThreads, std::max(static_cast<int>(numPoints / c_minNumPointsPerThread), 1));
+}
+
+} // namespace
+
 void BiasState::getPmf(gmx::ArrayRef<float> pmf) const
 {
     GMX_ASSERT(pmf.size() == points_.size(), "pmf should have the size of the bias grid");
@@ -96,47 +117,6 @@ void BiasState::getPmf(gmx::ArrayRef<float> pmf) const
 namespace
 {
 
-/*! \brief
- * Sum PMF over multiple simulations, when requested.
- *
- * \param[in,out] pointState         The state of the points in the bias.
- * \param[in]     numSharedUpdate    The number of biases sharing the histogram.
- * \param[in]     biasSharing        Object for sharing bias data over multiple simulations
- * \param[in]     biasIndex          Index of this bias in the total list of biases in this simulation
- */
-void sumPmf(gmx::ArrayRef<PointState> pointState, int numSharedUpdate, const BiasSharing* biasSharing, const int biasIndex)
-{
-    if (numSharedUpdate == 1)
-    {
-        return;
-    }
-    GMX_ASSERT(biasSharing != nullptr
-                       && numSharedUpdate % biasSharing->numSharingSimulations(biasIndex) == 0,
-               "numSharedUpdate should be a multiple of multiSimComm->numSimulations_");
-    GMX_ASSERT(numSharedUpdate == biasSharing->numSharingSimulations(biasIndex),
-               "Sharing within a simulation is not implemented (yet)");
-
-    std::vector<double> buffer(pointState.size());
-
-    /* Need to temporarily exponentiate the log weights to sum over simulations */
-    for (size_t i = 0; i < buffer.size(); i++)
-    {
-        buffer[i] = pointState[i].inTargetRegion() ? std::exp(pointState[i].logPmfSum()) : 0;
-    }
-
-    biasSharing->sumOverSharingSimulations(gmx::ArrayRef<double>(buffer), biasIndex);
-
-    /* Take log again to get (non-normalized) PMF */
-    double normFac = 1.0 / numSharedUpdate;
-    for (gmx::index i = 0; i < pointState.ssize(); i++)
-    {
-        if (pointState[i].inTargetRegion())
-        {
-            pointState[i].setLogPmfSum(std::log(buffer[i] * normFac));
-        }
-    }
-}
-
 /*! \brief
  * Find the minimum free energy value.
  *
@@ -265,31 +245,38 @@ void BiasState::calcConvolvedPmf(ArrayRef<const DimParams> dimParams,
     std::vector<float> pmf(numPoints);
     getPmf(pmf);
 
-    for (size_t m = 0; m < numPoints; m++)
+    /* The convolution of each point only reads the PMF and point states */
+    const int gmx_unused numThreads = numThreadsForPointLoop(numPoints);
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int m = 0; m < static_cast<int>(numPoints); m++)
     {
-        double           freeEnergyWeights = 0;
-        const GridPoint& point             = grid.point(m);
-        for (const auto& neighbor : point.neighbor)
+        try
         {
-            /* Do not convolve the bias along a lambda axis - only use the pmf from the current point */
-            if (!pointsHaveDifferentLambda(grid, m, neighbor))
+            double           freeEnergyWeights = 0;
+            const GridPoint& point             = grid.point(m);
+            for (const auto& neighbor : point.neighbor)
             {
-                /* The negative PMF is a positive bias. */
-                double biasNeighbor = -pmf[neighbor];
-
-                /* Add the convolved PMF weights for the neighbors of this point.
-                Note that this function only adds point within the target > 0 region.
-                Sum weights, take the logarithm last to get the free energy. */
-                double logWeight = biasedLogWeightFromPoint(
-                        dimParams, points_, grid, neighbor, biasNeighbor, point.coordValue, {}, m);
-                freeEnergyWeights += std::exp(logWeight);
+                /* Do not convolve the bias along a lambda axis - only use the pmf from the current point */
+                if (!pointsHaveDifferentLambda(grid, m, neighbor))
+                {
+                    /* The negative PMF is a positive bias. */
+                    double biasNeighbor = -pmf[neighbor];
+
+                    /* Add the convolved PMF weights for the neighbors of this point.
+                    Note that this function only adds point within the target > 0 region.
+                    Sum weights, take the logarithm last to get the free energy. */
+                    double logWeight = biasedLogWeightFromPoint(
+                            dimParams, points_, grid, neighbor, biasNeighbor, point.coordValue, {}, m);
+                    freeEnergyWeights += std::exp(logWeight);
+                }
             }
-        }
 
-        GMX_RELEASE_ASSERT(freeEnergyWeights > 0,
-                           "Attempting to do log(<= 0) in AWH convolved PMF calculation.");
-        // We should cast to float after taking the logarithm to avoid underflows
-        (*convolvedPmf)[m] = static_cast<float>(-std::log(freeEnergyWeights));
+            GMX_RELEASE_ASSERT(freeEnergyWeights > 0,
+                               "Attempting to do log(<= 0) in AWH convolved PMF calculation.");
+            // We should cast to float after taking the logarithm to avoid underflows
+            (*convolvedPmf)[m] = static_cast<float>(-std::log(freeEnergyWeights));
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
     }
 }
 
@@ -749,7 +736,12 @@ namespace
 {
 
 /*! \brief
- * Add partial histograms (accumulating between updates) to accumulating histograms.
+ * Add partial histograms (accumulating between updates) to accumulating histograms
+ * and sum the PMF over multiple simulations, when requested.
+ *
+ * The partial histograms of the local points and the PMF of all points are
+ * summed over the sharing simulations with a single reduction, as with many
+ * sharing simulations the latency of each reduction dominates.
  *
  * \param[in,out] pointState         The state of the points in the bias.
  * \param[in,out] weightSumCovering  The weights for checking covering.
@@ -758,12 +750,12 @@ namespace
  * \param[in]     biasIndex          Index of this bias in the total list of biases in this
  * simulation \param[in]     localUpdateList    List of points with data.
  */
-void sumHistograms(gmx::ArrayRef<PointState> pointState,
-                   gmx::ArrayRef<double>     weightSumCovering,
-                   int                       numSharedUpdate,
-                   const BiasSharing*        biasSharing,
-                   const int                 biasIndex,
-                   const std::vector<int>&   localUpdateList)
+void sumHistogramsAndPmf(gmx::ArrayRef<PointState> pointState,
+                         gmx::ArrayRef<double>     weightSumCovering,
+                         int                       numSharedUpdate,
+                         const BiasSharing*        biasSharing,
+                         const int                 biasIndex,
+                         const std::vector<int>&   localUpdateList)
 {
     /* The covering checking histograms are added before summing over simulations, so that the
        weights from different simulations are kept distinguishable. */
@@ -772,45 +764,66 @@ void sumHistograms(gmx::ArrayRef<PointState> pointState,
         weightSumCovering[globalIndex] += pointState[globalIndex].weightSumIteration();
     }
 
-    /* Sum histograms over multiple simulations if needed. */
+    /* Sum histograms and PMF over multiple simulations if needed. */
     if (numSharedUpdate > 1)
     {
+        GMX_ASSERT(biasSharing != nullptr
+                           && numSharedUpdate % biasSharing->numSharingSimulations(biasIndex) == 0,
+                   "numSharedUpdate should be a multiple of multiSimComm->numSimulations_");
         GMX_ASSERT(numSharedUpdate == biasSharing->numSharingSimulations(biasIndex),
                    "Sharing within a simulation is not implemented (yet)");
 
-        /* Collect the weights and counts in linear arrays to be able to use gmx_sumd_sim. */
-        std::vector<double> weightSum;
-        std::vector<double> coordVisits;
+        /* Collect the weights and counts of the local points, followed by the PMF
+           of all points, in one linear array to be able to reduce them at once. */
+        const size_t        numLocalPoints = localUpdateList.size();
+        const size_t        visitsOffset   = numLocalPoints;
+        const size_t        pmfOffset      = 2 * numLocalPoints;
+        std::vector<double> buffer(pmfOffset + pointState.size());
 
-        weightSum.resize(localUpdateList.size());
-        coordVisits.resize(localUpdateList.size());
-
-        for (size_t localIndex = 0; localIndex < localUpdateList.size(); localIndex++)
+        for (size_t localIndex = 0; localIndex < numLocalPoints; localIndex++)
         {
             const PointState& ps = pointState[localUpdateList[localIndex]];
 
-            weightSum[localIndex]   = ps.weightSumIteration();
-            coordVisits[localIndex] = ps.numVisitsIteration();
+            buffer[localIndex]                = ps.weightSumIteration();
+            buffer[visitsOffset + localIndex] = ps.numVisitsIteration();
         }
 
-        biasSharing->sumOverSharingSimulations(gmx::ArrayRef<double>(weightSum), biasIndex);
-        biasSharing->sumOverSharingSimulations(gmx::ArrayRef<double>(coordVisits), biasIndex);
+        /* Need to temporarily exponentiate the log weights to sum over simulations */
+        for (size_t i = 0; i < pointState.size(); i++)
+        {
+            buffer[pmfOffset + i] =
+                    pointState[i].inTargetRegion() ? std::exp(pointState[i].logPmfSum()) : 0;
+        }
+
+        biasSharing->sumOverSharingSimulations(gmx::ArrayRef<double>(buffer), biasIndex);
 
         /* Transfer back the result */
-        for (size_t localIndex = 0; localIndex < localUpdateList.size(); localIndex++)
+        for (size_t localIndex = 0; localIndex < numLocalPoints; localIndex++)
         {
             PointState& ps = pointState[localUpdateList[localIndex]];
 
-            ps.setPartialWeightAndCount(weightSum[localIndex], coordVisits[localIndex]);
+            ps.setPartialWeightAndCount(buffer[localIndex], buffer[visitsOffset + localIndex]);
+        }
+
+        /* Take log again to get (non-normalized) PMF */
+        double normFac = 1.0 / numSharedUpdate;
+        for (size_t i = 0; i < pointState.size(); i++)
+        {
+            if (pointState[i].inTargetRegion())
+            {
+                pointState[i].setLogPmfSum(std::log(buffer[pmfOffset + i] * normFac));
+            }
         }
     }
 
     /* Now add the partial counts and weights to the accumulating histograms.
        Note: we still need to use the weights for the update so we wait
        with resetting them until the end of the update. */
-    for (int globalIndex : localUpdateList)
+    const int gmx_unused numThreads = numThreadsForPointLoop(localUpdateList.size());
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int localIndex = 0; localIndex < static_cast<int>(localUpdateList.size()); localIndex++)
     {
-        pointState[globalIndex].addPartialWeightAndCount();
+        pointState[localUpdateList[localIndex]].addPartialWeightAndCount();
     }
 }
 
@@ -1090,9 +1103,8 @@ void BiasState::updateFreeEnergyAndAddSamplesToHistogram(ArrayRef<const DimParam
     resetLocalUpdateRange(grid);
 
     /* Add samples to histograms for all local points and sync simulations if needed */
-    sumHistograms(points_, weightSumCovering_, params.numSharedUpdate, biasSharing_, params.biasIndex, *updateList);
-
-    sumPmf(points_, params.numSharedUpdate, biasSharing_, params.biasIndex);
+    sumHistogramsAndPmf(
+            points_, weightSumCovering_, params.numSharedUpdate, biasSharing_, params.biasIndex, *updateList);
 
     /* Renormalize the free energy if values are too large. */
     bool needToNormalizeFreeEnergy = false;
@@ -1163,21 +1175,32 @@ void BiasState::updateFreeEnergyAndAddSamplesToHistogram(ArrayRef<const DimParam
     setHistogramUpdateScaleFactors(
             params, newHistogramSize, histogramSize_.histogramSize(), &weightHistScalingNew, &logPmfsumScalingNew);
 
-    /* Update free energy and reference weight histogram for points in the update list. */
-    for (int pointIndex : *updateList)
-    {
-        PointState* pointStateToUpdate = &points_[pointIndex];
+    /* Update free energy and reference weight histogram for points in the update list.
+     * The points are updated independently, so we can distribute them over threads.
+     */
+    const int     numPointsToUpdate = updateList->size();
+    const int64_t numUpdates        = histogramSize_.numUpdates();
 
-        /* Do updates from previous update steps that were skipped because this point was at that time non-local. */
-        if (params.skipUpdates())
+    const int gmx_unused numThreads = numThreadsForPointLoop(numPointsToUpdate);
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int i = 0; i < numPointsToUpdate; i++)
+    {
+        try
         {
-            pointStateToUpdate->performPreviouslySkippedUpdates(
-                    params, histogramSize_.numUpdates(), weightHistScalingSkipped, logPmfsumScalingSkipped);
-        }
+            PointState* pointStateToUpdate = &points_[(*updateList)[i]];
 
-        /* Now do an update with new sampling data. */
-        pointStateToUpdate->updateWithNewSampling(
-                params, histogramSize_.numUpdates(), weightHistScalingNew, logPmfsumScalingNew);
+            /* Do updates from previous update steps that were skipped because this point was at that time non-local. */
+            if (params.skipUpdates())
+            {
+                pointStateToUpdate->performPreviouslySkippedUpdates(
+                        params, numUpdates, weightHistScalingSkipped, logPmfsumScalingSkipped);
+            }
+
+            /* Now do an update with new sampling data. */
+            pointStateToUpdate->updateWithNewSampling(
+                    params, numUpdates, weightHistScalingNew, logPmfsumScalingNew);
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
     }
 
     /* Only update the histogram size after we are done with the local point updates */
@@ -1196,9 +1219,10 @@ void BiasState::updateFreeEnergyAndAddSamplesToHistogram(ArrayRef<const DimParam
 
     /* Update the bias. The bias is updated separately and last since it simply a function of
        the free energy and the target distribution and we want to avoid doing extra work. */
-    for (int pointIndex : *updateList)
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int i = 0; i < numPointsToUpdate; i++)
     {
-        points_[pointIndex].updateBias();
+        points_[(*updateList)[i]].updateBias();
     }
 
     /* Increase the update counter. */
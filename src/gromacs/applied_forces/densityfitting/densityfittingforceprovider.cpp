@@ -45,6 +45,7 @@
 
 #include <numeric>
 #include <optional>
+#include <vector>
 
 #include "gromacs/domdec/localatomset.h"
 #include "gromacs/gmxlib/network.h"
@@ -53,10 +54,13 @@
 #include "gromacs/math/densityfittingforce.h"
 #include "gromacs/math/gausstransform.h"
 #include "gromacs/mdlib/broadcaststructs.h"
+#include "gromacs/mdlib/gmx_omp_nthreads.h"
 #include "gromacs/mdtypes/commrec.h"
 #include "gromacs/mdtypes/enerdata.h"
 #include "gromacs/mdtypes/forceoutput.h"
 #include "gromacs/pbcutil/pbc.h"
+#include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/strconvert.h"
 
 #include "densityfittingamplitudelookup.h"
@@ -172,7 +176,8 @@ private:
     GaussianSpreadKernelParameters::Shape spreadKernel_;
     GaussTransform3D                      gaussTransform_;
     DensitySimilarityMeasure              measure_;
-    DensityFittingForce                   densityFittingForce_;
+    //! The force evaluators, one per thread since they hold scratch buffers
+    std::vector<DensityFittingForce> densityFittingForcePerThread_;
     //! the local atom coordinates transformed into the grid coordinate system
     std::vector<RVec>             transformedCoordinates_;
     std::vector<RVec>             forces_;
@@ -205,7 +210,7 @@ DensityFittingForceProvider::Impl::Impl(const DensityFittingParameters&
                                    transformationToDensityLattice.scaleOperationOnly())),
     gaussTransform_(referenceDensity.extents(), spreadKernel_),
     measure_(parameters.similarityMeasureMethod_, referenceDensity),
-    densityFittingForce_(spreadKernel_),
+    densityFittingForcePerThread_(1, DensityFittingForce(spreadKernel_)),
     transformedCoordinates_(localAtomSet_.numAtomsLocal()),
     amplitudeLookup_(parameters_.amplitudeLookupMethod_),
     transformationToDensityLattice_(transformationToDensityLattice),
@@ -336,14 +341,22 @@ void DensityFittingForceProvider::Impl::calculateForces(const ForceProviderInput
             measure_.gradient(gaussTransform_.constView());
     // calculate forces
     forces_.resize(localAtomSet_.numAtomsLocal());
-    std::transform(
-            std::begin(transformedCoordinates_),
-            std::end(transformedCoordinates_),
-            std::begin(amplitudes),
-            std::begin(forces_),
-            [&densityDerivative, this](const RVec r, real amplitude) {
-                return densityFittingForce_.evaluateForce({ r, amplitude }, densityDerivative);
-            });
+    const int numThreads = std::max(gmx_omp_nthreads_get(ModuleMultiThread::Default), 1);
+    if (densityFittingForcePerThread_.size() < static_cast<size_t>(numThreads))
+    {
+        densityFittingForcePerThread_.resize(numThreads, densityFittingForcePerThread_[0]);
+    }
+    const int numAtomsLocal = localAtomSet_.numAtomsLocal();
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int i = 0; i < numAtomsLocal; i++)
+    {
+        try
+        {
+            forces_[i] = densityFittingForcePerThread_[gmx_omp_get_thread_num()].evaluateForce(
+                    { transformedCoordinates_[i], amplitudes[i] }, densityDerivative);
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
 
     transformationToDensityLattice_.scaleOperationOnly().inverseIgnoringZeroScale(forces_);
 
@@ -46,6 +46,7 @@
 
 #include <cmath>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -53,6 +54,7 @@
 #include "gromacs/fileio/gmxfio.h"
 #include "gromacs/fileio/xvgr.h"
 #include "gromacs/math/units.h"
+#include "gromacs/mdlib/gmx_omp_nthreads.h"
 #include "gromacs/mdtypes/commrec.h"
 #include "gromacs/mdtypes/forceoutput.h"
 #include "gromacs/mdtypes/iforceprovider.h"
@@ -74,6 +76,9 @@ namespace gmx
 namespace
 {
 
+//! The minimum number of atoms for which we apply the field with multiple threads
+constexpr int c_minAtomsForThreading = 1000;
+
 /*! \internal
  * \brief Describes an applied electric field in a coordinate
  * dimension.
@@ -315,18 +320,25 @@ void ElectricField::calculateForces(const ForceProviderInput& forceProviderInput
         ArrayRef<RVec> f = forceProviderOutput->forceWithVirial_.force_;
 
         auto chargeA = forceProviderInput.chargeA_;
+        RVec fieldStrength;
+        bool haveField = false;
         for (int m = 0; (m < DIM); m++)
         {
-            const real fieldStrength = gmx::c_fieldfac * field(m, t);
+            fieldStrength[m] = gmx::c_fieldfac * field(m, t);
+            haveField        = haveField || (fieldStrength[m] != 0);
+        }
 
-            if (fieldStrength != 0)
+        if (haveField)
+        {
+            // All field components are applied in a single pass over the forces
+            const int  numAtoms   = forceProviderInput.homenr_;
+            const int  numThreads = std::max(gmx_omp_nthreads_get(ModuleMultiThread::Default), 1);
+            const bool useThreads = (numAtoms >= c_minAtomsForThreading);
+#pragma omp parallel for num_threads(numThreads) schedule(static) if (useThreads)
+            for (int i = 0; i < numAtoms; ++i)
             {
-                // TODO: Check parallellism
-                for (int i = 0; i < forceProviderInput.homenr_; ++i)
-                {
-                    // NOTE: Not correct with perturbed charges
-                    f[i][m] += chargeA[i] * fieldStrength;
-                }
+                // NOTE: Not correct with perturbed charges
+                f[i] += chargeA[i] * fieldStrength;
             }
         }
         if (MASTER(&cr) && fpField_ != nullptr)
@@ -214,7 +214,8 @@ void QMMMForceProvider::calculateForces(const ForceProviderInput& fInput, ForceP
      */
 
     // x - coordinates (gathered across nodes in case of DD)
-    std::vector<RVec> x(numAtoms, RVec({ 0.0, 0.0, 0.0 }));
+    std::vector<RVec>& x = x_;
+    x.assign(numAtoms, RVec({ 0.0, 0.0, 0.0 }));
 
     // Fill cordinates of local QM atoms and add translation
     for (size_t i = 0; i < qmAtoms_.numAtomsLocal(); i++)
@@ -244,7 +245,8 @@ void QMMMForceProvider::calculateForces(const ForceProviderInput& fInput, ForceP
      *    update coordinates and box in CP2K and perform QM calculation
      */
     // x_d - coordinates casted to linear dobule vector for CP2K with parameters_.qmTrans_ added
-    std::vector<double> x_d(3 * numAtoms, 0.0);
+    std::vector<double>& x_d = xCp2k_;
+    x_d.resize(3 * numAtoms);
     for (size_t i = 0; i < numAtoms; i++)
     {
         x_d[3 * i]     = static_cast<double>((x[i][XX]) / c_bohr2Nm);
@@ -282,7 +284,8 @@ void QMMMForceProvider::calculateForces(const ForceProviderInput& fInput, ForceP
     }
 
     // Get Forces they are in Hartree/Bohr and will be converted to kJ/mol/nm
-    std::vector<double> cp2kForce(3 * numAtoms, 0.0);
+    std::vector<double>& cp2kForce = forceCp2k_;
+    cp2kForce.resize(3 * numAtoms);
     cp2k_get_forces(force_env_, cp2kForce.data(), 3 * numAtoms);
 
     // Fill forces on QM atoms first
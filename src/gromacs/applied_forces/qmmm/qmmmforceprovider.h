@@ -43,6 +43,8 @@
 #ifndef GMX_APPLIED_FORCES_QMMMFORCEPROVIDER_H
 #define GMX_APPLIED_FORCES_QMMMFORCEPROVIDER_H
 
+#include <vector>
+
 #include "gromacs/domdec/localatomset.h"
 #include "gromacs/mdtypes/forceoutput.h"
 #include "gromacs/mdtypes/iforceprovider.h"
@@ -112,6 +114,13 @@ private:
 
     //! CP2K force environment handle
     force_env_t force_env_ = -1;
+
+    //! Coordinates of all atoms, gathered over the ranks, kept to avoid reallocation every step
+    std::vector<RVec> x_;
+    //! Coordinates of all atoms in CP2K units and format
+    std::vector<double> xCp2k_;
+    //! Forces on all atoms in CP2K units and format
+    std::vector<double> forceCp2k_;
 };
 
 #ifdef __clang__
@@ -240,27 +240,21 @@ std::unique_ptr<TrajectoryFrameWriter> createTrajectoryFrameWriter(const gmx_mto
 
 
 /*! \brief
- * Create a deep copy of a t_trxframe \p input into \p copy
+ * Create a shallow copy of a t_trxframe \p input into \p copy
  *
  * When running the analysis tools and changing values with the
- * outputadapters, a deep copy of the \p input coordinate frame has to be
- * created first to ensure that the data is not changed if it is needed for other
- * tools following with analysis later. Therefore, the data is passed
- * to \p copy by performing a deep copy first.
- *
- * The method allocates new storage for coordinates of the x, v, and f arrays
- * in the new coordinate frame. This means that those arrays need to be free'd
- * after the frame has been processed and been written to disk.
+ * outputadapters, the \p input coordinate frame must not be changed, as
+ * it may be needed for other tools following with analysis later.
+ * The output adapters only change the fields of the frame and the
+ * pointers to the atom data, never the atom data itself (see
+ * IOutputAdapter::processFrame()), so it is sufficient to copy the fields
+ * and to share the atom data with \p input, which avoids copying all
+ * coordinates for every frame.
  *
  * \param[in]     input Reference input coordinate frame.
- * \param[in,out] copy  Pointer to new output frame that will receive the deep copy.
- * \param[in]     xvec  Pointer to local coordinate storage vector.
- * \param[in]     vvec  Pointer to local velocity storage vector.
- * \param[in]     fvec  Pointer to local force storage vector.
- * \param[in] indexvec  Pointer to local index storage vector.
+ * \param[in,out] copy  Pointer to new output frame that will receive the copy.
  */
-static void
-deepCopy_t_trxframe(const t_trxframe& input, t_trxframe* copy, RVec* xvec, RVec* vvec, RVec* fvec, int* indexvec)
+static void shallowCopy_t_trxframe(const t_trxframe& input, t_trxframe* copy)
 {
     copy->not_ok    = input.not_ok;
     copy->bStep     = input.bStep;
@@ -286,43 +280,17 @@ deepCopy_t_trxframe(const t_trxframe& input, t_trxframe* copy, RVec* xvec, RVec*
     copy->prec = input.prec;
     if (copy->bX)
     {
-        copy->x = as_rvec_array(xvec);
+        copy->x = input.x;
     }
     if (copy->bV)
     {
-        copy->v = as_rvec_array(vvec);
+        copy->v = input.v;
     }
     if (copy->bF)
     {
-        copy->f = as_rvec_array(fvec);
-    }
-    if (input.index)
-    {
-        copy->index = indexvec;
-    }
-    else
-    {
-        copy->index = nullptr;
-    }
-    for (int i = 0; i < copy->natoms; i++)
-    {
-        if (copy->bX)
-        {
-            copy_rvec(input.x[i], copy->x[i]);
-        }
-        if (copy->bV)
-        {
-            copy_rvec(input.v[i], copy->v[i]);
-        }
-        if (copy->bF)
-        {
-            copy_rvec(input.f[i], copy->f[i]);
-        }
-        if (input.index)
-        {
-            copy->index[i] = input.index[i];
-        }
+        copy->f = input.f;
     }
+    copy->index = input.index;
     copy_mat(input.box, copy->box);
     copy->bPBC    = input.bPBC;
     copy->pbcType = input.pbcType;
@@ -398,18 +366,7 @@ void TrajectoryFrameWriter::prepareAndWriteFrame(const int framenumber, const t_
     {
         t_trxframe local;
         clear_trxframe(&local, true);
-        localX_.resize(input.natoms);
-        localIndex_.resize(input.natoms);
-        if (input.bV)
-        {
-            localV_.resize(input.natoms);
-        }
-        if (input.bF)
-        {
-            localF_.resize(input.natoms);
-        }
-        deepCopy_t_trxframe(
-                input, &local, localX_.data(), localV_.data(), localF_.data(), localIndex_.data());
+        shallowCopy_t_trxframe(input, &local);
         for (const auto& outputAdapter : outputAdapters_.getAdapters())
         {
             if (outputAdapter)
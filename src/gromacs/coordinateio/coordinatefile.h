@@ -206,15 +206,6 @@ private:
 
     //! Storage for list of output adapters.
     OutputAdapterContainer outputAdapters_;
-
-    //! Local storage for modified positions.
-    std::vector<RVec> localX_;
-    //! Local storage for modified velocities.
-    std::vector<RVec> localV_;
-    //! Local storage for modified forces.
-    std::vector<RVec> localF_;
-    //! Local storage for modified indices.
-    std::vector<int> localIndex_;
 };
 
 //! Smart pointer to manage the TrajectoryFrameWriter object.
@@ -81,6 +81,12 @@ public:
     /*! \brief
      * Change t_trxframe according to user input.
      *
+     * The frame is a shallow copy of the input frame, so the atom data
+     * (coordinates, velocities, forces and indices) pointed to by \p input
+     * is shared with the input and must not be modified in place. To change
+     * the atom data, an adapter has to point \p input to its own storage,
+     * which must stay valid until the frame has been written.
+     *
      * \param[in] framenumber Frame number as reported from the
      *                        trajectoryanalysis framework or set by user.
      * \param[in,out] input   Pointer to trajectory analysis frame that will
@@ -51,6 +51,7 @@
 #include <cstring>
 
 #include <algorithm>
+#include <vector>
 
 #include "gromacs/correlationfunctions/expfit.h"
 #include "gromacs/correlationfunctions/integrate.h"
@@ -344,6 +345,31 @@ static void dump_tmp(char* s, int n, real c[])
     gmx_ffclose(fp);
 }
 
+/*! \brief Computes the normal ACFs of all \p nitem series in \p c1 using FFT.
+ *
+ * All series are transformed in a single call to many_auto_correl, so the
+ * FFT setup is done once per thread instead of once per series and the
+ * series are distributed over the OpenMP threads.
+ */
+static void do_four_core_normal_batched(int nframes, int nitem, real** c1)
+{
+    std::vector<std::vector<real>> data(nitem);
+    for (int i = 0; i < nitem; i++)
+    {
+        data[i].assign(c1[i], c1[i] + nframes);
+    }
+
+    many_auto_correl(&data);
+
+    for (int i = 0; i < nitem; i++)
+    {
+        for (int j = 0; j < nframes; j++)
+        {
+            c1[i][j] = data[i][j] / static_cast<real>(nframes - j);
+        }
+    }
+}
+
 /*! \brief High level ACF routine. */
 static void do_four_core(unsigned long mode, int nframes, real c1[], real csum[], real ctmp[])
 {
@@ -603,23 +629,30 @@ void low_do_autocorr(const char*             fn,
 
     /* Loop over items (e.g. molecules or dihedrals)
      * In this loop the actual correlation functions are computed, but without
-     * normalizing them.
+     * normalizing them. Plain ACFs using FFT are computed for all items at once.
      */
-    for (int i = 0; i < nitem; i++)
+    if (bFour && MODE(eacNormal))
+    {
+        do_four_core_normal_batched(nframes, nitem, c1);
+    }
+    else
     {
-        if (bVerbose && (((i % 100) == 0) || (i == nitem - 1)))
+        for (int i = 0; i < nitem; i++)
         {
-            fprintf(stderr, "\rThingie %d", i + 1);
-            fflush(stderr);
-        }
+            if (bVerbose && (((i % 100) == 0) || (i == nitem - 1)))
+            {
+                fprintf(stderr, "\rThingie %d", i + 1);
+                fflush(stderr);
+            }
 
-        if (bFour)
-        {
-            do_four_core(mode, nframes, c1[i], csum, ctmp);
-        }
-        else
-        {
-            do_ac_core(nframes, nout, ctmp, c1[i], nrestart, mode);
+            if (bFour)
+            {
+                do_four_core(mode, nframes, c1[i], csum, ctmp);
+            }
+            else
+            {
+                do_ac_core(nframes, nout, ctmp, c1[i], nrestart, mode);
+            }
         }
     }
     if (bVerbose)
@@ -95,13 +95,20 @@ int many_auto_correl(std::vector<std::vector<real>>* c)
             int i0        = (thread_id * nfunc) / nthreads;
             int i1        = std::min(nfunc, ((thread_id + 1) * nfunc) / nthreads);
 
-            gmx_fft_init_1d(&fft1, nfft, GMX_FFT_FLAG_CONSERVATIVE);
-            /* Allocate temporary arrays */
-            in.resize(2 * nfft, 0);
-            out.resize(2 * nfft, 0);
+            /* Threads without series to transform need no plan */
+            if (i0 < i1)
+            {
+                gmx_fft_init_1d(&fft1, nfft, GMX_FFT_FLAG_CONSERVATIVE);
+                /* Allocate temporary arrays */
+                in.resize(2 * nfft, 0);
+                out.resize(2 * nfft, 0);
+            }
             for (int i = i0; (i < i1); i++)
             {
-                for (size_t j = 0; j < ndata; j++)
+                /* Copy the zero padding as well, since the input buffer
+                 * still holds the power spectrum of the previous series.
+                 */
+                for (size_t j = 0; j < nfft; j++)
                 {
                     in[2 * j + 0] = (*c)[i][j];
                     in[2 * j + 1] = 0;
@@ -119,8 +126,10 @@ int many_auto_correl(std::vector<std::vector<real>>* c)
                     (*c)[i][j] = out[2 * j + 0];
                 }
             }
-            /* Free the memory */
-            gmx_fft_destroy(fft1);
+            if (i0 < i1)
+            {
+                gmx_fft_destroy(fft1);
+            }
         }
         GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
     }
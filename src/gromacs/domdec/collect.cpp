@@ -48,6 +48,7 @@
 
 #include "gromacs/domdec/domdec_network.h"
 #include "gromacs/math/vec.h"
+#include "gromacs/mdlib/gmx_omp_nthreads.h"
 #include "gromacs/mdtypes/state.h"
 #include "gromacs/utility/enumerationhelpers.h"
 #include "gromacs/utility/fatalerror.h"
@@ -232,14 +233,15 @@ static void dd_collect_vec_gatherv(gmx_domdec_t*                  dd,
     {
         const AtomDistribution& ma = *dd->ma;
 
-        int bufferAtom = 0;
-        for (int rank = 0; rank < dd->nnodes; rank++)
+        /* The domain group lists are consecutive in ma.atomGroups,
+         * so we can unpack the buffer with a single, threaded loop.
+         */
+        const int* atomGroups = ma.atomGroups.data();
+        const int  numAtoms   = ma.atomGroups.size();
+#pragma omp parallel for num_threads(gmx_omp_nthreads_get(ModuleMultiThread::Domdec)) schedule(static)
+        for (int i = 0; i < numAtoms; i++)
         {
-            const auto& domainGroups = ma.domainGroups[rank];
-            for (const int& globalAtom : domainGroups.atomGroups)
-            {
-                copy_rvec(ma.rvecBuffer[bufferAtom++], v[globalAtom]);
-            }
+            v[atomGroups[i]] = ma.rvecBuffer[i];
         }
     }
 }
@@ -50,11 +50,13 @@
 
 #include "gromacs/domdec/domdec_network.h"
 #include "gromacs/math/vec.h"
+#include "gromacs/mdlib/gmx_omp_nthreads.h"
 #include "gromacs/mdtypes/commrec.h"
 #include "gromacs/mdtypes/df_history.h"
 #include "gromacs/mdtypes/state.h"
 #include "gromacs/topology/topology.h"
 #include "gromacs/utility/enumerationhelpers.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/logger.h"
 
@@ -128,15 +130,16 @@ static void distributeVecScatterv(gmx_domdec_t*                  dd,
 
         get_commbuffer_counts(&ma, &sendCounts, &displacements);
 
-        gmx::ArrayRef<gmx::RVec> buffer    = ma.rvecBuffer;
-        int                      localAtom = 0;
-        for (int rank = 0; rank < dd->nnodes; rank++)
+        /* The domain group lists are consecutive in ma.atomGroups,
+         * so we can pack the buffer with a single, threaded loop.
+         */
+        gmx::ArrayRef<gmx::RVec> buffer     = ma.rvecBuffer;
+        const int*               atomGroups = ma.atomGroups.data();
+        const int                numAtoms   = ma.atomGroups.size();
+#pragma omp parallel for num_threads(gmx_omp_nthreads_get(ModuleMultiThread::Domdec)) schedule(static)
+        for (int i = 0; i < numAtoms; i++)
         {
-            const auto& domainGroups = ma.domainGroups[rank];
-            for (const int& globalAtom : domainGroups.atomGroups)
-            {
-                buffer[localAtom++] = globalVec[globalAtom];
-            }
+            buffer[i] = globalVec[atomGroups[i]];
         }
     }
 
@@ -402,21 +405,51 @@ static std::vector<std::vector<int>> getAtomGroupDistribution(const gmx::MDLogge
 
     if (dd->comm->systemInfo.useUpdateGroups)
     {
+        const int        numThreads = gmx_omp_nthreads_get(ModuleMultiThread::Domdec);
+        std::vector<int> groupDomainIndices;
+
         int atomOffset = 0;
         for (const gmx_molblock_t& molblock : mtop.molblock)
         {
             const auto& updateGrouping =
                     dd->comm->systemInfo.updateGroupingsPerMoleculeType[molblock.type];
+            const int numGroupsPerMolecule = updateGrouping.numBlocks();
+            const int numAtomsPerMolecule  = updateGrouping.fullRange().end();
+
+            /* Determine the domains in parallel, this only modifies
+             * the coordinates of the group itself, then fill the lists
+             * serially to keep the atom order independent of threading.
+             */
+            groupDomainIndices.resize(molblock.nmol * numGroupsPerMolecule);
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+            for (int mol = 0; mol < molblock.nmol; mol++)
+            {
+                try
+                {
+                    const int moleculeAtomOffset = atomOffset + mol * numAtomsPerMolecule;
+                    for (int g = 0; g < numGroupsPerMolecule; g++)
+                    {
+                        const auto& block = updateGrouping.block(g);
+                        groupDomainIndices[mol * numGroupsPerMolecule + g] =
+                                computeAtomGroupDomainIndex(*dd,
+                                                            ddbox,
+                                                            triclinicCorrectionMatrix,
+                                                            cellBoundaries,
+                                                            moleculeAtomOffset + block.begin(),
+                                                            moleculeAtomOffset + block.end(),
+                                                            box,
+                                                            pos);
+                    }
+                }
+                GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+            }
 
             for (int mol = 0; mol < molblock.nmol; mol++)
             {
-                for (int g = 0; g < updateGrouping.numBlocks(); g++)
+                for (int g = 0; g < numGroupsPerMolecule; g++)
                 {
                     const auto& block       = updateGrouping.block(g);
-                    const int   atomBegin   = atomOffset + block.begin();
-                    const int   atomEnd     = atomOffset + block.end();
-                    const int   domainIndex = computeAtomGroupDomainIndex(
-                            *dd, ddbox, triclinicCorrectionMatrix, cellBoundaries, atomBegin, atomEnd, box, pos);
+                    const int   domainIndex = groupDomainIndices[mol * numGroupsPerMolecule + g];
 
                     for (int atomIndex : block)
                     {
@@ -425,7 +458,7 @@ static std::vector<std::vector<int>> getAtomGroupDistribution(const gmx::MDLogge
                     ma.domainGroups[domainIndex].numAtoms += block.size();
                 }
 
-                atomOffset += updateGrouping.fullRange().end();
+                atomOffset += numAtomsPerMolecule;
             }
         }
 
@@ -433,11 +466,18 @@ static std::vector<std::vector<int>> getAtomGroupDistribution(const gmx::MDLogge
     }
     else
     {
-        /* Compute the center of geometry for all atoms */
+        /* Compute the domain indices for all atoms in parallel */
+        std::vector<int> atomDomainIndices(mtop.natoms);
+#pragma omp parallel for num_threads(gmx_omp_nthreads_get(ModuleMultiThread::Domdec)) schedule(static)
         for (int atom = 0; atom < mtop.natoms; atom++)
         {
-            int domainIndex = computeAtomGroupDomainIndex(
+            atomDomainIndices[atom] = computeAtomGroupDomainIndex(
                     *dd, ddbox, triclinicCorrectionMatrix, cellBoundaries, atom, atom + 1, box, pos);
+        }
+
+        for (int atom = 0; atom < mtop.natoms; atom++)
+        {
+            const int domainIndex = atomDomainIndices[atom];
 
             indices[domainIndex].push_back(atom);
             ma.domainGroups[domainIndex].numAtoms += 1;
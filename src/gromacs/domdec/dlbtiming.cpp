@@ -37,10 +37,12 @@
 
 #include "dlbtiming.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "gromacs/domdec/domdec.h"
 #include "gromacs/gmxlib/nrnb.h"
+#include "gromacs/timing/walltime_accounting.h"
 #include "gromacs/utility/gmxassert.h"
 
 #include "domdec_internal.h"
@@ -51,7 +53,13 @@ class BalanceRegion::Impl
 public:
     /*! \brief Constructor */
     Impl() :
-        isOpen(false), isOpenOnCpu(false), isOpenOnGpu(false), cyclesOpenCpu(0), cyclesLastCpu(0)
+        isOpen(false),
+        isOpenOnCpu(false),
+        isOpenOnGpu(false),
+        cyclesOpenCpu(0),
+        cyclesLastCpu(0),
+        cyclesOpenGpu(0),
+        timeOpenGpu(0)
     {
     }
 
@@ -60,6 +68,8 @@ public:
     bool         isOpenOnGpu;   /**< Is the, currently open, region open on the GPU side? */
     gmx_cycles_t cyclesOpenCpu; /**< Cycle count when opening the CPU region */
     gmx_cycles_t cyclesLastCpu; /**< Cycle count at the last call to \p ddCloseBalanceRegionCpu() */
+    gmx_cycles_t cyclesOpenGpu; /**< Cycle count when opening the GPU region */
+    double       timeOpenGpu;   /**< Wall time in seconds when opening the GPU region */
 };
 
 BalanceRegion::BalanceRegion()
@@ -102,7 +112,9 @@ void DDBalanceRegionHandler::openRegionGpuImpl() const
     BalanceRegion::Impl* reg = getBalanceRegion(dd_);
     GMX_ASSERT(reg->isOpen, "Can only open a GPU region inside an open CPU region");
     GMX_ASSERT(!reg->isOpenOnGpu, "Can not re-open a GPU balance region");
-    reg->isOpenOnGpu = true;
+    reg->isOpenOnGpu   = true;
+    reg->cyclesOpenGpu = gmx_cycles_read();
+    reg->timeOpenGpu   = gmx_gettime();
 }
 
 void ddReopenBalanceRegionCpu(const gmx_domdec_t* dd)
@@ -140,7 +152,8 @@ void DDBalanceRegionHandler::closeRegionCpuImpl() const
 }
 
 void DDBalanceRegionHandler::closeRegionGpuImpl(float waitGpuCyclesInCpuRegion,
-                                                DdBalanceRegionWaitedForGpu waitedForGpu) const
+                                                DdBalanceRegionWaitedForGpu waitedForGpu,
+                                                double gpuTaskMilliseconds) const
 {
     BalanceRegion::Impl* reg = getBalanceRegion(dd_);
     if (reg->isOpen)
@@ -149,14 +162,33 @@ void DDBalanceRegionHandler::closeRegionGpuImpl(float waitGpuCyclesInCpuRegion,
         GMX_ASSERT(!reg->isOpenOnCpu,
                    "The GPU region should be closed after closing the CPU region");
 
-        float waitGpuCyclesEstimate = gmx_cycles_read() - reg->cyclesLastCpu;
+        const gmx_cycles_t cyclesNow             = gmx_cycles_read();
+        float              waitGpuCyclesEstimate = cyclesNow - reg->cyclesLastCpu;
         if (waitedForGpu == DdBalanceRegionWaitedForGpu::no)
         {
-            /* The actual time could be anywhere between 0 and
-             * waitCyclesEstimate. Using half is the best we can do.
-             */
-            const float unknownWaitEstimateFactor = 0.5F;
-            waitGpuCyclesEstimate *= unknownWaitEstimateFactor;
+            const double timeNow = gmx_gettime();
+            if (gpuTaskMilliseconds >= 0 && timeNow > reg->timeOpenGpu)
+            {
+                /* The GPU tasks were launched when opening the GPU region.
+                 * Using the measured GPU time, we can estimate when the GPU
+                 * finished, assuming the tasks started right after launch.
+                 * The cycle rate is obtained from the same interval.
+                 */
+                const double cyclesPerSecond =
+                        (cyclesNow - reg->cyclesOpenGpu) / (timeNow - reg->timeOpenGpu);
+                const double cyclesGpuDone =
+                        reg->cyclesOpenGpu + gpuTaskMilliseconds * 1e-3 * cyclesPerSecond;
+                waitGpuCyclesEstimate = std::clamp(
+                        static_cast<float>(cyclesGpuDone - reg->cyclesLastCpu), 0.0F, waitGpuCyclesEstimate);
+            }
+            else
+            {
+                /* The actual time could be anywhere between 0 and
+                 * waitCyclesEstimate. Using half is the best we can do.
+                 */
+                const float unknownWaitEstimateFactor = 0.5F;
+                waitGpuCyclesEstimate *= unknownWaitEstimateFactor;
+            }
         }
 
         float cyclesCpu = reg->cyclesLastCpu - reg->cyclesOpenCpu;
@@ -159,18 +159,22 @@ public:
      *
      * This should be called after the CPU receives the last (local) results
      * from the GPU. The wait time for these results is estimated, depending
-     * on the \p waitedForGpu parameter.
+     * on the \p waitedForGpu parameter. When we did not wait and the GPU
+     * task time of this step was measured, that time is used to estimate
+     * when the GPU finished.
      * If called on an already closed region, this call does nothing.
      *
      * \param[in] waitCyclesGpuInCpuRegion  The time we waited for the GPU earlier, overlapping completely with the open CPU region
      * \param[in] waitedForGpu              Tells if we waited for the GPU to finish now
+     * \param[in] gpuTaskMilliseconds       The measured GPU task time of this step, negative when not available
      */
     void closeAfterForceComputationGpu(float                       waitCyclesGpuInCpuRegion,
-                                       DdBalanceRegionWaitedForGpu waitedForGpu) const
+                                       DdBalanceRegionWaitedForGpu waitedForGpu,
+                                       double                      gpuTaskMilliseconds) const
     {
         if (useBalancingRegion_)
         {
-            closeRegionGpuImpl(waitCyclesGpuInCpuRegion, waitedForGpu);
+            closeRegionGpuImpl(waitCyclesGpuInCpuRegion, waitedForGpu, gpuTaskMilliseconds);
         }
     }
 
@@ -195,8 +199,11 @@ private:
      *
      * \param[in] waitCyclesGpuInCpuRegion  The time we waited for the GPU earlier, overlapping completely with the open CPU region
      * \param[in] waitedForGpu              Tells if we waited for the GPU to finish now
+     * \param[in] gpuTaskMilliseconds       The measured GPU task time of this step, negative when not available
      */
-    void closeRegionGpuImpl(float waitCyclesGpuInCpuRegion, DdBalanceRegionWaitedForGpu waitedForGpu) const;
+    void closeRegionGpuImpl(float                       waitCyclesGpuInCpuRegion,
+                            DdBalanceRegionWaitedForGpu waitedForGpu,
+                            double                      gpuTaskMilliseconds) const;
 
     //! Tells whether the balancing region should be active
     bool useBalancingRegion_;
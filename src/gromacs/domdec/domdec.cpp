@@ -120,6 +120,7 @@
 #include "domdec_setup.h"
 #include "domdec_specatomcomm.h"
 #include "domdec_vsite.h"
+#include "halocompression.h"
 #include "redistribute.h"
 #include "utility.h"
 
@@ -259,66 +260,174 @@ void dd_get_constraint_range(const gmx_domdec_t& dd, int* at_start, int* at_end)
     *at_end   = dd.comm->atomRanges.end(DDAtomRanges::Type::Constraints);
 }
 
-void dd_move_x(gmx_domdec_t* dd, const matrix box, gmx::ArrayRef<gmx::RVec> x, gmx_wallcycle* wcycle)
+//! Packs the coordinates to send for pulse \p ind along DD dimension index \p d
+static void packHaloCoordinates(const gmx_domdec_t&            dd,
+                                int                            d,
+                                const gmx_domdec_ind_t&        ind,
+                                const matrix                   box,
+                                gmx::ArrayRef<const gmx::RVec> x,
+                                gmx::ArrayRef<gmx::RVec>       sendBuffer)
 {
-    wallcycle_start(wcycle, WallCycleCounter::MoveX);
+    const bool bPBC   = (dd.ci[dd.dim[d]] == 0);
+    const bool bScrew = (bPBC && dd.unitCellInfo.haveScrewPBC && dd.dim[d] == XX);
+    rvec       shift  = { 0, 0, 0 };
+    if (bPBC)
+    {
+        copy_rvec(box[dd.dim[d]], shift);
+    }
+
+    int n = 0;
+    if (!bPBC)
+    {
+        for (int j : ind.index)
+        {
+            sendBuffer[n] = x[j];
+            n++;
+        }
+    }
+    else if (!bScrew)
+    {
+        for (int j : ind.index)
+        {
+            /* We need to shift the coordinates */
+            for (int dim = 0; dim < DIM; dim++)
+            {
+                sendBuffer[n][dim] = x[j][dim] + shift[dim];
+            }
+            n++;
+        }
+    }
+    else
+    {
+        for (int j : ind.index)
+        {
+            /* Shift x */
+            sendBuffer[n][XX] = x[j][XX] + shift[XX];
+            /* Rotate y and z.
+             * This operation requires a special shift force
+             * treatment, which is performed in calc_vir.
+             */
+            sendBuffer[n][YY] = box[YY][YY] - x[j][YY];
+            sendBuffer[n][ZZ] = box[ZZ][ZZ] - x[j][ZZ];
+            n++;
+        }
+    }
+}
 
-    rvec shift = { 0, 0, 0 };
+//! Copies received coordinates, when not received in place, to the zones they belong to
+static void unpackHaloCoordinates(const gmx_domdec_ind_t&        ind,
+                                  int                            nzone,
+                                  gmx::ArrayRef<const gmx::RVec> receiveBuffer,
+                                  gmx::ArrayRef<gmx::RVec>       x)
+{
+    int j = 0;
+    for (int zone = 0; zone < nzone; zone++)
+    {
+        for (int i = ind.cell2at0[zone]; i < ind.cell2at1[zone]; i++)
+        {
+            x[i] = receiveBuffer[j++];
+        }
+    }
+}
+
+/*! \brief Sends \p sendBuffer and receives halo coordinates along DD dimension index \p d
+ *
+ * The coordinates are received in compressed format, in \p compressedReceiveBuffer,
+ * when \p receiveCompressed is true, otherwise directly in \p receiveBuffer.
+ */
+template<typename T>
+static void sendrecvHaloCoordinates(gmx_domdec_t*                dd,
+                                    int                          d,
+                                    gmx::ArrayRef<T>             sendBuffer,
+                                    bool                         receiveCompressed,
+                                    gmx::ArrayRef<gmx::RVec>     receiveBuffer,
+                                    gmx::ArrayRef<std::uint16_t> compressedReceiveBuffer)
+{
+    if (receiveCompressed)
+    {
+        ddSendrecv(dd, d, dddirBackward, sendBuffer, compressedReceiveBuffer);
+    }
+    else
+    {
+        ddSendrecv(dd, d, dddirBackward, sendBuffer, receiveBuffer);
+    }
+}
+
+/*! \brief Sends and receives halo coordinates along DD dimension index \p d
+ *
+ * The coordinates are compressed when sent to a rank for which halo
+ * compression is enabled and decompressed when received from such a rank.
+ * As the two directions are set up independently, the send and receive
+ * formats can differ.
+ */
+static void sendrecvHaloCoordinates(gmx_domdec_t*            dd,
+                                    int                      d,
+                                    gmx::ArrayRef<gmx::RVec> sendBuffer,
+                                    gmx::ArrayRef<gmx::RVec> receiveBuffer)
+{
+    gmx_domdec_comm_t* comm              = dd->comm.get();
+    const bool         sendCompressed    = comm->compressHaloXSend[d];
+    const bool         receiveCompressed = comm->compressHaloXReceive[d];
+
+    if (receiveCompressed)
+    {
+        /* The receive size is the worst case, as we do not know
+         * whether the sender could use fixed-point values.
+         */
+        comm->compressedReceiveBuffer.resize(gmx::compressedHaloBufferSize(receiveBuffer.ssize()));
+    }
+    if (sendCompressed)
+    {
+        comm->compressedSendBuffer.resize(gmx::compressedHaloBufferSize(sendBuffer.ssize()));
+        const std::size_t sendSize = gmx::compressHaloCoordinates(
+                sendBuffer, comm->haloCompressionTolerance, comm->compressedSendBuffer);
+        sendrecvHaloCoordinates(dd,
+                                d,
+                                gmx::arrayRefFromArray(comm->compressedSendBuffer.data(), sendSize),
+                                receiveCompressed,
+                                receiveBuffer,
+                                comm->compressedReceiveBuffer);
+    }
+    else
+    {
+        sendrecvHaloCoordinates(
+                dd, d, sendBuffer, receiveCompressed, receiveBuffer, comm->compressedReceiveBuffer);
+    }
+    if (receiveCompressed)
+    {
+        gmx::decompressHaloCoordinates(comm->compressedReceiveBuffer, receiveBuffer);
+    }
+}
 
+/*! \brief Communicates the halo coordinates for all pulses
+ *
+ * When \p firstPulseIsDone is true, the first pulse has already been
+ * communicated by dd_move_x_start() and is skipped.
+ */
+static void moveHaloCoordinates(gmx_domdec_t*            dd,
+                                const matrix             box,
+                                gmx::ArrayRef<gmx::RVec> x,
+                                bool                     firstPulseIsDone)
+{
     gmx_domdec_comm_t* comm = dd->comm.get();
 
     int nzone   = 1;
     int nat_tot = comm->atomRanges.numHomeAtoms();
     for (int d = 0; d < dd->ndim; d++)
     {
-        const bool bPBC   = (dd->ci[dd->dim[d]] == 0);
-        const bool bScrew = (bPBC && dd->unitCellInfo.haveScrewPBC && dd->dim[d] == XX);
-        if (bPBC)
-        {
-            copy_rvec(box[dd->dim[d]], shift);
-        }
         gmx_domdec_comm_dim_t* cd = &comm->cd[d];
         for (const gmx_domdec_ind_t& ind : cd->ind)
         {
-            DDBufferAccess<gmx::RVec> sendBufferAccess(comm->rvecBuffer, ind.nsend[nzone + 1]);
-            gmx::ArrayRef<gmx::RVec>& sendBuffer = sendBufferAccess.buffer;
-            int                       n          = 0;
-            if (!bPBC)
+            if (firstPulseIsDone && d == 0 && &ind == &cd->ind[0])
             {
-                for (int j : ind.index)
-                {
-                    sendBuffer[n] = x[j];
-                    n++;
-                }
-            }
-            else if (!bScrew)
-            {
-                for (int j : ind.index)
-                {
-                    /* We need to shift the coordinates */
-                    for (int d = 0; d < DIM; d++)
-                    {
-                        sendBuffer[n][d] = x[j][d] + shift[d];
-                    }
-                    n++;
-                }
-            }
-            else
-            {
-                for (int j : ind.index)
-                {
-                    /* Shift x */
-                    sendBuffer[n][XX] = x[j][XX] + shift[XX];
-                    /* Rotate y and z.
-                     * This operation requires a special shift force
-                     * treatment, which is performed in calc_vir.
-                     */
-                    sendBuffer[n][YY] = box[YY][YY] - x[j][YY];
-                    sendBuffer[n][ZZ] = box[ZZ][ZZ] - x[j][ZZ];
-                    n++;
-                }
+                nat_tot += ind.nrecv[nzone + 1];
+                continue;
             }
 
+            DDBufferAccess<gmx::RVec> sendBufferAccess(comm->rvecBuffer, ind.nsend[nzone + 1]);
+            gmx::ArrayRef<gmx::RVec>& sendBuffer = sendBufferAccess.buffer;
+            packHaloCoordinates(*dd, d, ind, box, x, sendBuffer);
+
             DDBufferAccess<gmx::RVec> receiveBufferAccess(
                     comm->rvecBuffer2, cd->receiveInPlace ? 0 : ind.nrecv[nzone + 1]);
 
@@ -332,31 +441,233 @@ void dd_move_x(gmx_domdec_t* dd, const matrix box, gmx::ArrayRef<gmx::RVec> x, g
                 receiveBuffer = receiveBufferAccess.buffer;
             }
             /* Send and receive the coordinates */
-            ddSendrecv(dd, d, dddirBackward, sendBuffer, receiveBuffer);
+            sendrecvHaloCoordinates(dd, d, sendBuffer, receiveBuffer);
 
             if (!cd->receiveInPlace)
             {
-                int j = 0;
-                for (int zone = 0; zone < nzone; zone++)
-                {
-                    for (int i = ind.cell2at0[zone]; i < ind.cell2at1[zone]; i++)
-                    {
-                        x[i] = receiveBuffer[j++];
-                    }
-                }
+                unpackHaloCoordinates(ind, nzone, receiveBuffer, x);
             }
             nat_tot += ind.nrecv[nzone + 1];
         }
         nzone += nzone;
     }
+}
+
+void dd_move_x(gmx_domdec_t* dd, const matrix box, gmx::ArrayRef<gmx::RVec> x, gmx_wallcycle* wcycle)
+{
+    wallcycle_start(wcycle, WallCycleCounter::MoveX);
+
+    moveHaloCoordinates(dd, box, x, false);
 
     wallcycle_stop(wcycle, WallCycleCounter::MoveX);
 }
 
-void dd_move_f(gmx_domdec_t* dd, gmx::ForceWithShiftForces* forceWithShiftForces, gmx_wallcycle* wcycle)
+/*! \brief Starts the first coordinate pulse along the first DD dimension index
+ *
+ * Receives in \p pending->compressedReceiveBuffer when
+ * \p pending->isReceiveCompressed is set, in \p receiveBuffer otherwise.
+ */
+template<typename T>
+static void startSendrecvHaloCoordinates(gmx_domdec_t*            dd,
+                                         gmx::ArrayRef<T>         sendBuffer,
+                                         gmx::ArrayRef<gmx::RVec> receiveBuffer,
+                                         DDPendingHaloPulse*      pending)
 {
-    wallcycle_start(wcycle, WallCycleCounter::MoveF);
+    if (pending->isReceiveCompressed)
+    {
+        ddStartSendrecv(dd,
+                        0,
+                        dddirBackward,
+                        sendBuffer,
+                        gmx::ArrayRef<std::uint16_t>(pending->compressedReceiveBuffer),
+                        pending);
+    }
+    else
+    {
+        ddStartSendrecv(dd, 0, dddirBackward, sendBuffer, receiveBuffer, pending);
+    }
+}
 
+void dd_move_x_start(gmx_domdec_t* dd, const matrix box, gmx::ArrayRef<gmx::RVec> x, gmx_wallcycle* wcycle)
+{
+    wallcycle_start(wcycle, WallCycleCounter::MoveX);
+
+    gmx_domdec_comm_t*           comm    = dd->comm.get();
+    DDPendingHaloPulse&          pending = comm->pendingMoveX;
+    const gmx_domdec_comm_dim_t& cd      = comm->cd[0];
+    const gmx_domdec_ind_t&      ind     = cd.ind[0];
+    const int                    nzone   = 1;
+
+    GMX_ASSERT(!pending.isActive, "Can not start a coordinate halo exchange twice");
+
+    pending.sendBuffer.resize(ind.nsend[nzone + 1]);
+    packHaloCoordinates(*dd, 0, ind, box, x, pending.sendBuffer);
+
+    gmx::ArrayRef<gmx::RVec> receiveBuffer;
+    if (cd.receiveInPlace)
+    {
+        receiveBuffer = gmx::arrayRefFromArray(x.data() + comm->atomRanges.numHomeAtoms(),
+                                               ind.nrecv[nzone + 1]);
+    }
+    else
+    {
+        pending.receiveBuffer.resize(ind.nrecv[nzone + 1]);
+        receiveBuffer = pending.receiveBuffer;
+    }
+
+    /* The send and receive formats are set up independently and can differ */
+    const bool sendCompressed   = comm->compressHaloXSend[0];
+    pending.isReceiveCompressed = comm->compressHaloXReceive[0];
+    if (pending.isReceiveCompressed)
+    {
+        pending.compressedReceiveBuffer.resize(gmx::compressedHaloBufferSize(receiveBuffer.ssize()));
+    }
+    if (sendCompressed)
+    {
+        pending.compressedSendBuffer.resize(
+                gmx::compressedHaloBufferSize(pending.sendBuffer.size()));
+        const std::size_t sendSize = gmx::compressHaloCoordinates(
+                pending.sendBuffer, comm->haloCompressionTolerance, pending.compressedSendBuffer);
+        startSendrecvHaloCoordinates(
+                dd,
+                gmx::arrayRefFromArray(pending.compressedSendBuffer.data(), sendSize),
+                receiveBuffer,
+                &pending);
+    }
+    else
+    {
+        startSendrecvHaloCoordinates(
+                dd, gmx::ArrayRef<gmx::RVec>(pending.sendBuffer), receiveBuffer, &pending);
+    }
+
+    wallcycle_stop(wcycle, WallCycleCounter::MoveX);
+}
+
+void dd_move_x_finish(gmx_domdec_t* dd, const matrix box, gmx::ArrayRef<gmx::RVec> x, gmx_wallcycle* wcycle)
+{
+    wallcycle_start(wcycle, WallCycleCounter::MoveX);
+
+    gmx_domdec_comm_t*  comm    = dd->comm.get();
+    DDPendingHaloPulse& pending = comm->pendingMoveX;
+
+    GMX_ASSERT(pending.isActive, "Can only finish a started coordinate halo exchange");
+
+    wallcycle_sub_start(wcycle, WallCycleSubCounter::DDHaloWait);
+    ddWaitSendrecv(&pending);
+    wallcycle_sub_stop(wcycle, WallCycleSubCounter::DDHaloWait);
+
+    const gmx_domdec_comm_dim_t& cd  = comm->cd[0];
+    const gmx_domdec_ind_t&      ind = cd.ind[0];
+    if (pending.isReceiveCompressed)
+    {
+        gmx::ArrayRef<gmx::RVec> receiveBuffer =
+                cd.receiveInPlace ? gmx::arrayRefFromArray(x.data() + comm->atomRanges.numHomeAtoms(),
+                                                           ind.nrecv[2])
+                                  : gmx::ArrayRef<gmx::RVec>(pending.receiveBuffer);
+        gmx::decompressHaloCoordinates(pending.compressedReceiveBuffer, receiveBuffer);
+    }
+    if (!cd.receiveInPlace)
+    {
+        unpackHaloCoordinates(ind, 1, pending.receiveBuffer, x);
+    }
+
+    moveHaloCoordinates(dd, box, x, true);
+
+    wallcycle_stop(wcycle, WallCycleCounter::MoveX);
+}
+
+//! Adds the forces received for pulse \p ind along DD dimension index \p d
+static void addHaloForces(const gmx_domdec_t&            dd,
+                          int                            d,
+                          const gmx_domdec_ind_t&        ind,
+                          bool                           computeVirial,
+                          gmx::ArrayRef<const gmx::RVec> receiveBuffer,
+                          gmx::ArrayRef<gmx::RVec>       f,
+                          gmx::ArrayRef<gmx::RVec>       fshift)
+{
+    /* Only forces in domains near the PBC boundaries need to
+       consider PBC in the treatment of fshift */
+    const bool shiftForcesNeedPbc = (computeVirial && dd.ci[dd.dim[d]] == 0);
+    const bool applyScrewPbc = (shiftForcesNeedPbc && dd.unitCellInfo.haveScrewPBC && dd.dim[d] == XX);
+    /* Determine which shift vector we need */
+    ivec vis       = { 0, 0, 0 };
+    vis[dd.dim[d]] = 1;
+    const int is   = gmx::ivecToShiftIndex(vis);
+
+    /* Add the received forces */
+    int n = 0;
+    if (!shiftForcesNeedPbc)
+    {
+        for (int j : ind.index)
+        {
+            for (int dim = 0; dim < DIM; dim++)
+            {
+                f[j][dim] += receiveBuffer[n][dim];
+            }
+            n++;
+        }
+    }
+    else if (!applyScrewPbc)
+    {
+        for (int j : ind.index)
+        {
+            for (int dim = 0; dim < DIM; dim++)
+            {
+                f[j][dim] += receiveBuffer[n][dim];
+            }
+            /* Add this force to the shift force */
+            for (int dim = 0; dim < DIM; dim++)
+            {
+                fshift[is][dim] += receiveBuffer[n][dim];
+            }
+            n++;
+        }
+    }
+    else
+    {
+        for (int j : ind.index)
+        {
+            /* Rotate the force */
+            f[j][XX] += receiveBuffer[n][XX];
+            f[j][YY] -= receiveBuffer[n][YY];
+            f[j][ZZ] -= receiveBuffer[n][ZZ];
+            if (shiftForcesNeedPbc)
+            {
+                /* Add this force to the shift force */
+                for (int dim = 0; dim < DIM; dim++)
+                {
+                    fshift[is][dim] += receiveBuffer[n][dim];
+                }
+            }
+            n++;
+        }
+    }
+}
+
+//! Copies the halo forces to send for pulse \p ind, when not sending in place
+static void packHaloForces(const gmx_domdec_ind_t&        ind,
+                           int                            nzone,
+                           gmx::ArrayRef<const gmx::RVec> f,
+                           gmx::ArrayRef<gmx::RVec>       sendBuffer)
+{
+    int j = 0;
+    for (int zone = 0; zone < nzone; zone++)
+    {
+        for (int i = ind.cell2at0[zone]; i < ind.cell2at1[zone]; i++)
+        {
+            sendBuffer[j++] = f[i];
+        }
+    }
+}
+
+/*! \brief Communicates and reduces the halo forces for all pulses
+ *
+ * When \p lastPulseIsDone is true, the last pulse along the last
+ * dimension has already been communicated by dd_move_f_start()
+ * and reduced by dd_move_f_finish() and is skipped.
+ */
+static void moveHaloForces(gmx_domdec_t* dd, gmx::ForceWithShiftForces* forceWithShiftForces, bool lastPulseIsDone)
+{
     gmx::ArrayRef<gmx::RVec> f      = forceWithShiftForces->force();
     gmx::ArrayRef<gmx::RVec> fshift = forceWithShiftForces->shiftForces();
 
@@ -365,27 +676,22 @@ void dd_move_f(gmx_domdec_t* dd, gmx::ForceWithShiftForces* forceWithShiftForces
     int                nat_tot = comm.atomRanges.end(DDAtomRanges::Type::Zones);
     for (int d = dd->ndim - 1; d >= 0; d--)
     {
-        /* Only forces in domains near the PBC boundaries need to
-           consider PBC in the treatment of fshift */
-        const bool shiftForcesNeedPbc =
-                (forceWithShiftForces->computeVirial() && dd->ci[dd->dim[d]] == 0);
-        const bool applyScrewPbc =
-                (shiftForcesNeedPbc && dd->unitCellInfo.haveScrewPBC && dd->dim[d] == XX);
-        /* Determine which shift vector we need */
-        ivec vis        = { 0, 0, 0 };
-        vis[dd->dim[d]] = 1;
-        const int is    = gmx::ivecToShiftIndex(vis);
-
         /* Loop over the pulses */
         const gmx_domdec_comm_dim_t& cd = comm.cd[d];
         for (int p = cd.numPulses() - 1; p >= 0; p--)
         {
-            const gmx_domdec_ind_t&   ind = cd.ind[p];
-            DDBufferAccess<gmx::RVec> receiveBufferAccess(comm.rvecBuffer, ind.nsend[nzone + 1]);
-            gmx::ArrayRef<gmx::RVec>& receiveBuffer = receiveBufferAccess.buffer;
+            const gmx_domdec_ind_t& ind = cd.ind[p];
 
             nat_tot -= ind.nrecv[nzone + 1];
 
+            if (lastPulseIsDone && d == dd->ndim - 1 && p == cd.numPulses() - 1)
+            {
+                continue;
+            }
+
+            DDBufferAccess<gmx::RVec> receiveBufferAccess(comm.rvecBuffer, ind.nsend[nzone + 1]);
+            gmx::ArrayRef<gmx::RVec>& receiveBuffer = receiveBufferAccess.buffer;
+
             DDBufferAccess<gmx::RVec> sendBufferAccess(
                     comm.rvecBuffer2, cd.receiveInPlace ? 0 : ind.nrecv[nzone + 1]);
 
@@ -397,68 +703,87 @@ void dd_move_f(gmx_domdec_t* dd, gmx::ForceWithShiftForces* forceWithShiftForces
             else
             {
                 sendBuffer = sendBufferAccess.buffer;
-                int j      = 0;
-                for (int zone = 0; zone < nzone; zone++)
-                {
-                    for (int i = ind.cell2at0[zone]; i < ind.cell2at1[zone]; i++)
-                    {
-                        sendBuffer[j++] = f[i];
-                    }
-                }
+                packHaloForces(ind, nzone, f, sendBuffer);
             }
             /* Communicate the forces */
             ddSendrecv(dd, d, dddirForward, sendBuffer, receiveBuffer);
-            /* Add the received forces */
-            int n = 0;
-            if (!shiftForcesNeedPbc)
-            {
-                for (int j : ind.index)
-                {
-                    for (int d = 0; d < DIM; d++)
-                    {
-                        f[j][d] += receiveBuffer[n][d];
-                    }
-                    n++;
-                }
-            }
-            else if (!applyScrewPbc)
-            {
-                for (int j : ind.index)
-                {
-                    for (int d = 0; d < DIM; d++)
-                    {
-                        f[j][d] += receiveBuffer[n][d];
-                    }
-                    /* Add this force to the shift force */
-                    for (int d = 0; d < DIM; d++)
-                    {
-                        fshift[is][d] += receiveBuffer[n][d];
-                    }
-                    n++;
-                }
-            }
-            else
-            {
-                for (int j : ind.index)
-                {
-                    /* Rotate the force */
-                    f[j][XX] += receiveBuffer[n][XX];
-                    f[j][YY] -= receiveBuffer[n][YY];
-                    f[j][ZZ] -= receiveBuffer[n][ZZ];
-                    if (shiftForcesNeedPbc)
-                    {
-                        /* Add this force to the shift force */
-                        for (int d = 0; d < DIM; d++)
-                        {
-                            fshift[is][d] += receiveBuffer[n][d];
-                        }
-                    }
-                    n++;
-                }
-            }
+            addHaloForces(*dd, d, ind, forceWithShiftForces->computeVirial(), receiveBuffer, f, fshift);
         }
         nzone /= 2;
     }
+}
+
+void dd_move_f(gmx_domdec_t* dd, gmx::ForceWithShiftForces* forceWithShiftForces, gmx_wallcycle* wcycle)
+{
+    wallcycle_start(wcycle, WallCycleCounter::MoveF);
+
+    moveHaloForces(dd, forceWithShiftForces, false);
+
+    wallcycle_stop(wcycle, WallCycleCounter::MoveF);
+}
+
+void dd_move_f_start(gmx_domdec_t* dd, gmx::ForceWithShiftForces* forceWithShiftForces, gmx_wallcycle* wcycle)
+{
+    wallcycle_start(wcycle, WallCycleCounter::MoveF);
+
+    gmx::ArrayRef<const gmx::RVec> f = forceWithShiftForces->force();
+
+    gmx_domdec_comm_t*           comm    = dd->comm.get();
+    DDPendingHaloPulse&          pending = comm->pendingMoveF;
+    const int                    d       = dd->ndim - 1;
+    const gmx_domdec_comm_dim_t& cd      = comm->cd[d];
+    const gmx_domdec_ind_t&      ind     = cd.ind[cd.numPulses() - 1];
+    const int                    nzone   = comm->zones.n / 2;
+    const int nat_tot = comm->atomRanges.end(DDAtomRanges::Type::Zones) - ind.nrecv[nzone + 1];
+
+    GMX_ASSERT(!pending.isActive, "Can not start a force halo exchange twice");
+
+    /* Always copy, as the force buffer is modified before completion */
+    pending.sendBuffer.resize(ind.nrecv[nzone + 1]);
+    if (cd.receiveInPlace)
+    {
+        std::copy(f.begin() + nat_tot, f.begin() + nat_tot + ind.nrecv[nzone + 1], pending.sendBuffer.begin());
+    }
+    else
+    {
+        packHaloForces(ind, nzone, f, pending.sendBuffer);
+    }
+    pending.receiveBuffer.resize(ind.nsend[nzone + 1]);
+    ddStartSendrecv(dd,
+                    d,
+                    dddirForward,
+                    gmx::ArrayRef<gmx::RVec>(pending.sendBuffer),
+                    gmx::ArrayRef<gmx::RVec>(pending.receiveBuffer),
+                    &pending);
+
+    wallcycle_stop(wcycle, WallCycleCounter::MoveF);
+}
+
+void dd_move_f_finish(gmx_domdec_t* dd, gmx::ForceWithShiftForces* forceWithShiftForces, gmx_wallcycle* wcycle)
+{
+    wallcycle_start(wcycle, WallCycleCounter::MoveF);
+
+    gmx_domdec_comm_t*  comm    = dd->comm.get();
+    DDPendingHaloPulse& pending = comm->pendingMoveF;
+
+    GMX_ASSERT(pending.isActive, "Can only finish a started force halo exchange");
+
+    wallcycle_sub_start(wcycle, WallCycleSubCounter::DDHaloWait);
+    ddWaitSendrecv(&pending);
+    wallcycle_sub_stop(wcycle, WallCycleSubCounter::DDHaloWait);
+
+    const int                    d  = dd->ndim - 1;
+    const gmx_domdec_comm_dim_t& cd = comm->cd[d];
+    addHaloForces(*dd,
+                  d,
+                  cd.ind[cd.numPulses() - 1],
+                  forceWithShiftForces->computeVirial(),
+                  pending.receiveBuffer,
+                  forceWithShiftForces->force(),
+                  forceWithShiftForces->shiftForces());
+
+    moveHaloForces(dd, forceWithShiftForces, true);
+
     wallcycle_stop(wcycle, WallCycleCounter::MoveF);
 }
 
@@ -864,6 +1189,11 @@ bool ddUsesUpdateGroups(const gmx_domdec_t& dd)
     return dd.comm->systemInfo.useUpdateGroups;
 }
 
+bool dd_overlapCpuHaloExchange(const gmx_domdec_t& dd)
+{
+    return dd.comm->ddSettings.overlapHaloExchange;
+}
+
 void dd_cycles_add(const gmx_domdec_t* dd, float cycles, int ddCycl)
 {
     /* Note that the cycles value can be incorrect, either 0 or some
@@ -1160,6 +1490,151 @@ static void setup_neighbor_relations(gmx_domdec_t* dd)
     }
 }
 
+#if GMX_MPI
+/*! \brief Returns the number of pairs of neighboring DD cells that are on different physical nodes
+ *
+ * \param[in] numCells        The number of DD cells along each dimension
+ * \param[in] nodeOfDDIndex   The physical node index for each DD cell index
+ */
+static int countInterNodeNeighborPairs(const ivec numCells, gmx::ArrayRef<const int> nodeOfDDIndex)
+{
+    int numPairs = 0;
+    for (int ddIndex = 0; ddIndex < nodeOfDDIndex.ssize(); ddIndex++)
+    {
+        ivec xyz;
+        ddindex2xyz(numCells, ddIndex, xyz);
+        for (int d = 0; d < DIM; d++)
+        {
+            if (numCells[d] > 1)
+            {
+                ivec neighbor;
+                copy_ivec(xyz, neighbor);
+                neighbor[d] = (xyz[d] + 1) % numCells[d];
+                if (nodeOfDDIndex[ddIndex] != nodeOfDDIndex[dd_index(numCells, neighbor)])
+                {
+                    numPairs++;
+                }
+            }
+        }
+    }
+
+    return numPairs;
+}
+
+/*! \brief Returns the DD cell coordinates of \p rank when each physical node gets a block
+ * of \p blockSize DD cells
+ */
+static void nodeBlockedRankToXyz(const ivec numCells, const ivec blockSize, int rank, ivec xyz)
+{
+    const int numRanksPerNode = blockSize[XX] * blockSize[YY] * blockSize[ZZ];
+    ivec      numBlocks;
+    for (int d = 0; d < DIM; d++)
+    {
+        numBlocks[d] = numCells[d] / blockSize[d];
+    }
+    ivec blockXyz, xyzInBlock;
+    ddindex2xyz(numBlocks, rank / numRanksPerNode, blockXyz);
+    ddindex2xyz(blockSize, rank % numRanksPerNode, xyzInBlock);
+    for (int d = 0; d < DIM; d++)
+    {
+        xyz[d] = blockXyz[d] * blockSize[d] + xyzInBlock[d];
+    }
+}
+
+/*! \brief Returns the key for reordering the PP ranks in \p comm so that the DD cells
+ * of each physical node form a compact block
+ *
+ * This reduces the number of halo communication neighbors that are on other
+ * physical nodes. Requires the same number of ranks on all nodes and consecutive
+ * ranks within each node. Returns the current rank when this is not possible
+ * or does not reduce the number of inter-node neighbor pairs.
+ */
+static int physicalNodeBlockedRankKey(const gmx::MDLogger& mdlog, MPI_Comm comm, const ivec numCells)
+{
+    int rank, numRanks;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &numRanks);
+
+    MPI_Comm nodeComm = MPI_COMM_NULL;
+    MPI_Comm_split(comm, gmx_physicalnode_id_hash(), rank, &nodeComm);
+    int rankInNode, numRanksInNode;
+    MPI_Comm_rank(nodeComm, &rankInNode);
+    MPI_Comm_size(nodeComm, &numRanksInNode);
+
+    /* Check that the node is a consecutive range of ranks with equal sizes over all nodes */
+    const int firstRankInNode = rank - rankInNode;
+    int       firstRankMinMax[2] = { firstRankInNode, -firstRankInNode };
+    MPI_Allreduce(MPI_IN_PLACE, firstRankMinMax, 2, MPI_INT, MPI_MIN, nodeComm);
+    MPI_Comm_free(&nodeComm);
+    const bool nodeIsConsecutive = (firstRankMinMax[0] == -firstRankMinMax[1]
+                                    && firstRankInNode % numRanksInNode == 0);
+    int nodeSizeMinMax[2] = { nodeIsConsecutive ? numRanksInNode : 0, -numRanksInNode };
+    MPI_Allreduce(MPI_IN_PLACE, nodeSizeMinMax, 2, MPI_INT, MPI_MIN, comm);
+    const int numRanksPerNode = nodeSizeMinMax[0];
+    if (numRanksPerNode != -nodeSizeMinMax[1] || numRanksPerNode <= 1 || numRanksPerNode == numRanks)
+    {
+        return rank;
+    }
+
+    /* With the default order, node n has DD indices n*numRanksPerNode and up */
+    std::vector<int> nodeOfDDIndex(numRanks);
+    for (int i = 0; i < numRanks; i++)
+    {
+        nodeOfDDIndex[i] = i / numRanksPerNode;
+    }
+    const int numPairsDefault = countInterNodeNeighborPairs(numCells, nodeOfDDIndex);
+
+    /* Find the block of DD cells per node with the fewest inter-node neighbor pairs */
+    int  numPairsBest = numPairsDefault;
+    ivec blockBest    = { 0, 0, 0 };
+    for (int bx = 1; bx <= numCells[XX]; bx++)
+    {
+        for (int by = 1; by <= numCells[YY]; by++)
+        {
+            const int bz = numRanksPerNode / (bx * by);
+            if (numCells[XX] % bx != 0 || numCells[YY] % by != 0 || bz == 0
+                || bx * by * bz != numRanksPerNode || numCells[ZZ] % bz != 0)
+            {
+                continue;
+            }
+            const ivec block = { bx, by, bz };
+            for (int r = 0; r < numRanks; r++)
+            {
+                ivec xyz;
+                nodeBlockedRankToXyz(numCells, block, r, xyz);
+                nodeOfDDIndex[dd_index(numCells, xyz)] = r / numRanksPerNode;
+            }
+            const int numPairs = countInterNodeNeighborPairs(numCells, nodeOfDDIndex);
+            if (numPairs < numPairsBest)
+            {
+                numPairsBest = numPairs;
+                copy_ivec(block, blockBest);
+            }
+        }
+    }
+
+    if (numPairsBest == numPairsDefault)
+    {
+        return rank;
+    }
+
+    GMX_LOG(mdlog.info)
+            .appendTextFormatted(
+                    "Placing the DD cells of each physical node in a %d x %d x %d block, "
+                    "this reduces the neighbor pairs across nodes from %d to %d",
+                    blockBest[XX],
+                    blockBest[YY],
+                    blockBest[ZZ],
+                    numPairsDefault,
+                    numPairsBest);
+
+    ivec xyz;
+    nodeBlockedRankToXyz(numCells, blockBest, rank, xyz);
+
+    return dd_index(numCells, xyz);
+}
+#endif
+
 static void make_pp_communicator(const gmx::MDLogger& mdlog,
                                  gmx_domdec_t*        dd,
                                  t_commrec gmx_unused* cr,
@@ -1184,6 +1659,25 @@ static void make_pp_communicator(const gmx::MDLogger& mdlog,
             periods[i] = TRUE;
         }
         MPI_Comm comm_cart = MPI_COMM_NULL;
+        if (reorder)
+        {
+            /* MPI libraries usually ignore the reorder flag, so first try to
+             * place neighboring DD cells on the same physical node ourselves.
+             * The key of rank 0 is 0, so the DD master stays at the same rank.
+             */
+            const int key = physicalNodeBlockedRankKey(mdlog, cr->mpi_comm_mygroup, dd->numCells);
+            int       rank;
+            MPI_Comm_rank(cr->mpi_comm_mygroup, &rank);
+            int keyDiffers = static_cast<int>(key != rank);
+            MPI_Allreduce(MPI_IN_PLACE, &keyDiffers, 1, MPI_INT, MPI_MAX, cr->mpi_comm_mygroup);
+            if (keyDiffers)
+            {
+                MPI_Comm comm_ordered = MPI_COMM_NULL;
+                MPI_Comm_split(cr->mpi_comm_mygroup, 0, key, &comm_ordered);
+                cr->mpi_comm_mygroup = comm_ordered;
+                reorder              = false;
+            }
+        }
         MPI_Cart_create(cr->mpi_comm_mygroup, DIM, dd->numCells, periods, static_cast<int>(reorder), &comm_cart);
         /* We overwrite the old communicator with the new cartesian one */
         cr->mpi_comm_mygroup = comm_cart;
@@ -1613,6 +2107,146 @@ static int multi_body_bondeds_count(const gmx_mtop_t& mtop)
     return n;
 }
 
+/*! \brief Returns cell fractions per dimension that put equal numbers of atoms in each cell
+ *
+ * This is used for static load balancing of systems with strongly
+ * inhomogeneous atom densities, such as droplets or vesicles in vacuum,
+ * where a uniform grid leaves ranks nearly or completely empty.
+ * The boundaries follow the atom density along each decomposed dimension
+ * separately, the grid stays Cartesian. Cells are not made smaller than
+ * \p cellsizeLimit nor smaller than half the cut-off distance, to avoid
+ * many communication pulses. Only the master rank needs \p x.
+ * An empty vector is returned for dimensions that are not decomposed.
+ */
+static std::array<std::vector<real>, DIM> getDensityBasedCellFractions(const gmx::MDLogger& mdlog,
+                                                                       DDRole               ddRole,
+                                                                       MPI_Comm communicator,
+                                                                       const ivec numDomains,
+                                                                       const matrix       box,
+                                                                       const gmx_ddbox_t& ddbox,
+                                                                       const real cellsizeLimit,
+                                                                       const real cutoff,
+                                                                       gmx::ArrayRef<const gmx::RVec> x)
+{
+    std::array<std::vector<real>, DIM> cellFractions;
+
+    const int npbcdim = ddbox.npbcdim;
+    matrix    triclinicCorrectionMatrix;
+    make_tric_corr_matrix(npbcdim, box, triclinicCorrectionMatrix);
+
+    for (int d = 0; d < DIM; d++)
+    {
+        const int numCells = numDomains[d];
+        if (numCells <= 1)
+        {
+            continue;
+        }
+
+        std::vector<real>& frac = cellFractions[d];
+        frac.resize(numCells);
+
+        if (ddRole == DDRole::Master)
+        {
+            /* Histogram the atoms along this dimension in DD cell coordinates */
+            const int           c_binsPerCell = 64;
+            const int           numBins       = c_binsPerCell * numCells;
+            std::vector<double> histogram(numBins, 0);
+            for (const gmx::RVec& xAtom : x)
+            {
+                real pos = xAtom[d];
+                if (d < npbcdim)
+                {
+                    if (ddbox.tric_dir[d])
+                    {
+                        for (int j = d + 1; j < DIM; j++)
+                        {
+                            pos += xAtom[j] * triclinicCorrectionMatrix[j][d];
+                        }
+                    }
+                    pos -= std::floor(pos / box[d][d]) * box[d][d];
+                }
+                const real f   = (pos - ddbox.box0[d]) / ddbox.box_size[d];
+                const int  bin = std::clamp(static_cast<int>(f * numBins), 0, numBins - 1);
+                histogram[bin] += 1;
+            }
+
+            /* Place boundaries at equal cumulative atom counts */
+            const double      atomsPerCell = x.ssize() / static_cast<double>(numCells);
+            std::vector<real> bounds(numCells + 1);
+            bounds[0]         = 0;
+            bounds[numCells]  = 1;
+            double cumulative = 0;
+            int    cell       = 1;
+            for (int bin = 0; bin < numBins && cell < numCells; bin++)
+            {
+                while (cell < numCells && cumulative + histogram[bin] >= cell * atomsPerCell)
+                {
+                    const double inBin =
+                            (histogram[bin] > 0) ? (cell * atomsPerCell - cumulative) / histogram[bin] : 0;
+                    bounds[cell]       = (bin + inBin) / numBins;
+                    cell++;
+                }
+                cumulative += histogram[bin];
+            }
+            for (int i = 0; i < numCells; i++)
+            {
+                frac[i] = bounds[i + 1] - bounds[i];
+            }
+
+            /* Enforce the minimum cell size by taking volume from the larger cells */
+            const real minCellSize = std::max(
+                    cellsizeLimit,
+                    std::min(ddbox.box_size[d] * ddbox.skew_fac[d] / numCells, real(0.5) * cutoff));
+            const real minFrac = minCellSize / (ddbox.box_size[d] * ddbox.skew_fac[d]);
+            if (numCells * minFrac >= 1)
+            {
+                std::fill(frac.begin(), frac.end(), real(1) / numCells);
+            }
+            for (int iteration = 0; iteration < numCells && numCells * minFrac < 1; iteration++)
+            {
+                real deficit   = 0;
+                real largeFrac = 0;
+                for (int i = 0; i < numCells; i++)
+                {
+                    if (frac[i] < minFrac)
+                    {
+                        deficit += minFrac - frac[i];
+                        frac[i] = minFrac;
+                    }
+                    else if (frac[i] > minFrac)
+                    {
+                        largeFrac += frac[i] - minFrac;
+                    }
+                }
+                if (deficit == 0)
+                {
+                    break;
+                }
+                for (int i = 0; i < numCells; i++)
+                {
+                    if (frac[i] > minFrac)
+                    {
+                        frac[i] -= deficit * (frac[i] - minFrac) / largeFrac;
+                    }
+                }
+            }
+        }
+        gmx_bcast(numCells * sizeof(real), frac.data(), communicator);
+
+        GMX_LOG(mdlog.info)
+                .appendTextFormatted("Using atom-density based static load balancing for the %c direction",
+                                     dim2char(d));
+        std::string relativeCellSizes = "Relative cell sizes:";
+        for (int i = 0; i < numCells; i++)
+        {
+            relativeCellSizes += gmx::formatString(" %5.3f", frac[i]);
+        }
+        GMX_LOG(mdlog.info).appendText(relativeCellSizes);
+    }
+
+    return cellFractions;
+}
+
 static int dd_getenv(const gmx::MDLogger& mdlog, const char* env_var, int def)
 {
     int   nst = def;
@@ -2259,7 +2893,8 @@ static void set_dd_limits(const gmx::MDLogger& mdlog,
                           const int            numPPRanks,
                           const gmx_mtop_t&    mtop,
                           const t_inputrec&    ir,
-                          const gmx_ddbox_t&   ddbox)
+                          const gmx_ddbox_t&   ddbox,
+                          gmx::ArrayRef<const std::vector<real>> densityCellFractions)
 {
     gmx_domdec_comm_t* comm = dd->comm.get();
     comm->ddSettings        = ddSettings;
@@ -2304,6 +2939,14 @@ static void set_dd_limits(const gmx::MDLogger& mdlog,
         comm->slb_frac[XX] = get_slb_frac(mdlog, "x", dd->numCells[XX], options.cellSizeX);
         comm->slb_frac[YY] = get_slb_frac(mdlog, "y", dd->numCells[YY], options.cellSizeY);
         comm->slb_frac[ZZ] = get_slb_frac(mdlog, "z", dd->numCells[ZZ], options.cellSizeZ);
+        for (int d = 0; d < DIM; d++)
+        {
+            /* User supplied cell sizes take precedence */
+            if (comm->slb_frac[d].empty() && !densityCellFractions.empty())
+            {
+                comm->slb_frac[d] = densityCellFractions[d];
+            }
+        }
     }
 
     /* Set the multi-body cut-off and cellsize limit for DLB */
@@ -2632,6 +3275,69 @@ bool dd_bonded_molpbc(const gmx_domdec_t& dd, PbcType pbcType)
                  && (dd.numCells[ZZ] > 1 || pbcType == PbcType::XY)));
 }
 
+void setHaloCompressionNeighbors(gmx_domdec_t* dd,
+                                 int           haloCompression,
+                                 int           physicalNodeId,
+                                 real          tolerance)
+{
+    GMX_RELEASE_ASSERT(tolerance > 0, "Halo compression needs a positive tolerance");
+
+    gmx_domdec_comm_t* comm = dd->comm.get();
+
+    comm->haloCompressionTolerance = tolerance;
+
+    for (int d = 0; d < dd->ndim; d++)
+    {
+        /* Coordinates are sent backward, so we receive from the forward neighbor */
+        int thisNode     = physicalNodeId;
+        int forwardNode  = 0;
+        int backwardNode = 0;
+        ddSendrecv(dd, d, dddirBackward, &thisNode, 1, &forwardNode, 1);
+        ddSendrecv(dd, d, dddirForward, &thisNode, 1, &backwardNode, 1);
+        comm->compressHaloXSend[d]    = (haloCompression > 1 || backwardNode != thisNode);
+        comm->compressHaloXReceive[d] = (haloCompression > 1 || forwardNode != thisNode);
+    }
+}
+
+/*! \brief Sets up which halo coordinate communication is compressed
+ *
+ * With \p haloCompression = 1 compression is used with ranks on other
+ * physical nodes, with 2 with all ranks, which is useful for testing.
+ * The tolerance is a small fraction of the pair list buffer, such that
+ * the coordinate errors are small compared to the displacements the
+ * Verlet buffer accounts for.
+ */
+static void setupHaloCompression(const gmx::MDLogger& mdlog,
+                                 int                  haloCompression,
+                                 const t_inputrec&    ir,
+                                 gmx_domdec_t*        dd)
+{
+    /* The fraction of the pair list buffer used as tolerance */
+    constexpr real c_haloCompressionBufferFraction = 0.001;
+
+    gmx_domdec_comm_t* comm = dd->comm.get();
+
+    const real pairlistBuffer = ir.rlist - std::max(ir.rvdw, ir.rcoulomb);
+    if (pairlistBuffer <= 0)
+    {
+        GMX_LOG(mdlog.info)
+                .appendText(
+                        "NOTE: Halo coordinate compression is not used, as there is no pair list "
+                        "buffer");
+        return;
+    }
+    setHaloCompressionNeighbors(dd,
+                                haloCompression,
+                                gmx_physicalnode_id_hash(),
+                                c_haloCompressionBufferFraction * pairlistBuffer);
+
+    GMX_LOG(mdlog.info)
+            .appendTextFormatted(
+                    "Compressing halo coordinates to %s with a tolerance of %g nm",
+                    haloCompression > 1 ? "all ranks" : "ranks on other nodes",
+                    comm->haloCompressionTolerance);
+}
+
 /*! \brief Sets grid size limits and PP-PME setup, prints settings to log */
 static void set_ddgrid_parameters(const gmx::MDLogger& mdlog,
                                   gmx_domdec_t*        dd,
@@ -2699,6 +3405,8 @@ static DDSettings getDDSettings(const gmx::MDLogger&     mdlog,
     DDSettings ddSettings;
 
     ddSettings.useSendRecv2        = (dd_getenv(mdlog, "GMX_DD_USE_SENDRECV2", 0) != 0);
+    ddSettings.overlapHaloExchange = (dd_getenv(mdlog, "GMX_DD_NO_HALO_OVERLAP", 0) == 0);
+    ddSettings.haloCompression     = dd_getenv(mdlog, "GMX_DD_HALO_COMPRESSION", 0);
     ddSettings.dlb_scale_lim       = dd_getenv(mdlog, "GMX_DLB_MAX_BOX_SCALING", 10);
     ddSettings.useDDOrderZYX       = bool(dd_getenv(mdlog, "GMX_DD_ORDER_ZYX", 0));
     ddSettings.useCartesianReorder = bool(dd_getenv(mdlog, "GMX_NO_CART_REORDER", 1));
@@ -2707,6 +3415,7 @@ static DDSettings getDDSettings(const gmx::MDLogger&     mdlog,
     ddSettings.nstDDDump           = dd_getenv(mdlog, "GMX_DD_NST_DUMP", 0);
     ddSettings.nstDDDumpGrid       = dd_getenv(mdlog, "GMX_DD_NST_DUMP_GRID", 0);
     ddSettings.DD_debug            = dd_getenv(mdlog, "GMX_DD_DEBUG", 0);
+    ddSettings.useDensityBasedSlb  = bool(dd_getenv(mdlog, "GMX_DD_DENSITY_SLB", 0));
 
     if (ddSettings.useSendRecv2)
     {
@@ -2813,6 +3522,8 @@ public:
     std::vector<int> pmeRanks_;
     //! Contains a valid Cartesian-communicator-based setup, or defaults.
     CartesianRankSetup cartSetup_;
+    //! Atom-density based static load balancing cell fractions, empty when not used
+    std::array<std::vector<real>, DIM> densityCellFractions_;
     //! }
 };
 
@@ -2908,6 +3619,26 @@ DomainDecompositionBuilder::Impl::Impl(const MDLogger&                   mdlog,
 
     cr_->npmenodes = ddGridSetup_.numPmeOnlyRanks;
 
+    if (ddSettings_.useDensityBasedSlb && isDlbDisabled(ddSettings_.initialDlbState))
+    {
+        densityCellFractions_ = getDensityBasedCellFractions(mdlog_,
+                                                             MASTER(cr_) ? DDRole::Master : DDRole::Agent,
+                                                             cr->mpiDefaultCommunicator,
+                                                             ddGridSetup_.numDomains,
+                                                             box,
+                                                             ddbox_,
+                                                             systemInfo_.cellsizeLimit,
+                                                             systemInfo_.cutoff,
+                                                             xGlobal);
+    }
+    else if (ddSettings_.useDensityBasedSlb)
+    {
+        GMX_LOG(mdlog_.info)
+                .appendText(
+                        "NOTE: Atom-density based static load balancing is only used with dynamic "
+                        "load balancing turned off (-dlb no)");
+    }
+
     ddRankSetup_ = getDDRankSetup(
             mdlog_, cr_->sizeOfDefaultCommunicator, options_.rankOrder, ddGridSetup_, ir_);
 
@@ -2940,7 +3671,8 @@ std::unique_ptr<gmx_domdec_t> DomainDecompositionBuilder::Impl::build(LocalAtomS
                   ddRankSetup_.numPPRanks,
                   mtop_,
                   ir_,
-                  ddbox_);
+                  ddbox_,
+                  densityCellFractions_);
 
     setupGroupCommunication(mdlog_, ddSettings_, pmeRanks_, cr_, mtop_.natoms, dd.get());
 
@@ -2949,6 +3681,11 @@ std::unique_ptr<gmx_domdec_t> DomainDecompositionBuilder::Impl::build(LocalAtomS
         set_ddgrid_parameters(mdlog_, dd.get(), options_.dlbScaling, mtop_, ir_, &ddbox_);
 
         setup_neighbor_relations(dd.get());
+
+        if (ddSettings_.haloCompression > 0)
+        {
+            setupHaloCompression(mdlog_, ddSettings_.haloCompression, ir_, dd.get());
+        }
     }
 
     /* Set overallocation to avoid frequent reallocation of arrays */
@@ -150,6 +150,9 @@ int dd_pme_maxshift_y(const gmx_domdec_t& dd);
 /*! \brief Return whether update groups are used */
 bool ddUsesUpdateGroups(const gmx_domdec_t& dd);
 
+/*! \brief Returns whether the CPU halo exchange may overlap with force computation */
+bool dd_overlapCpuHaloExchange(const gmx_domdec_t& dd);
+
 /*! \brief Returns whether molecules are always whole, i.e. not broken by PBC */
 bool dd_moleculesAreAlwaysWhole(const gmx_domdec_t& dd);
 
@@ -194,6 +197,17 @@ void dd_cycles_add(const gmx_domdec_t* dd, float cycles, int ddCycl);
 /*! \brief Communicate the coordinates to the neighboring cells and do pbc. */
 void dd_move_x(struct gmx_domdec_t* dd, const matrix box, gmx::ArrayRef<gmx::RVec> x, gmx_wallcycle* wcycle);
 
+/*! \brief Start communicating the coordinates to the neighboring cells
+ *
+ * Only the first pulse is started, non-blocking, as later pulses forward
+ * received coordinates. The halo part of \p x should not be accessed
+ * until dd_move_x_finish() has been called.
+ */
+void dd_move_x_start(struct gmx_domdec_t* dd, const matrix box, gmx::ArrayRef<gmx::RVec> x, gmx_wallcycle* wcycle);
+
+/*! \brief Complete the coordinate communication started by dd_move_x_start() */
+void dd_move_x_finish(struct gmx_domdec_t* dd, const matrix box, gmx::ArrayRef<gmx::RVec> x, gmx_wallcycle* wcycle);
+
 /*! \brief Sum the forces over the neighboring cells.
  *
  * When fshift!=NULL the shift forces are updated to obtain
@@ -201,6 +215,17 @@ void dd_move_x(struct gmx_domdec_t* dd, const matrix box, gmx::ArrayRef<gmx::RVe
  */
 void dd_move_f(struct gmx_domdec_t* dd, gmx::ForceWithShiftForces* forceWithShiftForces, gmx_wallcycle* wcycle);
 
+/*! \brief Start summing the forces over the neighboring cells
+ *
+ * Only the first pulse is started, non-blocking. After this call
+ * only forces on home atoms can be modified, until dd_move_f_finish()
+ * has been called.
+ */
+void dd_move_f_start(struct gmx_domdec_t* dd, gmx::ForceWithShiftForces* forceWithShiftForces, gmx_wallcycle* wcycle);
+
+/*! \brief Complete the force summation started by dd_move_f_start() */
+void dd_move_f_finish(struct gmx_domdec_t* dd, gmx::ForceWithShiftForces* forceWithShiftForces, gmx_wallcycle* wcycle);
+
 /*! \brief Reset all the statistics and counters for total run counting */
 void reset_dd_statistics_counters(struct gmx_domdec_t* dd);
 
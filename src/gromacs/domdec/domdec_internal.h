@@ -46,9 +46,12 @@
 
 #include "config.h"
 
+#include <cstdint>
+
 #include "gromacs/domdec/dlbtiming.h"
 #include "gromacs/domdec/domdec.h"
 #include "gromacs/domdec/domdec_struct.h"
+#include "gromacs/domdec/makebondedlinks.h"
 #include "gromacs/mdlib/updategroupscog.h"
 #include "gromacs/timing/cyclecounter.h"
 #include "gromacs/topology/block.h"
@@ -411,6 +414,31 @@ public:
     gmx::ArrayRef<T> buffer; /**< The access to the memory buffer */
 };
 
+/*! \brief A halo communication pulse that has been started, but not completed
+ *
+ * Only one pulse of a halo exchange can be overlapped with computation,
+ * as the other pulses forward data received in earlier pulses.
+ */
+struct DDPendingHaloPulse
+{
+    //! Whether the communication is in flight
+    bool isActive = false;
+    //! The send buffer, needs to persist until completion
+    std::vector<gmx::RVec> sendBuffer;
+    //! The receive buffer, not used when receiving coordinates in place
+    std::vector<gmx::RVec> receiveBuffer;
+    //! The send buffer for compressed coordinates
+    std::vector<std::uint16_t> compressedSendBuffer;
+    //! The receive buffer for compressed coordinates
+    std::vector<std::uint16_t> compressedReceiveBuffer;
+    //! Whether the coordinates are received in compressed format
+    bool isReceiveCompressed = false;
+    //! The requests for the non-blocking send and receive
+    std::array<MPI_Request, 2> requests;
+    //! The number of active requests
+    int numRequests = 0;
+};
+
 /*! \brief Temporary buffer for setting up communiation over one pulse and all zones in the halo */
 struct dd_comm_setup_work_t
 {
@@ -476,6 +504,12 @@ struct DDSettings
     //! Use MPI_Sendrecv communication instead of non-blocking calls
     bool useSendRecv2 = false;
 
+    //! Overlap the CPU halo exchange with local force computation
+    bool overlapHaloExchange = true;
+
+    //! Halo coordinate compression: 0 off, 1 with ranks on other nodes, 2 with all ranks
+    int haloCompression = 0;
+
     /* Information for managing the dynamic load balancing */
     //! Maximum DLB scaling per load balancing step in percent
     int dlb_scale_lim = 0;
@@ -491,6 +525,9 @@ struct DDSettings
     //! Whether we should record the load
     bool recordLoad = false;
 
+    //! Whether to set static cell sizes based on the atom density, only used without DLB
+    bool useDensityBasedSlb = false;
+
     /* Debugging */
     //! Step interval for dumping the local+non-local atoms to pdb
     int nstDDDump = 0;
@@ -579,7 +616,7 @@ struct gmx_domdec_comm_t // NOLINT (clang-analyzer-optin.performance.Padding)
 
     /* Data for the optional filtering of communication of atoms for bonded interactions */
     /**< Links between atoms through bonded interactions */
-    std::unique_ptr<gmx::ListOfLists<int>> bondedLinks;
+    std::unique_ptr<gmx::BondedLinks> bondedLinks;
 
     /* The DLB state, possible values are defined above */
     DlbState dlbState;
@@ -676,6 +713,22 @@ struct gmx_domdec_comm_t // NOLINT (clang-analyzer-optin.performance.Padding)
     /**< Another rvec comm. buffer */
     DDBuffer<gmx::RVec> rvecBuffer2;
 
+    /**< Whether halo coordinates sent along each DD dimension index are compressed */
+    std::array<bool, DIM> compressHaloXSend = { false, false, false };
+    /**< Whether halo coordinates received along each DD dimension index are compressed */
+    std::array<bool, DIM> compressHaloXReceive = { false, false, false };
+    /**< The maximum coordinate error allowed with halo compression */
+    real haloCompressionTolerance = 0;
+    /**< Send buffer for compressed halo coordinates */
+    std::vector<std::uint16_t> compressedSendBuffer;
+    /**< Receive buffer for compressed halo coordinates */
+    std::vector<std::uint16_t> compressedReceiveBuffer;
+
+    /**< The coordinate halo pulse in flight between dd_move_x_start() and dd_move_x_finish() */
+    DDPendingHaloPulse pendingMoveX;
+    /**< The force halo pulse in flight between dd_move_f_start() and dd_move_f_finish() */
+    DDPendingHaloPulse pendingMoveF;
+
     /* Communication buffers for local redistribution */
     /**< Charge group flag comm. buffers */
     std::array<std::vector<int>, DIM * 2> cggl_flag;
@@ -771,6 +824,24 @@ static const int zone_reorder_cartesian[DD_MAXZONE] = { 0, 1, 3, 2, 5, 4, 6, 7 }
  * components see only j zones with that component 0.
  */
 
+/*! \brief Sets which halo coordinate communication along each DD dimension is compressed
+ *
+ * Exchanges \p physicalNodeId with the neighbors along each DD dimension.
+ * With \p haloCompression = 1 coordinates are compressed when sent to a rank
+ * with a different node id and decompressed when received from such a rank,
+ * with 2 coordinates are compressed in all communication. Note that the two
+ * directions can differ. Must be called on all PP ranks.
+ *
+ * \param[in,out] dd               The domain decomposition object
+ * \param[in]     haloCompression  The compression mode, 1 or 2
+ * \param[in]     physicalNodeId   An id that is identical for ranks that share a node
+ * \param[in]     tolerance        The maximum coordinate error, should be > 0
+ */
+void setHaloCompressionNeighbors(gmx_domdec_t* dd,
+                                 int           haloCompression,
+                                 int           physicalNodeId,
+                                 real          tolerance);
+
 /*! \brief Returns the DD cut-off distance for multi-body interactions */
 real dd_cutoff_multibody(const gmx_domdec_t* dd);
 
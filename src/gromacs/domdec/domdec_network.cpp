@@ -51,6 +51,7 @@
 #include <cstring>
 
 #include "gromacs/domdec/domdec_struct.h"
+#include "gromacs/utility/gmxassert.h"
 #include "gromacs/utility/gmxmpi.h"
 
 #include "domdec_internal.h"
@@ -60,20 +61,20 @@
 #define DDMASTERRANK(dd) ((dd)->masterrank)
 
 
-/*! \brief Move data of type \p T in the communication region one cell along
- * the domain decomposition
+/*! \brief Move \p numBytesToSend bytes from \p sendBuffer, receiving
+ * \p numBytesToReceive bytes in \p receiveBuffer, one cell along the
+ * domain decomposition
  *
  * Moves in the dimension indexed by ddDimensionIndex, either forward
  * (direction=dddirFoward) or backward (direction=dddirBackward).
  */
-template<typename T>
-void ddSendrecv(const struct gmx_domdec_t* dd,
-                int                        ddDimensionIndex,
-                int                        direction,
-                T*                         sendBuffer,
-                int                        numElementsToSend,
-                T*                         receiveBuffer,
-                int                        numElementsToReceive)
+static void ddSendrecvBytes(const struct gmx_domdec_t* dd,
+                            int                        ddDimensionIndex,
+                            int                        direction,
+                            const void*                sendBuffer,
+                            std::size_t                numBytesToSend,
+                            void*                      receiveBuffer,
+                            std::size_t                numBytesToReceive)
 {
 #if GMX_MPI
     int sendRank    = dd->neighbor[ddDimensionIndex][direction == dddirForward ? 0 : 1];
@@ -81,61 +82,92 @@ void ddSendrecv(const struct gmx_domdec_t* dd,
 
     constexpr int mpiTag = 0;
     MPI_Status    mpiStatus;
-    if (numElementsToSend > 0 && numElementsToReceive > 0)
+    if (numBytesToSend > 0 && numBytesToReceive > 0)
     {
-        MPI_Sendrecv(sendBuffer,
-                     numElementsToSend * sizeof(T),
+        MPI_Sendrecv(const_cast<void*>(sendBuffer),
+                     numBytesToSend,
                      MPI_BYTE,
                      sendRank,
                      mpiTag,
                      receiveBuffer,
-                     numElementsToReceive * sizeof(T),
+                     numBytesToReceive,
                      MPI_BYTE,
                      receiveRank,
                      mpiTag,
                      dd->mpi_comm_all,
                      &mpiStatus);
     }
-    else if (numElementsToSend > 0)
+    else if (numBytesToSend > 0)
     {
-        MPI_Send(sendBuffer, numElementsToSend * sizeof(T), MPI_BYTE, sendRank, mpiTag, dd->mpi_comm_all);
+        MPI_Send(const_cast<void*>(sendBuffer),
+                 numBytesToSend,
+                 MPI_BYTE,
+                 sendRank,
+                 mpiTag,
+                 dd->mpi_comm_all);
     }
-    else if (numElementsToReceive > 0)
+    else if (numBytesToReceive > 0)
     {
-        MPI_Recv(receiveBuffer, numElementsToReceive * sizeof(T), MPI_BYTE, receiveRank, mpiTag, dd->mpi_comm_all, &mpiStatus);
+        MPI_Recv(receiveBuffer,
+                 numBytesToReceive,
+                 MPI_BYTE,
+                 receiveRank,
+                 mpiTag,
+                 dd->mpi_comm_all,
+                 &mpiStatus);
     }
 #else  // GMX_MPI
     GMX_UNUSED_VALUE(dd);
     GMX_UNUSED_VALUE(ddDimensionIndex);
     GMX_UNUSED_VALUE(direction);
     GMX_UNUSED_VALUE(sendBuffer);
-    GMX_UNUSED_VALUE(numElementsToSend);
+    GMX_UNUSED_VALUE(numBytesToSend);
     GMX_UNUSED_VALUE(receiveBuffer);
-    GMX_UNUSED_VALUE(numElementsToReceive);
+    GMX_UNUSED_VALUE(numBytesToReceive);
 #endif // GMX_MPI
 }
 
+template<typename T>
+void ddSendrecv(const struct gmx_domdec_t* dd,
+                int                        ddDimensionIndex,
+                int                        direction,
+                T*                         sendBuffer,
+                int                        numElementsToSend,
+                T*                         receiveBuffer,
+                int                        numElementsToReceive)
+{
+    ddSendrecvBytes(dd,
+                    ddDimensionIndex,
+                    direction,
+                    sendBuffer,
+                    numElementsToSend * sizeof(T),
+                    receiveBuffer,
+                    numElementsToReceive * sizeof(T));
+}
+
 //! Specialization of extern template for int
 template void ddSendrecv(const gmx_domdec_t*, int, int, int*, int, int*, int);
 //! Specialization of extern template for real
 template void ddSendrecv(const gmx_domdec_t*, int, int, real*, int, real*, int);
 //! Specialization of extern template for gmx::RVec
 template void ddSendrecv(const gmx_domdec_t*, int, int, rvec*, int, rvec*, int);
+//! Specialization of extern template for std::uint16_t
+template void ddSendrecv(const gmx_domdec_t*, int, int, std::uint16_t*, int, std::uint16_t*, int);
 
-template<typename T>
-void ddSendrecv(const gmx_domdec_t* dd,
-                int                 ddDimensionIndex,
-                int                 direction,
-                gmx::ArrayRef<T>    sendBuffer,
-                gmx::ArrayRef<T>    receiveBuffer)
+template<typename T, typename TReceive>
+void ddSendrecv(const gmx_domdec_t*     dd,
+                int                     ddDimensionIndex,
+                int                     direction,
+                gmx::ArrayRef<T>        sendBuffer,
+                gmx::ArrayRef<TReceive> receiveBuffer)
 {
-    ddSendrecv(dd,
-               ddDimensionIndex,
-               direction,
-               sendBuffer.data(),
-               sendBuffer.size(),
-               receiveBuffer.data(),
-               receiveBuffer.size());
+    ddSendrecvBytes(dd,
+                    ddDimensionIndex,
+                    direction,
+                    sendBuffer.data(),
+                    sendBuffer.size() * sizeof(T),
+                    receiveBuffer.data(),
+                    receiveBuffer.size() * sizeof(TReceive));
 }
 
 //! Specialization of extern template for int
@@ -144,6 +176,108 @@ template void ddSendrecv(const gmx_domdec_t*, int, int, gmx::ArrayRef<int>, gmx:
 template void ddSendrecv(const gmx_domdec_t*, int, int, gmx::ArrayRef<real>, gmx::ArrayRef<real>);
 //! Specialization of extern template for gmx::RVec
 template void ddSendrecv(const gmx_domdec_t*, int, int, gmx::ArrayRef<gmx::RVec>, gmx::ArrayRef<gmx::RVec>);
+//! Specialization of extern template for std::uint16_t
+template void
+ddSendrecv(const gmx_domdec_t*, int, int, gmx::ArrayRef<std::uint16_t>, gmx::ArrayRef<std::uint16_t>);
+//! Specialization of extern template for sending gmx::RVec and receiving std::uint16_t
+template void
+ddSendrecv(const gmx_domdec_t*, int, int, gmx::ArrayRef<gmx::RVec>, gmx::ArrayRef<std::uint16_t>);
+//! Specialization of extern template for sending std::uint16_t and receiving gmx::RVec
+template void
+ddSendrecv(const gmx_domdec_t*, int, int, gmx::ArrayRef<std::uint16_t>, gmx::ArrayRef<gmx::RVec>);
+
+template<typename T, typename TReceive>
+void ddStartSendrecv(const gmx_domdec_t*     dd,
+                     int                     ddDimensionIndex,
+                     int                     direction,
+                     gmx::ArrayRef<T>        sendBuffer,
+                     gmx::ArrayRef<TReceive> receiveBuffer,
+                     DDPendingHaloPulse*     pending)
+{
+    GMX_ASSERT(!pending->isActive, "Can only start an inactive communication");
+
+#if GMX_MPI
+    int sendRank    = dd->neighbor[ddDimensionIndex][direction == dddirForward ? 0 : 1];
+    int receiveRank = dd->neighbor[ddDimensionIndex][direction == dddirForward ? 1 : 0];
+
+    /* Use a different tag than ddSendrecv() to avoid matching
+     * with blocking messages sent while this communication is in flight.
+     */
+    constexpr int mpiTag = 1;
+
+    pending->numRequests = 0;
+    if (!receiveBuffer.empty())
+    {
+        MPI_Irecv(receiveBuffer.data(),
+                  receiveBuffer.size() * sizeof(TReceive),
+                  MPI_BYTE,
+                  receiveRank,
+                  mpiTag,
+                  dd->mpi_comm_all,
+                  &pending->requests[pending->numRequests++]);
+    }
+    if (!sendBuffer.empty())
+    {
+        MPI_Isend(sendBuffer.data(),
+                  sendBuffer.size() * sizeof(T),
+                  MPI_BYTE,
+                  sendRank,
+                  mpiTag,
+                  dd->mpi_comm_all,
+                  &pending->requests[pending->numRequests++]);
+    }
+#else  // GMX_MPI
+    GMX_UNUSED_VALUE(dd);
+    GMX_UNUSED_VALUE(ddDimensionIndex);
+    GMX_UNUSED_VALUE(direction);
+    GMX_UNUSED_VALUE(sendBuffer);
+    GMX_UNUSED_VALUE(receiveBuffer);
+#endif // GMX_MPI
+    pending->isActive = true;
+}
+
+//! Specialization of template for gmx::RVec
+template void ddStartSendrecv(const gmx_domdec_t*,
+                              int,
+                              int,
+                              gmx::ArrayRef<gmx::RVec>,
+                              gmx::ArrayRef<gmx::RVec>,
+                              DDPendingHaloPulse*);
+//! Specialization of template for std::uint16_t
+template void ddStartSendrecv(const gmx_domdec_t*,
+                              int,
+                              int,
+                              gmx::ArrayRef<std::uint16_t>,
+                              gmx::ArrayRef<std::uint16_t>,
+                              DDPendingHaloPulse*);
+//! Specialization of template for sending gmx::RVec and receiving std::uint16_t
+template void ddStartSendrecv(const gmx_domdec_t*,
+                              int,
+                              int,
+                              gmx::ArrayRef<gmx::RVec>,
+                              gmx::ArrayRef<std::uint16_t>,
+                              DDPendingHaloPulse*);
+//! Specialization of template for sending std::uint16_t and receiving gmx::RVec
+template void ddStartSendrecv(const gmx_domdec_t*,
+                              int,
+                              int,
+                              gmx::ArrayRef<std::uint16_t>,
+                              gmx::ArrayRef<gmx::RVec>,
+                              DDPendingHaloPulse*);
+
+void ddWaitSendrecv(DDPendingHaloPulse* pending)
+{
+    GMX_ASSERT(pending->isActive, "Can only wait for an active communication");
+
+#if GMX_MPI
+    if (pending->numRequests > 0)
+    {
+        MPI_Waitall(pending->numRequests, pending->requests.data(), MPI_STATUSES_IGNORE);
+    }
+#endif
+    pending->numRequests = 0;
+    pending->isActive    = false;
+}
 
 void dd_sendrecv2_rvec(const struct gmx_domdec_t gmx_unused* dd,
                        int gmx_unused                        ddimind,
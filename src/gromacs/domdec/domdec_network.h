@@ -49,8 +49,11 @@
 #ifndef GMX_DOMDEC_DOMDEC_NETWORK_H
 #define GMX_DOMDEC_DOMDEC_NETWORK_H
 
+#include <cstdint>
+
 #include "gromacs/math/vectypes.h"
 
+struct DDPendingHaloPulse;
 struct gmx_domdec_t;
 
 namespace gmx
@@ -111,18 +114,30 @@ extern template void ddSendrecv<rvec>(const gmx_domdec_t* dd,
                                       rvec*               buf_r,
                                       int                 n_r);
 
+//! Extern declaration for std::uint16_t specialization
+extern template void ddSendrecv<std::uint16_t>(const gmx_domdec_t* dd,
+                                               int                 ddDimensionIndex,
+                                               int                 direction,
+                                               std::uint16_t*      buf_s,
+                                               int                 n_s,
+                                               std::uint16_t*      buf_r,
+                                               int                 n_r);
+
 /*! \brief Move a view of T values in the communication region one
  * cell along the domain decomposition
  *
  * Moves in the dimension indexed by ddDimensionIndex, either forward
  * (direction=dddirFoward) or backward (direction=dddirBackward).
+ * The received values can be of a different type \p TReceive,
+ * which is used for halo coordinates that are compressed in only
+ * one of the two directions.
  */
-template<typename T>
-void ddSendrecv(const gmx_domdec_t* dd,
-                int                 ddDimensionIndex,
-                int                 direction,
-                gmx::ArrayRef<T>    sendBuffer,
-                gmx::ArrayRef<T>    receiveBuffer);
+template<typename T, typename TReceive = T>
+void ddSendrecv(const gmx_domdec_t*     dd,
+                int                     ddDimensionIndex,
+                int                     direction,
+                gmx::ArrayRef<T>        sendBuffer,
+                gmx::ArrayRef<TReceive> receiveBuffer);
 
 //! Extern declaration for int specialization
 extern template void ddSendrecv<int>(const gmx_domdec_t* dd,
@@ -145,6 +160,47 @@ extern template void ddSendrecv<gmx::RVec>(const gmx_domdec_t*      dd,
                                            gmx::ArrayRef<gmx::RVec> sendBuffer,
                                            gmx::ArrayRef<gmx::RVec> receiveBuffer);
 
+//! Extern declaration for std::uint16_t specialization
+extern template void ddSendrecv<std::uint16_t>(const gmx_domdec_t*          dd,
+                                               int                          ddDimensionIndex,
+                                               int                          direction,
+                                               gmx::ArrayRef<std::uint16_t> sendBuffer,
+                                               gmx::ArrayRef<std::uint16_t> receiveBuffer);
+
+//! Extern declaration for sending gmx::RVec and receiving std::uint16_t
+extern template void
+ddSendrecv<gmx::RVec, std::uint16_t>(const gmx_domdec_t*          dd,
+                                     int                          ddDimensionIndex,
+                                     int                          direction,
+                                     gmx::ArrayRef<gmx::RVec>     sendBuffer,
+                                     gmx::ArrayRef<std::uint16_t> receiveBuffer);
+
+//! Extern declaration for sending std::uint16_t and receiving gmx::RVec
+extern template void
+ddSendrecv<std::uint16_t, gmx::RVec>(const gmx_domdec_t*          dd,
+                                     int                          ddDimensionIndex,
+                                     int                          direction,
+                                     gmx::ArrayRef<std::uint16_t> sendBuffer,
+                                     gmx::ArrayRef<gmx::RVec>     receiveBuffer);
+
+/*! \brief Start a non-blocking move of T values one cell along the domain decomposition
+ *
+ * The request handles are stored in \p pending, the buffers should not be
+ * accessed until ddWaitSendrecv() has been called on \p pending.
+ * Instantiated for all combinations of gmx::RVec and std::uint16_t
+ * for the send and receive types.
+ */
+template<typename T, typename TReceive = T>
+void ddStartSendrecv(const gmx_domdec_t*     dd,
+                     int                     ddDimensionIndex,
+                     int                     direction,
+                     gmx::ArrayRef<T>        sendBuffer,
+                     gmx::ArrayRef<TReceive> receiveBuffer,
+                     DDPendingHaloPulse*     pending);
+
+//! Wait for the completion of a move started with ddStartSendrecv()
+void ddWaitSendrecv(DDPendingHaloPulse* pending);
+
 /*! \brief Move revc's in the comm. region one cell along the domain decomposition
  *
  * Moves in dimension indexed by ddimind, simultaneously in the forward
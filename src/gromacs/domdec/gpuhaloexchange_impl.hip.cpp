@@ -448,25 +448,24 @@ void GpuHaloExchange::Impl::communicateHaloDataWithCudaMPI(float3* sendPtr,
     // no need to wait for haloDataReadyOnDevice event if this rank is not sending any data
     if (sendSize > 0)
     {
-        // wait for halo stream to complete all outstanding
-        // activities, to ensure that buffer is up-to-date in GPU memory
+        // wait for the work enqueued so far in the halo stream to complete,
+        // to ensure that buffer is up-to-date in GPU memory
         // before transferring to remote rank
-
-        // ToDo: Replace stream synchronize with event synchronize
-        haloStream_->synchronize();
+        haloDataReadyOnDevice_.markEvent(*haloStream_);
+        haloDataReadyOnDevice_.waitForEvent();
     }
 
     // perform halo exchange directly in device buffers
 #if GMX_MPI
-    MPI_Request request;
+    MPI_Request requests[2];
 
     // recv remote data into halo region
-    MPI_Irecv(recvPtr, recvSize * DIM, MPI_FLOAT, recvRank, 0, mpi_comm_mysim_, &request);
+    MPI_Irecv(recvPtr, recvSize * DIM, MPI_FLOAT, recvRank, 0, mpi_comm_mysim_, &requests[0]);
 
-    // send data to remote halo region
-    MPI_Send(sendPtr, sendSize * DIM, MPI_FLOAT, sendRank, 0, mpi_comm_mysim_);
+    // send data to remote halo region, without serializing with the receive
+    MPI_Isend(sendPtr, sendSize * DIM, MPI_FLOAT, sendRank, 0, mpi_comm_mysim_, &requests[1]);
 
-    MPI_Wait(&request, MPI_STATUS_IGNORE);
+    MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
 #else
     GMX_UNUSED_VALUE(sendPtr);
     GMX_UNUSED_VALUE(sendRank);
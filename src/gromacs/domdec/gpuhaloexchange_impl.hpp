@@ -228,6 +228,8 @@ private:
     int atomOffset_ = 0;
     //! Event triggered when coordinate halo has been launched
     GpuEventSynchronizer coordinateHaloLaunched_;
+    //! Event for the host to wait for the send buffer contents with library MPI
+    GpuEventSynchronizer haloDataReadyOnDevice_;
 };
 
 } // namespace gmx
@@ -0,0 +1,173 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Implements functions for compressing halo coordinates
+ *
+ * \ingroup module_domdec
+ */
+
+#include "gmxpre.h"
+
+#include "halocompression.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/gmxassert.h"
+
+namespace gmx
+{
+
+namespace
+{
+
+//! The largest fixed-point value
+constexpr int c_maxFixedPointValue = UINT16_MAX;
+
+//! The buffer elements used for storing the origin and the resolution, as floats
+constexpr int c_headerFloatSize = (2 * DIM * sizeof(float)) / sizeof(std::uint16_t);
+
+//! The buffer elements used before the coordinate data
+constexpr int c_headerSize = c_headerFloatSize + 1;
+
+//! The value of the mode element of the header for full precision data
+constexpr std::uint16_t c_modeFullPrecision = 0;
+
+//! The value of the mode element of the header for fixed-point data
+constexpr std::uint16_t c_modeFixedPoint = 1;
+
+} // namespace
+
+std::size_t compressedHaloBufferSize(int numCoordinates)
+{
+    return c_headerSize + numCoordinates * sizeof(RVec) / sizeof(std::uint16_t);
+}
+
+std::size_t compressHaloCoordinates(ArrayRef<const RVec> x, real tolerance, ArrayRef<std::uint16_t> buffer)
+{
+    GMX_ASSERT(buffer.size() >= compressedHaloBufferSize(x.ssize()), "The buffer should be large enough");
+
+    float origin[DIM]     = { 0, 0, 0 };
+    float resolution[DIM] = { 0, 0, 0 };
+    bool  useFixedPoint   = (tolerance > 0 && !x.empty());
+    if (useFixedPoint)
+    {
+        RVec lower = x[0];
+        RVec upper = x[0];
+        for (const RVec& v : x)
+        {
+            for (int d = 0; d < DIM; d++)
+            {
+                lower[d] = std::min(lower[d], v[d]);
+                upper[d] = std::max(upper[d], v[d]);
+            }
+        }
+        for (int d = 0; d < DIM; d++)
+        {
+            origin[d]     = lower[d];
+            resolution[d] = (upper[d] - lower[d]) / c_maxFixedPointValue;
+            /* The error is half the resolution, plus the rounding error of origin */
+            if (0.5F * resolution[d] + std::abs(lower[d] - origin[d]) > tolerance)
+            {
+                useFixedPoint = false;
+            }
+        }
+    }
+
+    std::memcpy(buffer.data(), origin, sizeof(origin));
+    std::memcpy(buffer.data() + c_headerFloatSize / 2, resolution, sizeof(resolution));
+    buffer[c_headerFloatSize] = useFixedPoint ? c_modeFixedPoint : c_modeFullPrecision;
+
+    std::uint16_t* data = buffer.data() + c_headerSize;
+    if (!useFixedPoint)
+    {
+        if (!x.empty())
+        {
+            std::memcpy(data, x.data(), x.size() * sizeof(RVec));
+        }
+
+        return c_headerSize + x.size() * sizeof(RVec) / sizeof(std::uint16_t);
+    }
+
+    float invResolution[DIM];
+    for (int d = 0; d < DIM; d++)
+    {
+        invResolution[d] = (resolution[d] > 0 ? 1.0F / resolution[d] : 0.0F);
+    }
+    for (const RVec& v : x)
+    {
+        for (int d = 0; d < DIM; d++)
+        {
+            const int value = static_cast<int>(std::lround((v[d] - origin[d]) * invResolution[d]));
+            *data++         = static_cast<std::uint16_t>(std::clamp(value, 0, c_maxFixedPointValue));
+        }
+    }
+
+    return c_headerSize + x.size() * DIM;
+}
+
+void decompressHaloCoordinates(ArrayRef<const std::uint16_t> buffer, ArrayRef<RVec> x)
+{
+    float origin[DIM];
+    float resolution[DIM];
+    std::memcpy(origin, buffer.data(), sizeof(origin));
+    std::memcpy(resolution, buffer.data() + c_headerFloatSize / 2, sizeof(resolution));
+
+    const std::uint16_t* data = buffer.data() + c_headerSize;
+    if (buffer[c_headerFloatSize] == c_modeFullPrecision)
+    {
+        if (!x.empty())
+        {
+            std::memcpy(as_rvec_array(x.data()), data, x.size() * sizeof(RVec));
+        }
+
+        return;
+    }
+
+    GMX_ASSERT(buffer[c_headerFloatSize] == c_modeFixedPoint, "Unknown halo compression mode");
+    for (RVec& v : x)
+    {
+        for (int d = 0; d < DIM; d++)
+        {
+            v[d] = origin[d] + (*data++) * resolution[d];
+        }
+    }
+}
+
+} // namespace gmx
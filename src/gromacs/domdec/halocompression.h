@@ -0,0 +1,80 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Declares functions for compressing halo coordinates
+ *
+ * Halo coordinates sent to ranks on other nodes can be stored
+ * as 16-bit fixed-point values relative to the lower corner of
+ * the bounding box of the coordinates sent in a pulse.
+ * When the resolution would exceed the tolerance, the coordinates
+ * are sent with full precision in the same buffer format.
+ *
+ * \ingroup module_domdec
+ */
+#ifndef GMX_DOMDEC_HALOCOMPRESSION_H
+#define GMX_DOMDEC_HALOCOMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gromacs/math/vectypes.h"
+#include "gromacs/utility/real.h"
+
+namespace gmx
+{
+template<typename>
+class ArrayRef;
+
+/*! \brief Returns the buffer size needed for (de)compressing \p numCoordinates coordinates
+ *
+ * This is the size needed in the worst case, i.e. without compression.
+ */
+std::size_t compressedHaloBufferSize(int numCoordinates);
+
+/*! \brief Compresses \p x into \p buffer, returns the number of elements used
+ *
+ * Fixed-point values are used when the maximum error is at most \p tolerance,
+ * full precision otherwise. \p tolerance <= 0 disables compression,
+ * which is used for communication with ranks on the same node.
+ */
+std::size_t compressHaloCoordinates(ArrayRef<const RVec> x, real tolerance, ArrayRef<std::uint16_t> buffer);
+
+//! Decompresses \p buffer, filled by compressHaloCoordinates(), into \p x
+void decompressHaloCoordinates(ArrayRef<const std::uint16_t> buffer, ArrayRef<RVec> x);
+
+} // namespace gmx
+
+#endif
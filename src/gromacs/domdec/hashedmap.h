@@ -65,6 +65,10 @@ namespace gmx
  * Efficiently manages mapping from integer keys to values.
  * Note that this basically implements a subset of the functionality of
  * std::unordered_map, but is an order of magnitude faster.
+ *
+ * Each entry stores the generation of the table in which it was set.
+ * This allows clear() to invalidate all entries without touching them,
+ * which matters as the table is cleared and refilled at every DD repartitioning.
  */
 template<class T>
 class HashedMap
@@ -73,9 +77,10 @@ private:
     /*! \libinternal \brief Structure for the key/value hash table */
     struct hashEntry
     {
-        int key = -1;  /**< The key */
-        T   value;     /**< The value(s) */
-        int next = -1; /**< Index in the list of the next element with the same hash, -1 if none */
+        int key        = -1; /**< The key */
+        T   value;           /**< The value(s) */
+        int next       = -1; /**< Index in the list of the next element with the same hash, -1 if none */
+        int generation = 0;  /**< The entry is in use when this equals the table generation */
     };
 
     /*! \brief The table size is set to at least this factor time the nr of keys */
@@ -106,13 +111,17 @@ private:
         {
             tableSize *= 2;
         }
-        table_.resize(tableSize);
+        table_.assign(tableSize, hashEntry());
+        generation_ = 1;
 
         /* Table size is a power of 2, so a binary mask gives the hash */
         bitMask_                        = tableSize - 1;
         startIndexForSpaceForListEntry_ = tableSize;
     }
 
+    //! Returns whether the entry with index \p ind is in use
+    bool isUsed(size_t ind) const { return table_[ind].generation == generation_; }
+
 public:
     /*! \brief Constructor
      *
@@ -144,7 +153,7 @@ private:
     {
         size_t ind = (key & bitMask_);
 
-        if (table_[ind].key >= 0)
+        if (isUsed(ind))
         {
             /* Loop over the entries for this hash.
              * If we find the matching key, return the value.
@@ -185,7 +194,7 @@ private:
             }
             /* Search for space in table_ */
             ind = startIndexForSpaceForListEntry_;
-            while (ind < table_.size() && table_[ind].key >= 0)
+            while (ind < table_.size() && isUsed(ind))
             {
                 ind++;
             }
@@ -199,8 +208,10 @@ private:
             startIndexForSpaceForListEntry_ = ind + 1;
         }
 
-        table_[ind].key   = key;
-        table_[ind].value = value;
+        table_[ind].key        = key;
+        table_[ind].value      = value;
+        table_[ind].next       = -1;
+        table_[ind].generation = generation_;
 
         numElements_ += 1;
     }
@@ -228,14 +239,27 @@ public:
     {
         int ind_prev = -1;
         int ind      = (key & bitMask_);
+        if (!isUsed(ind))
+        {
+            return;
+        }
         do
         {
             if (table_[ind].key == key)
             {
-                if (ind_prev >= 0)
+                if (ind_prev < 0 && table_[ind].next >= 0)
+                {
+                    /* This is the head of a list, move the next entry into the head */
+                    ind_prev         = ind;
+                    ind              = table_[ind].next;
+                    table_[ind_prev] = table_[ind];
+                }
+                else if (ind_prev >= 0)
                 {
                     table_[ind_prev].next = table_[ind].next;
-
+                }
+                if (ind_prev >= 0)
+                {
                     /* This index is a linked entry, so we free an entry.
                      * Check if we are creating the first empty space.
                      */
@@ -244,8 +268,9 @@ public:
                         startIndexForSpaceForListEntry_ = ind;
                     }
                 }
-                table_[ind].key  = -1;
-                table_[ind].next = -1;
+                table_[ind].key        = -1;
+                table_[ind].next       = -1;
+                table_[ind].generation = 0;
 
                 numElements_ -= 1;
 
@@ -273,6 +298,10 @@ public:
     const T* find(int key) const
     {
         int ind = (key & bitMask_);
+        if (!isUsed(ind))
+        {
+            return nullptr;
+        }
         do
         {
             if (table_[ind].key == key)
@@ -288,11 +317,16 @@ public:
     //! Clear all the entries in the list
     void clear()
     {
-        for (hashEntry& entry : table_)
+        /* Moving to the next generation marks all entries as unused */
+        if (generation_ == INT_MAX)
         {
-            entry.key  = -1;
-            entry.next = -1;
+            for (hashEntry& entry : table_)
+            {
+                entry.generation = 0;
+            }
+            generation_ = 0;
         }
+        generation_++;
         startIndexForSpaceForListEntry_ = bucket_count();
         numElements_                    = 0;
     }
@@ -329,6 +363,8 @@ private:
     int startIndexForSpaceForListEntry_ = 0;
     /*! \brief The number of elements currently stored in the table */
     int numElements_ = 0;
+    /*! \brief The current generation, entries with a different generation are not in use */
+    int generation_ = 1;
 };
 
 } // namespace gmx
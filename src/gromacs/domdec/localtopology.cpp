@@ -333,55 +333,65 @@ static real dd_dist2(const t_pbc* pbc_null, ArrayRef<const RVec> coordinates, co
     return norm2(dx);
 }
 
-/*! \brief Append t_idef structures 1 to nsrc in src to *dest */
-static void combine_idef(InteractionDefinitions* dest, gmx::ArrayRef<const thread_work_t> src)
+/*! \brief Append t_idef structures 1 to nsrc in src to *dest
+ *
+ * The interaction types are independent, so these are appended in parallel
+ * using \p numThreads threads.
+ */
+static void combine_idef(InteractionDefinitions* dest, gmx::ArrayRef<const thread_work_t> src, int numThreads)
 {
+#pragma omp parallel for num_threads(numThreads) schedule(dynamic)
     for (int ftype = 0; ftype < F_NRE; ftype++)
     {
-        int n = 0;
-        for (gmx::index s = 1; s < src.ssize(); s++)
-        {
-            n += src[s].idef.il[ftype].size();
-        }
-        if (n > 0)
+        try
         {
+            int n = 0;
             for (gmx::index s = 1; s < src.ssize(); s++)
             {
-                dest->il[ftype].append(src[s].idef.il[ftype]);
+                n += src[s].idef.il[ftype].size();
             }
-
-            /* Position restraints need an additional treatment */
-            if (ftype == F_POSRES || ftype == F_FBPOSRES)
+            if (n > 0)
             {
-                int                     nposres = dest->il[ftype].size() / 2;
-                std::vector<t_iparams>& iparams_dest =
-                        (ftype == F_POSRES ? dest->iparams_posres : dest->iparams_fbposres);
-
-                /* Set nposres to the number of original position restraints in dest */
                 for (gmx::index s = 1; s < src.ssize(); s++)
                 {
-                    nposres -= src[s].idef.il[ftype].size() / 2;
+                    dest->il[ftype].append(src[s].idef.il[ftype]);
                 }
 
-                for (gmx::index s = 1; s < src.ssize(); s++)
+                /* Position restraints need an additional treatment */
+                if (ftype == F_POSRES || ftype == F_FBPOSRES)
                 {
-                    const std::vector<t_iparams>& iparams_src =
-                            (ftype == F_POSRES ? src[s].idef.iparams_posres : src[s].idef.iparams_fbposres);
-                    iparams_dest.insert(iparams_dest.end(), iparams_src.begin(), iparams_src.end());
+                    int                     nposres = dest->il[ftype].size() / 2;
+                    std::vector<t_iparams>& iparams_dest =
+                            (ftype == F_POSRES ? dest->iparams_posres : dest->iparams_fbposres);
 
-                    /* Correct the indices into iparams_posres */
-                    for (int i = 0; i < src[s].idef.il[ftype].size() / 2; i++)
+                    /* Set nposres to the number of original position restraints in dest */
+                    for (gmx::index s = 1; s < src.ssize(); s++)
                     {
-                        /* Correct the index into iparams_posres */
-                        dest->il[ftype].iatoms[nposres * 2] = nposres;
-                        nposres++;
+                        nposres -= src[s].idef.il[ftype].size() / 2;
+                    }
+
+                    for (gmx::index s = 1; s < src.ssize(); s++)
+                    {
+                        const std::vector<t_iparams>& iparams_src =
+                                (ftype == F_POSRES ? src[s].idef.iparams_posres
+                                                   : src[s].idef.iparams_fbposres);
+                        iparams_dest.insert(iparams_dest.end(), iparams_src.begin(), iparams_src.end());
+
+                        /* Correct the indices into iparams_posres */
+                        for (int i = 0; i < src[s].idef.il[ftype].size() / 2; i++)
+                        {
+                            /* Correct the index into iparams_posres */
+                            dest->il[ftype].iatoms[nposres * 2] = nposres;
+                            nposres++;
+                        }
                     }
+                    GMX_RELEASE_ASSERT(
+                            int(iparams_dest.size()) == nposres,
+                            "The number of parameters should match the number of restraints");
                 }
-                GMX_RELEASE_ASSERT(
-                        int(iparams_dest.size()) == nposres,
-                        "The number of parameters should match the number of restraints");
             }
         }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
     }
 }
 
@@ -919,7 +929,7 @@ static int make_local_bondeds_excls(const gmx_domdec_t&       dd,
 
         if (threadWorkObjects.size() > 1)
         {
-            combine_idef(idef, threadWorkObjects);
+            combine_idef(idef, threadWorkObjects, numThreads);
         }
 
         for (const thread_work_t& th_work : threadWorkObjects)
@@ -63,17 +63,18 @@ using gmx::DDBondedChecking;
 static void check_link(std::vector<int>* links, const int atom)
 {
     const auto it = find(links->begin(), links->end(), atom);
-    if (it != links->end())
+    if (it == links->end())
     {
         links->push_back(atom);
     }
 }
 
-/*! \brief Creates and return a list of bonded links for all atoms in the system */
-static gmx::ListOfLists<int> genBondedLinks(const gmx_mtop_t&                               mtop,
-                                            gmx::ArrayRef<gmx::AtomInfoWithinMoleculeBlock> atomInfoForEachMoleculeBlock)
+/*! \brief Creates and return the bonded links for all atoms in the system */
+static gmx::BondedLinks
+genBondedLinks(const gmx_mtop_t&                               mtop,
+               gmx::ArrayRef<gmx::AtomInfoWithinMoleculeBlock> atomInfoForEachMoleculeBlock)
 {
-    gmx::ListOfLists<int> link;
+    gmx::BondedLinks bondedLinks;
 
     /* For each atom make a list of other atoms in the system
      * that a linked to it via bonded interactions
@@ -115,11 +116,22 @@ static gmx::ListOfLists<int> genBondedLinks(const gmx_mtop_t&
         make_reverse_ilist(molt.ilist, &molt.atoms, rtOptions, AtomLinkRule::AllAtomsInBondeds, &ril);
 
         gmx::AtomInfoWithinMoleculeBlock* atomInfoOfMoleculeBlock = &atomInfoForEachMoleculeBlock[mb];
+        const int indexOfFirstAtomInMoleculeBlock = indexOfFirstAtomInMolecule;
+
+        /* Without intermolecular interactions all molecules in the block
+         * have the same links, so we only store those of the first molecule,
+         * using atom indices local to the molecule.
+         */
+        gmx::BondedLinks::MoleculeBlockLinks blockLinks;
+        blockLinks.atomStart           = indexOfFirstAtomInMolecule;
+        blockLinks.numAtomsPerMolecule = molt.atoms.nr;
+        blockLinks.isExpanded          = mtop.bIntermolecularInteractions;
 
         std::vector<int> linksForOneAtom;
-        int              mol = 0;
-        for (mol = 0; mol < (mtop.bIntermolecularInteractions ? molb.nmol : 1); mol++)
+        const int        numMoleculesToStore = (blockLinks.isExpanded ? molb.nmol : 1);
+        for (int mol = 0; mol < numMoleculesToStore; mol++)
         {
+            const int linkOffset = (blockLinks.isExpanded ? indexOfFirstAtomInMolecule : 0);
             for (int a = 0; a < molt.atoms.nr; a++)
             {
                 const int atomIndex = indexOfFirstAtomInMolecule + a;
@@ -136,7 +148,7 @@ static gmx::ListOfLists<int> genBondedLinks(const gmx_mtop_t&
                         int aj = ril.il[i + j];
                         if (aj != a)
                         {
-                            check_link(&linksForOneAtom, indexOfFirstAtomInMolecule + aj);
+                            check_link(&linksForOneAtom, linkOffset + aj);
                         }
                     }
                     i += nral_rt(ftype);
@@ -157,27 +169,31 @@ static gmx::ListOfLists<int> genBondedLinks(const gmx_mtop_t&
                              * this has been checked above.
                              */
                             int aj = ril_intermol.il[i + j];
-                            check_link(&linksForOneAtom, aj);
+                            if (aj != atomIndex)
+                            {
+                                check_link(&linksForOneAtom, aj);
+                            }
                         }
                         i += nral_rt(ftype);
                     }
                 }
                 if (!linksForOneAtom.empty())
                 {
-                    atomInfoOfMoleculeBlock->atomInfo[a] |= gmx::sc_atomInfo_BondCommunication;
+                    /* With identical molecules there is only atom info for one molecule */
+                    const int atomInfoIndex = (atomIndex - indexOfFirstAtomInMoleculeBlock)
+                                              % atomInfoOfMoleculeBlock->atomInfo.size();
+                    atomInfoOfMoleculeBlock->atomInfo[atomInfoIndex] |=
+                            gmx::sc_atomInfo_BondCommunication;
                     numLinkedAtoms++;
                 }
-                // Add the links for the current atom to the total list
-                link.pushBack(linksForOneAtom);
+                // Add the links for the current atom to the list for this block
+                blockLinks.links.pushBack(linksForOneAtom);
             }
 
             indexOfFirstAtomInMolecule += molt.atoms.nr;
-
-            GMX_ASSERT(link.size() == size_t(indexOfFirstAtomInMolecule),
-                       "We should have one link entry for each atom");
         }
-        int nlink_mol = link.listRangesView()[indexOfFirstAtomInMolecule]
-                        - link.listRangesView()[indexOfFirstAtomInMolecule - molt.atoms.nr];
+        int nlink_mol = blockLinks.links.listRangesView()[molt.atoms.nr]
+                        - blockLinks.links.listRangesView()[0];
 
         if (debug)
         {
@@ -188,34 +204,30 @@ static gmx::ListOfLists<int> genBondedLinks(const gmx_mtop_t&
                     nlink_mol);
         }
 
-        if (molb.nmol > mol)
+        if (molb.nmol > numMoleculesToStore)
         {
-            /* Copy the data for the rest of the molecules in this block */
-            for (; mol < molb.nmol; mol++)
+            /* The other molecules in this block have the same links.
+             * When the atom info differs between the molecules, we need
+             * to set the communication flag for each molecule.
+             */
+            const int numMoleculesInAtomInfo =
+                    atomInfoOfMoleculeBlock->atomInfo.size() / molt.atoms.nr;
+            for (int a = 0; a < molt.atoms.nr; a++)
             {
-                for (int a = 0; a < molt.atoms.nr; a++)
+                if (!blockLinks.links[a].empty())
                 {
-                    const int                      atomIndex = indexOfFirstAtomInMolecule + a;
-                    const gmx::ArrayRef<const int> linksForAtomInPreviousMolecule =
-                            link[atomIndex - molt.atoms.nr];
-                    link.pushBackListOfSize(linksForAtomInPreviousMolecule.size());
-                    gmx::ArrayRef<int> linksForAtom = link.back();
-                    std::transform(linksForAtomInPreviousMolecule.begin(),
-                                   linksForAtomInPreviousMolecule.end(),
-                                   linksForAtom.begin(),
-                                   [&molt](const auto a) { return a + molt.atoms.nr; });
-                    if (!linksForAtom.empty()
-                        && atomIndex - atomInfoOfMoleculeBlock->indexOfFirstAtomInMoleculeBlock
-                                   < gmx::ssize(atomInfoOfMoleculeBlock->atomInfo))
+                    for (int mol = 1; mol < numMoleculesInAtomInfo; mol++)
                     {
-                        atomInfoOfMoleculeBlock->atomInfo[atomIndex - atomInfoOfMoleculeBlock->indexOfFirstAtomInMoleculeBlock] |=
+                        atomInfoOfMoleculeBlock->atomInfo[mol * molt.atoms.nr + a] |=
                                 gmx::sc_atomInfo_BondCommunication;
-                        numLinkedAtoms++;
                     }
+                    numLinkedAtoms += molb.nmol - 1;
                 }
-                indexOfFirstAtomInMolecule += molt.atoms.nr;
             }
+            indexOfFirstAtomInMolecule += (molb.nmol - numMoleculesToStore) * molt.atoms.nr;
         }
+
+        bondedLinks.addMoleculeBlock(std::move(blockLinks));
     }
 
     if (debug)
@@ -223,7 +235,7 @@ static gmx::ListOfLists<int> genBondedLinks(const gmx_mtop_t&
         fprintf(debug, "Of the %d atoms %d are linked via bonded interactions\n", mtop.natoms, numLinkedAtoms);
     }
 
-    return link;
+    return bondedLinks;
 }
 
 void makeBondedLinks(gmx_domdec_t*                                   dd,
@@ -232,7 +244,7 @@ void makeBondedLinks(gmx_domdec_t*                                   dd,
 {
     if (dd->comm->systemInfo.filterBondedCommunication)
     {
-        dd->comm->bondedLinks  = std::make_unique<gmx::ListOfLists<int>>();
-        *dd->comm->bondedLinks = genBondedLinks(mtop, atomInfoForEachMoleculeBlock);
+        dd->comm->bondedLinks = std::make_unique<gmx::BondedLinks>(
+                genBondedLinks(mtop, atomInfoForEachMoleculeBlock));
     }
 }
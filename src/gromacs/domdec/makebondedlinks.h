@@ -44,17 +44,95 @@
 #ifndef GMX_DOMDEC_MAKEBONDEDLINKS_H
 #define GMX_DOMDEC_MAKEBONDEDLINKS_H
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/listoflists.h"
+
 struct gmx_domdec_t;
 struct gmx_mtop_t;
 
 namespace gmx
 {
-template<typename>
-class ArrayRef;
 struct AtomInfoWithinMoleculeBlock;
+
+/*! \libinternal \brief
+ * Links between atoms that are connected by bonded interactions
+ *
+ * Without intermolecular interactions all molecules in a molecule block
+ * have the same links. These are then stored only once per block, with atom
+ * indices local to the molecule, so the memory use does not scale with
+ * the system size. With intermolecular interactions the links are stored
+ * for each atom in the block using global atom indices.
+ */
+class BondedLinks
+{
+public:
+    //! The links for the atoms in one molecule block
+    struct MoleculeBlockLinks
+    {
+        //! The global index of the first atom in the block
+        int atomStart = 0;
+        //! The number of atoms per molecule
+        int numAtomsPerMolecule = 0;
+        //! Whether \p links has an entry with global indices for each atom in the block
+        bool isExpanded = false;
+        //! The links, either per atom in the first molecule with local indices or expanded
+        ListOfLists<int> links;
+    };
+
+    //! Adds the links for the next molecule block, blocks should be added in atom order
+    void addMoleculeBlock(MoleculeBlockLinks&& moleculeBlockLinks)
+    {
+        GMX_ASSERT(moleculeBlocks_.empty()
+                           || moleculeBlockLinks.atomStart > moleculeBlocks_.back().atomStart,
+                   "Molecule blocks should be added in order and should not be empty");
+        moleculeBlocks_.push_back(std::move(moleculeBlockLinks));
+    }
+
+    //! Returns whether \p predicate is true for any atom linked to atom \p globalAtomIndex
+    template<typename Predicate>
+    bool anyLinkedAtom(const int globalAtomIndex, Predicate predicate) const
+    {
+        const auto block = std::upper_bound(moleculeBlocks_.begin(),
+                                            moleculeBlocks_.end(),
+                                            globalAtomIndex,
+                                            [](const int atom, const MoleculeBlockLinks& mbl) {
+                                                return atom < mbl.atomStart;
+                                            })
+                           - 1;
+        GMX_ASSERT(block >= moleculeBlocks_.begin(), "The atom should be in a molecule block");
+
+        const int atomInBlock = globalAtomIndex - block->atomStart;
+        if (block->isExpanded)
+        {
+            const ArrayRef<const int> links = block->links[atomInBlock];
+
+            return std::any_of(links.begin(), links.end(), predicate);
+        }
+        else
+        {
+            const int moleculeStart =
+                    globalAtomIndex - atomInBlock % block->numAtomsPerMolecule;
+            const ArrayRef<const int> links = block->links[globalAtomIndex - moleculeStart];
+
+            return std::any_of(links.begin(), links.end(), [&](const int a) {
+                return predicate(moleculeStart + a);
+            });
+        }
+    }
+
+private:
+    //! The links for each non-empty molecule block
+    std::vector<MoleculeBlockLinks> moleculeBlocks_;
+};
+
 } // namespace gmx
 
-/*! \brief Generate a list of links between atoms that are linked by bonded interactions
+/*! \brief Generate the links between atoms that are linked by bonded interactions
  *
  * Also stores whether atoms are linked in \p atomInfoForEachMoleculeBlock.
  */
@@ -1427,11 +1427,12 @@ static void make_cell2at_index(gmx_domdec_comm_dim_t* cd, int nzone, int atomGro
 }
 
 //! Returns whether a link is missing.
-static bool missing_link(const gmx::ListOfLists<int>& link, const int globalAtomIndex, const gmx_ga2la_t& ga2la)
+static bool missing_link(const gmx::BondedLinks& link,
+                         const int               globalAtomIndex,
+                         const gmx_ga2la_t&      ga2la)
 {
-    return std::any_of(link[globalAtomIndex].begin(), link[globalAtomIndex].end(), [&](const int a) {
-        return ga2la.findHome(a) == nullptr;
-    });
+    return link.anyLinkedAtom(globalAtomIndex,
+                              [&](const int a) { return ga2la.findHome(a) == nullptr; });
 }
 
 //! Domain corners for communication, a maximum of 4 i-zones see a j domain
@@ -2510,15 +2511,25 @@ static void orderVector(gmx::ArrayRef<const gmx_cgsort_t> sort,
     GMX_ASSERT(sortBuffer.size() >= sort.size(),
                "The sorting buffer needs to be sufficiently large");
 
+    /* This is called for each state entry at every repartitioning,
+     * so we use all DD threads for the random-access gather and the copy.
+     */
+    const int numThreads = gmx_omp_nthreads_get(ModuleMultiThread::Domdec);
+    const int numEntries = sort.ssize();
+
     /* Order the data into the temporary buffer */
-    size_t i = 0;
-    for (const gmx_cgsort_t& entry : sort)
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int i = 0; i < numEntries; i++)
     {
-        sortBuffer[i++] = dataToSort[entry.ind];
+        sortBuffer[i] = dataToSort[sort[i].ind];
     }
 
     /* Copy back to the original array */
-    std::copy(sortBuffer.begin(), sortBuffer.begin() + sort.size(), dataToSort.begin());
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int i = 0; i < numEntries; i++)
+    {
+        dataToSort[i] = sortBuffer[i];
+    }
 }
 
 /*! \brief Order data in \p dataToSort according to \p sort
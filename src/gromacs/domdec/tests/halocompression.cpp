@@ -0,0 +1,141 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for the halo coordinate compression.
+ *
+ * \ingroup module_domdec
+ */
+#include "gmxpre.h"
+
+#include "gromacs/domdec/halocompression.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/utility/arrayref.h"
+
+#include "testutils/testasserts.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+//! Returns a set of coordinates spread over a halo-like slab
+std::vector<RVec> makeCoordinates()
+{
+    std::vector<RVec> x;
+    for (int i = 0; i < 1000; i++)
+    {
+        x.emplace_back(2.1_real + 0.0031_real * i, 0.37_real * (i % 13), 5.0_real - 0.0047_real * i);
+    }
+    return x;
+}
+
+TEST(HaloCompression, RoundTripSatisfiesTolerance)
+{
+    const std::vector<RVec> x         = makeCoordinates();
+    const real              tolerance = 1e-4;
+
+    std::vector<std::uint16_t> buffer(compressedHaloBufferSize(x.size()));
+    const std::size_t          size = compressHaloCoordinates(x, tolerance, buffer);
+    EXPECT_LT(size, buffer.size() / 1.9);
+
+    std::vector<RVec> result(x.size());
+    decompressHaloCoordinates(buffer, result);
+    for (std::size_t i = 0; i < x.size(); i++)
+    {
+        for (int d = 0; d < DIM; d++)
+        {
+            EXPECT_NEAR(result[i][d], x[i][d], tolerance);
+        }
+    }
+}
+
+TEST(HaloCompression, UsesFullPrecisionWithoutTolerance)
+{
+    const std::vector<RVec> x = makeCoordinates();
+
+    std::vector<std::uint16_t> buffer(compressedHaloBufferSize(x.size()));
+    const std::size_t          size = compressHaloCoordinates(x, 0, buffer);
+    EXPECT_EQ(size, buffer.size());
+
+    std::vector<RVec> result(x.size());
+    decompressHaloCoordinates(buffer, result);
+    for (std::size_t i = 0; i < x.size(); i++)
+    {
+        for (int d = 0; d < DIM; d++)
+        {
+            EXPECT_EQ(result[i][d], x[i][d]);
+        }
+    }
+}
+
+TEST(HaloCompression, UsesFullPrecisionWhenResolutionIsTooLow)
+{
+    std::vector<RVec> x = makeCoordinates();
+    x.emplace_back(100, 0, 0);
+
+    std::vector<std::uint16_t> buffer(compressedHaloBufferSize(x.size()));
+    const std::size_t          size = compressHaloCoordinates(x, 1e-4, buffer);
+    EXPECT_EQ(size, buffer.size());
+
+    std::vector<RVec> result(x.size());
+    decompressHaloCoordinates(buffer, result);
+    EXPECT_EQ(result.back()[XX], 100);
+}
+
+TEST(HaloCompression, HandlesEmptyAndSingleCoordinates)
+{
+    std::vector<std::uint16_t> buffer(compressedHaloBufferSize(1));
+    EXPECT_EQ(compressHaloCoordinates({}, 1e-4, buffer), compressedHaloBufferSize(0));
+    decompressHaloCoordinates(buffer, {});
+
+    const std::vector<RVec> x = { { 1.5_real, -2.25_real, 3.0_real } };
+    compressHaloCoordinates(x, 1e-4, buffer);
+    std::vector<RVec> result(1);
+    decompressHaloCoordinates(buffer, result);
+    EXPECT_EQ(result[0][XX], x[0][XX]);
+    EXPECT_EQ(result[0][YY], x[0][YY]);
+    EXPECT_EQ(result[0][ZZ], x[0][ZZ]);
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
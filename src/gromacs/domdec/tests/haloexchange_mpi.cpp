@@ -737,6 +737,85 @@ TEST(HaloExchangeTest, Coordinates2dHaloWith2PulsesInDim1)
     }
 }
 
+/*! \brief Check results for the 1D halo with 2 pulses sent with halo compression
+ *
+ * \param [in] x             Atom coordinate data array
+ * \param [in] dd            Domain decomposition object
+ * \param [in] numHomeAtoms  Number of home atoms
+ * \param [in] tolerance     The tolerance used for halo compression
+ */
+void checkResults1dHaloWith2PulsesCompressed(const RVec*         x,
+                                             const gmx_domdec_t* dd,
+                                             const int           numHomeAtoms,
+                                             const real          tolerance)
+{
+    const std::array<int, 5> sentAtoms = { 1, 3, 4, 5, 7 };
+    for (std::size_t i = 0; i < sentAtoms.size(); i++)
+    {
+        for (int j = 0; j < DIM; j++)
+        {
+            EXPECT_NEAR(x[numHomeAtoms + i][j],
+                        encodedValue(dd->neighbor[0][0], sentAtoms[i], j),
+                        tolerance);
+        }
+    }
+}
+
+TEST(HaloExchangeTest, CompressedCoordinates1dHaloWith2PulsesAcrossNodes)
+{
+    GMX_MPI_TEST(RequireRankCount<4>);
+
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    // Set up atom data
+    const int        numHomeAtoms  = 10;
+    const int        numHaloAtoms  = 5;
+    const int        numAtomsTotal = numHomeAtoms + numHaloAtoms;
+    HostVector<RVec> h_x;
+    h_x.resize(numAtomsTotal);
+
+    // Set up dd
+    t_inputrec   ir;
+    gmx_domdec_t dd(ir);
+    dd.mpi_comm_all              = MPI_COMM_WORLD;
+    dd.comm                      = std::make_unique<gmx_domdec_comm_t>();
+    dd.unitCellInfo.haveScrewPBC = false;
+
+    DDAtomRanges atomRanges;
+    atomRanges.setEnd(DDAtomRanges::Type::Home, numHomeAtoms);
+    dd.comm->atomRanges = atomRanges;
+
+    define1dRankTopology(&dd);
+
+    std::vector<gmx_domdec_ind_t> indvec;
+    define1dHaloWith2Pulses(&dd, &indvec);
+
+    // Emulate ranks 0, 1 and 2 on one node and rank 3 on another node,
+    // so some ranks compress in only one of the two directions
+    const real tolerance      = 0.01;
+    const int  physicalNodeId = (rank < 3 ? 0 : 1);
+    setHaloCompressionNeighbors(&dd, 1, physicalNodeId, tolerance);
+
+    const int backwardRank = dd.neighbor[0][1];
+    const int forwardRank  = dd.neighbor[0][0];
+    EXPECT_EQ(dd.comm->compressHaloXSend[0], physicalNodeId != (backwardRank < 3 ? 0 : 1));
+    EXPECT_EQ(dd.comm->compressHaloXReceive[0], physicalNodeId != (forwardRank < 3 ? 0 : 1));
+
+    matrix box = { { 0., 0., 0. } };
+
+    // Perform the blocking halo exchange
+    initHaloData(h_x.data(), numHomeAtoms, numAtomsTotal);
+    dd_move_x(&dd, box, static_cast<ArrayRef<RVec>>(h_x), nullptr);
+    checkResults1dHaloWith2PulsesCompressed(h_x.data(), &dd, numHomeAtoms, tolerance);
+
+    // Perform the halo exchange with the first pulse overlapped
+    initHaloData(h_x.data(), numHomeAtoms, numAtomsTotal);
+    dd_move_x_start(&dd, box, static_cast<ArrayRef<RVec>>(h_x), nullptr);
+    dd_move_x_finish(&dd, box, static_cast<ArrayRef<RVec>>(h_x), nullptr);
+    checkResults1dHaloWith2PulsesCompressed(h_x.data(), &dd, numHomeAtoms, tolerance);
+}
+
 } // namespace
 } // namespace test
 } // namespace gmx
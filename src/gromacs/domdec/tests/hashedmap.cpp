@@ -163,6 +163,58 @@ TEST(HashedMap, LinkedEntries)
     checkFinds(map, 3 + 2 * largePowerOf2, 'c');
 }
 
+// Check that erasing the first entry with a hash keeps the entries linked to it
+TEST(HashedMap, ErasesListHead)
+{
+    gmx::HashedMap<char> map(20);
+
+    const int largePowerOf2 = 2048;
+
+    map.insert(3 + 0 * largePowerOf2, 'a');
+    map.insert(3 + 1 * largePowerOf2, 'b');
+    map.insert(3 + 2 * largePowerOf2, 'c');
+
+    map.erase(3 + 0 * largePowerOf2);
+
+    checkDoesNotFind(map, 3 + 0 * largePowerOf2);
+    checkFinds(map, 3 + 1 * largePowerOf2, 'b');
+    checkFinds(map, 3 + 2 * largePowerOf2, 'c');
+    EXPECT_EQ(map.size(), 2);
+}
+
+// Check that erasing entries keeps all other entries in a densely filled table findable
+TEST(HashedMap, ErasesInDenseTable)
+{
+    gmx::HashedMap<char> map(1);
+
+    // Fill the table with more keys than buckets, so many entries are linked
+    const int numKeys = 100;
+    for (int i = 0; i < numKeys; i++)
+    {
+        map.insert(7 * i, 'a' + i % 26);
+    }
+    EXPECT_EQ(map.size(), numKeys);
+
+    // Erase every third key
+    for (int i = 0; i < numKeys; i += 3)
+    {
+        map.erase(7 * i);
+    }
+
+    for (int i = 0; i < numKeys; i++)
+    {
+        if (i % 3 == 0)
+        {
+            checkDoesNotFind(map, 7 * i);
+        }
+        else
+        {
+            checkFinds(map, 7 * i, 'a' + i % 26);
+        }
+    }
+    EXPECT_EQ(map.size(), numKeys - (numKeys + 2) / 3);
+}
+
 // HashedMap only throws in debug mode, so only test in debug mode
 #ifndef NDEBUG
 
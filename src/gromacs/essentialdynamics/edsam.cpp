@@ -44,6 +44,7 @@
 #include <cstring>
 #include <ctime>
 
+#include <algorithm>
 #include <memory>
 
 #include "gromacs/commandline/filenm.h"
@@ -60,6 +61,7 @@
 #include "gromacs/math/vectypes.h"
 #include "gromacs/mdlib/broadcaststructs.h"
 #include "gromacs/mdlib/constr.h"
+#include "gromacs/mdlib/gmx_omp_nthreads.h"
 #include "gromacs/mdlib/groupcoord.h"
 #include "gromacs/mdlib/stat.h"
 #include "gromacs/mdlib/update.h"
@@ -377,6 +379,21 @@ static char get_EDgroupChar(int nr_edi, int nED)
 
 namespace
 {
+//! The minimum number of eigenvector components to use OpenMP threads for in loops over them.
+constexpr int c_minNumComponentsForThreading = 10000;
+
+/*! \brief Returns the number of OpenMP threads to use for loops over \p numEigenvectors
+ * eigenvectors of \p numAtoms components.
+ */
+int numThreadsForEigenvectors(int numEigenvectors, int numAtoms)
+{
+    if (static_cast<int64_t>(numEigenvectors) * numAtoms < c_minNumComponentsForThreading)
+    {
+        return 1;
+    }
+    return std::max(gmx_omp_nthreads_get(ModuleMultiThread::Default), 1);
+}
+
 /*! \brief The mass-weighted inner product of two coordinate vectors.
  * Does not subtract average positions, projection on single eigenvector is returned
  * used by: do_linfix, do_linacc, do_radfix, do_radacc, do_radcon
@@ -452,6 +469,9 @@ void project_to_eigvectors(rvec* x, t_eigvec* vec, const t_edpar& edi)
         rvec_dec(x[i], edi.sav.x[i]);
     }
 
+    /* The eigenvectors are independent, so we can distribute them over threads */
+    const int gmx_unused numThreads = numThreadsForEigenvectors(vec->neig, edi.sav.nr);
+#pragma omp parallel for num_threads(numThreads) schedule(static)
     for (int i = 0; i < vec->neig; i++)
     {
         vec->xproj[i] = projectx(edi, x, vec->vec[i]);
@@ -864,6 +884,8 @@ void flood_blowup(const t_edpar& edi, rvec* forces_cart)
     }
 
     /* Now compute atomwise */
+    const int gmx_unused numThreads = numThreadsForEigenvectors(edi.flood.vecs.neig, edi.sav.nr_loc);
+#pragma omp parallel for num_threads(numThreads) schedule(static)
     for (int j = 0; j < edi.sav.nr_loc; j++)
     {
         /* Compute forces_cart[edi.sav.anrs[j]] */
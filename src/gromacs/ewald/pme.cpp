@@ -925,6 +925,8 @@ gmx_pme_t* gmx_pme_init(const t_commrec*     cr,
     snew(pme->cfftgrid, pme->ngrids);
     snew(pme->pfft_setup, pme->ngrids);
 
+    int numColoredSpreadBlocks = 0;
+
     for (i = 0; i < pme->ngrids; ++i)
     {
         if ((i < DO_Q && pme->doCoulomb && (i == 0 || bFreeEnergy_q))
@@ -942,7 +944,10 @@ gmx_pme_t* gmx_pme_init(const t_commrec*     cr,
                           pme->overlap[0].s2g1[pme->nodeid_major]
                                   - pme->overlap[0].s2g0[pme->nodeid_major + 1],
                           pme->overlap[1].s2g1[pme->nodeid_minor]
-                                  - pme->overlap[1].s2g0[pme->nodeid_minor + 1]);
+                                  - pme->overlap[1].s2g0[pme->nodeid_minor + 1],
+                          pme->nnodes == 1);
+            numColoredSpreadBlocks = std::max(
+                    numColoredSpreadBlocks, pme->pmegrid[i].ncb[XX] * pme->pmegrid[i].ncb[YY]);
             /* This routine will allocate the grid data to fit the FFTs */
             const auto allocateRealGridForGpu = (pme->runMode == PmeRunMode::Mixed)
                                                         ? gmx::PinningPolicy::PinnedIfSupported
@@ -980,6 +985,17 @@ gmx_pme_t* gmx_pme_init(const t_commrec*     cr,
         doSpread                 = false;
         pme->atc.emplace_back(pme->mpi_comm_d[1], pme->nthread, pme->pme_order, secondDimIndex, doSpread);
     }
+    if (numColoredSpreadBlocks > 0)
+    {
+        /* With colored spreading the atoms are binned on blocks instead of on threads */
+        PmeAtomComm& atc = pme->atc[0];
+        for (auto& threadMap : atc.threadMap)
+        {
+            threadMap.nBuffer.resize(std::max(pme->nthread, numColoredSpreadBlocks) + 2 * gmxCacheLineSize);
+            threadMap.n = threadMap.nBuffer.data() + gmxCacheLineSize;
+        }
+        atc.threadBlockAtomStart.resize(pme->nthread);
+    }
 
     // Initial check of validity of the input for running on the GPU
     if (pme->runMode != PmeRunMode::CPU)
@@ -1448,8 +1464,8 @@ int gmx_pme_do(struct gmx_pme_t*              pme,
         /* Loop over A- and B-state if we are doing FEP */
         for (int fep_state = 0; fep_state < fep_states_lj; ++fep_state)
         {
-            std::vector<real>         local_c6;
-            std::vector<real>         local_sigma;
+            gmx::ArrayRef<const real> local_c6;
+            gmx::ArrayRef<const real> local_sigma;
             gmx::ArrayRef<const real> RedistC6;
             gmx::ArrayRef<const real> RedistSigma;
             gmx::ArrayRef<real>       coefficientBuffer;
@@ -1460,12 +1476,12 @@ int gmx_pme_do(struct gmx_pme_t*              pme,
                 switch (fep_state)
                 {
                     case 0:
-                        local_c6.assign(c6A.begin(), c6A.end());
-                        local_sigma.assign(sigmaA.begin(), sigmaA.end());
+                        local_c6    = c6A;
+                        local_sigma = sigmaA;
                         break;
                     case 1:
-                        local_c6.assign(c6B.begin(), c6B.end());
-                        local_sigma.assign(sigmaB.begin(), sigmaB.end());
+                        local_c6    = c6B;
+                        local_sigma = sigmaB;
                         break;
                     default: gmx_incons("Trying to access wrong FEP-state in LJ-PME routine");
                 }
@@ -1488,20 +1504,22 @@ int gmx_pme_do(struct gmx_pme_t*              pme,
                 wallcycle_start(wcycle, WallCycleCounter::PmeRedistXF);
 
                 do_redist_pos_coeffs(pme, cr, bFirst, coordinates, RedistC6);
+                /* The redistributed coefficients are stored in the persistent
+                 * lb_buf1 and lb_buf2 buffers, as coefficientBuffer is
+                 * overwritten with the LB coefficients below.
+                 */
                 pme->lb_buf1.resize(atc.numAtoms());
                 pme->lb_buf2.resize(atc.numAtoms());
-                local_c6.assign(pme->lb_buf1.begin(), pme->lb_buf1.end());
-                for (int i = 0; i < atc.numAtoms(); ++i)
-                {
-                    local_c6[i] = atc.coefficient[i];
-                }
+                std::copy(atc.coefficient.begin(),
+                          atc.coefficient.begin() + atc.numAtoms(),
+                          pme->lb_buf1.begin());
+                local_c6 = pme->lb_buf1;
 
                 do_redist_pos_coeffs(pme, cr, FALSE, coordinates, RedistSigma);
-                local_sigma.assign(pme->lb_buf2.begin(), pme->lb_buf2.end());
-                for (int i = 0; i < atc.numAtoms(); ++i)
-                {
-                    local_sigma[i] = atc.coefficient[i];
-                }
+                std::copy(atc.coefficient.begin(),
+                          atc.coefficient.begin() + atc.numAtoms(),
+                          pme->lb_buf2.begin());
+                local_sigma = pme->lb_buf2;
 
                 wallcycle_stop(wcycle, WallCycleCounter::PmeRedistXF);
             }
@@ -0,0 +1,514 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Implements the estimator for the reciprocal-space force error of smooth PME.
+ *
+ * \ingroup module_ewald
+ */
+
+#include "gmxpre.h"
+
+#include "pme_error_estimate.h"
+
+#include <cmath>
+
+#include <array>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "gromacs/math/units.h"
+#include "gromacs/math/vec.h"
+#include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
+
+namespace gmx
+{
+
+namespace
+{
+
+//! The number of aliasing terms on each side of the series in Wang2010
+constexpr int c_sumOrder = 6;
+//! The number of non-zero aliasing terms in the self-interaction series
+constexpr int c_numSelfTerms = 2 * c_sumOrder;
+
+//! Returns the aliasing index of self-interaction term \p j, skipping zero
+constexpr int selfTermAliasIndex(int j)
+{
+    return j < c_sumOrder ? j - c_sumOrder : j - c_sumOrder + 1;
+}
+
+/* The following 4 functions determine polynomials required for the reciprocal error estimate */
+
+//! Returns the first B-spline aliasing polynomial for grid coordinate \p m
+double eps_poly1(double m, /* grid coordinate in certain direction */
+                 double K, /* grid size in corresponding direction */
+                 double n) /* spline interpolation order of the SPME */
+{
+    if (m == 0.0)
+    {
+        return 0.0;
+    }
+
+    double nom = 0;
+    for (int i = -c_sumOrder; i <= c_sumOrder; i++)
+    {
+        if (i != 0)
+        {
+            nom += std::pow(2.0 * M_PI * (m / K + i), -n);
+        }
+    }
+    const double denom = std::pow(2.0 * M_PI * m / K, -n) + nom;
+
+    return -nom / denom;
+}
+
+//! Returns the sum of B-spline aliasing polynomials of order \p n over all aliasing indices
+double aliasingDenominator(double m, double K, double n)
+{
+    double denom = 0;
+    for (int i = -c_sumOrder; i <= c_sumOrder; i++)
+    {
+        denom += std::pow(2.0 * M_PI * (m / K + i), -n);
+    }
+    return denom;
+}
+
+//! Returns the second B-spline aliasing polynomial for grid coordinate \p m
+double eps_poly2(double m, double K, double n)
+{
+    if (m == 0.0)
+    {
+        return 0.0;
+    }
+
+    double nom = 0;
+    for (int i = -c_sumOrder; i <= c_sumOrder; i++)
+    {
+        if (i != 0)
+        {
+            nom += std::pow(2.0 * M_PI * (m / K + i), -2 * n);
+        }
+    }
+    const double denom = aliasingDenominator(m, K, n);
+    const double tmp   = eps_poly1(m, K, n);
+
+    return nom / denom / denom + tmp * tmp;
+}
+
+//! Returns the third B-spline aliasing polynomial for grid coordinate \p m
+double eps_poly3(double m, double K, double n)
+{
+    if (m == 0.0)
+    {
+        return 0.0;
+    }
+
+    double nom = 0;
+    for (int i = -c_sumOrder; i <= c_sumOrder; i++)
+    {
+        nom += i * std::pow(2.0 * M_PI * (m / K + i), -2 * n);
+    }
+    const double denom = aliasingDenominator(m, K, n);
+
+    return 2.0 * M_PI * nom / denom / denom;
+}
+
+//! Returns the fourth B-spline aliasing polynomial for grid coordinate \p m
+double eps_poly4(double m, double K, double n)
+{
+    if (m == 0.0)
+    {
+        return 0.0;
+    }
+
+    double nom = 0;
+    for (int i = -c_sumOrder; i <= c_sumOrder; i++)
+    {
+        nom += i * i * std::pow(2.0 * M_PI * (m / K + i), -2 * n);
+    }
+    const double denom = aliasingDenominator(m, K, n);
+
+    return 4.0 * M_PI * M_PI * nom / denom / denom;
+}
+
+/*! \brief Tabulated aliasing series for one grid dimension
+ *
+ * All tables are indexed with m + K/2 for grid coordinates m in [-K/2, K/2].
+ */
+struct DimensionTables
+{
+    //! Initializes the tables for grid size \p K and interpolation order \p n
+    void init(int K, int n)
+    {
+        gridSize  = K;
+        halfWidth = K / 2;
+        const int numPoints = 2 * halfWidth + 1;
+        poly1.resize(numPoints);
+        poly2.resize(numPoints);
+        poly3.resize(numPoints);
+        poly4.resize(numPoints);
+        selfWeights.resize(numPoints);
+        for (int m = -halfWidth; m <= halfWidth; m++)
+        {
+            const int index = m + halfWidth;
+            poly1[index]    = eps_poly1(m, K, n);
+            poly2[index]    = eps_poly2(m, K, n);
+            poly3[index]    = eps_poly3(m, K, n);
+            poly4[index]    = eps_poly4(m, K, n);
+
+            /* The self-interaction series is sum_i -sin(2 pi i K r) w_i(m),
+             * where only the weights w_i depend on the grid coordinate.
+             */
+            selfWeights[index].fill(0);
+            if (m != 0)
+            {
+                double denom = std::pow(2.0 * M_PI * m / K, -n);
+                std::array<double, c_numSelfTerms> pows;
+                for (int j = 0; j < c_numSelfTerms; j++)
+                {
+                    pows[j] = std::pow(2.0 * M_PI * m / K + 2.0 * M_PI * selfTermAliasIndex(j), -n);
+                    denom += pows[j];
+                }
+                for (int j = 0; j < c_numSelfTerms; j++)
+                {
+                    selfWeights[index][j] =
+                            2.0 * M_PI * K * selfTermAliasIndex(j) * pows[j] / denom;
+                }
+            }
+        }
+    }
+
+    //! The grid size K
+    int gridSize = 0;
+    //! K/2, the grid coordinates run from -K/2 to K/2
+    int halfWidth = 0;
+    //! eps_poly1() for each grid coordinate
+    std::vector<double> poly1;
+    //! eps_poly2() for each grid coordinate
+    std::vector<double> poly2;
+    //! eps_poly3() for each grid coordinate
+    std::vector<double> poly3;
+    //! eps_poly4() for each grid coordinate
+    std::vector<double> poly4;
+    //! The weights of the self-interaction series for each grid coordinate
+    std::vector<std::array<double, c_numSelfTerms>> selfWeights;
+};
+
+//! Partial sums of a pass over the reciprocal grid, one per thread
+struct GridPassSums
+{
+    //! Sum for term 1 of the error estimate
+    double term1 = 0;
+    //! Sum for term 2 of the error estimate
+    double term2 = 0;
+    //! Sums of exp(-pi^2 k^2/beta^2)/k^2 over the other two dimensions, per dimension
+    std::array<std::vector<double>, DIM> marginals;
+};
+
+} // namespace
+
+class PmeReciprocalErrorEstimator::Impl
+{
+public:
+    Impl(ArrayRef<const RVec> x,
+         ArrayRef<const real> q,
+         ArrayRef<const int>  selfTermSamples,
+         const matrix         recipbox,
+         real                 volume,
+         int                  pmeOrder,
+         int                  numThreads);
+
+    //! (Re)computes all tables that only depend on the grid size
+    void setGridSize(const ivec gridSize);
+
+    real estimate(const ivec gridSize, real ewaldBeta);
+
+    //! Coordinates of the charges used for the self-interaction term
+    std::vector<RVec> sampleX_;
+    //! Charges used for the self-interaction term
+    std::vector<real> sampleQ_;
+    //! The reciprocal box
+    matrix recipbox_;
+    //! The box volume
+    double volume_;
+    //! The PME interpolation order
+    int pmeOrder_;
+    //! The number of OpenMP threads
+    int numThreads_;
+    //! The number of charges
+    int numCharges_;
+    //! The sum of squared charges
+    double q2All_ = 0;
+    //! Tables for each dimension, valid for the current grid size
+    std::array<DimensionTables, DIM> tables_;
+    //! -sin(2 pi i K r) for each sample, dimension and non-zero aliasing index
+    std::vector<std::array<std::array<double, c_numSelfTerms>, DIM>> sampleSines_;
+    //! Per-thread partial sums of the grid pass
+    std::vector<GridPassSums> threadSums_;
+};
+
+PmeReciprocalErrorEstimator::Impl::Impl(ArrayRef<const RVec> x,
+                                        ArrayRef<const real> q,
+                                        ArrayRef<const int>  selfTermSamples,
+                                        const matrix         recipbox,
+                                        real                 volume,
+                                        int                  pmeOrder,
+                                        int                  numThreads) :
+    volume_(volume),
+    pmeOrder_(pmeOrder),
+    numThreads_(std::max(numThreads, 1)),
+    numCharges_(q.ssize()),
+    threadSums_(numThreads_)
+{
+    GMX_RELEASE_ASSERT(x.size() == q.size(), "Need one charge per coordinate");
+    GMX_RELEASE_ASSERT(!q.empty(), "Need charges to estimate the PME error");
+
+    copy_mat(recipbox, recipbox_);
+    for (const real charge : q)
+    {
+        q2All_ += charge * charge;
+    }
+    if (selfTermSamples.empty())
+    {
+        sampleX_.assign(x.begin(), x.end());
+        sampleQ_.assign(q.begin(), q.end());
+    }
+    else
+    {
+        for (const int index : selfTermSamples)
+        {
+            sampleX_.push_back(x[index]);
+            sampleQ_.push_back(q[index]);
+        }
+    }
+}
+
+void PmeReciprocalErrorEstimator::Impl::setGridSize(const ivec gridSize)
+{
+    bool gridChanged = false;
+    for (int d = 0; d < DIM; d++)
+    {
+        if (tables_[d].gridSize != gridSize[d])
+        {
+            tables_[d].init(gridSize[d], pmeOrder_);
+            for (auto& sums : threadSums_)
+            {
+                sums.marginals[d].resize(2 * tables_[d].halfWidth + 1);
+            }
+            gridChanged = true;
+        }
+    }
+    if (!gridChanged)
+    {
+        return;
+    }
+
+    const int numSamples = sampleX_.size();
+    sampleSines_.resize(numSamples);
+#pragma omp parallel for num_threads(numThreads_) schedule(static)
+    for (int s = 0; s < numSamples; s++)
+    {
+        for (int d = 0; d < DIM; d++)
+        {
+            const double rcoord = iprod(recipbox_[d], sampleX_[s]);
+            for (int j = 0; j < c_numSelfTerms; j++)
+            {
+                sampleSines_[s][d][j] =
+                        -std::sin(2.0 * M_PI * selfTermAliasIndex(j) * gridSize[d] * rcoord);
+            }
+        }
+    }
+}
+
+real PmeReciprocalErrorEstimator::Impl::estimate(const ivec gridSize, real ewaldBeta)
+{
+    setGridSize(gridSize);
+
+    const DimensionTables& tx = tables_[XX];
+    const DimensionTables& ty = tables_[YY];
+    const DimensionTables& tz = tables_[ZZ];
+
+    const double beta2 = double(ewaldBeta) * ewaldBeta;
+
+    const DVec bx = RVec(recipbox_[XX]).toDVec();
+    const DVec by = RVec(recipbox_[YY]).toDVec();
+    const DVec bz = RVec(recipbox_[ZZ]).toDVec();
+
+    // Grid-size and box dependent prefactors of the fourth aliasing polynomials
+    const DVec polyFactor4 = { norm2(bx) * tx.gridSize * tx.gridSize,
+                               norm2(by) * ty.gridSize * ty.gridSize,
+                               norm2(bz) * tz.gridSize * tz.gridSize };
+
+    /* A single pass over the reciprocal grid computes the sums for the first
+     * two error terms and the marginal sums of the Gaussian factors, which are
+     * the only beta-dependent quantities needed for the self-interaction term.
+     */
+    const int numX = 2 * tx.halfWidth + 1;
+    /* All slots are cleared here, since the runtime can give us fewer threads
+     * than requested and the reduction below sums over all slots.
+     */
+    for (GridPassSums& sums : threadSums_)
+    {
+        sums.term1 = 0;
+        sums.term2 = 0;
+        for (auto& marginal : sums.marginals)
+        {
+            std::fill(marginal.begin(), marginal.end(), 0.0);
+        }
+    }
+#pragma omp parallel num_threads(numThreads_)
+    {
+        GridPassSums& sums = threadSums_[gmx_omp_get_thread_num()];
+
+#pragma omp for schedule(static)
+        for (int ix = 0; ix < numX; ix++)
+        {
+            const int nx = ix - tx.halfWidth;
+            for (int iy = 0; iy < 2 * ty.halfWidth + 1; iy++)
+            {
+                const int ny = iy - ty.halfWidth;
+                for (int iz = 0; iz < 2 * tz.halfWidth + 1; iz++)
+                {
+                    const int nz = iz - tz.halfWidth;
+                    if (0 == nx && 0 == ny && 0 == nz)
+                    {
+                        continue;
+                    }
+                    const DVec gridp = double(nx) * bx + double(ny) * by + double(nz) * bz;
+                    const double k2       = norm2(gridp);
+                    const double gaussian = std::exp(-M_PI * M_PI * k2 / beta2);
+                    const double coeff    = gaussian / (2.0 * M_PI * volume_ * k2);
+
+                    const double p1x = tx.poly1[ix];
+                    const double p1y = ty.poly1[iy];
+                    const double p1z = tz.poly1[iz];
+                    const double p1  = p1x + p1y + p1z;
+                    const double t1  = tx.poly2[ix] + ty.poly2[iy] + tz.poly2[iz]
+                                      + 2.0 * (p1x * p1y + p1z * p1y + p1z * p1x) + p1 * p1;
+                    sums.term1 += coeff * coeff * k2 * t1;
+
+                    double t2 = tx.poly3[ix] * tx.gridSize * dot(gridp, bx)
+                                + ty.poly3[iy] * ty.gridSize * dot(gridp, by)
+                                + tz.poly3[iz] * tz.gridSize * dot(gridp, bz);
+                    t2 *= 4.0 * M_PI;
+                    t2 += tx.poly4[ix] * polyFactor4[XX] + ty.poly4[iy] * polyFactor4[YY]
+                          + tz.poly4[iz] * polyFactor4[ZZ];
+                    sums.term2 += coeff * coeff * t2;
+
+                    const double selfCoeff = gaussian / k2;
+                    sums.marginals[XX][ix] += selfCoeff;
+                    sums.marginals[YY][iy] += selfCoeff;
+                    sums.marginals[ZZ][iz] += selfCoeff;
+                }
+            }
+        }
+    }
+
+    // Reduce the thread sums in a fixed order for reproducible results
+    double                                            term1 = 0;
+    double                                            term2 = 0;
+    std::array<std::array<double, c_numSelfTerms>, DIM> selfSums;
+    for (auto& selfSum : selfSums)
+    {
+        selfSum.fill(0);
+    }
+    for (const auto& sums : threadSums_)
+    {
+        term1 += sums.term1;
+        term2 += sums.term2;
+        for (int d = 0; d < DIM; d++)
+        {
+            for (int index = 0; index < 2 * tables_[d].halfWidth + 1; index++)
+            {
+                for (int j = 0; j < c_numSelfTerms; j++)
+                {
+                    selfSums[d][j] += tables_[d].selfWeights[index][j] * sums.marginals[d][index];
+                }
+            }
+        }
+    }
+
+    const double q2q2PerCharge = q2All_ * q2All_ / numCharges_;
+    term1 *= 32.0 * M_PI * M_PI * q2q2PerCharge;
+    term2 *= 4.0 * q2q2PerCharge;
+
+    /* Monte Carlo average of term IV of equation 35 in Wang2010 */
+    const int numSamples = sampleX_.size();
+    double    term3      = 0;
+#pragma omp parallel for num_threads(numThreads_) schedule(static) reduction(+ : term3)
+    for (int s = 0; s < numSamples; s++)
+    {
+        std::array<double, DIM> eRec3;
+        for (int d = 0; d < DIM; d++)
+        {
+            eRec3[d] = std::inner_product(
+                    sampleSines_[s][d].begin(), sampleSines_[s][d].end(), selfSums[d].begin(), 0.0);
+        }
+        const DVec selfTerm = eRec3[XX] * bx + eRec3[YY] * by + eRec3[ZZ] * bz;
+        const double q2 = double(sampleQ_[s]) * sampleQ_[s];
+        term3 += q2 * q2 * norm2(selfTerm);
+    }
+    term3 /= numSamples * M_PI * volume_ * M_PI * volume_;
+
+    return c_one4PiEps0 * std::sqrt(term1 + term2 + term3);
+}
+
+PmeReciprocalErrorEstimator::PmeReciprocalErrorEstimator(ArrayRef<const RVec> x,
+                                                         ArrayRef<const real> q,
+                                                         ArrayRef<const int>  selfTermSamples,
+                                                         const matrix         recipbox,
+                                                         real                 volume,
+                                                         int                  pmeOrder,
+                                                         int                  numThreads) :
+    impl_(std::make_unique<Impl>(x, q, selfTermSamples, recipbox, volume, pmeOrder, numThreads))
+{
+}
+
+PmeReciprocalErrorEstimator::~PmeReciprocalErrorEstimator() = default;
+
+real PmeReciprocalErrorEstimator::estimate(const ivec gridSize, real ewaldBeta)
+{
+    return impl_->estimate(gridSize, ewaldBeta);
+}
+
+int PmeReciprocalErrorEstimator::numSelfTermSamples() const
+{
+    return impl_->sampleX_.size();
+}
+
+} // namespace gmx
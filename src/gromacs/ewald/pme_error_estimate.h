@@ -0,0 +1,112 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \libinternal \file
+ *
+ * \brief Declares the estimator for the reciprocal-space force error of smooth PME.
+ *
+ * \inlibraryapi
+ * \ingroup module_ewald
+ */
+
+#ifndef GMX_EWALD_PME_ERROR_ESTIMATE_H
+#define GMX_EWALD_PME_ERROR_ESTIMATE_H
+
+#include <memory>
+
+#include "gromacs/math/vectypes.h"
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/real.h"
+
+namespace gmx
+{
+
+/*! \libinternal
+ * \brief Estimates the RMS reciprocal-space force error of smooth PME
+ *
+ * This implements the estimate of Wang et al., J. Chem. Phys. 132, 144105 (2010),
+ * which assumes a homogeneous distribution of the charges and a total charge of zero.
+ * The self-interaction term (term IV of equation 35) is averaged over a set of
+ * sampled charges, or over all charges.
+ *
+ * The aliasing series of the B-spline interpolation only depend on the grid size
+ * along each dimension, so they are tabulated once per grid, as are the sine factors
+ * of the sampled charges. The only part that depends on the Ewald splitting
+ * parameter is a single pass over the reciprocal grid, which also produces the
+ * marginal sums that reduce the self-interaction term to a cost linear in the grid
+ * size per sampled charge. Repeated estimates with different splitting parameters,
+ * as when tuning beta or balancing PME load, therefore only cost one grid pass each.
+ */
+class PmeReciprocalErrorEstimator
+{
+public:
+    /*! \brief Constructor
+     *
+     * \param[in] x              Coordinates of the charged atoms.
+     * \param[in] q              Charges of the charged atoms.
+     * \param[in] selfTermSamples  Indices into \p x and \p q of the charges used for
+     *                           the self-interaction term, all charges when empty.
+     * \param[in] recipbox       The reciprocal box, as used by PME.
+     * \param[in] volume         The box volume.
+     * \param[in] pmeOrder       The PME interpolation order.
+     * \param[in] numThreads     The number of OpenMP threads to use.
+     */
+    PmeReciprocalErrorEstimator(ArrayRef<const RVec> x,
+                                ArrayRef<const real> q,
+                                ArrayRef<const int>  selfTermSamples,
+                                const matrix         recipbox,
+                                real                 volume,
+                                int                  pmeOrder,
+                                int                  numThreads);
+    ~PmeReciprocalErrorEstimator();
+
+    /*! \brief Returns the reciprocal-space force error estimate in kJ/(mol nm)
+     *
+     * \param[in] gridSize   The PME grid size along each dimension.
+     * \param[in] ewaldBeta  The Ewald splitting parameter in 1/nm.
+     */
+    real estimate(const ivec gridSize, real ewaldBeta);
+
+    //! Returns the number of charges used for the self-interaction term
+    int numSelfTermSamples() const;
+
+private:
+    class Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace gmx
+
+#endif
@@ -109,6 +109,9 @@ constexpr int c_virialAndEnergyCount = 7;
 /*! \brief PME order parameter
  *
  *  Note that the GPU code, unlike the CPU, only supports order 4.
+ *  The kernels are templated on the order, but the warp layout of spline parameters and the
+ *  shuffle-based force reduction in gather assume that order (or order squared) threads per
+ *  atom evenly divide the warp, which does not hold for orders 5 and 6.
  */
 constexpr int c_pmeGpuOrder = 4;
 
@@ -54,6 +54,12 @@ typedef struct gmx_parallel_3dfft* gmx_parallel_3dfft_t;
  * And, expects that overlapSize <= local grid width.
  * Implement exchange with multiple neighbors to remove this limitation
  *
+ * The exchange is synchronous with respect to the PME stream: it waits for spread and
+ * packing to finish, then transfers and reduces all halos before the FFT is launched.
+ * ToDo: Overlapping the transfers with interior work needs the spread kernel to be split
+ * into halo and interior atom ranges on separate streams, and the distributed FFT (HeFFTe)
+ * to accept an interior-first schedule; neither is available yet.
+ *
  * \param[in]  pmeGpu                 The PME GPU structure.
  */
 void pmeGpuGridHaloExchange(const PmeGpu* pmeGpu);
@@ -52,6 +52,7 @@
 
 #include "config.h"
 
+#include <cstdlib>
 #include <list>
 #include <memory>
 #include <string>
@@ -782,6 +783,16 @@ static void pme_gpu_init_internal(PmeGpu* pmeGpu, const DeviceContext& deviceCon
      * The performance seems to be the same though.
      * TODO: PME could also try to pick up nice grid sizes (with factors of 2, 3, 5, 7).
      */
+#if GMX_GPU_CUDA || GMX_GPU_HIP
+    /* In-place R2C/C2R uses a single grid buffer, which halves the device memory needed
+     * for the FFT grids and makes grid switches during PME tuning cheaper.
+     * The HeFFTe backend used with decomposition only supports out-of-place transforms.
+     */
+    if (getenv("GMX_PME_GPU_INPLACE_FFT") != nullptr && !pmeGpu->settings.useDecomposition)
+    {
+        pmeGpu->archSpecific->performOutOfPlaceFFT = false;
+    }
+#endif
 
 #if GMX_GPU_CUDA || GMX_GPU_HIP
     pmeGpu->kernelParams->usePipeline       = char(false);
@@ -1055,9 +1066,10 @@ static void pme_gpu_reinit_grids(PmeGpu* pmeGpu)
         kernelParamsPtr->grid.complexGridSizePadded[i] = kernelParamsPtr->grid.realGridSize[i];
     }
     /* FFT: n real elements correspond to (n / 2 + 1) complex elements in minor dimension */
-    if (!pme_gpu_settings(pmeGpu).performGPUFFT)
+    if (!pme_gpu_settings(pmeGpu).performGPUFFT || !pmeGpu->archSpecific->performOutOfPlaceFFT)
     {
-        // This allows for GPU spreading grid and CPU fftgrid to have the same layout, so that we can copy the data directly
+        // This allows for GPU spreading grid and CPU fftgrid to have the same layout, so that we can copy the data directly.
+        // In-place GPU FFT needs the same padding to hold the complex output.
         kernelParamsPtr->grid.realGridSizePadded[ZZ] =
                 (kernelParamsPtr->grid.realGridSize[ZZ] / 2 + 1) * 2;
     }
@@ -1665,8 +1677,10 @@ void pme_gpu_spread(const PmeGpu*                  pmeGpu,
     pme_gpu_start_timing(pmeGpu, timingId);
     auto* timingEvent = pme_gpu_fetch_timing_event(pmeGpu, timingId);
 
-#if defined(GMX_GPU_HIP) && defined(GMX_THREAD_MPI)
-    // pipelining under thread-MPI makes the last pipeline step hang
+#if GMX_GPU_HIP && GMX_THREAD_MPI
+    // pipelining under thread-MPI makes the last pipeline step hang with HIP.
+    // Note that GMX_GPU_HIP and GMX_THREAD_MPI are always defined, to 0 or 1,
+    // so they need to be tested by value for the other builds to pipeline.
     // TODO Fix
     kernelParamsPtr->usePipeline = 0;
 #else
@@ -1775,6 +1789,20 @@ void pme_gpu_spread(const PmeGpu*                  pmeGpu,
     {
         pmeGpuGridHaloExchange(pmeGpu);
     }
+#if GMX_GPU_CUDA || GMX_GPU_HIP
+    else if (settings.performGPUFFT)
+    {
+        // Without decomposition the spread kernel already writes the FFT input grid directly
+        // (same buffer and padded layout), so no conversion pass is needed before the 3D FFT,
+        // and the gather kernel likewise reads the FFT output in place.
+        for (int gridIndex = 0; gridIndex < pmeGpu->common->ngrids; gridIndex++)
+        {
+            GMX_ASSERT(kernelParamsPtr->grid.d_fftRealGrid[gridIndex]
+                               == kernelParamsPtr->grid.d_realGrid[gridIndex],
+                       "Without decomposition the PME grid should be the FFT real grid");
+        }
+    }
+#endif
 
     const bool copyBackGrid =
             spreadCharges
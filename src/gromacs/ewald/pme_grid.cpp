@@ -44,6 +44,8 @@
 
 #include <cstdlib>
 
+#include <algorithm>
+
 #include "gromacs/ewald/pme.h"
 #include "gromacs/fft/parallel_3dfft.h"
 #include "gromacs/math/vec.h"
@@ -634,6 +636,35 @@ static int div_round_up(int enumerator, int denominator)
     return (enumerator + denominator - 1) / denominator;
 }
 
+/*! \brief Allocates \p numThreads thread-local grids of \p gridsize elements, with GMX_CACHE_SEP
+ * elements before, between and after them
+ *
+ * The memory is not cleared by the calling thread, but by the PME threads, each its own grid,
+ * with the same static schedule as used for spreading. With pinned threads, first touch then
+ * places each thread-local grid on the NUMA node of the thread that uses it.
+ */
+static real* allocateThreadLocalGrids(int numThreads, int gridsize)
+{
+    real* gridAll = static_cast<real*>(
+            save_malloc_aligned("gridAll",
+                                __FILE__,
+                                __LINE__,
+                                numThreads * gridsize + (numThreads + 1) * GMX_CACHE_SEP,
+                                sizeof(real),
+                                SIMD4_ALIGNMENT));
+
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int t = 0; t < numThreads; t++)
+    {
+        /* Each thread clears its grid and the separator after it */
+        const int begin = (t == 0 ? 0 : GMX_CACHE_SEP + t * (gridsize + GMX_CACHE_SEP));
+        const int end   = (t + 1) * (gridsize + GMX_CACHE_SEP) + GMX_CACHE_SEP;
+        std::fill(gridAll + begin, gridAll + end, 0.0_real);
+    }
+
+    return gridAll;
+}
+
 static void make_subgrid_division(const ivec n, int ovl, int nthread, ivec nsub)
 {
     int   gsize_opt, gsize;
@@ -689,6 +720,147 @@ static void make_subgrid_division(const ivec n, int ovl, int nthread, ivec nsub)
     }
 }
 
+/*! \brief The minimum number of threads for using colored spreading
+ *
+ * With few threads the overlap of the thread-local grids is small and cheap to reduce.
+ */
+static constexpr int c_pmeColoredSpreadMinThreads = 16;
+
+/* Returns whether n grid lines can be divided into nb colored blocks.
+ * The spreading range of an atom should cover at most two blocks, which requires
+ * blocks of at least pme_order - 1 lines, and blocks of the same parity should
+ * not be neighbors over the periodic boundary, which requires an even block count.
+ */
+static bool colorable_block_count(int n, int nb, int pme_order)
+{
+    return nb == 1 || (nb % 2 == 0 && n / nb >= pme_order - 1);
+}
+
+/* Returns the number of blocks with index parity p out of nb blocks */
+static int num_blocks_with_parity(int nb, int p)
+{
+    return (nb - p + 1) / 2;
+}
+
+/* Determines the division into colored blocks along x and y,
+ * returns false when no division with a block for each thread in every phase exists.
+ */
+static bool make_colored_block_division(const ivec n, int pme_order, int nthread, ivec ncb)
+{
+    double volumeOpt = -1;
+    for (int ncx = 1; ncx <= n[XX]; ncx++)
+    {
+        if (!colorable_block_count(n[XX], ncx, pme_order))
+        {
+            continue;
+        }
+        for (int ncy = 1; ncy <= n[YY]; ncy++)
+        {
+            if (!colorable_block_count(n[YY], ncy, pme_order))
+            {
+                continue;
+            }
+            const int numColors = (ncx > 1 ? 2 : 1) * (ncy > 1 ? 2 : 1);
+            if (ncx * ncy < nthread * numColors)
+            {
+                continue;
+            }
+            /* Minimize the number of grid points over all block grids */
+            const double volume = static_cast<double>(div_round_up(n[XX], ncx) + pme_order - 1) * ncx
+                                  * (div_round_up(n[YY], ncy) + pme_order - 1) * ncy;
+            if (volumeOpt < 0 || volume < volumeOpt)
+            {
+                ncb[XX]   = ncx;
+                ncb[YY]   = ncy;
+                volumeOpt = volume;
+            }
+        }
+    }
+    ncb[ZZ] = 1;
+
+    return volumeOpt >= 0;
+}
+
+/* Sets up the blocks, their assignment to threads and the block grids for colored spreading */
+static void init_colored_spreading(pmegrids_t* grids, const ivec n, int pme_order)
+{
+    const int nthread = grids->nthread;
+
+    for (int d = 0; d < DIM; d++)
+    {
+        snew(grids->g2b[d], n[d]);
+        int b = 0;
+        for (int i = 0; i < n[d]; i++)
+        {
+            while (b + 1 < grids->ncb[d] && i >= (n[d] * (b + 1)) / grids->ncb[d])
+            {
+                b++;
+            }
+            grids->g2b[d][i] = (d == XX ? b * grids->ncb[YY] : (d == YY ? b : 0));
+        }
+    }
+
+    /* Each thread gets a contiguous range of the blocks of each color */
+    snew(grids->block_order, grids->ncb[XX] * grids->ncb[YY]);
+    snew(grids->thread_color_block_start, nthread * c_pmeSpreadNumColors + 1);
+    int numOrdered = 0;
+    for (int t = 0; t < nthread; t++)
+    {
+        for (int c = 0; c < c_pmeSpreadNumColors; c++)
+        {
+            grids->thread_color_block_start[t * c_pmeSpreadNumColors + c] = numOrdered;
+
+            const int px             = c / 2;
+            const int py             = c % 2;
+            const int numBlocksY     = num_blocks_with_parity(grids->ncb[YY], py);
+            const int numColorBlocks = num_blocks_with_parity(grids->ncb[XX], px) * numBlocksY;
+            for (int j = (numColorBlocks * t) / nthread; j < (numColorBlocks * (t + 1)) / nthread; j++)
+            {
+                const int bx = px + 2 * (j / numBlocksY);
+                const int by = py + 2 * (j % numBlocksY);
+
+                grids->block_order[numOrdered++] = bx * grids->ncb[YY] + by;
+            }
+        }
+    }
+    grids->thread_color_block_start[nthread * c_pmeSpreadNumColors] = numOrdered;
+    GMX_RELEASE_ASSERT(numOrdered == grids->ncb[XX] * grids->ncb[YY],
+                       "All colored blocks should be assigned to a thread");
+
+    /* The block grids cover the whole z range, so wrapping along z stays within a block */
+    int nsz = n[ZZ] + pme_order - 1;
+    set_grid_alignment(&nsz, pme_order);
+    int gridsize = (div_round_up(n[XX], grids->ncb[XX]) + pme_order - 1)
+                   * (div_round_up(n[YY], grids->ncb[YY]) + pme_order - 1) * nsz;
+    set_gridsize_alignment(&gridsize, pme_order);
+    snew(grids->grid_block, nthread);
+    grids->grid_block_all = allocateThreadLocalGrids(nthread, gridsize);
+    for (int t = 0; t < nthread; t++)
+    {
+        pmegrid_init(&grids->grid_block[t],
+                     0,
+                     0,
+                     0,
+                     0,
+                     0,
+                     0,
+                     div_round_up(n[XX], grids->ncb[XX]),
+                     div_round_up(n[YY], grids->ncb[YY]),
+                     n[ZZ],
+                     TRUE,
+                     pme_order,
+                     grids->grid_block_all + GMX_CACHE_SEP + t * (gridsize + GMX_CACHE_SEP));
+    }
+
+    if (debug)
+    {
+        fprintf(debug,
+                "pmegrid colored spreading blocks: %d x %d\n",
+                grids->ncb[XX],
+                grids->ncb[YY]);
+    }
+}
+
 void pmegrids_init(pmegrids_t* grids,
                    int         nx,
                    int         ny,
@@ -698,7 +870,8 @@ void pmegrids_init(pmegrids_t* grids,
                    gmx_bool    bUseThreads,
                    int         nthread,
                    int         overlap_x,
-                   int         overlap_y)
+                   int         overlap_y,
+                   bool        allowColoredSpread)
 {
     ivec n, n_base;
     int  t, x, y, z, d, i, tfac;
@@ -717,7 +890,24 @@ void pmegrids_init(pmegrids_t* grids,
 
     make_subgrid_division(n_base, pme_order - 1, grids->nthread, grids->nc);
 
-    if (bUseThreads)
+    clear_ivec(grids->ncb);
+    for (d = 0; d < DIM; d++)
+    {
+        grids->g2b[d] = nullptr;
+    }
+    grids->block_order              = nullptr;
+    grids->thread_color_block_start = nullptr;
+    grids->grid_block               = nullptr;
+    grids->grid_block_all           = nullptr;
+    if (bUseThreads && allowColoredSpread && nthread >= c_pmeColoredSpreadMinThreads
+        && getenv("GMX_PME_NO_COLORED_SPREAD") == nullptr
+        && make_colored_block_division(n_base, pme_order, nthread, grids->ncb))
+    {
+        /* Colored spreading replaces the thread-local grids */
+        init_colored_spreading(grids, n_base, pme_order);
+    }
+
+    if (bUseThreads && grids->ncb[XX] == 0)
     {
         ivec nst;
         int  gridsize;
@@ -742,9 +932,7 @@ void pmegrids_init(pmegrids_t* grids,
         t        = 0;
         gridsize = nst[XX] * nst[YY] * nst[ZZ];
         set_gridsize_alignment(&gridsize, pme_order);
-        snew_aligned(grids->grid_all,
-                     grids->nthread * gridsize + (grids->nthread + 1) * GMX_CACHE_SEP,
-                     SIMD4_ALIGNMENT);
+        grids->grid_all = allocateThreadLocalGrids(grids->nthread, gridsize);
 
         for (x = 0; x < grids->nc[XX]; x++)
         {
@@ -772,7 +960,8 @@ void pmegrids_init(pmegrids_t* grids,
     }
     else
     {
-        grids->grid_th = nullptr;
+        grids->grid_th  = nullptr;
+        grids->grid_all = nullptr;
     }
 
     tfac = 1;
@@ -840,7 +1029,12 @@ void pmegrids_destroy(pmegrids_t* grids)
         for (int d = 0; d < DIM; d++)
         {
             sfree(grids->g2t[d]);
+            sfree(grids->g2b[d]);
         }
+        sfree(grids->block_order);
+        sfree(grids->thread_color_block_start);
+        sfree(grids->grid_block);
+        sfree_aligned(grids->grid_block_all);
     }
 }
 
@@ -922,7 +1116,7 @@ void reuse_pmegrids(const pmegrids_t* oldgrid, pmegrids_t* newgrid)
     sfree_aligned(newgrid->grid.grid);
     newgrid->grid.grid = oldgrid->grid.grid;
 
-    if (newgrid->grid_th != nullptr && newgrid->nthread == oldgrid->nthread)
+    if (newgrid->grid_th != nullptr && oldgrid->grid_th != nullptr && newgrid->nthread == oldgrid->nthread)
     {
         sfree_aligned(newgrid->grid_all);
         newgrid->grid_all = oldgrid->grid_all;
@@ -54,6 +54,12 @@ constexpr int c_pmeMaxUnitcellShift = 2;
  */
 constexpr int c_pmeNeighborUnitcellCount = 2 * c_pmeMaxUnitcellShift + 1;
 
+/*! \brief
+ * The number of colors, i.e. sequential phases, used with colored spreading.
+ * Blocks are colored by their parity along x and y.
+ */
+constexpr int c_pmeSpreadNumColors = 4;
+
 struct pmegrid_t;
 struct pmegrids_t;
 
@@ -90,7 +96,8 @@ void pmegrids_init(pmegrids_t* grids,
                    gmx_bool    bUseThreads,
                    int         nthread,
                    int         overlap_x,
-                   int         overlap_y);
+                   int         overlap_y,
+                   bool        allowColoredSpread);
 
 void pmegrids_destroy(pmegrids_t* grids);
 
@@ -268,10 +268,12 @@ public:
 
     //! The number of threads to use in PME
     int nthread;
-    //! Thread index for each atom
+    //! Thread index for each atom, block index with colored spreading
     FastVector<int>              thread_idx;
     std::vector<AtomToThreadMap> threadMap;
     std::vector<splinedata_t>    spline;
+    //! With colored spreading, for each thread the start in spline.ind of each of its blocks
+    std::vector<std::vector<int>> threadBlockAtomStart;
 };
 
 /*! \brief Data structure for a single PME grid */
@@ -295,6 +297,17 @@ struct pmegrids_t
     real*      grid_all;     /* Allocated array for the grids in *grid_th        */
     int*       g2t[DIM];     /* The grid to thread index                         */
     ivec       nthread_comm; /* The number of threads to communicate with        */
+
+    /* Colored spreading: atoms are binned on blocks of grid columns along x and y.
+     * Blocks of the same color do not overlap and are spread in the same phase
+     * directly to the FFT grid, without thread grid overlap reduction.
+     */
+    ivec       ncb;                      /* The number of blocks, ncb[XX] = 0 when not used */
+    int*       g2b[DIM];                 /* The grid to block index, zero along z           */
+    int*       block_order;              /* The blocks ordered on thread and color          */
+    int*       thread_color_block_start; /* Start in block_order per thread and color       */
+    pmegrid_t* grid_block;               /* The largest block grid, for each thread         */
+    real*      grid_block_all;           /* Allocated array for the grids in *grid_block    */
 };
 
 /*! \brief Data structure for spline-interpolation working buffers */
@@ -49,6 +49,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstdlib>
 
 #include <algorithm>
 
@@ -74,6 +75,7 @@
 #include "gromacs/nbnxm/gpu_data_mgmt.h"
 #include "gromacs/nbnxm/nbnxm.h"
 #include "gromacs/pbcutil/pbc.h"
+#include "gromacs/timing/steptimestatistics.h"
 #include "gromacs/timing/wallcycle.h"
 #include "gromacs/timing/walltime_accounting.h"
 #include "gromacs/utility/cstringutil.h"
@@ -141,6 +143,14 @@ const int c_numFirstTuningIntervalSkipWithSepPme = 3;
 const int c_numPostSwitchTuningIntervalSkip = 1;
 //! \brief Number of seconds to delay the tuning at startup to allow processors clocks to ramp up.
 const double c_startupTimeDelay = 5.0;
+//! \brief Number of nstlist long intervals averaged per monitoring window in continuous mode.
+const int c_continuousMonitorWindow = 100;
+/*! \brief In continuous mode, re-tune when the average step time of a window deviates
+ * by more than this factor from the reference, in either direction.
+ */
+const real c_continuousRetuneTriggerFactor = 1.1;
+//! \brief Number of consecutive deviating windows required for re-tuning, for hysteresis.
+const int c_continuousNumDeviatingWindows = 2;
 
 /*! \brief Enumeration whose values describe the effect limiting the load balancing */
 enum class PmeLoadBalancingLimit : int
@@ -198,6 +208,15 @@ struct pme_load_balancing_t
     int    cycles_n;  /**< step cycle counter cumulative count */
     double cycles_c;  /**< step cycle counter cumulative cycles */
     double startTime; /**< time stamp when the balancing was started on the master rank (relative to the UNIX epoch start).*/
+
+    bool    bContinuous;         /**< keep monitoring the performance after tuning? */
+    bool    bMonitor;            /**< are we monitoring the performance of the chosen setup? */
+    int     monitorIntervals;    /**< number of nstlist intervals in the current window */
+    double  monitorCycles;       /**< cycles accumulated in the current window */
+    double  monitorReference;    /**< average cycles per interval after tuning, <= 0 when unset */
+    int     numDeviatingWindows; /**< number of consecutive windows deviating from the reference */
+    int     retunePrevious;      /**< setup chosen before re-tuning, -1 when not re-tuning */
+    int64_t numStragglerWindows; /**< number of windows with stragglers at the previous call */
 };
 
 /* TODO The code in this file should call this getter, rather than
@@ -294,6 +313,15 @@ void pme_loadbal_init(pme_load_balancing_t**     pme_lb_p,
 
     pme_lb->cycles_n = 0;
     pme_lb->cycles_c = 0;
+
+    pme_lb->bContinuous         = (getenv("GMX_PME_LB_CONTINUOUS") != nullptr);
+    pme_lb->bMonitor            = false;
+    pme_lb->monitorIntervals    = 0;
+    pme_lb->monitorCycles       = 0;
+    pme_lb->monitorReference    = 0;
+    pme_lb->numDeviatingWindows = 0;
+    pme_lb->retunePrevious      = -1;
+    pme_lb->numStragglerWindows = 0;
     // only master ranks do timing
     if (!PAR(cr) || (haveDDAtomOrdering(*cr) && DDMASTER(cr->dd)))
     {
@@ -777,6 +805,20 @@ static void pme_load_balance(pme_load_balancing_t*          pme_lb,
 
         if (pme_lb->stage == pme_lb->nstage)
         {
+            /* When re-tuning, only switch away from the previous setup
+             * when the new one is significantly faster.
+             */
+            if (pme_lb->retunePrevious >= 0)
+            {
+                const pme_setup_t& previous = pme_lb->setup[pme_lb->retunePrevious];
+                if (previous.count > c_numPostSwitchTuningIntervalSkip
+                    && previous.cycles <= cycles_fast * maxFluctuationAccepted)
+                {
+                    pme_lb->fastest = pme_lb->retunePrevious;
+                }
+                pme_lb->retunePrevious = -1;
+            }
+
             /* We are done optimizing, use the fastest setup we found */
             pme_lb->cur = pme_lb->fastest;
         }
@@ -915,6 +957,97 @@ static void continue_pme_loadbal(pme_load_balancing_t* pme_lb, gmx_bool bDlbUnlo
     pme_lb->start = pme_lb->lower_limit;
 }
 
+/*! \brief Monitor the performance of the chosen setup in continuous mode
+ *
+ * \param[in,out] pme_lb  Pointer to PME load balancing struct
+ * \param[in]     cr      Communication record
+ * \param[in]     fp_err  Stream for notes, can be nullptr
+ * \param[in]     fp_log  Log file, can be nullptr
+ * \param[in]     cycles  Cycles of the last nstlist interval on this rank
+ * \param[in]     step    Current step
+ *
+ * The cycles are accumulated locally over windows of c_continuousMonitorWindow
+ * intervals, so there is only communication once per window. When the average
+ * over c_continuousNumDeviatingWindows consecutive windows deviates from the
+ * average right after tuning, due to e.g. GPU clock throttling or changing
+ * network load, the setups are rescanned.
+ */
+static void pme_loadbal_monitor(pme_load_balancing_t* pme_lb,
+                                t_commrec*            cr,
+                                FILE*                 fp_err,
+                                FILE*                 fp_log,
+                                double                cycles,
+                                int64_t               step)
+{
+    pme_lb->monitorCycles += cycles;
+    pme_lb->monitorIntervals++;
+    if (pme_lb->monitorIntervals < c_continuousMonitorWindow)
+    {
+        return;
+    }
+
+    double cyclesAverage = pme_lb->monitorCycles / pme_lb->monitorIntervals;
+    pme_lb->monitorCycles    = 0;
+    pme_lb->monitorIntervals = 0;
+    if (PAR(cr))
+    {
+        gmx_sumd(1, &cyclesAverage, cr);
+        cyclesAverage /= cr->nnodes;
+    }
+
+    if (pme_lb->monitorReference <= 0)
+    {
+        pme_lb->monitorReference = cyclesAverage;
+        return;
+    }
+
+    const double ratio = cyclesAverage / pme_lb->monitorReference;
+    if (ratio > c_continuousRetuneTriggerFactor || ratio * c_continuousRetuneTriggerFactor < 1)
+    {
+        pme_lb->numDeviatingWindows++;
+    }
+    else
+    {
+        pme_lb->numDeviatingWindows = 0;
+    }
+    if (pme_lb->numDeviatingWindows < c_continuousNumDeviatingWindows)
+    {
+        return;
+    }
+
+    auto buf = gmx::formatString(
+            "step %4s: the step time changed by %+.0f%%, re-tuning PME load balancing",
+            gmx::int64ToString(step).c_str(),
+            (ratio - 1) * 100);
+    if (fp_err != nullptr)
+    {
+        fprintf(fp_err, "\r%s\n", buf.c_str());
+        fflush(fp_err);
+    }
+    if (fp_log != nullptr)
+    {
+        fprintf(fp_log, "%s\n", buf.c_str());
+    }
+
+    /* The old timings are no longer valid, time all setups again */
+    for (pme_setup_t& setup : pme_lb->setup)
+    {
+        setup.count  = 0;
+        setup.cycles = 0;
+    }
+    pme_lb->fastest = pme_lb->cur;
+    if (pme_lb->stage > 0)
+    {
+        pme_lb->retunePrevious = pme_lb->cur;
+        continue_pme_loadbal(pme_lb, FALSE);
+    }
+
+    pme_lb->bMonitor            = false;
+    pme_lb->numDeviatingWindows = 0;
+    pme_lb->bBalance            = TRUE;
+    pme_lb->bActive             = TRUE;
+}
+
 void pme_loadbal_do(pme_load_balancing_t*          pme_lb,
                     t_commrec*                     cr,
                     FILE*                          fp_err,
@@ -928,14 +1061,15 @@ void pme_loadbal_do(pme_load_balancing_t*          pme_lb,
                     int64_t                        step,
                     int64_t                        step_rel,
                     gmx_bool*                      bPrinting,
-                    bool                           useGpuPmePpCommunication)
+                    bool                           useGpuPmePpCommunication,
+                    const gmx::StepTimeStatistics* stepTimeStatistics)
 {
     int    n_prev;
     double cycles_prev;
 
     assert(pme_lb != nullptr);
 
-    if (!pme_lb->bActive)
+    if (!pme_lb->bActive && !pme_lb->bMonitor)
     {
         return;
     }
@@ -944,6 +1078,37 @@ void pme_loadbal_do(pme_load_balancing_t*          pme_lb,
     cycles_prev = pme_lb->cycles_c;
     wallcycle_get(wcycle, WallCycleCounter::Step, &pme_lb->cycles_n, &pme_lb->cycles_c);
 
+    /* The timing of an interval in which a rank was straggling, e.g. due to OS jitter,
+     * does not reflect the performance of the setup, so we ignore it.
+     * The straggler detection is collective, so all ranks agree on this.
+     */
+    bool intervalHadStraggler = false;
+    if (stepTimeStatistics != nullptr)
+    {
+        intervalHadStraggler =
+                (stepTimeStatistics->numStragglerWindows() != pme_lb->numStragglerWindows);
+        pme_lb->numStragglerWindows = stepTimeStatistics->numStragglerWindows();
+    }
+
+    if (!pme_lb->bActive)
+    {
+        if (pme_lb->cycles_n < n_prev)
+        {
+            /* The cycle counters were reset, discard the current window */
+            pme_lb->monitorCycles    = 0;
+            pme_lb->monitorIntervals = 0;
+        }
+        else if (!intervalHadStraggler)
+        {
+            pme_loadbal_monitor(pme_lb, cr, fp_err, fp_log, pme_lb->cycles_c - cycles_prev, step);
+        }
+        *bPrinting = pme_lb->bBalance;
+        if (!pme_lb->bBalance)
+        {
+            return;
+        }
+    }
+
     /* Before the first step we haven't done any steps yet.
      * Also handle cases where ir.init_step % ir.nstlist != 0.
      * We also want to skip a number of steps and seconds while
@@ -1048,7 +1213,16 @@ void pme_loadbal_do(pme_load_balancing_t*          pme_lb,
         }
     }
 
-    if (pme_lb->bBalance)
+    if (pme_lb->bBalance && intervalHadStraggler)
+    {
+        if (fp_log != nullptr)
+        {
+            fprintf(fp_log,
+                    "step %4s: ignoring the timing, a rank was straggling\n",
+                    gmx::int64ToString(step).c_str());
+        }
+    }
+    else if (pme_lb->bBalance)
     {
         /* We might not have collected nstlist steps in cycles yet,
          * since init_step might not be a multiple of nstlist,
@@ -1094,6 +1268,17 @@ void pme_loadbal_do(pme_load_balancing_t*          pme_lb,
                 .appendText("NOTE: DLB can now turn on, when beneficial");
     }
 
+    if (!pme_lb->bActive && pme_lb->bContinuous && !pme_lb->bMonitor)
+    {
+        /* Keep monitoring the chosen setup, the reference is set by the first window */
+        pme_lb->bMonitor            = true;
+        pme_lb->monitorIntervals    = 0;
+        pme_lb->monitorCycles       = 0;
+        pme_lb->monitorReference    = 0;
+        pme_lb->numDeviatingWindows = 0;
+        pme_lb->retunePrevious      = -1;
+    }
+
     *bPrinting = pme_lb->bBalance;
 }
 
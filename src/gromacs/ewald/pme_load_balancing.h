@@ -61,6 +61,7 @@ class t_state;
 namespace gmx
 {
 class MDLogger;
+class StepTimeStatistics;
 template<typename T>
 class ArrayRef;
 } // namespace gmx
@@ -94,6 +95,8 @@ void pme_loadbal_init(pme_load_balancing_t**     pme_lb_p,
  * either continue balancing or check if we need to trigger balancing.
  * Should be called after the WallCycleCounter::Step cycle counter has been stopped.
  * Returns if the load balancing is printing to fp_err.
+ * When \p stepTimeStatistics is not nullptr, the timings of intervals in which
+ * it detected a straggling rank are ignored.
  */
 void pme_loadbal_do(pme_load_balancing_t*          pme_lb,
                     struct t_commrec*              cr,
@@ -108,7 +111,8 @@ void pme_loadbal_do(pme_load_balancing_t*          pme_lb,
                     int64_t                        step,
                     int64_t                        step_rel,
                     gmx_bool*                      bPrinting,
-                    bool                           useGpuPmePpCommunication);
+                    bool                           useGpuPmePpCommunication,
+                    const gmx::StepTimeStatistics* stepTimeStatistics);
 
 /*! \brief Finish the PME load balancing and print the settings when fplog!=NULL */
 void pme_loadbal_done(pme_load_balancing_t* pme_lb, FILE* fplog, const gmx::MDLogger& mdlog, gmx_bool bNonBondedOnGPU);
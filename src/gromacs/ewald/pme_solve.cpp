@@ -268,57 +268,72 @@ calc_exponentials_q(int start, int end, real f, ArrayRef<real> d, ArrayRef<real>
 }
 #endif
 
+/* For LJ-PME we compute the full energy and virial prefactors for each kx
+ * in one pass, including the square root, so no scalar work remains per
+ * grid point except the (triclinic) mh setup and the structure factors.
+ *
+ * On input, eterm contains -factor*m^2 and d the B-spline moduli denominator.
+ * On output, eterm contains the energy/force prefactor and, when
+ * computeVirialTerm is set, vterm the virial prefactor; both include 1/d.
+ */
 #if defined PME_SIMD_SOLVE
-/* Calculate exponentials through SIMD */
+/* Calculate exponentials and prefactors through SIMD */
 inline static void calc_exponentials_lj(int /*unused*/,
                                         int /*unused*/,
-                                        ArrayRef<SimdReal> r_aligned,
-                                        ArrayRef<SimdReal> factor_aligned,
+                                        bool               computeVirialTerm,
+                                        ArrayRef<SimdReal> eterm_aligned,
+                                        ArrayRef<SimdReal> vterm_aligned,
                                         ArrayRef<SimdReal> d_aligned)
 {
-    SimdReal       tmp_r, tmp_d, tmp_fac, d_inv, tmp_mk;
     const SimdReal sqr_PI = sqrt(SimdReal(M_PI));
+    const SimdReal one(1.0);
+    const SimdReal two(2.0);
+    const SimdReal three(3.0);
 
-    GMX_ASSERT(d_aligned.size() == r_aligned.size(), "d and r must have same size");
-    GMX_ASSERT(d_aligned.size() == factor_aligned.size(), "d and factor must have same size");
+    GMX_ASSERT(d_aligned.size() == eterm_aligned.size(), "d and eterm must have same size");
+    GMX_ASSERT(d_aligned.size() == vterm_aligned.size(), "d and vterm must have same size");
     for (size_t kx = 0; kx != d_aligned.size(); ++kx)
     {
         /* We only need to calculate from start. But since start is 0 or 1
          * and we want to use aligned loads/stores, we always start from 0.
          */
-        tmp_d              = d_aligned[kx];
-        d_inv              = SimdReal(1.0) / tmp_d;
-        d_aligned[kx]      = d_inv;
-        tmp_r              = r_aligned[kx];
-        tmp_r              = gmx::exp(tmp_r);
-        r_aligned[kx]      = tmp_r;
-        tmp_mk             = factor_aligned[kx];
-        tmp_fac            = sqr_PI * tmp_mk * erfc(tmp_mk);
-        factor_aligned[kx] = tmp_fac;
+        SimdReal tmp_r   = eterm_aligned[kx];
+        SimdReal m2k     = -tmp_r;
+        SimdReal tmp_mk  = sqrt(m2k);
+        SimdReal d_inv   = one / d_aligned[kx];
+        SimdReal tmp_exp = gmx::exp(tmp_r);
+        SimdReal tmp_fac = sqr_PI * tmp_mk * erfc(tmp_mk);
+
+        eterm_aligned[kx] = -((one - two * m2k) * tmp_exp + two * m2k * tmp_fac) * d_inv;
+        if (computeVirialTerm)
+        {
+            vterm_aligned[kx] = three * (tmp_fac - tmp_exp) * d_inv;
+        }
     }
 }
 #else
-inline static void
-calc_exponentials_lj(int start, int end, ArrayRef<real> r, ArrayRef<real> tmp2, ArrayRef<real> d)
+inline static void calc_exponentials_lj(int            start,
+                                        int            end,
+                                        bool           computeVirialTerm,
+                                        ArrayRef<real> eterm,
+                                        ArrayRef<real> vterm,
+                                        ArrayRef<real> d)
 {
-    int  kx;
-    real mk;
-    GMX_ASSERT(d.size() == r.size(), "d and r must have same size");
-    GMX_ASSERT(d.size() == tmp2.size(), "d and tmp2 must have same size");
-    for (kx = start; kx < end; kx++)
+    GMX_ASSERT(d.size() == eterm.size(), "d and eterm must have same size");
+    GMX_ASSERT(d.size() == vterm.size(), "d and vterm must have same size");
+    for (int kx = start; kx < end; kx++)
     {
-        d[kx] = 1.0 / d[kx];
-    }
-
-    for (kx = start; kx < end; kx++)
-    {
-        r[kx] = std::exp(r[kx]);
-    }
-
-    for (kx = start; kx < end; kx++)
-    {
-        mk       = tmp2[kx];
-        tmp2[kx] = sqrt(M_PI) * mk * std::erfc(mk);
+        real m2k     = -eterm[kx];
+        real mk      = std::sqrt(m2k);
+        real d_inv   = 1.0 / d[kx];
+        real tmp_exp = std::exp(eterm[kx]);
+        real tmp_fac = std::sqrt(M_PI) * mk * std::erfc(mk);
+
+        eterm[kx] = -((1.0 - 2.0 * m2k) * tmp_exp + 2.0 * m2k * tmp_fac) * d_inv;
+        if (computeVirialTerm)
+        {
+            vterm[kx] = 3.0 * (tmp_fac - tmp_exp) * d_inv;
+        }
     }
 }
 #endif
@@ -611,7 +626,7 @@ int solve_pme_lj_yzx(const gmx_pme_t* pme,
     real                     by, bz;
     real                     virxx = 0, virxy = 0, virxz = 0, viryy = 0, viryz = 0, virzz = 0;
     real                     rxx, ryx, ryy, rzx, rzy, rzz;
-    real *                   mhx, *mhy, *mhz, *m2, *denom, *tmp1, *tmp2;
+    real *                   mhx, *mhy, *mhz, *denom, *tmp1, *tmp2;
     real                     mhxk, mhyk, mhzk, m2k;
     struct pme_solve_work_t* work;
     real                     corner_fac;
@@ -638,7 +653,6 @@ int solve_pme_lj_yzx(const gmx_pme_t* pme,
     mhx   = work->mhx;
     mhy   = work->mhy;
     mhz   = work->mhz;
-    m2    = work->m2;
     denom = work->denom;
     tmp1  = work->tmp1;
     tmp2  = work->tmp2;
@@ -699,10 +713,8 @@ int solve_pme_lj_yzx(const gmx_pme_t* pme,
                 mhx[kx]   = mhxk;
                 mhy[kx]   = mhyk;
                 mhz[kx]   = mhzk;
-                m2[kx]    = m2k;
                 denom[kx] = bz * by * pme->bsp_mod[XX][kx];
                 tmp1[kx]  = -factor * m2k;
-                tmp2[kx]  = sqrt(factor * m2k);
             }
 
             for (kx = maxkx; kx < kxend; kx++)
@@ -716,10 +728,8 @@ int solve_pme_lj_yzx(const gmx_pme_t* pme,
                 mhx[kx]   = mhxk;
                 mhy[kx]   = mhyk;
                 mhz[kx]   = mhzk;
-                m2[kx]    = m2k;
                 denom[kx] = bz * by * pme->bsp_mod[XX][kx];
                 tmp1[kx]  = -factor * m2k;
-                tmp2[kx]  = sqrt(factor * m2k);
             }
             /* Clear padding elements to avoid (harmless) fp exceptions */
             const int kxendSimd = roundUpToMultipleOfFactor<c_simdWidth>(kxend);
@@ -732,19 +742,11 @@ int solve_pme_lj_yzx(const gmx_pme_t* pme,
             calc_exponentials_lj(
                     kxstart,
                     kxend,
+                    true,
                     ArrayRef<PME_T>(tmp1, tmp1 + roundUpToMultipleOfFactor<c_simdWidth>(kxend)),
                     ArrayRef<PME_T>(tmp2, tmp2 + roundUpToMultipleOfFactor<c_simdWidth>(kxend)),
                     ArrayRef<PME_T>(denom, denom + roundUpToMultipleOfFactor<c_simdWidth>(kxend)));
 
-            for (kx = kxstart; kx < kxend; kx++)
-            {
-                m2k      = factor * m2[kx];
-                eterm    = -((1.0 - 2.0 * m2k) * tmp1[kx] + 2.0 * m2k * tmp2[kx]);
-                vterm    = 3.0 * (-tmp1[kx] + tmp2[kx]);
-                tmp1[kx] = eterm * denom[kx];
-                tmp2[kx] = vterm * denom[kx];
-            }
-
             if (!bLB)
             {
                 t_complex* p0;
@@ -845,10 +847,8 @@ int solve_pme_lj_yzx(const gmx_pme_t* pme,
                 mhyk      = mx * ryx + my * ryy;
                 mhzk      = mx * rzx + my * rzy + mz * rzz;
                 m2k       = mhxk * mhxk + mhyk * mhyk + mhzk * mhzk;
-                m2[kx]    = m2k;
                 denom[kx] = bz * by * pme->bsp_mod[XX][kx];
                 tmp1[kx]  = -factor * m2k;
-                tmp2[kx]  = sqrt(factor * m2k);
             }
 
             for (kx = maxkx; kx < kxend; kx++)
@@ -859,10 +859,8 @@ int solve_pme_lj_yzx(const gmx_pme_t* pme,
                 mhyk      = mx * ryx + my * ryy;
                 mhzk      = mx * rzx + my * rzy + mz * rzz;
                 m2k       = mhxk * mhxk + mhyk * mhyk + mhzk * mhzk;
-                m2[kx]    = m2k;
                 denom[kx] = bz * by * pme->bsp_mod[XX][kx];
                 tmp1[kx]  = -factor * m2k;
-                tmp2[kx]  = sqrt(factor * m2k);
             }
             /* Clear padding elements to avoid (harmless) fp exceptions */
             const int kxendSimd = roundUpToMultipleOfFactor<c_simdWidth>(kxend);
@@ -872,19 +870,14 @@ int solve_pme_lj_yzx(const gmx_pme_t* pme,
                 tmp2[kx] = 0;
             }
 
+            /* Only the energy/force prefactor is needed, skip the virial term */
             calc_exponentials_lj(
                     kxstart,
                     kxend,
+                    false,
                     ArrayRef<PME_T>(tmp1, tmp1 + roundUpToMultipleOfFactor<c_simdWidth>(kxend)),
                     ArrayRef<PME_T>(tmp2, tmp2 + roundUpToMultipleOfFactor<c_simdWidth>(kxend)),
                     ArrayRef<PME_T>(denom, denom + roundUpToMultipleOfFactor<c_simdWidth>(kxend)));
-
-            for (kx = kxstart; kx < kxend; kx++)
-            {
-                m2k      = factor * m2[kx];
-                eterm    = -((1.0 - 2.0 * m2k) * tmp1[kx] + 2.0 * m2k * tmp2[kx]);
-                tmp1[kx] = eterm * denom[kx];
-            }
             gcount = (bLB ? 7 : 1);
             for (ig = 0; ig < gcount; ++ig)
             {
@@ -52,6 +52,7 @@
 #include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/smalloc.h"
 
 #include "pme_grid.h"
@@ -87,9 +88,15 @@ static void calc_interpolation_idx(const gmx_pme_t* pme, PmeAtomComm* atc, int s
     rzy = pme->recipbox[ZZ][YY];
     rzz = pme->recipbox[ZZ][ZZ];
 
-    g2tx = pme->pmegrid[grid_index].g2t[XX];
-    g2ty = pme->pmegrid[grid_index].g2t[YY];
-    g2tz = pme->pmegrid[grid_index].g2t[ZZ];
+    /* With colored spreading we bin the atoms on blocks instead of on threads */
+    const pmegrids_t& grids   = pme->pmegrid[grid_index];
+    const bool        colored = (grids.ncb[XX] > 0);
+
+    g2tx = colored ? grids.g2b[XX] : grids.g2t[XX];
+    g2ty = colored ? grids.g2b[YY] : grids.g2t[YY];
+    g2tz = colored ? grids.g2b[ZZ] : grids.g2t[ZZ];
+
+    const int numBins = colored ? grids.ncb[XX] * grids.ncb[YY] : atc->nthread;
 
     bThreads = (atc->nthread > 1);
     if (bThreads)
@@ -97,7 +104,7 @@ static void calc_interpolation_idx(const gmx_pme_t* pme, PmeAtomComm* atc, int s
         thread_idx = atc->thread_idx.data();
 
         tpl_n = atc->threadMap[thread].n;
-        for (i = 0; i < atc->nthread; i++)
+        for (i = 0; i < numBins; i++)
         {
             tpl_n[i] = 0;
         }
@@ -155,7 +162,7 @@ static void calc_interpolation_idx(const gmx_pme_t* pme, PmeAtomComm* atc, int s
         /* Make a list of particle indices sorted on thread */
 
         /* Get the cumulative count */
-        for (i = 1; i < atc->nthread; i++)
+        for (i = 1; i < numBins; i++)
         {
             tpl_n[i] += tpl_n[i - 1];
         }
@@ -164,9 +171,9 @@ static void calc_interpolation_idx(const gmx_pme_t* pme, PmeAtomComm* atc, int s
          * in pme_realloc_atomcomm_things.
          */
         AtomToThreadMap& threadMap = atc->threadMap[thread];
-        threadMap.i.resize(tpl_n[atc->nthread - 1]);
+        threadMap.i.resize(tpl_n[numBins - 1]);
         /* Set tpl_n to the cumulative start */
-        for (i = atc->nthread - 1; i >= 1; i--)
+        for (i = numBins - 1; i >= 1; i--)
         {
             tpl_n[i] = tpl_n[i - 1];
         }
@@ -207,6 +214,43 @@ static void make_thread_local_ind(const PmeAtomComm* atc, int thread, splinedata
     spline->n = n;
 }
 
+/* Combine the indices of the atoms in the blocks of our thread into one index,
+ * ordered on color and block, and store the start of each block in \p blockAtomStart.
+ */
+static void make_thread_local_ind_colored(const PmeAtomComm* atc,
+                                          const pmegrids_t*  grids,
+                                          int                thread,
+                                          splinedata_t*      spline,
+                                          std::vector<int>*  blockAtomStart)
+{
+    const int blockBegin = grids->thread_color_block_start[thread * c_pmeSpreadNumColors];
+    const int blockEnd   = grids->thread_color_block_start[(thread + 1) * c_pmeSpreadNumColors];
+
+    blockAtomStart->resize(blockEnd - blockBegin + 1);
+
+    int n = 0;
+    for (int b = blockBegin; b < blockEnd; b++)
+    {
+        (*blockAtomStart)[b - blockBegin] = n;
+
+        const int block = grids->block_order[b];
+        for (int t = 0; t < atc->nthread; t++)
+        {
+            const AtomToThreadMap& threadMap = atc->threadMap[t];
+
+            const int start = (block > 0 ? threadMap.n[block - 1] : 0);
+            const int end   = threadMap.n[block];
+            for (int i = start; i < end; i++)
+            {
+                spline->ind[n++] = threadMap.i[i];
+            }
+        }
+    }
+    (*blockAtomStart)[blockEnd - blockBegin] = n;
+
+    spline->n = n;
+}
+
 // At run time, the values of order used and asserted upon mean that
 // indexing out of bounds does not occur. However compilers don't
 // always understand that, so we suppress this warning for this code
@@ -325,10 +369,12 @@ static void make_bsplines(splinevec  theta,
 static void spread_coefficients_bsplines_thread(const pmegrid_t*       pmegrid,
                                                 const PmeAtomComm*     atc,
                                                 splinedata_t*          spline,
-                                                struct pme_spline_work gmx_unused* work)
+                                                struct pme_spline_work gmx_unused* work,
+                                                int                                atomBegin,
+                                                int                                atomEnd)
 {
 
-    /* spread coefficients from home atoms to local grid */
+    /* spread coefficients from home atoms atomBegin to atomEnd in spline to local grid */
     real*      grid;
     int        i, nn, n, ithx, ithy, ithz, i0, j0, k0;
     const int* idxptr;
@@ -359,7 +405,7 @@ static void spread_coefficients_bsplines_thread(const pmegrid_t*       pmegrid,
 
     order = pmegrid->order;
 
-    for (nn = 0; nn < spline->n; nn++)
+    for (nn = atomBegin; nn < atomEnd; nn++)
     {
         n           = spline->ind[nn];
         coefficient = atc->coefficient[n];
@@ -886,6 +932,153 @@ static void sum_fftgrid_dd(const gmx_pme_t* pme, real* fftgrid, int grid_index)
     }
 }
 
+/* Add a block grid to the local FFT grid, wrapping the spreading overlap periodically */
+static void add_block_grid_to_fftgrid(const pmegrid_t* blockGrid,
+                                      const ivec       local_fft_ndata,
+                                      const ivec       local_fft_size,
+                                      real*            fftgrid)
+{
+    const int fft_my = local_fft_size[YY];
+    const int fft_mz = local_fft_size[ZZ];
+    const int nz     = local_fft_ndata[ZZ];
+
+    const int   nsy  = blockGrid->s[YY];
+    const int   nsz  = blockGrid->s[ZZ];
+    const real* grid = blockGrid->grid;
+
+    for (int x = 0; x < blockGrid->n[XX]; x++)
+    {
+        int fx = blockGrid->offset[XX] + x;
+        if (fx >= local_fft_ndata[XX])
+        {
+            fx -= local_fft_ndata[XX];
+        }
+        for (int y = 0; y < blockGrid->n[YY]; y++)
+        {
+            int fy = blockGrid->offset[YY] + y;
+            if (fy >= local_fft_ndata[YY])
+            {
+                fy -= local_fft_ndata[YY];
+            }
+            real*       fftgrid_xy = fftgrid + (fx * fft_my + fy) * fft_mz;
+            const real* grid_xy    = grid + (x * nsy + y) * nsz;
+            for (int z = 0; z < nz; z++)
+            {
+                fftgrid_xy[z] += grid_xy[z];
+            }
+            for (int z = nz; z < blockGrid->n[ZZ]; z++)
+            {
+                fftgrid_xy[z - nz] += grid_xy[z];
+            }
+        }
+    }
+}
+
+/* Spline and spread with colored blocks, see pmegrids_t.
+ * In each color phase, each thread spreads its blocks of that color on a small
+ * block grid and adds it directly to the FFT grid. Blocks of the same color
+ * do not overlap, so no thread grid overlap reduction is needed.
+ */
+static void spread_on_grid_colored(const gmx_pme_t*  pme,
+                                   PmeAtomComm*      atc,
+                                   const pmegrids_t* grids,
+                                   gmx_bool          bCalcSplines,
+                                   gmx_bool          bSpread,
+                                   real*             fftgrid,
+                                   gmx_bool          bDoSplines,
+                                   int               grid_index)
+{
+    const int nthread = pme->nthread;
+    GMX_ASSERT(grids->nthread == nthread, "Colored spreading requires a block assignment for each thread");
+
+    ivec local_fft_ndata, local_fft_offset, local_fft_size;
+    gmx_parallel_3dfft_real_limits(
+            pme->pfft_setup[grid_index], local_fft_ndata, local_fft_offset, local_fft_size);
+
+#pragma omp parallel num_threads(nthread)
+    {
+        const int         thread         = gmx_omp_get_thread_num();
+        splinedata_t*     spline         = &atc->spline[thread];
+        std::vector<int>& blockAtomStart = atc->threadBlockAtomStart[thread];
+
+        try
+        {
+            make_thread_local_ind_colored(atc, grids, thread, spline, &blockAtomStart);
+
+            if (bCalcSplines)
+            {
+                make_bsplines(spline->theta.coefficients,
+                              spline->dtheta.coefficients,
+                              pme->pme_order,
+                              as_rvec_array(atc->fractx.data()),
+                              spline->n,
+                              spline->ind.data(),
+                              atc->coefficient.data(),
+                              bDoSplines);
+            }
+
+            if (bSpread)
+            {
+                /* Clear our part of the FFT grid, the blocks are added to it */
+                const int  sizeXSlice = local_fft_size[YY] * local_fft_size[ZZ];
+                const int  xStart     = (local_fft_ndata[XX] * thread) / nthread;
+                const int  xEnd       = (local_fft_ndata[XX] * (thread + 1)) / nthread;
+                std::fill(fftgrid + xStart * sizeXSlice, fftgrid + xEnd * sizeXSlice, 0.0_real);
+            }
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+
+        if (bSpread)
+        {
+            const int* colorBlockStart =
+                    grids->thread_color_block_start + thread * c_pmeSpreadNumColors;
+
+            for (int c = 0; c < c_pmeSpreadNumColors; c++)
+            {
+                /* Wait for clearing of the FFT grid or for the previous color to finish */
+#pragma omp barrier
+                try
+                {
+                    for (int b = colorBlockStart[c]; b < colorBlockStart[c + 1]; b++)
+                    {
+                        const int atomBegin = blockAtomStart[b - colorBlockStart[0]];
+                        const int atomEnd   = blockAtomStart[b - colorBlockStart[0] + 1];
+                        if (atomBegin == atomEnd)
+                        {
+                            continue;
+                        }
+
+                        const int block = grids->block_order[b];
+                        const int bx    = block / grids->ncb[YY];
+                        const int by    = block % grids->ncb[YY];
+
+                        pmegrid_t blockGrid;
+                        pmegrid_init(&blockGrid,
+                                     bx,
+                                     by,
+                                     0,
+                                     (local_fft_ndata[XX] * bx) / grids->ncb[XX],
+                                     (local_fft_ndata[YY] * by) / grids->ncb[YY],
+                                     0,
+                                     (local_fft_ndata[XX] * (bx + 1)) / grids->ncb[XX],
+                                     (local_fft_ndata[YY] * (by + 1)) / grids->ncb[YY],
+                                     local_fft_ndata[ZZ],
+                                     TRUE,
+                                     pme->pme_order,
+                                     grids->grid_block[thread].grid);
+
+                        spread_coefficients_bsplines_thread(
+                                &blockGrid, atc, spline, pme->spline_work, atomBegin, atomEnd);
+
+                        add_block_grid_to_fftgrid(&blockGrid, local_fft_ndata, local_fft_size, fftgrid);
+                    }
+                }
+                GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+            }
+        }
+    }
+}
+
 void spread_on_grid(const gmx_pme_t*  pme,
                     PmeAtomComm*      atc,
                     const pmegrids_t* grids,
@@ -934,6 +1127,13 @@ void spread_on_grid(const gmx_pme_t*  pme,
     cs1 += (double)c1;
 #endif
 
+    if (grids != nullptr && grids->ncb[XX] > 0)
+    {
+        spread_on_grid_colored(pme, atc, grids, bCalcSplines, bSpread, fftgrid, bDoSplines, grid_index);
+
+        return;
+    }
+
 #ifdef PME_TIME_THREADS
     c2 = omp_cyc_start();
 #endif
@@ -987,7 +1187,7 @@ void spread_on_grid(const gmx_pme_t*  pme,
 #ifdef PME_TIME_SPREAD
                 ct1a = omp_cyc_start();
 #endif
-                spread_coefficients_bsplines_thread(grid, atc, spline, pme->spline_work);
+                spread_coefficients_bsplines_thread(grid, atc, spline, pme->spline_work, 0, spline->n);
 
                 if (pme->bUseThreads)
                 {
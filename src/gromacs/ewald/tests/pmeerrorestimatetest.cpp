@@ -0,0 +1,306 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements tests for the PME reciprocal-space error estimate.
+ *
+ * \ingroup module_ewald
+ */
+
+#include "gmxpre.h"
+
+#include <cmath>
+
+#include <array>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/ewald/pme_error_estimate.h"
+#include "gromacs/math/invertmatrix.h"
+#include "gromacs/math/units.h"
+#include "gromacs/math/vec.h"
+#include "gromacs/math/vectypes.h"
+#include "gromacs/utility/stringutil.h"
+
+#include "testutils/testasserts.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+//! The number of aliasing terms on each side of the series in the direct evaluation
+constexpr int c_directSumOrder = 6;
+
+//! Returns sum_i (2 pi (m/K + i))^-power * factor(i) over the aliasing terms with \p includeZero
+template<typename Factor>
+double aliasingSum(int m, int K, double power, bool includeZero, Factor factor)
+{
+    double sum = 0;
+    for (int i = -c_directSumOrder; i <= c_directSumOrder; i++)
+    {
+        if (i != 0 || includeZero)
+        {
+            sum += factor(i) * std::pow(2.0 * M_PI * (double(m) / K + i), -power);
+        }
+    }
+    return sum;
+}
+
+/*! \brief Returns the reciprocal-space PME force error of equation 35 in Wang2010
+ *
+ * Evaluates all aliasing series at every grid point and the self-interaction
+ * term of every charge with a separate pass over the grid, without any tabulation.
+ */
+double directReciprocalError(ArrayRef<const RVec> x,
+                             ArrayRef<const real> q,
+                             const matrix         recipbox,
+                             double               volume,
+                             int                  pmeOrder,
+                             const ivec           gridSize,
+                             double               beta)
+{
+    const double n          = pmeOrder;
+    auto         one        = [](int) { return 1.0; };
+    auto         aliasIndex = [](int i) { return double(i); };
+    auto         eps1       = [&](int m, int K) {
+        return m == 0 ? 0.0 : -aliasingSum(m, K, n, false, one) / aliasingSum(m, K, n, true, one);
+    };
+    auto eps2 = [&](int m, int K) {
+        if (m == 0)
+        {
+            return 0.0;
+        }
+        const double denom = aliasingSum(m, K, n, true, one);
+        return aliasingSum(m, K, 2 * n, false, one) / (denom * denom) + eps1(m, K) * eps1(m, K);
+    };
+    auto eps3 = [&](int m, int K) {
+        const double denom = aliasingSum(m, K, n, true, one);
+        return m == 0 ? 0.0
+                      : 2.0 * M_PI * aliasingSum(m, K, 2 * n, true, aliasIndex) / (denom * denom);
+    };
+    auto eps4 = [&](int m, int K) {
+        const double denom       = aliasingSum(m, K, n, true, one);
+        auto         aliasIndex2 = [](int i) { return double(i) * i; };
+        return m == 0 ? 0.0
+                      : 4.0 * M_PI * M_PI * aliasingSum(m, K, 2 * n, true, aliasIndex2)
+                                / (denom * denom);
+    };
+    auto epsSelf = [&](int m, int K, const RVec& rboxv, const RVec& xi) {
+        if (m == 0)
+        {
+            return 0.0;
+        }
+        const double rcoord = iprod(rboxv, xi);
+        auto         sine   = [&](int i) { return -std::sin(2.0 * M_PI * i * K * rcoord) * i; };
+        return 2.0 * M_PI * K * aliasingSum(m, K, n, false, sine) / aliasingSum(m, K, n, true, one);
+    };
+
+    double q2All = 0;
+    for (const real charge : q)
+    {
+        q2All += charge * charge;
+    }
+    const double q2q2PerCharge = q2All * q2All / q.ssize();
+
+    const RVec bx(recipbox[XX]);
+    const RVec by(recipbox[YY]);
+    const RVec bz(recipbox[ZZ]);
+    const int  Kx = gridSize[XX];
+    const int  Ky = gridSize[YY];
+    const int  Kz = gridSize[ZZ];
+
+    double term1   = 0;
+    double term2   = 0;
+    auto   forGrid = [&](auto body) {
+        for (int nx = -Kx / 2; nx <= Kx / 2; nx++)
+        {
+            for (int ny = -Ky / 2; ny <= Ky / 2; ny++)
+            {
+                for (int nz = -Kz / 2; nz <= Kz / 2; nz++)
+                {
+                    if (nx != 0 || ny != 0 || nz != 0)
+                    {
+                        const DVec gridp = (double(nx) * bx.toDVec() + double(ny) * by.toDVec()
+                                            + double(nz) * bz.toDVec());
+                        body(nx, ny, nz, gridp, norm2(gridp));
+                    }
+                }
+            }
+        }
+    };
+    forGrid([&](int nx, int ny, int nz, const DVec& gridp, double k2) {
+        const double coeff =
+                std::exp(-M_PI * M_PI * k2 / (beta * beta)) / (2.0 * M_PI * volume * k2);
+
+        const double p1x = eps1(nx, Kx);
+        const double p1y = eps1(ny, Ky);
+        const double p1z = eps1(nz, Kz);
+        const double t1  = eps2(nx, Kx) + eps2(ny, Ky) + eps2(nz, Kz)
+                          + 2.0 * (p1x * p1y + p1z * p1y + p1z * p1x)
+                          + (p1x + p1y + p1z) * (p1x + p1y + p1z);
+        term1 += 32.0 * M_PI * M_PI * coeff * coeff * k2 * t1 * q2q2PerCharge;
+
+        double t2 = eps3(nx, Kx) * Kx * dot(gridp, bx.toDVec())
+                    + eps3(ny, Ky) * Ky * dot(gridp, by.toDVec())
+                    + eps3(nz, Kz) * Kz * dot(gridp, bz.toDVec());
+        t2 *= 4.0 * M_PI;
+        t2 += eps4(nx, Kx) * norm2(bx.toDVec()) * Kx * Kx
+              + eps4(ny, Ky) * norm2(by.toDVec()) * Ky * Ky
+              + eps4(nz, Kz) * norm2(bz.toDVec()) * Kz * Kz;
+        term2 += 4.0 * coeff * coeff * t2 * q2q2PerCharge;
+    });
+
+    double term3 = 0;
+    for (gmx::index i = 0; i < q.ssize(); i++)
+    {
+        DVec eRec3 = { 0, 0, 0 };
+        forGrid([&](int nx, int ny, int nz, const DVec& /*gridp*/, double k2) {
+            const double coeff = std::exp(-M_PI * M_PI * k2 / (beta * beta)) / k2;
+            eRec3[XX] += coeff * epsSelf(nx, Kx, bx, x[i]);
+            eRec3[YY] += coeff * epsSelf(ny, Ky, by, x[i]);
+            eRec3[ZZ] += coeff * epsSelf(nz, Kz, bz, x[i]);
+        });
+        const DVec selfTerm =
+                eRec3[XX] * bx.toDVec() + eRec3[YY] * by.toDVec() + eRec3[ZZ] * bz.toDVec();
+        const double q2 = double(q[i]) * q[i];
+        term3 += q2 * q2 * norm2(selfTerm) / (q.ssize() * M_PI * volume * M_PI * volume);
+    }
+
+    return c_one4PiEps0 * std::sqrt(term1 + term2 + term3);
+}
+
+//! Test fixture with a small neutral system of random charges in a rectangular box
+class PmeErrorEstimateTest : public ::testing::Test
+{
+public:
+    PmeErrorEstimateTest()
+    {
+        const matrix box = { { 3.1, 0, 0 }, { 0, 3.3, 0 }, { 0, 0, 3.5 } };
+        volume_          = det(box);
+        invertBoxMatrix(box, recipbox_);
+        // Deterministic, roughly homogeneous positions
+        for (int i = 0; i < c_numCharges; i++)
+        {
+            x_.emplace_back(box[XX][XX] * std::fmod(0.6180339887 * i, 1.0),
+                            box[YY][YY] * std::fmod(0.4142135624 * i, 1.0),
+                            box[ZZ][ZZ] * std::fmod(0.7320508076 * i, 1.0));
+            q_.push_back(i % 2 == 0 ? 0.8 : -0.8);
+        }
+    }
+
+    //! Returns an estimator using \p samples for the self-interaction term on \p numThreads
+    PmeReciprocalErrorEstimator makeEstimator(ArrayRef<const int> samples, int numThreads = 2) const
+    {
+        return PmeReciprocalErrorEstimator(
+                x_, q_, samples, recipbox_, volume_, c_pmeOrder, numThreads);
+    }
+
+    //! The number of charges
+    static constexpr int c_numCharges = 60;
+    //! The PME interpolation order
+    static constexpr int c_pmeOrder = 4;
+    //! The Ewald splitting parameter
+    static constexpr real c_beta = 3.12;
+    //! Coordinates
+    std::vector<RVec> x_;
+    //! Charges
+    std::vector<real> q_;
+    //! Reciprocal box
+    matrix recipbox_;
+    //! Box volume
+    real volume_;
+};
+
+TEST_F(PmeErrorEstimateTest, AllChargesAreUsedWithoutSamples)
+{
+    std::vector<int> allCharges(c_numCharges);
+    std::iota(allCharges.begin(), allCharges.end(), 0);
+
+    const ivec gridSize = { 16, 16, 18 };
+    const real estimate = makeEstimator({}).estimate(gridSize, c_beta);
+    EXPECT_GT(estimate, 0);
+    EXPECT_REAL_EQ_TOL(estimate,
+                       makeEstimator(allCharges).estimate(gridSize, c_beta),
+                       relativeToleranceAsFloatingPoint(estimate, 1e-6));
+}
+
+TEST_F(PmeErrorEstimateTest, RepeatedEstimatesReuseTables)
+{
+    PmeReciprocalErrorEstimator estimator = makeEstimator({});
+
+    const ivec coarseGrid = { 12, 12, 14 };
+    const ivec fineGrid   = { 20, 20, 24 };
+    const real coarse     = estimator.estimate(coarseGrid, c_beta);
+    const real fine       = estimator.estimate(fineGrid, c_beta);
+    // A finer grid with the same splitting parameter gives a smaller error
+    EXPECT_LT(fine, coarse);
+    // Switching back to a grid and splitting parameter gives the same result
+    EXPECT_REAL_EQ_TOL(coarse,
+                       estimator.estimate(coarseGrid, c_beta),
+                       relativeToleranceAsFloatingPoint(coarse, 1e-6));
+    // A larger splitting parameter moves weight to reciprocal space
+    EXPECT_GT(estimator.estimate(coarseGrid, 1.2 * c_beta), coarse);
+}
+
+TEST_F(PmeErrorEstimateTest, MatchesDirectEvaluation)
+{
+    const std::vector<std::array<int, DIM>> gridSizes = {
+        { 8, 8, 8 }, { 9, 11, 12 }, { 12, 10, 14 }
+    };
+    for (const auto& size : gridSizes)
+    {
+        SCOPED_TRACE(formatString("Grid %d x %d x %d", size[XX], size[YY], size[ZZ]));
+        const ivec   gridSize = { size[XX], size[YY], size[ZZ] };
+        const double direct =
+                directReciprocalError(x_, q_, recipbox_, volume_, c_pmeOrder, gridSize, c_beta);
+        EXPECT_GT(direct, 0);
+        for (const int numThreads : { 1, 3 })
+        {
+            SCOPED_TRACE(formatString("With %d threads", numThreads));
+            EXPECT_REAL_EQ_TOL(direct,
+                               makeEstimator({}, numThreads).estimate(gridSize, c_beta),
+                               relativeToleranceAsFloatingPoint(direct, 1e-5));
+        }
+    }
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
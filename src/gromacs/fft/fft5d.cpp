@@ -47,6 +47,7 @@
 #include <cstring>
 
 #include <algorithm>
+#include <vector>
 
 #include "gromacs/gpu_utils/gpu_utils.h"
 #include "gromacs/gpu_utils/hostallocator.h"
@@ -151,6 +152,108 @@ static int vmax(const int* a, int s)
     return max;
 }
 
+/* Number of uint16_t header elements per block in the FP16 transpose buffers,
+ * used to store the scaling factor of the block as a float.
+ */
+static const int c_halfBlockHeaderSize = sizeof(float) / sizeof(uint16_t);
+
+/* Returns the real-valued size of one block of the MPI transpose for FFT step s */
+static int fft5d_transpose_block_size(const fft5d_plan plan, int s)
+{
+    if ((s == 0 && !(plan->flags & FFT5D_ORDER_YZ)) || (s == 1 && (plan->flags & FFT5D_ORDER_YZ)))
+    {
+        return plan->N[s] * plan->pM[s] * plan->K[s] * sizeof(t_complex) / sizeof(real);
+    }
+    else
+    {
+        return plan->N[s] * plan->M[s] * plan->pK[s] * sizeof(t_complex) / sizeof(real);
+    }
+}
+
+
+/* The number of chunks each transpose is split into with FFT5D_OVERLAP_COMM */
+static const int c_numOverlapCommChunks = 4;
+
+#if GMX_LIB_MPI && !defined FFT5D_MPI_TRANSPOSE
+/* Sets up the chunks and their 1D FFT plans for overlapping the transpose of FFT step s.
+ *
+ * The elements of each transpose block are split uniformly into chunks, so the
+ * chunk boundaries are identical on all ranks. Chunk c of the FFT lines contains
+ * all lines whose output starts before the end of element chunk c. Note that
+ * splitaxes() puts line (y,z) at offset (z*M + y)*N in every block.
+ * When a chunk would have fewer lines than threads on any rank, step s is not overlapped.
+ * Has to be called by all ranks in plan->cart[s].
+ */
+static void fft5d_init_overlap_comm(fft5d_plan plan, int s)
+{
+    const int numChunks  = c_numOverlapCommChunks;
+    const int numLines   = plan->pM[s] * plan->pK[s];
+    const int blockSize  = fft5d_transpose_block_size(plan, s) * sizeof(real) / sizeof(t_complex);
+    const int numThreads = plan->nthreads;
+
+    std::vector<int> chunkLineStart(numChunks + 1);
+    std::vector<int> chunkElementStart(numChunks + 1);
+    int              line       = 0;
+    int              canOverlap = 1;
+    for (int c = 0; c <= numChunks; c++)
+    {
+        chunkElementStart[c] = (c * blockSize) / numChunks;
+        while (line < numLines
+               && ((line / plan->pM[s]) * plan->M[s] + line % plan->pM[s]) * plan->N[s]
+                          < chunkElementStart[c])
+        {
+            line++;
+        }
+        chunkLineStart[c] = (c == numChunks ? numLines : line);
+        if (c > 0 && chunkLineStart[c] - chunkLineStart[c - 1] < numThreads)
+        {
+            canOverlap = 0;
+        }
+    }
+    /* The number of lines differs between ranks, but all ranks need to use the same transpose */
+    int allCanOverlap;
+    MPI_Allreduce(&canOverlap, &allCanOverlap, 1, MPI_INT, MPI_MIN, plan->cart[s]);
+    if (!allCanOverlap)
+    {
+        return;
+    }
+
+    plan->chunkLineStart[s] = static_cast<int*>(malloc((numChunks + 1) * sizeof(int)));
+    std::copy(chunkLineStart.begin(), chunkLineStart.end(), plan->chunkLineStart[s]);
+    /* Counts and displacements for MPI_Ialltoallv in reals */
+    plan->chunkCounts[s] = static_cast<int*>(malloc(numChunks * plan->P[s] * sizeof(int)));
+    plan->chunkDispls[s] = static_cast<int*>(malloc(numChunks * plan->P[s] * sizeof(int)));
+    for (int c = 0; c < numChunks; c++)
+    {
+        for (int i = 0; i < plan->P[s]; i++)
+        {
+            plan->chunkCounts[s][c * plan->P[s] + i] =
+                    2 * (chunkElementStart[c + 1] - chunkElementStart[c]);
+            plan->chunkDispls[s][c * plan->P[s] + i] = 2 * (i * blockSize + chunkElementStart[c]);
+        }
+    }
+
+    plan->p1dChunk[s] = static_cast<gmx_fft_t*>(malloc(sizeof(gmx_fft_t) * numThreads * numChunks));
+    for (int c = 0; c < numChunks; c++)
+    {
+        const int chunkLines = plan->chunkLineStart[s][c + 1] - plan->chunkLineStart[s][c];
+        for (int t = 0; t < numThreads; t++)
+        {
+            const int tsize = ((t + 1) * chunkLines / numThreads) - (t * chunkLines / numThreads);
+            gmx_fft_t* p1d  = &plan->p1dChunk[s][c * numThreads + t];
+            const int  fftFlags = (plan->flags & FFT5D_NOMEASURE) ? GMX_FFT_FLAG_CONSERVATIVE : 0;
+            if ((plan->flags & FFT5D_REALCOMPLEX) && !(plan->flags & FFT5D_BACKWARD) && s == 0)
+            {
+                gmx_fft_init_many_1d_real(p1d, plan->rC[s], tsize, fftFlags);
+            }
+            else
+            {
+                gmx_fft_init_many_1d(p1d, plan->C[s], tsize, fftFlags);
+            }
+        }
+    }
+}
+#endif
 
 /* NxMxK the size of the data
  * comm communicator to use for fft5d
@@ -745,6 +848,43 @@ fft5d_plan fft5d_plan_3d(int                NG,
     plan->flags         = flags;
     plan->nthreads      = nthreads;
     plan->pinningPolicy = realGridAllocationPinningPolicy;
+
+#ifndef FFT5D_MPI_TRANSPOSE
+    if (plan->flags & FFT5D_HALF_COMM)
+    {
+        size_t halfBufferSize = 0;
+        for (s = 0; s < 2; s++)
+        {
+            if (nP[s] > 1)
+            {
+                halfBufferSize = std::max(
+                        halfBufferSize,
+                        static_cast<size_t>(nP[s])
+                                * (fft5d_transpose_block_size(plan, s) + c_halfBlockHeaderSize));
+            }
+        }
+        snew(plan->halfSendBuffer, halfBufferSize);
+        snew(plan->halfRecvBuffer, halfBufferSize);
+    }
+#else
+    plan->flags &= ~FFT5D_HALF_COMM;
+#endif
+
+#if GMX_LIB_MPI && !defined FFT5D_MPI_TRANSPOSE
+    /* The FP16 transposes are not overlapped. With a single thread the transpose
+     * buffers alias the FFT input and output, so these can not be overlapped either.
+     */
+    if ((plan->flags & FFT5D_OVERLAP_COMM) && !(plan->flags & FFT5D_HALF_COMM) && nthreads > 1)
+    {
+        for (s = 0; s < 2; s++)
+        {
+            if (nP[s] > 1 && plan->p1d[s] != nullptr)
+            {
+                fft5d_init_overlap_comm(plan, s);
+            }
+        }
+    }
+#endif
     *rlin               = lin;
     *rlout              = lout;
     *rlout2             = lout2;
@@ -1115,6 +1255,220 @@ static void print_localdata(const t_complex* lin, const char* txt, int s, fft5d_
     }
 }
 
+/* Converts a float to IEEE FP16 with round to nearest even, saturates at the largest finite value */
+static uint16_t float_to_half(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000U;
+    bits &= 0x7fffffffU;
+
+    if (bits >= 0x477fe000U)
+    {
+        /* Would round to 65536 or more */
+        return sign | 0x7bffU;
+    }
+    if (bits < 0x38800000U)
+    {
+        /* Below the smallest normal FP16 value of 2^-14 */
+        if (bits < 0x33000000U)
+        {
+            return sign;
+        }
+        const uint32_t mantissa = (bits & 0x7fffffU) | 0x800000U;
+        const uint32_t shift    = 126 - (bits >> 23);
+        uint32_t       h        = mantissa >> shift;
+        const uint32_t rest     = mantissa & ((1U << shift) - 1);
+        const uint32_t halfway  = 1U << (shift - 1);
+        if (rest > halfway || (rest == halfway && (h & 1U)))
+        {
+            h++;
+        }
+        return sign | h;
+    }
+
+    /* Rebias the exponent from 127 to 15 and round off 13 mantissa bits */
+    uint32_t       h    = (bits - 0x38000000U) >> 13;
+    const uint32_t rest = bits & 0x1fffU;
+    if (rest > 0x1000U || (rest == 0x1000U && (h & 1U)))
+    {
+        h++;
+    }
+    return sign | h;
+}
+
+/* Converts IEEE FP16 to float, infinities and NaNs are never produced by float_to_half */
+static float half_to_float(uint16_t h)
+{
+    const uint32_t sign     = static_cast<uint32_t>(h & 0x8000U) << 16;
+    const uint32_t exponent = (h >> 10) & 0x1fU;
+    const uint32_t mantissa = h & 0x3ffU;
+
+    float value;
+    if (exponent == 0)
+    {
+        value = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -value : value;
+    }
+    const uint32_t bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/* Converts the send blocks of lout2 for FFT step s to FP16, called by all threads
+ *
+ * Each block is scaled by a power of two, such that its largest absolute value
+ * is close to, but below, 2^15. This avoids overflow and keeps the full relative
+ * FP16 precision independently of the magnitude of the grid values.
+ */
+static void fft5d_pack_half(const fft5d_plan plan, int s, const t_complex* lout2, int thread)
+{
+    const int   blockSize = fft5d_transpose_block_size(plan, s);
+    const real* in        = reinterpret_cast<const real*>(lout2);
+
+    for (int b = thread; b < plan->P[s]; b += plan->nthreads)
+    {
+        const real* blockIn  = in + static_cast<size_t>(b) * blockSize;
+        uint16_t*   blockOut = plan->halfSendBuffer
+                             + static_cast<size_t>(b) * (blockSize + c_halfBlockHeaderSize);
+
+        real maxAbs = 0;
+        for (int i = 0; i < blockSize; i++)
+        {
+            maxAbs = std::max(maxAbs, std::abs(blockIn[i]));
+        }
+        int exponent = 0;
+        if (maxAbs > 0)
+        {
+            std::frexp(maxAbs, &exponent);
+        }
+        const int   scaleExponent = std::min(std::max(15 - exponent, -100), 100);
+        const float scale         = std::ldexp(1.0F, scaleExponent);
+        const float invScale      = std::ldexp(1.0F, -scaleExponent);
+
+        std::memcpy(blockOut, &invScale, sizeof(invScale));
+        for (int i = 0; i < blockSize; i++)
+        {
+            blockOut[c_halfBlockHeaderSize + i] = float_to_half(static_cast<float>(blockIn[i]) * scale);
+        }
+    }
+}
+
+/* Converts the received FP16 blocks for FFT step s back into lout3, called by all threads */
+static void fft5d_unpack_half(const fft5d_plan plan, int s, t_complex* lout3, int thread)
+{
+    const int blockSize = fft5d_transpose_block_size(plan, s);
+    real*     out       = reinterpret_cast<real*>(lout3);
+
+    for (int b = thread; b < plan->P[s]; b += plan->nthreads)
+    {
+        const uint16_t* blockIn = plan->halfRecvBuffer
+                                  + static_cast<size_t>(b) * (blockSize + c_halfBlockHeaderSize);
+        real* blockOut = out + static_cast<size_t>(b) * blockSize;
+
+        float invScale;
+        std::memcpy(&invScale, blockIn, sizeof(invScale));
+        for (int i = 0; i < blockSize; i++)
+        {
+            blockOut[i] = half_to_float(blockIn[c_halfBlockHeaderSize + i]) * invScale;
+        }
+    }
+}
+
+#if GMX_LIB_MPI && !defined FFT5D_MPI_TRANSPOSE
+/* Does the 1D FFTs, split and transpose of FFT step s in chunks, called by all threads
+ *
+ * The non-blocking transpose of each chunk overlaps with the FFTs and split of the
+ * next chunks. On return, after the caller's barrier, lout3 contains the same data
+ * as after the MPI_Alltoall of the non-overlapped path.
+ */
+static void fft5d_fft_split_overlap_comm(fft5d_plan plan, int s, int thread, fft5d_time times)
+{
+    const int  numChunks  = c_numOverlapCommChunks;
+    const int  numThreads = plan->nthreads;
+    const bool realToComplex =
+            (plan->flags & FFT5D_REALCOMPLEX) && !(plan->flags & FFT5D_BACKWARD) && s == 0;
+    MPI_Request requests[c_numOverlapCommChunks];
+
+    /* The chunks divide the lines over the threads differently than the previous step
+     * that produced plan->lin, so we need to wait for all of plan->lin to be written.
+     */
+#    pragma omp barrier
+
+    for (int c = 0; c < numChunks; c++)
+    {
+        const int chunkLines = plan->chunkLineStart[s][c + 1] - plan->chunkLineStart[s][c];
+        const int lineStart  = plan->chunkLineStart[s][c] + (thread * chunkLines) / numThreads;
+        const int lineEnd    = plan->chunkLineStart[s][c] + ((thread + 1) * chunkLines) / numThreads;
+        const int offset     = lineStart * plan->C[s];
+
+        gmx_fft_t p1d = plan->p1dChunk[s][c * numThreads + thread];
+        if (realToComplex)
+        {
+            gmx_fft_many_1d_real(p1d, GMX_FFT_REAL_TO_COMPLEX, plan->lin + offset, plan->lout + offset);
+        }
+        else
+        {
+            gmx_fft_many_1d(p1d,
+                            (plan->flags & FFT5D_BACKWARD) ? GMX_FFT_BACKWARD : GMX_FFT_FORWARD,
+                            plan->lin + offset,
+                            plan->lout + offset);
+        }
+
+        const int pM = plan->pM[s];
+        splitaxes(plan->lout2,
+                  plan->lout,
+                  plan->N[s],
+                  plan->M[s],
+                  plan->K[s],
+                  pM,
+                  plan->P[s],
+                  plan->C[s],
+                  plan->iNout[s],
+                  plan->oNout[s],
+                  lineStart % pM,
+                  lineStart / pM,
+                  lineEnd % pM,
+                  lineEnd / pM);
+
+#    pragma omp barrier /* the whole chunk needs to be split before sending */
+
+        if (thread == 0)
+        {
+            /* The counts and displacements are stored in the plan,
+             * as they should not change before the transpose completes.
+             */
+            int* counts = plan->chunkCounts[s] + c * plan->P[s];
+            int* displs = plan->chunkDispls[s] + c * plan->P[s];
+            MPI_Ialltoallv(reinterpret_cast<real*>(plan->lout2),
+                           counts,
+                           displs,
+                           GMX_MPI_REAL,
+                           reinterpret_cast<real*>(plan->lout3),
+                           counts,
+                           displs,
+                           GMX_MPI_REAL,
+                           plan->cart[s],
+                           &requests[c]);
+            /* Give MPI a chance to progress the transposes already started */
+            int flag;
+            MPI_Testall(c + 1, requests, &flag, MPI_STATUSES_IGNORE);
+        }
+    }
+
+    if (thread == 0)
+    {
+#    ifndef NOGMX
+        wallcycle_start(times, WallCycleCounter::PmeFftComm);
+#    endif
+        MPI_Waitall(numChunks, requests, MPI_STATUSES_IGNORE);
+#    ifndef NOGMX
+        wallcycle_stop(times, WallCycleCounter::PmeFftComm);
+#    endif
+    }
+}
+#endif
+
 void fft5d_execute(fft5d_plan plan, int thread, fft5d_time times)
 {
     t_complex* lin   = plan->lin;
@@ -1183,6 +1537,11 @@ void fft5d_execute(fft5d_plan plan, int thread, fft5d_time times)
         {
             bParallelDim = 0;
         }
+#if GMX_LIB_MPI && !defined FFT5D_MPI_TRANSPOSE
+        const bool overlapComm = bParallelDim && plan->p1dChunk[s] != nullptr;
+#else
+        const bool overlapComm = false;
+#endif
 
         /* ---------- START FFT ------------ */
 #ifdef NOGMX
@@ -1209,7 +1568,13 @@ void fft5d_execute(fft5d_plan plan, int thread, fft5d_time times)
         }
 
         tstart = (thread * pM[s] * pK[s] / plan->nthreads) * C[s];
-        if ((plan->flags & FFT5D_REALCOMPLEX) && !(plan->flags & FFT5D_BACKWARD) && s == 0)
+        if (overlapComm)
+        {
+#if GMX_LIB_MPI && !defined FFT5D_MPI_TRANSPOSE
+            fft5d_fft_split_overlap_comm(plan, s, thread, times);
+#endif
+        }
+        else if ((plan->flags & FFT5D_REALCOMPLEX) && !(plan->flags & FFT5D_BACKWARD) && s == 0)
         {
             gmx_fft_many_1d_real(p1d[s][thread],
                                  (plan->flags & FFT5D_BACKWARD) ? GMX_FFT_COMPLEX_TO_REAL
@@ -1238,7 +1603,7 @@ void fft5d_execute(fft5d_plan plan, int thread, fft5d_time times)
         /* ---------- END FFT ------------ */
 
         /* ---------- START SPLIT + TRANSPOSE------------ (if parallel in in this dimension)*/
-        if (bParallelDim)
+        if (bParallelDim && !overlapComm)
         {
 #ifdef NOGMX
             if (times != NULL && thread == 0)
@@ -1270,6 +1635,11 @@ void fft5d_execute(fft5d_plan plan, int thread, fft5d_time times)
                           tend / pM[s]);
             }
 #pragma omp barrier /*barrier required before AllToAll (all input has to be their) - before timing to make timing more acurate*/
+            if (plan->flags & FFT5D_HALF_COMM)
+            {
+                fft5d_pack_half(plan, s, lout2, thread);
+#pragma omp barrier
+            }
 #ifdef NOGMX
             if (times != NULL && thread == 0)
             {
@@ -1293,8 +1663,21 @@ void fft5d_execute(fft5d_plan plan, int thread, fft5d_time times)
                 FFTW(execute)(mpip[s]);
 #else
 #    if GMX_MPI
-                if ((s == 0 && !(plan->flags & FFT5D_ORDER_YZ))
-                    || (s == 1 && (plan->flags & FFT5D_ORDER_YZ)))
+                if (plan->flags & FFT5D_HALF_COMM)
+                {
+                    const int halfBlockBytes =
+                            (fft5d_transpose_block_size(plan, s) + c_halfBlockHeaderSize)
+                            * sizeof(uint16_t);
+                    MPI_Alltoall(plan->halfSendBuffer,
+                                 halfBlockBytes,
+                                 MPI_BYTE,
+                                 plan->halfRecvBuffer,
+                                 halfBlockBytes,
+                                 MPI_BYTE,
+                                 cart[s]);
+                }
+                else if ((s == 0 && !(plan->flags & FFT5D_ORDER_YZ))
+                         || (s == 1 && (plan->flags & FFT5D_ORDER_YZ)))
                 {
                     MPI_Alltoall(reinterpret_cast<real*>(lout2),
                                  N[s] * pM[s] * K[s] * sizeof(t_complex) / sizeof(real),
@@ -1329,6 +1712,11 @@ void fft5d_execute(fft5d_plan plan, int thread, fft5d_time times)
             }       /*master*/
         }           /* bPrallelDim */
 #pragma omp barrier /*both needed for parallel and non-parallel dimension (either have to wait on data from AlltoAll or from last FFT*/
+        if (bParallelDim && (plan->flags & FFT5D_HALF_COMM))
+        {
+            fft5d_unpack_half(plan, s, lout3, thread);
+#pragma omp barrier
+        }
 
         /* ---------- END SPLIT + TRANSPOSE------------ */
 
@@ -1463,6 +1851,21 @@ void fft5d_destroy(fft5d_plan plan)
 {
     int s, t;
 
+    for (s = 0; s < 2; s++)
+    {
+        if (plan->p1dChunk[s])
+        {
+            for (t = 0; t < plan->nthreads * c_numOverlapCommChunks; t++)
+            {
+                gmx_many_fft_destroy(plan->p1dChunk[s][t]);
+            }
+            free(plan->p1dChunk[s]);
+        }
+        free(plan->chunkLineStart[s]);
+        free(plan->chunkCounts[s]);
+        free(plan->chunkDispls[s]);
+    }
+
     for (s = 0; s < 3; s++)
     {
         if (plan->p1d[s])
@@ -1531,6 +1934,9 @@ void fft5d_destroy(fft5d_plan plan)
 #    endif
 #endif
 
+    sfree(plan->halfSendBuffer);
+    sfree(plan->halfRecvBuffer);
+
     free(plan);
 }
 
@@ -39,6 +39,8 @@
 
 #include "config.h"
 
+#include <cstdint>
+
 #ifdef NOGMX
 /*#define GMX_MPI*/
 /*#define GMX_FFT_FFTW3*/
@@ -83,13 +85,17 @@ enum class PinningPolicy : int;
 
 typedef enum fft5d_flags_t
 {
-    FFT5D_ORDER_YZ    = 1,
-    FFT5D_BACKWARD    = 2,
-    FFT5D_REALCOMPLEX = 4,
-    FFT5D_DEBUG       = 8,
-    FFT5D_NOMEASURE   = 16,
-    FFT5D_INPLACE     = 32,
-    FFT5D_NOMALLOC    = 64
+    FFT5D_ORDER_YZ     = 1,
+    FFT5D_BACKWARD     = 2,
+    FFT5D_REALCOMPLEX  = 4,
+    FFT5D_DEBUG        = 8,
+    FFT5D_NOMEASURE    = 16,
+    FFT5D_INPLACE      = 32,
+    FFT5D_NOMALLOC     = 64,
+    /* Store the data in FP16 for the MPI transposes, computation stays in FP32 */
+    FFT5D_HALF_COMM    = 128,
+    /* Overlap the MPI transposes with the 1D FFTs, only with library MPI */
+    FFT5D_OVERLAP_COMM = 256
 } fft5d_flags;
 
 struct fft5d_plan_t
@@ -123,6 +129,17 @@ struct fft5d_plan_t
     int                coor[2];
     int                nthreads;
     gmx::PinningPolicy pinningPolicy;
+    /* FP16 send and receive buffers for the transposes, only with FFT5D_HALF_COMM */
+    uint16_t* halfSendBuffer;
+    uint16_t* halfRecvBuffer;
+    /* With FFT5D_OVERLAP_COMM, for the first two FFT steps: 1D plans per thread and chunk,
+     * the start line of each chunk and the MPI counts and displacements per chunk.
+     * p1dChunk[s] is nullptr when step s is not overlapped.
+     */
+    gmx_fft_t* p1dChunk[2];
+    int*       chunkLineStart[2];
+    int*       chunkCounts[2];
+    int*       chunkDispls[2];
 };
 
 typedef struct fft5d_plan_t* fft5d_plan;
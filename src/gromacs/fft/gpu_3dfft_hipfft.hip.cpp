@@ -45,8 +45,18 @@
 
 #include "gpu_3dfft_hipfft.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include "gromacs/gpu_utils/device_context.h"
 #include "gromacs/gpu_utils/device_stream.h"
 #include "gromacs/gpu_utils/devicebuffer.h"
+#include "gromacs/hardware/device_information.h"
 #include "gromacs/utility/arrayref.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxassert.h"
@@ -61,6 +71,184 @@ static void handleHipfftError(hipfftResult_t status, const char* msg)
     }
 }
 
+#ifndef GMX_GPU_USE_VKFFT
+//! The parameters that fully define a hipFFT plan for a single PME grid transform
+struct HipfftPlanKey
+{
+    std::array<int, DIM> realGridSize;
+    std::array<int, DIM> realGridSizePadded;
+    std::array<int, DIM> complexGridSizePadded;
+    int                  deviceId;
+    hipfftType           type;
+
+    bool operator<(const HipfftPlanKey& other) const
+    {
+        return std::tie(realGridSize, realGridSizePadded, complexGridSizePadded, deviceId, type)
+               < std::tie(other.realGridSize,
+                          other.realGridSizePadded,
+                          other.complexGridSizePadded,
+                          other.deviceId,
+                          other.type);
+    }
+};
+
+/*! \internal \brief
+ * A hipFFT plan bound to a stream, destroyed together with its last user
+ *
+ * The plan keeps its stream alive, so evicting the plan from the cache or
+ * destroying the cache does not invalidate plans that are still in use.
+ */
+class HipfftPlan
+{
+public:
+    HipfftPlan(const HipfftPlanKey& key, std::shared_ptr<const DeviceStream> stream) :
+        stream_(std::move(stream))
+    {
+        // hipfftPlanMany takes non-const pointers
+        auto realGridSize          = key.realGridSize;
+        auto realGridSizePadded    = key.realGridSizePadded;
+        auto complexGridSizePadded = key.complexGridSizePadded;
+        const int realGridSizePaddedTotal =
+                realGridSizePadded[XX] * realGridSizePadded[YY] * realGridSizePadded[ZZ];
+        const int complexGridSizePaddedTotal =
+                complexGridSizePadded[XX] * complexGridSizePadded[YY] * complexGridSizePadded[ZZ];
+        const bool isR2C = (key.type == HIPFFT_R2C);
+
+        const int      rank = 3, batch = 1;
+        hipfftResult_t result =
+                hipfftPlanMany(&handle_,
+                               rank,
+                               realGridSize.data(),
+                               isR2C ? realGridSizePadded.data() : complexGridSizePadded.data(),
+                               1,
+                               isR2C ? realGridSizePaddedTotal : complexGridSizePaddedTotal,
+                               isR2C ? complexGridSizePadded.data() : realGridSizePadded.data(),
+                               1,
+                               isR2C ? complexGridSizePaddedTotal : realGridSizePaddedTotal,
+                               key.type,
+                               batch);
+        handleHipfftError(result,
+                          isR2C ? "hipfftPlanMany R2C plan failure"
+                                : "hipfftPlanMany C2R plan failure");
+
+        result = hipfftSetStream(handle_, stream_->stream());
+        handleHipfftError(result,
+                          isR2C ? "hipfftSetStream R2C failure" : "hipfftSetStream C2R failure");
+    }
+
+    ~HipfftPlan()
+    {
+        hipfftResult_t result = hipfftDestroy(handle_);
+        handleHipfftError(result, "hipfftDestroy failure");
+    }
+
+    HipfftPlan(const HipfftPlan&) = delete;
+    HipfftPlan& operator=(const HipfftPlan&) = delete;
+
+    //! Returns the hipFFT handle
+    hipfftHandle handle() const { return handle_; }
+    //! Returns the stream the plan runs in
+    const DeviceStream& stream() const { return *stream_; }
+
+private:
+    hipfftHandle                        handle_;
+    std::shared_ptr<const DeviceStream> stream_;
+};
+
+namespace
+{
+
+/*! \internal \brief
+ * Process-wide cache of hipFFT plans
+ *
+ * Creating rocFFT plans can take seconds, and PME tuning re-creates the 3D FFT
+ * setup for every grid it tries, often revisiting the same grid sizes. Plans do
+ * not bind the data buffers, so a plan can be reused by any transform with the
+ * same dimensions and layout on the same device.
+ *
+ * The plans run in a stream per device that is owned by the cache, so a plan never
+ * refers to a stream that has been destroyed. Its users order the transforms with
+ * their own streams. Uses of the same plan are serialized by the stream, as they
+ * share the work area of the plan.
+ *
+ * At most \c c_maxNumPlans plans are kept, the least recently requested plans
+ * are evicted first. Evicted plans are destroyed when their last user is done.
+ */
+class HipfftPlanCache
+{
+public:
+    //! Destroys all plans not in use and the streams they run in
+    ~HipfftPlanCache()
+    {
+        plans_.clear();
+        streams_.clear();
+    }
+
+    //! Returns a plan for \p key, creating it on first use
+    std::shared_ptr<const HipfftPlan> get(const HipfftPlanKey& key, const DeviceContext& context)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        useCounter_++;
+        auto found = plans_.find(key);
+        if (found != plans_.end())
+        {
+            found->second.lastUse = useCounter_;
+            return found->second.plan;
+        }
+
+        auto& stream = streams_[key.deviceId];
+        if (!stream)
+        {
+            stream = std::make_shared<const DeviceStream>(
+                    context, DeviceStreamPriority::High, false);
+        }
+
+        if (plans_.size() == c_maxNumPlans)
+        {
+            auto leastRecentlyUsed = std::min_element(
+                    plans_.begin(), plans_.end(), [](const auto& a, const auto& b) {
+                        return a.second.lastUse < b.second.lastUse;
+                    });
+            plans_.erase(leastRecentlyUsed);
+        }
+
+        auto plan = std::make_shared<const HipfftPlan>(key, stream);
+        plans_.emplace(key, CachedPlan{ plan, useCounter_ });
+        return plan;
+    }
+
+private:
+    //! The maximum number of cached plans, an R2C and a C2R plan for 8 grids
+    static constexpr size_t c_maxNumPlans = 16;
+
+    //! A cached plan with the time it was last requested
+    struct CachedPlan
+    {
+        std::shared_ptr<const HipfftPlan> plan;
+        uint64_t                          lastUse;
+    };
+
+    std::mutex                                          mutex_;
+    std::map<int, std::shared_ptr<const DeviceStream>> streams_;
+    std::map<HipfftPlanKey, CachedPlan>                 plans_;
+    uint64_t                                            useCounter_ = 0;
+};
+
+/*! \brief Returns the process-wide plan cache
+ *
+ * The cache is constructed on first use, after the HIP runtime has been initialized,
+ * so it is destructed before the runtime at process exit.
+ */
+HipfftPlanCache& hipfftPlanCache()
+{
+    static HipfftPlanCache cache;
+    return cache;
+}
+
+} // namespace
+#endif
+
 Gpu3dFft::ImplHipFft::ImplHipFft(bool allocateGrids,
                                  MPI_Comm /*comm*/,
                                  ArrayRef<const int> gridSizesInXForEachRank,
@@ -74,7 +262,12 @@ Gpu3dFft::ImplHipFft::ImplHipFft(bool allocateGrids,
                                  ivec                 complexGridSizePadded,
                                  DeviceBuffer<float>* realGrid,
                                  DeviceBuffer<float>* complexGrid) :
-    realGrid_(reinterpret_cast<hipfftReal*>(*realGrid)), performOutOfPlaceFFT_(performOutOfPlaceFFT)
+    realGrid_(reinterpret_cast<hipfftReal*>(*realGrid)),
+    performOutOfPlaceFFT_(performOutOfPlaceFFT)
+#ifndef GMX_GPU_USE_VKFFT
+    ,
+    pmeStream_(pmeStream)
+#endif
 {
     GMX_RELEASE_ASSERT(allocateGrids == false, "Grids needs to be pre-allocated");
     GMX_RELEASE_ASSERT(gridSizesInXForEachRank.size() == 1 && gridSizesInYForEachRank.size() == 1,
@@ -95,12 +288,6 @@ Gpu3dFft::ImplHipFft::ImplHipFft(bool allocateGrids,
 
     complexGrid_ = *complexGrid;
 
-
-    const int complexGridSizePaddedTotal =
-            complexGridSizePadded[XX] * complexGridSizePadded[YY] * complexGridSizePadded[ZZ];
-    const int realGridSizePaddedTotal =
-            realGridSizePadded[XX] * realGridSizePadded[YY] * realGridSizePadded[ZZ];
-
     GMX_RELEASE_ASSERT(realGrid_, "Bad (null) input real-space grid");
     GMX_RELEASE_ASSERT(complexGrid_, "Bad (null) input complex grid");
 
@@ -128,63 +315,37 @@ Gpu3dFft::ImplHipFft::ImplHipFft(bool allocateGrids,
     configuration.bufferStride[2] = complexGridSizePadded[ZZ]* complexGridSizePadded[YY]* complexGridSizePadded[XX];
     configuration.buffer = (void**)&complexGrid_;
 
-    configuration.isInputFormatted = 1;
-    configuration.inverseReturnToInputBuffer = 1;
+    // In-place transforms use the padded real layout of the single buffer directly
     uint64_t inputBufferSize = realGridSizePadded[XX]* realGridSizePadded[YY]* realGridSizePadded[ZZ] * sizeof(hipfftReal);
-    configuration.inputBufferSize = &inputBufferSize;
-    configuration.inputBufferStride[0] = realGridSizePadded[ZZ];
-    configuration.inputBufferStride[1] = realGridSizePadded[ZZ]* realGridSizePadded[YY];
-    configuration.inputBufferStride[2] = realGridSizePadded[ZZ]* realGridSizePadded[YY]* realGridSizePadded[XX];
-    configuration.inputBuffer = (void**)&realGrid_;
+    if (performOutOfPlaceFFT_)
+    {
+        configuration.isInputFormatted = 1;
+        configuration.inverseReturnToInputBuffer = 1;
+        configuration.inputBufferSize = &inputBufferSize;
+        configuration.inputBufferStride[0] = realGridSizePadded[ZZ];
+        configuration.inputBufferStride[1] = realGridSizePadded[ZZ]* realGridSizePadded[YY];
+        configuration.inputBufferStride[2] = realGridSizePadded[ZZ]* realGridSizePadded[YY]* realGridSizePadded[XX];
+        configuration.inputBuffer = (void**)&realGrid_;
+    }
     VkFFTResult resFFT = initializeVkFFT(&appR2C, configuration);
     if (resFFT!=VKFFT_SUCCESS) printf ("VkFFT error: %d\n", resFFT);
 #else
 
-    hipfftResult_t result;
-    /* Commented code for a simple 3D grid with no padding */
-    /*
-       result = hipfftPlan3d(&planR2C_, realGridSize[XX], realGridSize[YY], realGridSize[ZZ],
-       HIPFFT_R2C); handleHipfftError(result, "hipfftPlan3d R2C plan failure");
-
-       result = hipfftPlan3d(&planC2R_, realGridSize[XX], realGridSize[YY], realGridSize[ZZ],
-       HIPFFT_C2R); handleHipfftError(result, "hipfftPlan3d C2R plan failure");
-     */
-
-    const int rank = 3, batch = 1;
-    result = hipfftPlanMany(&planR2C_,
-                           rank,
-                           realGridSize,
-                           realGridSizePadded,
-                           1,
-                           realGridSizePaddedTotal,
-                           complexGridSizePadded,
-                           1,
-                           complexGridSizePaddedTotal,
-                           HIPFFT_R2C,
-                           batch);
-    handleHipfftError(result, "hipfftPlanMany R2C plan failure");
-
-    result = hipfftPlanMany(&planC2R_,
-                           rank,
-                           realGridSize,
-                           complexGridSizePadded,
-                           1,
-                           complexGridSizePaddedTotal,
-                           realGridSizePadded,
-                           1,
-                           realGridSizePaddedTotal,
-                           HIPFFT_C2R,
-                           batch);
-    handleHipfftError(result, "hipfftPlanMany C2R plan failure");
-
-    hipStream_t stream = pmeStream.stream();
-    GMX_RELEASE_ASSERT(stream, "Can not use the default HIP stream for PME cuFFT");
-
-    result = hipfftSetStream(planR2C_, stream);
-    handleHipfftError(result, "hipfftSetStream R2C failure");
-
-    result = hipfftSetStream(planC2R_, stream);
-    handleHipfftError(result, "hipfftSetStream C2R failure");
+    GMX_RELEASE_ASSERT(pmeStream.stream(), "Can not use the default HIP stream for PME cuFFT");
+
+    HipfftPlanKey key;
+    for (int d = 0; d < DIM; d++)
+    {
+        key.realGridSize[d]          = realGridSize[d];
+        key.realGridSizePadded[d]    = realGridSizePadded[d];
+        key.complexGridSizePadded[d] = complexGridSizePadded[d];
+    }
+    key.deviceId = context.deviceInfo().id;
+
+    key.type = HIPFFT_R2C;
+    planR2C_ = hipfftPlanCache().get(key, context);
+    key.type = HIPFFT_C2R;
+    planC2R_ = hipfftPlanCache().get(key, context);
 #endif
 }
 
@@ -198,12 +359,7 @@ Gpu3dFft::ImplHipFft::~ImplHipFft()
     {
         freeDeviceBuffer(&complexGrid_);
     }
-
-    hipfftResult_t result;
-    result = hipfftDestroy(planR2C_);
-    handleHipfftError(result, "hipfftDestroy R2C failure");
-    result = hipfftDestroy(planC2R_);
-    handleHipfftError(result, "hipfftDestroy C2R failure");
+    // The plans are shared with the plan cache
 #endif
 }
 
@@ -213,6 +369,11 @@ void Gpu3dFft::ImplHipFft::perform3dFft(gmx_fft_direction dir, CommandEvent* /*t
     VkFFTResult resFFT = VKFFT_SUCCESS;
 #else
     hipfftResult_t result;
+#endif
+#ifndef GMX_GPU_USE_VKFFT
+    const HipfftPlan& plan = (dir == GMX_FFT_REAL_TO_COMPLEX) ? *planR2C_ : *planC2R_;
+    fftInputReady_.markEvent(pmeStream_);
+    fftInputReady_.enqueueWaitEvent(plan.stream());
 #endif
     if (dir == GMX_FFT_REAL_TO_COMPLEX)
     {
@@ -220,7 +381,7 @@ void Gpu3dFft::ImplHipFft::perform3dFft(gmx_fft_direction dir, CommandEvent* /*t
         resFFT = VkFFTAppend(&appR2C, -1, NULL);
         if (resFFT!=VKFFT_SUCCESS) printf ("VkFFT error: %d\n", resFFT);
 #else
-        result = hipfftExecR2C(planR2C_, realGrid_, (hipfftComplex*)complexGrid_);
+        result = hipfftExecR2C(plan.handle(), realGrid_, (hipfftComplex*)complexGrid_);
         handleHipfftError(result, "hipFFT R2C execution failure");
 #endif
     }
@@ -230,10 +391,14 @@ void Gpu3dFft::ImplHipFft::perform3dFft(gmx_fft_direction dir, CommandEvent* /*t
         resFFT = VkFFTAppend(&appR2C, 1, NULL);
         if (resFFT!=VKFFT_SUCCESS) printf ("VkFFT error: %d\n", resFFT);
 #else
-        result = hipfftExecC2R(planC2R_, (hipfftComplex*)complexGrid_, realGrid_);
+        result = hipfftExecC2R(plan.handle(), (hipfftComplex*)complexGrid_, realGrid_);
         handleHipfftError(result, "hipFFT C2R execution failure");
 #endif
     }
+#ifndef GMX_GPU_USE_VKFFT
+    fftOutputReady_.markEvent(plan.stream());
+    fftOutputReady_.enqueueWaitEvent(pmeStream_);
+#endif
 }
 
 } // namespace gmx
@@ -49,6 +49,7 @@
 
 #include "gromacs/fft/fft.h"
 #include "gromacs/gpu_utils/devicebuffer_datatype.h"
+#include "gromacs/gpu_utils/gpueventsynchronizer.h"
 #include "gromacs/gpu_utils/gputraits.h"
 #include "gromacs/utility/gmxmpi.h"
 #include "gpu_3dfft_impl.h"
@@ -66,6 +67,8 @@ class DeviceStream;
 namespace gmx
 {
 
+class HipfftPlan;
+
 /*! \internal \brief
  * A 3D FFT wrapper class for performing R2C/C2R transforms using cuFFT
  */
@@ -94,8 +97,6 @@ public:
     void perform3dFft(gmx_fft_direction dir, CommandEvent* timingEvent) override;
 
 private:
-    hipfftHandle   planR2C_;
-    hipfftHandle   planC2R_;
     hipfftReal*    realGrid_;
     //hipfftComplex* complexGrid_;
 #ifdef GMX_GPU_USE_VKFFT
@@ -103,13 +104,24 @@ private:
     VkFFTApplication appR2C;
 #endif
     DeviceBuffer<float> complexGrid_;
-    /*! \brief A boolean which tells whether the complex and real grids are different or same. Currenty true. */
+    /*! \brief A boolean which tells whether the complex and real grids are different or same. */
     bool performOutOfPlaceFFT_ = false;
     /*! \brief complexGrid float (not float2!) element count (actual) */
     int complexGridSize_ = 0;
     /*! \brief complexGrid float (not float2!) element count (reserved) */
     int complexGridCapacity_ = 0;
-
+#ifndef GMX_GPU_USE_VKFFT
+    //! R2C plan, shared with the process-wide plan cache
+    std::shared_ptr<const HipfftPlan> planR2C_;
+    //! C2R plan, shared with the process-wide plan cache
+    std::shared_ptr<const HipfftPlan> planC2R_;
+    //! The PME stream, the FFTs run in the stream of the plans
+    const DeviceStream& pmeStream_;
+    //! Orders the FFTs after the preceding PME work
+    GpuEventSynchronizer fftInputReady_;
+    //! Orders the following PME work after the FFTs
+    GpuEventSynchronizer fftOutputReady_;
+#endif
 };
 
 } // namespace gmx
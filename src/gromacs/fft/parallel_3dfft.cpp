@@ -73,6 +73,15 @@ int gmx_parallel_3dfft_init(gmx_parallel_3dfft_t* pfft_setup,
     {
         flags |= FFT5D_NOMEASURE;
     }
+    if (getenv("GMX_PME_FFT_HALF_COMM") != nullptr)
+    {
+        /* Halve the transpose volume, gmx pme_error estimates the resulting error */
+        flags |= FFT5D_HALF_COMM;
+    }
+    if (getenv("GMX_PME_FFT_OVERLAP_COMM") != nullptr)
+    {
+        flags |= FFT5D_OVERLAP_COMM;
+    }
 
     if (!(flags & FFT5D_ORDER_YZ))
     {
@@ -0,0 +1,148 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2024, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests that overlapping the fft5d transposes with the 1D FFTs does not change the result.
+ *
+ * \ingroup module_fft
+ */
+#include "gmxpre.h"
+
+#include "gromacs/fft/fft5d.h"
+
+#include <cmath>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/math/vectypes.h"
+#include "gromacs/utility/basenetwork.h"
+#include "gromacs/utility/gmxmpi.h"
+#include "gromacs/utility/gmxomp.h"
+#include "gromacs/utility/real.h"
+
+#include "testutils/mpitest.h"
+#include "testutils/testasserts.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+//! Parameters: grid size, number of ranks along the first decomposition dimension, thread count
+using Fft5dOverlapTestParams = std::tuple<IVec, int, int>;
+
+/*! \brief Runs the forward real-to-complex and the backward complex-to-real transforms
+ * of the grid with \p flags and returns the local output of both.
+ */
+std::vector<t_complex> runFft5d(const IVec& gridSize, MPI_Comm comm[2], int flags, int numThreads)
+{
+    std::vector<t_complex> output;
+    for (const int directionFlags : { FFT5D_REALCOMPLEX | FFT5D_ORDER_YZ,
+                                      FFT5D_REALCOMPLEX | FFT5D_BACKWARD })
+    {
+        t_complex *lin, *lout, *lout2, *lout3;
+        fft5d_plan plan = fft5d_plan_3d(gridSize[XX],
+                                        gridSize[YY],
+                                        gridSize[ZZ],
+                                        comm,
+                                        flags | directionFlags | FFT5D_NOMEASURE,
+                                        &lin,
+                                        &lout,
+                                        &lout2,
+                                        &lout3,
+                                        numThreads);
+
+        // Fill the input with values that only depend on the local index and the rank
+        const int inputSize = plan->C[0] * plan->pM[0] * plan->pK[0];
+        for (int i = 0; i < inputSize; i++)
+        {
+            lin[i].re = std::sin(0.1 * i + gmx_node_rank());
+            lin[i].im = std::cos(0.3 * i - gmx_node_rank());
+        }
+
+#pragma omp parallel num_threads(numThreads)
+        fft5d_execute(plan, gmx_omp_get_thread_num(), nullptr);
+
+        const int outputSize = plan->C[2] * plan->pM[2] * plan->pK[2];
+        output.insert(output.end(), lout, lout + outputSize);
+        fft5d_destroy(plan);
+    }
+    return output;
+}
+
+class Fft5dOverlapTest : public ::testing::TestWithParam<Fft5dOverlapTestParams>
+{
+};
+
+TEST_P(Fft5dOverlapTest, OverlappedTransposesGiveTheSameResult)
+{
+    GMX_MPI_TEST(RequireRankCount<4>);
+    const auto [gridSize, numRanksFirstDim, numThreads] = GetParam();
+
+    const int rank = gmx_node_rank();
+    MPI_Comm  comm[2];
+    MPI_Comm_split(MPI_COMM_WORLD, rank % (4 / numRanksFirstDim), rank, &comm[0]);
+    MPI_Comm_split(MPI_COMM_WORLD, rank / (4 / numRanksFirstDim), rank, &comm[1]);
+
+    const std::vector<t_complex> reference = runFft5d(gridSize, comm, 0, numThreads);
+    const std::vector<t_complex> overlapped =
+            runFft5d(gridSize, comm, FFT5D_OVERLAP_COMM, numThreads);
+
+    ASSERT_EQ(reference.size(), overlapped.size());
+    for (size_t i = 0; i < reference.size(); i++)
+    {
+        EXPECT_REAL_EQ_TOL(reference[i].re, overlapped[i].re, defaultRealTolerance());
+        EXPECT_REAL_EQ_TOL(reference[i].im, overlapped[i].im, defaultRealTolerance());
+    }
+
+    MPI_Comm_free(&comm[0]);
+    MPI_Comm_free(&comm[1]);
+}
+
+INSTANTIATE_TEST_SUITE_P(Decompositions,
+                         Fft5dOverlapTest,
+                         ::testing::Combine(::testing::Values(IVec{ 20, 24, 28 },
+                                                              IVec{ 13, 17, 9 },
+                                                              IVec{ 7, 9, 5 }),
+                                            ::testing::Values(4, 2, 1),
+                                            ::testing::Values(2, 3)));
+
+} // namespace
+} // namespace test
+} // namespace gmx
@@ -41,12 +41,16 @@
 
 #include "checkpoint.h"
 
+#include "config.h"
+
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
 
+#include <algorithm>
 #include <array>
 #include <memory>
+#include <vector>
 
 #include "buildinfo.h"
 #include "gromacs/fileio/filetypes.h"
@@ -616,6 +620,65 @@ static inline xdrproc_t xdrProc(XdrDataType xdrType)
     return nullptr;
 }
 
+/*! \brief Reverses the byte order of \p numElements elements of \p elementSize bytes */
+static void swapElementBytes(char* data, int numElements, unsigned int elementSize)
+{
+    for (int i = 0; i < numElements; i++)
+    {
+        std::reverse(data + i * elementSize, data + (i + 1) * elementSize);
+    }
+}
+
+/*! \brief Reads or writes a vector of XDR elements of 4 or 8 bytes
+ *
+ * Produces exactly the same data as xdr_vector() with xdr_int, xdr_float or
+ * xdr_double, since XDR stores these as big-endian 4 or 8 byte values.
+ * Calling xdr_vector() costs a function call and a stdio call per element.
+ * Instead we convert the byte order in chunks and pass each chunk with
+ * one xdr_opaque() call, which matters for checkpoints of large systems.
+ * Chunking avoids a full copy of the vector when writing.
+ */
+static bool_t doXdrVectorData(XDR* xd, char* data, int numElements, unsigned int elementSize)
+{
+    GMX_RELEASE_ASSERT(elementSize == 4 || elementSize == 8,
+                       "Only elements of 4 or 8 bytes can be transferred in bulk");
+
+    constexpr int     c_chunkSize = 1 << 16;
+    std::vector<char> chunk;
+    for (int start = 0; start < numElements; start += c_chunkSize)
+    {
+        const int          numInChunk = std::min(c_chunkSize, numElements - start);
+        char*              chunkData  = data + static_cast<std::size_t>(start) * elementSize;
+        const unsigned int numBytes   = numInChunk * elementSize;
+        if (xd->x_op == XDR_ENCODE)
+        {
+            /* Convert a copy, the data itself should not be modified */
+            chunk.assign(chunkData, chunkData + numBytes);
+            if (!GMX_INTEGER_BIG_ENDIAN)
+            {
+                swapElementBytes(chunk.data(), numInChunk, elementSize);
+            }
+            if (xdr_opaque(xd, chunk.data(), numBytes) == 0)
+            {
+                return 0;
+            }
+        }
+        else
+        {
+            if (xdr_opaque(xd, chunkData, numBytes) == 0)
+            {
+                return 0;
+            }
+            if (!GMX_INTEGER_BIG_ENDIAN)
+            {
+                swapElementBytes(chunkData, numInChunk, elementSize);
+            }
+        }
+    }
+
+    return 1;
+}
+
 /*! \brief Lists or only reads an xdr vector from checkpoint file
  *
  * When list!=NULL reads and lists the \p nf vector elements of type \p xdrType.
@@ -842,8 +905,7 @@ static int doVectorLow(XDR*                           xd,
         {
             snew(vChar, numElemInTheFile * sizeOfXdrType(xdrTypeInTheFile));
         }
-        res = xdr_vector(
-                xd, vChar, numElemInTheFile, sizeOfXdrType(xdrTypeInTheFile), xdrProc(xdrTypeInTheFile));
+        res = doXdrVectorData(xd, vChar, numElemInTheFile, sizeOfXdrType(xdrTypeInTheFile));
         if (res == 0)
         {
             return -1;
@@ -60,6 +60,12 @@ class t_state;
  * The file pointer returned from open_enx
  * can also be used with the routines in gmxfio.h
  *
+ * Each frame stores all energy terms interleaved (value, and average
+ * and sum when nsum > 0), followed by blocks whose string sub-blocks
+ * have variable length. Thus a reader can only get at a single term
+ * by decoding the whole frame; direct per-term access would need a
+ * new, chunked file layout.
+ *
  **************************************************************/
 
 typedef struct
@@ -68,6 +68,7 @@ struct t_fileio
     XDR*        xdr;     /* the xdr data pointer */
     enum xdr_op xdrmode; /* the xdr mode */
     int         iFTP;    /* the file type identifier */
+    char*       stdioBuffer; /* the stdio buffer for read-only XDR and checkpoint files */
 
     t_fileio *next, *prev; /* next and previous file pointers in the
                               linked list */
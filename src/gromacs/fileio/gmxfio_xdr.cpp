@@ -874,6 +874,26 @@ void FileIOXdrSerializer::doUCharArray(unsigned char* values, int elements)
     gmx_fio_ndo_uchar(fio_, values, elements);
 }
 
+void FileIOXdrSerializer::doIntArray(int* values, int elements)
+{
+    gmx_fio_ndo_int(fio_, values, elements);
+}
+
+void FileIOXdrSerializer::doInt64Array(int64_t* values, int elements)
+{
+    gmx_fio_ndo_int64(fio_, values, elements);
+}
+
+void FileIOXdrSerializer::doFloatArray(float* values, int elements)
+{
+    gmx_fio_ndo_float(fio_, values, elements);
+}
+
+void FileIOXdrSerializer::doDoubleArray(double* values, int elements)
+{
+    gmx_fio_ndo_double(fio_, values, elements);
+}
+
 void FileIOXdrSerializer::doRvecArray(rvec* values, int elements)
 {
     gmx_fio_ndo_rvec(fio_, values, elements);
@@ -205,6 +205,14 @@ public:
     void doCharArray(char* values, int elements) override;
     //! Special case for handling I/O of a vector of unsigned characters.
     void doUCharArray(unsigned char* values, int elements) override;
+    //! Special case for handling I/O of a vector of integers.
+    void doIntArray(int* values, int elements) override;
+    //! Special case for handling I/O of a vector of 64-bit integers.
+    void doInt64Array(int64_t* values, int elements) override;
+    //! Special case for handling I/O of a vector of floats.
+    void doFloatArray(float* values, int elements) override;
+    //! Special case for handling I/O of a vector of doubles.
+    void doDoubleArray(double* values, int elements) override;
     //! Special case for handling I/O of a vector of rvecs.
     void doRvecArray(rvec* values, int elements) override;
 
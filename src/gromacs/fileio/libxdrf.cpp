@@ -492,87 +492,45 @@ int xdr3dfcoord(XDR* xdrs, float* fp, int* size, float* precision)
         minint[0] = minint[1] = minint[2] = INT_MAX;
         maxint[0] = maxint[1] = maxint[2] = INT_MIN;
         prevrun                           = -1;
-        lfp                               = fp;
-        lip                               = ip;
         mindiff                           = INT_MAX;
+
+        /* Convert all floats to the nearest integer. This is done in a separate
+         * pass with the precision in a local variable, so the compiler can
+         * vectorize the loop; note that the rounding offset is added in double
+         * precision, as it always has been.
+         */
+        const float precisionLocal = *precision;
+        bool        haveOverflow   = false;
+        for (unsigned int j = 0; j < size3; j++)
+        {
+            const float scaled = fp[j] * precisionLocal;
+            lf = (fp[j] >= 0.0) ? static_cast<float>(scaled + 0.5) : static_cast<float>(scaled - 0.5);
+            /* scaling would cause overflow */
+            haveOverflow = haveOverflow || (std::fabs(lf) > maxAbsoluteInt);
+            ip[j]        = static_cast<int>(lf);
+        }
+        if (haveOverflow)
+        {
+            errval = 0;
+        }
+
+        /* Determine the integer range and the smallest difference between
+         * successive coordinates
+         */
         oldlint1 = oldlint2 = oldlint3 = 0;
-        while (lfp < fp + size3)
+        for (lip = ip; lip < ip + size3; lip += 3)
         {
-            /* find nearest integer */
-            if (*lfp >= 0.0)
-            {
-                lf = *lfp * *precision + 0.5;
-            }
-            else
-            {
-                lf = *lfp * *precision - 0.5;
-            }
-            if (std::fabs(lf) > maxAbsoluteInt)
-            {
-                /* scaling would cause overflow */
-                errval = 0;
-            }
-            lint1 = static_cast<int>(lf);
-            if (lint1 < minint[0])
-            {
-                minint[0] = lint1;
-            }
-            if (lint1 > maxint[0])
-            {
-                maxint[0] = lint1;
-            }
-            *lip++ = lint1;
-            lfp++;
-            if (*lfp >= 0.0)
-            {
-                lf = *lfp * *precision + 0.5;
-            }
-            else
-            {
-                lf = *lfp * *precision - 0.5;
-            }
-            if (std::fabs(lf) > maxAbsoluteInt)
-            {
-                /* scaling would cause overflow */
-                errval = 0;
-            }
-            lint2 = static_cast<int>(lf);
-            if (lint2 < minint[1])
-            {
-                minint[1] = lint2;
-            }
-            if (lint2 > maxint[1])
-            {
-                maxint[1] = lint2;
-            }
-            *lip++ = lint2;
-            lfp++;
-            if (*lfp >= 0.0)
-            {
-                lf = *lfp * *precision + 0.5;
-            }
-            else
-            {
-                lf = *lfp * *precision - 0.5;
-            }
-            if (std::abs(lf) > maxAbsoluteInt)
-            {
-                /* scaling would cause overflow */
-                errval = 0;
-            }
-            lint3 = static_cast<int>(lf);
-            if (lint3 < minint[2])
-            {
-                minint[2] = lint3;
-            }
-            if (lint3 > maxint[2])
-            {
-                maxint[2] = lint3;
-            }
-            *lip++ = lint3;
-            lfp++;
+            lint1     = lip[0];
+            lint2     = lip[1];
+            lint3     = lip[2];
+            minint[0] = std::min(minint[0], lint1);
+            minint[1] = std::min(minint[1], lint2);
+            minint[2] = std::min(minint[2], lint3);
+            maxint[0] = std::max(maxint[0], lint1);
+            maxint[1] = std::max(maxint[1], lint2);
+            maxint[2] = std::max(maxint[2], lint3);
             diff = std::abs(oldlint1 - lint1) + std::abs(oldlint2 - lint2) + std::abs(oldlint3 - lint3);
-            if (diff < mindiff && lfp > fp + 3)
+            if (diff < mindiff && lip > ip)
             {
                 mindiff = diff;
             }
@@ -3245,9 +3245,11 @@ static void doTpxBodyBuffer(gmx::ISerializer* serializer, gmx::ArrayRef<char> bu
  * The second version is the default for the legacy tools that read the
  * coordinates and velocities separate from the state.
  *
- * After reading in the data, a separate buffer is populated from them
- * containing only \p ir and \p mtop that can be communicated directly
- * to nodes needing the information to set up a simulation.
+ * After reading in the data, when \p prepareBroadcastBody is true, a
+ * separate buffer is populated from them containing only \p ir and \p mtop
+ * that can be communicated directly to nodes needing the information to set
+ * up a simulation. Otherwise the body read from file is released and the
+ * returned struct only holds the header and the PBC type.
  *
  * \param[in] tpx The file header.
  * \param[in] serializer The Serialization interface used to read the TPR.
@@ -3256,6 +3258,7 @@ static void doTpxBodyBuffer(gmx::ISerializer* serializer, gmx::ArrayRef<char> bu
  * \param[out] x Coordinates to populate if needed.
  * \param[out] v Velocities to populate if needed.
  * \param[out] mtop Global topology to populate.
+ * \param[in] prepareBroadcastBody Whether to serialize \p ir and \p mtop for communication.
  *
  * \returns Partial de-serialized TPR used for communication to nodes.
  */
@@ -3265,7 +3268,8 @@ static PartialDeserializedTprFile readTpxBody(TpxFileHeader*    tpx,
                                               t_state*          state,
                                               rvec*             x,
                                               rvec*             v,
-                                              gmx_mtop_t*       mtop)
+                                              gmx_mtop_t*       mtop,
+                                              bool              prepareBroadcastBody)
 {
     PartialDeserializedTprFile partialDeserializedTpr;
     if (tpx->fileVersion >= tpxv_AddSizeField && tpx->fileGeneration >= 27)
@@ -3281,6 +3285,14 @@ static PartialDeserializedTprFile readTpxBody(TpxFileHeader*    tpx,
     {
         partialDeserializedTpr.pbcType = do_tpx_body(serializer, tpx, ir, state, x, v, mtop);
     }
+    if (!prepareBroadcastBody)
+    {
+        // Serializing the whole topology again takes as long as reading
+        // it, so only do it when the caller distributes the result.
+        partialDeserializedTpr.header = *tpx;
+        std::vector<char>().swap(partialDeserializedTpr.body);
+        return partialDeserializedTpr;
+    }
     // Update header to system info for communication to nodes.
     // As we only need to communicate the inputrec and mtop to other nodes,
     // we prepare a new char buffer with the information we have already read
@@ -3386,12 +3398,25 @@ PartialDeserializedTprFile read_tpx_state(const char* fn, t_inputrec* ir, t_stat
     gmx::FileIOXdrSerializer   serializer(fio);
     PartialDeserializedTprFile partialDeserializedTpr;
     do_tpxheader(&serializer, &partialDeserializedTpr.header, fn, fio, ir == nullptr);
-    partialDeserializedTpr =
-            readTpxBody(&partialDeserializedTpr.header, &serializer, ir, state, nullptr, nullptr, mtop);
+    partialDeserializedTpr = readTpxBody(
+            &partialDeserializedTpr.header, &serializer, ir, state, nullptr, nullptr, mtop, true);
     close_tpx(fio);
     return partialDeserializedTpr;
 }
 
+PbcType read_tpx_state_no_broadcast(const char* fn, t_inputrec* ir, t_state* state, gmx_mtop_t* mtop)
+{
+    t_fileio* fio;
+    fio = open_tpx(fn, "r");
+    gmx::FileIOXdrSerializer serializer(fio);
+    TpxFileHeader            tpx;
+    do_tpxheader(&serializer, &tpx, fn, fio, ir == nullptr);
+    PartialDeserializedTprFile partialDeserializedTpr =
+            readTpxBody(&tpx, &serializer, ir, state, nullptr, nullptr, mtop, false);
+    close_tpx(fio);
+    return partialDeserializedTpr.pbcType;
+}
+
 PbcType read_tpx(const char* fn, t_inputrec* ir, matrix box, int* natoms, rvec* x, rvec* v, gmx_mtop_t* mtop)
 {
     t_fileio* fio;
@@ -3402,7 +3427,7 @@ PbcType read_tpx(const char* fn, t_inputrec* ir, matrix box, int* natoms, rvec*
     gmx::FileIOXdrSerializer serializer(fio);
     do_tpxheader(&serializer, &tpx, fn, fio, ir == nullptr);
     PartialDeserializedTprFile partialDeserializedTpr =
-            readTpxBody(&tpx, &serializer, ir, &state, x, v, mtop);
+            readTpxBody(&tpx, &serializer, ir, &state, x, v, mtop, false);
     close_tpx(fio);
     if (mtop != nullptr && natoms != nullptr)
     {
@@ -0,0 +1,325 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements gmx::TrajectoryWriterThread.
+ *
+ * \ingroup module_fileio
+ */
+#include "gmxpre.h"
+
+#include "trajectorywriterthread.h"
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gromacs/fileio/tngio.h"
+#include "gromacs/fileio/trxio.h"
+#include "gromacs/fileio/xtcio.h"
+#include "gromacs/math/vec.h"
+#include "gromacs/trajectory/trajectoryframe.h"
+#include "gromacs/utility/fatalerror.h"
+
+namespace gmx
+{
+
+//! Implementation of the asynchronous trajectory writer
+class TrajectoryWriterThread::Impl
+{
+public:
+    //! The number of frame buffers
+    static constexpr int c_numFrameBuffers = 2;
+
+    //! Constructor, starts the writer thread
+    Impl() : thread_(&Impl::run, this) {}
+
+    //! Writes all pending frames and stops the thread
+    ~Impl()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        condition_.notify_all();
+        thread_.join();
+    }
+
+    //! A trajectory frame to write to an XTC, TNG or trx file
+    struct Frame
+    {
+        //! The XTC file to write to, or nullptr
+        t_fileio* xtc;
+        //! The TNG trajectory to write to, or nullptr
+        gmx_tng_trajectory_t tng;
+        //! The trx file to write \p trxFrame to, or nullptr
+        t_trxstatus* trx;
+        //! The frame for write_trxframe(), its coordinate pointers are not used
+        t_trxframe trxFrame;
+        //! The XTC precision
+        int precision;
+        //! Whether to use lossy TNG compression
+        bool useLossyCompression;
+        //! The MD step
+        int64_t step;
+        //! The time
+        double t;
+        //! The lambda value, only used for TNG
+        real lambda;
+        //! Whether the frame has a box
+        bool haveBox;
+        //! The box
+        matrix box;
+        //! The number of atoms
+        int natoms;
+        //! Whether the frame has coordinates, velocities and forces
+        bool haveX, haveV, haveF;
+        //! The coordinates, velocities and forces
+        std::vector<RVec> x, v, f;
+    };
+
+    //! Copies \p natoms vectors from \p src, when present, to \p dest
+    static void copyVectors(std::vector<RVec>* dest, bool* haveVectors, int natoms, const rvec* src)
+    {
+        *haveVectors = (src != nullptr);
+        if (*haveVectors)
+        {
+            dest->assign(reinterpret_cast<const RVec*>(src), reinterpret_cast<const RVec*>(src) + natoms);
+        }
+    }
+
+    //! Returns a free frame buffer, waits when all buffers are in use
+    Frame& beginFrame()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this] { return numPending_ < c_numFrameBuffers; });
+        checkForWriteFailure();
+        /* The buffer is not pending, so the writer thread does not access it */
+        Frame& frame = frames_[(oldest_ + numPending_) % c_numFrameBuffers];
+        frame.xtc    = nullptr;
+        frame.tng    = nullptr;
+        frame.trx    = nullptr;
+        return frame;
+    }
+
+    //! Queues the frame returned by the last beginFrame() call for writing
+    void endFrame()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            numPending_++;
+        }
+        condition_.notify_all();
+    }
+
+    //! Waits until all queued frames have been written
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this] { return numPending_ == 0; });
+        checkForWriteFailure();
+    }
+
+private:
+    //! Issues a fatal error when writing a frame failed, should be called with the mutex locked
+    void checkForWriteFailure() const
+    {
+        if (writeFailed_)
+        {
+            gmx_fatal(FARGS,
+                      "XTC error. This indicates you are out of disk space, or a "
+                      "simulation with major instabilities resulting in coordinates "
+                      "that are NaN or too large to be represented in the XTC format.\n");
+        }
+    }
+
+    //! Writes a frame, returns whether this succeeded
+    static bool writeFrame(Frame& frame)
+    {
+        if (frame.xtc != nullptr)
+        {
+            return write_xtc(frame.xtc,
+                             frame.natoms,
+                             frame.step,
+                             frame.t,
+                             frame.box,
+                             as_rvec_array(frame.x.data()),
+                             frame.precision)
+                   != 0;
+        }
+        if (frame.trx != nullptr)
+        {
+            t_trxframe trxFrame = frame.trxFrame;
+            trxFrame.x          = frame.haveX ? as_rvec_array(frame.x.data()) : nullptr;
+            trxFrame.v          = frame.haveV ? as_rvec_array(frame.v.data()) : nullptr;
+            trxFrame.f          = frame.haveF ? as_rvec_array(frame.f.data()) : nullptr;
+            /* write_trxframe() issues a fatal error itself on failure */
+            write_trxframe(frame.trx, &trxFrame, nullptr);
+            return true;
+        }
+        /* The TNG writing issues a fatal error itself on failure */
+        gmx_fwrite_tng(frame.tng,
+                       frame.useLossyCompression,
+                       frame.step,
+                       frame.t,
+                       frame.lambda,
+                       frame.haveBox ? frame.box : nullptr,
+                       frame.natoms,
+                       frame.haveX ? as_rvec_array(frame.x.data()) : nullptr,
+                       frame.haveV ? as_rvec_array(frame.v.data()) : nullptr,
+                       frame.haveF ? as_rvec_array(frame.f.data()) : nullptr);
+        return true;
+    }
+
+    //! The thread function, writes frames in the order they were queued
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            condition_.wait(lock, [this] { return numPending_ > 0 || stop_; });
+            if (numPending_ == 0)
+            {
+                return;
+            }
+            Frame& frame = frames_[oldest_];
+            lock.unlock();
+
+            const bool writeOK = writeFrame(frame);
+
+            lock.lock();
+            writeFailed_ = writeFailed_ || !writeOK;
+            oldest_      = (oldest_ + 1) % c_numFrameBuffers;
+            numPending_--;
+            condition_.notify_all();
+        }
+    }
+
+    //! The frame buffers
+    std::array<Frame, c_numFrameBuffers> frames_;
+    //! The buffer index of the oldest pending frame
+    int oldest_ = 0;
+    //! The number of frames queued but not yet written
+    int numPending_ = 0;
+    //! Whether writing a frame has failed
+    bool writeFailed_ = false;
+    //! Tells the writer thread to stop after writing the pending frames
+    bool stop_ = false;
+    //! Protects the frame queue state
+    std::mutex mutex_;
+    //! Signals changes in the frame queue state
+    std::condition_variable condition_;
+    //! The writer thread, declared last so it starts after all other members are initialized
+    std::thread thread_;
+};
+
+TrajectoryWriterThread::TrajectoryWriterThread() : impl_(new Impl()) {}
+
+TrajectoryWriterThread::~TrajectoryWriterThread() = default;
+
+void TrajectoryWriterThread::writeXtc(t_fileio*    fio,
+                                      int          precision,
+                                      int64_t      step,
+                                      double       t,
+                                      const matrix box,
+                                      int          natoms,
+                                      const rvec*  x)
+{
+    Impl::Frame& frame = impl_->beginFrame();
+    frame.xtc          = fio;
+    frame.precision    = precision;
+    frame.step         = step;
+    frame.t            = t;
+    frame.haveBox      = true;
+    copy_mat(box, frame.box);
+    frame.natoms = natoms;
+    Impl::copyVectors(&frame.x, &frame.haveX, natoms, x);
+    Impl::copyVectors(&frame.v, &frame.haveV, natoms, nullptr);
+    Impl::copyVectors(&frame.f, &frame.haveF, natoms, nullptr);
+    impl_->endFrame();
+}
+
+void TrajectoryWriterThread::writeTng(gmx_tng_trajectory_t tng,
+                                      bool                 useLossyCompression,
+                                      int64_t              step,
+                                      double               t,
+                                      real                 lambda,
+                                      const rvec*          box,
+                                      int                  natoms,
+                                      const rvec*          x,
+                                      const rvec*          v,
+                                      const rvec*          f)
+{
+    Impl::Frame& frame        = impl_->beginFrame();
+    frame.tng                 = tng;
+    frame.useLossyCompression = useLossyCompression;
+    frame.step                = step;
+    frame.t                   = t;
+    frame.lambda              = lambda;
+    frame.haveBox             = (box != nullptr);
+    if (frame.haveBox)
+    {
+        copy_mat(box, frame.box);
+    }
+    frame.natoms = natoms;
+    Impl::copyVectors(&frame.x, &frame.haveX, natoms, x);
+    Impl::copyVectors(&frame.v, &frame.haveV, natoms, v);
+    Impl::copyVectors(&frame.f, &frame.haveF, natoms, f);
+    impl_->endFrame();
+}
+
+void TrajectoryWriterThread::writeTrxFrame(t_trxstatus* status, const t_trxframe& trxFrame)
+{
+    Impl::Frame& frame = impl_->beginFrame();
+    frame.trx          = status;
+    frame.trxFrame     = trxFrame;
+    frame.natoms       = trxFrame.natoms;
+    /* The atoms are not needed for XTC and TRR output and are not copied */
+    frame.trxFrame.bAtoms = FALSE;
+    frame.trxFrame.atoms  = nullptr;
+    Impl::copyVectors(&frame.x, &frame.haveX, trxFrame.natoms, trxFrame.bX ? trxFrame.x : nullptr);
+    Impl::copyVectors(&frame.v, &frame.haveV, trxFrame.natoms, trxFrame.bV ? trxFrame.v : nullptr);
+    Impl::copyVectors(&frame.f, &frame.haveF, trxFrame.natoms, trxFrame.bF ? trxFrame.f : nullptr);
+    impl_->endFrame();
+}
+
+void TrajectoryWriterThread::flush()
+{
+    impl_->flush();
+}
+
+} // namespace gmx
@@ -0,0 +1,116 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \libinternal \file
+ * \brief
+ * Declares gmx::TrajectoryWriterThread for asynchronous trajectory output.
+ *
+ * \inlibraryapi
+ * \ingroup module_fileio
+ */
+#ifndef GMX_FILEIO_TRAJECTORYWRITERTHREAD_H
+#define GMX_FILEIO_TRAJECTORYWRITERTHREAD_H
+
+#include <cstdint>
+
+#include <memory>
+
+#include "gromacs/math/vectypes.h"
+#include "gromacs/utility/real.h"
+
+struct t_fileio;
+struct t_trxframe;
+struct t_trxstatus;
+typedef struct gmx_tng_trajectory* gmx_tng_trajectory_t;
+
+namespace gmx
+{
+
+/*! \libinternal \brief Writes compressed trajectory frames on a separate thread
+ *
+ * The caller hands over a copy of the frame data and continues, while this
+ * thread does the compression and the write of the frame, including the
+ * frame-set compression in the TNG library. All writes to a file passed to
+ * this class should go through it, so each file is only accessed from one
+ * thread at a time; call flush() before accessing or closing the file
+ * otherwise. Two frame buffers are used; when both are in use, queueing a
+ * new frame waits until the oldest one has been written.
+ */
+class TrajectoryWriterThread
+{
+public:
+    //! Constructor, starts the writer thread
+    TrajectoryWriterThread();
+    //! Writes all pending frames and stops the thread
+    ~TrajectoryWriterThread();
+
+    //! Copies an XTC frame and queues it for writing to \p fio
+    void writeXtc(t_fileio*    fio,
+                  int          precision,
+                  int64_t      step,
+                  double       t,
+                  const matrix box,
+                  int          natoms,
+                  const rvec*  x);
+
+    //! Copies a TNG frame and queues it for writing to \p tng, arguments as gmx_fwrite_tng()
+    void writeTng(gmx_tng_trajectory_t tng,
+                  bool                 useLossyCompression,
+                  int64_t              step,
+                  double               t,
+                  real                 lambda,
+                  const rvec*          box,
+                  int                  natoms,
+                  const rvec*          x,
+                  const rvec*          v,
+                  const rvec*          f);
+
+    /*! \brief Copies \p trxFrame and queues it for writing with write_trxframe() to \p status
+     *
+     * Only for XTC and TRR output, the atoms in \p trxFrame are not copied.
+     */
+    void writeTrxFrame(t_trxstatus* status, const t_trxframe& trxFrame);
+
+    //! Waits until all queued frames have been written
+    void flush();
+
+private:
+    class Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace gmx
+
+#endif
@@ -365,6 +365,15 @@ gmx_bool gmx_trr_read_frame_data(t_fileio* fio, gmx_trr_header_t* header, rvec*
     return do_trr_frame_data(fio, header, box, x, v, f);
 }
 
+gmx_bool gmx_trr_skip_frame_data(t_fileio* fio, const gmx_trr_header_t* header)
+{
+    /* The sizes in the header are the number of bytes of each data block */
+    const gmx_off_t dataSize = static_cast<gmx_off_t>(header->box_size) + header->vir_size
+                               + header->pres_size + header->x_size + header->v_size + header->f_size;
+
+    return gmx_fio_seek(fio, gmx_fio_ftell(fio) + dataSize) == 0;
+}
+
 t_fileio* gmx_trr_open(const char* fn, const char* mode)
 {
     return gmx_fio_open(fn, mode);
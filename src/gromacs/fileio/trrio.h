@@ -111,6 +111,12 @@ gmx_bool gmx_trr_read_frame_data(struct t_fileio* fio, gmx_trr_header_t* sh, rve
  * Return FALSE on error
  */
 
+gmx_bool gmx_trr_skip_frame_data(struct t_fileio* fio, const gmx_trr_header_t* sh);
+/* Skip over the data of a frame whose header was pre-read, using
+ * routine gmx_trr_read_frame_header(), by seeking instead of reading.
+ * Return FALSE on error
+ */
+
 gmx_bool gmx_trr_read_frame(struct t_fileio* fio,
                             int64_t*         step,
                             real*            t,
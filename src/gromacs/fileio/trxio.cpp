@@ -674,6 +674,28 @@ t_trxstatus* open_trx(const char* outfile, const char* filemode)
     return stat;
 }
 
+/* Positions a TRR file at the first frame with time >= time.
+ * Only the frame headers are read, the frame data is skipped by seeking.
+ * When no such frame is found, the file is left after the last frame,
+ * so the next read reports the end of the file.
+ */
+static void trr_seek_time(t_trxstatus* status, real time)
+{
+    gmx_trr_header_t sh;
+    gmx_bool         bOK;
+
+    while (true)
+    {
+        const gmx_off_t frameStart = gmx_fio_ftell(status->fio);
+        if (!gmx_trr_read_frame_header(status->fio, &sh, &bOK) || sh.t >= time
+            || !gmx_trr_skip_frame_data(status->fio, &sh))
+        {
+            gmx_fio_seek(status->fio, frameStart);
+            return;
+        }
+    }
+}
+
 static gmx_bool gmx_next_frame(t_trxstatus* status, t_trxframe* fr)
 {
     gmx_trr_header_t sh;
@@ -840,7 +862,14 @@ bool read_next_frame(const gmx_output_env_t* oenv, t_trxstatus* status, t_trxfra
         }
         switch (ftp)
         {
-            case efTRR: bRet = gmx_next_frame(status, fr); break;
+            case efTRR:
+                if (bTimeSet(TimeControl::Begin) && (status->tf < rTimeValue(TimeControl::Begin)))
+                {
+                    trr_seek_time(status, rTimeValue(TimeControl::Begin));
+                    initcount(status);
+                }
+                bRet = gmx_next_frame(status, fr);
+                break;
             case efCPT:
                 /* Checkpoint files can not contain mulitple frames */
                 break;
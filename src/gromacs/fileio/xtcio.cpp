@@ -286,3 +286,122 @@ int read_next_xtc(t_fileio* fio, int natoms, int64_t* step, real* time, matrix b
 
     return static_cast<int>(*bOK);
 }
+
+/* Reads or writes the frame data following the header of a frame
+ * read or written with read_next_xtc_compressed() or write_xtc_compressed() */
+static int xtc_compressed_coord(XDR* xd, t_xtc_compressed_frame* frame, gmx_bool bRead)
+{
+    int result = 1;
+    for (int i = 0; ((i < DIM) && result); i++)
+    {
+        for (int j = 0; ((j < DIM) && result); j++)
+        {
+            result = XTC_CHECK("box", xdr_float(xd, &(frame->box[i][j])));
+        }
+    }
+    /* The atom count is stored again at the start of the coordinates */
+    int size = frame->natoms;
+    if (result)
+    {
+        result = XTC_CHECK("natoms", xdr_int(xd, &size));
+    }
+    if (!result || size != frame->natoms)
+    {
+        return 0;
+    }
+
+    if (size <= 9)
+    {
+        /* Small frames are stored uncompressed, as in xdr3dfcoord() */
+        if (bRead)
+        {
+            frame->x.resize(DIM * size);
+        }
+        return XTC_CHECK("x",
+                         xdr_vector(xd,
+                                    reinterpret_cast<char*>(frame->x.data()),
+                                    static_cast<unsigned int>(DIM * size),
+                                    static_cast<unsigned int>(sizeof(float)),
+                                    reinterpret_cast<xdrproc_t>(xdr_float)));
+    }
+
+    result = XTC_CHECK("precision", xdr_float(xd, &frame->precision));
+    for (int d = 0; ((d < DIM) && result); d++)
+    {
+        result = XTC_CHECK("minint", xdr_int(xd, &(frame->minint[d])));
+    }
+    for (int d = 0; ((d < DIM) && result); d++)
+    {
+        result = XTC_CHECK("maxint", xdr_int(xd, &(frame->maxint[d])));
+    }
+    if (result)
+    {
+        result = XTC_CHECK("smallidx", xdr_int(xd, &frame->smallidx));
+    }
+    int numBytes = frame->compressedX.size();
+    if (result)
+    {
+        result = XTC_CHECK("x", xdr_int(xd, &numBytes));
+    }
+    if (!result || numBytes < 0)
+    {
+        return 0;
+    }
+    if (bRead)
+    {
+        frame->compressedX.resize(numBytes);
+    }
+    return XTC_CHECK(
+            "x", xdr_opaque(xd, frame->compressedX.data(), static_cast<unsigned int>(numBytes)));
+}
+
+int read_next_xtc_compressed(t_fileio* fio, t_xtc_compressed_frame* frame, gmx_bool* bOK)
+{
+    int  magic;
+    XDR* xd;
+
+    *bOK = TRUE;
+    xd   = gmx_fio_getxdr(fio);
+
+    /* read header */
+    if (!xtc_header(xd, &magic, &frame->natoms, &frame->step, &frame->time, TRUE, bOK))
+    {
+        return 0;
+    }
+
+    /* Check magic number */
+    check_xtc_magic(magic);
+
+    *bOK = (xtc_compressed_coord(xd, frame, TRUE) != 0);
+
+    return static_cast<int>(*bOK);
+}
+
+int write_xtc_compressed(t_fileio* fio, const t_xtc_compressed_frame* frame)
+{
+    int      magic_number = XTC_MAGIC;
+    int      natoms       = frame->natoms;
+    int64_t  step         = frame->step;
+    real     time         = frame->time;
+    XDR*     xd;
+    gmx_bool bDum;
+    int      bOK;
+
+    xd = gmx_fio_getxdr(fio);
+    if (xtc_header(xd, &magic_number, &natoms, &step, &time, FALSE, &bDum) == 0)
+    {
+        return 0;
+    }
+
+    /* The data is only written, so the frame is not modified */
+    bOK = xtc_compressed_coord(xd, const_cast<t_xtc_compressed_frame*>(frame), FALSE);
+
+    if (bOK)
+    {
+        if (gmx_fio_flush(fio) != 0)
+        {
+            bOK = 0;
+        }
+    }
+    return bOK; /* 0 if bad, 1 if writing went well */
+}
@@ -39,6 +39,10 @@
 #ifndef GMX_FILEIO_XTCIO_H
 #define GMX_FILEIO_XTCIO_H
 
+#include <cstdint>
+
+#include <vector>
+
 #include "gromacs/math/vectypes.h"
 #include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/real.h"
@@ -78,4 +82,29 @@ int read_next_xtc(struct t_fileio* fio, int natoms, int64_t* step, real* time, m
 int write_xtc(struct t_fileio* fio, int natoms, int64_t step, real time, const rvec* box, const rvec* x, real prec);
 /* Write a frame to xtc file */
 
+/* An xtc frame with the coordinates kept in the compressed form of the file,
+ * so frames can be copied between xtc files without decompressing and
+ * compressing the coordinates. The box and precision are stored in the
+ * single precision of the file.
+ */
+struct t_xtc_compressed_frame
+{
+    int                natoms;
+    int64_t            step;
+    real               time;
+    float              box[DIM][DIM];
+    float              precision; /* only used with more than 9 atoms */
+    int                minint[DIM], maxint[DIM], smallidx;
+    std::vector<char>  compressedX; /* the compressed coordinates */
+    std::vector<float> x;           /* uncompressed coordinates, only used with up to 9 atoms */
+};
+
+int read_next_xtc_compressed(struct t_fileio* fio, t_xtc_compressed_frame* frame, gmx_bool* bOK);
+/* Read the next frame without decompressing the coordinates */
+
+int write_xtc_compressed(struct t_fileio* fio, const t_xtc_compressed_frame* frame);
+/* Write a frame read with read_next_xtc_compressed(), with possibly changed
+ * step and time. Apart from those, the frame is a byte-for-byte copy of the
+ * frame that was read. */
+
 #endif
@@ -66,6 +66,7 @@
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/futil.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/smalloc.h"
 
 #include "thermochemistry.h"
@@ -495,7 +496,7 @@ static void project(const char*             trajfile,
                     const gmx_output_env_t* oenv)
 {
     FILE*        xvgrout = nullptr;
-    int          nat, i, j, d, v, vec, nfr, nframes = 0, snew_size, frame;
+    int          nat, i, j, d, v, nfr, nframes = 0, snew_size, frame;
     t_trxstatus* out = nullptr;
     t_trxstatus* status;
     int          noutvec_extr, imin, imax;
@@ -503,7 +504,7 @@ static void project(const char*             trajfile,
     int*         all_at;
     matrix       box;
     rvec *       xread, *x;
-    real         t, inp, **inprod = nullptr;
+    real         t, **inprod = nullptr;
     char         str[STRLEN], str2[STRLEN], *c;
     const char** ylabel;
     real         fact;
@@ -558,6 +559,10 @@ static void project(const char*             trajfile,
         {
             all_at[i] = i;
         }
+        /* Only use threads when there is sufficient work per frame */
+        const int nthreadsProj = (static_cast<gmx::index>(noutvec + 1) * natoms < 10000)
+                                         ? 1
+                                         : std::max(1, gmx_omp_get_max_threads());
         do
         {
             if (nfr % skip == 0)
@@ -568,7 +573,7 @@ static void project(const char*             trajfile,
                 }
                 if (nframes >= snew_size)
                 {
-                    snew_size += 100;
+                    snew_size = over_alloc_large(nframes + 1);
                     for (i = 0; i < noutvec + 1; i++)
                     {
                         srenew(inprod[i], snew_size);
@@ -581,34 +586,38 @@ static void project(const char*             trajfile,
                     reset_x(nfit, ifit, nat, nullptr, xread, w_rls);
                     do_fit(nat, w_rls, xref, xread);
                 }
+                /* x: the deviation of the selected atoms from the average structure */
                 for (i = 0; i < natoms; i++)
                 {
-                    copy_rvec(xread[index[i]], x[i]);
+                    rvec_sub(xread[index[i]], xav[i], x[i]);
                 }
 
-                for (v = 0; v < noutvec; v++)
+                /* The projections onto the different eigenvectors are independent,
+                 * each one is summed in the same order as with a single thread.
+                 */
+#pragma omp parallel for num_threads(nthreadsProj) schedule(static)
+                for (int v = 0; v < noutvec; v++)
                 {
-                    vec = outvec[v];
+                    const rvec* ev = eigvec[outvec[v]];
                     /* calculate (mass-weighted) projection */
-                    inp = 0;
-                    for (i = 0; i < natoms; i++)
+                    real inp = 0;
+                    for (int i = 0; i < natoms; i++)
                     {
-                        inp += (eigvec[vec][i][0] * (x[i][0] - xav[i][0])
-                                + eigvec[vec][i][1] * (x[i][1] - xav[i][1])
-                                + eigvec[vec][i][2] * (x[i][2] - xav[i][2]))
+                        inp += (ev[i][0] * x[i][0] + ev[i][1] * x[i][1] + ev[i][2] * x[i][2])
                                * sqrtm[i];
                     }
                     inprod[v][nframes] = inp;
                 }
                 if (filterfile)
                 {
-                    for (i = 0; i < natoms; i++)
+#pragma omp parallel for num_threads(nthreadsProj) schedule(static)
+                    for (int i = 0; i < natoms; i++)
                     {
-                        for (d = 0; d < DIM; d++)
+                        for (int d = 0; d < DIM; d++)
                         {
                             /* misuse xread for output */
                             xread[index[i]][d] = xav[i][d];
-                            for (v = 0; v < noutvec; v++)
+                            for (int v = 0; v < noutvec; v++)
                             {
                                 xread[index[i]][d] +=
                                         inprod[v][nframes] * eigvec[outvec[v]][i][d] / sqrtm[i];
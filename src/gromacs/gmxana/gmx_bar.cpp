@@ -1579,14 +1579,17 @@ static void sim_data_init(sim_data_t* sd)
 }
 
 
+/* The minimum number of samples for which we use OpenMP threads in calc_bar_sum,
+ * below this the threading overhead is larger than the gain.
+ */
+static const int c_minSamplesForThreading = 10000;
+
 static double calc_bar_sum(int n, const double* W, double Wfac, double sbMmDG)
 {
-    int    i;
-    double sum;
-
-    sum = 0;
+    double sum = 0;
 
-    for (i = 0; i < n; i++)
+#pragma omp parallel for reduction(+ : sum) schedule(static) if (n >= c_minSamplesForThreading)
+    for (int i = 0; i < n; i++)
     {
         sum += 1. / (1. + std::exp(Wfac * W[i] + sbMmDG));
     }
@@ -1632,10 +1635,56 @@ static double calc_bar_sum_hist(const hist_t* hist, double Wfac, double sbMmDG,
     return sum;
 }
 
+/* calculate the difference of the BAR averages of ca and cb for a given
+   value of M - DG; this is zero at the BAR estimate of DG */
+static double calc_bar_average(const sample_coll_t* ca,
+                               const sample_coll_t* cb,
+                               double               Wfac1,
+                               double               Wfac2,
+                               double               MmDG,
+                               int                  type)
+{
+    double dDG = 0.;
+
+    for (int i = 0; i < ca->nsamples; i++)
+    {
+        const samples_t*      s = ca->s[i];
+        const sample_range_t* r = &(ca->r[i]);
+        if (r->use)
+        {
+            if (s->hist)
+            {
+                dDG += calc_bar_sum_hist(s->hist, Wfac1, MmDG, type);
+            }
+            else
+            {
+                dDG += calc_bar_sum(r->end - r->start, s->du + r->start, Wfac1, MmDG);
+            }
+        }
+    }
+    for (int i = 0; i < cb->nsamples; i++)
+    {
+        const samples_t*      s = cb->s[i];
+        const sample_range_t* r = &(cb->r[i]);
+        if (r->use)
+        {
+            if (s->hist)
+            {
+                dDG -= calc_bar_sum_hist(s->hist, Wfac2, -MmDG, type);
+            }
+            else
+            {
+                dDG -= calc_bar_sum(r->end - r->start, s->du + r->start, Wfac2, -MmDG);
+            }
+        }
+    }
+
+    return dDG;
+}
+
 static double calc_bar_lowlevel(sample_coll_t* ca, sample_coll_t* cb, double temp, double tol, int type)
 {
     double kT, beta, M;
-    int    i;
     double Wfac1, Wfac2, Wmin, Wmax;
     double DG0, DG1, DG2, dDG1;
     double n1, n2; /* numbers of samples as doubles */
@@ -1700,58 +1749,47 @@ static double calc_bar_lowlevel(sample_coll_t* ca, sample_coll_t* cb, double tem
     {
         fprintf(debug, "DG %9.5f %9.5f\n", DG0, DG2);
     }
-    /* We approximate by bisection: given our initial estimates
-       we keep checking whether the halfway point is greater or
-       smaller than what we get out of the BAR averages.
+    /* We find the root of the BAR equation, which is monotonically
+       increasing in DG, within the bracket [DG0, DG2]. We use false
+       position (regula falsi) steps, which converge much faster than
+       bisection for the smooth BAR function. To guarantee convergence
+       we take a bisection step whenever the previous step did not at
+       least halve the bracket and we keep trial points at least tol
+       away from the bracket ends, so the bracket also closes from the
+       far side.
 
        For the comparison we can use twice the tolerance. */
+    double f0 = calc_bar_average(ca, cb, Wfac1, Wfac2, M - DG0, type);
+    double f2 = calc_bar_average(ca, cb, Wfac1, Wfac2, M - DG2, type);
+
+    double prevWidth = 2 * (DG2 - DG0);
     while (DG2 - DG0 > 2 * tol)
     {
-        DG1 = 0.5 * (DG0 + DG2);
+        double width = DG2 - DG0;
 
-        /* calculate the BAR averages */
-        dDG1 = 0.;
-
-        for (i = 0; i < ca->nsamples; i++)
+        if (f0 < 0 && f2 > 0 && width <= 0.5 * prevWidth)
         {
-            samples_t*      s = ca->s[i];
-            sample_range_t* r = &(ca->r[i]);
-            if (r->use)
-            {
-                if (s->hist)
-                {
-                    dDG1 += calc_bar_sum_hist(s->hist, Wfac1, (M - DG1), type);
-                }
-                else
-                {
-                    dDG1 += calc_bar_sum(r->end - r->start, s->du + r->start, Wfac1, (M - DG1));
-                }
-            }
+            DG1 = (f2 * DG0 - f0 * DG2) / (f2 - f0);
+            DG1 = std::min(std::max(DG1, DG0 + tol), DG2 - tol);
         }
-        for (i = 0; i < cb->nsamples; i++)
+        else
         {
-            samples_t*      s = cb->s[i];
-            sample_range_t* r = &(cb->r[i]);
-            if (r->use)
-            {
-                if (s->hist)
-                {
-                    dDG1 -= calc_bar_sum_hist(s->hist, Wfac2, -(M - DG1), type);
-                }
-                else
-                {
-                    dDG1 -= calc_bar_sum(r->end - r->start, s->du + r->start, Wfac2, -(M - DG1));
-                }
-            }
+            DG1 = 0.5 * (DG0 + DG2);
         }
+        prevWidth = width;
+
+        /* calculate the BAR averages */
+        dDG1 = calc_bar_average(ca, cb, Wfac1, Wfac2, M - DG1, type);
 
         if (dDG1 < 0)
         {
             DG0 = DG1;
+            f0  = dDG1;
         }
         else
         {
             DG2 = DG1;
+            f2  = dDG1;
         }
         if (debug)
         {
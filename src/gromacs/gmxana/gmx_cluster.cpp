@@ -64,8 +64,10 @@
 #include "gromacs/topology/topology.h"
 #include "gromacs/utility/arraysize.h"
 #include "gromacs/utility/cstringutil.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/futil.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/smalloc.h"
 #include "gromacs/utility/stringutil.h"
 
@@ -890,7 +892,7 @@ int gmx_cluster(int argc, char* argv[])
 
     matrix      box;
     matrix*     boxes = nullptr;
-    rvec *      xtps, *usextps, *x1, **xx = nullptr;
+    rvec *      xtps, *usextps, **xx = nullptr;
     const char *fn, *trx_out_fn;
     t_clusters  clust;
     t_mat *     rms, *orig = nullptr;
@@ -903,7 +905,7 @@ int gmx_cluster(int argc, char* argv[])
     int      isize = 0, ifsize = 0, iosize = 0;
     int *    index = nullptr, *fitidx = nullptr, *outidx = nullptr, *frameindices = nullptr;
     char*    grpname;
-    real     rmsd, **d1, **d2, *time = nullptr, time_invfac, *mass = nullptr;
+    real **  d1, **d2, *time = nullptr, time_invfac, *mass = nullptr;
     char     buf[STRLEN], buf1[80];
     gmx_bool bAnalyze, bUseRmsdCut, bJP_RMSD = FALSE, bReadMat, bReadTraj, bPBC = TRUE;
 
@@ -1263,31 +1265,56 @@ int gmx_cluster(int argc, char* argv[])
         if (!bRMSdist)
         {
             fprintf(stderr, "Computing %dx%d RMS deviation matrix\n", nf, nf);
-            /* Initialize work array */
-            snew(x1, isize);
-            for (i1 = 0; i1 < nf; i1++)
+            /* The rows are computed in parallel, each thread uses its own
+             * work array for fitting. The RMSD values are stored in the
+             * upper triangle here, and entered with set_mat_entry() in
+             * order afterwards, so the matrix statistics do not depend on
+             * the number of threads.
+             */
+#pragma omp parallel
             {
-                for (i2 = i1 + 1; i2 < nf; i2++)
+                try
                 {
-                    for (i = 0; i < isize; i++)
+                    rvec* xFit;
+                    snew(xFit, isize);
+#pragma omp for schedule(dynamic)
+                    for (int row = 0; row < nf; row++)
                     {
-                        copy_rvec(xx[i1][i], x1[i]);
-                    }
-                    if (bFit)
-                    {
-                        do_fit(isize, mass, xx[i2], x1);
+                        for (int col = row + 1; col < nf; col++)
+                        {
+                            for (int a = 0; a < isize; a++)
+                            {
+                                copy_rvec(xx[row][a], xFit[a]);
+                            }
+                            if (bFit)
+                            {
+                                do_fit(isize, mass, xx[col], xFit);
+                            }
+                            rms->mat[row][col] = rmsdev(isize, mass, xx[col], xFit);
+                        }
+                        int64_t numLeft;
+#pragma omp atomic capture
+                        numLeft = nrms -= nf - row - 1;
+                        if (gmx_omp_get_thread_num() == 0)
+                        {
+                            fprintf(stderr,
+                                    "\r# RMSD calculations left: "
+                                    "%" PRId64 "   ",
+                                    numLeft);
+                            fflush(stderr);
+                        }
                     }
-                    rmsd = rmsdev(isize, mass, xx[i2], x1);
-                    set_mat_entry(rms, i1, i2, rmsd);
+                    sfree(xFit);
+                }
+                GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+            }
+            for (i1 = 0; i1 < nf; i1++)
+            {
+                for (i2 = i1 + 1; i2 < nf; i2++)
+                {
+                    set_mat_entry(rms, i1, i2, rms->mat[i1][i2]);
                 }
-                nrms -= nf - i1 - 1;
-                fprintf(stderr,
-                        "\r# RMSD calculations left: "
-                        "%" PRId64 "   ",
-                        nrms);
-                fflush(stderr);
             }
-            sfree(x1);
         }
         else /* bRMSdist */
         {
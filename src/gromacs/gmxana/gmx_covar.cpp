@@ -37,9 +37,13 @@
  */
 #include "gmxpre.h"
 
+#include "config.h"
+
 #include <cmath>
 #include <cstring>
 
+#include <vector>
+
 #include "gromacs/commandline/pargs.h"
 #include "gromacs/fileio/confio.h"
 #include "gromacs/fileio/matio.h"
@@ -48,6 +52,7 @@
 #include "gromacs/gmxana/eigio.h"
 #include "gromacs/gmxana/gmx_ana.h"
 #include "gromacs/linearalgebra/eigensolver.h"
+#include "gromacs/linearalgebra/gmx_blas.h"
 #include "gromacs/math/do_fit.h"
 #include "gromacs/math/vec.h"
 #include "gromacs/pbcutil/pbc.h"
@@ -97,6 +102,35 @@ void throwErrorIfIndexOutOfBounds(ArrayRef<const int> indices, const int numAtom
     }
 };
 
+//! The number of frames to accumulate into the covariance matrix at once
+constexpr int c_covarFrameChunkSize = 64;
+
+/*! \brief Adds the outer products of frame displacements to a covariance matrix
+ *
+ * Computes \p mat += F F^T with one matrix multiplication, where column f of
+ * F is frame f in \p frames. Adding a chunk of frames at once instead of one
+ * frame at a time means the matrix, which is much larger than the cache for
+ * large systems, is streamed through memory once per chunk instead of once
+ * per frame.
+ *
+ * \param[in,out] mat       The ndim x ndim covariance matrix
+ * \param[in]     ndim      The number of degrees of freedom
+ * \param[in]     frames    \p numFrames frames of \p ndim displacements each
+ * \param[in]     numFrames The number of frames to add
+ */
+void addFramesToCovariance(real* mat, int ndim, real* frames, int numFrames)
+{
+    const char* transA = "N";
+    const char* transB = "T";
+    real        one    = 1;
+#if GMX_DOUBLE
+    F77_FUNC(dgemm, DGEMM)
+#else
+    F77_FUNC(sgemm, SGEMM)
+#endif
+    (transA, transB, &ndim, &ndim, &numFrames, &one, frames, &ndim, frames, &ndim, &one, mat, &ndim);
+}
+
 } // namespace
 
 } // namespace gmx
@@ -160,10 +194,10 @@ int gmx_covar(int argc, char* argv[])
     matrix            box, zerobox;
     real *            sqrtm, *mat, *eigenvalues, sum, trace, inv_nframes;
     real              t, tstart, tend, **mat2;
-    real              xj, *w_rls = nullptr;
+    real*             w_rls = nullptr;
     real              min, max, *axis;
     int               natoms, nat, nframes0, nframes, nlevels;
-    int64_t           ndim, i, j, k, l;
+    int64_t           ndim, i, j, k;
     int               WriteXref;
     const char *      fitfile, *trxfile, *ndxfile;
     const char *      eigvalfile, *eigvecfile, *averfile, *logfile;
@@ -361,6 +395,8 @@ int gmx_covar(int argc, char* argv[])
     nframes = 0;
     nat     = read_first_x(oenv, &status, trxfile, &t, &xread, box);
     tstart  = t;
+    std::vector<real> frameChunk(ndim * gmx::c_covarFrameChunkSize);
+    int               numFramesInChunk = 0;
     do
     {
         nframes++;
@@ -390,23 +426,20 @@ int gmx_covar(int argc, char* argv[])
             }
         }
 
-        for (j = 0; j < natoms; j++)
+        std::memcpy(frameChunk.data() + numFramesInChunk * ndim, x, ndim * sizeof(real));
+        numFramesInChunk++;
+        if (numFramesInChunk == gmx::c_covarFrameChunkSize)
         {
-            for (dj = 0; dj < DIM; dj++)
-            {
-                k  = ndim * (DIM * j + dj);
-                xj = x[j][dj];
-                for (i = j; i < natoms; i++)
-                {
-                    l = k + DIM * i;
-                    for (d = 0; d < DIM; d++)
-                    {
-                        mat[l + d] += x[i][d] * xj;
-                    }
-                }
-            }
+            gmx::addFramesToCovariance(
+                    mat, static_cast<int>(ndim), frameChunk.data(), numFramesInChunk);
+            numFramesInChunk = 0;
         }
     } while (read_next_x(oenv, status, &t, xread, box) && (bRef || nframes < nframes0));
+    if (numFramesInChunk > 0)
+    {
+        gmx::addFramesToCovariance(
+                mat, static_cast<int>(ndim), frameChunk.data(), numFramesInChunk);
+    }
     close_trx(status);
     gmx_rmpbc_done(gpbc);
 
@@ -42,6 +42,8 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <vector>
+
 #include "gromacs/commandline/pargs.h"
 #include "gromacs/commandline/viewit.h"
 #include "gromacs/fileio/trxio.h"
@@ -228,6 +230,34 @@ static void calc_electron_density(const char*             fn,
         snew((*slDensity)[i], *nslices);
     }
 
+    /* Look up the number of electrons of each atom once, instead of every frame */
+    std::vector<std::vector<const t_electron*>> atomElectrons(nr_grps);
+    for (n = 0; n < nr_grps; n++)
+    {
+        atomElectrons[n].resize(gnx[n]);
+        for (i = 0; i < gnx[n]; i++)
+        {
+            sought.nr_el    = 0;
+            sought.atomname = gmx_strdup(*(top->atoms.atomname[index[n][i]]));
+
+            found = static_cast<t_electron*>(
+                    bsearch(&sought,
+                            eltab,
+                            nr,
+                            sizeof(t_electron),
+                            reinterpret_cast<int (*)(const void*, const void*)>(compare)));
+
+            if (found == nullptr)
+            {
+                fprintf(stderr,
+                        "Couldn't find %s. Add it to the .dat file\n",
+                        *(top->atoms.atomname[index[n][i]]));
+            }
+            atomElectrons[n][i] = found;
+            free(sought.atomname);
+        }
+    }
+
     gpbc = gmx_rmpbc_init(&top->idef, pbcType, top->atoms.nr);
     /*********** Start processing trajectory ***********/
     do
@@ -285,28 +315,11 @@ static void calc_electron_density(const char*             fn,
                 {
                     slice = static_cast<int>(z / (*slWidth));
                 }
-                sought.nr_el    = 0;
-                sought.atomname = gmx_strdup(*(top->atoms.atomname[index[n][i]]));
-
-                /* now find the number of electrons. This is not efficient. */
-                found = static_cast<t_electron*>(
-                        bsearch(&sought,
-                                eltab,
-                                nr,
-                                sizeof(t_electron),
-                                reinterpret_cast<int (*)(const void*, const void*)>(compare)));
-
-                if (found == nullptr)
-                {
-                    fprintf(stderr,
-                            "Couldn't find %s. Add it to the .dat file\n",
-                            *(top->atoms.atomname[index[n][i]]));
-                }
-                else
+                if (atomElectrons[n][i] != nullptr)
                 {
-                    (*slDensity)[n][slice] += (found->nr_el - top->atoms.atom[index[n][i]].q) * invvol;
+                    (*slDensity)[n][slice] +=
+                            (atomElectrons[n][i]->nr_el - top->atoms.atom[index[n][i]].q) * invvol;
                 }
-                free(sought.atomname);
             }
         }
         nr_frames++;
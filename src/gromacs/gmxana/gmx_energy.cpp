@@ -66,8 +66,10 @@
 #include "gromacs/trajectory/energyframe.h"
 #include "gromacs/utility/arraysize.h"
 #include "gromacs/utility/cstringutil.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/pleasecite.h"
 #include "gromacs/utility/smalloc.h"
 #include "gromacs/utility/strconvert.h"
@@ -442,184 +444,203 @@ static void set_ee_av(ener_ee_t* eee)
     eee->nst = 0;
 }
 
-static void calc_averages(int nset, enerdata_t* edat, int nbmin, int nbmax)
+//! Computes the average, fluctuation, drift and error estimate of set \p ed, \p eee is a buffer
+static void calc_set_averages(const enerdata_t* edat,
+                              enerdat_t*        ed,
+                              int               nbmin,
+                              int               nbmax,
+                              ener_ee_t*        eee)
 {
-    int         nb, i, f, nee;
+    int         nb, f, nee;
     double      sum, sum2, sump, see2;
     int64_t     np, p, bound_nb;
-    enerdat_t*  ed;
     exactsum_t* es;
-    gmx_bool    bAllZero;
     double      x, sx, sy, sxx, sxy;
-    ener_ee_t*  eee;
 
-    /* Check if we have exact statistics over all points */
-    for (i = 0; i < nset; i++)
+    sum  = 0;
+    sum2 = 0;
+    np   = 0;
+    sx   = 0;
+    sy   = 0;
+    sxx  = 0;
+    sxy  = 0;
+    for (nb = nbmin; nb <= nbmax; nb++)
     {
-        ed             = &edat->s[i];
-        ed->bExactStat = FALSE;
-        if (edat->bHaveSums)
+        eee[nb].b = 0;
+        clear_ee_sum(&eee[nb].sum);
+        eee[nb].nst     = 0;
+        eee[nb].nst_min = 0;
+    }
+    for (f = 0; f < edat->nframes; f++)
+    {
+        es = &ed->es[f];
+
+        if (ed->bExactStat)
         {
-            /* All energy file sum entries 0 signals no exact sums.
-             * But if all energy values are 0, we still have exact sums.
-             */
-            bAllZero = TRUE;
-            for (f = 0; f < edat->nframes && !ed->bExactStat; f++)
-            {
-                if (ed->ener[i] != 0)
-                {
-                    bAllZero = FALSE;
-                }
-                ed->bExactStat = (ed->es[f].sum != 0);
-            }
-            if (bAllZero)
+            /* Add the sum and the sum of variances to the totals. */
+            p    = edat->points[f];
+            sump = es->sum;
+            sum2 += es->sum2;
+            if (np > 0)
             {
-                ed->bExactStat = TRUE;
+                sum2 += gmx::square(sum / np - (sum + es->sum) / (np + p)) * np * (np + p) / p;
             }
         }
-    }
+        else
+        {
+            /* Add a single value to the sum and sum of squares. */
+            p    = 1;
+            sump = ed->ener[f];
+            sum2 += gmx::square(sump);
+        }
 
-    snew(eee, nbmax + 1);
-    for (i = 0; i < nset; i++)
-    {
-        ed = &edat->s[i];
+        /* sum has to be increased after sum2 */
+        np += p;
+        sum += sump;
+
+        /* For the linear regression use variance 1/p.
+         * Note that sump is the sum, not the average, so we don't need p*.
+         */
+        x = edat->step[f] - 0.5 * (edat->steps[f] - 1);
+        sx += p * x;
+        sy += sump;
+        sxx += p * x * x;
+        sxy += x * sump;
 
-        sum  = 0;
-        sum2 = 0;
-        np   = 0;
-        sx   = 0;
-        sy   = 0;
-        sxx  = 0;
-        sxy  = 0;
         for (nb = nbmin; nb <= nbmax; nb++)
         {
-            eee[nb].b = 0;
-            clear_ee_sum(&eee[nb].sum);
-            eee[nb].nst     = 0;
-            eee[nb].nst_min = 0;
-        }
-        for (f = 0; f < edat->nframes; f++)
-        {
-            es = &ed->es[f];
-
+            /* Check if the current end step is closer to the desired
+             * block boundary than the next end step.
+             */
+            bound_nb = (edat->step[0] - 1) * nb + edat->nsteps * (eee[nb].b + 1);
+            if (eee[nb].nst > 0 && bound_nb - edat->step[f - 1] * nb < edat->step[f] * nb - bound_nb)
+            {
+                set_ee_av(&eee[nb]);
+            }
+            if (f == 0)
+            {
+                eee[nb].nst = 1;
+            }
+            else
+            {
+                eee[nb].nst += edat->step[f] - edat->step[f - 1];
+            }
             if (ed->bExactStat)
             {
-                /* Add the sum and the sum of variances to the totals. */
-                p    = edat->points[f];
-                sump = es->sum;
-                sum2 += es->sum2;
-                if (np > 0)
-                {
-                    sum2 += gmx::square(sum / np - (sum + es->sum) / (np + p)) * np * (np + p) / p;
-                }
+                add_ee_sum(&eee[nb].sum, es->sum, edat->points[f]);
             }
             else
             {
-                /* Add a single value to the sum and sum of squares. */
-                p    = 1;
-                sump = ed->ener[f];
-                sum2 += gmx::square(sump);
+                add_ee_sum(&eee[nb].sum, ed->ener[f], 1);
             }
-
-            /* sum has to be increased after sum2 */
-            np += p;
-            sum += sump;
-
-            /* For the linear regression use variance 1/p.
-             * Note that sump is the sum, not the average, so we don't need p*.
-             */
-            x = edat->step[f] - 0.5 * (edat->steps[f] - 1);
-            sx += p * x;
-            sy += sump;
-            sxx += p * x * x;
-            sxy += x * sump;
-
-            for (nb = nbmin; nb <= nbmax; nb++)
+            bound_nb = (edat->step[0] - 1) * nb + edat->nsteps * (eee[nb].b + 1);
+            if (edat->step[f] * nb >= bound_nb)
             {
-                /* Check if the current end step is closer to the desired
-                 * block boundary than the next end step.
-                 */
-                bound_nb = (edat->step[0] - 1) * nb + edat->nsteps * (eee[nb].b + 1);
-                if (eee[nb].nst > 0 && bound_nb - edat->step[f - 1] * nb < edat->step[f] * nb - bound_nb)
-                {
-                    set_ee_av(&eee[nb]);
-                }
-                if (f == 0)
-                {
-                    eee[nb].nst = 1;
-                }
-                else
-                {
-                    eee[nb].nst += edat->step[f] - edat->step[f - 1];
-                }
-                if (ed->bExactStat)
-                {
-                    add_ee_sum(&eee[nb].sum, es->sum, edat->points[f]);
-                }
-                else
-                {
-                    add_ee_sum(&eee[nb].sum, edat->s[i].ener[f], 1);
-                }
-                bound_nb = (edat->step[0] - 1) * nb + edat->nsteps * (eee[nb].b + 1);
-                if (edat->step[f] * nb >= bound_nb)
-                {
-                    set_ee_av(&eee[nb]);
-                }
+                set_ee_av(&eee[nb]);
             }
         }
+    }
 
-        edat->s[i].av = sum / np;
-        if (ed->bExactStat)
-        {
-            edat->s[i].rmsd = std::sqrt(sum2 / np);
-        }
-        else
-        {
-            edat->s[i].rmsd = std::sqrt(sum2 / np - gmx::square(edat->s[i].av));
-        }
+    ed->av = sum / np;
+    if (ed->bExactStat)
+    {
+        ed->rmsd = std::sqrt(sum2 / np);
+    }
+    else
+    {
+        ed->rmsd = std::sqrt(sum2 / np - gmx::square(ed->av));
+    }
 
-        if (edat->nframes > 1)
+    if (edat->nframes > 1)
+    {
+        ed->slope = (np * sxy - sx * sy) / (np * sxx - sx * sx);
+    }
+    else
+    {
+        ed->slope = 0;
+    }
+
+    nee  = 0;
+    see2 = 0;
+    for (nb = nbmin; nb <= nbmax; nb++)
+    {
+        /* Check if we actually got nb blocks and if the smallest
+         * block is not shorter than 80% of the average.
+         */
+        if (debug)
         {
-            edat->s[i].slope = (np * sxy - sx * sy) / (np * sxx - sx * sx);
+            char buf1[STEPSTRSIZE], buf2[STEPSTRSIZE];
+            fprintf(debug,
+                    "Requested %d blocks, we have %d blocks, min %s nsteps %s\n",
+                    nb,
+                    eee[nb].b,
+                    gmx_step_str(eee[nb].nst_min, buf1),
+                    gmx_step_str(edat->nsteps, buf2));
         }
-        else
+        if (eee[nb].b == nb && 5 * nb * eee[nb].nst_min >= 4 * edat->nsteps)
         {
-            edat->s[i].slope = 0;
+            see2 += calc_ee2(nb, &eee[nb].sum);
+            nee++;
         }
+    }
+    if (nee > 0)
+    {
+        ed->ee = std::sqrt(see2 / nee);
+    }
+    else
+    {
+        ed->ee = -1;
+    }
+}
 
-        nee  = 0;
-        see2 = 0;
-        for (nb = nbmin; nb <= nbmax; nb++)
+static void calc_averages(int nset, enerdata_t* edat, int nbmin, int nbmax)
+{
+    int        i, f;
+    enerdat_t* ed;
+    gmx_bool   bAllZero;
+
+    /* Check if we have exact statistics over all points */
+    for (i = 0; i < nset; i++)
+    {
+        ed             = &edat->s[i];
+        ed->bExactStat = FALSE;
+        if (edat->bHaveSums)
         {
-            /* Check if we actually got nb blocks and if the smallest
-             * block is not shorter than 80% of the average.
+            /* All energy file sum entries 0 signals no exact sums.
+             * But if all energy values are 0, we still have exact sums.
              */
-            if (debug)
+            bAllZero = TRUE;
+            for (f = 0; f < edat->nframes && !ed->bExactStat; f++)
             {
-                char buf1[STEPSTRSIZE], buf2[STEPSTRSIZE];
-                fprintf(debug,
-                        "Requested %d blocks, we have %d blocks, min %s nsteps %s\n",
-                        nb,
-                        eee[nb].b,
-                        gmx_step_str(eee[nb].nst_min, buf1),
-                        gmx_step_str(edat->nsteps, buf2));
+                if (ed->ener[i] != 0)
+                {
+                    bAllZero = FALSE;
+                }
+                ed->bExactStat = (ed->es[f].sum != 0);
             }
-            if (eee[nb].b == nb && 5 * nb * eee[nb].nst_min >= 4 * edat->nsteps)
+            if (bAllZero)
             {
-                see2 += calc_ee2(nb, &eee[nb].sum);
-                nee++;
+                ed->bExactStat = TRUE;
             }
         }
-        if (nee > 0)
-        {
-            edat->s[i].ee = std::sqrt(see2 / nee);
-        }
-        else
+    }
+
+    /* The sets are independent, so they are processed in parallel */
+#pragma omp parallel num_threads(std::max(1, std::min(nset, gmx_omp_get_max_threads())))
+    {
+        try
         {
-            edat->s[i].ee = -1;
+            ener_ee_t* eee;
+            snew(eee, nbmax + 1);
+#pragma omp for schedule(dynamic)
+            for (int s = 0; s < nset; s++)
+            {
+                calc_set_averages(edat, &edat->s[s], nbmin, nbmax, eee);
+            }
+            sfree(eee);
         }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
     }
-    sfree(eee);
 }
 
 static enerdata_t* calc_sum(int nset, enerdata_t* edat, int nbmin, int nbmax)
@@ -1958,6 +1979,7 @@ int gmx_energy(int argc, char* argv[])
     edat.points    = nullptr;
     edat.bHaveSums = TRUE;
     snew(edat.s, nset);
+    int nframesAlloc = 0;
 
     /* Initiate counters */
     bFoundStart = FALSE;
@@ -1987,21 +2009,25 @@ int gmx_energy(int argc, char* argv[])
                 /* The frame contains energies, so update cur */
                 cur = NEXT;
 
-                if (edat.nframes % 1000 == 0)
+                if (edat.nframes == nframesAlloc)
                 {
-                    srenew(edat.step, edat.nframes + 1000);
-                    std::memset(&(edat.step[edat.nframes]), 0, 1000 * sizeof(edat.step[0]));
-                    srenew(edat.steps, edat.nframes + 1000);
-                    std::memset(&(edat.steps[edat.nframes]), 0, 1000 * sizeof(edat.steps[0]));
-                    srenew(edat.points, edat.nframes + 1000);
-                    std::memset(&(edat.points[edat.nframes]), 0, 1000 * sizeof(edat.points[0]));
+                    /* Grow geometrically, so long runs do not copy the data over and over */
+                    nframesAlloc  = over_alloc_large(edat.nframes + 1);
+                    const int nnf = nframesAlloc - edat.nframes;
+                    srenew(edat.step, nframesAlloc);
+                    std::memset(&(edat.step[edat.nframes]), 0, nnf * sizeof(edat.step[0]));
+                    srenew(edat.steps, nframesAlloc);
+                    std::memset(&(edat.steps[edat.nframes]), 0, nnf * sizeof(edat.steps[0]));
+                    srenew(edat.points, nframesAlloc);
+                    std::memset(&(edat.points[edat.nframes]), 0, nnf * sizeof(edat.points[0]));
+                    srenew(time, nframesAlloc);
 
                     for (i = 0; i < nset; i++)
                     {
-                        srenew(edat.s[i].ener, edat.nframes + 1000);
-                        std::memset(&(edat.s[i].ener[edat.nframes]), 0, 1000 * sizeof(edat.s[i].ener[0]));
-                        srenew(edat.s[i].es, edat.nframes + 1000);
-                        std::memset(&(edat.s[i].es[edat.nframes]), 0, 1000 * sizeof(edat.s[i].es[0]));
+                        srenew(edat.s[i].ener, nframesAlloc);
+                        std::memset(&(edat.s[i].ener[edat.nframes]), 0, nnf * sizeof(edat.s[i].ener[0]));
+                        srenew(edat.s[i].es, nframesAlloc);
+                        std::memset(&(edat.s[i].es[edat.nframes]), 0, nnf * sizeof(edat.s[i].es[0]));
                     }
                 }
 
@@ -2077,10 +2103,6 @@ int gmx_energy(int argc, char* argv[])
              */
             if (!bDHDL && (fr->nre > 0))
             {
-                if (edat.nframes % 1000 == 0)
-                {
-                    srenew(time, edat.nframes + 1000);
-                }
                 time[edat.nframes] = fr->t;
                 edat.nframes++;
             }
@@ -319,12 +319,13 @@ static void add_ff(t_hbdata* hbd, int id, int h, int ia, int frame, int ihb)
     else
     {
         hb->nframes = frame - hb->n0;
-        /* We need a while loop here because hbonds may be returning
-         * after a long time.
+        /* Hbonds may be returning after a long time, so we grow the
+         * arrays directly to the required multiple of delta, instead of
+         * by delta at a time, to avoid repeated reallocation and copying.
          */
-        while (hb->nframes >= hb->maxframes)
+        if (hb->nframes >= hb->maxframes)
         {
-            n = hb->maxframes + delta;
+            n = (hb->nframes / delta + 1) * delta;
             for (i = 0; (i < maxhydro); i++)
             {
                 srenew(hb->h[i], n / wlen);
@@ -41,6 +41,7 @@
 #include <cstring>
 
 #include <algorithm>
+#include <vector>
 
 #include "gromacs/commandline/filenm.h"
 #include "gromacs/commandline/pargs.h"
@@ -57,8 +58,10 @@
 #include "gromacs/topology/topology.h"
 #include "gromacs/utility/arraysize.h"
 #include "gromacs/utility/cstringutil.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/futil.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/smalloc.h"
 
 
@@ -118,10 +121,9 @@ static void calc_mat(int        nres,
                      PbcType    pbcType,
                      matrix     box)
 {
-    int   i, j, resi, resj;
-    real  trunc2, r, r2;
+    int   resi, resj;
+    real  trunc2, r;
     t_pbc pbc;
-    rvec  ddx;
 
     set_pbc(&pbc, pbcType, box);
     trunc2 = gmx::square(trunc);
@@ -132,21 +134,57 @@ static void calc_mat(int        nres,
             mdmat[resi][resj] = FARAWAY;
         }
     }
-    for (i = 0; (i < natoms); i++)
+
+    /* Sort the atoms by residue, so each thread can own complete rows of mdmat and nmat */
+    std::vector<int> resAtomStart(nres + 1, 0);
+    std::vector<int> resAtoms(natoms);
+    for (int i = 0; (i < natoms); i++)
+    {
+        resAtomStart[rndx[i] + 1]++;
+    }
+    for (resi = 0; (resi < nres); resi++)
     {
-        resi = rndx[i];
-        for (j = i + 1; (j < natoms); j++)
+        resAtomStart[resi + 1] += resAtomStart[resi];
+    }
+    {
+        std::vector<int> fill(resAtomStart.begin(), resAtomStart.end() - 1);
+        for (int i = 0; (i < natoms); i++)
         {
-            resj = rndx[j];
-            pbc_dx(&pbc, x[index[i]], x[index[j]], ddx);
-            r2 = norm2(ddx);
-            if (r2 < trunc2)
+            resAtoms[fill[rndx[i]]++] = i;
+        }
+    }
+
+    /* Only nmat[resj][i] can be written by several threads, the minimum pair
+     * distances and the counts are independent of the thread distribution.
+     */
+#pragma omp parallel for num_threads(std::max(1, std::min(nres, gmx_omp_get_max_threads()))) \
+        schedule(dynamic)
+    for (int res = 0; res < nres; res++)
+    {
+        try
+        {
+            real* mdmatRow = mdmat[res];
+            int*  nmatRow  = nmat[res];
+            for (int a = resAtomStart[res]; a < resAtomStart[res + 1]; a++)
             {
-                nmat[resi][j]++;
-                nmat[resj][i]++;
+                const int i = resAtoms[a];
+                for (int j = i + 1; (j < natoms); j++)
+                {
+                    const int rj = rndx[j];
+                    rvec      ddx;
+                    pbc_dx(&pbc, x[index[i]], x[index[j]], ddx);
+                    const real r2 = norm2(ddx);
+                    if (r2 < trunc2)
+                    {
+                        nmatRow[j]++;
+#pragma omp atomic
+                        nmat[rj][i]++;
+                    }
+                    mdmatRow[rj] = std::min(r2, mdmatRow[rj]);
+                }
             }
-            mdmat[resi][resj] = std::min(r2, mdmat[resi][resj]);
         }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
     }
 
     for (resi = 0; (resi < nres); resi++)
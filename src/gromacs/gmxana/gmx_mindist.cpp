@@ -42,6 +42,7 @@
 #include <cstring>
 
 #include <algorithm>
+#include <vector>
 
 #include "gromacs/commandline/pargs.h"
 #include "gromacs/commandline/viewit.h"
@@ -58,9 +59,11 @@
 #include "gromacs/topology/topology.h"
 #include "gromacs/utility/arraysize.h"
 #include "gromacs/utility/cstringutil.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/futil.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/smalloc.h"
 
 
@@ -228,6 +231,27 @@ static void periodic_mindist_plot(const char*             trxfn,
             index[ind_minj] + 1);
 }
 
+namespace
+{
+
+//! Minimum/maximum distance and contact counts accumulated over a range of \p index2 atoms
+struct DistanceRangeResult
+{
+    real rmin2 = 1e12;
+    real rmax2 = -1e12;
+    int  nmin  = 0;
+    int  nmax  = 0;
+    int  ixmin = -1;
+    int  jxmin = -1;
+    int  ixmax = -1;
+    int  jxmax = -1;
+};
+
+} // namespace
+
+//! Number of atom pairs below which calc_dist does not start an OpenMP region
+static const gmx::index c_calcDistMinPairsForThreading = 100000;
+
 static void calc_dist(real     rcut,
                       gmx_bool bPBC,
                       PbcType  pbcType,
@@ -247,20 +271,10 @@ static void calc_dist(real     rcut,
                       int*     ixmax,
                       int*     jxmax)
 {
-    int   i, j, i0 = 0, j1;
-    int   ix, jx;
+    int   j1;
     int*  index3;
-    rvec  dx;
-    real  r2, rmin2, rmax2, rcut2;
+    real  rcut2;
     t_pbc pbc;
-    int   nmin_j, nmax_j;
-
-    *ixmin = -1;
-    *jxmin = -1;
-    *ixmax = -1;
-    *jxmax = -1;
-    *nmin  = 0;
-    *nmax  = 0;
 
     rcut2 = gmx::square(rcut);
 
@@ -271,7 +285,6 @@ static void calc_dist(real     rcut,
     }
     if (index2)
     {
-        i0     = 0;
         j1     = nx2;
         index3 = index2;
     }
@@ -282,73 +295,118 @@ static void calc_dist(real     rcut,
     }
     GMX_RELEASE_ASSERT(index1 != nullptr, "Need a valid index for plotting distances");
 
-    rmin2 = 1e12;
-    rmax2 = -1e12;
+    /* The loop over j is distributed in contiguous static chunks, one per thread,
+     * and the per-thread results are merged in thread order with the same strict
+     * comparisons as the loop itself. This gives the same extrema, extremal atom
+     * pairs and counts as a serial loop, independent of the number of threads.
+     */
+    const int nthreads = (static_cast<gmx::index>(nx1) * j1 < c_calcDistMinPairsForThreading)
+                                 ? 1
+                                 : std::max(1, std::min(j1, gmx_omp_get_max_threads()));
+    std::vector<DistanceRangeResult> threadResult(nthreads);
 
-    for (j = 0; (j < j1); j++)
+#pragma omp parallel num_threads(nthreads)
     {
-        jx = index3[j];
-        if (index2 == nullptr)
-        {
-            i0 = j + 1;
-        }
-        nmin_j = 0;
-        nmax_j = 0;
-        for (i = i0; (i < nx1); i++)
+        try
         {
-            ix = index1[i];
-            if (ix != jx)
+            DistanceRangeResult& res = threadResult[gmx_omp_get_thread_num()];
+            int                  i0  = 0;
+            rvec                 dx;
+
+#pragma omp for schedule(static)
+            for (int j = 0; j < j1; j++)
             {
-                if (bPBC)
+                const int jx = index3[j];
+                if (index2 == nullptr)
                 {
-                    pbc_dx(&pbc, x[ix], x[jx], dx);
+                    i0 = j + 1;
                 }
-                else
+                int nmin_j = 0;
+                int nmax_j = 0;
+                for (int i = i0; (i < nx1); i++)
                 {
-                    rvec_sub(x[ix], x[jx], dx);
-                }
-                r2 = iprod(dx, dx);
-                if (r2 < rmin2)
-                {
-                    rmin2  = r2;
-                    *ixmin = ix;
-                    *jxmin = jx;
-                }
-                if (r2 > rmax2)
-                {
-                    rmax2  = r2;
-                    *ixmax = ix;
-                    *jxmax = jx;
+                    const int ix = index1[i];
+                    if (ix != jx)
+                    {
+                        if (bPBC)
+                        {
+                            pbc_dx(&pbc, x[ix], x[jx], dx);
+                        }
+                        else
+                        {
+                            rvec_sub(x[ix], x[jx], dx);
+                        }
+                        const real r2 = iprod(dx, dx);
+                        if (r2 < res.rmin2)
+                        {
+                            res.rmin2 = r2;
+                            res.ixmin = ix;
+                            res.jxmin = jx;
+                        }
+                        if (r2 > res.rmax2)
+                        {
+                            res.rmax2 = r2;
+                            res.ixmax = ix;
+                            res.jxmax = jx;
+                        }
+                        if (r2 <= rcut2)
+                        {
+                            nmin_j++;
+                        }
+                        else
+                        {
+                            nmax_j++;
+                        }
+                    }
                 }
-                if (r2 <= rcut2)
+                if (bGroup)
                 {
-                    nmin_j++;
+                    if (nmin_j > 0)
+                    {
+                        res.nmin++;
+                    }
+                    if (nmax_j > 0)
+                    {
+                        res.nmax++;
+                    }
                 }
                 else
                 {
-                    nmax_j++;
+                    res.nmin += nmin_j;
+                    res.nmax += nmax_j;
                 }
             }
         }
-        if (bGroup)
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
+
+    DistanceRangeResult total;
+    for (const DistanceRangeResult& res : threadResult)
+    {
+        if (res.rmin2 < total.rmin2)
         {
-            if (nmin_j > 0)
-            {
-                (*nmin)++;
-            }
-            if (nmax_j > 0)
-            {
-                (*nmax)++;
-            }
+            total.rmin2 = res.rmin2;
+            total.ixmin = res.ixmin;
+            total.jxmin = res.jxmin;
         }
-        else
+        if (res.rmax2 > total.rmax2)
         {
-            *nmin += nmin_j;
-            *nmax += nmax_j;
+            total.rmax2 = res.rmax2;
+            total.ixmax = res.ixmax;
+            total.jxmax = res.jxmax;
         }
+        total.nmin += res.nmin;
+        total.nmax += res.nmax;
     }
-    *rmin = std::sqrt(rmin2);
-    *rmax = std::sqrt(rmax2);
+
+    *ixmin = total.ixmin;
+    *jxmin = total.jxmin;
+    *ixmax = total.ixmax;
+    *jxmax = total.jxmax;
+    *nmin  = total.nmin;
+    *nmax  = total.nmax;
+    *rmin  = std::sqrt(total.rmin2);
+    *rmax  = std::sqrt(total.rmax2);
 }
 
 static void dist_plot(const char*             fn,
@@ -190,6 +190,14 @@ typedef struct
     gmx_bool** bContrib;
     real**     ztime; //!< input data z(t) as a function of time. Required to compute ACTs
 
+    /*! \brief Umbrella exponent -U/kT for each pull group and bin
+     *
+     * The umbrella potential does not change during the WHAM iterations, so it is
+     * tabulated once by setupUmbrellaFactors() instead of evaluated in every iteration.
+     */
+    double** umbrellaExponent;
+    double** boltzmannFactor; //!< exp(umbrellaExponent), Boltzmann factor of the umbrella potential
+
     /*! \brief average force estimated from average displacement, fAv=dzAv*k
      *
      *  Used for integration to guess the potential.
@@ -336,6 +344,7 @@ static t_UmbrellaWindow* initUmbrellaWindows(int nwin)
         win[i].g = win[i].tau = win[i].tausmooth = nullptr;
         win[i].bContrib                          = nullptr;
         win[i].ztime                             = nullptr;
+        win[i].umbrellaExponent = win[i].boltzmannFactor = nullptr;
         win[i].forceAv                           = nullptr;
         win[i].aver = win[i].sigma = nullptr;
         win[i].bsWeight            = nullptr;
@@ -370,6 +379,14 @@ static void freeUmbrellaWindows(t_UmbrellaWindow* win, int nwin)
                 sfree(win[i].bContrib[j]);
             }
         }
+        if (win[i].umbrellaExponent)
+        {
+            for (j = 0; j < win[i].nPull; j++)
+            {
+                sfree(win[i].umbrellaExponent[j]);
+                sfree(win[i].boltzmannFactor[j]);
+            }
+        }
         sfree(win[i].Histo);
         sfree(win[i].cum);
         sfree(win[i].k);
@@ -381,6 +398,8 @@ static void freeUmbrellaWindows(t_UmbrellaWindow* win, int nwin)
         sfree(win[i].tau);
         sfree(win[i].tausmooth);
         sfree(win[i].bContrib);
+        sfree(win[i].umbrellaExponent);
+        sfree(win[i].boltzmannFactor);
         sfree(win[i].ztime);
         sfree(win[i].forceAv);
         sfree(win[i].aver);
@@ -523,6 +542,68 @@ static double tabulated_pot(double dist, t_UmbrellaOptions* opt)
     return pl + dp;
 }
 
+/*! \brief
+ * Tabulate the umbrella exponents and Boltzmann factors of all windows
+ *
+ * Needs the final bins and, with -tab, the tabulated potential. Window positions
+ * and force constants must not change afterwards.
+ */
+static void setupUmbrellaFactors(t_UmbrellaWindow* window, int nWindows, t_UmbrellaOptions* opt)
+{
+    double min = opt->min, dz = opt->dz, ztot_half, ztot;
+
+    ztot      = opt->max - opt->min;
+    ztot_half = ztot / 2;
+
+    for (int i = 0; i < nWindows; ++i)
+    {
+        snew(window[i].umbrellaExponent, window[i].nPull);
+        snew(window[i].boltzmannFactor, window[i].nPull);
+    }
+
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < nWindows; ++i)
+    {
+        try
+        {
+            for (int j = 0; j < window[i].nPull; ++j)
+            {
+                snew(window[i].umbrellaExponent[j], opt->bins);
+                snew(window[i].boltzmannFactor[j], opt->bins);
+                for (int k = 0; k < opt->bins; ++k)
+                {
+                    double temp     = (1.0 * k + 0.5) * dz + min;
+                    double distance = temp - window[i].pos[j]; /* distance to umbrella center */
+                    double U;
+                    if (opt->bCycl)
+                    {                             /* in cyclic wham:             */
+                        if (distance > ztot_half) /*    |distance| < ztot_half   */
+                        {
+                            distance -= ztot;
+                        }
+                        else if (distance < -ztot_half)
+                        {
+                            distance += ztot;
+                        }
+                    }
+
+                    if (!opt->bTab)
+                    {
+                        U = 0.5 * window[i].k[j] * gmx::square(distance); /* harmonic potential assumed. */
+                    }
+                    else
+                    {
+                        U = tabulated_pot(distance, opt); /* Use tabulated potential     */
+                    }
+                    window[i].umbrellaExponent[j][k] = -U / (gmx::c_boltz * opt->Temperature);
+                    window[i].boltzmannFactor[j][k]  = std::exp(window[i].umbrellaExponent[j][k]);
+                }
+            }
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
+}
+
 
 /*! \brief
  * Check which bins substiantially contribute (accelerates WHAM)
@@ -534,7 +615,7 @@ static double tabulated_pot(double dist, t_UmbrellaOptions* opt)
 static void setup_acc_wham(const double* profile, t_UmbrellaWindow* window, int nWindows, t_UmbrellaOptions* opt)
 {
     int        i, j, k, nGrptot = 0, nContrib = 0, nTot = 0;
-    double     U, min = opt->min, dz = opt->dz, temp, ztot_half, distance, ztot, contrib1, contrib2;
+    double     contrib1, contrib2;
     gmx_bool   bAnyContrib;
     static int bFirst = 1;
     static double wham_contrib_lim;
@@ -548,9 +629,6 @@ static void setup_acc_wham(const double* profile, t_UmbrellaWindow* window, int
         wham_contrib_lim = opt->Tolerance / nGrptot;
     }
 
-    ztot      = opt->max - opt->min;
-    ztot_half = ztot / 2;
-
     for (i = 0; i < nWindows; ++i)
     {
         if (!window[i].bContrib)
@@ -566,37 +644,14 @@ static void setup_acc_wham(const double* profile, t_UmbrellaWindow* window, int
             bAnyContrib = FALSE;
             for (k = 0; k < opt->bins; ++k)
             {
-                temp     = (1.0 * k + 0.5) * dz + min;
-                distance = temp - window[i].pos[j]; /* distance to umbrella center */
-                if (opt->bCycl)
-                {                             /* in cyclic wham:             */
-                    if (distance > ztot_half) /*    |distance| < ztot_half   */
-                    {
-                        distance -= ztot;
-                    }
-                    else if (distance < -ztot_half)
-                    {
-                        distance += ztot;
-                    }
-                }
                 /* Note: there are two contributions to bin k in the wham equations:
                    i)  N[j]*exp(- U/(c_boltz*opt->Temperature) + window[i].z[j])
                    ii) exp(- U/(c_boltz*opt->Temperature))
                    where U is the umbrella potential
                    If any of these number is larger wham_contrib_lim, I set contrib=TRUE
                  */
-
-                if (!opt->bTab)
-                {
-                    U = 0.5 * window[i].k[j] * gmx::square(distance); /* harmonic potential assumed. */
-                }
-                else
-                {
-                    U = tabulated_pot(distance, opt); /* Use tabulated potential     */
-                }
-                contrib1 = profile[k] * std::exp(-U / (gmx::c_boltz * opt->Temperature));
-                contrib2 = window[i].N[j]
-                           * std::exp(-U / (gmx::c_boltz * opt->Temperature) + window[i].z[j]);
+                contrib1 = profile[k] * window[i].boltzmannFactor[j][k];
+                contrib2 = window[i].N[j] * std::exp(window[i].umbrellaExponent[j][k] + window[i].z[j]);
                 window[i].bContrib[j][k] = (contrib1 > wham_contrib_lim || contrib2 > wham_contrib_lim);
                 bAnyContrib              = bAnyContrib || window[i].bContrib[j][k];
                 if (window[i].bContrib[j][k])
@@ -636,11 +691,6 @@ static void setup_acc_wham(const double* profile, t_UmbrellaWindow* window, int
 //! Compute the PMF (one of the two main WHAM routines)
 static void calc_profile(double* profile, t_UmbrellaWindow* window, int nWindows, t_UmbrellaOptions* opt, gmx_bool bExact)
 {
-    double ztot_half, ztot, min = opt->min, dz = opt->dz;
-
-    ztot      = opt->max - opt->min;
-    ztot_half = ztot / 2;
-
 #pragma omp parallel
     {
         try
@@ -654,43 +704,21 @@ static void calc_profile(double* profile, t_UmbrellaWindow* window, int nWindows
             for (i = i0; i < i1; ++i)
             {
                 int    j, k;
-                double num, denom, invg, temp = 0, distance, U = 0;
+                double num, denom, invg;
                 num = denom = 0.;
                 for (j = 0; j < nWindows; ++j)
                 {
                     for (k = 0; k < window[j].nPull; ++k)
                     {
                         invg = 1.0 / window[j].g[k] * window[j].bsWeight[k];
-                        temp = (1.0 * i + 0.5) * dz + min;
                         num += invg * window[j].Histo[k][i];
 
                         if (!(bExact || window[j].bContrib[k][i]))
                         {
                             continue;
                         }
-                        distance = temp - window[j].pos[k]; /* distance to umbrella center */
-                        if (opt->bCycl)
-                        {                             /* in cyclic wham:             */
-                            if (distance > ztot_half) /*    |distance| < ztot_half   */
-                            {
-                                distance -= ztot;
-                            }
-                            else if (distance < -ztot_half)
-                            {
-                                distance += ztot;
-                            }
-                        }
-
-                        if (!opt->bTab)
-                        {
-                            U = 0.5 * window[j].k[k] * gmx::square(distance); /* harmonic potential assumed. */
-                        }
-                        else
-                        {
-                            U = tabulated_pot(distance, opt); /* Use tabulated potential     */
-                        }
                         denom += invg * window[j].N[k]
-                                 * std::exp(-U / (gmx::c_boltz * opt->Temperature) + window[j].z[k]);
+                                 * std::exp(window[j].umbrellaExponent[k][i] + window[j].z[k]);
                     }
                 }
                 profile[i] = num / denom;
@@ -701,14 +729,10 @@ static void calc_profile(double* profile, t_UmbrellaWindow* window, int nWindows
 }
 
 //! Compute the free energy offsets z (one of the two main WHAM routines)
-static double calc_z(const double* profile, t_UmbrellaWindow* window, int nWindows, t_UmbrellaOptions* opt, gmx_bool bExact)
+static double calc_z(const double* profile, t_UmbrellaWindow* window, int nWindows, gmx_bool bExact)
 {
-    double min = opt->min, dz = opt->dz, ztot_half, ztot;
     double maxglob = -1e20;
 
-    ztot      = opt->max - opt->min;
-    ztot_half = ztot / 2;
-
 #pragma omp parallel
     {
         try
@@ -722,7 +746,7 @@ static double calc_z(const double* profile, t_UmbrellaWindow* window, int nWindo
 
             for (i = i0; i < i1; ++i)
             {
-                double total = 0, temp, distance, U = 0;
+                double total = 0, temp;
                 int    j, k;
 
                 for (j = 0; j < window[i].nPull; ++j)
@@ -734,29 +758,7 @@ static double calc_z(const double* profile, t_UmbrellaWindow* window, int nWindo
                         {
                             continue;
                         }
-                        temp     = (1.0 * k + 0.5) * dz + min;
-                        distance = temp - window[i].pos[j]; /* distance to umbrella center */
-                        if (opt->bCycl)
-                        {                             /* in cyclic wham:             */
-                            if (distance > ztot_half) /*    |distance| < ztot_half   */
-                            {
-                                distance -= ztot;
-                            }
-                            else if (distance < -ztot_half)
-                            {
-                                distance += ztot;
-                            }
-                        }
-
-                        if (!opt->bTab)
-                        {
-                            U = 0.5 * window[i].k[j] * gmx::square(distance); /* harmonic potential assumed. */
-                        }
-                        else
-                        {
-                            U = tabulated_pot(distance, opt); /* Use tabulated potential     */
-                        }
-                        total += profile[k] * std::exp(-U / (gmx::c_boltz * opt->Temperature));
+                        total += profile[k] * window[i].boltzmannFactor[j][k];
                     }
                     /* Avoid floating point exception if window is far outside min and max */
                     if (total != 0.0)
@@ -950,6 +952,9 @@ static void copy_pullgrp_to_synthwindow(t_UmbrellaWindow* synthWindow, t_Umbrell
     synthWindow->bContrib[0] = thisWindow->bContrib[pullid];
     synthWindow->g[0]        = thisWindow->g[pullid];
     synthWindow->bsWeight[0] = thisWindow->bsWeight[pullid];
+
+    synthWindow->umbrellaExponent[0] = thisWindow->umbrellaExponent[pullid];
+    synthWindow->boltzmannFactor[0]  = thisWindow->boltzmannFactor[pullid];
 }
 
 /*! \brief Calculate cumulative distribution function of of all histograms.
@@ -1103,6 +1108,9 @@ static void create_synthetic_histo(t_UmbrellaWindow*  synthWindow,
     synthWindow->g[0]        = thisWindow->g[pullid];
     synthWindow->bsWeight[0] = thisWindow->bsWeight[pullid];
 
+    synthWindow->umbrellaExponent[0] = thisWindow->umbrellaExponent[pullid];
+    synthWindow->boltzmannFactor[0]  = thisWindow->boltzmannFactor[pullid];
+
     for (i = 0; i < nbins; i++)
     {
         synthWindow->Histo[0][i] = 0.;
@@ -1341,6 +1349,8 @@ static void do_bootstrapping(const char*        fnres,
         snew(synthWindow[i].z, 1);
         snew(synthWindow[i].k, 1);
         snew(synthWindow[i].bContrib, 1);
+        snew(synthWindow[i].umbrellaExponent, 1);
+        snew(synthWindow[i].boltzmannFactor, 1);
         snew(synthWindow[i].g, 1);
         snew(synthWindow[i].bsWeight, 1);
     }
@@ -1431,7 +1441,7 @@ static void do_bootstrapping(const char*        fnres,
             }
             calc_profile(bsProfile, synthWindow, nAllPull, opt, bExact);
             i++;
-        } while ((maxchange = calc_z(bsProfile, synthWindow, nAllPull, opt, bExact)) > opt->Tolerance
+        } while ((maxchange = calc_z(bsProfile, synthWindow, nAllPull, bExact)) > opt->Tolerance
                  || !bExact);
         printf("\tConverged in %d iterations. Final maximum change %g\n", i, maxchange);
 
@@ -1551,7 +1561,7 @@ static void read_tpr_header(const char* fn, t_UmbrellaHeader* header, t_Umbrella
     static int  first = 1;
 
     /* printf("Reading %s \n",fn); */
-    read_tpx_state(fn, ir, &state, nullptr);
+    read_tpx_state_no_broadcast(fn, ir, &state, nullptr);
 
     if (!ir->bPull)
     {
@@ -2740,7 +2750,7 @@ static void guessPotByIntegration(t_UmbrellaWindow* window, int nWindows, t_Umbr
     {
         pot[j] = std::exp(-pot[j] / (gmx::c_boltz * opt->Temperature));
     }
-    calc_z(pot, window, nWindows, opt, TRUE);
+    calc_z(pot, window, nWindows, TRUE);
 
     sfree(pot);
     sfree(f);
@@ -3319,6 +3329,9 @@ int gmx_wham(int argc, char* argv[])
         averageSigma(window, nwins);
     }
 
+    /* The umbrella potentials are fixed from here on, tabulate them for the WHAM iterations */
+    setupUmbrellaFactors(window, nwins, &opt);
+
     /* Get initial potential by simple integration */
     if (opt.bInitPotByIntegration)
     {
@@ -3353,7 +3366,7 @@ int gmx_wham(int argc, char* argv[])
             printf("\t%4d) Maximum change %e\n", i, maxchange);
         }
         i++;
-    } while ((maxchange = calc_z(profile, window, nwins, &opt, bExact)) > opt.Tolerance || !bExact);
+    } while ((maxchange = calc_z(profile, window, nwins, bExact)) > opt.Tolerance || !bExact);
     printf("Converged in %d iterations. Final maximum change %g\n", i, maxchange);
 
     /* calc error from Kumar's formula */
@@ -42,6 +42,8 @@
 #include <cmath>
 #include <cstring>
 
+#include <vector>
+
 #include "gromacs/math/vec.h"
 #include "gromacs/random/threefry.h"
 #include "gromacs/random/uniformintdistribution.h"
@@ -231,6 +233,16 @@ gmx_radial_distribution_histogram_t* calc_radial_distribution_histogram(gmx_sans
 
     snew(pr->gr, pr->grn);
 
+    /* gather the group coordinates and scattering lengths, so the pair loops
+     * below access contiguous memory instead of going through index */
+    std::vector<gmx::RVec> xGroup(isize);
+    std::vector<double>    slength(isize);
+    for (i = 0; i < isize; i++)
+    {
+        copy_rvec(x[index[i]], xGroup[i]);
+        slength[i] = gsans->slength[index[i]];
+    }
+
     if (bMC)
     {
         /* Special case for setting automaticaly number of mc iterations to 1% of total number of direct iterations */
@@ -251,7 +263,7 @@ gmx_radial_distribution_histogram_t* calc_radial_distribution_histogram(gmx_sans
             snew(tgr[i], pr->grn);
             trng[i].seed(rng());
         }
-#    pragma omp parallel shared(tgr, trng) private(tid, i, j)
+#    pragma omp parallel shared(tgr, trng, xGroup, slength) private(tid, i, j)
         {
             gmx::UniformIntDistribution<int> tdist(0, isize - 1);
             tid = gmx_omp_get_thread_num();
@@ -265,8 +277,8 @@ gmx_radial_distribution_histogram_t* calc_radial_distribution_histogram(gmx_sans
                     j = tdist(trng[tid]); // [0,isize-1]
                     if (i != j)
                     {
-                        tgr[tid][static_cast<int>(std::floor(std::sqrt(distance2(x[index[i]], x[index[j]])) / binwidth))] +=
-                                gsans->slength[index[i]] * gsans->slength[index[j]];
+                        tgr[tid][static_cast<int>(std::floor(std::sqrt(distance2(xGroup[i], xGroup[j])) / binwidth))] +=
+                                slength[i] * slength[j];
                     }
                 }
                 GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
@@ -295,8 +307,8 @@ gmx_radial_distribution_histogram_t* calc_radial_distribution_histogram(gmx_sans
             j = dist(rng); // [0,isize-1]
             if (i != j)
             {
-                pr->gr[static_cast<int>(std::floor(std::sqrt(distance2(x[index[i]], x[index[j]])) / binwidth))] +=
-                        gsans->slength[index[i]] * gsans->slength[index[j]];
+                pr->gr[static_cast<int>(std::floor(std::sqrt(distance2(xGroup[i], xGroup[j])) / binwidth))] +=
+                        slength[i] * slength[j];
             }
         }
 #endif
@@ -311,19 +323,19 @@ gmx_radial_distribution_histogram_t* calc_radial_distribution_histogram(gmx_sans
         {
             snew(tgr[i], pr->grn);
         }
-#    pragma omp parallel shared(tgr) private(tid, i, j)
+#    pragma omp parallel shared(tgr, xGroup, slength) private(tid, i, j)
         {
             tid = gmx_omp_get_thread_num();
-/* starting parallel threads */
-#    pragma omp for
+/* starting parallel threads, the work per i grows with i */
+#    pragma omp for schedule(dynamic, 16)
             for (i = 0; i < isize; i++)
             {
                 try
                 {
                     for (j = 0; j < i; j++)
                     {
-                        tgr[tid][static_cast<int>(std::floor(std::sqrt(distance2(x[index[i]], x[index[j]])) / binwidth))] +=
-                                gsans->slength[index[i]] * gsans->slength[index[j]];
+                        tgr[tid][static_cast<int>(std::floor(std::sqrt(distance2(xGroup[i], xGroup[j])) / binwidth))] +=
+                                slength[i] * slength[j];
                     }
                 }
                 GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
@@ -348,8 +360,8 @@ gmx_radial_distribution_histogram_t* calc_radial_distribution_histogram(gmx_sans
         {
             for (j = 0; j < i; j++)
             {
-                pr->gr[static_cast<int>(std::floor(std::sqrt(distance2(x[index[i]], x[index[j]])) / binwidth))] +=
-                        gsans->slength[index[i]] * gsans->slength[index[j]];
+                pr->gr[static_cast<int>(std::floor(std::sqrt(distance2(xGroup[i], xGroup[j])) / binwidth))] +=
+                        slength[i] * slength[j];
             }
         }
 #endif
@@ -69,25 +69,21 @@
 struct ScalarDataTypes
 {
     using RealType = real; //!< The data type to use as real.
-    using IntType  = int;  //!< The data type to use as int.
     using BoolType = bool; //!< The data type to use as bool for real value comparison.
     static constexpr int simdRealWidth = 1; //!< The width of the RealType.
-    static constexpr int simdIntWidth  = 1; //!< The width of the IntType.
 };
 
-#if GMX_SIMD_HAVE_REAL && GMX_SIMD_HAVE_INT32_ARITHMETICS
-//! SIMD data types.
+#if GMX_SIMD_HAVE_REAL
+/*! \brief SIMD data types.
+ *
+ * Only SIMD real operations are used, integer data is handled in the scalar
+ * pre-loading of the j-atom data, so this works with all SIMD setups.
+ */
 struct SimdDataTypes
 {
-    using RealType = gmx::SimdReal;  //!< The data type to use as real.
-    using IntType  = gmx::SimdInt32; //!< The data type to use as int.
-    using BoolType = gmx::SimdBool;  //!< The data type to use as bool for real value comparison.
+    using RealType = gmx::SimdReal; //!< The data type to use as real.
+    using BoolType = gmx::SimdBool; //!< The data type to use as bool for real value comparison.
     static constexpr int simdRealWidth = GMX_SIMD_REAL_WIDTH; //!< The width of the RealType.
-#    if GMX_SIMD_HAVE_DOUBLE && GMX_DOUBLE
-    static constexpr int simdIntWidth = GMX_SIMD_DINT32_WIDTH; //!< The width of the IntType.
-#    else
-    static constexpr int simdIntWidth = GMX_SIMD_FINT32_WIDTH; //!< The width of the IntType.
-#    endif
 };
 #endif
 
@@ -285,7 +281,6 @@ static void nb_free_energy_kernel(const t_nblist&
 #define NSTATES 2
 
     using RealType = typename DataTypes::RealType;
-    using IntType  = typename DataTypes::IntType;
     using BoolType = typename DataTypes::BoolType;
 
     constexpr real oneTwelfth = 1.0_real / 12.0_real;
@@ -484,7 +479,6 @@ static void nb_free_energy_kernel(const t_nblist&
             preloadIi[i] = ii;
             preloadIs[i] = shift[n];
         }
-        IntType ii_s = gmx::load<IntType>(preloadIi);
 
         for (int k = nj0; k < nj1; k += DataTypes::simdRealWidth)
         {
@@ -494,6 +488,7 @@ static void nb_free_energy_kernel(const t_nblist&
             alignas(GMX_SIMD_ALIGNMENT) real    preloadPairIsValid[DataTypes::simdRealWidth];
             alignas(GMX_SIMD_ALIGNMENT) real    preloadPairIncluded[DataTypes::simdRealWidth];
             alignas(GMX_SIMD_ALIGNMENT) int32_t preloadJnr[DataTypes::simdRealWidth];
+            alignas(GMX_SIMD_ALIGNMENT) real    preloadIiEqJnr[DataTypes::simdRealWidth];
             alignas(GMX_SIMD_ALIGNMENT) int32_t typeIndices[NSTATES][DataTypes::simdRealWidth];
             alignas(GMX_SIMD_ALIGNMENT) real    preloadQq[NSTATES][DataTypes::simdRealWidth];
             alignas(GMX_SIMD_ALIGNMENT) real gmx_unused preloadSigma6[NSTATES][DataTypes::simdRealWidth];
@@ -510,6 +505,7 @@ static void nb_free_energy_kernel(const t_nblist&
             real            preloadPairIsValid[DataTypes::simdRealWidth];
             real            preloadPairIncluded[DataTypes::simdRealWidth];
             int             preloadJnr[DataTypes::simdRealWidth];
+            real            preloadIiEqJnr[DataTypes::simdRealWidth];
             int             typeIndices[NSTATES][DataTypes::simdRealWidth];
             real            preloadQq[NSTATES][DataTypes::simdRealWidth];
             real gmx_unused preloadSigma6[NSTATES][DataTypes::simdRealWidth];
@@ -633,6 +629,14 @@ static void nb_free_energy_kernel(const t_nblist&
                 }
             }
 
+            /* Flag self-interactions, which only occur with excluded pairs,
+             * here to avoid the need for SIMD integer comparisons.
+             */
+            for (int j = 0; j < DataTypes::simdRealWidth; j++)
+            {
+                preloadIiEqJnr[j] = (preloadJnr[j] == ii ? 1.0_real : 0.0_real);
+            }
+
             RealType jx, jy, jz;
             gmx::gatherLoadUTranspose<3>(reinterpret_cast<const real*>(x), preloadJnr, &jx, &jy, &jz);
 
@@ -670,8 +674,7 @@ static void nb_free_energy_kernel(const t_nblist&
                 haveExcludedPairsBeyondRlist = true;
             }
 
-            const IntType  jnr_s    = gmx::load<IntType>(preloadJnr);
-            const BoolType bIiEqJnr = gmx::cvtIB2B(ii_s == jnr_s);
+            const BoolType bIiEqJnr = (gmx::load<RealType>(preloadIiEqJnr) != zero);
 
             RealType            c6[NSTATES];
             RealType            c12[NSTATES];
@@ -1183,7 +1186,7 @@ static KernelFunction dispatchKernelOnUseSimd(const bool useSimd)
 {
     if (useSimd)
     {
-#if GMX_SIMD_HAVE_REAL && GMX_SIMD_HAVE_INT32_ARITHMETICS && GMX_USE_SIMD_KERNELS
+#if GMX_SIMD_HAVE_REAL && GMX_USE_SIMD_KERNELS
         return (nb_free_energy_kernel<SimdDataTypes, softcoreType, scLambdasOrAlphasDiffer, vdwInteractionTypeIsEwald, elecInteractionTypeIsEwald, vdwModifierIsPotSwitch, computeForces>);
 #else
         return (nb_free_energy_kernel<ScalarDataTypes, softcoreType, scLambdasOrAlphasDiffer, vdwInteractionTypeIsEwald, elecInteractionTypeIsEwald, vdwModifierIsPotSwitch, computeForces>);
@@ -55,6 +55,7 @@
 #include "gromacs/pbcutil/pbc.h"
 #include "gromacs/random/threefry.h"
 #include "gromacs/random/uniformintdistribution.h"
+#include "gromacs/selection/nbsearch.h"
 #include "gromacs/topology/index.h"
 #include "gromacs/topology/topology.h"
 #include "gromacs/utility/arrayref.h"
@@ -99,6 +100,49 @@ static bool groupsCloserThanCutoffWithPbc(t_pbc*                   pbc,
     return false;
 }
 
+/*! \brief Return whether a solvent molecule is below minimum distance of non-solvent atoms.
+ *
+ * The non-solvent atoms present at the start are looked up with a grid
+ * search, the ions placed so far are checked directly.
+ *
+ * \param[in] notSolventSearch neighborhood search over the initial non-solvent
+ *                             atoms, with a cutoff of at least \p minimumDistance
+ * \param[in] pbc the periodic boundary conditions
+ * \param[in] x the coordinates
+ * \param[in] moleculeIndices the atom indices of the solvent molecule
+ * \param[in] ionIndices the atom indices of the ions placed so far
+ * \param[in] minimumDistance the minimum required distance
+ * \returns true if any atom of the molecule is closer than \p minimumDistance
+ *               to a non-solvent atom or ion.
+ */
+static bool moleculeCloserThanCutoffToNotSolvent(
+        const gmx::AnalysisNeighborhoodSearch& notSolventSearch,
+        t_pbc*                                 pbc,
+        rvec                                   x[],
+        gmx::ArrayRef<const int>               moleculeIndices,
+        gmx::ArrayRef<const int>               ionIndices,
+        real                                   minimumDistance)
+{
+    const real             minimumDistance2 = minimumDistance * minimumDistance;
+    std::vector<gmx::RVec> moleculeX;
+    moleculeX.reserve(moleculeIndices.size());
+    for (int index : moleculeIndices)
+    {
+        moleculeX.emplace_back(x[index]);
+    }
+    gmx::AnalysisNeighborhoodPairSearch pairSearch =
+            notSolventSearch.startPairSearch(gmx::AnalysisNeighborhoodPositions(moleculeX));
+    gmx::AnalysisNeighborhoodPair pair;
+    while (pairSearch.findNextPair(&pair))
+    {
+        if (pair.distance2() < minimumDistance2)
+        {
+            return true;
+        }
+    }
+    return groupsCloserThanCutoffWithPbc(pbc, x, moleculeIndices, ionIndices, minimumDistance);
+}
+
 /*! \brief Calculate the solvent molecule atom indices from molecule number.
  *
  * \note the solvent group index has to be continuous
@@ -122,18 +166,19 @@ static std::vector<int> solventMoleculeIndices(int solventMoleculeNumber,
     return indices;
 }
 
-static void insert_ion(int                      nsa,
-                       std::vector<int>*        solventMoleculesForReplacement,
-                       int                      repl[],
-                       gmx::ArrayRef<const int> index,
-                       rvec                     x[],
-                       t_pbc*                   pbc,
-                       int                      sign,
-                       int                      q,
-                       const char*              ionname,
-                       t_atoms*                 atoms,
-                       real                     rmin,
-                       std::vector<int>*        notSolventGroup)
+static void insert_ion(int                                    nsa,
+                       std::vector<int>*                      solventMoleculesForReplacement,
+                       int                                    repl[],
+                       gmx::ArrayRef<const int>               index,
+                       rvec                                   x[],
+                       t_pbc*                                 pbc,
+                       int                                    sign,
+                       int                                    q,
+                       const char*                            ionname,
+                       t_atoms*                               atoms,
+                       real                                   rmin,
+                       const gmx::AnalysisNeighborhoodSearch& notSolventSearch,
+                       std::vector<int>*                      ionAtoms)
 {
     std::vector<int> solventMoleculeAtomsToBeReplaced =
             solventMoleculeIndices(solventMoleculesForReplacement->back(), nsa, index);
@@ -141,7 +186,8 @@ static void insert_ion(int                      nsa,
     if (rmin > 0.0)
     {
         // check for proximity to non-solvent
-        while (groupsCloserThanCutoffWithPbc(pbc, x, solventMoleculeAtomsToBeReplaced, *notSolventGroup, rmin)
+        while (moleculeCloserThanCutoffToNotSolvent(
+                       notSolventSearch, pbc, x, solventMoleculeAtomsToBeReplaced, *ionAtoms, rmin)
                && !solventMoleculesForReplacement->empty())
         {
             solventMoleculesForReplacement->pop_back();
@@ -162,7 +208,7 @@ static void insert_ion(int                      nsa,
             ionname);
 
     /* Replace solvent molecule charges with ion charge */
-    notSolventGroup->push_back(solventMoleculeAtomsToBeReplaced[0]);
+    ionAtoms->push_back(solventMoleculeAtomsToBeReplaced[0]);
     repl[solventMoleculesForReplacement->back()] = sign;
 
     // The first solvent molecule atom is replaced with an ion and the respective
@@ -651,7 +697,21 @@ int gmx_genion(int argc, char* argv[])
         fprintf(stderr, "Using random seed %d.\n", seed);
 
 
-        std::vector<int> notSolventGroup = invertIndexGroup(atoms.nr, solventGroup);
+        // Grid search over the non-solvent atoms for the -rmin check, the
+        // ions are added to a separate list as they are placed.
+        std::vector<gmx::RVec>          notSolventX;
+        gmx::AnalysisNeighborhoodSearch notSolventSearch;
+        gmx::AnalysisNeighborhood       nb;
+        std::vector<int>                ionAtoms;
+        if (rmin > 0.0)
+        {
+            for (int i : invertIndexGroup(atoms.nr, solventGroup))
+            {
+                notSolventX.emplace_back(x[i]);
+            }
+            nb.setCutoff(rmin);
+            notSolventSearch = nb.initSearch(&pbc, gmx::AnalysisNeighborhoodPositions(notSolventX));
+        }
 
         std::vector<int> solventMoleculesForReplacement(nw);
         std::iota(std::begin(solventMoleculesForReplacement), std::end(solventMoleculesForReplacement), 0);
@@ -665,13 +725,35 @@ int gmx_genion(int argc, char* argv[])
         /* Now loop over the ions that have to be placed */
         while (p_num-- > 0)
         {
-            insert_ion(
-                    nsa, &solventMoleculesForReplacement, repl, solventGroup, x, &pbc, 1, p_q, p_name, &atoms, rmin, &notSolventGroup);
+            insert_ion(nsa,
+                       &solventMoleculesForReplacement,
+                       repl,
+                       solventGroup,
+                       x,
+                       &pbc,
+                       1,
+                       p_q,
+                       p_name,
+                       &atoms,
+                       rmin,
+                       notSolventSearch,
+                       &ionAtoms);
         }
         while (n_num-- > 0)
         {
-            insert_ion(
-                    nsa, &solventMoleculesForReplacement, repl, solventGroup, x, &pbc, -1, n_q, n_name, &atoms, rmin, &notSolventGroup);
+            insert_ion(nsa,
+                       &solventMoleculesForReplacement,
+                       repl,
+                       solventGroup,
+                       x,
+                       &pbc,
+                       -1,
+                       n_q,
+                       n_name,
+                       &atoms,
+                       rmin,
+                       notSolventSearch,
+                       &ionAtoms);
         }
         fprintf(stderr, "\n");
 
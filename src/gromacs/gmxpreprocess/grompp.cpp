@@ -462,16 +462,43 @@ static void check_bonds_timestep(const gmx_mtop_t* mtop, double dt, warninp* wi)
     }
 }
 
+//! Returns whether \p atom is a particle without mass, whose velocity should be zero
+static bool isMasslessParticle(const t_atom& atom)
+{
+    return atom.ptype == ParticleType::Shell || atom.ptype == ParticleType::Bond
+           || atom.ptype == ParticleType::VSite;
+}
+
 static void check_vel(gmx_mtop_t* mtop, rvec v[])
 {
-    for (const AtomProxy atomP : AtomRange(*mtop))
+    /* Work per molecule type, so blocks of molecules without shells or
+     * virtual sites, e.g. solvent, do not need to be looped over.
+     */
+    std::vector<int> masslessAtoms;
+    for (size_t mb = 0; mb < mtop->molblock.size(); mb++)
     {
-        const t_atom& local = atomP.atom();
-        int           i     = atomP.globalAtomNumber();
-        if (local.ptype == ParticleType::Shell || local.ptype == ParticleType::Bond
-            || local.ptype == ParticleType::VSite)
+        const gmx_molblock_t& molb  = mtop->molblock[mb];
+        const t_atoms&        atoms = mtop->moltype[molb.type].atoms;
+        masslessAtoms.clear();
+        for (int a = 0; a < atoms.nr; a++)
+        {
+            if (isMasslessParticle(atoms.atom[a]))
+            {
+                masslessAtoms.push_back(a);
+            }
+        }
+        if (masslessAtoms.empty())
+        {
+            continue;
+        }
+        const MoleculeBlockIndices& indices = mtop->moleculeBlockIndices[mb];
+        for (int mol = 0; mol < molb.nmol; mol++)
         {
-            clear_rvec(v[i]);
+            const int offset = indices.globalAtomStart + mol * indices.numAtomsPerMolecule;
+            for (int a : masslessAtoms)
+            {
+                clear_rvec(v[offset + a]);
+            }
         }
     }
 }
@@ -480,13 +507,19 @@ static void check_shells_inputrec(gmx_mtop_t* mtop, t_inputrec* ir, warninp* wi)
 {
     int nshells = 0;
 
-    for (const AtomProxy atomP : AtomRange(*mtop))
+    for (const gmx_molblock_t& molb : mtop->molblock)
     {
-        const t_atom& local = atomP.atom();
-        if (local.ptype == ParticleType::Shell || local.ptype == ParticleType::Bond)
+        const t_atoms& atoms         = mtop->moltype[molb.type].atoms;
+        int            nshellsPerMol = 0;
+        for (int a = 0; a < atoms.nr; a++)
         {
-            nshells++;
+            const ParticleType ptype = atoms.atom[a].ptype;
+            if (ptype == ParticleType::Shell || ptype == ParticleType::Bond)
+            {
+                nshellsPerMol++;
+            }
         }
+        nshells += molb.nmol * nshellsPerMol;
     }
     if ((nshells > 0) && (ir->nstcalcenergy != 1))
     {
@@ -245,6 +245,11 @@ static void insert_mols(int                  nmol_insrt,
 
     std::vector<RVec> x_n(x_insrt.size());
 
+    // The search over the current atoms only changes when a molecule is
+    // inserted, so it is not rebuilt for the trials that fail.
+    gmx::AnalysisNeighborhoodSearch search;
+    bool                            searchIsCurrent = false;
+
     int                                mol        = 0;
     int                                trial      = 0;
     int                                firstTrial = 0;
@@ -285,8 +290,12 @@ static void insert_mols(int                  nmol_insrt,
         fflush(stderr);
 
         generate_trial_conf(x_insrt, offset_x, enum_rot, &rng, &x_n);
-        gmx::AnalysisNeighborhoodPositions pos(*x);
-        gmx::AnalysisNeighborhoodSearch    search = nb.initSearch(&pbc, pos);
+        if (!searchIsCurrent)
+        {
+            search.reset();
+            search          = nb.initSearch(&pbc, gmx::AnalysisNeighborhoodPositions(*x));
+            searchIsCurrent = true;
+        }
         if (isInsertionAllowed(
                     &search, exclusionDistances, x_n, exclusionDistances_insrt, *atoms, removableAtoms, &remover))
         {
@@ -295,6 +304,7 @@ static void insert_mols(int                  nmol_insrt,
                                       exclusionDistances_insrt.begin(),
                                       exclusionDistances_insrt.end());
             builder.mergeAtoms(atoms_insrt);
+            searchIsCurrent = false;
             ++mol;
             firstTrial = trial;
             fprintf(stderr, " success (now %d atoms)!\n", builder.currentAtomCount());
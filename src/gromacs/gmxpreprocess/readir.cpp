@@ -351,10 +351,31 @@ void check_ir(const char*                    mdparin,
             }
         }
 
-        if (!(ir->vdwtype == VanDerWaalsType::Cut || ir->vdwtype == VanDerWaalsType::Pme))
+        if (!(ir->vdwtype == VanDerWaalsType::Cut || ir->vdwtype == VanDerWaalsType::Pme
+              || ir->vdwtype == VanDerWaalsType::User))
         {
             warning_error(wi,
-                          "With Verlet lists only cut-off and PME LJ interactions are supported");
+                          "With Verlet lists only cut-off, PME and user LJ interactions are "
+                          "supported");
+        }
+        if (ir->vdwtype == VanDerWaalsType::User)
+        {
+            if (ir->efep != FreeEnergyPerturbationType::No)
+            {
+                warning_error(wi,
+                              "With Verlet lists user VdW tables are not supported with free-energy "
+                              "calculations");
+            }
+            if (!(ir->vdw_modifier == InteractionModifiers::None
+                  || ir->vdw_modifier == InteractionModifiers::PotShift))
+            {
+                sprintf(warn_buf,
+                        "With vdwtype = %s, vdw_modifier=%s is not supported, the table should "
+                        "contain the modified interaction",
+                        enumValueToString(ir->vdwtype),
+                        enumValueToString(ir->vdw_modifier));
+                warning_error(wi, warn_buf);
+            }
         }
         if (!(ir->coulombtype == CoulombInteractionType::Cut || EEL_RF(ir->coulombtype)
               || EEL_PME(ir->coulombtype) || ir->coulombtype == CoulombInteractionType::Ewald))
@@ -48,7 +48,10 @@
 
 #include "config.h"
 
+#include <cstdint>
+
 #include <memory>
+#include <vector>
 
 #if GMX_GPU_CUDA
 #    include <cuda_runtime.h>
@@ -123,6 +126,19 @@ private:
     cudaStream_t stream_ = nullptr;
 #elif GMX_GPU_HIP
 
+    /*! \brief Construct a stream whose kernels only run on the compute units in \p computeUnitMask
+     *
+     * Such a stream has normal priority, as the HIP runtime does not
+     * combine compute-unit masks with stream priorities.
+     *
+     * \param[in] deviceContext    Device context (not used in HIP).
+     * \param[in] computeUnitMask  Bit \c i of word \c i/32 enables compute unit \c i.
+     * \param[in] useTiming        If the timing should be enabled (not used in HIP).
+     */
+    DeviceStream(const DeviceContext&         deviceContext,
+                 const std::vector<uint32_t>& computeUnitMask,
+                 bool                         useTiming);
+
     //! Getter
     hipStream_t stream() const;
 
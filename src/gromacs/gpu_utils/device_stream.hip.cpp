@@ -77,6 +77,19 @@ DeviceStream::DeviceStream(const DeviceContext& /* deviceContext */,
     stream_pointer_[0] = stream_;
 }
 
+DeviceStream::DeviceStream(const DeviceContext& /* deviceContext */,
+                           const std::vector<uint32_t>& computeUnitMask,
+                           const bool /* useTiming */)
+{
+    stream_pointer_ = new hipStream_t[1];
+
+    hipError_t stat =
+            hipExtStreamCreateWithCUMask(&stream_, computeUnitMask.size(), computeUnitMask.data());
+    gmx::checkDeviceError(stat, "Could not create HIP stream with a compute-unit mask.");
+
+    stream_pointer_[0] = stream_;
+}
+
 DeviceStream::~DeviceStream()
 {
     if (isValid())
@@ -45,8 +45,16 @@
 
 #include "device_stream_manager.h"
 
+#include "config.h"
+
+#include <cmath>
+#include <cstdlib>
+
+#include <algorithm>
+
 #include "gromacs/gpu_utils/device_context.h"
 #include "gromacs/gpu_utils/device_stream.h"
+#include "gromacs/hardware/device_information.h"
 #include "gromacs/mdtypes/simulation_workload.h"
 #include "gromacs/utility/enumerationhelpers.h"
 #include "gromacs/utility/exceptions.h"
@@ -56,6 +64,51 @@
 namespace gmx
 {
 
+std::vector<uint32_t> makeComputeUnitMask(int numComputeUnits, int begin, int end)
+{
+    GMX_RELEASE_ASSERT(0 <= begin && begin <= end && end <= numComputeUnits,
+                       "The compute-unit range should be within the device");
+
+    std::vector<uint32_t> mask((numComputeUnits + 31) / 32, 0);
+    for (int cu = begin; cu < end; cu++)
+    {
+        mask[cu / 32] |= (1U << (cu % 32));
+    }
+    return mask;
+}
+
+#if GMX_GPU_HIP
+
+namespace
+{
+
+/*! \brief Returns the fraction of compute units to reserve for PME on a GPU shared with PP work
+ *
+ * Set by the environment variable GMX_HIP_PME_CU_FRACTION, returns 0 when not set.
+ *
+ * \throws InvalidInputError  When the value is not a number between 0 and 1.
+ */
+double pmeComputeUnitFraction()
+{
+    const char* env = std::getenv("GMX_HIP_PME_CU_FRACTION");
+    if (env == nullptr)
+    {
+        return 0;
+    }
+    char*        end      = nullptr;
+    const double fraction = std::strtod(env, &end);
+    if (end == env || *end != '\0' || !(fraction > 0 && fraction < 1))
+    {
+        GMX_THROW(InvalidInputError(formatString(
+                "GMX_HIP_PME_CU_FRACTION should be a number between 0 and 1, not '%s'", env)));
+    }
+    return fraction;
+}
+
+} // namespace
+
+#endif
+
 /*! \libinternal
  * \brief Impl class to manages the lifetime of the GPU streams.
  *
@@ -94,11 +147,41 @@ DeviceStreamManager::Impl::Impl(const DeviceInformation& deviceInfo,
 {
     try
     {
-	if (hasPP)
-        streams_[DeviceStreamType::NonBondedLocal] =
-                std::make_unique<DeviceStream>(context_, DeviceStreamPriority::Normal, useTiming);
+#if GMX_GPU_HIP
+        /* When PME and PP work share the GPU, the PME kernels compete for
+         * compute units with the local non-bonded kernel. On request we
+         * reserve the last compute units for PME and run the local
+         * non-bonded stream on the others.
+         */
+        const double pmeFraction = (simulationWork.useGpuPme && hasPme && hasPP)
+                                           ? pmeComputeUnitFraction()
+                                           : 0;
+        if (pmeFraction > 0)
+        {
+            const int numComputeUnits = deviceInfo.prop.multiProcessorCount;
+            const int numPmeComputeUnits =
+                    std::clamp(static_cast<int>(std::lround(pmeFraction * numComputeUnits)),
+                               1,
+                               numComputeUnits - 1);
+            const int firstPmeComputeUnit              = numComputeUnits - numPmeComputeUnits;
+            streams_[DeviceStreamType::NonBondedLocal] = std::make_unique<DeviceStream>(
+                    context_,
+                    makeComputeUnitMask(numComputeUnits, 0, firstPmeComputeUnit),
+                    useTiming);
+            streams_[DeviceStreamType::Pme] = std::make_unique<DeviceStream>(
+                    context_,
+                    makeComputeUnitMask(numComputeUnits, firstPmeComputeUnit, numComputeUnits),
+                    useTiming);
+        }
+#endif
+
+        if (hasPP && !streams_[DeviceStreamType::NonBondedLocal])
+        {
+            streams_[DeviceStreamType::NonBondedLocal] = std::make_unique<DeviceStream>(
+                    context_, DeviceStreamPriority::Normal, useTiming);
+        }
 
-        if (simulationWork.useGpuPme && hasPme)
+        if (simulationWork.useGpuPme && hasPme && !streams_[DeviceStreamType::Pme])
         {
             /* Creating a PME GPU stream:
              * - default high priority with CUDA
@@ -46,8 +46,11 @@
 #ifndef GMX_GPU_UTILS_GPUSTREAMMANAGER_H
 #define GMX_GPU_UTILS_GPUSTREAMMANAGER_H
 
+#include <cstdint>
+
 #include <memory>
 #include <string>
+#include <vector>
 
 class DeviceContext;
 struct DeviceInformation;
@@ -143,6 +146,14 @@ private:
     std::unique_ptr<Impl> impl_;
 };
 
+/*! \brief Returns a compute-unit mask that enables compute units \p begin up to \p end
+ *
+ * Bit \c i of word \c i/32 of the mask enables compute unit \c i, as
+ * used by \c hipExtStreamCreateWithCUMask. The mask has enough words for
+ * \p numComputeUnits compute units.
+ */
+std::vector<uint32_t> makeComputeUnitMask(int numComputeUnits, int begin, int end);
+
 } // namespace gmx
 
 #endif
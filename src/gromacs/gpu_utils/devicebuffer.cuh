@@ -50,6 +50,7 @@
 #include "gromacs/gpu_utils/device_context.h"
 #include "gromacs/gpu_utils/device_stream.h"
 #include "gromacs/gpu_utils/devicebuffer_datatype.h"
+#include "gromacs/gpu_utils/devicememorypool.h"
 #include "gromacs/gpu_utils/gpu_utils.h" //only for GpuApiCallBehavior
 #include "gromacs/gpu_utils/gputraits.cuh"
 #include "gromacs/utility/gmxassert.h"
@@ -58,6 +59,7 @@
 /*! \brief
  * Allocates a device-side buffer.
  * It is currently a caller's responsibility to call it only on not-yet allocated buffers.
+ * The memory comes from the device buffer memory pool when that is enabled.
  *
  * \tparam        ValueType            Raw value type of the \p buffer.
  * \param[in,out] buffer               Pointer to the device-side buffer.
@@ -68,6 +70,14 @@ template<typename ValueType>
 void allocateDeviceBuffer(DeviceBuffer<ValueType>* buffer, size_t numValues, const DeviceContext& /* deviceContext */)
 {
     GMX_ASSERT(buffer, "needs a buffer pointer");
+    gmx::DeviceMemoryPool* pool = gmx::deviceBufferMemoryPool();
+    if (pool != nullptr)
+    {
+        *buffer = static_cast<ValueType*>(pool->allocate(numValues * sizeof(ValueType)));
+        GMX_RELEASE_ASSERT(*buffer != nullptr || numValues == 0,
+                           "Allocation of the device buffer from the memory pool failed.");
+        return;
+    }
     cudaError_t stat = cudaMalloc(buffer, numValues * sizeof(ValueType));
     GMX_RELEASE_ASSERT(
             stat == cudaSuccess,
@@ -88,6 +98,12 @@ void freeDeviceBuffer(DeviceBuffer* buffer)
     GMX_ASSERT(buffer, "needs a buffer pointer");
     if (*buffer)
     {
+        gmx::DeviceMemoryPool* pool = gmx::deviceBufferMemoryPool();
+        if (pool != nullptr)
+        {
+            pool->deallocate(*buffer);
+            return;
+        }
         cudaError_t stat = cudaFree(*buffer);
         GMX_RELEASE_ASSERT(
                 stat == cudaSuccess,
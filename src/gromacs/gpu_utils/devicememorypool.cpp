@@ -0,0 +1,193 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief Implements gmx::DeviceMemoryPool.
+ *
+ * \ingroup module_gpu_utils
+ */
+#include "gmxpre.h"
+
+#include "devicememorypool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "gromacs/utility/gmxassert.h"
+
+namespace gmx
+{
+
+namespace
+{
+
+//! The smallest block size, matches the alignment of the device runtimes
+constexpr size_t c_minBlockSize = 256;
+//! The number of size classes per power of two
+constexpr size_t c_sizeClassesPerOctave = 4;
+
+} // namespace
+
+DeviceMemoryPool::DeviceMemoryPool(Backend backend) : backend_(std::move(backend))
+{
+    GMX_RELEASE_ASSERT(backend_.allocate && backend_.free,
+                       "The allocate and free backend functions should be set");
+    GMX_RELEASE_ASSERT(bool(backend_.recordMarker) == bool(backend_.waitForMarker),
+                       "The marker backend functions should be set together");
+}
+
+DeviceMemoryPool::~DeviceMemoryPool()
+{
+    releaseCachedBlocksLocked();
+}
+
+size_t DeviceMemoryPool::sizeClass(size_t numBytes)
+{
+    if (numBytes <= c_minBlockSize)
+    {
+        return c_minBlockSize;
+    }
+    size_t powerOfTwo = c_minBlockSize;
+    while (powerOfTwo * 2 <= numBytes)
+    {
+        powerOfTwo *= 2;
+    }
+    const size_t step = powerOfTwo / c_sizeClassesPerOctave;
+
+    return (numBytes + step - 1) / step * step;
+}
+
+void* DeviceMemoryPool::allocate(size_t numBytes)
+{
+    if (numBytes == 0)
+    {
+        return nullptr;
+    }
+
+    const size_t blockSize = sizeClass(numBytes);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    void* pointer = nullptr;
+    auto  freeBlocks = freeBlocks_.find(blockSize);
+    if (freeBlocks != freeBlocks_.end() && !freeBlocks->second.empty())
+    {
+        const FreeBlock freeBlock = freeBlocks->second.back();
+        freeBlocks->second.pop_back();
+        if (freeBlock.marker != nullptr)
+        {
+            backend_.waitForMarker(freeBlock.marker);
+        }
+        pointer = freeBlock.pointer;
+        statistics_.bytesCached -= blockSize;
+        statistics_.numReusedAllocations++;
+    }
+    else
+    {
+        pointer = backend_.allocate(blockSize);
+        if (pointer == nullptr && statistics_.bytesCached > 0)
+        {
+            releaseCachedBlocksLocked();
+            pointer = backend_.allocate(blockSize);
+        }
+        if (pointer == nullptr)
+        {
+            return nullptr;
+        }
+        statistics_.numBackendAllocations++;
+    }
+
+    blocksInUse_[pointer] = blockSize;
+    statistics_.bytesInUse += blockSize;
+    statistics_.highWaterMark = std::max(statistics_.highWaterMark, statistics_.bytesInUse);
+
+    return pointer;
+}
+
+void DeviceMemoryPool::deallocate(void* pointer)
+{
+    if (pointer == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto block = blocksInUse_.find(pointer);
+    if (block == blocksInUse_.end())
+    {
+        backend_.free(pointer);
+        return;
+    }
+    const size_t blockSize = block->second;
+    blocksInUse_.erase(block);
+
+    void* marker = backend_.recordMarker ? backend_.recordMarker() : nullptr;
+    freeBlocks_[blockSize].push_back({ pointer, marker });
+    statistics_.bytesInUse -= blockSize;
+    statistics_.bytesCached += blockSize;
+}
+
+void DeviceMemoryPool::releaseCachedBlocks()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    releaseCachedBlocksLocked();
+}
+
+void DeviceMemoryPool::releaseCachedBlocksLocked()
+{
+    for (auto& freeBlocks : freeBlocks_)
+    {
+        for (const FreeBlock& freeBlock : freeBlocks.second)
+        {
+            if (freeBlock.marker != nullptr)
+            {
+                backend_.waitForMarker(freeBlock.marker);
+            }
+            backend_.free(freeBlock.pointer);
+        }
+    }
+    freeBlocks_.clear();
+    statistics_.bytesCached = 0;
+}
+
+DeviceMemoryPool::Statistics DeviceMemoryPool::statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return statistics_;
+}
+
+} // namespace gmx
@@ -0,0 +1,195 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \libinternal \file
+ * \brief Declares gmx::DeviceMemoryPool, a caching allocator for device buffers
+ * and pinned host buffers.
+ *
+ * Allocating and freeing device memory with the runtime API is expensive
+ * and synchronizes the device, and so is pinning and unpinning host memory.
+ * Such buffers are reallocated during a run, e.g. after domain decomposition
+ * repartitioning and when pairlists grow. The pool keeps freed blocks in
+ * size classes and returns them for later allocations of the same class.
+ *
+ * \inlibraryapi
+ * \ingroup module_gpu_utils
+ */
+#ifndef GMX_GPU_UTILS_DEVICEMEMORYPOOL_H
+#define GMX_GPU_UTILS_DEVICEMEMORYPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "gromacs/gpu_utils/gpu_macros.h"
+
+namespace gmx
+{
+
+class MDLogger;
+
+/*! \libinternal \brief
+ * Caching allocator for memory from a GPU runtime, with blocks binned by size class
+ *
+ * Freed blocks are not returned to the runtime, but kept for reuse by
+ * allocations of the same size class. Size classes have four bins per
+ * power of two, so at most a quarter of a block is unused.
+ *
+ * A freed block might still be accessed by work that is enqueued in any
+ * stream. When the backend provides markers, a marker is recorded when
+ * a block is freed and the pool waits for it before the block is handed
+ * out again. The wait is thus only for the work that was enqueued before
+ * the free, which has normally completed by then, instead of for all
+ * work on the device.
+ *
+ * When the backend runs out of memory, all cached blocks are released
+ * and the allocation is retried.
+ *
+ * All methods are thread safe, so thread-MPI ranks can share a pool.
+ */
+class DeviceMemoryPool
+{
+public:
+    //! The runtime calls the pool is built on
+    struct Backend
+    {
+        //! Allocates device memory, returns nullptr on failure
+        std::function<void*(size_t)> allocate;
+        //! Frees device memory
+        std::function<void(void*)> free;
+        /*! \brief Returns a marker for the completion of the work enqueued so far
+         *
+         * Optional, should be set together with \p waitForMarker.
+         */
+        std::function<void*()> recordMarker;
+        //! Waits for completion of, and releases, a marker returned by \p recordMarker
+        std::function<void(void*)> waitForMarker;
+    };
+
+    //! Usage statistics of the pool, all sizes in bytes
+    struct Statistics
+    {
+        //! The size of all blocks handed out and not yet freed
+        size_t bytesInUse = 0;
+        //! The maximum of bytesInUse
+        size_t highWaterMark = 0;
+        //! The size of all free blocks kept for reuse
+        size_t bytesCached = 0;
+        //! The number of allocations that called the backend
+        int64_t numBackendAllocations = 0;
+        //! The number of allocations that reused a cached block
+        int64_t numReusedAllocations = 0;
+    };
+
+    //! Constructs an empty pool on \p backend
+    explicit DeviceMemoryPool(Backend backend);
+    //! Frees all cached blocks, blocks still in use are left to the caller
+    ~DeviceMemoryPool();
+
+    DeviceMemoryPool(const DeviceMemoryPool&) = delete;
+    DeviceMemoryPool& operator=(const DeviceMemoryPool&) = delete;
+
+    /*! \brief Returns a block of at least \p numBytes bytes
+     *
+     * Returns nullptr for zero bytes and when the backend fails to
+     * allocate, also after releasing the cache.
+     */
+    void* allocate(size_t numBytes);
+    /*! \brief Returns \p pointer to the pool
+     *
+     *  A nullptr is ignored. Pointers not allocated by this pool are
+     *  freed by the backend directly.
+     */
+    void deallocate(void* pointer);
+    //! Frees all cached blocks with the backend
+    void releaseCachedBlocks();
+    //! Returns the usage statistics
+    Statistics statistics() const;
+
+    //! Returns the size of the blocks used for allocations of \p numBytes bytes
+    static size_t sizeClass(size_t numBytes);
+
+private:
+    //! A freed block with the marker recorded when it was freed
+    struct FreeBlock
+    {
+        //! The block
+        void* pointer;
+        //! The marker to wait for before reuse, nullptr when there is none
+        void* marker;
+    };
+
+    //! Frees all cached blocks, the mutex should be locked
+    void releaseCachedBlocksLocked();
+
+    //! Protects all data below
+    mutable std::mutex mutex_;
+    //! The runtime calls
+    Backend backend_;
+    //! Free blocks per size class
+    std::map<size_t, std::vector<FreeBlock>> freeBlocks_;
+    //! The size class of each block in use
+    std::unordered_map<void*, size_t> blocksInUse_;
+    //! The usage statistics
+    Statistics statistics_;
+};
+
+/*! \brief Returns the pool for device buffers on the current device
+ *
+ * The pool is experimental and only used when the environment variable
+ * GMX_GPU_MEMORY_POOL is set. Returns nullptr otherwise and in builds
+ * without CUDA or HIP.
+ */
+CUDA_FUNC_QUALIFIER
+DeviceMemoryPool* deviceBufferMemoryPool() CUDA_FUNC_TERM_WITH_RETURN(nullptr);
+
+/*! \brief Frees the cached blocks of, and destroys, the pool of the current device
+ *
+ * Should be called before the device is reset.
+ */
+CUDA_FUNC_QUALIFIER
+void releaseDeviceBufferMemoryPool() CUDA_FUNC_TERM;
+
+//! Logs the statistics of the pool of the current device, when there is one
+CUDA_FUNC_QUALIFIER
+void logDeviceBufferMemoryPoolUsage(const MDLogger& CUDA_FUNC_ARGUMENT(mdlog)) CUDA_FUNC_TERM;
+
+} // namespace gmx
+
+#endif
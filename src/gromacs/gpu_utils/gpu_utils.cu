@@ -47,11 +47,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 #include <cuda_profiler_api.h>
 
 #include "gromacs/gpu_utils/cudautils.cuh"
 #include "gromacs/gpu_utils/device_context.h"
 #include "gromacs/gpu_utils/device_stream.h"
+#include "gromacs/gpu_utils/devicememorypool.h"
 #include "gromacs/hardware/device_information.h"
 #include "gromacs/hardware/device_management.h"
 #include "gromacs/utility/basedefinitions.h"
@@ -261,3 +266,138 @@ void setupGpuDevicePeerAccess(const std::vector<int>& gpuIdsToUse, const gmx::MD
         GMX_LOG(mdlog.info).asParagraph().appendTextFormatted("%s", message.c_str());
     }
 }
+
+namespace gmx
+{
+
+namespace
+{
+
+//! Protects the device buffer memory pools
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::mutex g_deviceBufferMemoryPoolMutex;
+
+/*! \brief Returns the device buffer memory pools, indexed by device ID
+ *
+ * The pools are never destroyed at exit, as the runtime might already
+ * have been shut down then.
+ */
+std::map<int, std::unique_ptr<DeviceMemoryPool>>& deviceBufferMemoryPools()
+{
+    static auto* pools = new std::map<int, std::unique_ptr<DeviceMemoryPool>>;
+    return *pools;
+}
+
+//! Returns the CUDA runtime calls for a memory pool
+DeviceMemoryPool::Backend cudaMemoryPoolBackend()
+{
+    DeviceMemoryPool::Backend backend;
+    backend.allocate = [](size_t numBytes) -> void* {
+        void*       pointer = nullptr;
+        cudaError_t stat    = cudaMalloc(&pointer, numBytes);
+        if (stat != cudaSuccess)
+        {
+            // Clear the error, so the allocation can be retried
+            cudaGetLastError();
+            return nullptr;
+        }
+        return pointer;
+    };
+    backend.free = [](void* pointer) {
+        cudaError_t stat = cudaFree(pointer);
+        GMX_RELEASE_ASSERT(
+                stat == cudaSuccess,
+                ("Freeing of the device buffer failed. " + getDeviceErrorString(stat)).c_str());
+    };
+    backend.recordMarker = []() -> void* {
+        /* An event in the legacy default stream completes after all work
+         * enqueued before it in the blocking streams that DeviceStream creates.
+         * This orders reuse of the block without blocking the host.
+         */
+        cudaEvent_t event = nullptr;
+        cudaError_t stat  = cudaEventCreateWithFlags(&event, cudaEventDisableTiming);
+        GMX_RELEASE_ASSERT(
+                stat == cudaSuccess,
+                ("Creating a memory pool event failed. " + getDeviceErrorString(stat)).c_str());
+        stat = cudaEventRecord(event, cudaStreamLegacy);
+        GMX_RELEASE_ASSERT(
+                stat == cudaSuccess,
+                ("Recording a memory pool event failed. " + getDeviceErrorString(stat)).c_str());
+        return event;
+    };
+    backend.waitForMarker = [](void* marker) {
+        cudaEvent_t event = static_cast<cudaEvent_t>(marker);
+        cudaError_t stat  = cudaEventSynchronize(event);
+        GMX_RELEASE_ASSERT(
+                stat == cudaSuccess,
+                ("Waiting for a memory pool event failed. " + getDeviceErrorString(stat)).c_str());
+        stat = cudaEventDestroy(event);
+        GMX_RELEASE_ASSERT(
+                stat == cudaSuccess,
+                ("Destroying a memory pool event failed. " + getDeviceErrorString(stat)).c_str());
+    };
+    return backend;
+}
+
+//! Returns the ID of the current device
+int currentDeviceId()
+{
+    int         deviceId = -1;
+    cudaError_t stat     = cudaGetDevice(&deviceId);
+    GMX_RELEASE_ASSERT(stat == cudaSuccess,
+                       ("cudaGetDevice failed. " + getDeviceErrorString(stat)).c_str());
+    return deviceId;
+}
+
+} // namespace
+
+DeviceMemoryPool* deviceBufferMemoryPool()
+{
+    static const bool s_usePool = (getenv("GMX_GPU_MEMORY_POOL") != nullptr);
+    if (!s_usePool)
+    {
+        return nullptr;
+    }
+
+    const int                   deviceId = currentDeviceId();
+    std::lock_guard<std::mutex> lock(g_deviceBufferMemoryPoolMutex);
+    auto&                       pool = deviceBufferMemoryPools()[deviceId];
+    if (!pool)
+    {
+        pool = std::make_unique<DeviceMemoryPool>(cudaMemoryPoolBackend());
+    }
+    return pool.get();
+}
+
+void releaseDeviceBufferMemoryPool()
+{
+    const int                   deviceId = currentDeviceId();
+    std::lock_guard<std::mutex> lock(g_deviceBufferMemoryPoolMutex);
+    deviceBufferMemoryPools().erase(deviceId);
+}
+
+void logDeviceBufferMemoryPoolUsage(const MDLogger& mdlog)
+{
+    const int                   deviceId = currentDeviceId();
+    std::lock_guard<std::mutex> lock(g_deviceBufferMemoryPoolMutex);
+    const auto                  pool = deviceBufferMemoryPools().find(deviceId);
+    if (pool == deviceBufferMemoryPools().end())
+    {
+        return;
+    }
+
+    const DeviceMemoryPool::Statistics statistics = pool->second->statistics();
+    constexpr double                   c_bytesToMiB = 1.0 / (1024 * 1024);
+    GMX_LOG(mdlog.info)
+            .asParagraph()
+            .appendTextFormatted(
+                    "Device buffer memory pool on GPU #%d: high-water mark %.1f MiB, "
+                    "%.1f MiB cached, %ld runtime allocations, %ld reused allocations",
+                    deviceId,
+                    statistics.highWaterMark * c_bytesToMiB,
+                    statistics.bytesCached * c_bytesToMiB,
+                    static_cast<long>(statistics.numBackendAllocations),
+                    static_cast<long>(statistics.numReusedAllocations));
+}
+
+} // namespace gmx
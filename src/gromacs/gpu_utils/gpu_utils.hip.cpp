@@ -47,6 +47,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 #include <hip/hip_profile.h>
 #ifdef GMX_USE_ROCTX
 #include <roctx.h>
@@ -55,6 +59,7 @@
 #include "gromacs/gpu_utils/hiputils.hpp"
 #include "gromacs/gpu_utils/device_context.h"
 #include "gromacs/gpu_utils/device_stream.h"
+#include "gromacs/gpu_utils/devicememorypool.h"
 #include "gromacs/hardware/device_information.h"
 #include "gromacs/hardware/device_management.h"
 #include "gromacs/utility/basedefinitions.h"
@@ -269,6 +274,141 @@ void setupGpuDevicePeerAccess(const std::vector<int>& gpuIdsToUse, const gmx::MD
     }
 }
 
+namespace gmx
+{
+
+namespace
+{
+
+//! Protects the device buffer memory pools
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::mutex g_deviceBufferMemoryPoolMutex;
+
+/*! \brief Returns the device buffer memory pools, indexed by device ID
+ *
+ * The pools are never destroyed at exit, as the runtime might already
+ * have been shut down then.
+ */
+std::map<int, std::unique_ptr<DeviceMemoryPool>>& deviceBufferMemoryPools()
+{
+    static auto* pools = new std::map<int, std::unique_ptr<DeviceMemoryPool>>;
+    return *pools;
+}
+
+//! Returns the HIP runtime calls for a memory pool
+DeviceMemoryPool::Backend hipMemoryPoolBackend()
+{
+    DeviceMemoryPool::Backend backend;
+    backend.allocate = [](size_t numBytes) -> void* {
+        void*      pointer = nullptr;
+        hipError_t stat    = hipMalloc(&pointer, numBytes);
+        if (stat != hipSuccess)
+        {
+            // Clear the error, so the allocation can be retried
+            hipGetLastError();
+            return nullptr;
+        }
+        return pointer;
+    };
+    backend.free = [](void* pointer) {
+        hipError_t stat = hipFree(pointer);
+        GMX_RELEASE_ASSERT(
+                stat == hipSuccess,
+                ("Freeing of the device buffer failed. " + getDeviceErrorString(stat)).c_str());
+    };
+    backend.recordMarker = []() -> void* {
+        /* An event in the legacy default stream completes after all work
+         * enqueued before it in the blocking streams that DeviceStream creates.
+         * This orders reuse of the block without blocking the host.
+         */
+        hipEvent_t event = nullptr;
+        hipError_t stat  = hipEventCreateWithFlags(&event, hipEventDisableTiming);
+        GMX_RELEASE_ASSERT(
+                stat == hipSuccess,
+                ("Creating a memory pool event failed. " + getDeviceErrorString(stat)).c_str());
+        stat = hipEventRecord(event, nullptr);
+        GMX_RELEASE_ASSERT(
+                stat == hipSuccess,
+                ("Recording a memory pool event failed. " + getDeviceErrorString(stat)).c_str());
+        return event;
+    };
+    backend.waitForMarker = [](void* marker) {
+        hipEvent_t event = static_cast<hipEvent_t>(marker);
+        hipError_t stat  = hipEventSynchronize(event);
+        GMX_RELEASE_ASSERT(
+                stat == hipSuccess,
+                ("Waiting for a memory pool event failed. " + getDeviceErrorString(stat)).c_str());
+        stat = hipEventDestroy(event);
+        GMX_RELEASE_ASSERT(
+                stat == hipSuccess,
+                ("Destroying a memory pool event failed. " + getDeviceErrorString(stat)).c_str());
+    };
+    return backend;
+}
+
+//! Returns the ID of the current device
+int currentDeviceId()
+{
+    int        deviceId = -1;
+    hipError_t stat     = hipGetDevice(&deviceId);
+    GMX_RELEASE_ASSERT(stat == hipSuccess,
+                       ("hipGetDevice failed. " + getDeviceErrorString(stat)).c_str());
+    return deviceId;
+}
+
+} // namespace
+
+DeviceMemoryPool* deviceBufferMemoryPool()
+{
+    static const bool s_usePool = (getenv("GMX_GPU_MEMORY_POOL") != nullptr);
+    if (!s_usePool)
+    {
+        return nullptr;
+    }
+
+    const int                   deviceId = currentDeviceId();
+    std::lock_guard<std::mutex> lock(g_deviceBufferMemoryPoolMutex);
+    auto&                       pool = deviceBufferMemoryPools()[deviceId];
+    if (!pool)
+    {
+        pool = std::make_unique<DeviceMemoryPool>(hipMemoryPoolBackend());
+    }
+    return pool.get();
+}
+
+void releaseDeviceBufferMemoryPool()
+{
+    const int                   deviceId = currentDeviceId();
+    std::lock_guard<std::mutex> lock(g_deviceBufferMemoryPoolMutex);
+    deviceBufferMemoryPools().erase(deviceId);
+}
+
+void logDeviceBufferMemoryPoolUsage(const MDLogger& mdlog)
+{
+    const int                   deviceId = currentDeviceId();
+    std::lock_guard<std::mutex> lock(g_deviceBufferMemoryPoolMutex);
+    const auto                  pool = deviceBufferMemoryPools().find(deviceId);
+    if (pool == deviceBufferMemoryPools().end())
+    {
+        return;
+    }
+
+    const DeviceMemoryPool::Statistics statistics = pool->second->statistics();
+    constexpr double                   c_bytesToMiB = 1.0 / (1024 * 1024);
+    GMX_LOG(mdlog.info)
+            .asParagraph()
+            .appendTextFormatted(
+                    "Device buffer memory pool on GPU #%d: high-water mark %.1f MiB, "
+                    "%.1f MiB cached, %ld runtime allocations, %ld reused allocations",
+                    deviceId,
+                    statistics.highWaterMark * c_bytesToMiB,
+                    statistics.bytesCached * c_bytesToMiB,
+                    static_cast<long>(statistics.numBackendAllocations),
+                    static_cast<long>(statistics.numReusedAllocations));
+}
+
+} // namespace gmx
+
 void hipRangePush(const char* msg){
 #ifdef GMX_USE_ROCTX
     roctxRangePush(msg);
@@ -44,8 +44,11 @@
 
 #include <cstddef>
 
+#include <algorithm>
+#include <exception>
 #include <memory>
 
+#include "gromacs/gpu_utils/devicememorypool.h"
 #include "gromacs/gpu_utils/gpu_utils.h"
 #include "gromacs/gpu_utils/pinning.h"
 #include "gromacs/utility/alignedallocator.h"
@@ -70,6 +73,21 @@ void* HostAllocationPolicy::malloc(std::size_t bytes) const noexcept
 {
     if (pinningPolicy_ == PinningPolicy::PinnedIfSupported)
     {
+        DeviceMemoryPool* pool = pinnedHostMemoryPool();
+        if (pool != nullptr)
+        {
+            /* The pool returns blocks that are already page aligned
+             * and pinned. A non-null pointer is also needed for
+             * 0 bytes, so we ask for at least one byte. */
+            try
+            {
+                return pool->allocate(std::max<std::size_t>(bytes, 1));
+            }
+            catch (const std::exception&)
+            {
+                return nullptr;
+            }
+        }
         void* p = PageAlignedAllocationPolicy::malloc(bytes);
         if (p)
         {
@@ -104,6 +122,10 @@ void HostAllocationPolicy::free(void* buffer) const noexcept
     }
     if (pinningPolicy_ == PinningPolicy::PinnedIfSupported)
     {
+        if (returnToPinnedHostMemoryPool(buffer))
+        {
+            return;
+        }
         unpinBuffer(buffer);
         PageAlignedAllocationPolicy::free(buffer);
     }
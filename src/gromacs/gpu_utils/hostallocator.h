@@ -117,6 +117,10 @@ using PaddedHostVector = PaddedVector<T, HostAllocator<T>>;
  * build, and silently do nothing otherwise. In future, we may modify
  * or generalize this to work differently in other cases.
  *
+ * With CUDA and HIP, pinned memory is taken from pinnedHostMemoryPool(),
+ * which keeps freed buffers pinned for reuse, so resizing buffers during
+ * a run does not repeatedly pin and unpin memory.
+ *
  * The intended use is to configure gmx::Allocator with this class as
  * its policy class, and then to use e.g.
  * std::vector::get_allocator().getPolicy() to control whether the
@@ -49,6 +49,8 @@
 #include <assert.h>
 
 #include <cctype>
+#include <cinttypes>
+#include <cstdint>
 #include <cstdio>
 
 #include <algorithm>
@@ -57,10 +59,12 @@
 #include <string>
 #include <vector>
 
+#include "gromacs/utility/baseversion.h"
 #include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/programcontext.h"
 #include "gromacs/utility/smalloc.h"
 #include "gromacs/utility/stringutil.h"
+#include "gromacs/utility/sysinfo.h"
 #include "gromacs/utility/textreader.h"
 #include "gromacs/utility/unique_cptr.h"
 
@@ -69,19 +73,47 @@ namespace gmx
 namespace ocl
 {
 
-std::string makeBinaryCacheFilename(const std::string& kernelFilename, cl_device_id deviceId)
+/*! \brief Returns a string from the OpenCL device info query \p paramName
+ *
+ * \throws InternalError  if an OpenCL error was encountered
+ */
+static std::string getDeviceInfoString(cl_device_id deviceId, cl_device_info paramName)
 {
     // Note that the OpenCL API is defined in terms of bytes, and we
     // assume that sizeof(char) is one byte.
-    std::array<char, 1024> deviceName;
-    size_t                 deviceNameLength;
-    cl_int                 cl_error = clGetDeviceInfo(
-            deviceId, CL_DEVICE_NAME, deviceName.size(), deviceName.data(), &deviceNameLength);
+    std::array<char, 1024> buffer;
+    size_t                 length;
+    cl_int cl_error = clGetDeviceInfo(deviceId, paramName, buffer.size(), buffer.data(), &length);
     if (cl_error != CL_SUCCESS)
     {
-        GMX_THROW(InternalError(formatString("Could not get OpenCL device name, error was %s",
+        GMX_THROW(InternalError(formatString("Could not get OpenCL device info, error was %s",
                                              ocl_get_error_string(cl_error).c_str())));
     }
+    // The returned length includes the terminating null character
+    return std::string(buffer.data(), std::max<size_t>(length, 1) - 1);
+}
+
+/*! \brief Returns the 64-bit FNV-1a hash of \p text
+ *
+ * Unlike std::hash, this is stable between runs and builds.
+ */
+static uint64_t fnv1aHash(const std::string& text)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char c : text)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::string makeBinaryCacheFilename(const std::string& kernelFilename,
+                                    const std::string& buildOptions,
+                                    cl_device_id       deviceId)
+{
+    const std::string deviceName    = getDeviceInfoString(deviceId, CL_DEVICE_NAME);
+    const std::string driverVersion = getDeviceInfoString(deviceId, CL_DRIVER_VERSION);
 
     std::string cacheFilename = "OCL-cache";
     /* remove the kernel source suffix */
@@ -94,11 +126,12 @@ std::string makeBinaryCacheFilename(const std::string& kernelFilename, cl_device
        (symbols), by permitting only alphanumeric characters from the
        current locale. We assume these work well enough in a
        filename. */
-    std::copy_if(deviceName.begin(),
-                 deviceName.begin() + deviceNameLength,
-                 std::back_inserter(cacheFilename),
-                 isalnum);
-    cacheFilename += ".bin";
+    std::copy_if(deviceName.begin(), deviceName.end(), std::back_inserter(cacheFilename), isalnum);
+    /* A binary can only be reused when it was built from the same
+       code with the same options by the same driver. */
+    const uint64_t buildHash = fnv1aHash(std::string(gmx_version()) + '\n' + driverVersion + '\n'
+                                         + deviceName + '\n' + buildOptions);
+    cacheFilename += formatString("_%016" PRIx64 ".bin", buildHash);
 
     return cacheFilename;
 }
@@ -127,12 +160,8 @@ cl_program makeProgramFromCache(const std::string& filename, cl_context context,
         GMX_THROW(FileIOError("Failed to read binary cache file " + filename));
     }
 
-    /* TODO If/when caching is re-enabled, compare current build
-     * options and code against the build options and the code
-     * corresponding to the cache. If any change is detected then the
-     * cache cannot be used.
-     *
-     * Also caching functionality will need full re-testing. */
+    /* The build options, driver and code version are part of the
+     * file name, so a cache file that exists matches this build. */
 
     /* Create program from pre-built binary */
     cl_int     cl_error;
@@ -170,13 +199,27 @@ void writeBinaryToCache(cl_program program, const std::string& filename)
                                 + ocl_get_error_string(cl_error)));
     }
 
-    const auto f = create_unique_with_deleter(fopen(filename.c_str(), "wb"), fclose);
-    if (!f)
+    /* Write to a file unique to this process and rename it afterwards,
+     * so concurrent ranks never see a partially written cache file. */
+    const std::string tempFilename = formatString("%s.%d.tmp", filename.c_str(), gmx_getpid());
     {
-        GMX_THROW(FileIOError("Failed to open binary cache file " + filename));
+        const auto f = create_unique_with_deleter(fopen(tempFilename.c_str(), "wb"), fclose);
+        if (!f)
+        {
+            GMX_THROW(FileIOError("Failed to open binary cache file " + tempFilename));
+        }
+
+        if (fwrite(binary, 1, fileSize, f.get()) != fileSize)
+        {
+            std::remove(tempFilename.c_str());
+            GMX_THROW(FileIOError("Failed to write binary cache file " + tempFilename));
+        }
+    }
+    if (std::rename(tempFilename.c_str(), filename.c_str()) != 0)
+    {
+        std::remove(tempFilename.c_str());
+        GMX_THROW(FileIOError("Failed to rename binary cache file to " + filename));
     }
-
-    fwrite(binary, 1, fileSize, f.get());
 }
 
 } // namespace ocl
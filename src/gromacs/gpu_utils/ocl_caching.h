@@ -37,7 +37,7 @@
  *  \brief Declare infrastructure for managing caching of OpenCL
  *  JIT-ted binaries
  *
- *  This functionality is currently disabled in compileProgram()
+ *  This functionality is disabled by default in compileProgram()
  *
  *  \author Dimitrios Karkoulis <dimitris.karkoulis@gmail.com>
  *  \author Anca Hamuraru <anca@streamcomputing.eu>
@@ -57,20 +57,20 @@ namespace ocl
 {
 
 /*! \brief Construct the name for the binary cache file
+ *
+ * The name contains a hash of the build options, the device driver
+ * version and the GROMACS version, so that a binary cache file is only
+ * reused for identical builds of the kernel.
  *
  * \param[in]  kernelFilename  Name of the kernel from which the binary will be compiled.
+ * \param[in]  buildOptions    The options the binary is built with.
  * \param[in]  deviceId        ID of the device upon which the binary is used.
  *
- * \todo The set of preprocessor options should also form part of the
- * identification of the cached binary. Also perhaps compiler, runtime
- * and device version info?
- *
- * \todo Mutual exclusion of ranks and nodes should also be implemented
- * if/when caching is re-enabled.
- *
  * \returns The name of the cache file.
  */
-std::string makeBinaryCacheFilename(const std::string& kernelFilename, cl_device_id deviceId);
+std::string makeBinaryCacheFilename(const std::string& kernelFilename,
+                                    const std::string& buildOptions,
+                                    cl_device_id       deviceId);
 
 /*! \brief Check if there's a valid cache available, and return it if so
  *
@@ -86,6 +86,10 @@ std::string makeBinaryCacheFilename(const std::string& kernelFilename, cl_device
 cl_program makeProgramFromCache(const std::string& filename, cl_context context, cl_device_id deviceId);
 
 /*! \brief Implement caching of OpenCL binaries
+ *
+ * The binary is first written to a file unique to this process, which
+ * is then renamed to \p filename, so concurrent ranks never read a
+ * partially written cache file.
  *
  * \param[in] program     Index of program to cache
  * \param[in] filename    Name of file to use for the cache
@@ -74,8 +74,8 @@ namespace ocl
 
 /*! \brief True if OpenCL binary caching is enabled.
  *
- *  Currently caching is disabled by default unless the env var override
- *  is used until we resolve concurrency issues. */
+ *  Caching is disabled by default unless the env var override is used,
+ *  as the cache files are written to the working directory. */
 static bool useBuildCache = getenv("GMX_OCL_GENCACHE") != nullptr;
 
 /*! \brief Handles writing the OpenCL JIT compilation log to \c fplog.
@@ -431,7 +431,7 @@ cl_program compileProgram(FILE*              fplog,
     std::string cacheFilename;
     if (useBuildCache)
     {
-        cacheFilename = makeBinaryCacheFilename(kernelBaseFilename, deviceId);
+        cacheFilename = makeBinaryCacheFilename(kernelBaseFilename, preprocessorOptions, deviceId);
     }
 
     /* Create OpenCL program */
@@ -43,10 +43,16 @@
 #include "pinning.h"
 
 #include <cstddef>
+#include <cstdlib>
 
 #include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "gromacs/gpu_utils/cudautils.cuh"
+#include "gromacs/gpu_utils/devicememorypool.h"
 #include "gromacs/utility/alignedallocator.h"
 #include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/gmxassert.h"
@@ -123,4 +129,146 @@ void unpinBuffer(void* pointer) noexcept
     GMX_RELEASE_ASSERT(stat == cudaSuccess, (errorMessage + getDeviceErrorString(stat)).c_str());
 }
 
+namespace
+{
+
+//! Protects the pinned host memory pools
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::mutex g_pinnedHostMemoryPoolMutex;
+
+/*! \brief Returns the pinned host memory pools, indexed by device ID
+ *
+ * The pools are never destroyed at exit, as the runtime might already
+ * have been shut down then.
+ */
+std::map<int, std::unique_ptr<DeviceMemoryPool>>& pinnedHostMemoryPools()
+{
+    static auto* pools = new std::map<int, std::unique_ptr<DeviceMemoryPool>>;
+    return *pools;
+}
+
+//! Protects the owners of the pinned host memory pool blocks
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::mutex g_pinnedHostBlockOwnerMutex;
+
+/*! \brief Returns the device ID of the pool that allocated each block, cached or in use
+ *
+ * With multiple devices the current device can differ between allocating
+ * and freeing a buffer, so the owning pool is recorded per block.
+ */
+std::unordered_map<void*, int>& pinnedHostBlockOwners()
+{
+    static auto* owners = new std::unordered_map<void*, int>;
+    return *owners;
+}
+
+//! Unpins and frees \p pointer and forgets its owner
+void unpinAndFreePinnedHostBlock(void* pointer)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_pinnedHostBlockOwnerMutex);
+        pinnedHostBlockOwners().erase(pointer);
+    }
+    unpinBuffer(pointer);
+    PageAlignedAllocationPolicy::free(pointer);
+}
+
+/*! \brief Returns the calls that allocate and pin, and unpin and free, host memory
+ * for the pool of device \p deviceId
+ *
+ * The host might overwrite a reused buffer while a transfer from it
+ * that was enqueued before it was freed is still running. Unpinning
+ * and freeing did not prevent that either, as the memory could then be
+ * handed out again by the system allocator, so no synchronization is
+ * done.
+ */
+DeviceMemoryPool::Backend pinnedHostMemoryPoolBackend(int deviceId)
+{
+    DeviceMemoryPool::Backend backend;
+    backend.allocate = [deviceId](size_t numBytes) -> void* {
+        void* pointer = PageAlignedAllocationPolicy::malloc(numBytes);
+        if (pointer != nullptr)
+        {
+            pinBuffer(pointer, numBytes);
+            std::lock_guard<std::mutex> lock(g_pinnedHostBlockOwnerMutex);
+            pinnedHostBlockOwners()[pointer] = deviceId;
+        }
+        return pointer;
+    };
+    backend.free = [](void* pointer) { unpinAndFreePinnedHostBlock(pointer); };
+    return backend;
+}
+
+} // namespace
+
+DeviceMemoryPool* pinnedHostMemoryPool() noexcept
+{
+    static const bool s_usePool = (getenv("GMX_GPU_MEMORY_POOL") != nullptr);
+    if (!s_usePool)
+    {
+        return nullptr;
+    }
+
+    int         deviceId = -1;
+    cudaError_t stat     = cudaGetDevice(&deviceId);
+    if (stat != cudaSuccess)
+    {
+        return nullptr;
+    }
+
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_pinnedHostMemoryPoolMutex);
+        auto&                       pool = pinnedHostMemoryPools()[deviceId];
+        if (!pool)
+        {
+            pool = std::make_unique<DeviceMemoryPool>(pinnedHostMemoryPoolBackend(deviceId));
+        }
+        return pool.get();
+    }
+    catch (const std::exception&)
+    {
+        return nullptr;
+    }
+}
+
+bool returnToPinnedHostMemoryPool(void* pointer) noexcept
+{
+    int deviceId = -1;
+    {
+        std::lock_guard<std::mutex> lock(g_pinnedHostBlockOwnerMutex);
+        const auto                  owner = pinnedHostBlockOwners().find(pointer);
+        if (owner == pinnedHostBlockOwners().end())
+        {
+            return false;
+        }
+        deviceId = owner->second;
+    }
+
+    std::lock_guard<std::mutex> lock(g_pinnedHostMemoryPoolMutex);
+    const auto                  pool = pinnedHostMemoryPools().find(deviceId);
+    if (pool != pinnedHostMemoryPools().end() && pool->second)
+    {
+        // Keeps the buffer pinned for reuse
+        pool->second->deallocate(pointer);
+    }
+    else
+    {
+        // The pool has been released while the buffer was in use
+        unpinAndFreePinnedHostBlock(pointer);
+    }
+    return true;
+}
+
+void releasePinnedHostMemoryPool()
+{
+    int         deviceId = -1;
+    cudaError_t stat     = cudaGetDevice(&deviceId);
+    GMX_RELEASE_ASSERT(stat == cudaSuccess,
+                       ("cudaGetDevice failed. " + getDeviceErrorString(stat)).c_str());
+
+    std::lock_guard<std::mutex> lock(g_pinnedHostMemoryPoolMutex);
+    pinnedHostMemoryPools().erase(deviceId);
+}
+
 } // namespace gmx
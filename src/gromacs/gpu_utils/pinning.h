@@ -47,6 +47,8 @@
 namespace gmx
 {
 
+class DeviceMemoryPool;
+
 /*! \brief Pin the allocation to physical memory.
  *
  * Requires that \c pointer is not nullptr.
@@ -65,4 +67,37 @@ CUDA_FUNC_QUALIFIER void pinBuffer(void*       CUDA_FUNC_ARGUMENT(pointer),
  */
 CUDA_FUNC_QUALIFIER void unpinBuffer(void* CUDA_FUNC_ARGUMENT(pointer)) noexcept CUDA_FUNC_TERM;
 
+/*! \brief Returns the pool of pinned, page-aligned host buffers for the current device
+ *
+ * HostAllocationPolicy takes pinned buffers from this pool, so buffers
+ * that are resized during the run, e.g. after domain decomposition
+ * repartitioning, do not need to be pinned and unpinned again.
+ *
+ * The pool is experimental and only used when the environment variable
+ * GMX_GPU_MEMORY_POOL is set. Returns nullptr otherwise and in builds
+ * without CUDA or HIP.
+ *
+ * Does not throw.
+ */
+CUDA_FUNC_QUALIFIER DeviceMemoryPool* pinnedHostMemoryPool() noexcept
+        CUDA_FUNC_TERM_WITH_RETURN(nullptr);
+
+/*! \brief Returns \p pointer to the pinned host memory pool that allocated it
+ *
+ * The owning pool is recorded at allocation, so this also works when
+ * another device is current when the buffer is freed. When that pool
+ * has been released, the buffer is unpinned and freed.
+ *
+ * \returns false when \p pointer was not allocated by a pool, in which
+ * case nothing is done.
+ */
+CUDA_FUNC_QUALIFIER bool returnToPinnedHostMemoryPool(void* CUDA_FUNC_ARGUMENT(pointer)) noexcept
+        CUDA_FUNC_TERM_WITH_RETURN(false);
+
+/*! \brief Unpins and frees the cached buffers of, and destroys, the pool of the current device
+ *
+ * Should be called before the device is reset.
+ */
+CUDA_FUNC_QUALIFIER void releasePinnedHostMemoryPool() CUDA_FUNC_TERM;
+
 } // namespace gmx
@@ -253,6 +253,14 @@ TEST_F(DeviceStreamManagerTest, CorrectStreamsAreReturnedOnNonbondedDevice)
     }
 }
 
+TEST(DeviceStreamManagerTest, ComputeUnitMaskCoversTheRange)
+{
+    EXPECT_EQ(std::vector<uint32_t>({ 0x0000000FU }), makeComputeUnitMask(20, 0, 4));
+    EXPECT_EQ(std::vector<uint32_t>({ 0xFFFF0000U, 0x0000000FU }), makeComputeUnitMask(36, 16, 36));
+    EXPECT_EQ(std::vector<uint32_t>({ 0U, 0U, 0x1U }), makeComputeUnitMask(65, 64, 65));
+    EXPECT_EQ(std::vector<uint32_t>({ 0U, 0U }), makeComputeUnitMask(64, 10, 10));
+}
+
 } // namespace
 } // namespace test
 } // namespace gmx
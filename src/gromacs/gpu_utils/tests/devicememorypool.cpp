@@ -0,0 +1,269 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for the device memory pool.
+ *
+ * \ingroup module_gpu_utils
+ */
+#include "gmxpre.h"
+
+#include "gromacs/gpu_utils/devicememorypool.h"
+
+#include <cstdlib>
+
+#include <map>
+#include <set>
+
+#include <gtest/gtest.h>
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+//! Host memory backend for the pool that counts its calls
+class FakeBackend
+{
+public:
+    FakeBackend()
+    {
+        backend_.allocate = [this](size_t numBytes) -> void* {
+            if (numBytes > maxAllocation_ || numAllocated_ + numBytes > capacity_)
+            {
+                return nullptr;
+            }
+            void* pointer = std::malloc(numBytes);
+            live_.insert(pointer);
+            numAllocated_ += numBytes;
+            allocationSizes_[pointer] = numBytes;
+            return pointer;
+        };
+        backend_.free = [this](void* pointer) {
+            EXPECT_EQ(1U, live_.erase(pointer)) << "Only live pointers should be freed";
+            numAllocated_ -= allocationSizes_[pointer];
+            std::free(pointer);
+            numFrees_++;
+        };
+        backend_.recordMarker = [this]() -> void* {
+            void* marker = new int(numMarkersRecorded_++);
+            liveMarkers_.insert(marker);
+            return marker;
+        };
+        backend_.waitForMarker = [this](void* marker) {
+            EXPECT_EQ(1U, liveMarkers_.erase(marker)) << "Only live markers should be waited for";
+            delete static_cast<int*>(marker);
+            numMarkerWaits_++;
+        };
+    }
+
+    //! The backend to pass to the pool
+    DeviceMemoryPool::Backend backend_;
+    //! Allocations larger than this fail
+    size_t maxAllocation_ = 1 << 20;
+    //! Allocations fail when the total would exceed this
+    size_t capacity_ = 1 << 22;
+    //! The number of bytes allocated and not freed
+    size_t numAllocated_ = 0;
+    //! The pointers allocated and not freed
+    std::set<void*> live_;
+    //! The size of every allocation
+    std::map<void*, size_t> allocationSizes_;
+    //! The number of frees
+    int numFrees_ = 0;
+    //! The markers recorded and not waited for
+    std::set<void*> liveMarkers_;
+    //! The number of markers recorded
+    int numMarkersRecorded_ = 0;
+    //! The number of waits for markers
+    int numMarkerWaits_ = 0;
+};
+
+TEST(DeviceMemoryPoolTest, SizeClassesHaveFourBinsPerPowerOfTwo)
+{
+    EXPECT_EQ(256U, DeviceMemoryPool::sizeClass(1));
+    EXPECT_EQ(256U, DeviceMemoryPool::sizeClass(256));
+    EXPECT_EQ(320U, DeviceMemoryPool::sizeClass(257));
+    EXPECT_EQ(512U, DeviceMemoryPool::sizeClass(500));
+    EXPECT_EQ(640U, DeviceMemoryPool::sizeClass(513));
+    EXPECT_EQ(1280U, DeviceMemoryPool::sizeClass(1025));
+    EXPECT_EQ(1536U, DeviceMemoryPool::sizeClass(1500));
+    for (size_t numBytes : { 1000U, 12345U, 1000000U })
+    {
+        EXPECT_GE(DeviceMemoryPool::sizeClass(numBytes), numBytes);
+        EXPECT_LE(4 * DeviceMemoryPool::sizeClass(numBytes), 5 * numBytes);
+    }
+}
+
+TEST(DeviceMemoryPoolTest, ReusesFreedBlocksOfTheSameSizeClass)
+{
+    FakeBackend      fake;
+    DeviceMemoryPool pool(fake.backend_);
+
+    void* first = pool.allocate(1000);
+    ASSERT_NE(nullptr, first);
+    pool.deallocate(first);
+    EXPECT_EQ(0, fake.numFrees_);
+
+    void* second = pool.allocate(900);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(1, fake.numMarkerWaits_);
+
+    void* third = pool.allocate(5000);
+    EXPECT_NE(first, third);
+
+    const DeviceMemoryPool::Statistics statistics = pool.statistics();
+    EXPECT_EQ(2, statistics.numBackendAllocations);
+    EXPECT_EQ(1, statistics.numReusedAllocations);
+    EXPECT_EQ(DeviceMemoryPool::sizeClass(1000) + DeviceMemoryPool::sizeClass(5000),
+              statistics.bytesInUse);
+    EXPECT_EQ(statistics.bytesInUse, statistics.highWaterMark);
+    EXPECT_EQ(0U, statistics.bytesCached);
+
+    pool.deallocate(second);
+    pool.deallocate(third);
+}
+
+TEST(DeviceMemoryPoolTest, WaitsForTheFreeMarkerOfReusedBlocksOnly)
+{
+    FakeBackend      fake;
+    DeviceMemoryPool pool(fake.backend_);
+
+    void* a = pool.allocate(1000);
+    void* b = pool.allocate(1000);
+    void* c = pool.allocate(5000);
+    pool.deallocate(a);
+    pool.deallocate(b);
+    pool.deallocate(c);
+    EXPECT_EQ(3, fake.numMarkersRecorded_);
+    EXPECT_EQ(0, fake.numMarkerWaits_);
+
+    a = pool.allocate(1000);
+    EXPECT_EQ(1, fake.numMarkerWaits_);
+    b = pool.allocate(1000);
+    EXPECT_EQ(2, fake.numMarkerWaits_);
+
+    // The marker of c is still pending and is waited for before c is freed
+    pool.releaseCachedBlocks();
+    EXPECT_EQ(3, fake.numMarkerWaits_);
+    EXPECT_TRUE(fake.liveMarkers_.empty());
+
+    pool.deallocate(a);
+    pool.deallocate(b);
+}
+
+TEST(DeviceMemoryPoolTest, WorksWithoutMarkers)
+{
+    FakeBackend fake;
+    fake.backend_.recordMarker  = nullptr;
+    fake.backend_.waitForMarker = nullptr;
+    DeviceMemoryPool pool(fake.backend_);
+
+    void* a = pool.allocate(1000);
+    pool.deallocate(a);
+    EXPECT_EQ(a, pool.allocate(1000));
+    pool.deallocate(a);
+    EXPECT_EQ(0, fake.numMarkersRecorded_);
+}
+
+TEST(DeviceMemoryPoolTest, TracksHighWaterMarkAndCache)
+{
+    FakeBackend      fake;
+    DeviceMemoryPool pool(fake.backend_);
+
+    void* a = pool.allocate(4096);
+    void* b = pool.allocate(8192);
+    pool.deallocate(a);
+    pool.deallocate(b);
+
+    DeviceMemoryPool::Statistics statistics = pool.statistics();
+    EXPECT_EQ(0U, statistics.bytesInUse);
+    EXPECT_EQ(4096U + 8192U, statistics.highWaterMark);
+    EXPECT_EQ(4096U + 8192U, statistics.bytesCached);
+
+    pool.releaseCachedBlocks();
+    statistics = pool.statistics();
+    EXPECT_EQ(0U, statistics.bytesCached);
+    EXPECT_EQ(0U, fake.numAllocated_);
+}
+
+TEST(DeviceMemoryPoolTest, ReleasesCacheWhenOutOfMemory)
+{
+    FakeBackend fake;
+    fake.capacity_ = 12 * 1024;
+    DeviceMemoryPool pool(fake.backend_);
+
+    void* a = pool.allocate(8192);
+    pool.deallocate(a);
+    void* b = pool.allocate(6144);
+    ASSERT_NE(nullptr, b);
+    EXPECT_EQ(1, fake.numFrees_);
+    pool.deallocate(b);
+
+    fake.maxAllocation_ = 1024;
+    EXPECT_EQ(nullptr, pool.allocate(2048));
+}
+
+TEST(DeviceMemoryPoolTest, HandlesNullAndForeignPointers)
+{
+    FakeBackend      fake;
+    DeviceMemoryPool pool(fake.backend_);
+
+    EXPECT_EQ(nullptr, pool.allocate(0));
+    pool.deallocate(nullptr);
+
+    void* foreign = fake.backend_.allocate(100);
+    pool.deallocate(foreign);
+    EXPECT_EQ(1, fake.numFrees_);
+    EXPECT_EQ(0U, pool.statistics().bytesCached);
+}
+
+TEST(DeviceMemoryPoolTest, FreesCachedBlocksOnDestruction)
+{
+    FakeBackend fake;
+    {
+        DeviceMemoryPool pool(fake.backend_);
+        pool.deallocate(pool.allocate(1000));
+        pool.deallocate(pool.allocate(100000));
+    }
+    EXPECT_TRUE(fake.live_.empty());
+    EXPECT_TRUE(fake.liveMarkers_.empty());
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
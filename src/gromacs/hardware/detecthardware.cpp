@@ -354,11 +354,11 @@ void hardwareTopologyDoubleCheckDetection(const gmx::MDLogger gmx_unused& mdlog,
 
 std::unique_ptr<gmx_hw_info_t> gmx_detect_hardware(const PhysicalNodeCommunicator& physicalNodeComm)
 {
-    // TODO: We should also do CPU hardware detection only once on each
-    // physical node and broadcast it, instead of doing it on every MPI rank.
+    // The expensive hwloc topology discovery is done only once on each physical
+    // node. CPUID based detection is cheap and still done on every MPI rank.
     auto hardwareInfo = std::make_unique<gmx_hw_info_t>(
             std::make_unique<CpuInfo>(CpuInfo::detect()),
-            std::make_unique<HardwareTopology>(HardwareTopology::detect()));
+            std::make_unique<HardwareTopology>(HardwareTopology::detect(&physicalNodeComm)));
 
     // TODO: Get rid of this altogether.
     hardwareInfo->nthreads_hw_avail = hardwareInfo->hardwareTopology->machine().logicalProcessorCount;
@@ -54,6 +54,8 @@
 #include "gromacs/gpu_utils/cudautils.cuh"
 #include "gromacs/gpu_utils/device_context.h"
 #include "gromacs/gpu_utils/device_stream.h"
+#include "gromacs/gpu_utils/devicememorypool.h"
+#include "gromacs/gpu_utils/pinning.h"
 #include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/logger.h"
 #include "gromacs/utility/programcontext.h"
@@ -349,6 +351,9 @@ void releaseDevice(DeviceInformation* deviceInfo)
                 fprintf(stderr, "Cleaning up context on GPU ID #%d.\n", gpuid);
             }
 
+            // The cached buffers of the pools become invalid with the reset
+            gmx::releaseDeviceBufferMemoryPool();
+            gmx::releasePinnedHostMemoryPool();
             stat = cudaDeviceReset();
             if (stat != cudaSuccess)
             {
@@ -55,6 +55,8 @@
 #include "gromacs/gpu_utils/hiputils.hpp"
 #include "gromacs/gpu_utils/device_context.h"
 #include "gromacs/gpu_utils/device_stream.h"
+#include "gromacs/gpu_utils/devicememorypool.h"
+#include "gromacs/gpu_utils/pinning.h"
 #include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/logger.h"
 #include "gromacs/utility/programcontext.h"
@@ -356,6 +358,9 @@ void releaseDevice(DeviceInformation* deviceInfo)
             }
             
             // fprintf(stderr, "Cleaning up context on GPU ID #%d.\n", gpuid);
+            // The cached buffers of the pools become invalid with the reset
+            gmx::releaseDeviceBufferMemoryPool();
+            gmx::releasePinnedHostMemoryPool();
             stat = hipDeviceReset();
             if (stat != hipSuccess)
             {
@@ -49,6 +49,7 @@
 #include "config.h"
 
 #include <cstdio>
+#include <cstdlib>
 
 #include <algorithm>
 #include <functional>
@@ -61,7 +62,10 @@
 #endif
 
 #include "gromacs/hardware/cpuinfo.h"
+#include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxmpi.h"
+#include "gromacs/utility/physicalnodecommunicator.h"
 
 #ifdef HAVE_UNISTD_H
 #    include <unistd.h> // sysconf()
@@ -603,35 +607,155 @@ bool parseHwLocDevices(hwloc_topology_t topo, HardwareTopology::Machine* machine
     return !pcidevs.empty();
 }
 
-void parseHwLoc(HardwareTopology::Machine* machine, HardwareTopology::SupportLevel* supportLevel, bool* isThisSystem)
+/*! \brief Sets the flags for loading \p topo
+ *
+ * \param[in] topo        The topology to set the flags for
+ * \param[in] isImported  Whether the topology is imported from an XML buffer
+ *                        exported by another process on this physical node
+ */
+void setHwLocFlags(hwloc_topology_t topo, bool isImported)
+{
+#    if GMX_HWLOC_API_VERSION_IS_2XX
+    hwloc_topology_set_io_types_filter(topo, HWLOC_TYPE_FILTER_KEEP_IMPORTANT);
+    if (isImported)
+    {
+        hwloc_topology_set_flags(topo, HWLOC_TOPOLOGY_FLAG_IS_THISSYSTEM);
+    }
+#    else
+    hwloc_topology_set_flags(topo,
+                             HWLOC_TOPOLOGY_FLAG_IO_DEVICES
+                                     | (isImported ? HWLOC_TOPOLOGY_FLAG_IS_THISSYSTEM : 0));
+#    endif
+}
+
+/*! \brief Loads \p topo, discovering it only once per physical node
+ *
+ * hwloc topology discovery is expensive and serializes when many ranks on
+ * a node run it at the same time. With an MPI library and a non-null
+ * \p physicalNodeComm, the master rank of that communicator discovers the
+ * topology and broadcasts it in XML format, the other ranks on the node only
+ * import that. This assumes that all ranks on the node are allowed to use the
+ * same resources, which can be overridden by setting
+ * GMX_DISABLE_SHARED_HWLOC_DETECTION.
+ *
+ * This is collective over \p physicalNodeComm, also when hwloc_topology_init()
+ * failed on this rank, as signaled by \p isInitialized. Such a rank does not
+ * load \p topo but still takes part in the broadcasts, and a master rank
+ * broadcasts the failure to the other ranks.
+ *
+ * \returns 0 on success, as hwloc_topology_load().
+ */
+int loadHwLocTopology(hwloc_topology_t                topo,
+                      bool                            isInitialized,
+                      const PhysicalNodeCommunicator* physicalNodeComm)
+{
+#    if GMX_LIB_MPI
+    if (physicalNodeComm != nullptr && physicalNodeComm->size_ > 1
+        && std::getenv("GMX_DISABLE_SHARED_HWLOC_DETECTION") == nullptr)
+    {
+        const bool isMasterRankOfPhysicalNode = (physicalNodeComm->rank_ == 0);
+
+        // A negative size signals that the master rank failed to load the topology,
+        // a zero size that it could not export it.
+        std::vector<char> buffer;
+        int               sizeOfBuffer = 0;
+        int               result       = 0;
+        if (isMasterRankOfPhysicalNode)
+        {
+            if (isInitialized)
+            {
+                setHwLocFlags(topo, false);
+                result = hwloc_topology_load(topo);
+            }
+            else
+            {
+                result = -1;
+            }
+            if (result == 0)
+            {
+                char* xmlBuffer = nullptr;
+                int   xmlLength = 0;
+#        if GMX_HWLOC_API_VERSION_IS_2XX
+                if (hwloc_topology_export_xmlbuffer(topo, &xmlBuffer, &xmlLength, 0) == 0)
+#        else
+                if (hwloc_topology_export_xmlbuffer(topo, &xmlBuffer, &xmlLength) == 0)
+#        endif
+                {
+                    buffer.assign(xmlBuffer, xmlBuffer + xmlLength);
+                    hwloc_free_xmlbuffer(topo, xmlBuffer);
+                }
+                sizeOfBuffer = buffer.size();
+            }
+            else
+            {
+                sizeOfBuffer = -1;
+            }
+        }
+        MPI_Bcast(&sizeOfBuffer, 1, MPI_INT, 0, physicalNodeComm->comm_);
+        buffer.resize(std::max(sizeOfBuffer, 0));
+        if (!buffer.empty())
+        {
+            MPI_Bcast(buffer.data(), buffer.size(), MPI_BYTE, 0, physicalNodeComm->comm_);
+        }
+
+        if (isMasterRankOfPhysicalNode)
+        {
+            return result;
+        }
+        if (sizeOfBuffer < 0 || !isInitialized)
+        {
+            return -1;
+        }
+        // Fall back to discovering the topology on this rank when the import fails
+        const bool isImported =
+                (sizeOfBuffer > 0
+                 && hwloc_topology_set_xmlbuffer(topo, buffer.data(), sizeOfBuffer) == 0);
+        setHwLocFlags(topo, isImported);
+        return hwloc_topology_load(topo);
+    }
+#    else
+    GMX_UNUSED_VALUE(physicalNodeComm);
+#    endif
+
+    if (!isInitialized)
+    {
+        return -1;
+    }
+    setHwLocFlags(topo, false);
+    return hwloc_topology_load(topo);
+}
+
+void parseHwLoc(HardwareTopology::Machine*      machine,
+                HardwareTopology::SupportLevel* supportLevel,
+                bool*                           isThisSystem,
+                const PhysicalNodeCommunicator* physicalNodeComm)
 {
-    hwloc_topology_t topo;
+    hwloc_topology_t topo = nullptr;
 
     // Initialize a hwloc object, set flags to request IO device information too,
     // try to load the topology, and get the root object. If either step fails,
     // return that we do not have any support at all from hwloc.
-    if (hwloc_topology_init(&topo) != 0)
-    {
-        hwloc_topology_destroy(topo);
-        return; // SupportLevel::None.
-    }
+    // A failed initialization is only handled after loading, which is collective.
+    const bool isInitialized = (hwloc_topology_init(&topo) == 0);
 
-    // Flags to look for io devices
 #    if GMX_HWLOC_API_VERSION_IS_2XX
     GMX_RELEASE_ASSERT(
             (hwloc_get_api_version() >= 0x20000),
             "Mismatch between hwloc headers and library, using v2 headers with v1 library");
-    hwloc_topology_set_io_types_filter(topo, HWLOC_TYPE_FILTER_KEEP_IMPORTANT);
 #    else
     GMX_RELEASE_ASSERT(
             (hwloc_get_api_version() < 0x20000),
             "Mismatch between hwloc headers and library, using v1 headers with v2 library");
-    hwloc_topology_set_flags(topo, HWLOC_TOPOLOGY_FLAG_IO_DEVICES);
 #    endif
 
-    if (hwloc_topology_load(topo) != 0 || hwloc_get_root_obj(topo) == nullptr)
+    // Collective over *physicalNodeComm, so no rank may return before this
+    if (loadHwLocTopology(topo, isInitialized, physicalNodeComm) != 0
+        || hwloc_get_root_obj(topo) == nullptr)
     {
-        hwloc_topology_destroy(topo);
+        if (isInitialized)
+        {
+            hwloc_topology_destroy(topo);
+        }
         return; // SupportLevel::None.
     }
 
@@ -700,12 +824,14 @@ int detectLogicalProcessorCount()
 } // namespace
 
 // static
-HardwareTopology HardwareTopology::detect()
+HardwareTopology HardwareTopology::detect(const PhysicalNodeCommunicator* physicalNodeComm)
 {
     HardwareTopology result;
 
 #if GMX_USE_HWLOC
-    parseHwLoc(&result.machine_, &result.supportLevel_, &result.isThisSystem_);
+    parseHwLoc(&result.machine_, &result.supportLevel_, &result.isThisSystem_, physicalNodeComm);
+#else
+    GMX_UNUSED_VALUE(physicalNodeComm);
 #endif
 
     // If something went wrong in hwloc (or if it was not present) we might
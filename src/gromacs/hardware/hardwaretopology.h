@@ -50,6 +50,8 @@
 namespace gmx
 {
 
+class PhysicalNodeCommunicator;
+
 /*! \libinternal \brief Information about sockets, cores, threads, numa, caches
  *
  * This class is the main GROMACS interface to provide information about the
@@ -186,8 +188,13 @@ public:
         std::vector<Device>           devices;           //!< Devices on PCI bus
     };
 
-    /*! \brief Detects the hardware topology. */
-    static HardwareTopology detect();
+    /*! \brief Detects the hardware topology.
+     *
+     * With an MPI library and \p physicalNodeComm given, the call is
+     * collective over that communicator and the hwloc topology is only
+     * discovered on its master rank and shared with the other ranks.
+     */
+    static HardwareTopology detect(const PhysicalNodeCommunicator* physicalNodeComm = nullptr);
 
     /*! \brief Creates a topology with given number of logical cores.
      *
@@ -1629,6 +1629,14 @@ void ImdSession::sendPositionsAndEnergies()
         return;
     }
 
+    /* Do not let a slow client stall the simulation: when the client has not
+     * yet consumed the previous frame, so that the socket cannot be written
+     * to, we drop this frame and send the next one. */
+    if (imdsock_trywrite(impl_->clientsocket, 0, 0) == 0)
+    {
+        return;
+    }
+
     if (imd_send_energies(impl_->clientsocket, impl_->energies, impl_->energysendbuf))
     {
         impl_->issueFatalError("Error sending updated energies. Disconnecting client.");
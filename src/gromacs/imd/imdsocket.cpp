@@ -440,4 +440,43 @@ int imdsock_tryread(IMDSocket* sock, int timeoutsec, int timeoutusec)
     return ret;
 }
 
+
+int imdsock_trywrite(IMDSocket* sock, int timeoutsec, int timeoutusec)
+{
+    int ret = -1;
+
+
+#if GMX_IMD
+    fd_set writefds;
+    /* Create new time structure with sec and usec. */
+    struct timeval tval;
+
+    /* clear the set */
+    FD_ZERO(&writefds);
+    /* add the socket to the write set */
+    FD_SET(sock->sockfd, &writefds);
+
+    /* set the timeout */
+    tval.tv_sec  = timeoutsec;
+    tval.tv_usec = timeoutusec;
+    do
+    {
+        /* check the set for write readiness. */
+        ret = select(sock->sockfd + 1, nullptr, &writefds, nullptr, &tval);
+        /* redo on system interrupt */
+    } while (ret < 0 && errno == EINTR);
+#else
+    GMX_UNUSED_VALUE(sock);
+    GMX_UNUSED_VALUE(timeoutsec);
+    GMX_UNUSED_VALUE(timeoutusec);
+#endif
+
+    if (ret < 0)
+    {
+        print_IMD_error(ERR_ARGS);
+    }
+
+    return ret;
+}
+
 } // namespace gmx
@@ -184,6 +184,20 @@ int imdsock_destroy(IMDSocket* sock);
  */
 int imdsock_tryread(IMDSocket* sock, int timeoutsec, int timeoutusec);
 
+
+/*! \brief Check whether the socket can be written to.
+ *
+ * Time out after waiting the interval specified.
+ * Print an error message if unsuccessful.
+ *
+ * \param sock         The IMD socket.
+ * \param timeoutsec   Time out seconds
+ * \param timeoutusec  Time out microseconds
+ *
+ * \returns 1 if the socket is ready for writing, 0 on time out and -1 on error.
+ */
+int imdsock_trywrite(IMDSocket* sock, int timeoutsec, int timeoutusec);
+
 } // namespace gmx
 
 #endif
@@ -49,6 +49,7 @@
 #define GMX_LISTED_FORCES_BONDED_H
 
 #include <string>
+#include <vector>
 
 #include "gromacs/math/vectypes.h"
 #include "gromacs/topology/ifunc.h"
@@ -134,6 +135,18 @@ real cmap_dihs(int                 nbonds,
                t_oriresdata gmx_unused* oriresdata,
                int gmx_unused* global_atom_index);
 
+/*! \brief Returns the bicubic interpolation coefficients for all cells of all CMAP grids
+ *
+ * For each CMAP type and grid cell (iphi1, iphi2) the 16 coefficients used by
+ * cmap_dihs() are stored consecutively, starting at index
+ * ((cmapType * gridSpacing + iphi1) * gridSpacing + iphi2) * 16.
+ * Coefficient i * 4 + j multiplies t^i u^j, with t and u the fractional positions
+ * within the cell along the first and second torsion, and the derivatives are
+ * with respect to the cell fractions. This allows evaluating CMAP interactions
+ * without the matrix-vector product per interaction, which is used on GPUs.
+ */
+std::vector<real> cmapBicubicCoefficients(const gmx_cmap_t& cmapGrid);
+
 /*! \brief For selecting which flavor of bonded kernel is used for simple bonded types */
 enum class BondedKernelFlavor
 {
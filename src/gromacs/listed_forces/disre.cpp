@@ -293,14 +293,13 @@ void init_disres(FILE*                 fplog,
     }
 }
 
-void calc_disres_R_6(const t_commrec*      cr,
-                     const gmx_multisim_t* ms,
-                     int                   nfa,
-                     const t_iatom         forceatoms[],
-                     const rvec            x[],
-                     const t_pbc*          pbc,
-                     t_disresdata*         dd,
-                     const history_t*      hist)
+gmx::ArrayRef<real> calcDisresR6Local(const t_commrec* cr,
+                                      int              nfa,
+                                      const t_iatom    forceatoms[],
+                                      const rvec       x[],
+                                      const t_pbc*     pbc,
+                                      t_disresdata*    dd,
+                                      const history_t* hist)
 {
     rvec     dx;
     real *   rt, *rm3tav, *Rtl_6, *Rt_6, *Rtav_6;
@@ -383,6 +382,14 @@ void calc_disres_R_6(const t_commrec*      cr,
         gmx_sum(2 * dd->nres, dd->Rt_6, cr);
     }
 
+    /* Store the base forceatoms pointer, so we can re-calculate the pair
+     * index in ta_disres() for indexing pair data in t_disresdata when
+     * using thread parallelization.
+     */
+    dd->forceatomsStart = forceatoms;
+
+    dd->sumviol = 0;
+
     if (dd->nsystems > 1)
     {
         real invn = 1.0 / dd->nsystems;
@@ -394,22 +401,39 @@ void calc_disres_R_6(const t_commrec*      cr,
             Rtav_6[res] *= invn;
         }
 
-        GMX_ASSERT(cr != nullptr && ms != nullptr, "We need multisim with nsystems>1");
-        gmx_sum_sim(2 * dd->nres, dd->Rt_6, ms);
+        return gmx::arrayRefFromArray(dd->Rt_6, 2 * dd->nres);
+    }
+    else
+    {
+        return {};
+    }
+}
 
-        if (haveDDAtomOrdering(*cr))
-        {
-            gmx_bcast(2 * dd->nres, dd->Rt_6, cr->mpi_comm_mygroup);
-        }
+void finishDisresR6(const t_commrec* cr, t_disresdata* dd)
+{
+    if (dd->nsystems > 1 && haveDDAtomOrdering(*cr))
+    {
+        gmx_bcast(2 * dd->nres, dd->Rt_6, cr->mpi_comm_mygroup);
     }
+}
 
-    /* Store the base forceatoms pointer, so we can re-calculate the pair
-     * index in ta_disres() for indexing pair data in t_disresdata when
-     * using thread parallelization.
-     */
-    dd->forceatomsStart = forceatoms;
+void calc_disres_R_6(const t_commrec*      cr,
+                     const gmx_multisim_t* ms,
+                     int                   nfa,
+                     const t_iatom         forceatoms[],
+                     const rvec            x[],
+                     const t_pbc*          pbc,
+                     t_disresdata*         dd,
+                     const history_t*      hist)
+{
+    gmx::ArrayRef<real> ensembleSum = calcDisresR6Local(cr, nfa, forceatoms, x, pbc, dd, hist);
+    if (!ensembleSum.empty())
+    {
+        GMX_ASSERT(cr != nullptr && ms != nullptr, "We need multisim with nsystems>1");
+        gmx_sum_sim(ensembleSum.ssize(), ensembleSum.data(), ms);
 
-    dd->sumviol = 0;
+        finishDisresR6(cr, dd);
+    }
 }
 
 real ta_disres(int              nfa,
@@ -112,6 +112,25 @@ void calc_disres_R_6(const t_commrec*      cr,
                      t_disresdata*         disresdata,
                      const history_t*      hist);
 
+/*! \brief
+ * Calculates the local part of calc_disres_R_6(), including the reduction over ranks
+ *
+ * With ensemble averaging over multiple simulations, returns the buffer
+ * that needs to be summed over the simulations before calling
+ * finishDisresR6(). Otherwise returns an empty buffer. This allows callers
+ * to combine this reduction with other reductions over the simulations.
+ */
+gmx::ArrayRef<real> calcDisresR6Local(const t_commrec* cr,
+                                      int              nfa,
+                                      const t_iatom*   fa,
+                                      const rvec*      x,
+                                      const t_pbc*     pbc,
+                                      t_disresdata*    disresdata,
+                                      const history_t* hist);
+
+//! Distributes the ensemble sums of calcDisresR6Local() over the ranks of the simulation
+void finishDisresR6(const t_commrec* cr, t_disresdata* disresdata);
+
 //! Calculates the distance restraint forces, return the potential.
 real ta_disres(int                       nfa,
                const t_iatom*            forceatoms,
@@ -65,6 +65,7 @@
 #include "gromacs/mdlib/enerdata_utils.h"
 #include "gromacs/mdlib/force.h"
 #include "gromacs/mdlib/gmx_omp_nthreads.h"
+#include "gromacs/mdrunutility/multisim.h"
 #include "gromacs/mdtypes/commrec.h"
 #include "gromacs/mdtypes/mdatom.h"
 #include "gromacs/mdtypes/fcdata.h"
@@ -678,29 +679,66 @@ void ListedForces::calculate(struct gmx_wallcycle*                     wcycle,
             fbposres_wrapper(nrnb, idef, &pbc_full, x, enerd, fr, &forceOutputs->forceWithVirial());
         }
 
-        /* Do pre force calculation stuff which might require communication */
+        /* Do pre force calculation stuff which might require communication.
+         * With ensemble averaging, the sums over the simulations for orientation
+         * and distance restraints are combined into a single reduction.
+         */
+        gmx::ArrayRef<real> oriresEnsembleSum;
+        gmx::ArrayRef<real> disresEnsembleSum;
         if (fcdata->orires)
         {
             GMX_ASSERT(!xWholeMolecules.empty(), "Need whole molecules for orienation restraints");
-            enerd->term[F_ORIRESDEV] = calc_orires_dev(ms,
+            oriresEnsembleSum = calcOriresDTensors(ms,
+                                                   idef.il[F_ORIRES].size(),
+                                                   idef.il[F_ORIRES].iatoms.data(),
+                                                   idef.iparams.data(),
+                                                   xWholeMolecules,
+                                                   x,
+                                                   fr->bMolPBC ? pbc : nullptr,
+                                                   fcdata->orires.get());
+        }
+        if (fcdata->disres->nres > 0)
+        {
+            disresEnsembleSum = calcDisresR6Local(cr,
+                                                  idef.il[F_DISRES].size(),
+                                                  idef.il[F_DISRES].iatoms.data(),
+                                                  x,
+                                                  fr->bMolPBC ? pbc : nullptr,
+                                                  fcdata->disres,
+                                                  hist);
+        }
+        if (!oriresEnsembleSum.empty() && !disresEnsembleSum.empty())
+        {
+            restraintEnsembleSumBuffer_.resize(oriresEnsembleSum.size() + disresEnsembleSum.size());
+            auto disresStart = std::copy(oriresEnsembleSum.begin(),
+                                         oriresEnsembleSum.end(),
+                                         restraintEnsembleSumBuffer_.begin());
+            std::copy(disresEnsembleSum.begin(), disresEnsembleSum.end(), disresStart);
+            gmx_sum_sim(restraintEnsembleSumBuffer_.size(), restraintEnsembleSumBuffer_.data(), ms);
+            std::copy(restraintEnsembleSumBuffer_.begin(), disresStart, oriresEnsembleSum.begin());
+            std::copy(disresStart, restraintEnsembleSumBuffer_.end(), disresEnsembleSum.begin());
+        }
+        else
+        {
+            for (gmx::ArrayRef<real> ensembleSum : { oriresEnsembleSum, disresEnsembleSum })
+            {
+                if (!ensembleSum.empty())
+                {
+                    gmx_sum_sim(ensembleSum.ssize(), ensembleSum.data(), ms);
+                }
+            }
+        }
+        if (fcdata->orires)
+        {
+            enerd->term[F_ORIRESDEV] = finishOriresDev(ms,
                                                        idef.il[F_ORIRES].size(),
                                                        idef.il[F_ORIRES].iatoms.data(),
                                                        idef.iparams.data(),
-                                                       xWholeMolecules,
-                                                       x,
-                                                       fr->bMolPBC ? pbc : nullptr,
                                                        fcdata->orires.get());
         }
-        if (fcdata->disres->nres > 0)
+        if (!disresEnsembleSum.empty())
         {
-            calc_disres_R_6(cr,
-                            ms,
-                            idef.il[F_DISRES].size(),
-                            idef.il[F_DISRES].iatoms.data(),
-                            x,
-                            fr->bMolPBC ? pbc : nullptr,
-                            fcdata->disres,
-                            hist);
+            finishDisresR6(cr, fcdata->disres);
         }
 
         wallcycle_sub_stop(wcycle, WallCycleSubCounter::Restraints);
@@ -235,6 +235,8 @@ private:
     std::vector<gmx::RVec> shiftForceBufferLambda_;
     //! Temporary array for storing foreign lambda group pair energies
     std::unique_ptr<gmx_grppairener_t> foreignEnergyGroups_;
+    //! Buffer for combining the restraint sums over multiple simulations into one reduction
+    std::vector<real> restraintEnsembleSumBuffer_;
 
     GMX_DISALLOW_COPY_AND_ASSIGN(ListedForces);
 };
@@ -60,12 +60,12 @@ namespace gmx
 static bool someInteractionsCanRunOnGpu(const InteractionLists& ilists)
 {
     // Perturbation is not implemented in the GPU bonded
-    // kernels. If all the interactions were actually
-    // perturbed, then that will be detected later on each
-    // domain, and work will never run on the GPU. This is
-    // very unlikely to occur, and has little run-time cost,
-    // so we don't complicate the code by catering for it
-    // here.
+    // kernels, perturbed interactions are computed on the CPU.
+    // If all the interactions were actually perturbed, then
+    // that will be detected later on each domain, and work
+    // will never run on the GPU. This is very unlikely to
+    // occur, and has little run-time cost, so we don't
+    // complicate the code by catering for it here.
     return std::any_of(fTypesOnGpu.begin(), fTypesOnGpu.end(), [ilists](int fType) {
         return !ilists[fType].iatoms.empty();
     });
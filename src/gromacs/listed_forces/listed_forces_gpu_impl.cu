@@ -48,12 +48,16 @@
 
 #include "listed_forces_gpu_impl.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "gromacs/gpu_utils/cuda_arch_utils.cuh"
 #include "gromacs/gpu_utils/cudautils.cuh"
 #include "gromacs/gpu_utils/device_context.h"
 #include "gromacs/gpu_utils/device_stream.h"
 #include "gromacs/gpu_utils/devicebuffer.h"
 #include "gromacs/gpu_utils/typecasts.cuh"
+#include "gromacs/listed_forces/bonded.h"
 #include "gromacs/mdtypes/enerdata.h"
 #include "gromacs/timing/wallcycle.h"
 #include "gromacs/topology/forcefieldparameters.h"
@@ -95,6 +99,21 @@ ListedForcesGpu::Impl::Impl(const gmx_ffparams_t& ffparams,
                        deviceStream_,
                        GpuApiCallBehavior::Sync,
                        nullptr);
+    // Store the CMAP interpolation coefficients per grid cell, so the kernel
+    // does not need to compute them for each interaction
+    if (!ffparams.cmap_grid.cmapdata.empty())
+    {
+        const std::vector<real> cmapCoefficients = cmapBicubicCoefficients(ffparams.cmap_grid);
+
+        allocateDeviceBuffer(&d_cmapCoefficients_, cmapCoefficients.size(), deviceContext_);
+        copyToDeviceBuffer(&d_cmapCoefficients_,
+                           cmapCoefficients.data(),
+                           0,
+                           cmapCoefficients.size(),
+                           deviceStream_,
+                           GpuApiCallBehavior::Sync,
+                           nullptr);
+    }
     vTot_.resize(F_NRE);
     allocateDeviceBuffer(&d_vTot_, F_NRE, deviceContext_);
     clearDeviceBufferAsync(&d_vTot_, 0, F_NRE, deviceStream_);
@@ -102,6 +121,8 @@ ListedForcesGpu::Impl::Impl(const gmx_ffparams_t& ffparams,
     kernelParams_.electrostaticsScaleFactor = electrostaticsScaleFactor;
     kernelParams_.d_forceParams             = d_forceParams_;
     kernelParams_.d_vTot                    = d_vTot_;
+    kernelParams_.cmapGridSpacing           = ffparams.cmap_grid.grid_spacing;
+    kernelParams_.d_cmapCoefficients        = d_cmapCoefficients_;
     for (int i = 0; i < numFTypesOnGpu; i++)
     {
         kernelParams_.d_iatoms[i]        = nullptr;
@@ -133,37 +154,71 @@ ListedForcesGpu::Impl::~Impl()
     }
 
     freeDeviceBuffer(&d_forceParams_);
+    if (d_cmapCoefficients_)
+    {
+        freeDeviceBuffer(&d_cmapCoefficients_);
+    }
     freeDeviceBuffer(&d_vTot_);
 }
 
-//! Return whether function type \p fType in \p idef has perturbed interactions
-static bool fTypeHasPerturbedEntries(const InteractionDefinitions& idef, int fType)
+/*! \brief Return the number of iatoms entries of function type \p fType in \p idef
+ * that are not perturbed
+ *
+ * With free-energy sorting the perturbed interactions are stored at the end of the list.
+ */
+static int fTypeNumNonperturbedIAtoms(const InteractionDefinitions& idef, int fType)
 {
     GMX_ASSERT(idef.ilsort == ilsortNO_FE || idef.ilsort == ilsortFE_SORTED,
                "Perturbed interations should be sorted here");
 
     const InteractionList& ilist = idef.il[fType];
 
-    return (idef.ilsort != ilsortNO_FE && idef.numNonperturbedInteractions[fType] != ilist.size());
+    return (idef.ilsort != ilsortNO_FE ? idef.numNonperturbedInteractions[fType] : ilist.size());
 }
 
-//! Converts \p src with atom indices in state order to \p dest in nbnxn order
+/*! \brief Converts the first \p numIAtoms entries of \p src with atom indices in state order
+ * to \p dest in nbnxn order
+ */
 static void convertIlistToNbnxnOrder(const InteractionList& src,
+                                     int                    numIAtoms,
                                      HostInteractionList*   dest,
                                      int                    numAtomsPerInteraction,
                                      ArrayRef<const int>    nbnxnAtomOrder)
 {
-    GMX_ASSERT(src.empty() || !nbnxnAtomOrder.empty(), "We need the nbnxn atom order");
+    GMX_ASSERT(numIAtoms == 0 || !nbnxnAtomOrder.empty(), "We need the nbnxn atom order");
+
+    const int stride          = 1 + numAtomsPerInteraction;
+    const int numInteractions = numIAtoms / stride;
+
+    /* Sort the interactions on their first atom in the nbnxm atom order.
+     * Consecutive threads then update the same or nearby atoms, which
+     * reduces conflicts between the force atomics and improves the locality
+     * of the coordinate loads. The sort is stable to keep the order
+     * deterministic.
+     */
+    std::vector<int> sortKeys(numInteractions);
+    std::vector<int> order(numInteractions);
+    for (int i = 0; i < numInteractions; i++)
+    {
+        sortKeys[i] = nbnxnAtomOrder[src.iatoms[i * stride + 1]];
+        order[i]    = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](int a, int b) {
+        return sortKeys[a] < sortKeys[b];
+    });
 
-    dest->iatoms.resize(src.size());
+    dest->iatoms.resize(numIAtoms);
 
     // TODO use OpenMP to parallelise this loop
-    for (int i = 0; i < src.size(); i += 1 + numAtomsPerInteraction)
+    for (int i = 0; i < numInteractions; i++)
     {
-        dest->iatoms[i] = src.iatoms[i];
+        const int* srcIAtoms  = src.iatoms.data() + order[i] * stride;
+        int*       destIAtoms = dest->iatoms.data() + i * stride;
+
+        destIAtoms[0] = srcIAtoms[0];
         for (int a = 0; a < numAtomsPerInteraction; a++)
         {
-            dest->iatoms[i + 1 + a] = nbnxnAtomOrder[src.iatoms[i + 1 + a]];
+            destIAtoms[1 + a] = nbnxnAtomOrder[srcIAtoms[1 + a]];
         }
     }
 }
@@ -212,14 +267,15 @@ void ListedForcesGpu::Impl::updateInteractionListsAndDeviceBuffers(ArrayRef<cons
         auto& iList = iLists_[fType];
 
         /* Perturbation is not implemented in the GPU bonded kernels.
-         * But instead of doing all interactions on the CPU, we can
-         * still easily handle the types that have no perturbed
-         * interactions on the GPU. */
-        if (!idef.il[fType].empty() && !fTypeHasPerturbedEntries(idef, fType))
+         * The non-perturbed interactions, which are sorted first, are
+         * computed on the GPU, the perturbed ones on the CPU. */
+        const int numNonperturbedIAtoms = fTypeNumNonperturbedIAtoms(idef, fType);
+        if (numNonperturbedIAtoms > 0)
         {
             haveInteractions_ = true;
 
-            convertIlistToNbnxnOrder(idef.il[fType], &iList, NRAL(fType), nbnxnAtomOrder);
+            convertIlistToNbnxnOrder(
+                    idef.il[fType], numNonperturbedIAtoms, &iList, NRAL(fType), nbnxnAtomOrder);
         }
         else
         {
@@ -105,6 +105,10 @@ struct BondedCudaKernelParameters
     float* d_vTot;
     //! Interaction list atoms (on GPU)
     t_iatom* d_iatoms[numFTypesOnGpu];
+    //! The number of CMAP grid points along each dimension
+    int cmapGridSpacing;
+    //! Bicubic interpolation coefficients for all CMAP grid cells (on GPU)
+    float* d_cmapCoefficients;
 
     BondedCudaKernelParameters()
     {
@@ -115,6 +119,8 @@ struct BondedCudaKernelParameters
         electrostaticsScaleFactor = 1.0;
         d_forceParams             = nullptr;
         d_vTot                    = nullptr;
+        cmapGridSpacing           = 0;
+        d_cmapCoefficients        = nullptr;
     }
 };
 
@@ -180,6 +186,8 @@ private:
     t_ilist d_iLists_[F_NRE] = {};
     //! Bonded parameters for device-side use.
     t_iparams* d_forceParams_ = nullptr;
+    //! CMAP interpolation coefficients for device-side use, see cmapBicubicCoefficients().
+    float* d_cmapCoefficients_ = nullptr;
     //! Position-charge vector on the device.
     const float4* d_xq_ = nullptr;
     //! Force vector on the device.
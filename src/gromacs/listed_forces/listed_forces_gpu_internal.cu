@@ -723,6 +723,392 @@ __device__ void pairs_gpu(const int       i,
     }
 }
 
+template<bool calcVir, bool calcEner>
+__device__ void restraint_bonds_gpu(const int       i,
+                                    float*          vtot_loc,
+                                    const int       numBonds,
+                                    const t_iatom   d_forceatoms[],
+                                    const t_iparams d_forceparams[],
+                                    const float4    gm_xq[],
+                                    float3          gm_f[],
+                                    float3          sm_fShiftLoc[],
+                                    const PbcAiuc   pbcAiuc)
+{
+    if (i < numBonds)
+    {
+        const int3 bondData = *(reinterpret_cast<const int3*>(d_forceatoms + 3 * i));
+        int        type     = bondData.x;
+        int        ai       = bondData.y;
+        int        aj       = bondData.z;
+
+        /* dx = xi - xj, corrected for periodic boundary conditions. */
+        float3 dx;
+        int    ki = pbcDxAiuc<calcVir>(pbcAiuc, gm_xq[ai], gm_xq[aj], dx);
+
+        float dr2 = norm2(dx);
+        float dr  = sqrt(dr2);
+
+        /* Perturbed interactions are computed on the CPU, so we only need the A state */
+        float low = d_forceparams[type].restraint.lowA;
+        float up1 = d_forceparams[type].restraint.up1A;
+        float up2 = d_forceparams[type].restraint.up2A;
+        float k   = d_forceparams[type].restraint.kA;
+
+        float vbond;
+        float fbond;
+        if (dr < low)
+        {
+            float drh = dr - low;
+            vbond     = 0.5F * k * drh * drh;
+            fbond     = -k * drh;
+        }
+        else if (dr <= up1)
+        {
+            vbond = 0.0F;
+            fbond = 0.0F;
+        }
+        else if (dr <= up2)
+        {
+            float drh = dr - up1;
+            vbond     = 0.5F * k * drh * drh;
+            fbond     = -k * drh;
+        }
+        else
+        {
+            float drh = dr - up2;
+            vbond     = k * (up2 - up1) * (0.5F * (up2 - up1) + drh);
+            fbond     = -k * (up2 - up1);
+        }
+
+        float3 fij = make_float3(0.0F);
+        if (dr2 != 0.0F)
+        {
+            if (calcEner)
+            {
+                *vtot_loc += vbond;
+            }
+
+            fbond *= rsqrtf(dr2);
+
+            fij = fbond * dx;
+            if (calcVir && ki != gmx::c_centralShiftIndex)
+            {
+                atomicAdd(&sm_fShiftLoc[ki], fij);
+                atomicAdd(&sm_fShiftLoc[gmx::c_centralShiftIndex], -fij);
+            }
+        }
+        atomicAdd(&gm_f[ai], fij);
+        atomicAdd(&gm_f[aj], -fij);
+    }
+}
+
+template<bool calcVir, bool calcEner>
+__device__ void restricted_angles_gpu(const int       i,
+                                      float*          vtot_loc,
+                                      const int       numBonds,
+                                      const t_iatom   d_forceatoms[],
+                                      const t_iparams d_forceparams[],
+                                      const float4    gm_xq[],
+                                      float3          gm_f[],
+                                      float3          sm_fShiftLoc[],
+                                      const PbcAiuc   pbcAiuc)
+{
+    if (i < numBonds)
+    {
+        const int4 angleData = *(reinterpret_cast<const int4*>(d_forceatoms + 4 * i));
+        int        type      = angleData.x;
+        int        ai        = angleData.y;
+        int        aj        = angleData.z;
+        int        ak        = angleData.w;
+
+        float3 r_ij;
+        float3 delta_post;
+        int    t1 = pbcDxAiuc<calcVir>(pbcAiuc, gm_xq[ai], gm_xq[aj], r_ij);
+        int    t2 = pbcDxAiuc<calcVir>(pbcAiuc, gm_xq[ak], gm_xq[aj], delta_post);
+        float3 delta_ante = -r_ij;
+
+        /* The restricted bending potential, see compute_factors_restangles() */
+        float k_bending          = d_forceparams[type].harmonic.krA;
+        float cosine_theta_equil = -cosf(d_forceparams[type].harmonic.rA * CUDA_DEG2RAD_F);
+
+        float c_ante = norm2(delta_ante);
+        float c_cros = iprod(delta_ante, delta_post);
+        float c_post = norm2(delta_post);
+
+        float norm          = rsqrtf(c_ante * c_post);
+        float cosine_theta  = c_cros * norm;
+        float sine_theta_sq = 1.0F - cosine_theta * cosine_theta;
+
+        float ratio_ante = c_cros / c_ante;
+        float ratio_post = c_cros / c_post;
+
+        float delta_cosine           = cosine_theta - cosine_theta_equil;
+        float term_theta_theta_equil = 1.0F - cosine_theta * cosine_theta_equil;
+        float prefactor = -k_bending * delta_cosine * norm * term_theta_theta_equil
+                          / (sine_theta_sq * sine_theta_sq);
+
+        if (calcEner)
+        {
+            *vtot_loc += k_bending * 0.5F * delta_cosine * delta_cosine / sine_theta_sq;
+        }
+
+        float3 f_i = prefactor * (ratio_ante * delta_ante - delta_post);
+        float3 f_j = prefactor * ((ratio_post + 1.0F) * delta_post - (ratio_ante + 1.0F) * delta_ante);
+        float3 f_k = prefactor * (delta_ante - ratio_post * delta_post);
+
+        atomicAdd(&gm_f[ai], f_i);
+        atomicAdd(&gm_f[aj], f_j);
+        atomicAdd(&gm_f[ak], f_k);
+
+        if (calcVir)
+        {
+            atomicAdd(&sm_fShiftLoc[t1], f_i);
+            atomicAdd(&sm_fShiftLoc[gmx::c_centralShiftIndex], f_j);
+            atomicAdd(&sm_fShiftLoc[t2], f_k);
+        }
+    }
+}
+
+/* Returns the CMAP torsion angle, using asin/acos as on the CPU to avoid
+ * inaccuracies around 0 and pi, and the intermediates for the forces.
+ */
+template<bool returnShift>
+__device__ __forceinline__ static float cmap_dih_angle_gpu(const float4   xi,
+                                                           const float4   xj,
+                                                           const float4   xk,
+                                                           const float4   xl,
+                                                           const PbcAiuc& pbcAiuc,
+                                                           float3*        r_ij,
+                                                           float3*        r_kj,
+                                                           float3*        r_kl,
+                                                           float3*        a,
+                                                           float3*        b,
+                                                           float*         ra2r,
+                                                           float*         rb2r,
+                                                           float*         rgr,
+                                                           float*         rg,
+                                                           int*           t1,
+                                                           int*           t2)
+{
+    float3 m;
+    float3 n;
+    int    t3;
+    float  phi = dih_angle_gpu<returnShift>(xi, xj, xk, xl, pbcAiuc, r_ij, r_kj, r_kl, &m, &n, t1, t2, &t3);
+
+    float cos_phi = cosf(phi);
+
+    *a = cprod(*r_ij, *r_kj);
+    *b = cprod(*r_kl, *r_kj);
+
+    float3 h;
+    pbcDxAiuc<false>(pbcAiuc, xl, xk, h);
+
+    *rg   = sqrt(norm2(*r_kj));
+    *rgr  = 1.0F / *rg;
+    *ra2r = 1.0F / norm2(*a);
+    *rb2r = 1.0F / norm2(*b);
+
+    float rabr    = sqrt(*ra2r * *rb2r);
+    float sin_phi = -(*rg) * rabr * iprod(*a, h);
+
+    if (cos_phi < -0.5F || cos_phi > 0.5F)
+    {
+        phi = asinf(sin_phi);
+
+        if (cos_phi < 0.0F)
+        {
+            phi = (phi > 0.0F) ? CUDART_PI_F - phi : -CUDART_PI_F - phi;
+        }
+    }
+    else
+    {
+        phi = acosf(cos_phi);
+
+        if (sin_phi < 0.0F)
+        {
+            phi = -phi;
+        }
+    }
+
+    return phi;
+}
+
+/* Puts phi + pi in the range [0, 2 pi) and returns the CMAP grid cell and its fraction */
+__device__ __forceinline__ static int cmap_grid_cell_gpu(const float phi, const int gridSpacing, float* fraction)
+{
+    float xphi = phi + CUDART_PI_F;
+    if (xphi < 0.0F)
+    {
+        xphi += 2.0F * CUDART_PI_F;
+    }
+    else if (xphi >= 2.0F * CUDART_PI_F)
+    {
+        xphi -= 2.0F * CUDART_PI_F;
+    }
+
+    float xphiInCells = xphi * gridSpacing / (2.0F * CUDART_PI_F);
+    int   cell        = min(static_cast<int>(xphiInCells), gridSpacing - 1);
+    *fraction         = xphiInCells - cell;
+
+    return cell;
+}
+
+/* Spreads the CMAP force for one of the two torsions, as accumulateCmapForces() on the CPU */
+template<bool calcVir>
+__device__ static void cmap_force_fup_gpu(const int      ai,
+                                          const int      aj,
+                                          const int      ak,
+                                          const int      al,
+                                          const float    df,
+                                          const float3   r_ij,
+                                          const float3   r_kj,
+                                          const float3   r_kl,
+                                          const float3   a,
+                                          const float3   b,
+                                          const float    ra2r,
+                                          const float    rb2r,
+                                          const float    rgr,
+                                          const float    rg,
+                                          const int      t1,
+                                          const int      t2,
+                                          float3         gm_f[],
+                                          float3         sm_fShiftLoc[],
+                                          const PbcAiuc& pbcAiuc,
+                                          const float4   gm_xq[])
+{
+    float fga = iprod(r_ij, r_kj) * ra2r * rgr;
+    float hgb = iprod(r_kl, r_kj) * rb2r * rgr;
+    float gaa = -ra2r * rg;
+    float gbb = rb2r * rg;
+
+    float3 ff = (df * gaa) * a;
+    float3 fg = df * (fga * a - hgb * b);
+    float3 fh = (df * gbb) * b;
+
+    float3 f_i = ff;
+    float3 f_j = -ff - fg;
+    float3 f_k = fh + fg;
+    float3 f_l = -fh;
+
+    atomicAdd(&gm_f[ai], f_i);
+    atomicAdd(&gm_f[aj], f_j);
+    atomicAdd(&gm_f[ak], f_k);
+    atomicAdd(&gm_f[al], f_l);
+
+    if (calcVir)
+    {
+        float3 dx_jl;
+        int    t3 = pbcDxAiuc<calcVir>(pbcAiuc, gm_xq[al], gm_xq[aj], dx_jl);
+
+        atomicAdd(&sm_fShiftLoc[t1], f_i);
+        atomicAdd(&sm_fShiftLoc[gmx::c_centralShiftIndex], f_j);
+        atomicAdd(&sm_fShiftLoc[t2], f_k);
+        atomicAdd(&sm_fShiftLoc[t3], f_l);
+    }
+}
+
+template<bool calcVir, bool calcEner>
+__device__ void cmap_dihs_gpu(const int       i,
+                              float*          vtot_loc,
+                              const int       numBonds,
+                              const t_iatom   d_forceatoms[],
+                              const t_iparams d_forceparams[],
+                              const float     gm_cmapCoefficients[],
+                              const int       cmapGridSpacing,
+                              const float4    gm_xq[],
+                              float3          gm_f[],
+                              float3          sm_fShiftLoc[],
+                              const PbcAiuc   pbcAiuc)
+{
+    if (i < numBonds)
+    {
+        /* Five atoms are involved in the two torsions */
+        int type = d_forceatoms[6 * i];
+        int ai   = d_forceatoms[6 * i + 1];
+        int aj   = d_forceatoms[6 * i + 2];
+        int ak   = d_forceatoms[6 * i + 3];
+        int al   = d_forceatoms[6 * i + 4];
+        int am   = d_forceatoms[6 * i + 5];
+
+        float3 r1_ij, r1_kj, r1_kl, a1, b1;
+        float  ra2r1, rb2r1, rgr1, rg1;
+        int    t11, t21;
+        float  phi1 = cmap_dih_angle_gpu<calcVir>(gm_xq[ai],
+                                                 gm_xq[aj],
+                                                 gm_xq[ak],
+                                                 gm_xq[al],
+                                                 pbcAiuc,
+                                                 &r1_ij,
+                                                 &r1_kj,
+                                                 &r1_kl,
+                                                 &a1,
+                                                 &b1,
+                                                 &ra2r1,
+                                                 &rb2r1,
+                                                 &rgr1,
+                                                 &rg1,
+                                                 &t11,
+                                                 &t21);
+
+        float3 r2_ij, r2_kj, r2_kl, a2, b2;
+        float  ra2r2, rb2r2, rgr2, rg2;
+        int    t12, t22;
+        float  phi2 = cmap_dih_angle_gpu<calcVir>(gm_xq[aj],
+                                                 gm_xq[ak],
+                                                 gm_xq[al],
+                                                 gm_xq[am],
+                                                 pbcAiuc,
+                                                 &r2_ij,
+                                                 &r2_kj,
+                                                 &r2_kl,
+                                                 &a2,
+                                                 &b2,
+                                                 &ra2r2,
+                                                 &rb2r2,
+                                                 &rgr2,
+                                                 &rg2,
+                                                 &t12,
+                                                 &t22);
+
+        float tt;
+        float tu;
+        int   iphi1 = cmap_grid_cell_gpu(phi1, cmapGridSpacing, &tt);
+        int   iphi2 = cmap_grid_cell_gpu(phi2, cmapGridSpacing, &tu);
+
+        /* The coefficients of the bicubic interpolation in this grid cell */
+        const float* tc = gm_cmapCoefficients
+                          + ((d_forceparams[type].cmap.cmapA * cmapGridSpacing + iphi1) * cmapGridSpacing
+                             + iphi2)
+                                    * 16;
+
+        float e   = 0.0F;
+        float df1 = 0.0F;
+        float df2 = 0.0F;
+#pragma unroll
+        for (int k = 3; k >= 0; k--)
+        {
+            e   = tt * e + ((tc[k * 4 + 3] * tu + tc[k * 4 + 2]) * tu + tc[k * 4 + 1]) * tu + tc[k * 4];
+            df1 = tu * df1 + (3.0F * tc[12 + k] * tt + 2.0F * tc[8 + k]) * tt + tc[4 + k];
+            df2 = tt * df2 + (3.0F * tc[k * 4 + 3] * tu + 2.0F * tc[k * 4 + 2]) * tu + tc[k * 4 + 1];
+        }
+
+        /* Convert the derivatives from per cell to per radian */
+        float cellsPerRadian = cmapGridSpacing / (2.0F * CUDART_PI_F);
+        df1 *= cellsPerRadian;
+        df2 *= cellsPerRadian;
+
+        if (calcEner)
+        {
+            *vtot_loc += e;
+        }
+
+        cmap_force_fup_gpu<calcVir>(
+                ai, aj, ak, al, df1, r1_ij, r1_kj, r1_kl, a1, b1, ra2r1, rb2r1, rgr1, rg1, t11, t21, gm_f, sm_fShiftLoc, pbcAiuc, gm_xq);
+        cmap_force_fup_gpu<calcVir>(
+                aj, ak, al, am, df2, r2_ij, r2_kj, r2_kl, a2, b2, ra2r2, rb2r2, rgr2, rg2, t12, t22, gm_f, sm_fShiftLoc, pbcAiuc, gm_xq);
+    }
+}
+
 namespace gmx
 {
 
@@ -778,6 +1164,17 @@ __global__ void exec_kernel_gpu(BondedCudaKernelParameters kernelParams, float4*
                                                  sm_fShiftLoc,
                                                  kernelParams.pbcAiuc);
                     break;
+                case F_RESTRBONDS:
+                    restraint_bonds_gpu<calcVir, calcEner>(fTypeTid,
+                                                           &vtot_loc,
+                                                           numBonds,
+                                                           iatoms,
+                                                           kernelParams.d_forceParams,
+                                                           gm_xq,
+                                                           gm_f,
+                                                           sm_fShiftLoc,
+                                                           kernelParams.pbcAiuc);
+                    break;
                 case F_ANGLES:
                     angles_gpu<calcVir, calcEner>(fTypeTid,
                                                   &vtot_loc,
@@ -789,6 +1186,17 @@ __global__ void exec_kernel_gpu(BondedCudaKernelParameters kernelParams, float4*
                                                   sm_fShiftLoc,
                                                   kernelParams.pbcAiuc);
                     break;
+                case F_RESTRANGLES:
+                    restricted_angles_gpu<calcVir, calcEner>(fTypeTid,
+                                                             &vtot_loc,
+                                                             numBonds,
+                                                             iatoms,
+                                                             kernelParams.d_forceParams,
+                                                             gm_xq,
+                                                             gm_f,
+                                                             sm_fShiftLoc,
+                                                             kernelParams.pbcAiuc);
+                    break;
                 case F_UREY_BRADLEY:
                     urey_bradley_gpu<calcVir, calcEner>(fTypeTid,
                                                         &vtot_loc,
@@ -834,6 +1242,19 @@ __global__ void exec_kernel_gpu(BondedCudaKernelParameters kernelParams, float4*
                                                  sm_fShiftLoc,
                                                  kernelParams.pbcAiuc);
                     break;
+                case F_CMAP:
+                    cmap_dihs_gpu<calcVir, calcEner>(fTypeTid,
+                                                     &vtot_loc,
+                                                     numBonds,
+                                                     iatoms,
+                                                     kernelParams.d_forceParams,
+                                                     kernelParams.d_cmapCoefficients,
+                                                     kernelParams.cmapGridSpacing,
+                                                     gm_xq,
+                                                     gm_f,
+                                                     sm_fShiftLoc,
+                                                     kernelParams.pbcAiuc);
+                    break;
                 case F_LJ14:
                     pairs_gpu<calcVir, calcEner>(fTypeTid,
                                                  numBonds,
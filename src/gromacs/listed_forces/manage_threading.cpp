@@ -57,6 +57,8 @@
 #include <algorithm>
 #include <string>
 
+#include "gromacs/gmxlib/nrnb.h"
+#include "gromacs/listed_forces/bonded.h"
 #include "gromacs/listed_forces/listed_forces_gpu.h"
 #include "gromacs/pbcutil/ishift.h"
 #include "gromacs/topology/ifunc.h"
@@ -73,8 +75,29 @@ typedef struct
     const InteractionList* il;    /**< pointer to t_ilist entry corresponding to ftype */
     int                    ftype; /**< the function type index */
     int                    nat;   /**< nr of atoms involved in a single ftype interaction */
+    int                    cost;  /**< estimated cost of a single ftype interaction */
 } ilist_data_t;
 
+/*! \brief Returns the estimated relative cost of a single interaction of type \p ftype
+ *
+ * We use the flop counts of the kernels, which differ by more than an order
+ * of magnitude between the cheapest and most expensive types (e.g. bonds
+ * and CMAP). For the few types without flop count we assume that the cost
+ * is proportional to the number of atoms, with the bond cost per atom.
+ */
+static int bondedInteractionCost(int ftype)
+{
+    const int nrnbIndexForType = nrnbIndex(ftype);
+    if (nrnbIndexForType >= 0 && cost_nrnb(nrnbIndexForType) > 0)
+    {
+        return cost_nrnb(nrnbIndexForType);
+    }
+    else
+    {
+        return NRAL(ftype) * std::max(cost_nrnb(eNR_BONDS) / 2, 1);
+    }
+}
+
 /*! \brief Divides listed interactions over threads
  *
  * This routine attempts to divide all interactions of the numType bondeds
@@ -84,18 +107,18 @@ typedef struct
  */
 static void divide_bondeds_by_locality(bonded_threading_t* bt, int numType, const ilist_data_t* ild)
 {
-    int nat_tot, nat_sum;
-    int ind[F_NRE];    /* index into the ild[].il->iatoms */
-    int at_ind[F_NRE]; /* index of the first atom of the interaction at ind */
-    int f, t;
+    int64_t cost_tot, cost_sum;
+    int     ind[F_NRE];    /* index into the ild[].il->iatoms */
+    int     at_ind[F_NRE]; /* index of the first atom of the interaction at ind */
+    int     f, t;
 
     assert(numType <= F_NRE);
 
-    nat_tot = 0;
+    cost_tot = 0;
     for (f = 0; f < numType; f++)
     {
-        /* Sum #bondeds*#atoms_per_bond over all bonded types */
-        nat_tot += ild[f].il->size() / (ild[f].nat + 1) * ild[f].nat;
+        /* Sum #bondeds*cost_per_bond over all bonded types */
+        cost_tot += static_cast<int64_t>(ild[f].il->size() / (ild[f].nat + 1)) * ild[f].cost;
         /* The start bound for thread 0 is 0 for all interactions */
         ind[f] = 0;
         /* Initialize the next atom index array */
@@ -103,7 +126,7 @@ static void divide_bondeds_by_locality(bonded_threading_t* bt, int numType, cons
         at_ind[f] = ild[f].il->iatoms[1];
     }
 
-    nat_sum = 0;
+    cost_sum = 0;
     /* Loop over the end bounds of the nthreads threads to determine
      * which interactions threads 0 to nthreads shall calculate.
      *
@@ -117,18 +140,14 @@ static void divide_bondeds_by_locality(bonded_threading_t* bt, int numType, cons
      */
     for (t = 1; t <= bt->nthreads; t++)
     {
-        int nat_thread;
-
-        /* Here we assume that the computational cost is proportional
-         * to the number of atoms in the interaction. This is a rough
-         * measure, but roughly correct. Usually there are very few
-         * interactions anyhow and there are distributed relatively
-         * uniformly. Proper and RB dihedrals are often distributed
-         * non-uniformly, but their cost is roughly equal.
+        /* We weigh the interactions with the estimated cost per type,
+         * see bondedInteractionCost(). This matters in particular for
+         * expensive types, such as CMAP, which are often distributed
+         * non-uniformly over the atoms.
          */
-        nat_thread = (nat_tot * t) / bt->nthreads;
+        const int64_t cost_thread = (cost_tot * t) / bt->nthreads;
 
-        while (nat_sum < nat_thread)
+        while (cost_sum < cost_thread)
         {
             /* To divide bonds based on atom order, we compare
              * the index of the first atom in the bonded interaction.
@@ -158,7 +177,7 @@ static void divide_bondeds_by_locality(bonded_threading_t* bt, int numType, cons
              * index f_min) to thread t-1 by increasing ind.
              */
             ind[f_min] += ild[f_min].nat + 1;
-            nat_sum += ild[f_min].nat;
+            cost_sum += ild[f_min].cost;
 
             /* Update the first unassigned atom index for this type */
             if (ind[f_min] < ild[f_min].il->size())
@@ -188,15 +207,19 @@ static void divide_bondeds_by_locality(bonded_threading_t* bt, int numType, cons
     }
 }
 
-//! Return whether function type \p ftype in \p idef has perturbed interactions
-static bool ftypeHasPerturbedEntries(const InteractionDefinitions& idef, int ftype)
+/*! \brief Return the number of iatoms entries of function type \p ftype in \p idef
+ * that are not perturbed
+ *
+ * With free-energy sorting the perturbed interactions are stored at the end of the list.
+ */
+static int ftypeNumNonperturbedIAtoms(const InteractionDefinitions& idef, int ftype)
 {
     GMX_ASSERT(idef.ilsort == ilsortNO_FE || idef.ilsort == ilsortFE_SORTED,
                "Perturbed interations should be sorted here");
 
     const InteractionList& ilist = idef.il[ftype];
 
-    return (idef.ilsort != ilsortNO_FE && idef.numNonperturbedInteractions[ftype] != ilist.size());
+    return (idef.ilsort != ilsortNO_FE ? idef.numNonperturbedInteractions[ftype] : ilist.size());
 }
 
 //! Divides bonded interactions over threads and GPU
@@ -221,8 +244,10 @@ static void divide_bondeds_over_threads(bonded_threading_t*           bt,
             continue;
         }
 
-        const InteractionList& il                     = idef.il[fType];
-        int                    nrToAssignToCpuThreads = il.size();
+        const InteractionList& il = idef.il[fType];
+        /* The CPU threads compute the entries cpuStart to il.size() */
+        int cpuStart               = 0;
+        int nrToAssignToCpuThreads = il.size();
 
         if (useGpuForBondeds && fTypeGpuIndex < gmx::fTypesOnGpu.size()
             && gmx::fTypesOnGpu[fTypeGpuIndex] == fType)
@@ -230,14 +255,11 @@ static void divide_bondeds_over_threads(bonded_threading_t*           bt,
             fTypeGpuIndex++;
 
             /* Perturbation is not implemented in the GPU bonded kernels.
-             * But instead of doing all on the CPU, we could do only
-             * the actually perturbed interactions on the CPU.
+             * The non-perturbed interactions, which are sorted first,
+             * are computed on the GPU and only the perturbed ones on the CPU.
              */
-            if (!ftypeHasPerturbedEntries(idef, fType))
-            {
-                /* We will assign this interaction type to the GPU */
-                nrToAssignToCpuThreads = 0;
-            }
+            cpuStart = ftypeNumNonperturbedIAtoms(idef, fType);
+            nrToAssignToCpuThreads -= cpuStart;
         }
 
         if (nrToAssignToCpuThreads > 0)
@@ -253,10 +275,12 @@ static void divide_bondeds_over_threads(bonded_threading_t*           bt,
                 bt->workDivision.setBound(fType, t, 0);
             }
         }
-        else if (numThreads <= bt->max_nthread_uniform || fType == F_DISRES)
+        else if (numThreads <= bt->max_nthread_uniform || fType == F_DISRES || cpuStart > 0)
         {
             /* On up to 4 threads, load balancing the bonded work
              * is more important than minimizing the reduction cost.
+             * The, usually few, perturbed interactions left over from
+             * the GPU are also divided equally.
              */
 
             const int stride = 1 + NRAL(fType);
@@ -264,7 +288,8 @@ static void divide_bondeds_over_threads(bonded_threading_t*           bt,
             for (int t = 0; t <= numThreads; t++)
             {
                 /* Divide equally over the threads */
-                int nr_t = (((nrToAssignToCpuThreads / stride) * t) / numThreads) * stride;
+                int nr_t = cpuStart
+                           + (((nrToAssignToCpuThreads / stride) * t) / numThreads) * stride;
 
                 if (fType == F_DISRES)
                 {
@@ -289,6 +314,7 @@ static void divide_bondeds_over_threads(bonded_threading_t*           bt,
             ild[numType].ftype = fType;
             ild[numType].il    = &il;
             ild[numType].nat   = nat;
+            ild[numType].cost  = bondedInteractionCost(fType);
 
             /* The first index for the thread division is always 0 */
             bt->workDivision.setBound(fType, 0, 0);
@@ -324,6 +350,22 @@ static void divide_bondeds_over_threads(bonded_threading_t*           bt,
                 fprintf(debug, "\n");
             }
         }
+        fprintf(debug, "%16s", "Estimated cost");
+        for (int t = 0; t < numThreads; t++)
+        {
+            int64_t cost = 0;
+            for (f = 0; f < F_NRE; f++)
+            {
+                if (ftype_is_bonded_potential(f) && !idef.il[f].empty())
+                {
+                    cost += static_cast<int64_t>(bt->workDivision.bound(f, t + 1)
+                                                 - bt->workDivision.bound(f, t))
+                            / (1 + NRAL(f)) * bondedInteractionCost(f);
+                }
+            }
+            fprintf(debug, " %" PRId64, cost);
+        }
+        fprintf(debug, "\n");
     }
 }
 
@@ -409,6 +451,21 @@ void setup_bonded_threading(bonded_threading_t*           bt,
     }
 
     bt->threadedForceBuffer.setupReduction();
+
+    if (debug)
+    {
+        fprintf(debug, "Number of force reduction blocks touched per thread:");
+        for (int t = 0; t < bt->nthreads; t++)
+        {
+            int numBlocks = 0;
+            for (const gmx_bitmask_t& mask : bt->threadedForceBuffer.threadForceBuffer(t).reductionMask())
+            {
+                numBlocks += bitmask_is_set(mask, t) ? 1 : 0;
+            }
+            fprintf(debug, " %d", numBlocks);
+        }
+        fprintf(debug, "\n");
+    }
 }
 
 bonded_threading_t::bonded_threading_t(const int numThreads, const int numEnergyGroups, FILE* fplog) :
@@ -399,37 +399,23 @@ void print_orires_log(FILE* log, t_oriresdata* od)
     }
 }
 
-real calc_orires_dev(const gmx_multisim_t* ms,
-                     int                   nfa,
-                     const t_iatom         forceatoms[],
-                     const t_iparams       ip[],
-                     ArrayRef<const RVec>  xWholeMolecules,
-                     const rvec            x[],
-                     const t_pbc*          pbc,
-                     t_oriresdata*         od)
+ArrayRef<real> calcOriresDTensors(const gmx_multisim_t* ms,
+                                  int                   nfa,
+                                  const t_iatom         forceatoms[],
+                                  const t_iparams       ip[],
+                                  ArrayRef<const RVec>  xWholeMolecules,
+                                  const rvec            x[],
+                                  const t_pbc*          pbc,
+                                  t_oriresdata*         od)
 {
-    real       invn, pfac, r2, invr, corrfac, wsv2, sw, dev;
-    rvec       com, r_unrot, r;
-    const real two_thr = 2.0 / 3.0;
+    real invn, pfac, r2, invr;
+    rvec com, r_unrot, r;
 
-    const bool                 bTAV  = (od->edt != 0);
-    const real                 edt   = od->edt;
-    const real                 edt_1 = od->edt_1;
-    gmx::ArrayRef<OriresMatEq> matEq = od->tmpEq;
-    gmx::ArrayRef<gmx::RVec>   xFit  = od->xTmp();
+    gmx::ArrayRef<gmx::RVec> xFit = od->xTmp();
 
-    if (bTAV)
+    if (od->edt != 0)
     {
-        od->exp_min_t_tau = od->timeAveragingInitFactor() * edt;
-
-        /* Correction factor to correct for the lack of history
-         * at short times.
-         */
-        corrfac = 1.0 / (1.0 - od->exp_min_t_tau);
-    }
-    else
-    {
-        corrfac = 1.0;
+        od->exp_min_t_tau = od->timeAveragingInitFactor() * od->edt;
     }
 
     if (ms)
@@ -516,7 +502,38 @@ real calc_orires_dev(const gmx_multisim_t* ms,
 
     if (ms)
     {
-        gmx_sum_sim(5 * od->numRestraints, od->DTensorsEnsembleAv[0], ms);
+        return gmx::arrayRefFromArray(od->DTensorsEnsembleAv[0], 5 * od->numRestraints);
+    }
+    else
+    {
+        return {};
+    }
+}
+
+real finishOriresDev(const gmx_multisim_t* ms,
+                     int                   nfa,
+                     const t_iatom         forceatoms[],
+                     const t_iparams       ip[],
+                     t_oriresdata*         od)
+{
+    real       corrfac, wsv2, sw, dev;
+    const real two_thr = 2.0 / 3.0;
+
+    const bool                 bTAV  = (od->edt != 0);
+    const real                 edt   = od->edt;
+    const real                 edt_1 = od->edt_1;
+    gmx::ArrayRef<OriresMatEq> matEq = od->tmpEq;
+
+    if (bTAV)
+    {
+        /* Correction factor to correct for the lack of history
+         * at short times.
+         */
+        corrfac = 1.0 / (1.0 - od->exp_min_t_tau);
+    }
+    else
+    {
+        corrfac = 1.0;
     }
 
     /* Calculate the order tensor S for each experiment via optimization */
@@ -655,6 +672,25 @@ real calc_orires_dev(const gmx_multisim_t* ms,
     /* Approx. 120*nfa/3 flops */
 }
 
+real calc_orires_dev(const gmx_multisim_t* ms,
+                     int                   nfa,
+                     const t_iatom         forceatoms[],
+                     const t_iparams       ip[],
+                     ArrayRef<const RVec>  xWholeMolecules,
+                     const rvec            x[],
+                     const t_pbc*          pbc,
+                     t_oriresdata*         od)
+{
+    ArrayRef<real> ensembleSum =
+            calcOriresDTensors(ms, nfa, forceatoms, ip, xWholeMolecules, x, pbc, od);
+    if (!ensembleSum.empty())
+    {
+        gmx_sum_sim(ensembleSum.ssize(), ensembleSum.data(), ms);
+    }
+
+    return finishOriresDev(ms, nfa, forceatoms, ip, od);
+}
+
 real orires(int             nfa,
             const t_iatom   forceatoms[],
             const t_iparams ip[],
@@ -86,6 +86,35 @@ real calc_orires_dev(const gmx_multisim_t*          ms,
                      const t_pbc*                   pbc,
                      t_oriresdata*                  oriresdata);
 
+/*! \brief
+ * Calculates the instantaneous D matrices, the first part of calc_orires_dev().
+ *
+ * With ensemble averaging over multiple simulations, returns the buffer
+ * that needs to be summed over the simulations before calling
+ * finishOriresDev(). Otherwise returns an empty buffer. This allows callers
+ * to combine this reduction with other reductions over the simulations.
+ */
+gmx::ArrayRef<real> calcOriresDTensors(const gmx_multisim_t*          ms,
+                                       int                            nfa,
+                                       const t_iatom                  fa[],
+                                       const t_iparams                ip[],
+                                       gmx::ArrayRef<const gmx::RVec> xWholeMolecules,
+                                       const rvec                     x[],
+                                       const t_pbc*                   pbc,
+                                       t_oriresdata*                  oriresdata);
+
+/*! \brief
+ * Calculates the time averaged D matrices and the S matrix for each experiment,
+ * the second part of calc_orires_dev().
+ *
+ * Returns the weighted RMS deviation of the orientation restraints.
+ */
+real finishOriresDev(const gmx_multisim_t* ms,
+                     int                   nfa,
+                     const t_iatom         fa[],
+                     const t_iparams       ip[],
+                     t_oriresdata*         oriresdata);
+
 /*! \brief
  * Diagonalizes the order tensor(s) of the orienation restraints.
  *
@@ -66,6 +66,7 @@
 #include "gromacs/topology/idef.h"
 #include "gromacs/utility/enumerationhelpers.h"
 #include "gromacs/utility/strconvert.h"
+#include "gromacs/utility/stringutil.h"
 #include "gromacs/utility/stringstream.h"
 #include "gromacs/utility/textwriter.h"
 
@@ -823,6 +824,67 @@ INSTANTIATE_TEST_SUITE_P(AngleZero,
                                             ::testing::ValuesIn(c_coordinatesForTestsZeroAngle),
                                             ::testing::ValuesIn(c_pbcForTests)));
 
+//! Evaluates the bicubic CMAP polynomial with coefficients \p tc at cell fractions \p t and \p u
+real evaluateCmapPolynomial(ArrayRef<const real> tc, real t, real u)
+{
+    real value = 0;
+    for (int i = 3; i >= 0; i--)
+    {
+        value = t * value + ((tc[i * 4 + 3] * u + tc[i * 4 + 2]) * u + tc[i * 4 + 1]) * u + tc[i * 4];
+    }
+    return value;
+}
+
+TEST(CmapBicubicCoefficients, ReproduceGridValuesAtCellCorners)
+{
+    const int  gridSpacing = 4;
+    gmx_cmap_t cmapGrid;
+    cmapGrid.grid_spacing = gridSpacing;
+    cmapGrid.cmapdata.resize(2);
+    for (size_t cmapType = 0; cmapType < cmapGrid.cmapdata.size(); cmapType++)
+    {
+        auto& cmap = cmapGrid.cmapdata[cmapType].cmap;
+        cmap.resize(4 * gridSpacing * gridSpacing);
+        for (size_t i = 0; i < cmap.size(); i++)
+        {
+            cmap[i] = std::sin(0.7 * i + cmapType);
+        }
+    }
+
+    const std::vector<real> coefficients = cmapBicubicCoefficients(cmapGrid);
+    ASSERT_EQ(coefficients.size(), cmapGrid.cmapdata.size() * gridSpacing * gridSpacing * 16);
+
+    const FloatingPointTolerance tolerance = relativeToleranceAsFloatingPoint(1.0, 50 * GMX_REAL_EPS);
+    for (size_t cmapType = 0; cmapType < cmapGrid.cmapdata.size(); cmapType++)
+    {
+        const auto& cmap = cmapGrid.cmapdata[cmapType].cmap;
+        for (int iphi1 = 0; iphi1 < gridSpacing; iphi1++)
+        {
+            for (int iphi2 = 0; iphi2 < gridSpacing; iphi2++)
+            {
+                SCOPED_TRACE(formatString("CMAP type %zu, cell %d %d", cmapType, iphi1, iphi2));
+                ArrayRef<const real> tc = constArrayRefFromArray(
+                        coefficients.data() + ((cmapType * gridSpacing + iphi1) * gridSpacing + iphi2) * 16,
+                        16);
+                const int next1 = (iphi1 + 1) % gridSpacing;
+                const int next2 = (iphi2 + 1) % gridSpacing;
+                EXPECT_REAL_EQ_TOL(cmap[(iphi1 * gridSpacing + iphi2) * 4],
+                                   evaluateCmapPolynomial(tc, 0, 0),
+                                   tolerance);
+                EXPECT_REAL_EQ_TOL(cmap[(next1 * gridSpacing + iphi2) * 4],
+                                   evaluateCmapPolynomial(tc, 1, 0),
+                                   tolerance);
+                EXPECT_REAL_EQ_TOL(cmap[(next1 * gridSpacing + next2) * 4],
+                                   evaluateCmapPolynomial(tc, 1, 1),
+                                   tolerance);
+                EXPECT_REAL_EQ_TOL(cmap[(iphi1 * gridSpacing + next2) * 4],
+                                   evaluateCmapPolynomial(tc, 0, 1),
+                                   tolerance);
+            }
+        }
+    }
+}
+
 } // namespace
 
 } // namespace test
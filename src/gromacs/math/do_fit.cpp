@@ -48,7 +48,6 @@
 #include "gromacs/math/utilities.h"
 #include "gromacs/math/vec.h"
 #include "gromacs/utility/fatalerror.h"
-#include "gromacs/utility/smalloc.h"
 
 real calc_similar_ind(gmx_bool bRho, int nind, const int* index, const real mass[], rvec x[], rvec xp[])
 {
@@ -113,9 +112,8 @@ real rhodev(int natoms, real mass[], rvec x[], rvec xp[])
 
 void calc_fit_R(int ndim, int natoms, const real* w_rls, const rvec* xp, rvec* x, matrix R)
 {
-    int      c, r, n, j, i, irot, s;
-    double **omega, **om;
-    double   d[2 * DIM], xnr, xpc;
+    int    c, r, n, j, i, irot, s;
+    double d[2 * DIM], xnr, xpc;
     matrix   vh, vk, u;
     real     mn;
     int      index;
@@ -126,12 +124,18 @@ void calc_fit_R(int ndim, int natoms, const real* w_rls, const rvec* xp, rvec* x
         gmx_fatal(FARGS, "calc_fit_R called with ndim=%d instead of 3 or 2", ndim);
     }
 
-    snew(omega, 2 * ndim);
-    snew(om, 2 * ndim);
+    /* This is called for every frame in analysis tools that fit, so we
+     * avoid heap allocation and use fixed-size storage for the at most
+     * 6x6 matrices, accessed through row pointers as jacobi() expects.
+     */
+    double  omegaData[2 * DIM][2 * DIM];
+    double  omData[2 * DIM][2 * DIM];
+    double* omega[2 * DIM];
+    double* om[2 * DIM];
     for (i = 0; i < 2 * ndim; i++)
     {
-        snew(omega[i], 2 * ndim);
-        snew(om[i], 2 * ndim);
+        omega[i] = omegaData[i];
+        om[i]    = omData[i];
     }
 
     for (i = 0; i < 2 * ndim; i++)
@@ -250,14 +254,6 @@ void calc_fit_R(int ndim, int natoms, const real* w_rls, const rvec* xp, rvec* x
     {
         R[r][r] = 1;
     }
-
-    for (i = 0; i < 2 * ndim; i++)
-    {
-        sfree(omega[i]);
-        sfree(om[i]);
-    }
-    sfree(omega);
-    sfree(om);
 }
 
 void do_fit_ndim(int ndim, int natoms, real* w_rls, const rvec* xp, rvec* x)
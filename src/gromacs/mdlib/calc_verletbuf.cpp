@@ -928,7 +928,10 @@ real calcVerletBufferSize(const gmx_mtop_t&         mtop,
     pot_derivatives_t ljRep  = { 0, 0, 0 };
     real              repPow = mtop.ffparams.reppow;
 
-    if (ir.vdwtype == VanDerWaalsType::Cut)
+    /* The user table is not available here, for user tables we estimate
+     * the drift using the derivatives of plain cut-off LJ.
+     */
+    if (ir.vdwtype == VanDerWaalsType::Cut || ir.vdwtype == VanDerWaalsType::User)
     {
         real sw_range, md3_pswf;
 
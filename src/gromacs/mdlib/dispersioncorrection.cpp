@@ -537,9 +537,23 @@ DispersionCorrection::DispersionCorrection(const gmx_mtop_t&          mtop,
         GMX_RELEASE_ASSERT(tableFileName, "Need a table file name");
 
         setInteractionParameters(&iParams_, ic, tableFileName);
+        addInteractionParamsToCache(ic);
     }
 }
 
+void DispersionCorrection::addInteractionParamsToCache(const interaction_const_t& ic)
+{
+    iParamsCache_.push_back({ ic.rvdw,
+                              ic.rvdw_switch,
+                              ic.ewaldcoeff_lj,
+                              iParams_.enershiftsix_,
+                              iParams_.enershifttwelve_,
+                              iParams_.enerdiffsix_,
+                              iParams_.enerdifftwelve_,
+                              iParams_.virdiffsix_,
+                              iParams_.virdifftwelve_ });
+}
+
 bool DispersionCorrection::correctFullInteraction() const
 {
     return (eDispCorr_ == DispersionCorrectionType::AllEner
@@ -571,10 +585,29 @@ void DispersionCorrection::print(const gmx::MDLogger& mdlog) const
 
 void DispersionCorrection::setParameters(const interaction_const_t& ic)
 {
-    if (eDispCorr_ != DispersionCorrectionType::No)
+    if (eDispCorr_ == DispersionCorrectionType::No)
     {
-        setInteractionParameters(&iParams_, ic, nullptr);
+        return;
     }
+
+    for (const CachedInteractionParams& cached : iParamsCache_)
+    {
+        if (cached.rvdw == ic.rvdw && cached.rvdwSwitch == ic.rvdw_switch
+            && cached.ewaldCoeffLJ == ic.ewaldcoeff_lj)
+        {
+            iParams_.enershiftsix_    = cached.enershiftsix;
+            iParams_.enershifttwelve_ = cached.enershifttwelve;
+            iParams_.enerdiffsix_     = cached.enerdiffsix;
+            iParams_.enerdifftwelve_  = cached.enerdifftwelve;
+            iParams_.virdiffsix_      = cached.virdiffsix;
+            iParams_.virdifftwelve_   = cached.virdifftwelve;
+
+            return;
+        }
+    }
+
+    setInteractionParameters(&iParams_, ic, nullptr);
+    addInteractionParamsToCache(ic);
 }
 
 DispersionCorrection::Correction DispersionCorrection::calculate(const matrix box, const real lambda) const
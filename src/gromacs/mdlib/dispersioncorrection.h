@@ -39,6 +39,7 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 #include "gromacs/math/vectypes.h"
 
@@ -170,6 +171,36 @@ private:
         real virdifftwelve_ = 0;
     };
 
+    /*! \internal \brief The cut-off settings and resulting values of earlier interaction parameter setups
+     *
+     * PME tuning switches back and forth between a limited number of settings,
+     * so we store the results to avoid rebuilding tables and integrating them again.
+     */
+    struct CachedInteractionParams
+    {
+        //! VdW cut-off distance
+        real rvdw;
+        //! VdW switching distance
+        real rvdwSwitch;
+        //! LJ-PME splitting coefficient
+        real ewaldCoeffLJ;
+        //! Dispersion energy shift constant
+        real enershiftsix;
+        //! Repulsion energy shift constant
+        real enershifttwelve;
+        //! Dispersion energy difference per atom per unit of volume
+        real enerdiffsix;
+        //! Repulsion energy difference per atom per unit of volume
+        real enerdifftwelve;
+        //! Dispersion virial difference per atom per unit of volume
+        real virdiffsix;
+        //! Repulsion virial difference per atom per unit of volume
+        real virdifftwelve;
+    };
+
+    //! Stores the current interaction parameters for the settings in \p ic in the cache
+    void addInteractionParamsToCache(const interaction_const_t& ic);
+
     //! Sets the interaction parameters
     static void setInteractionParameters(DispersionCorrection::InteractionParams* iParams,
                                          const interaction_const_t&               ic,
@@ -188,6 +219,8 @@ private:
     TopologyParams topParams_;
     //! Interaction parameters
     InteractionParams iParams_;
+    //! Interaction parameters for earlier settings
+    std::vector<CachedInteractionParams> iParamsCache_;
 };
 
 #endif
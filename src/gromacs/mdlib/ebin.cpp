@@ -192,39 +192,32 @@ void add_ebin(t_ebin* eb, int entryIndex, int nener, const real ener[], gmx_bool
     }
 }
 
-// TODO It would be faster if this function was templated on both bSum
-// and whether eb->nsum was zero, to lift the branches out of the loop
-// over all possible energy terms, but that is true for a lot of the
-// ebin and mdebin functionality, so we should do it all or nothing.
-void add_ebin_indexed(t_ebin*                   eb,
-                      int                       entryIndex,
-                      gmx::ArrayRef<bool>       shouldUse,
-                      gmx::ArrayRef<const real> ener,
-                      gmx_bool                  bSum)
+namespace
 {
 
-    GMX_ASSERT(shouldUse.size() == ener.size(), "View sizes must match");
-    GMX_ASSERT(entryIndex + std::count(shouldUse.begin(), shouldUse.end(), true) <= eb->nener,
-               gmx::formatString("Energies out of range: entryIndex=%d nener=%td maxener=%d",
-                                 entryIndex,
-                                 std::count(shouldUse.begin(), shouldUse.end(), true),
-                                 eb->nener)
-                       .c_str());
-    GMX_ASSERT(entryIndex >= 0, "Must have non-negative entry");
-
-    const int    m              = eb->nsum;
-    const double invmm          = (m == 0) ? 0 : (1.0 / m) / (m + 1.0);
-    t_energy*    energyEntry    = &(eb->e[entryIndex]);
-    t_energy*    simEnergyEntry = &(eb->e_sim[entryIndex]);
-    auto         shouldUseIter  = shouldUse.begin();
+/*! \brief Stores the energies in \p ener with \p shouldUse set
+ *
+ * Templated on whether to update the sums and whether this is the
+ * first sample, so the branches are lifted out of the loop over all
+ * possible energy terms.
+ */
+template<bool doSum, bool isFirstSample>
+void addEnergiesIndexed(t_energy*                 energyEntry,
+                        t_energy*                 simEnergyEntry,
+                        const int                 m,
+                        const double              invmm,
+                        gmx::ArrayRef<bool>       shouldUse,
+                        gmx::ArrayRef<const real> ener)
+{
+    auto shouldUseIter = shouldUse.begin();
     for (const auto& theEnergy : ener)
     {
         if (*shouldUseIter)
         {
             energyEntry->e = theEnergy;
-            if (bSum)
+            if (doSum)
             {
-                if (m == 0)
+                if (isFirstSample)
                 {
                     energyEntry->eav  = 0;
                     energyEntry->esum = theEnergy;
@@ -246,6 +239,42 @@ void add_ebin_indexed(t_ebin*                   eb,
     }
 }
 
+} // namespace
+
+void add_ebin_indexed(t_ebin*                   eb,
+                      int                       entryIndex,
+                      gmx::ArrayRef<bool>       shouldUse,
+                      gmx::ArrayRef<const real> ener,
+                      gmx_bool                  bSum)
+{
+
+    GMX_ASSERT(shouldUse.size() == ener.size(), "View sizes must match");
+    GMX_ASSERT(entryIndex + std::count(shouldUse.begin(), shouldUse.end(), true) <= eb->nener,
+               gmx::formatString("Energies out of range: entryIndex=%d nener=%td maxener=%d",
+                                 entryIndex,
+                                 std::count(shouldUse.begin(), shouldUse.end(), true),
+                                 eb->nener)
+                       .c_str());
+    GMX_ASSERT(entryIndex >= 0, "Must have non-negative entry");
+
+    const int    m              = eb->nsum;
+    const double invmm          = (m == 0) ? 0 : (1.0 / m) / (m + 1.0);
+    t_energy*    energyEntry    = &(eb->e[entryIndex]);
+    t_energy*    simEnergyEntry = &(eb->e_sim[entryIndex]);
+    if (!bSum)
+    {
+        addEnergiesIndexed<false, false>(energyEntry, simEnergyEntry, m, invmm, shouldUse, ener);
+    }
+    else if (m == 0)
+    {
+        addEnergiesIndexed<true, true>(energyEntry, simEnergyEntry, m, invmm, shouldUse, ener);
+    }
+    else
+    {
+        addEnergiesIndexed<true, false>(energyEntry, simEnergyEntry, m, invmm, shouldUse, ener);
+    }
+}
+
 void ebin_increase_count(int increment, t_ebin* eb, gmx_bool bSum)
 {
     eb->nsteps += increment;
@@ -92,15 +92,16 @@ static void GenerateGibbsProbabilities(const real* ene, double* p_k, double* pks
             maxene = ene[i];
         }
     }
-    /* find the denominator */
+    /* find the numerators and the denominator, evaluating each exponential once */
     for (i = minfep; i <= maxfep; i++)
     {
-        *pks += std::exp(ene[i] - maxene);
+        p_k[i] = std::exp(ene[i] - maxene);
+        *pks += p_k[i];
     }
-    /*numerators*/
+    /* normalize */
     for (i = minfep; i <= maxfep; i++)
     {
-        p_k[i] = std::exp(ene[i] - maxene) / *pks;
+        p_k[i] /= *pks;
     }
 }
 
@@ -884,6 +885,12 @@ static int ChooseNewLambda(int               nlim,
     snew(accept, nlim);
     snew(remainder, nlim);
 
+    /* The Gibbs probabilities only depend on the range of states, since the energies
+     * do not change over the repeats, so we only recompute them when the range changes.
+     */
+    int gibbsMinfep = -1;
+    int gibbsMaxfep = -1;
+
     for (i = 0; i < expand->lmc_repeats; i++)
     {
         rng.restart(step, i);
@@ -918,7 +925,12 @@ static int ChooseNewLambda(int               nlim,
                 }
             }
 
-            GenerateGibbsProbabilities(weighted_lamee, p_k, &pks, minfep, maxfep);
+            if (minfep != gibbsMinfep || maxfep != gibbsMaxfep)
+            {
+                GenerateGibbsProbabilities(weighted_lamee, p_k, &pks, minfep, maxfep);
+                gibbsMinfep = minfep;
+                gibbsMaxfep = maxfep;
+            }
 
             if (expand->elmcmove == LambdaMoveCalculation::Gibbs)
             {
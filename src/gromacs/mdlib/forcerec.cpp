@@ -626,6 +626,41 @@ static void init_ewald_f_table(const interaction_const_t& ic,
     }
 }
 
+/* Generate the Van der Waals user table for the nonbonded kernels
+ *
+ * Reads the user table in \p tabfn and extracts the dispersion and
+ * repulsion parts, which are stored interleaved per table point.
+ */
+static std::unique_ptr<VdwUserTable> makeVdwUserTable(FILE*                      fp,
+                                                      const interaction_const_t& ic,
+                                                      const char*                tabfn,
+                                                      const real                 rtab)
+{
+    GMX_RELEASE_ASSERT(tabfn != nullptr, "Need a table file with user Van der Waals interactions");
+
+    const std::unique_ptr<t_forcetable> table = make_tables(fp, &ic, tabfn, rtab, 0);
+
+    auto vdwUserTable   = std::make_unique<VdwUserTable>();
+    vdwUserTable->scale = table->scale;
+
+    /* Also copy the (zero) point beyond the last table point, so lookups
+     * at r < rtab cannot go out of bounds due to rounding of the table size.
+     */
+    const int numValuesPerPoint = 2 * table->formatsize;
+    const int numPoints         = table->numTablePoints + 1;
+    vdwUserTable->tableYFGH.resize(numPoints * numValuesPerPoint);
+    for (int i = 0; i < numPoints; i++)
+    {
+        for (int k = 0; k < numValuesPerPoint; k++)
+        {
+            vdwUserTable->tableYFGH[i * numValuesPerPoint + k] =
+                    table->data[i * table->stride + etiLJ6 * table->formatsize + k];
+        }
+    }
+
+    return vdwUserTable;
+}
+
 void init_interaction_const_tables(FILE* fp, interaction_const_t* ic, const real rlist, const real tableExtensionLength)
 {
     if (EEL_PME_EWALD(ic->eeltype) || EVDW_PME(ic->vdwtype))
@@ -762,7 +797,10 @@ void init_forcerec(FILE*                            fplog,
             }
 
             forcerec->wholeMoleculeTransform = std::make_unique<gmx::WholeMoleculeTransform>(
-                    mtop, inputrec.pbcType, haveDDAtomOrdering(*commrec));
+                    mtop,
+                    inputrec.pbcType,
+                    haveDDAtomOrdering(*commrec),
+                    gmx_omp_nthreads_get(ModuleMultiThread::Default));
         }
 
         forcerec->bMolPBC =
@@ -967,6 +1005,12 @@ void init_forcerec(FILE*                            fplog,
         forcerec->pairsTable = make_tables(fplog, interactionConst, tabpfn, rtab, GMX_MAKETABLES_14ONLY);
     }
 
+    /* The nonbonded kernels use the dispersion and repulsion of the user table */
+    if (interactionConst->vdwtype == VanDerWaalsType::User)
+    {
+        forcerec->ic->vdwUserTable = makeVdwUserTable(fplog, *interactionConst, tabfn, rtab);
+    }
+
     /* Wall stuff */
     forcerec->nwall = inputrec.nwall;
     if (inputrec.nwall && inputrec.wall_type == WallType::Table)
@@ -53,6 +53,8 @@
 #include <cstdlib>
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -125,6 +127,20 @@ struct Task
     tensor vir_r_m_dr = { { 0 } };
     //! Temporary variable for lambda derivative.
     real dhdlambda;
+    //! The other tasks that own constraints coupled to constraints of this task.
+    std::vector<int> coupledTasks;
+};
+
+/*! \brief Progress of a LINCS task through the matrix expansion
+ *
+ * With interdependent tasks, a task only waits for the tasks it is
+ * coupled to before each expansion step, instead of for all threads.
+ * Aligned to avoid false sharing between the counters of different tasks.
+ */
+struct alignas(64) TaskProgress
+{
+    //! The number of expansion steps this task has completed, never reset
+    std::atomic<int64_t> count{ 0 };
 };
 
 /*! \brief Data for LINCS algorithm.
@@ -198,6 +214,8 @@ public:
     std::vector<gmx_bitmask_t> atf;
     //! Are the LINCS tasks interdependent?
     bool bTaskDep = false;
+    //! Matrix expansion progress per task, only used with interdependent tasks.
+    std::unique_ptr<TaskProgress[]> taskProgress;
     //! Are there triangle constraints that cross task borders?
     bool bTaskDepTri = false;
     //! Whether any task has constraints in the second update list.
@@ -252,13 +270,27 @@ real lincs_rmsd(const Lincs* lincsd)
     }
 }
 
+//! Waits until all tasks coupled to \p li_task have completed \p count steps
+static void waitForCoupledTasks(const Lincs& lincsd, const Task& li_task, const int64_t count)
+{
+    for (const int task : li_task.coupledTasks)
+    {
+        while (lincsd.taskProgress[task].count.load(std::memory_order_acquire) < count) {}
+    }
+}
+
 /*! \brief Do a set of nrec LINCS matrix multiplications.
  *
  * This function will return with up to date thread-local
  * constraint data, without an OpenMP barrier.
+ *
+ * With interdependent tasks, each task only waits for the tasks that
+ * are coupled to it before each multiplication. All tasks have
+ * completed the same number of steps on entry, since callers pass an
+ * OpenMP barrier between calls.
  */
 static void lincs_matrix_expand(const Lincs&              lincsd,
-                                const Task&               li_task,
+                                const int                 th,
                                 gmx::ArrayRef<const real> blcc,
                                 gmx::ArrayRef<real>       rhs1,
                                 gmx::ArrayRef<real>       rhs2,
@@ -267,15 +299,28 @@ static void lincs_matrix_expand(const Lincs&              lincsd,
     gmx::ArrayRef<const int> blnr  = lincsd.blnr;
     gmx::ArrayRef<const int> blbnb = lincsd.blbnb;
 
+    const Task& li_task = lincsd.task[th];
+
     const int b0   = li_task.b0;
     const int b1   = li_task.b1;
     const int nrec = lincsd.nOrder;
 
+    /* Step 0 is setting rhs1, which the caller has done */
+    std::atomic<int64_t>* progress      = lincsd.bTaskDep ? &lincsd.taskProgress[th].count : nullptr;
+    const int64_t         progressStart = progress ? progress->load(std::memory_order_relaxed) : 0;
+    if (progress)
+    {
+        progress->store(progressStart + 1, std::memory_order_release);
+    }
+
     for (int rec = 0; rec < nrec; rec++)
     {
         if (lincsd.bTaskDep)
         {
-#pragma omp barrier
+            /* Step rec reads rhs1 of the coupled tasks from step rec - 1
+             * and overwrites rhs2, which they read during step rec - 1.
+             */
+            waitForCoupledTasks(lincsd, li_task, progressStart + 1 + rec);
         }
         for (int b = b0; b < b1; b++)
         {
@@ -291,6 +336,11 @@ static void lincs_matrix_expand(const Lincs&              lincsd,
             sol[b]  = sol[b] + mvb;
         }
 
+        if (progress)
+        {
+            progress->store(progressStart + 2 + rec, std::memory_order_release);
+        }
+
         std::swap(rhs1, rhs2);
     } /* nrec*(ncons+2*nrtot) flops */
 
@@ -306,12 +356,11 @@ static void lincs_matrix_expand(const Lincs&              lincsd,
 
         if (lincsd.bTaskDep)
         {
-            /* We need a barrier here, since other threads might still be
-             * reading the contents of rhs1 and/o rhs2.
-             * We could avoid this barrier by introducing two extra rhs
-             * arrays for the triangle constraints only.
+            /* Coupled tasks might still be reading the contents of
+             * rhs1 and/or rhs2. We could avoid this wait by introducing
+             * two extra rhs arrays for the triangle constraints only.
              */
-#pragma omp barrier
+            waitForCoupledTasks(lincsd, li_task, progressStart + 1 + nrec);
         }
 
         /* Constraints involved in a triangle are ensured to be in the same
@@ -707,7 +756,7 @@ static void do_lincsp(ArrayRefWithPadding<const RVec> xPadded,
     }
     /* Together: 23*ncons + 6*nrtot flops */
 
-    lincs_matrix_expand(*lincsd, lincsd->task[th], blcc, rhs1, rhs2, sol);
+    lincs_matrix_expand(*lincsd, th, blcc, rhs1, rhs2, sol);
     /* nrec*(ncons+2*nrtot) flops */
 
     if (econq == ConstraintVariable::Deriv_FlexCon)
@@ -1095,7 +1144,7 @@ static void do_lincs(ArrayRefWithPadding<const RVec> xPadded,
     }
     /* Together: 26*ncons + 6*nrtot flops */
 
-    lincs_matrix_expand(*lincsd, lincsd->task[th], blcc, rhs1, rhs2, sol);
+    lincs_matrix_expand(*lincsd, th, blcc, rhs1, rhs2, sol);
     /* nrec*(ncons+2*nrtot) flops */
 
 #if GMX_SIMD_HAVE_REAL
@@ -1152,7 +1201,7 @@ static void do_lincs(ArrayRefWithPadding<const RVec> xPadded,
         /* 20*ncons flops */
 #endif // GMX_SIMD_HAVE_REAL
 
-        lincs_matrix_expand(*lincsd, lincsd->task[th], blcc, rhs1, rhs2, sol);
+        lincs_matrix_expand(*lincsd, th, blcc, rhs1, rhs2, sol);
         /* nrec*(ncons+2*nrtot) flops */
 
 #if GMX_SIMD_HAVE_REAL
@@ -1546,6 +1595,10 @@ Lincs* init_lincs(FILE*                            fplog,
         /* Allocate an extra elements for "task-overlap" constraints */
         li->task.resize(li->ntask + 1);
     }
+    if (li->bTaskDep)
+    {
+        li->taskProgress = std::make_unique<TaskProgress[]>(li->ntask);
+    }
 
     if (bPLINCS || li->ncg_triangle > 0)
     {
@@ -1968,6 +2021,39 @@ static void set_matrix_indices(Lincs* li, const Task& li_task, const ListOfLists
     }
 }
 
+/*! \brief Sets the list of other tasks that own constraints coupled to task \p th
+ *
+ * Requires the matrix indices of all tasks to be set.
+ */
+static void set_coupled_tasks(Lincs* li, const int th)
+{
+    Task& li_task = li->task[th];
+
+    li_task.coupledTasks.clear();
+    for (int b = li_task.b0; b < li_task.b1; b++)
+    {
+        for (int n = li->blnr[b]; n < li->blnr[b + 1]; n++)
+        {
+            const int c = li->blbnb[n];
+            if (c >= li_task.b0 && c < li_task.b1)
+            {
+                continue;
+            }
+            /* The tasks own increasing ranges of constraints */
+            const auto taskEnd = li->task.begin() + li->ntask;
+            const auto owner   = std::upper_bound(
+                    li->task.begin(), taskEnd, c, [](int con, const Task& task) { return con < task.b0; });
+            const int ownerIndex = static_cast<int>(std::distance(li->task.begin(), owner)) - 1;
+            GMX_ASSERT(ownerIndex >= 0 && c < li->task[ownerIndex].b1,
+                       "Coupled constraints should be owned by a task");
+            li_task.coupledTasks.push_back(ownerIndex);
+        }
+    }
+    std::sort(li_task.coupledTasks.begin(), li_task.coupledTasks.end());
+    li_task.coupledTasks.erase(std::unique(li_task.coupledTasks.begin(), li_task.coupledTasks.end()),
+                               li_task.coupledTasks.end());
+}
+
 void set_lincs(const InteractionDefinitions& idef,
                const int                     numAtoms,
                ArrayRef<const real>          invmass,
@@ -2215,6 +2301,19 @@ void set_lincs(const InteractionDefinitions& idef,
         GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
     }
 
+    if (li->bTaskDep)
+    {
+#pragma omp parallel for num_threads(li->ntask) schedule(static)
+        for (int th = 0; th < li->ntask; th++)
+        {
+            try
+            {
+                set_coupled_tasks(li, th);
+            }
+            GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+        }
+    }
+
     if (cr->dd == nullptr)
     {
         /* Since the matrix is static, we should free some memory */
@@ -86,19 +86,16 @@ void LincsGpu::apply(const DeviceBuffer<Float3>& d_x,
     {
         // Fill with zeros so the values can be reduced to it
         // Only 6 values are needed because virial is symmetrical
-        clearDeviceBufferAsync(&kernelParams_.d_virialScaled, 0, 6, deviceStream_);
+        clearDeviceBufferAsync(&d_virialScaled_, 0, 6, deviceStream_);
     }
 
-    kernelParams_.pbcAiuc = pbcAiuc;
-
-    launchLincsGpuKernel(
-            &kernelParams_, d_x, d_xp, updateVelocities, d_v, invdt, computeVirial, deviceStream_);
+    launch(d_x, d_xp, updateVelocities, d_v, invdt, computeVirial, d_virialScaled_, pbcAiuc);
 
     if (computeVirial)
     {
         // Copy LINCS virial data and add it to the common virial
         copyFromDeviceBuffer(h_virialScaled_.data(),
-                             &kernelParams_.d_virialScaled,
+                             &d_virialScaled_,
                              0,
                              6,
                              deviceStream_,
@@ -120,6 +117,28 @@ void LincsGpu::apply(const DeviceBuffer<Float3>& d_x,
     }
 }
 
+void LincsGpu::launch(const DeviceBuffer<Float3>& d_x,
+                      DeviceBuffer<Float3>        d_xp,
+                      const bool                  updateVelocities,
+                      DeviceBuffer<Float3>        d_v,
+                      const real                  invdt,
+                      const bool                  computeVirial,
+                      DeviceBuffer<float>         d_virialScaled,
+                      const PbcAiuc&              pbcAiuc)
+{
+    // Early exit if no constraints
+    if (kernelParams_.numConstraintsThreads == 0)
+    {
+        return;
+    }
+
+    kernelParams_.pbcAiuc        = pbcAiuc;
+    kernelParams_.d_virialScaled = d_virialScaled;
+
+    launchLincsGpuKernel(
+            &kernelParams_, d_x, d_xp, updateVelocities, d_v, invdt, computeVirial, deviceStream_);
+}
+
 LincsGpu::LincsGpu(int                  numIterations,
                    int                  expansionOrder,
                    const DeviceContext& deviceContext,
@@ -128,16 +147,17 @@ LincsGpu::LincsGpu(int                  numIterations,
 {
     GMX_RELEASE_ASSERT(bool(GMX_GPU_CUDA) || bool(GMX_GPU_HIP) || bool(GMX_GPU_SYCL),
                        "LINCS GPU is only implemented in CUDA, HIP and SYCL.");
-    kernelParams_.numIterations  = numIterations;
-    kernelParams_.expansionOrder = expansionOrder;
+    kernelParams_.numIterations   = numIterations;
+    kernelParams_.expansionOrder  = expansionOrder;
+    kernelParams_.threadsPerBlock = c_threadsPerBlock;
 
     static_assert(sizeof(real) == sizeof(float),
                   "Real numbers should be in single precision in GPU code.");
     static_assert(
-            gmx::isPowerOfTwo(c_threadsPerBlock),
+            gmx::isPowerOfTwo(c_threadsPerBlock) && gmx::isPowerOfTwo(c_maxThreadsPerBlock),
             "Number of threads per block should be a power of two in order for reduction to work.");
 
-    allocateDeviceBuffer(&kernelParams_.d_virialScaled, 6, deviceContext_);
+    allocateDeviceBuffer(&d_virialScaled_, 6, deviceContext_);
     h_virialScaled_.resize(6);
 
     // The data arrays should be expanded/reallocated on first call of set() function.
@@ -147,7 +167,7 @@ LincsGpu::LincsGpu(int                  numIterations,
 
 LincsGpu::~LincsGpu()
 {
-    freeDeviceBuffer(&kernelParams_.d_virialScaled);
+    freeDeviceBuffer(&d_virialScaled_);
 
     if (numConstraintsThreadsAlloc_ > 0)
     {
@@ -330,7 +350,7 @@ bool LincsGpu::isNumCoupledConstraintsSupported(const gmx_mtop_t& mtop)
         const auto numCoupledConstraints = countNumCoupledConstraints(iatoms, atomsAdjacencyList);
         for (const int numCoupled : numCoupledConstraints)
         {
-            if (numCoupled > c_threadsPerBlock)
+            if (numCoupled > c_maxThreadsPerBlock)
             {
                 return false;
             }
@@ -373,34 +393,45 @@ void LincsGpu::set(const InteractionDefinitions& idef, const int numAtoms, const
     // Compute, how many constraints are coupled to each constraint
     const auto numCoupledConstraints = countNumCoupledConstraints(iatoms, atomsAdjacencyList);
 
+    // Use the smallest block size that fits the largest group of coupled constraints.
+    // Larger blocks have more dummy threads at their ends and synchronize more threads.
+    const int maxNumCoupledConstraints =
+            *std::max_element(numCoupledConstraints.begin(), numCoupledConstraints.end());
+    if (maxNumCoupledConstraints > c_maxThreadsPerBlock)
+    {
+        gmx_fatal(FARGS,
+                  "Maximum number of coupled constraints (%d) exceeds the maximum size of the "
+                  "GPU thread block (%d). Most likely, you are trying to use the GPU version of "
+                  "LINCS with constraints on all-bonds, which is not supported for large "
+                  "molecules. When compatible with the force field and integration settings, "
+                  "using constraints on H-bonds only.",
+                  maxNumCoupledConstraints,
+                  c_maxThreadsPerBlock);
+    }
+    int threadsPerBlock = c_threadsPerBlock;
+    while (threadsPerBlock < maxNumCoupledConstraints)
+    {
+        threadsPerBlock *= 2;
+    }
+    kernelParams_.threadsPerBlock = threadsPerBlock;
+
     // Map of splits in the constraints data. For each 'old' constraint index gives 'new' which
     // takes into account the empty spaces which might be needed in the end of each thread block.
     std::vector<int> splitMap(numConstraints, -1);
     int              currentMapIndex = 0;
     for (int c = 0; c < numConstraints; c++)
     {
-        // Check if coupled constraints all fit in one block
-        if (numCoupledConstraints[c] > c_threadsPerBlock)
-        {
-            gmx_fatal(FARGS,
-                      "Maximum number of coupled constraints (%d) exceeds the size of the CUDA "
-                      "thread block (%d). Most likely, you are trying to use the GPU version of "
-                      "LINCS with constraints on all-bonds, which is not supported for large "
-                      "molecules. When compatible with the force field and integration settings, "
-                      "using constraints on H-bonds only.",
-                      numCoupledConstraints[c],
-                      c_threadsPerBlock);
-        }
-        if (currentMapIndex / c_threadsPerBlock != (currentMapIndex + numCoupledConstraints[c]) / c_threadsPerBlock)
+        // Move to the next block if the coupled constraints do not fit in the current one
+        if (currentMapIndex / threadsPerBlock != (currentMapIndex + numCoupledConstraints[c]) / threadsPerBlock)
         {
-            currentMapIndex = ((currentMapIndex / c_threadsPerBlock) + 1) * c_threadsPerBlock;
+            currentMapIndex = ((currentMapIndex / threadsPerBlock) + 1) * threadsPerBlock;
         }
         addWithCoupled(iatoms, stride, atomsAdjacencyList, splitMap, c, &currentMapIndex);
     }
 
     kernelParams_.numConstraintsThreads =
-            currentMapIndex + c_threadsPerBlock - currentMapIndex % c_threadsPerBlock;
-    GMX_RELEASE_ASSERT(kernelParams_.numConstraintsThreads % c_threadsPerBlock == 0,
+            currentMapIndex + threadsPerBlock - currentMapIndex % threadsPerBlock;
+    GMX_RELEASE_ASSERT(kernelParams_.numConstraintsThreads % threadsPerBlock == 0,
                        "Number of threads should be a multiple of the block size");
 
     // Initialize constraints and their target indexes taking into account the splits in the data arrays.
@@ -476,7 +507,7 @@ void LincsGpu::set(const InteractionDefinitions& idef, const int numAtoms, const
                 int index = kernelParams_.numConstraintsThreads
                                     * coupledConstraintsCountsHost[splitMap[c1]]
                             + splitMap[c1];
-                int threadBlockStarts = splitMap[c1] - splitMap[c1] % c_threadsPerBlock;
+                int threadBlockStarts = splitMap[c1] - splitMap[c1] % threadsPerBlock;
 
                 coupledConstraintsIndicesHost[index] = splitMap[c2] - threadBlockStarts;
 
@@ -504,7 +535,7 @@ void LincsGpu::set(const InteractionDefinitions& idef, const int numAtoms, const
                 int index = kernelParams_.numConstraintsThreads
                                     * coupledConstraintsCountsHost[splitMap[c1]]
                             + splitMap[c1];
-                int threadBlockStarts = splitMap[c1] - splitMap[c1] % c_threadsPerBlock;
+                int threadBlockStarts = splitMap[c1] - splitMap[c1] % threadsPerBlock;
 
                 coupledConstraintsIndicesHost[index] = splitMap[c2] - threadBlockStarts;
 
@@ -83,7 +83,7 @@ struct LincsGpuKernelParameters
     int numIterations;
     //! 1/mass for all atoms (GPU)
     DeviceBuffer<float> d_inverseMasses;
-    //! Scaled virial tensor (6 floats: [XX, XY, XZ, YY, YZ, ZZ], GPU)
+    //! Scaled virial tensor to accumulate to (6 floats: [XX, XY, XZ, YY, YZ, ZZ], GPU)
     DeviceBuffer<float> d_virialScaled;
     /*! \brief Total number of threads.
      *
@@ -92,6 +92,12 @@ struct LincsGpuKernelParameters
      *  Should be a multiple of block size (the last block is filled with dummy to the end).
      */
     int numConstraintsThreads;
+    /*! \brief Number of threads in a block.
+     *
+     *  A power of two, large enough for the largest group of coupled constraints to fit in
+     *  one block.
+     */
+    int threadsPerBlock;
     //! List of constrained atoms (GPU memory)
     DeviceBuffer<AtomPair> d_constraints;
     //! Equilibrium distances for the constraints (GPU)
@@ -160,6 +166,34 @@ public:
                tensor                      virialScaled,
                const PbcAiuc&              pbcAiuc);
 
+    /*! \brief Launch LINCS, accumulating the virial on the device.
+     *
+     * Same as apply(), but the scaled virial is added to \p d_virialScaled (6 floats:
+     * [XX, XY, XZ, YY, YZ, ZZ]) in GPU memory. The buffer is neither cleared nor copied
+     * to the host, so that several constraint algorithms can share one reduction buffer
+     * and one blocking device-to-host transfer.
+     *
+     * \param[in]     d_x               Coordinates before timestep (in GPU memory)
+     * \param[in,out] d_xp              Coordinates after timestep (in GPU memory). The
+     *                                  resulting constrained coordinates will be saved here.
+     * \param[in]     updateVelocities  If the velocities should be updated.
+     * \param[in,out] d_v               Velocities to update (in GPU memory, can be nullptr
+     *                                  if not updated)
+     * \param[in]     invdt             Reciprocal timestep (to scale Lagrange
+     *                                  multipliers when velocities are updated)
+     * \param[in]     computeVirial     If virial should be updated.
+     * \param[in,out] d_virialScaled    Scaled virial to add to (in GPU memory).
+     * \param[in]     pbcAiuc           PBC data.
+     */
+    void launch(const DeviceBuffer<Float3>& d_x,
+                DeviceBuffer<Float3>        d_xp,
+                bool                        updateVelocities,
+                DeviceBuffer<Float3>        d_v,
+                real                        invdt,
+                bool                        computeVirial,
+                DeviceBuffer<float>         d_virialScaled,
+                const PbcAiuc&              pbcAiuc);
+
     /*! \brief
      * Update data-structures (e.g. after NB search step).
      *
@@ -199,6 +233,8 @@ private:
 
     //! Scaled virial tensor (6 floats: [XX, XY, XZ, YY, YZ, ZZ])
     std::vector<float> h_virialScaled_;
+    //! Scaled virial tensor used by apply() (6 floats: [XX, XY, XZ, YY, YZ, ZZ], GPU)
+    DeviceBuffer<float> d_virialScaled_;
 
     /*! \brief Maximum total number of constraints so far.
      *
@@ -57,9 +57,6 @@
 namespace gmx
 {
 
-//! Maximum number of threads in a block (for __launch_bounds__)
-constexpr static int c_maxThreadsPerBlock = c_threadsPerBlock;
-
 /*! \brief Main kernel for LINCS constraints.
  *
  * See Hess et al., J. Comput. Chem. 18: 1463-1472 (1997) for the description of the algorithm.
@@ -83,11 +80,14 @@ constexpr static int c_maxThreadsPerBlock = c_threadsPerBlock;
  * \todo The use of __restrict__  for gm_xp and gm_v causes failure, probably because of the atomic
          operations. Investigate this issue further.
  *
+ * \tparam largeBlocks  Whether the block is larger than \c c_threadsPerBlock, which is needed
+ *                     when a group of coupled constraints does not fit in \c c_threadsPerBlock.
+ *
  * \param[in,out] kernelParams  All parameters and pointers for the kernel condensed in single struct.
  * \param[in]     invdt         Inverse timestep (needed to update velocities).
  */
-template<bool updateVelocities, bool computeVirial>
-__launch_bounds__(c_maxThreadsPerBlock) __global__
+template<bool largeBlocks, bool updateVelocities, bool computeVirial>
+__launch_bounds__(largeBlocks ? c_maxThreadsPerBlock : c_threadsPerBlock) __global__
         void lincs_kernel(LincsGpuKernelParameters kernelParams,
                           const float3* __restrict__ gm_x,
                           float3*     gm_xp,
@@ -383,30 +383,32 @@ __launch_bounds__(c_maxThreadsPerBlock) __global__
  *
  * Returns pointer to a CUDA kernel based on provided booleans.
  *
+ * \tparam    largeBlocks       If blocks larger than \c c_threadsPerBlock are used.
  * \param[in] updateVelocities  If the velocities should be constrained.
  * \param[in] computeVirial     If virial should be updated.
  *
  * \return                      Pointer to CUDA kernel
  */
+template<bool largeBlocks>
 inline auto getLincsKernelPtr(const bool updateVelocities, const bool computeVirial)
 {
 
-    auto kernelPtr = lincs_kernel<true, true>;
+    auto kernelPtr = lincs_kernel<largeBlocks, true, true>;
     if (updateVelocities && computeVirial)
     {
-        kernelPtr = lincs_kernel<true, true>;
+        kernelPtr = lincs_kernel<largeBlocks, true, true>;
     }
     else if (updateVelocities && !computeVirial)
     {
-        kernelPtr = lincs_kernel<true, false>;
+        kernelPtr = lincs_kernel<largeBlocks, true, false>;
     }
     else if (!updateVelocities && computeVirial)
     {
-        kernelPtr = lincs_kernel<false, true>;
+        kernelPtr = lincs_kernel<largeBlocks, false, true>;
     }
     else if (!updateVelocities && !computeVirial)
     {
-        kernelPtr = lincs_kernel<false, false>;
+        kernelPtr = lincs_kernel<largeBlocks, false, false>;
     }
     return kernelPtr;
 }
@@ -421,13 +423,17 @@ void launchLincsGpuKernel(LincsGpuKernelParameters*   kernelParams,
                           const DeviceStream&         deviceStream)
 {
 
-    auto kernelPtr = getLincsKernelPtr(updateVelocities, computeVirial);
+    const int  threadsPerBlock = kernelParams->threadsPerBlock;
+    const bool largeBlocks     = (threadsPerBlock > c_threadsPerBlock);
+
+    auto kernelPtr = largeBlocks ? getLincsKernelPtr<true>(updateVelocities, computeVirial)
+                                 : getLincsKernelPtr<false>(updateVelocities, computeVirial);
 
     KernelLaunchConfig config;
-    config.blockSize[0] = c_threadsPerBlock;
+    config.blockSize[0] = threadsPerBlock;
     config.blockSize[1] = 1;
     config.blockSize[2] = 1;
-    config.gridSize[0] = (kernelParams->numConstraintsThreads + c_threadsPerBlock - 1) / c_threadsPerBlock;
+    config.gridSize[0] = (kernelParams->numConstraintsThreads + threadsPerBlock - 1) / threadsPerBlock;
     config.gridSize[1] = 1;
     config.gridSize[2] = 1;
 
@@ -440,11 +446,11 @@ void launchLincsGpuKernel(LincsGpuKernelParameters*   kernelParams,
     // max{3, 2, 6} = 6 floats per thread are needed in case virial is computed, or max{3, 2} = 3 if not.
     if (computeVirial)
     {
-        config.sharedMemorySize = c_threadsPerBlock * 6 * sizeof(float);
+        config.sharedMemorySize = threadsPerBlock * 6 * sizeof(float);
     }
     else
     {
-        config.sharedMemorySize = c_threadsPerBlock * 3 * sizeof(float);
+        config.sharedMemorySize = threadsPerBlock * 3 * sizeof(float);
     }
 
     const auto kernelArgs = prepareGpuKernelArguments(kernelPtr,
@@ -459,7 +465,7 @@ void launchLincsGpuKernel(LincsGpuKernelParameters*   kernelParams,
                     config,
                     deviceStream,
                     nullptr,
-                    "lincs_kernel<updateVelocities, computeVirial>",
+                    "lincs_kernel<largeBlocks, updateVelocities, computeVirial>",
                     kernelArgs);
 }
 
@@ -56,6 +56,13 @@ struct LincsGpuKernelParameters;
 
 //! Number of threads in a GPU block
 constexpr static int c_threadsPerBlock = 64;
+/*! \brief Maximum number of threads in a GPU block.
+ *
+ * Coupled constraints are handled in one block, so this is the largest group of coupled
+ * constraints the GPU LINCS can handle. Larger blocks are only used when a group does not
+ * fit in \c c_threadsPerBlock threads.
+ */
+constexpr static int c_maxThreadsPerBlock = 1024;
 
 /*! \brief Backend-specific function to launch LINCS kernel.
  *
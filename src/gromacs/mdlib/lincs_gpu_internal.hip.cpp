@@ -58,9 +58,6 @@
 namespace gmx
 {
 
-//! Maximum number of threads in a block (for __launch_bounds__)
-constexpr static int c_maxThreadsPerBlock = c_threadsPerBlock;
-
 /*! \brief Main kernel for LINCS constraints.
  *
  * See Hess et al., J. Comput. Chem. 18: 1463-1472 (1997) for the description of the algorithm.
@@ -84,11 +81,14 @@ constexpr static int c_maxThreadsPerBlock = c_threadsPerBlock;
  * \todo The use of __restrict__  for gm_xp and gm_v causes failure, probably because of the atomic
          operations. Investigate this issue further.
  *
+ * \tparam largeBlocks  Whether the block is larger than \c c_threadsPerBlock, which is needed
+ *                     when a group of coupled constraints does not fit in \c c_threadsPerBlock.
+ *
  * \param[in,out] kernelParams  All parameters and pointers for the kernel condensed in single struct.
  * \param[in]     invdt         Inverse timestep (needed to update velocities).
  */
-template<bool updateVelocities, bool computeVirial>
-__launch_bounds__(c_maxThreadsPerBlock) __global__
+template<bool largeBlocks, bool updateVelocities, bool computeVirial>
+__launch_bounds__(largeBlocks ? c_maxThreadsPerBlock : c_threadsPerBlock) __global__
         void lincs_kernel(LincsGpuKernelParameters kernelParams,
                           const float3* __restrict__ gm_x,
                           float3*     gm_xp,
@@ -108,7 +108,9 @@ __launch_bounds__(c_maxThreadsPerBlock) __global__
     const float* __restrict__ gm_inverseMasses           = kernelParams.d_inverseMasses;
     float* __restrict__ gm_virialScaled                  = kernelParams.d_virialScaled;
 
-    const int threadIndex = blockIdx.x * c_threadsPerBlock + threadIdx.x;
+    // The block size is a compile-time constant unless large blocks are needed
+    const int blockSize   = largeBlocks ? static_cast<int>(blockDim.x) : c_threadsPerBlock;
+    const int threadIndex = blockIdx.x * blockSize + threadIdx.x;
 
     // numConstraintsThreads should be a integer multiple of blockSize (numConstraintsThreads = numBlocks*blockSize).
     // This is to ensure proper synchronizations and reduction. All array are padded to the required size.
@@ -221,11 +223,11 @@ __launch_bounds__(c_maxThreadsPerBlock) __global__
             int c1    = gm_coupledConstraintsIndices[index];
             // Convolute current right-hand-side with A
             // Different, non overlapping parts of sm_rhs[..] are read during odd and even iterations
-            mvb = mvb + gm_matrixA[index] * sm_rhs[c1 + c_threadsPerBlock * (rec % 2)];
+            mvb = mvb + gm_matrixA[index] * sm_rhs[c1 + blockSize * (rec % 2)];
         }
         // 'Switch' rhs vectors, save current result
         // These values will be accessed in the loop above during the next iteration.
-        sm_rhs[threadIdx.x + c_threadsPerBlock * ((rec + 1) % 2)] = mvb;
+        sm_rhs[threadIdx.x + blockSize * ((rec + 1) % 2)] = mvb;
         sol                                                = sol + mvb;
     }
 
@@ -291,9 +293,9 @@ __launch_bounds__(c_maxThreadsPerBlock) __global__
                 int index = n * numConstraintsThreads + threadIndex;
                 int c1    = gm_coupledConstraintsIndices[index];
 
-                mvb = mvb + gm_matrixA[index] * sm_rhs[c1 + c_threadsPerBlock * (rec % 2)];
+                mvb = mvb + gm_matrixA[index] * sm_rhs[c1 + blockSize * (rec % 2)];
             }
-            sm_rhs[threadIdx.x + c_threadsPerBlock * ((rec + 1) % 2)] = mvb;
+            sm_rhs[threadIdx.x + blockSize * ((rec + 1) % 2)] = mvb;
             sol                                                = sol + mvb;
         }
 
@@ -341,12 +343,12 @@ __launch_bounds__(c_maxThreadsPerBlock) __global__
         __syncthreads();
         extern __shared__ float sm_threadVirial[];
         float                   mult                  = targetLength * lagrangeScaled;
-        sm_threadVirial[0 * c_threadsPerBlock + threadIdx.x] = mult * rc.x * rc.x;
-        sm_threadVirial[1 * c_threadsPerBlock + threadIdx.x] = mult * rc.x * rc.y;
-        sm_threadVirial[2 * c_threadsPerBlock + threadIdx.x] = mult * rc.x * rc.z;
-        sm_threadVirial[3 * c_threadsPerBlock + threadIdx.x] = mult * rc.y * rc.y;
-        sm_threadVirial[4 * c_threadsPerBlock + threadIdx.x] = mult * rc.y * rc.z;
-        sm_threadVirial[5 * c_threadsPerBlock + threadIdx.x] = mult * rc.z * rc.z;
+        sm_threadVirial[0 * blockSize + threadIdx.x] = mult * rc.x * rc.x;
+        sm_threadVirial[1 * blockSize + threadIdx.x] = mult * rc.x * rc.y;
+        sm_threadVirial[2 * blockSize + threadIdx.x] = mult * rc.x * rc.z;
+        sm_threadVirial[3 * blockSize + threadIdx.x] = mult * rc.y * rc.y;
+        sm_threadVirial[4 * blockSize + threadIdx.x] = mult * rc.y * rc.z;
+        sm_threadVirial[5 * blockSize + threadIdx.x] = mult * rc.z * rc.z;
 
         __syncthreads();
 
@@ -355,15 +357,15 @@ __launch_bounds__(c_maxThreadsPerBlock) __global__
         // half of it sums two values. This procedure is repeated until only one thread is left.
         // Only works if the threads per blocks is a power of two (hence static_assert
         // in the beginning of the kernel).
-        for (int divideBy = 2; divideBy <= static_cast<int>(c_threadsPerBlock); divideBy *= 2)
+        for (int divideBy = 2; divideBy <= blockSize; divideBy *= 2)
         {
-            int dividedAt = c_threadsPerBlock / divideBy;
+            int dividedAt = blockSize / divideBy;
             if (static_cast<int>(threadIdx.x) < dividedAt)
             {
                 for (int d = 0; d < 6; d++)
                 {
-                    sm_threadVirial[d * c_threadsPerBlock + threadIdx.x] +=
-                            sm_threadVirial[d * c_threadsPerBlock + (threadIdx.x + dividedAt)];
+                    sm_threadVirial[d * blockSize + threadIdx.x] +=
+                            sm_threadVirial[d * blockSize + (threadIdx.x + dividedAt)];
                 }
             }
             // Syncronize if not within one warp
@@ -375,7 +377,7 @@ __launch_bounds__(c_maxThreadsPerBlock) __global__
         // First 6 threads in the block add the results of 6 tensor components to the global memory address.
         if (threadIdx.x < 6)
         {
-            atomicAdd(&(gm_virialScaled[threadIdx.x]), sm_threadVirial[threadIdx.x * c_threadsPerBlock]);
+            atomicAdd(&(gm_virialScaled[threadIdx.x]), sm_threadVirial[threadIdx.x * blockSize]);
         }
     }
 }
@@ -384,30 +386,32 @@ __launch_bounds__(c_maxThreadsPerBlock) __global__
  *
  * Returns pointer to a HIP kernel based on provided booleans.
  *
+ * \tparam    largeBlocks       If blocks larger than \c c_threadsPerBlock are used.
  * \param[in] updateVelocities  If the velocities should be constrained.
  * \param[in] computeVirial     If virial should be updated.
  *
  * \return                      Pointer to HIP kernel
  */
+template<bool largeBlocks>
 inline auto getLincsKernelPtr(const bool updateVelocities, const bool computeVirial)
 {
 
-    auto kernelPtr = lincs_kernel<true, true>;
+    auto kernelPtr = lincs_kernel<largeBlocks, true, true>;
     if (updateVelocities && computeVirial)
     {
-        kernelPtr = lincs_kernel<true, true>;
+        kernelPtr = lincs_kernel<largeBlocks, true, true>;
     }
     else if (updateVelocities && !computeVirial)
     {
-        kernelPtr = lincs_kernel<true, false>;
+        kernelPtr = lincs_kernel<largeBlocks, true, false>;
     }
     else if (!updateVelocities && computeVirial)
     {
-        kernelPtr = lincs_kernel<false, true>;
+        kernelPtr = lincs_kernel<largeBlocks, false, true>;
     }
     else if (!updateVelocities && !computeVirial)
     {
-        kernelPtr = lincs_kernel<false, false>;
+        kernelPtr = lincs_kernel<largeBlocks, false, false>;
     }
     return kernelPtr;
 }
@@ -422,13 +426,17 @@ void launchLincsGpuKernel(LincsGpuKernelParameters*   kernelParams,
                           const DeviceStream&         deviceStream)
 {
 
-    auto kernelPtr = getLincsKernelPtr(updateVelocities, computeVirial);
+    const int  threadsPerBlock = kernelParams->threadsPerBlock;
+    const bool largeBlocks     = (threadsPerBlock > c_threadsPerBlock);
+
+    auto kernelPtr = largeBlocks ? getLincsKernelPtr<true>(updateVelocities, computeVirial)
+                                 : getLincsKernelPtr<false>(updateVelocities, computeVirial);
 
     KernelLaunchConfig config;
-    config.blockSize[0] = c_threadsPerBlock;
+    config.blockSize[0] = threadsPerBlock;
     config.blockSize[1] = 1;
     config.blockSize[2] = 1;
-    config.gridSize[0] = (kernelParams->numConstraintsThreads + c_threadsPerBlock - 1) / c_threadsPerBlock;
+    config.gridSize[0] = (kernelParams->numConstraintsThreads + threadsPerBlock - 1) / threadsPerBlock;
     config.gridSize[1] = 1;
     config.gridSize[2] = 1;
 
@@ -441,11 +449,11 @@ void launchLincsGpuKernel(LincsGpuKernelParameters*   kernelParams,
     // max{3, 2, 6} = 6 floats per thread are needed in case virial is computed, or max{3, 2} = 3 if not.
     if (computeVirial)
     {
-        config.sharedMemorySize = c_threadsPerBlock * 6 * sizeof(float);
+        config.sharedMemorySize = threadsPerBlock * 6 * sizeof(float);
     }
     else
     {
-        config.sharedMemorySize = c_threadsPerBlock * 3 * sizeof(float);
+        config.sharedMemorySize = threadsPerBlock * 3 * sizeof(float);
     }
 
     const auto kernelArgs = prepareGpuKernelArguments(kernelPtr,
@@ -460,7 +468,7 @@ void launchLincsGpuKernel(LincsGpuKernelParameters*   kernelParams,
                     config,
                     deviceStream,
                     nullptr,
-                    "lincs_kernel<updateVelocities, computeVirial>",
+                    "lincs_kernel<largeBlocks, updateVelocities, computeVirial>",
                     kernelArgs);
 }
 
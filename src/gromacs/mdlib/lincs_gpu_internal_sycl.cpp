@@ -87,6 +87,7 @@ using mode = sycl::access_mode;
  *
  * \param[in]     cgh                           SYCL handler.
  * \param[in]     numConstraintsThreads         Total number of threads.
+ * \param[in]     threadsPerBlock               Number of threads in a block.
  * \param[in]     a_constraints                 List of constrained atoms.
  * \param[in]     a_constraintsTargetLengths    Equilibrium distances for the constraints.
  * \param[in]     a_coupledConstraintsCounts    Number of constraints, coupled with the current one.
@@ -107,6 +108,7 @@ using mode = sycl::access_mode;
 template<bool updateVelocities, bool computeVirial, bool haveCoupledConstraints>
 auto lincsKernel(sycl::handler&                       cgh,
                  const int                            numConstraintsThreads,
+                 const int                            threadsPerBlock,
                  DeviceAccessor<AtomPair, mode::read> a_constraints,
                  DeviceAccessor<float, mode::read>    a_constraintsTargetLengths,
                  OptionalAccessor<int, mode::read, haveCoupledConstraints> a_coupledConstraintsCounts,
@@ -152,7 +154,7 @@ auto lincsKernel(sycl::handler&                       cgh,
      */
     static constexpr int                smBufferElementsPerThread = computeVirial ? 6 : 3;
     sycl_2020::local_accessor<float, 1> sm_buffer{
-        sycl::range<1>(c_threadsPerBlock * smBufferElementsPerThread), cgh
+        sycl::range<1>(threadsPerBlock * smBufferElementsPerThread), cgh
     };
 
     return [=](sycl::nd_item<1> itemIdx) {
@@ -272,11 +274,11 @@ auto lincsKernel(sycl::handler&                       cgh,
                     int c1    = a_coupledConstraintsIndices[index];
                     // Convolute current right-hand-side with A
                     // Different, non overlapping parts of sm_buffer[..] are read during odd and even iterations
-                    mvb = mvb + a_matrixA[index] * sm_buffer[c1 + c_threadsPerBlock * (rec % 2)];
+                    mvb = mvb + a_matrixA[index] * sm_buffer[c1 + threadsPerBlock * (rec % 2)];
                 }
                 // 'Switch' rhs vectors, save current result
                 // These values will be accessed in the loop above during the next iteration.
-                sm_buffer[threadInBlock + c_threadsPerBlock * ((rec + 1) % 2)] = mvb;
+                sm_buffer[threadInBlock + threadsPerBlock * ((rec + 1) % 2)] = mvb;
 
                 sol = sol + mvb;
             }
@@ -358,10 +360,10 @@ auto lincsKernel(sycl::handler&                       cgh,
                         int index = n * numConstraintsThreads + threadIndex;
                         int c1    = a_coupledConstraintsIndices[index];
 
-                        mvb = mvb + a_matrixA[index] * sm_buffer[c1 + c_threadsPerBlock * (rec % 2)];
+                        mvb = mvb + a_matrixA[index] * sm_buffer[c1 + threadsPerBlock * (rec % 2)];
                     }
 
-                    sm_buffer[threadInBlock + c_threadsPerBlock * ((rec + 1) % 2)] = mvb;
+                    sm_buffer[threadInBlock + threadsPerBlock * ((rec + 1) % 2)] = mvb;
                     sol                                                            = sol + mvb;
                 }
             }
@@ -418,17 +420,17 @@ auto lincsKernel(sycl::handler&                       cgh,
             // We reuse the same shared memory buffer, so we make sure we don't need its old values:
             itemIdx.barrier(fence_space::local_space);
             float mult                                       = targetLength * lagrangeScaled;
-            sm_buffer[0 * c_threadsPerBlock + threadInBlock] = mult * rc[XX] * rc[XX];
-            sm_buffer[1 * c_threadsPerBlock + threadInBlock] = mult * rc[XX] * rc[YY];
-            sm_buffer[2 * c_threadsPerBlock + threadInBlock] = mult * rc[XX] * rc[ZZ];
-            sm_buffer[3 * c_threadsPerBlock + threadInBlock] = mult * rc[YY] * rc[YY];
-            sm_buffer[4 * c_threadsPerBlock + threadInBlock] = mult * rc[YY] * rc[ZZ];
-            sm_buffer[5 * c_threadsPerBlock + threadInBlock] = mult * rc[ZZ] * rc[ZZ];
+            sm_buffer[0 * threadsPerBlock + threadInBlock] = mult * rc[XX] * rc[XX];
+            sm_buffer[1 * threadsPerBlock + threadInBlock] = mult * rc[XX] * rc[YY];
+            sm_buffer[2 * threadsPerBlock + threadInBlock] = mult * rc[XX] * rc[ZZ];
+            sm_buffer[3 * threadsPerBlock + threadInBlock] = mult * rc[YY] * rc[YY];
+            sm_buffer[4 * threadsPerBlock + threadInBlock] = mult * rc[YY] * rc[ZZ];
+            sm_buffer[5 * threadsPerBlock + threadInBlock] = mult * rc[ZZ] * rc[ZZ];
 
             itemIdx.barrier(fence_space::local_space);
             // This casts unsigned into signed integers to avoid clang warnings
             const int tib          = static_cast<int>(threadInBlock);
-            const int blockSize    = static_cast<int>(c_threadsPerBlock);
+            const int blockSize    = threadsPerBlock;
             const int subGroupSize = itemIdx.get_sub_group().get_max_local_range()[0];
 
             // Reduce up to one virial per thread block
@@ -471,17 +473,18 @@ class LincsKernelName;
 template<bool updateVelocities, bool computeVirial, bool haveCoupledConstraints, class... Args>
 static sycl::event launchLincsKernel(const DeviceStream& deviceStream,
                                      const int           numConstraintsThreads,
+                                     const int           threadsPerBlock,
                                      Args&&... args)
 {
     // Should not be needed for SYCL2020.
     using kernelNameType = LincsKernelName<updateVelocities, computeVirial, haveCoupledConstraints>;
 
-    const sycl::nd_range<1> rangeAllLincs(numConstraintsThreads, c_threadsPerBlock);
+    const sycl::nd_range<1> rangeAllLincs(numConstraintsThreads, threadsPerBlock);
     sycl::queue             q = deviceStream.stream();
 
     sycl::event e = q.submit([&](sycl::handler& cgh) {
         auto kernel = lincsKernel<updateVelocities, computeVirial, haveCoupledConstraints>(
-                cgh, numConstraintsThreads, std::forward<Args>(args)...);
+                cgh, numConstraintsThreads, threadsPerBlock, std::forward<Args>(args)...);
         cgh.parallel_for<kernelNameType>(rangeAllLincs, kernel);
     });
 
@@ -518,6 +521,7 @@ void launchLincsGpuKernel(LincsGpuKernelParameters*   kernelParams,
                       kernelParams->haveCoupledConstraints,
                       deviceStream,
                       kernelParams->numConstraintsThreads,
+                      kernelParams->threadsPerBlock,
                       kernelParams->d_constraints,
                       kernelParams->d_constraintsTargetLengths,
                       kernelParams->d_coupledConstraintsCounts,
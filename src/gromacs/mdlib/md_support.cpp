@@ -139,11 +139,30 @@ static void calc_ke_part_normal(gmx::ArrayRef<const gmx::RVec> v,
         }
         *dekindl_sum = 0.0;
 
+        /* We accumulate in double precision over runs of atoms in the same
+         * temperature-coupling group, so the sum does not lose precision
+         * with many atoms in single precision builds.
+         */
+        double ekinGroup[DIM][DIM] = { { 0 } };
+        double dekindlThread       = 0;
+
         gt = 0;
+        if (md->cTC && start_t < end_t)
+        {
+            gt = md->cTC[start_t];
+        }
         for (n = start_t; n < end_t; n++)
         {
-            if (md->cTC)
+            if (md->cTC && md->cTC[n] != gt)
             {
+                for (d = 0; d < DIM; d++)
+                {
+                    for (m = 0; m < DIM; m++)
+                    {
+                        ekin_sum[gt][m][d] += ekinGroup[m][d];
+                        ekinGroup[m][d] = 0;
+                    }
+                }
                 gt = md->cTC[n];
             }
             hm = 0.5 * md->massT[n];
@@ -153,14 +172,22 @@ static void calc_ke_part_normal(gmx::ArrayRef<const gmx::RVec> v,
                 for (m = 0; (m < DIM); m++)
                 {
                     /* if we're computing a full step velocity, v[d] has v(t).  Otherwise, v(t+dt/2) */
-                    ekin_sum[gt][m][d] += hm * v[n][m] * v[n][d];
+                    ekinGroup[m][d] += hm * v[n][m] * v[n][d];
                 }
             }
             if (md->nMassPerturbed && md->bPerturbed[n])
             {
-                *dekindl_sum += 0.5 * (md->massB[n] - md->massA[n]) * iprod(v[n], v[n]);
+                dekindlThread += 0.5 * (md->massB[n] - md->massA[n]) * iprod(v[n], v[n]);
+            }
+        }
+        for (d = 0; d < DIM; d++)
+        {
+            for (m = 0; m < DIM; m++)
+            {
+                ekin_sum[gt][m][d] += ekinGroup[m][d];
             }
         }
+        *dekindl_sum = dekindlThread;
     }
 
     ekind->dekindl = 0;
@@ -0,0 +1,149 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Declares the MD GPU graph class, which captures the GPU work of
+ * a regular MD step into a device graph and replays it on later steps.
+ *
+ * \ingroup module_mdlib
+ */
+#ifndef GMX_MDLIB_MDGRAPH_GPU_H
+#define GMX_MDLIB_MDGRAPH_GPU_H
+
+#include <memory>
+
+#include "config.h"
+
+#include "gromacs/timing/wallcycle.h"
+
+class DeviceStreamManager;
+class GpuEventSynchronizer;
+
+namespace gmx
+{
+
+#define HAVE_MD_GPU_GRAPH (GMX_GPU_HIP)
+
+/*! \internal
+ * \brief Manages the capture and replay of the GPU work of an MD step
+ *
+ * When all work of an MD step is resident on a single GPU, the
+ * sequence of kernels, copies and inter-stream dependencies launched
+ * between two consecutive pair-search steps is identical on every
+ * step that does not compute energies, the virial, couple to a bath
+ * or a barostat, or produce output. On such steps the work is
+ * captured once into a graph with stream capture, starting and ending
+ * in the update stream which all other streams are forked from and
+ * joined into. The executable graph is then launched instead of
+ * repeating the individual launches on all subsequent eligible steps,
+ * which removes the per-launch host overhead that dominates small
+ * systems.
+ *
+ * The graph is invalidated on every search step, since the pair list,
+ * the atom ordering and the buffers may change. The executable graph
+ * is kept and updated in-place from the next capture when the graph
+ * topology allows it, otherwise it is re-instantiated.
+ */
+class MdGpuGraph
+{
+public:
+    /*! \brief Create MD graph object
+     *
+     * \param [in] deviceStreamManager  Device stream manager object
+     * \param [in] wcycle               Wall cycle timer object
+     */
+    MdGpuGraph(const DeviceStreamManager& deviceStreamManager, gmx_wallcycle* wcycle);
+
+    ~MdGpuGraph();
+
+    /*! \brief Invalidate the captured graph
+     *
+     * Must be called on steps where the pair list, domain decomposition
+     * or device buffers may have changed, before any GPU work of the step
+     * is launched.
+     */
+    void reset();
+
+    /*! \brief Decide whether the graph is used this step
+     *
+     * Must be called on each step before the force calculation is launched.
+     * If \p canUseGraphThisStep is true and no graph is available, the
+     * GPU work of this step will be captured.
+     *
+     * \param [in] canUseGraphThisStep  Whether the GPU work of this step
+     *                                  is identical to that of a regular step
+     */
+    void setUseGraphThisStep(bool canUseGraphThisStep);
+
+    //! Whether the graph is launched this step, instead of the individual GPU tasks.
+    bool useGraphThisStep() const;
+
+    //! Whether the GPU work of this step is being captured into the graph.
+    bool graphIsCapturingThisStep() const;
+
+    /*! \brief Start the capture of the GPU work of this step
+     *
+     * Begins stream capture in the update stream and forks all other
+     * streams from it. The coordinates-ready event is re-marked inside the
+     * capture, so that the work consuming it depends on a captured node
+     * rather than on work submitted before the capture.
+     *
+     * \param [in] xReadyOnDeviceEvent  Event marked when coordinates are ready on device
+     */
+    void startRecord(GpuEventSynchronizer* xReadyOnDeviceEvent);
+
+    /*! \brief End the capture of the GPU work of this step
+     *
+     * Joins all streams into the update stream, ends the stream capture
+     * and creates (or updates) the executable graph.
+     */
+    void endRecord();
+
+    /*! \brief Launch the executable graph in the update stream
+     *
+     * \param [in] xUpdatedOnDeviceEvent  Event marked when the coordinates
+     *                                    updated by the graph are ready on device
+     */
+    void launchGraphMdStep(GpuEventSynchronizer* xUpdatedOnDeviceEvent);
+
+    class Impl;
+
+private:
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace gmx
+
+#endif
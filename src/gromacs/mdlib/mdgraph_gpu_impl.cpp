@@ -0,0 +1,245 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Implements the MD GPU graph with HIP stream capture.
+ *
+ * \ingroup module_mdlib
+ */
+
+#include "gmxpre.h"
+
+#include "mdgraph_gpu_impl.h"
+
+#include "gromacs/gpu_utils/device_stream.h"
+#include "gromacs/utility/gmxassert.h"
+
+namespace gmx
+{
+
+MdGpuGraph::Impl::Impl(const DeviceStreamManager& deviceStreamManager, gmx_wallcycle* wcycle) :
+    launchStream_(deviceStreamManager.stream(DeviceStreamType::UpdateAndConstraints)),
+    wcycle_(wcycle)
+{
+    GMX_RELEASE_ASSERT(deviceStreamManager.streamIsValid(DeviceStreamType::UpdateAndConstraints),
+                       "The MD GPU graph requires a valid update stream");
+    for (const auto streamType : { DeviceStreamType::NonBondedLocal,
+                                   DeviceStreamType::NonBondedNonLocal,
+                                   DeviceStreamType::Pme,
+                                   DeviceStreamType::PmePpTransfer })
+    {
+        if (deviceStreamManager.streamIsValid(streamType))
+        {
+            forkedStreams_.push_back(&deviceStreamManager.stream(streamType));
+        }
+    }
+    const int numForkedStreams = static_cast<int>(forkedStreams_.size());
+    forkEvent_.setConsumptionLimits(numForkedStreams, numForkedStreams);
+}
+
+MdGpuGraph::Impl::~Impl()
+{
+    if (graphInstance_ != nullptr)
+    {
+        hipGraphExecDestroy(graphInstance_);
+    }
+    if (graph_ != nullptr)
+    {
+        hipGraphDestroy(graph_);
+    }
+}
+
+void MdGpuGraph::Impl::reset()
+{
+    // The executable graph is kept, so that it can be updated from the next capture.
+    haveValidGraph_           = false;
+    useGraphThisStep_         = false;
+    graphIsCapturingThisStep_ = false;
+}
+
+void MdGpuGraph::Impl::setUseGraphThisStep(const bool canUseGraphThisStep)
+{
+    useGraphThisStep_         = canUseGraphThisStep;
+    graphIsCapturingThisStep_ = canUseGraphThisStep && !haveValidGraph_;
+}
+
+void MdGpuGraph::Impl::startRecord(GpuEventSynchronizer* xReadyOnDeviceEvent)
+{
+    GMX_ASSERT(graphIsCapturingThisStep_, "startRecord called on a step which is not captured");
+
+    wallcycle_start_nocount(wcycle_, WallCycleCounter::LaunchGpu);
+    wallcycle_sub_start(wcycle_, WallCycleSubCounter::MdGpuGraph);
+
+    // The coordinates consumed by this step are produced by work submitted before the
+    // capture, so the dependency is taken outside the graph.
+    xReadyOnDeviceEvent->enqueueWaitEvent(launchStream_);
+
+    if (graph_ != nullptr)
+    {
+        hipError_t stat = hipGraphDestroy(graph_);
+        checkDeviceError(stat, "Failed to destroy the MD GPU graph.");
+        graph_ = nullptr;
+    }
+
+    hipError_t stat = hipStreamBeginCapture(launchStream_.stream(), hipStreamCaptureModeThreadLocal);
+    checkDeviceError(stat, "Failed to begin the capture of the MD GPU graph.");
+
+    // Fork all other streams from the launch stream so that their work becomes part of the graph
+    forkEvent_.markEvent(launchStream_);
+    for (const DeviceStream* stream : forkedStreams_)
+    {
+        forkEvent_.enqueueWaitEvent(*stream);
+    }
+
+    // Re-mark the coordinates-ready event inside the capture, so that all consumers depend on
+    // a captured node.
+    xReadyOnDeviceEvent->markEvent(launchStream_);
+
+    wallcycle_sub_stop(wcycle_, WallCycleSubCounter::MdGpuGraph);
+    wallcycle_stop(wcycle_, WallCycleCounter::LaunchGpu);
+}
+
+void MdGpuGraph::Impl::endRecord()
+{
+    GMX_ASSERT(graphIsCapturingThisStep_, "endRecord called on a step which is not captured");
+
+    wallcycle_start_nocount(wcycle_, WallCycleCounter::LaunchGpu);
+    wallcycle_sub_start(wcycle_, WallCycleSubCounter::MdGpuGraph);
+
+    // Join all other streams into the launch stream, capture can only end when all
+    // forked streams have been joined.
+    for (const DeviceStream* stream : forkedStreams_)
+    {
+        joinEvent_.markEvent(*stream);
+        joinEvent_.enqueueWaitEvent(launchStream_);
+    }
+
+    hipError_t stat = hipStreamEndCapture(launchStream_.stream(), &graph_);
+    checkDeviceError(stat, "Failed to end the capture of the MD GPU graph.");
+
+    createExecutableGraph();
+
+    haveValidGraph_           = true;
+    graphIsCapturingThisStep_ = false;
+
+    wallcycle_sub_stop(wcycle_, WallCycleSubCounter::MdGpuGraph);
+    wallcycle_stop(wcycle_, WallCycleCounter::LaunchGpu);
+}
+
+void MdGpuGraph::Impl::createExecutableGraph()
+{
+    if (graphInstance_ != nullptr)
+    {
+        // Between search steps only kernel arguments and buffer sizes change in the common
+        // case, which an in-place update handles at a fraction of the instantiation cost.
+        hipGraphNode_t           errorNode;
+        hipGraphExecUpdateResult updateResult;
+        hipError_t stat = hipGraphExecUpdate(graphInstance_, graph_, &errorNode, &updateResult);
+        if (stat == hipSuccess && updateResult == hipGraphExecUpdateSuccess)
+        {
+            return;
+        }
+        // Clear the sticky error from the failed update before re-instantiating
+        hipGetLastError();
+        stat = hipGraphExecDestroy(graphInstance_);
+        checkDeviceError(stat, "Failed to destroy the MD GPU graph instance.");
+        graphInstance_ = nullptr;
+    }
+
+    hipError_t stat = hipGraphInstantiate(&graphInstance_, graph_, nullptr, nullptr, 0);
+    checkDeviceError(stat, "Failed to instantiate the MD GPU graph.");
+}
+
+void MdGpuGraph::Impl::launchGraphMdStep(GpuEventSynchronizer* xUpdatedOnDeviceEvent)
+{
+    GMX_ASSERT(useGraphThisStep_ && haveValidGraph_,
+               "The MD GPU graph can only be launched after it has been captured");
+
+    wallcycle_start(wcycle_, WallCycleCounter::LaunchGpu);
+    wallcycle_sub_start(wcycle_, WallCycleSubCounter::MdGpuGraph);
+
+    hipError_t stat = hipGraphLaunch(graphInstance_, launchStream_.stream());
+    checkDeviceError(stat, "Failed to launch the MD GPU graph.");
+
+    // The event marked by the update inside the graph is not visible outside of it
+    xUpdatedOnDeviceEvent->markEvent(launchStream_);
+
+    wallcycle_sub_stop(wcycle_, WallCycleSubCounter::MdGpuGraph);
+    wallcycle_stop(wcycle_, WallCycleCounter::LaunchGpu);
+}
+
+MdGpuGraph::MdGpuGraph(const DeviceStreamManager& deviceStreamManager, gmx_wallcycle* wcycle) :
+    impl_(new Impl(deviceStreamManager, wcycle))
+{
+}
+
+MdGpuGraph::~MdGpuGraph() = default;
+
+void MdGpuGraph::reset()
+{
+    impl_->reset();
+}
+
+void MdGpuGraph::setUseGraphThisStep(const bool canUseGraphThisStep)
+{
+    impl_->setUseGraphThisStep(canUseGraphThisStep);
+}
+
+bool MdGpuGraph::useGraphThisStep() const
+{
+    return impl_->useGraphThisStep();
+}
+
+bool MdGpuGraph::graphIsCapturingThisStep() const
+{
+    return impl_->graphIsCapturingThisStep();
+}
+
+void MdGpuGraph::startRecord(GpuEventSynchronizer* xReadyOnDeviceEvent)
+{
+    impl_->startRecord(xReadyOnDeviceEvent);
+}
+
+void MdGpuGraph::endRecord()
+{
+    impl_->endRecord();
+}
+
+void MdGpuGraph::launchGraphMdStep(GpuEventSynchronizer* xUpdatedOnDeviceEvent)
+{
+    impl_->launchGraphMdStep(xUpdatedOnDeviceEvent);
+}
+
+} // namespace gmx
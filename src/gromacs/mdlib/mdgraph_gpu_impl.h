@@ -0,0 +1,112 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Declares the HIP implementation of the MD GPU graph.
+ *
+ * \ingroup module_mdlib
+ */
+#ifndef GMX_MDLIB_MDGRAPH_GPU_IMPL_H
+#define GMX_MDLIB_MDGRAPH_GPU_IMPL_H
+
+#include <vector>
+
+#include "gromacs/gpu_utils/device_stream_manager.h"
+#include "gromacs/gpu_utils/gpueventsynchronizer.h"
+#include "gromacs/gpu_utils/hiputils.hpp"
+
+#include "mdgraph_gpu.h"
+
+namespace gmx
+{
+
+class MdGpuGraph::Impl
+{
+public:
+    //! Constructor
+    Impl(const DeviceStreamManager& deviceStreamManager, gmx_wallcycle* wcycle);
+    // NOLINTNEXTLINE(performance-trivially-destructible)
+    ~Impl();
+
+    //! Invalidate the captured graph, see MdGpuGraph::reset()
+    void reset();
+
+    //! Decide whether the graph is used this step, see MdGpuGraph::setUseGraphThisStep()
+    void setUseGraphThisStep(bool canUseGraphThisStep);
+
+    //! Whether the graph is launched this step
+    bool useGraphThisStep() const { return useGraphThisStep_; }
+
+    //! Whether the GPU work of this step is being captured
+    bool graphIsCapturingThisStep() const { return graphIsCapturingThisStep_; }
+
+    //! Start the capture, see MdGpuGraph::startRecord()
+    void startRecord(GpuEventSynchronizer* xReadyOnDeviceEvent);
+
+    //! End the capture, see MdGpuGraph::endRecord()
+    void endRecord();
+
+    //! Launch the executable graph, see MdGpuGraph::launchGraphMdStep()
+    void launchGraphMdStep(GpuEventSynchronizer* xUpdatedOnDeviceEvent);
+
+private:
+    //! Create the executable graph from the captured graph, updating the existing one if possible
+    void createExecutableGraph();
+
+    //! Stream in which the capture starts and ends and the graph is launched
+    const DeviceStream& launchStream_;
+    //! All other valid streams, forked from and joined into the launch stream during capture
+    std::vector<const DeviceStream*> forkedStreams_;
+    //! Event used to fork the other streams from the launch stream
+    GpuEventSynchronizer forkEvent_;
+    //! Event used to join the other streams into the launch stream
+    GpuEventSynchronizer joinEvent_;
+    //! The captured graph
+    hipGraph_t graph_ = nullptr;
+    //! The executable graph
+    hipGraphExec_t graphInstance_ = nullptr;
+    //! Whether \c graph_ holds the work of the current pair list
+    bool haveValidGraph_ = false;
+    //! Whether the graph is launched this step
+    bool useGraphThisStep_ = false;
+    //! Whether the GPU work of this step is being captured
+    bool graphIsCapturingThisStep_ = false;
+    //! Wall cycle timer object
+    gmx_wallcycle* wcycle_;
+};
+
+} // namespace gmx
+
+#endif
@@ -45,6 +45,7 @@
 #include "gromacs/fileio/checkpoint.h"
 #include "gromacs/fileio/gmxfio.h"
 #include "gromacs/fileio/tngio.h"
+#include "gromacs/fileio/trajectorywriterthread.h"
 #include "gromacs/fileio/trrio.h"
 #include "gromacs/fileio/xtcio.h"
 #include "gromacs/math/vec.h"
@@ -75,6 +76,7 @@ struct gmx_mdoutf
 {
     t_fileio*                      fp_trn;
     t_fileio*                      fp_xtc;
+    gmx::TrajectoryWriterThread*   trajectoryWriter; /* writes XTC and TNG asynchronously if set */
     gmx_tng_trajectory_t           tng;
     gmx_tng_trajectory_t           tng_low_prec;
     int                            x_compression_precision; /* only used by XTC output */
@@ -124,6 +126,7 @@ gmx_mdoutf_t init_mdoutf(FILE*                          fplog,
     of->fp_trn       = nullptr;
     of->fp_ene       = nullptr;
     of->fp_xtc       = nullptr;
+    of->trajectoryWriter = nullptr;
     of->tng          = nullptr;
     of->tng_low_prec = nullptr;
     of->fp_dhdl      = nullptr;
@@ -157,7 +160,9 @@ gmx_mdoutf_t init_mdoutf(FILE*                          fplog,
             filename = ftp2fn(efCOMPRESSED, nfile, fnm);
             switch (fn2ftp(filename))
             {
-                case efXTC: of->fp_xtc = open_xtc(filename, filemode); break;
+                case efXTC:
+                    of->fp_xtc = open_xtc(filename, filemode);
+                    break;
                 case efTNG:
                     gmx_tng_open(filename, filemode[0], &of->tng_low_prec);
                     if (filemode[0] == 'w')
@@ -202,6 +207,10 @@ gmx_mdoutf_t init_mdoutf(FILE*                          fplog,
         {
             of->fp_ene = open_enx(ftp2fn(efEDR, nfile, fnm), filemode);
         }
+        if ((of->fp_xtc || of->tng || of->tng_low_prec) && getenv("GMX_TRAJECTORY_WRITER_THREAD") != nullptr)
+        {
+            of->trajectoryWriter = new gmx::TrajectoryWriterThread();
+        }
         of->fn_cpt = opt2fn("-cpo", nfile, fnm);
 
         if ((ir->efep != FreeEnergyPerturbationType::No || ir->bSimTemp) && ir->fepvals->nstdhdl > 0
@@ -506,6 +515,11 @@ void mdoutf_write_checkpoint(gmx_mdoutf_t                    of,
                              ObservablesHistory*             observablesHistory,
                              gmx::WriteCheckpointDataHolder* modularSimulatorCheckpointData)
 {
+    /* The checkpoint stores the output file positions, so all frames need to be written */
+    if (of->trajectoryWriter)
+    {
+        of->trajectoryWriter->flush();
+    }
     fflush_tng(of->tng);
     fflush_tng(of->tng_low_prec);
     /* Write the checkpoint file.
@@ -534,6 +548,36 @@ void mdoutf_write_checkpoint(gmx_mdoutf_t                    of,
                      of->mastersComm);
 }
 
+/*! \brief Writes a TNG frame, through the trajectory writer thread when present
+ *
+ * Does nothing when \p tng is nullptr, like gmx_fwrite_tng().
+ */
+static void writeTngFrame(gmx_mdoutf_t         of,
+                          gmx_tng_trajectory_t tng,
+                          bool                 useLossyCompression,
+                          int64_t              step,
+                          double               t,
+                          real                 lambda,
+                          const rvec*          box,
+                          int                  natoms,
+                          const rvec*          x,
+                          const rvec*          v,
+                          const rvec*          f)
+{
+    if (tng == nullptr)
+    {
+        return;
+    }
+    if (of->trajectoryWriter)
+    {
+        of->trajectoryWriter->writeTng(tng, useLossyCompression, step, t, lambda, box, natoms, x, v, f);
+    }
+    else
+    {
+        gmx_fwrite_tng(tng, useLossyCompression, step, t, lambda, box, natoms, x, v, f);
+    }
+}
+
 void mdoutf_write_to_trajectory_files(FILE*                           fplog,
                                       const t_commrec*                cr,
                                       gmx_mdoutf_t                    of,
@@ -635,31 +679,33 @@ void mdoutf_write_to_trajectory_files(FILE*                           fplog,
                velocities and forces to it. */
             else if (of->tng)
             {
-                gmx_fwrite_tng(of->tng,
-                               FALSE,
-                               step,
-                               t,
-                               state_local->lambda[FreeEnergyPerturbationCouplingType::Fep],
-                               state_local->box,
-                               natoms,
-                               x,
-                               v,
-                               f);
+                writeTngFrame(of,
+                              of->tng,
+                              FALSE,
+                              step,
+                              t,
+                              state_local->lambda[FreeEnergyPerturbationCouplingType::Fep],
+                              state_local->box,
+                              natoms,
+                              x,
+                              v,
+                              f);
             }
             /* If only a TNG file is open for compressed coordinate output (no uncompressed
                coordinate output) also write forces and velocities to it. */
             else if (of->tng_low_prec)
             {
-                gmx_fwrite_tng(of->tng_low_prec,
-                               FALSE,
-                               step,
-                               t,
-                               state_local->lambda[FreeEnergyPerturbationCouplingType::Fep],
-                               state_local->box,
-                               natoms,
-                               x,
-                               v,
-                               f);
+                writeTngFrame(of,
+                              of->tng_low_prec,
+                              FALSE,
+                              step,
+                              t,
+                              state_local->lambda[FreeEnergyPerturbationCouplingType::Fep],
+                              state_local->box,
+                              natoms,
+                              x,
+                              v,
+                              f);
             }
         }
         if (mdof_flags & MDOF_X_COMPRESSED)
@@ -689,24 +735,35 @@ void mdoutf_write_to_trajectory_files(FILE*                           fplog,
                     }
                 }
             }
-            if (write_xtc(of->fp_xtc, of->natoms_x_compressed, step, t, state_local->box, xxtc, of->x_compression_precision)
-                == 0)
+            if (of->trajectoryWriter && of->fp_xtc)
+            {
+                of->trajectoryWriter->writeXtc(of->fp_xtc,
+                                               of->x_compression_precision,
+                                               step,
+                                               t,
+                                               state_local->box,
+                                               of->natoms_x_compressed,
+                                               xxtc);
+            }
+            else if (write_xtc(of->fp_xtc, of->natoms_x_compressed, step, t, state_local->box, xxtc, of->x_compression_precision)
+                     == 0)
             {
                 gmx_fatal(FARGS,
                           "XTC error. This indicates you are out of disk space, or a "
                           "simulation with major instabilities resulting in coordinates "
                           "that are NaN or too large to be represented in the XTC format.\n");
             }
-            gmx_fwrite_tng(of->tng_low_prec,
-                           TRUE,
-                           step,
-                           t,
-                           state_local->lambda[FreeEnergyPerturbationCouplingType::Fep],
-                           state_local->box,
-                           of->natoms_x_compressed,
-                           xxtc,
-                           nullptr,
-                           nullptr);
+            writeTngFrame(of,
+                          of->tng_low_prec,
+                          TRUE,
+                          step,
+                          t,
+                          state_local->lambda[FreeEnergyPerturbationCouplingType::Fep],
+                          state_local->box,
+                          of->natoms_x_compressed,
+                          xxtc,
+                          nullptr,
+                          nullptr);
             if (of->natoms_x_compressed != of->natoms_global)
             {
                 sfree(xxtc);
@@ -726,7 +783,17 @@ void mdoutf_write_to_trajectory_files(FILE*                           fplog,
                 {
                     lambda = state_local->lambda[FreeEnergyPerturbationCouplingType::Fep];
                 }
-                gmx_fwrite_tng(of->tng, FALSE, step, t, lambda, box, natoms, nullptr, nullptr, nullptr);
+                writeTngFrame(of,
+                              of->tng,
+                              FALSE,
+                              step,
+                              t,
+                              lambda,
+                              box,
+                              natoms,
+                              nullptr,
+                              nullptr,
+                              nullptr);
             }
         }
         if (mdof_flags & (MDOF_BOX_COMPRESSED | MDOF_LAMBDA_COMPRESSED)
@@ -744,7 +811,17 @@ void mdoutf_write_to_trajectory_files(FILE*                           fplog,
                 {
                     lambda = state_local->lambda[FreeEnergyPerturbationCouplingType::Fep];
                 }
-                gmx_fwrite_tng(of->tng_low_prec, FALSE, step, t, lambda, box, natoms, nullptr, nullptr, nullptr);
+                writeTngFrame(of,
+                              of->tng_low_prec,
+                              FALSE,
+                              step,
+                              t,
+                              lambda,
+                              box,
+                              natoms,
+                              nullptr,
+                              nullptr,
+                              nullptr);
             }
         }
 
@@ -764,6 +841,10 @@ void mdoutf_tng_close(gmx_mdoutf_t of)
     if (of->tng || of->tng_low_prec)
     {
         wallcycle_start(of->wcycle, WallCycleCounter::Traj);
+        if (of->trajectoryWriter)
+        {
+            of->trajectoryWriter->flush();
+        }
         gmx_tng_close(&of->tng);
         gmx_tng_close(&of->tng_low_prec);
         wallcycle_stop(of->wcycle, WallCycleCounter::Traj);
@@ -776,6 +857,12 @@ void done_mdoutf(gmx_mdoutf_t of)
     {
         done_ener_file(of->fp_ene);
     }
+    if (of->trajectoryWriter)
+    {
+        of->trajectoryWriter->flush();
+        delete of->trajectoryWriter;
+        of->trajectoryWriter = nullptr;
+    }
     if (of->fp_xtc)
     {
         close_xtc(of->fp_xtc);
@@ -138,13 +138,10 @@ int add_bind(t_bin* b, gmx::ArrayRef<const double> r)
 
 void sum_bin(t_bin* b, const t_commrec* cr)
 {
-    int i;
-
-    for (i = b->nreal; (i < b->maxreal); i++)
-    {
-        b->rbuf[i] = 0;
-    }
-    gmx_sumd(b->maxreal, b->rbuf, cr);
+    /* Only communicate the entries in use; the allocated size is the
+     * maximum over all calls, e.g. including energy terms on energy steps.
+     */
+    gmx_sumd(b->nreal, b->rbuf, cr);
 }
 
 void extract_binr(t_bin* b, int index, int nr, real r[])
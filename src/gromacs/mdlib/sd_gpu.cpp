@@ -0,0 +1,208 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Implements the SD integrator on the GPU
+ *
+ * This file contains backend-agnostic code for the SD integrator class on GPU,
+ * including class initialization, and data-structures management.
+ *
+ * \ingroup module_mdlib
+ */
+#include "gmxpre.h"
+
+#include "sd_gpu.h"
+
+#include <cmath>
+
+#include <algorithm>
+#include <numeric>
+
+#include "gromacs/gpu_utils/devicebuffer.h"
+#include "gromacs/math/units.h"
+#include "gromacs/mdlib/sd_gpu_internal.h"
+#include "gromacs/mdtypes/inputrec.h"
+#include "gromacs/random/seed.h"
+#include "gromacs/random/tabulatednormaldistribution.h"
+#include "gromacs/utility/gmxassert.h"
+
+namespace gmx
+{
+
+SdGpu::SdGpu(const t_inputrec&    ir,
+             const DeviceContext& deviceContext,
+             const DeviceStream&  deviceStream) :
+    deviceContext_(deviceContext), deviceStream_(deviceStream), numTempScaleValues_(ir.opts.ngtc)
+{
+    GMX_RELEASE_ASSERT(ir.eI == IntegrationAlgorithm::SD1,
+                       "The GPU SD integrator can only be used with the sd integrator");
+
+    // The CPU update passes the seed as int to ThreeFry2x64, do the same conversion here
+    key0_ = static_cast<uint64_t>(static_cast<int>(ir.ld_seed));
+    key1_ = static_cast<uint64_t>(RandomDomain::UpdateCoordinates);
+
+    const auto table = TabulatedNormalDistribution<float, c_sdGpuNormalTableBits>::makeTable();
+    reallocateDeviceBuffer(
+            &d_normalTable_, table.size(), &numNormalTable_, &numNormalTableAlloc_, deviceContext_);
+    copyToDeviceBuffer(&d_normalTable_,
+                       table.data(),
+                       0,
+                       table.size(),
+                       deviceStream_,
+                       GpuApiCallBehavior::Sync,
+                       nullptr);
+
+    h_temperatureConstants_.resize(2 * numTempScaleValues_);
+    reallocateDeviceBuffer(&d_temperatureConstants_,
+                           h_temperatureConstants_.size(),
+                           &numTemperatureConstants_,
+                           &numTemperatureConstantsAlloc_,
+                           deviceContext_);
+    updateTemperatureConstants(ir);
+}
+
+SdGpu::~SdGpu()
+{
+    freeDeviceBuffer(&d_inverseMasses_);
+    freeDeviceBuffer(&d_tempScaleGroups_);
+    freeDeviceBuffer(&d_globalAtomIndices_);
+    freeDeviceBuffer(&d_temperatureConstants_);
+    freeDeviceBuffer(&d_normalTable_);
+}
+
+void SdGpu::updateTemperatureConstants(const t_inputrec& ir)
+{
+    // Same constants as gmx_stochd_t and Update::update_temperature_constants() on the CPU
+    for (int gt = 0; gt < numTempScaleValues_; gt++)
+    {
+        const real em = (ir.opts.tau_t[gt] > 0) ? std::exp(-ir.delta_t / ir.opts.tau_t[gt]) : 1;
+        const real kT = c_boltz * ir.opts.ref_t[gt];
+
+        h_temperatureConstants_[2 * gt]     = em;
+        h_temperatureConstants_[2 * gt + 1] = std::sqrt(kT * (1 - em * em));
+    }
+    copyToDeviceBuffer(&d_temperatureConstants_,
+                       h_temperatureConstants_.data(),
+                       0,
+                       h_temperatureConstants_.size(),
+                       deviceStream_,
+                       GpuApiCallBehavior::Sync,
+                       nullptr);
+}
+
+void SdGpu::integrate(DeviceBuffer<Float3> d_x,
+                      DeviceBuffer<Float3> d_v,
+                      const int64_t        step,
+                      const float          dt)
+{
+    launchSdKernel(numAtoms_,
+                   d_x,
+                   d_v,
+                   d_inverseMasses_,
+                   d_tempScaleGroups_,
+                   d_globalAtomIndices_,
+                   d_temperatureConstants_,
+                   d_normalTable_,
+                   key0_,
+                   key1_,
+                   static_cast<uint64_t>(step),
+                   dt,
+                   deviceStream_);
+}
+
+void SdGpu::set(const int                      numAtoms,
+                const real*                    inverseMasses,
+                const unsigned short*          tempScaleGroups,
+                const gmx::ArrayRef<const int> globalAtomIndices)
+{
+    numAtoms_ = numAtoms;
+
+    reallocateDeviceBuffer(
+            &d_inverseMasses_, numAtoms_, &numInverseMasses_, &numInverseMassesAlloc_, deviceContext_);
+    copyToDeviceBuffer(
+            &d_inverseMasses_, inverseMasses, 0, numAtoms_, deviceStream_, GpuApiCallBehavior::Sync, nullptr);
+
+    // The kernel always looks up the group and the global index, which
+    // avoids separate kernel flavors for the rare cases without them.
+    h_tempScaleGroups_.resize(numAtoms_);
+    if (tempScaleGroups != nullptr)
+    {
+        std::copy(tempScaleGroups, tempScaleGroups + numAtoms_, h_tempScaleGroups_.begin());
+    }
+    else
+    {
+        std::fill(h_tempScaleGroups_.begin(), h_tempScaleGroups_.end(), 0);
+    }
+    reallocateDeviceBuffer(&d_tempScaleGroups_,
+                           numAtoms_,
+                           &numTempScaleGroups_,
+                           &numTempScaleGroupsAlloc_,
+                           deviceContext_);
+    copyToDeviceBuffer(&d_tempScaleGroups_,
+                       h_tempScaleGroups_.data(),
+                       0,
+                       numAtoms_,
+                       deviceStream_,
+                       GpuApiCallBehavior::Sync,
+                       nullptr);
+
+    h_globalAtomIndices_.resize(numAtoms_);
+    if (!globalAtomIndices.empty())
+    {
+        GMX_ASSERT(globalAtomIndices.ssize() >= numAtoms_,
+                   "Need a global index for every home atom");
+        std::copy(globalAtomIndices.begin(),
+                  globalAtomIndices.begin() + numAtoms_,
+                  h_globalAtomIndices_.begin());
+    }
+    else
+    {
+        std::iota(h_globalAtomIndices_.begin(), h_globalAtomIndices_.end(), 0);
+    }
+    reallocateDeviceBuffer(&d_globalAtomIndices_,
+                           numAtoms_,
+                           &numGlobalAtomIndices_,
+                           &numGlobalAtomIndicesAlloc_,
+                           deviceContext_);
+    copyToDeviceBuffer(&d_globalAtomIndices_,
+                       h_globalAtomIndices_.data(),
+                       0,
+                       numAtoms_,
+                       deviceStream_,
+                       GpuApiCallBehavior::Sync,
+                       nullptr);
+}
+
+} // namespace gmx
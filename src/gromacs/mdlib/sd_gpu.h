@@ -0,0 +1,188 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \libinternal \file
+ *
+ * \brief Declarations for GPU implementation of the stochastic dynamics integrator.
+ *
+ * \ingroup module_mdlib
+ * \inlibraryapi
+ */
+#ifndef GMX_MDLIB_SD_GPU_H
+#define GMX_MDLIB_SD_GPU_H
+
+#include "config.h"
+
+#if GMX_GPU_CUDA
+#    include "gromacs/gpu_utils/gputraits.cuh"
+#elif GMX_GPU_HIP
+#    include "gromacs/gpu_utils/gputraits.hpp"
+#endif
+#if GMX_GPU_SYCL
+#    include "gromacs/gpu_utils/gputraits_sycl.h"
+#endif
+
+#include <cstdint>
+
+#include <vector>
+
+#include "gromacs/gpu_utils/devicebuffer_datatype.h"
+#include "gromacs/utility/arrayref.h"
+
+class DeviceContext;
+class DeviceStream;
+struct t_inputrec;
+
+namespace gmx
+{
+
+/*! \brief Friction and noise part of the SD integrator on the GPU.
+ *
+ * The force part of the SD update is the same as the leap-frog update
+ * without coupling, so only the second half of the update, which applies
+ * friction and noise to the velocities and half of the resulting change
+ * to the coordinates, is implemented here.
+ *
+ * The noise is drawn from the same counter-based random streams as on the
+ * CPU: ThreeFry2x64 with 0 internal counter bits, keyed on the seed and
+ * RandomDomain::UpdateCoordinates and with the step and global atom index
+ * as counter, mapped onto normal values through the same table. The GPU
+ * update is therefore independent of the domain decomposition and uses
+ * the same random numbers as the CPU update.
+ */
+class SdGpu
+{
+
+public:
+    /*! \brief Constructor.
+     *
+     * \param[in] ir            Input record with the seed and temperature coupling parameters.
+     * \param[in] deviceContext Device context.
+     * \param[in] deviceStream  Device stream to use.
+     */
+    SdGpu(const t_inputrec&    ir,
+          const DeviceContext& deviceContext,
+          const DeviceStream&  deviceStream);
+    ~SdGpu();
+
+    /*! \brief Apply friction and noise for step \p step.
+     *
+     * \param[in,out] d_x  Coordinates after the force part of the update.
+     * \param[in,out] d_v  Velocities after the force part of the update.
+     * \param[in]     step The MD step, used as part of the random counter.
+     * \param[in]     dt   Timestep.
+     */
+    void integrate(DeviceBuffer<Float3> d_x, DeviceBuffer<Float3> d_v, int64_t step, float dt);
+
+    /*! \brief Update the noise amplitudes after a change of the reference temperatures.
+     *
+     * \param[in] ir Input record with the reference temperatures.
+     */
+    void updateTemperatureConstants(const t_inputrec& ir);
+
+    /*! \brief Set the atom data, e.g. after NB search step.
+     *
+     * \param[in] numAtoms          Number of home atoms.
+     * \param[in] inverseMasses     Inverse masses of the atoms.
+     * \param[in] tempScaleGroups   Temperature coupling group of each atom,
+     *                              can be nullptr with a single group.
+     * \param[in] globalAtomIndices Global index of each atom, empty when no
+     *                              domain decomposition atom ordering is used.
+     */
+    void set(int                      numAtoms,
+             const real*              inverseMasses,
+             const unsigned short*    tempScaleGroups,
+             gmx::ArrayRef<const int> globalAtomIndices);
+
+private:
+    //! GPU context object
+    const DeviceContext& deviceContext_;
+    //! GPU stream
+    const DeviceStream& deviceStream_;
+
+    //! Number of atoms
+    int numAtoms_ = 0;
+    //! Number of temperature coupling groups
+    int numTempScaleValues_ = 0;
+    //! First word of the random key
+    uint64_t key0_;
+    //! Second word of the random key
+    uint64_t key1_;
+
+    //! 1/mass for all atoms (GPU)
+    DeviceBuffer<float> d_inverseMasses_;
+    //! Current size of the reciprocal masses array
+    int numInverseMasses_ = -1;
+    //! Maximum size of the reciprocal masses array
+    int numInverseMassesAlloc_ = -1;
+
+    //! Temperature coupling group of each atom
+    DeviceBuffer<unsigned short> d_tempScaleGroups_;
+    //! Current size of the temperature coupling groups array
+    int numTempScaleGroups_ = -1;
+    //! Maximum size of the temperature coupling groups array
+    int numTempScaleGroupsAlloc_ = -1;
+
+    //! Global index of each atom, used as part of the random counter
+    DeviceBuffer<int> d_globalAtomIndices_;
+    //! Current size of the global atom index array
+    int numGlobalAtomIndices_ = -1;
+    //! Maximum size of the global atom index array
+    int numGlobalAtomIndicesAlloc_ = -1;
+
+    //! Host-side friction and noise factors, em and sigma_V for each group
+    std::vector<float> h_temperatureConstants_;
+    //! Friction and noise factors, em and sigma_V for each group
+    DeviceBuffer<float> d_temperatureConstants_;
+    //! Current size of the friction and noise factor array
+    int numTemperatureConstants_ = -1;
+    //! Maximum size of the friction and noise factor array
+    int numTemperatureConstantsAlloc_ = -1;
+
+    //! Table mapping random bits onto normally distributed values
+    DeviceBuffer<float> d_normalTable_;
+    //! Current size of the normal distribution table
+    int numNormalTable_ = -1;
+    //! Maximum size of the normal distribution table
+    int numNormalTableAlloc_ = -1;
+
+    //! Host-side temperature coupling groups, used for uploading
+    std::vector<unsigned short> h_tempScaleGroups_;
+    //! Host-side global atom indices, used for uploading
+    std::vector<int> h_globalAtomIndices_;
+};
+
+} // namespace gmx
+
+#endif
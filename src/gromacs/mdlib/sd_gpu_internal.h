@@ -0,0 +1,88 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \libinternal \file
+ *
+ * \brief Declarations for backend specific GPU functions for the SD integrator.
+ *
+ * \ingroup module_mdlib
+ * \inlibraryapi
+ */
+#ifndef GMX_MDLIB_SD_GPU_INTERNAL_H
+#define GMX_MDLIB_SD_GPU_INTERNAL_H
+
+#include <cstdint>
+
+#include "gromacs/gpu_utils/devicebuffer_datatype.h"
+#include "gromacs/mdlib/sd_gpu.h"
+
+namespace gmx
+{
+
+//! Number of random bits used per normal value, the same as on the CPU
+constexpr int c_sdGpuNormalTableBits = 14;
+
+/*! \brief Backend-specific function to launch the GPU SD friction and noise kernel.
+ *
+ * \param numAtoms                     Number of atoms.
+ * \param[in,out] d_x                  Coordinates to update.
+ * \param[in,out] d_v                  Velocities to update.
+ * \param[in] d_inverseMasses          Reciprocal masses of the atoms.
+ * \param[in] d_tempScaleGroups        Temperature coupling group of each atom.
+ * \param[in] d_globalAtomIndices      Global index of each atom.
+ * \param[in] d_temperatureConstants   Friction factor em and noise sigma_V for each group.
+ * \param[in] d_normalTable            Table of normal values indexed with random bits.
+ * \param key0                         First word of the random key.
+ * \param key1                         Second word of the random key.
+ * \param step                         MD step, the first word of the random counter.
+ * \param dt                           Timestep.
+ * \param deviceStream                 Device stream for kernel launch.
+ */
+void launchSdKernel(int                          numAtoms,
+                    DeviceBuffer<Float3>         d_x,
+                    DeviceBuffer<Float3>         d_v,
+                    DeviceBuffer<float>          d_inverseMasses,
+                    DeviceBuffer<unsigned short> d_tempScaleGroups,
+                    DeviceBuffer<int>            d_globalAtomIndices,
+                    DeviceBuffer<float>          d_temperatureConstants,
+                    DeviceBuffer<float>          d_normalTable,
+                    uint64_t                     key0,
+                    uint64_t                     key1,
+                    uint64_t                     step,
+                    float                        dt,
+                    const DeviceStream&          deviceStream);
+
+} // namespace gmx
+
+#endif
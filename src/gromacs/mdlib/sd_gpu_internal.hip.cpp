@@ -0,0 +1,205 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Implements the SD integrator friction and noise kernel using HIP
+ *
+ * \ingroup module_mdlib
+ */
+#include "gmxpre.h"
+
+#include "sd_gpu_internal.h"
+
+#include "gromacs/gpu_utils/hiputils.hpp"
+#include "gromacs/gpu_utils/devicebuffer.h"
+#include "gromacs/gpu_utils/typecasts.hpp"
+
+namespace gmx
+{
+
+/*!\brief Number of HIP threads in a block
+ *
+ * \todo Check if using smaller block size will lead to better performance.
+ */
+constexpr static int c_threadsPerBlock = 64;
+//! Maximum number of threads in a block (for __launch_bounds__)
+constexpr static int c_maxThreadsPerBlock = c_threadsPerBlock;
+
+//! Rotate \p i left by \p bits bits
+static __device__ __forceinline__ uint64_t rotateLeft(const uint64_t i, const unsigned int bits)
+{
+    return (i << bits) | (i >> (64 - bits));
+}
+
+/*! \brief Return the first value of a ThreeFry2x64<0> stream
+ *
+ * Gives the same value as ThreeFry2x64<0> on the host after
+ * seeding it with {key0, key1} and restarting it with {ctr0, ctr1}.
+ */
+static __device__ __forceinline__ uint64_t threeFry2x64FirstValue(const uint64_t key0,
+                                                                  const uint64_t key1,
+                                                                  const uint64_t ctr0,
+                                                                  const uint64_t ctr1)
+{
+    constexpr unsigned int c_rounds       = 20;
+    constexpr unsigned int c_rotations[8] = { 16, 42, 12, 31, 16, 32, 24, 21 };
+
+    const uint64_t ks[3] = { key0, key1, 0x1bd11bdaa9fc1a22 ^ key0 ^ key1 };
+
+    uint64_t x0 = ctr0 + ks[0];
+    uint64_t x1 = ctr1 + ks[1];
+#pragma unroll
+    for (unsigned int r = 0; r < c_rounds; r++)
+    {
+        x0 += x1;
+        x1 = rotateLeft(x1, c_rotations[r % 8]);
+        x1 ^= x0;
+        if (((r + 1) & 3) == 0)
+        {
+            const unsigned int r4 = (r + 1) >> 2;
+            x0 += ks[r4 % 3];
+            x1 += ks[(r4 + 1) % 3] + r4;
+        }
+    }
+    return x0;
+}
+
+/*! \brief Friction and noise kernel of the SD integrator.
+ *
+ *  This is the second half of the SD update, the first half is the
+ *  leap-frog update without coupling. Each GPU thread works with a single
+ *  particle and draws the noise for its three dimensions from 14-bit
+ *  chunks of a single 64-bit random value, in the same order as the CPU.
+ *
+ * \param[in]     numAtoms                Number of atoms.
+ * \param[in,out] gm_x                    Coordinates to update.
+ * \param[in,out] gm_v                    Velocities to update.
+ * \param[in]     gm_inverseMasses        Reciprocal masses.
+ * \param[in]     gm_tempScaleGroups      Temperature coupling group of each atom.
+ * \param[in]     gm_globalAtomIndices    Global index of each atom.
+ * \param[in]     gm_temperatureConstants Friction factor em and noise sigma_V per group.
+ * \param[in]     gm_normalTable          Table of normal values.
+ * \param[in]     key0                    First word of the random key.
+ * \param[in]     key1                    Second word of the random key.
+ * \param[in]     step                    MD step, first word of the random counter.
+ * \param[in]     dt                      Timestep.
+ */
+__launch_bounds__(c_maxThreadsPerBlock) __global__
+        static void sd_kernel(const int numAtoms,
+                              float3* __restrict__ gm_x,
+                              float3* __restrict__ gm_v,
+                              const float* __restrict__ gm_inverseMasses,
+                              const unsigned short* __restrict__ gm_tempScaleGroups,
+                              const int* __restrict__ gm_globalAtomIndices,
+                              const float* __restrict__ gm_temperatureConstants,
+                              const float* __restrict__ gm_normalTable,
+                              const uint64_t key0,
+                              const uint64_t key1,
+                              const uint64_t step,
+                              const float    dt)
+{
+    int threadIndex = blockIdx.x * blockDim.x + threadIdx.x;
+    if (threadIndex < numAtoms)
+    {
+        constexpr uint64_t c_tableMask = (1ULL << c_sdGpuNormalTableBits) - 1;
+
+        const int   tempScaleGroup = gm_tempScaleGroups[threadIndex];
+        const float em             = gm_temperatureConstants[2 * tempScaleGroup];
+        const float sigmaV         = gm_temperatureConstants[2 * tempScaleGroup + 1];
+        const float noiseScale     = sqrtf(gm_inverseMasses[threadIndex]) * sigmaV;
+
+        uint64_t randomBits = threeFry2x64FirstValue(
+                key0, key1, step, static_cast<uint64_t>(gm_globalAtomIndices[threadIndex]));
+
+        const float3 v  = gm_v[threadIndex];
+        float3       vn = v;
+        vn.x            = v.x * em + noiseScale * gm_normalTable[randomBits & c_tableMask];
+        randomBits >>= c_sdGpuNormalTableBits;
+        vn.y = v.y * em + noiseScale * gm_normalTable[randomBits & c_tableMask];
+        randomBits >>= c_sdGpuNormalTableBits;
+        vn.z = v.z * em + noiseScale * gm_normalTable[randomBits & c_tableMask];
+
+        // The force part of the update added a full v*dt term to the
+        // coordinates, half of the velocity change is added here.
+        float3 x = gm_x[threadIndex];
+        x.x += 0.5F * (vn.x - v.x) * dt;
+        x.y += 0.5F * (vn.y - v.y) * dt;
+        x.z += 0.5F * (vn.z - v.z) * dt;
+
+        gm_v[threadIndex] = vn;
+        gm_x[threadIndex] = x;
+    }
+}
+
+void launchSdKernel(const int                          numAtoms,
+                    DeviceBuffer<Float3>               d_x,
+                    DeviceBuffer<Float3>               d_v,
+                    const DeviceBuffer<float>          d_inverseMasses,
+                    const DeviceBuffer<unsigned short> d_tempScaleGroups,
+                    const DeviceBuffer<int>            d_globalAtomIndices,
+                    const DeviceBuffer<float>          d_temperatureConstants,
+                    const DeviceBuffer<float>          d_normalTable,
+                    const uint64_t                     key0,
+                    const uint64_t                     key1,
+                    const uint64_t                     step,
+                    const float                        dt,
+                    const DeviceStream&                deviceStream)
+{
+    KernelLaunchConfig kernelLaunchConfig;
+
+    kernelLaunchConfig.gridSize[0]      = (numAtoms + c_threadsPerBlock - 1) / c_threadsPerBlock;
+    kernelLaunchConfig.blockSize[0]     = c_threadsPerBlock;
+    kernelLaunchConfig.blockSize[1]     = 1;
+    kernelLaunchConfig.blockSize[2]     = 1;
+    kernelLaunchConfig.sharedMemorySize = 0;
+
+    const auto kernelArgs = prepareGpuKernelArguments(sd_kernel,
+                                                      kernelLaunchConfig,
+                                                      &numAtoms,
+                                                      asFloat3Pointer(&d_x),
+                                                      asFloat3Pointer(&d_v),
+                                                      &d_inverseMasses,
+                                                      &d_tempScaleGroups,
+                                                      &d_globalAtomIndices,
+                                                      &d_temperatureConstants,
+                                                      &d_normalTable,
+                                                      &key0,
+                                                      &key1,
+                                                      &step,
+                                                      &dt);
+    launchGpuKernel(sd_kernel, kernelLaunchConfig, deviceStream, nullptr, "sd_kernel", kernelArgs);
+}
+
+} // namespace gmx
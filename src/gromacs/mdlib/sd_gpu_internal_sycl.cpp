@@ -0,0 +1,196 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Implements the SD integrator friction and noise kernel using SYCL
+ *
+ * \ingroup module_mdlib
+ */
+#include "gmxpre.h"
+
+#include "sd_gpu_internal.h"
+
+#include "gromacs/gpu_utils/devicebuffer.h"
+#include "gromacs/gpu_utils/gmxsycl.h"
+
+//! \brief Class name for the SD kernel
+class SdKernel;
+
+namespace gmx
+{
+
+using mode = sycl::access_mode;
+
+//! Rotate \p i left by \p bits bits
+static inline uint64_t rotateLeft(const uint64_t i, const unsigned int bits)
+{
+    return (i << bits) | (i >> (64 - bits));
+}
+
+/*! \brief Return the first value of a ThreeFry2x64<0> stream
+ *
+ * Gives the same value as ThreeFry2x64<0> on the host after
+ * seeding it with {key0, key1} and restarting it with {ctr0, ctr1}.
+ */
+static inline uint64_t threeFry2x64FirstValue(const uint64_t key0,
+                                              const uint64_t key1,
+                                              const uint64_t ctr0,
+                                              const uint64_t ctr1)
+{
+    constexpr unsigned int c_rounds       = 20;
+    constexpr unsigned int c_rotations[8] = { 16, 42, 12, 31, 16, 32, 24, 21 };
+
+    const uint64_t ks[3] = { key0, key1, 0x1bd11bdaa9fc1a22 ^ key0 ^ key1 };
+
+    uint64_t x0 = ctr0 + ks[0];
+    uint64_t x1 = ctr1 + ks[1];
+#pragma unroll
+    for (unsigned int r = 0; r < c_rounds; r++)
+    {
+        x0 += x1;
+        x1 = rotateLeft(x1, c_rotations[r % 8]);
+        x1 ^= x0;
+        if (((r + 1) & 3) == 0)
+        {
+            const unsigned int r4 = (r + 1) >> 2;
+            x0 += ks[r4 % 3];
+            x1 += ks[(r4 + 1) % 3] + r4;
+        }
+    }
+    return x0;
+}
+
+/*! \brief Friction and noise kernel of the SD integrator.
+ *
+ *  This is the second half of the SD update, the first half is the
+ *  leap-frog update without coupling. Each GPU thread works with a single
+ *  particle and draws the noise for its three dimensions from 14-bit
+ *  chunks of a single 64-bit random value, in the same order as the CPU.
+ *
+ * \param         cgh                     SYCL's command group handler.
+ * \param[in,out] a_x                     Coordinates to update.
+ * \param[in,out] a_v                     Velocities to update.
+ * \param[in]     a_inverseMasses         Reciprocal masses.
+ * \param[in]     a_tempScaleGroups       Temperature coupling group of each atom.
+ * \param[in]     a_globalAtomIndices     Global index of each atom.
+ * \param[in]     a_temperatureConstants  Friction factor em and noise sigma_V per group.
+ * \param[in]     a_normalTable           Table of normal values.
+ * \param[in]     key0                    First word of the random key.
+ * \param[in]     key1                    Second word of the random key.
+ * \param[in]     step                    MD step, first word of the random counter.
+ * \param[in]     dt                      Timestep.
+ */
+static auto sdKernel(sycl::handler&                             cgh,
+                     DeviceAccessor<Float3, mode::read_write>   a_x,
+                     DeviceAccessor<Float3, mode::read_write>   a_v,
+                     DeviceAccessor<float, mode::read>          a_inverseMasses,
+                     DeviceAccessor<unsigned short, mode::read> a_tempScaleGroups,
+                     DeviceAccessor<int, mode::read>            a_globalAtomIndices,
+                     DeviceAccessor<float, mode::read>          a_temperatureConstants,
+                     DeviceAccessor<float, mode::read>          a_normalTable,
+                     uint64_t                                   key0,
+                     uint64_t                                   key1,
+                     uint64_t                                   step,
+                     float                                      dt)
+{
+    a_x.bind(cgh);
+    a_v.bind(cgh);
+    a_inverseMasses.bind(cgh);
+    a_tempScaleGroups.bind(cgh);
+    a_globalAtomIndices.bind(cgh);
+    a_temperatureConstants.bind(cgh);
+    a_normalTable.bind(cgh);
+
+    return [=](sycl::id<1> itemIdx) {
+        constexpr uint64_t c_tableMask = (1ULL << c_sdGpuNormalTableBits) - 1;
+
+        const int   tempScaleGroup = a_tempScaleGroups[itemIdx];
+        const float em             = a_temperatureConstants[2 * tempScaleGroup];
+        const float sigmaV         = a_temperatureConstants[2 * tempScaleGroup + 1];
+        const float noiseScale     = sycl::sqrt(a_inverseMasses[itemIdx]) * sigmaV;
+
+        uint64_t randomBits = threeFry2x64FirstValue(
+                key0, key1, step, static_cast<uint64_t>(a_globalAtomIndices[itemIdx]));
+
+        const Float3 v = a_v[itemIdx];
+        Float3       vn;
+        for (int d = 0; d < DIM; d++)
+        {
+            vn[d] = v[d] * em + noiseScale * a_normalTable[randomBits & c_tableMask];
+            randomBits >>= c_sdGpuNormalTableBits;
+        }
+
+        // The force part of the update added a full v*dt term to the
+        // coordinates, half of the velocity change is added here.
+        a_v[itemIdx] = vn;
+        a_x[itemIdx] = a_x[itemIdx] + (vn - v) * (0.5F * dt);
+    };
+}
+
+void launchSdKernel(const int                          numAtoms,
+                    DeviceBuffer<Float3>               d_x,
+                    DeviceBuffer<Float3>               d_v,
+                    const DeviceBuffer<float>          d_inverseMasses,
+                    const DeviceBuffer<unsigned short> d_tempScaleGroups,
+                    const DeviceBuffer<int>            d_globalAtomIndices,
+                    const DeviceBuffer<float>          d_temperatureConstants,
+                    const DeviceBuffer<float>          d_normalTable,
+                    const uint64_t                     key0,
+                    const uint64_t                     key1,
+                    const uint64_t                     step,
+                    const float                        dt,
+                    const DeviceStream&                deviceStream)
+{
+    const sycl::range<1> rangeAllAtoms(numAtoms);
+    sycl::queue          q = deviceStream.stream();
+
+    q.submit([&](sycl::handler& cgh) {
+        auto kernel = sdKernel(cgh,
+                               d_x,
+                               d_v,
+                               d_inverseMasses,
+                               d_tempScaleGroups,
+                               d_globalAtomIndices,
+                               d_temperatureConstants,
+                               d_normalTable,
+                               key0,
+                               key1,
+                               step,
+                               dt);
+        cgh.parallel_for<SdKernel>(rangeAllAtoms, kernel);
+    });
+}
+
+} // namespace gmx
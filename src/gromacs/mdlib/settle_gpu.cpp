@@ -86,18 +86,7 @@ void SettleGpu::apply(const DeviceBuffer<Float3>& d_x,
         clearDeviceBufferAsync(&d_virialScaled_, 0, 6, deviceStream_);
     }
 
-    launchSettleGpuKernel(numSettles_,
-                          d_atomIds_,
-                          settleParameters_,
-                          d_x,
-                          d_xp,
-                          updateVelocities,
-                          d_v,
-                          invdt,
-                          computeVirial,
-                          d_virialScaled_,
-                          pbcAiuc,
-                          deviceStream_);
+    launch(d_x, d_xp, updateVelocities, d_v, invdt, computeVirial, d_virialScaled_, pbcAiuc);
 
 
     if (computeVirial)
@@ -120,6 +109,36 @@ void SettleGpu::apply(const DeviceBuffer<Float3>& d_x,
     }
 }
 
+void SettleGpu::launch(const DeviceBuffer<Float3>& d_x,
+                       DeviceBuffer<Float3>        d_xp,
+                       const bool                  updateVelocities,
+                       DeviceBuffer<Float3>        d_v,
+                       const real                  invdt,
+                       const bool                  computeVirial,
+                       DeviceBuffer<float>         d_virialScaled,
+                       const PbcAiuc&              pbcAiuc)
+{
+    // Early exit if no settles
+    if (numSettles_ == 0)
+    {
+        return;
+    }
+
+    launchSettleGpuKernel(numSettles_,
+                          d_atomIds_,
+                          atomsConsecutive_,
+                          settleParameters_,
+                          d_x,
+                          d_xp,
+                          updateVelocities,
+                          d_v,
+                          invdt,
+                          computeVirial,
+                          d_virialScaled,
+                          pbcAiuc,
+                          deviceStream_);
+}
+
 SettleGpu::SettleGpu(const gmx_mtop_t& mtop, const DeviceContext& deviceContext, const DeviceStream& deviceStream) :
     deviceContext_(deviceContext), deviceStream_(deviceStream)
 {
@@ -245,6 +264,9 @@ void SettleGpu::set(const InteractionDefinitions& idef)
 
     reallocateDeviceBuffer(&d_atomIds_, numSettles_, &numAtomIds_, &numAtomIdsAlloc_, deviceContext_);
     h_atomIds_.resize(numSettles_);
+    // With the usual O-H-H ordering of the water atoms, which the local atom order
+    // preserves, the kernel can derive the hydrogen indices from the oxygen index.
+    atomsConsecutive_ = true;
     for (int i = 0; i < numSettles_; i++)
     {
         WaterMolecule settler;
@@ -252,6 +274,8 @@ void SettleGpu::set(const InteractionDefinitions& idef)
         settler.hw2   = iatoms[i * nral1 + 2]; // First hydrogen index
         settler.hw3   = iatoms[i * nral1 + 3]; // Second hydrogen index
         h_atomIds_[i] = settler;
+        atomsConsecutive_ =
+                atomsConsecutive_ && settler.hw2 == settler.ow1 + 1 && settler.hw3 == settler.ow1 + 2;
     }
     copyToDeviceBuffer(
             &d_atomIds_, h_atomIds_.data(), 0, numSettles_, deviceStream_, GpuApiCallBehavior::Sync, nullptr);
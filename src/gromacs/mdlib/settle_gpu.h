@@ -123,6 +123,34 @@ public:
                tensor                      virialScaled,
                const PbcAiuc&              pbcAiuc);
 
+    /*! \brief Launch SETTLE, accumulating the virial on the device.
+     *
+     * Same as apply(), but the scaled virial is added to \p d_virialScaled (6 floats:
+     * [XX, XY, XZ, YY, YZ, ZZ]) in GPU memory. The buffer is neither cleared nor copied
+     * to the host, so that several constraint algorithms can share one reduction buffer
+     * and one blocking device-to-host transfer.
+     *
+     * \param[in]     d_x               Coordinates before timestep (in GPU memory)
+     * \param[in,out] d_xp              Coordinates after timestep (in GPU memory). The
+     *                                  resulting constrained coordinates will be saved here.
+     * \param[in]     updateVelocities  If the velocities should be updated.
+     * \param[in,out] d_v               Velocities to update (in GPU memory, can be nullptr
+     *                                  if not updated)
+     * \param[in]     invdt             Reciprocal timestep (to scale Lagrange
+     *                                  multipliers when velocities are updated)
+     * \param[in]     computeVirial     If virial should be updated.
+     * \param[in,out] d_virialScaled    Scaled virial to add to (in GPU memory).
+     * \param[in]     pbcAiuc           PBC data.
+     */
+    void launch(const DeviceBuffer<Float3>& d_x,
+                DeviceBuffer<Float3>        d_xp,
+                bool                        updateVelocities,
+                DeviceBuffer<Float3>        d_v,
+                real                        invdt,
+                bool                        computeVirial,
+                DeviceBuffer<float>         d_virialScaled,
+                const PbcAiuc&              pbcAiuc);
+
     /*! \brief
      * Update data-structures (e.g. after NB search step).
      *
@@ -155,6 +183,8 @@ private:
     std::vector<WaterMolecule> h_atomIds_;
     //! Indexes of atoms (.i for oxygen, .j and.k for hydrogens, GPU)
     DeviceBuffer<WaterMolecule> d_atomIds_;
+    //! Whether the hydrogens of every water directly follow their oxygen in the atom order
+    bool atomsConsecutive_ = false;
     //! Current size of the array of atom IDs
     int numAtomIds_ = -1;
     //! Allocated size for the array of atom IDs
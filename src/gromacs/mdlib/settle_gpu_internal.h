@@ -59,6 +59,8 @@ namespace gmx
  *
  * \param[in]     numSettles        Number of SETTLE constraints.
  * \param[in]     d_atomIds         Device buffer with indices of atoms to be SETTLEd.
+ * \param[in]     atomsConsecutive  If the hydrogens of every water directly follow their
+ *                                  oxygen, only the oxygen indices are read.
  * \param[in]     settleParameters  Parameters for SETTLE constraints.
  * \param[in]     d_x               Coordinates before timestep (in GPU memory)
  * \param[in,out] d_xp              Coordinates after timestep (in GPU memory). The
@@ -75,6 +77,7 @@ namespace gmx
  */
 void launchSettleGpuKernel(int                                numSettles,
                            const DeviceBuffer<WaterMolecule>& d_atomIds,
+                           bool                               atomsConsecutive,
                            const SettleParameters&            settleParameters,
                            const DeviceBuffer<Float3>&        d_x,
                            DeviceBuffer<Float3>               d_xp,
@@ -91,7 +91,7 @@ constexpr static int sc_maxThreadsPerBlock = sc_threadsPerBlock;
  * \param [in]      gm_virialScaled  Virial tensor.
  * \param [in]      pbcAiuc          Periodic boundary conditions data.
  */
-template<bool updateVelocities, bool computeVirial>
+template<bool consecutiveAtoms, bool updateVelocities, bool computeVirial>
 __launch_bounds__(sc_threadsPerBlock) __global__
         void settle_kernel(const int numSettles,
                            const WaterMolecule* __restrict__ gm_settles,
@@ -128,8 +128,18 @@ __launch_bounds__(sc_threadsPerBlock) __global__
     if (tid < numSettles)
     {
         // These are the indexes of three atoms in a single 'water' molecule.
-        // TODO Can be reduced to one integer if atoms are consecutive in memory.
-        WaterMolecule indices = gm_settles[tid];
+        // When the hydrogens follow the oxygen in memory, only the oxygen index is loaded.
+        WaterMolecule indices;
+        if (consecutiveAtoms)
+        {
+            indices.ow1 = gm_settles[tid].ow1;
+            indices.hw2 = indices.ow1 + 1;
+            indices.hw3 = indices.ow1 + 2;
+        }
+        else
+        {
+            indices = gm_settles[tid];
+        }
 
         float3 x_ow1 = gm_x[indices.ow1];
         float3 x_hw2 = gm_x[indices.hw2];
@@ -365,36 +375,39 @@ __launch_bounds__(sc_threadsPerBlock) __global__
  *
  * Returns pointer to a HIP kernel based on provided booleans.
  *
+ * \tparam    consecutiveAtoms  If the atoms of each water are consecutive in memory.
  * \param[in] updateVelocities  If the velocities should be constrained.
  * \param[in] bCalcVir          If virial should be updated.
  *
  * \retrun                      Pointer to HIP kernel
  */
+template<bool consecutiveAtoms>
 inline auto getSettleKernelPtr(const bool updateVelocities, const bool computeVirial)
 {
 
-    auto kernelPtr = settle_kernel<true, true>;
+    auto kernelPtr = settle_kernel<consecutiveAtoms, true, true>;
     if (updateVelocities && computeVirial)
     {
-        kernelPtr = settle_kernel<true, true>;
+        kernelPtr = settle_kernel<consecutiveAtoms, true, true>;
     }
     else if (updateVelocities && !computeVirial)
     {
-        kernelPtr = settle_kernel<true, false>;
+        kernelPtr = settle_kernel<consecutiveAtoms, true, false>;
     }
     else if (!updateVelocities && computeVirial)
     {
-        kernelPtr = settle_kernel<false, true>;
+        kernelPtr = settle_kernel<consecutiveAtoms, false, true>;
     }
     else if (!updateVelocities && !computeVirial)
     {
-        kernelPtr = settle_kernel<false, false>;
+        kernelPtr = settle_kernel<consecutiveAtoms, false, false>;
     }
     return kernelPtr;
 }
 
 void launchSettleGpuKernel(const int                          numSettles,
                            const DeviceBuffer<WaterMolecule>& d_atomIds,
+                           const bool                         atomsConsecutive,
                            const SettleParameters&            settleParameters,
                            const DeviceBuffer<Float3>&        d_x,
                            DeviceBuffer<Float3>               d_xp,
@@ -410,7 +423,8 @@ void launchSettleGpuKernel(const int                          numSettles,
             gmx::isPowerOfTwo(sc_threadsPerBlock),
             "Number of threads per block should be a power of two in order for reduction to work.");
 
-    auto kernelPtr = getSettleKernelPtr(updateVelocities, computeVirial);
+    auto kernelPtr = atomsConsecutive ? getSettleKernelPtr<true>(updateVelocities, computeVirial)
+                                      : getSettleKernelPtr<false>(updateVelocities, computeVirial);
 
     KernelLaunchConfig config;
     config.blockSize[0] = sc_threadsPerBlock;
@@ -446,7 +460,7 @@ void launchSettleGpuKernel(const int                          numSettles,
                     config,
                     deviceStream,
                     nullptr,
-                    "settle_kernel<updateVelocities, computeVirial>",
+                    "settle_kernel<consecutiveAtoms, updateVelocities, computeVirial>",
                     kernelArgs);
 }
 
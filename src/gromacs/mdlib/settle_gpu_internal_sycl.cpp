@@ -59,7 +59,7 @@ using mode = sycl::access_mode;
 constexpr static int sc_workGroupSize = 256;
 
 //! \brief Function returning the SETTLE kernel lambda.
-template<bool updateVelocities, bool computeVirial>
+template<bool consecutiveAtoms, bool updateVelocities, bool computeVirial>
 auto settleKernel(sycl::handler&                                               cgh,
                   const int                                                    numSettles,
                   DeviceAccessor<WaterMolecule, mode::read>                    a_settles,
@@ -101,10 +101,20 @@ auto settleKernel(sycl::handler&                                               c
         const int       threadIdx = itemIdx.get_local_linear_id(); // Work-item index in work-group
         assert(itemIdx.get_local_range(0) == sc_workGroupSize);
         // These are the indexes of three atoms in a single 'water' molecule.
-        // TODO Can be reduced to one integer if atoms are consecutive in memory.
+        // When the hydrogens follow the oxygen in memory, only the oxygen index is loaded.
         if (settleIdx < numSettles)
         {
-            WaterMolecule indices = a_settles[settleIdx];
+            WaterMolecule indices;
+            if constexpr (consecutiveAtoms)
+            {
+                indices.ow1 = a_settles[settleIdx].ow1;
+                indices.hw2 = indices.ow1 + 1;
+                indices.hw3 = indices.ow1 + 2;
+            }
+            else
+            {
+                indices = a_settles[settleIdx];
+            }
 
             const Float3 x_ow1 = a_x[indices.ow1];
             const Float3 x_hw2 = a_x[indices.hw2];
@@ -345,15 +355,15 @@ auto settleKernel(sycl::handler&                                               c
 }
 
 // SYCL 1.2.1 requires providing a unique type for a kernel. Should not be needed for SYCL2020.
-template<bool updateVelocities, bool computeVirial>
+template<bool consecutiveAtoms, bool updateVelocities, bool computeVirial>
 class SettleKernelName;
 
 //! \brief SETTLE SYCL kernel launch code.
-template<bool updateVelocities, bool computeVirial, class... Args>
+template<bool consecutiveAtoms, bool updateVelocities, bool computeVirial, class... Args>
 static sycl::event launchSettleKernel(const DeviceStream& deviceStream, int numSettles, Args&&... args)
 {
     // Should not be needed for SYCL2020.
-    using kernelNameType = SettleKernelName<updateVelocities, computeVirial>;
+    using kernelNameType = SettleKernelName<consecutiveAtoms, updateVelocities, computeVirial>;
 
     const int numSettlesRoundedUp =
             static_cast<int>((numSettles + sc_workGroupSize - 1) / sc_workGroupSize) * sc_workGroupSize;
@@ -361,7 +371,7 @@ static sycl::event launchSettleKernel(const DeviceStream& deviceStream, int numS
     sycl::queue             q = deviceStream.stream();
 
     sycl::event e = q.submit([&](sycl::handler& cgh) {
-        auto kernel = settleKernel<updateVelocities, computeVirial>(
+        auto kernel = settleKernel<consecutiveAtoms, updateVelocities, computeVirial>(
                 cgh, numSettles, std::forward<Args>(args)...);
         cgh.parallel_for<kernelNameType>(rangeAllSettles, kernel);
     });
@@ -371,12 +381,17 @@ static sycl::event launchSettleKernel(const DeviceStream& deviceStream, int numS
 
 /*! \brief Select templated kernel and launch it. */
 template<class... Args>
-static inline sycl::event launchSettleKernel(bool updateVelocities, bool computeVirial, Args&&... args)
+static inline sycl::event launchSettleKernel(bool consecutiveAtoms,
+                                             bool updateVelocities,
+                                             bool computeVirial,
+                                             Args&&... args)
 {
     return dispatchTemplatedFunction(
-            [&](auto updateVelocities_, auto computeVirial_) {
-                return launchSettleKernel<updateVelocities_, computeVirial_>(std::forward<Args>(args)...);
+            [&](auto consecutiveAtoms_, auto updateVelocities_, auto computeVirial_) {
+                return launchSettleKernel<consecutiveAtoms_, updateVelocities_, computeVirial_>(
+                        std::forward<Args>(args)...);
             },
+            consecutiveAtoms,
             updateVelocities,
             computeVirial);
 }
@@ -384,6 +399,7 @@ static inline sycl::event launchSettleKernel(bool updateVelocities, bool compute
 
 void launchSettleGpuKernel(const int                          numSettles,
                            const DeviceBuffer<WaterMolecule>& d_settles,
+                           const bool                         atomsConsecutive,
                            const SettleParameters&            settleParameters,
                            const DeviceBuffer<Float3>&        d_x,
                            DeviceBuffer<Float3>               d_xp,
@@ -396,7 +412,8 @@ void launchSettleGpuKernel(const int                          numSettles,
                            const DeviceStream&                deviceStream)
 {
 
-    launchSettleKernel(updateVelocities,
+    launchSettleKernel(atomsConsecutive,
+                       updateVelocities,
                        computeVirial,
                        deviceStream,
                        numSettles,
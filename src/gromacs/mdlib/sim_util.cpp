@@ -1583,7 +1583,8 @@ void do_force(FILE*                               fplog,
         }
 
         hipRangePush("nbv_setAtomProperties");
-        nbv->setAtomProperties(gmx::constArrayRefFromArray(mdatoms->typeA, mdatoms->nr),
+        nbv->setAtomProperties(gmx::AtomLocality::All,
+                               gmx::constArrayRefFromArray(mdatoms->typeA, mdatoms->nr),
                                gmx::constArrayRefFromArray(mdatoms->chargeA, mdatoms->nr),
                                fr->atomInfo);
         hipRangePop();
@@ -1751,6 +1752,14 @@ void do_force(FILE*                               fplog,
         hipRangePop();
     }
 
+    /* With CPU nonbonded work, the coordinate halo exchange can overlap
+     * with the local nonbonded computation.
+     */
+    const bool overlapCpuXHalo =
+            (simulationWork.havePpDomainDecomposition && !stepWork.doNeighborSearch
+             && !stepWork.useGpuXHalo && !simulationWork.useGpuNonbonded && !fr->nbv->emulateGpu()
+             && stepWork.computeNonbondedForces && dd_overlapCpuHaloExchange(*cr->dd));
+
     /* Communicate coordinates and sum dipole if necessary +
        do non-local pair search */
     if (simulationWork.havePpDomainDecomposition)
@@ -1812,7 +1821,14 @@ void do_force(FILE*                               fplog,
                     }
                 }
                 hipRangePush("dd_move_x");
-                dd_move_x(cr->dd, box, x.unpaddedArrayRef(), wcycle);
+                if (overlapCpuXHalo)
+                {
+                    dd_move_x_start(cr->dd, box, x.unpaddedArrayRef(), wcycle);
+                }
+                else
+                {
+                    dd_move_x(cr->dd, box, x.unpaddedArrayRef(), wcycle);
+                }
                 hipRangePop();
             }
 
@@ -1832,7 +1848,7 @@ void do_force(FILE*                               fplog,
                                 AtomLocality::NonLocal, simulationWork, stepWork, gpuCoordinateHaloLaunched));
                 hipRangePop();
             }
-            else
+            else if (!overlapCpuXHalo)
             {
                 hipRangePush("convertCoordinates_notGpuXHalo");
                 nbv->convertCoordinates(AtomLocality::NonLocal, x.unpaddedArrayRef());
@@ -2030,6 +2046,16 @@ void do_force(FILE*                               fplog,
         hipRangePop();
     }
 
+    if (overlapCpuXHalo)
+    {
+        wallcycle_stop(wcycle, WallCycleCounter::Force);
+        hipRangePush("dd_move_x_finish");
+        dd_move_x_finish(cr->dd, box, x.unpaddedArrayRef(), wcycle);
+        nbv->convertCoordinates(AtomLocality::NonLocal, x.unpaddedArrayRef());
+        hipRangePop();
+        wallcycle_start_nocount(wcycle, WallCycleCounter::Force);
+    }
+
     if (fr->efep != FreeEnergyPerturbationType::No && stepWork.computeNonbondedForces)
     {
         /* Calculate the local and non-local free energy interactions here.
@@ -2182,6 +2208,22 @@ void do_force(FILE*                               fplog,
         }
     }
 
+    /* All halo forces have been computed on the CPU, the force halo exchange
+     * can overlap with the remaining work that only acts on home atoms.
+     */
+    const bool overlapCpuFHalo =
+            (simulationWork.havePpDomainDecomposition && stepWork.computeForces && !useOrEmulateGpuNb
+             && !stepWork.useGpuFHalo && !stepWork.useGpuFBufferOps && !simulationWork.useMts
+             && dd_overlapCpuHaloExchange(*cr->dd));
+    if (overlapCpuFHalo)
+    {
+        wallcycle_stop(wcycle, WallCycleCounter::Force);
+        hipRangePush("dd_move_f_start");
+        dd_move_f_start(cr->dd, &forceOutMtsLevel0.forceWithShiftForces(), wcycle);
+        hipRangePop();
+        wallcycle_start_nocount(wcycle, WallCycleCounter::Force);
+    }
+
     if (stepWork.computeSlowForces)
     {
         hipRangePush("longRangeNonbonded->calculate_ifComputeSlowForces");
@@ -2421,7 +2463,14 @@ void do_force(FILE*                               fplog,
                 if (!simulationWork.useMts || !stepWork.combineMtsForcesBeforeHaloExchange)
                 {
                     hipRangePush("dd_move_f_ifNotMTS_orNotCombineBeforeHalo");
-                    dd_move_f(cr->dd, &forceOutMtsLevel0.forceWithShiftForces(), wcycle);
+                    if (overlapCpuFHalo)
+                    {
+                        dd_move_f_finish(cr->dd, &forceOutMtsLevel0.forceWithShiftForces(), wcycle);
+                    }
+                    else
+                    {
+                        dd_move_f(cr->dd, &forceOutMtsLevel0.forceWithShiftForces(), wcycle);
+                    }
                     hipRangePop();
                 }
                 // With MTS we need to communicate the slow or combined (in forceOutMtsLevel1) forces
@@ -2500,8 +2549,16 @@ void do_force(FILE*                               fplog,
                  */
                 waitedForGpu = DdBalanceRegionWaitedForGpu::no;
             }
+            /* With GPU timing enabled, the measured time of this step's
+             * nonbonded tasks gives a better estimate of the GPU end time.
+             */
+            const gmx_wallclock_gpu_nbnxn_t* gpuTimings = Nbnxm::gpu_get_timings(nbv->gpu_nbv);
+            const double                     gpuTaskMilliseconds =
+                    (gpuTimings != nullptr) ? gpuTimings->lastStepTime[0] + gpuTimings->lastStepTime[1]
+                                            : -1;
             hipRangePush("closeAfterForceComputationGpu");
-            ddBalanceRegionHandler.closeAfterForceComputationGpu(cycles_wait_gpu, waitedForGpu);
+            ddBalanceRegionHandler.closeAfterForceComputationGpu(
+                    cycles_wait_gpu, waitedForGpu, gpuTaskMilliseconds);
             hipRangePop();
         }
     }
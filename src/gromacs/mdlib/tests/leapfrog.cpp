@@ -272,6 +272,41 @@ TEST_P(LeapFrogTest, SimpleIntegration)
 
 INSTANTIATE_TEST_SUITE_P(WithParameters, LeapFrogTest, ::testing::ValuesIn(parametersSets));
 
+/*! \brief Test that the compensated position update keeps free particles on the exact path
+ *
+ * Without compensation, the rounding errors of x + v*dt accumulate over the steps
+ * and lead to errors of the order of 1e-3 nm in single precision for this setup.
+ */
+TEST(LeapFrogCompensatedTest, FreeParticlesStayOnAnalyticalPath)
+{
+    const int  numAtoms = 100;
+    const real timestep = 0.001;
+    const int  numSteps = 10000;
+    const rvec v        = { 1.0, -2.0, 3.0 };
+    const rvec f        = { 0.0, 0.0, 0.0 };
+
+    LeapFrogTestData testData(numAtoms, timestep, v, f, 0, 0);
+    testData.update_->setUseCompensatedPositionUpdate(true);
+
+    LeapFrogHostTestRunner runner;
+    runner.integrate(&testData, numSteps);
+
+    // The error should be of the order of the final rounding of the coordinates
+    FloatingPointTolerance tolerance = absoluteTolerance(1e-5);
+    for (int i = 0; i < numAtoms; i++)
+    {
+        for (int d = 0; d < DIM; d++)
+        {
+            // The displacement per step v*dt is rounded to real precision
+            const double displacementPerStep = testData.v0_[i][d] * timestep;
+            const double xAnalytical = testData.x0_[i][d] + numSteps * displacementPerStep;
+
+            EXPECT_REAL_EQ_TOL(xAnalytical, testData.xPrime_[i][d], tolerance) << gmx::formatString(
+                    "Coordinate %d of atom %d is different from analytical solution.", d, i);
+        }
+    }
+}
+
 } // namespace
 } // namespace test
 } // namespace gmx
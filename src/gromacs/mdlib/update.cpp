@@ -44,6 +44,7 @@
 #include <cstdio>
 
 #include <algorithm>
+#include <array>
 #include <memory>
 
 #include "gromacs/domdec/domdec_struct.h"
@@ -179,6 +180,10 @@ public:
     gmx::ArrayRef<const unsigned short> cTC_;
     //! Group index for accleration groups
     gmx::ArrayRef<const unsigned short> cAcceleration_;
+    //! Whether the md position update uses compensated summation
+    bool useCompensatedPositionUpdate_ = false;
+    //! The rounding residuals of the positions with the compensated update
+    std::vector<RVec> positionResidual_;
 
 private:
     //! stochastic dynamics struct
@@ -650,6 +655,35 @@ static void updateMDLeapfrogGeneral(int                                 start,
     }
 }
 
+/*! \brief Recomputes the leap-frog positions xprime = x + v*dt with compensated summation
+ *
+ * Uses the error-free two-sum transformation to keep the part of the displacement
+ * that is lost when rounding x + v*dt in \p residual and adds it to the displacement
+ * of the next step. Must be called after the velocities have been updated.
+ */
+static void updatePositionsCompensated(int                      start,
+                                       int                      nrend,
+                                       real                     dt,
+                                       const rvec* gmx_restrict x,
+                                       rvec* gmx_restrict       xprime,
+                                       const rvec* gmx_restrict v,
+                                       rvec* gmx_restrict       residual)
+{
+    for (int a = start; a < nrend; a++)
+    {
+        for (int d = 0; d < DIM; d++)
+        {
+            const real displacement        = v[a][d] * dt + residual[a][d];
+            const real sum                 = x[a][d] + displacement;
+            const real displacementRounded = sum - x[a][d];
+            const real xRounded            = sum - displacementRounded;
+
+            residual[a][d] = (x[a][d] - xRounded) + (displacement - displacementRounded);
+            xprime[a][d]   = sum;
+        }
+    }
+}
+
 /*! \brief Handles the Leap-frog MD x and v integration */
 static void do_update_md(int                                  start,
                          int                                  nrend,
@@ -1091,6 +1125,24 @@ void Update::updateAfterPartition(int                                 numAtoms,
     impl_->cFREEZE_       = cFREEZE;
     impl_->cTC_           = cTC;
     impl_->cAcceleration_ = cAcceleration;
+    if (impl_->useCompensatedPositionUpdate_)
+    {
+        /* The atom order changes with repartitioning, so we start over */
+        impl_->positionResidual_.assign(numAtoms, RVec{ 0, 0, 0 });
+    }
+}
+
+void Update::setUseCompensatedPositionUpdate(bool useCompensatedPositionUpdate)
+{
+    impl_->useCompensatedPositionUpdate_ = useCompensatedPositionUpdate;
+    if (useCompensatedPositionUpdate)
+    {
+        impl_->positionResidual_.assign(impl_->xp()->size(), RVec{ 0, 0, 0 });
+    }
+    else
+    {
+        impl_->positionResidual_.clear();
+    }
 }
 
 /*! \brief Sets the SD update type */
@@ -1101,6 +1153,31 @@ enum class SDUpdate : int
     Combined
 };
 
+/*! \brief Random engine that returns a value that was generated beforehand
+ *
+ * The SD update draws at most three 14-bit normal values per atom from
+ * a single 64-bit ThreeFry value. This adaptor lets the tabulated normal
+ * distribution consume values that were generated for a whole batch of
+ * atoms at once, which gives exactly the same random stream as restarting
+ * the engine for each atom.
+ */
+class PregeneratedRandomValue
+{
+public:
+    //! Integer type for output
+    typedef uint64_t result_type;
+
+    //! Set the value to return
+    void set(result_type value) { value_ = value; }
+
+    //! Return the stored value
+    result_type operator()() const { return value_; }
+
+private:
+    //! The stored value
+    result_type value_ = 0;
+};
+
 /*! \brief SD integrator update
  *
  * Two phases are required in the general case of a constrained
@@ -1156,12 +1233,34 @@ static void doSDUpdateGeneral(const gmx_stochd_t&                 sd,
     // Even 0 bits internal counter gives 2x64 ints (more than enough for three table lookups)
     gmx::ThreeFry2x64<0>                       rng(seed, gmx::RandomDomain::UpdateCoordinates);
     gmx::TabulatedNormalDistribution<real, 14> dist;
+    PregeneratedRandomValue                    randomValue;
+
+    // The random values for a batch of atoms are generated together, so
+    // the encryption rounds of ThreeFry are executed with SIMD instructions.
+    constexpr int                           c_randomBatchSize = 16;
+    std::array<uint64_t, c_randomBatchSize> stepCounter;
+    std::array<uint64_t, c_randomBatchSize> atomCounter;
+    std::array<uint64_t, c_randomBatchSize> randomValues;
+    stepCounter.fill(step);
 
     for (int n = start; n < nrend; n++)
     {
-        int globalAtomIndex = gatindex ? gatindex[n] : n;
-        rng.restart(step, globalAtomIndex);
-        dist.reset();
+        if (updateType != SDUpdate::ForcesOnly)
+        {
+            const int indexInBatch = (n - start) % c_randomBatchSize;
+            if (indexInBatch == 0)
+            {
+                for (int i = 0; i < c_randomBatchSize; i++)
+                {
+                    // Pad the last batch with copies of the last atom
+                    const int atom = std::min(n + i, nrend - 1);
+                    atomCounter[i] = gatindex ? gatindex[atom] : atom;
+                }
+                randomValues = rng.firstValues(stepCounter, atomCounter);
+            }
+            randomValue.set(randomValues[indexInBatch]);
+            dist.reset();
+        }
 
         real inverseMass = invmass[n];
         real invsqrtMass = std::sqrt(inverseMass);
@@ -1185,7 +1284,7 @@ static void doSDUpdateGeneral(const gmx_stochd_t&                 sd,
                 {
                     real vn = v[n][d];
                     v[n][d] = (vn * sd.sdc[temperatureGroup].em
-                               + invsqrtMass * sd.sdsig[temperatureGroup].V * dist(rng));
+                               + invsqrtMass * sd.sdsig[temperatureGroup].V * dist(randomValue));
                     // The previous phase already updated the
                     // positions with a full v*dt term that must
                     // now be half removed.
@@ -1195,7 +1294,7 @@ static void doSDUpdateGeneral(const gmx_stochd_t&                 sd,
                 {
                     real vn = v[n][d] + (inverseMass * f[n][d] + acceleration[accelerationGroup][d]) * dt;
                     v[n][d] = (vn * sd.sdc[temperatureGroup].em
-                               + invsqrtMass * sd.sdsig[temperatureGroup].V * dist(rng));
+                               + invsqrtMass * sd.sdsig[temperatureGroup].V * dist(randomValue));
                     // Here we include half of the friction+noise
                     // update of v into the position update.
                     xprime[n][d] = x[n][d] + 0.5 * (vn + v[n][d]) * dt;
@@ -1639,6 +1738,9 @@ void Update::Impl::update_coords(const t_inputrec&                 inputRecord,
         fcdata->orires->updateHistory();
     }
 
+    GMX_ASSERT(!useCompensatedPositionUpdate_ || gmx::ssize(positionResidual_) >= homenr,
+               "The position residuals should cover all home atoms");
+
     /* ############# START The update of velocities and positions ######### */
     int nth = gmx_omp_nthreads_get(ModuleMultiThread::Update);
 
@@ -1681,6 +1783,16 @@ void Update::Impl::update_coords(const t_inputrec&                 inputRecord,
                                  state->nosehoover_vxi.data(),
                                  M,
                                  havePartiallyFrozenAtoms);
+                    if (useCompensatedPositionUpdate_)
+                    {
+                        updatePositionsCompensated(start_th,
+                                                   end_th,
+                                                   dt,
+                                                   x_rvec,
+                                                   xp_rvec,
+                                                   v_rvec,
+                                                   as_rvec_array(positionResidual_.data()));
+                    }
                     break;
                 case (IntegrationAlgorithm::SD1):
                     do_update_sd(start_th,
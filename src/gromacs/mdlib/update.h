@@ -104,6 +104,21 @@ public:
                               gmx::ArrayRef<const unsigned short> cTC,
                               gmx::ArrayRef<const unsigned short> cAcceleration);
 
+    /*! \brief Sets whether the leap-frog position update uses compensated summation.
+     *
+     * With single precision, the displacement v*dt of an atom is often several orders
+     * of magnitude smaller than its coordinate, so the rounding error of x + v*dt
+     * accumulates over many steps. With compensated (Kahan) summation, the part of
+     * the displacement that is lost in the rounding is kept per atom and added back
+     * in the next step, which gives positions with an accuracy close to double
+     * precision integration at the cost of one extra vector per atom.
+     * Only applies to the md integrator. The residuals are reset in
+     * updateAfterPartition(), i.e. at every domain decomposition repartitioning.
+     *
+     * \param[in] useCompensatedPositionUpdate  Whether to use the compensated update.
+     */
+    void setUseCompensatedPositionUpdate(bool useCompensatedPositionUpdate);
+
     /*! \brief Perform numerical integration step.
      *
      * Selects the appropriate integrator, based on the input record and performs a numerical integration step.
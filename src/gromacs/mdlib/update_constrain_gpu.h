@@ -44,6 +44,8 @@
 #ifndef GMX_MDLIB_UPDATE_CONSTRAIN_GPU_H
 #define GMX_MDLIB_UPDATE_CONSTRAIN_GPU_H
 
+#include <cstdint>
+
 #include <memory>
 
 #include "gromacs/gpu_utils/devicebuffer_datatype.h"
@@ -99,6 +101,7 @@ public:
      *
      * \param[in]  fReadyOnDevice           Event synchronizer indicating that the forces are
      *                                      ready in the device memory.
+     * \param[in]  step                     The MD step, used for the random streams of SD.
      * \param[in]  pmeKernelData            Gets PME Data to zero it out later
      * \param[in]  dt                       Timestep.
      * \param[in]  updateVelocities         If the velocities should be constrained.
@@ -112,6 +115,7 @@ public:
      */
 
     void integrate(GpuEventSynchronizer*             fReadyOnDevice,
+                   int64_t                           step,
                    real                              dt,
                    bool                              updateVelocities,
                    bool                              computeVirial,
@@ -147,6 +151,8 @@ public:
      * \param[in]      d_f                 Device buffer with forces.
      * \param[in]      idef                System topology
      * \param[in]      md                  Atoms data.
+     * \param[in]      globalAtomIndices   Global index of each home atom, empty without
+     *                                     domain decomposition atom ordering.
      */
     void set(DeviceBuffer<RVec>            d_x,
              DeviceBuffer<RVec>            d_v,
@@ -154,7 +160,14 @@ public:
              DeviceBuffer<real>*           d_grid, 
              DeviceBuffer<RVec>            d_f,
              const InteractionDefinitions& idef,
-             const t_mdatoms&              md);
+             const t_mdatoms&              md,
+             gmx::ArrayRef<const int>      globalAtomIndices);
+
+    /*! \brief Update the SD noise amplitudes after the reference temperatures changed.
+     *
+     * \param[in] ir Input record with the reference temperatures.
+     */
+    void updateTemperatureConstants(const t_inputrec& ir);
 
     /*! \brief
      * Update PBC data.
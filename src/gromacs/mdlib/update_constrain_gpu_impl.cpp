@@ -74,6 +74,7 @@ namespace gmx
 {
 
 void UpdateConstrainGpu::Impl::integrate(GpuEventSynchronizer*             fReadyOnDevice,
+                                         const int64_t                     step,
                                          const real                        dt,
                                          const bool                        updateVelocities,
                                          const bool                        computeVirial,
@@ -97,16 +98,76 @@ void UpdateConstrainGpu::Impl::integrate(GpuEventSynchronizer*             fRead
 
     // The integrate should save a copy of the current coordinates in d_xp_ and write updated
     // once into d_x_. The d_xp_ is only needed by constraints.
-    integrator_->integrate(
-            d_x_, d_xp_, d_v_, realGridSize_, *d_grid_, 
-            d_f_, dt, doTemperatureScaling, tcstat, doParrinelloRahman, dtPressureCouple, isPmeRank,  prVelocityScalingMatrix);
+    // The force part of the SD update is leap-frog without coupling, as on the CPU.
+    integrator_->integrate(d_x_,
+                           d_xp_,
+                           d_v_,
+                           realGridSize_,
+                           *d_grid_,
+                           d_f_,
+                           dt,
+                           doTemperatureScaling && !sd_,
+                           tcstat,
+                           doParrinelloRahman && !sd_,
+                           dtPressureCouple,
+                           isPmeRank,
+                           prVelocityScalingMatrix);
     // Constraints need both coordinates before (d_x_) and after (d_xp_) update. However, after constraints
     // are applied, the d_x_ can be discarded. So we intentionally swap the d_x_ and d_xp_ here to avoid the
     // d_xp_ -> d_x_ copy after constraints. Note that the integrate saves them in the wrong order as well.
+    // LINCS and SETTLE reduce their virial into the same device buffer, so that only one
+    // blocking transfer is needed and the SETTLE launch is not delayed by the LINCS transfer.
     if (sc_haveGpuConstraintSupport)
     {
-        lincsGpu_->apply(d_xp_, d_x_, updateVelocities, d_v_, 1.0 / dt, computeVirial, virial, pbcAiuc_);
-        settleGpu_->apply(d_xp_, d_x_, updateVelocities, d_v_, 1.0 / dt, computeVirial, virial, pbcAiuc_);
+        if (computeVirial)
+        {
+            clearDeviceBufferAsync(&d_constraintVirialScaled_, 0, 6, deviceStream_);
+        }
+        lincsGpu_->launch(
+                d_xp_, d_x_, updateVelocities, d_v_, 1.0 / dt, computeVirial, d_constraintVirialScaled_, pbcAiuc_);
+        settleGpu_->launch(
+                d_xp_, d_x_, updateVelocities, d_v_, 1.0 / dt, computeVirial, d_constraintVirialScaled_, pbcAiuc_);
+    }
+
+    if (sd_)
+    {
+        // Apply friction and noise and constrain the positions for half a time step,
+        // correcting the velocities, without contributing to the virial.
+        sd_->integrate(d_x_, d_v_, step, dt);
+        if (sc_haveGpuConstraintSupport)
+        {
+            lincsGpu_->launch(
+                    d_xp_, d_x_, true, d_v_, 2.0 / dt, false, d_constraintVirialScaled_, pbcAiuc_);
+            settleGpu_->launch(
+                    d_xp_, d_x_, true, d_v_, 2.0 / dt, false, d_constraintVirialScaled_, pbcAiuc_);
+        }
+    }
+
+    if (sc_haveGpuConstraintSupport)
+    {
+        if (computeVirial)
+        {
+            copyFromDeviceBuffer(h_constraintVirialScaled_.data(),
+                                 &d_constraintVirialScaled_,
+                                 0,
+                                 6,
+                                 deviceStream_,
+                                 GpuApiCallBehavior::Sync,
+                                 nullptr);
+
+            // Mapping [XX, XY, XZ, YY, YZ, ZZ] internal format to a tensor object
+            virial[XX][XX] = h_constraintVirialScaled_[0];
+            virial[XX][YY] = h_constraintVirialScaled_[1];
+            virial[XX][ZZ] = h_constraintVirialScaled_[2];
+
+            virial[YY][XX] = h_constraintVirialScaled_[1];
+            virial[YY][YY] = h_constraintVirialScaled_[3];
+            virial[YY][ZZ] = h_constraintVirialScaled_[4];
+
+            virial[ZZ][XX] = h_constraintVirialScaled_[2];
+            virial[ZZ][YY] = h_constraintVirialScaled_[4];
+            virial[ZZ][ZZ] = h_constraintVirialScaled_[5];
+        }
     }
 
     // scaledVirial -> virial (methods above returns scaled values)
@@ -160,14 +221,27 @@ UpdateConstrainGpu::Impl::Impl(const t_inputrec&    ir,
     deviceContext_(deviceContext), deviceStream_(deviceStream), wcycle_(wcycle)
 {
     integrator_ = std::make_unique<LeapFrogGpu>(deviceContext_, deviceStream_, numTempScaleValues);
+    if (ir.eI == IntegrationAlgorithm::SD1)
+    {
+        sd_ = std::make_unique<SdGpu>(ir, deviceContext_, deviceStream_);
+    }
     if (sc_haveGpuConstraintSupport)
     {
         lincsGpu_ = std::make_unique<LincsGpu>(ir.nLincsIter, ir.nProjOrder, deviceContext_, deviceStream_);
         settleGpu_ = std::make_unique<SettleGpu>(mtop, deviceContext_, deviceStream_);
+
+        allocateDeviceBuffer(&d_constraintVirialScaled_, 6, deviceContext_);
+        h_constraintVirialScaled_.resize(6);
     }
 }
 
-UpdateConstrainGpu::Impl::~Impl() {}
+UpdateConstrainGpu::Impl::~Impl()
+{
+    if (sc_haveGpuConstraintSupport)
+    {
+        freeDeviceBuffer(&d_constraintVirialScaled_);
+    }
+}
 
 void UpdateConstrainGpu::Impl::set(DeviceBuffer<Float3>          d_x,
                                    DeviceBuffer<Float3>          d_v,
@@ -175,7 +249,8 @@ void UpdateConstrainGpu::Impl::set(DeviceBuffer<Float3>          d_x,
                                    DeviceBuffer<real>*           d_grid, 
                                    const DeviceBuffer<Float3>    d_f,
                                    const InteractionDefinitions& idef,
-                                   const t_mdatoms&              md)
+                                   const t_mdatoms&              md,
+                                   gmx::ArrayRef<const int>      globalAtomIndices)
 {
     wallcycle_start_nocount(wcycle_, WallCycleCounter::LaunchGpu);
     wallcycle_sub_start(wcycle_, WallCycleSubCounter::LaunchGpuUpdateConstrain);
@@ -199,6 +274,10 @@ void UpdateConstrainGpu::Impl::set(DeviceBuffer<Float3>          d_x,
 
     // Integrator should also update something, but it does not even have a method yet
     integrator_->set(numAtoms_, md.invmass, md.cTC);
+    if (sd_)
+    {
+        sd_->set(numAtoms_, md.invmass, md.cTC, globalAtomIndices);
+    }
     if (sc_haveGpuConstraintSupport)
     {
         lincsGpu_->set(idef, numAtoms_, md.invmass);
@@ -214,6 +293,14 @@ void UpdateConstrainGpu::Impl::set(DeviceBuffer<Float3>          d_x,
     wallcycle_stop(wcycle_, WallCycleCounter::LaunchGpu);
 }
 
+void UpdateConstrainGpu::Impl::updateTemperatureConstants(const t_inputrec& ir)
+{
+    if (sd_)
+    {
+        sd_->updateTemperatureConstants(ir);
+    }
+}
+
 void UpdateConstrainGpu::Impl::setPbc(const PbcType pbcType, const matrix box)
 {
     // TODO wallcycle
@@ -238,6 +325,7 @@ UpdateConstrainGpu::UpdateConstrainGpu(const t_inputrec&    ir,
 UpdateConstrainGpu::~UpdateConstrainGpu() = default;
 
 void UpdateConstrainGpu::integrate(GpuEventSynchronizer*             fReadyOnDevice,
+                                   const int64_t                     step,
                                    const real                        dt,
                                    const bool                        updateVelocities,
                                    const bool                        computeVirial,
@@ -250,6 +338,7 @@ void UpdateConstrainGpu::integrate(GpuEventSynchronizer*             fReadyOnDev
                                    const matrix                      prVelocityScalingMatrix)
 {
     impl_->integrate(fReadyOnDevice,
+                     step,
                      dt,
                      updateVelocities,
                      computeVirial,
@@ -278,9 +367,15 @@ void UpdateConstrainGpu::set(DeviceBuffer<Float3>          d_x,
                              DeviceBuffer<real>*           d_grid,
                              const DeviceBuffer<Float3>    d_f,
                              const InteractionDefinitions& idef,
-                             const t_mdatoms&              md)
+                             const t_mdatoms&              md,
+                             gmx::ArrayRef<const int>      globalAtomIndices)
+{
+    impl_->set(d_x, d_v, realGridSize, d_grid, d_f, idef, md, globalAtomIndices);
+}
+
+void UpdateConstrainGpu::updateTemperatureConstants(const t_inputrec& ir)
 {
-    impl_->set(d_x, d_v, realGridSize, d_grid, d_f, idef, md);
+    impl_->updateTemperatureConstants(ir);
 }
 
 void UpdateConstrainGpu::setPbc(const PbcType pbcType, const matrix box)
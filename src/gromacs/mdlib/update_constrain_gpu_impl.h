@@ -53,6 +53,7 @@
 #include "gromacs/gpu_utils/gpueventsynchronizer.h"
 #include "gromacs/mdlib/leapfrog_gpu.h"
 #include "gromacs/mdlib/lincs_gpu.h"
+#include "gromacs/mdlib/sd_gpu.h"
 #include "gromacs/mdlib/settle_gpu.h"
 #include "gromacs/mdlib/update_constrain_gpu.h"
 #include "gromacs/mdtypes/inputrec.h"
@@ -93,7 +94,9 @@ public:
     /*! \brief Integrate
      *
      * Integrates the equation of motion using Leap-Frog algorithm and applies
-     * LINCS and SETTLE constraints.
+     * LINCS and SETTLE constraints. With the SD integrator, this is followed by
+     * friction and noise and a second constraining of the positions, as
+     * update_sd_second_half() does on the CPU.
      * If computeVirial is true, constraints virial is written at the provided pointer.
      * doTempCouple should be true if:
      *   1. The temperature coupling is enabled.
@@ -102,6 +105,7 @@ public:
      *
      * \param[in]  fReadyOnDevice           Event synchronizer indicating that the forces are ready in
      *                                      the device memory.
+     * \param[in]  step                     The MD step, used for the random streams of SD.
      * \param[in]  dt                       Timestep.
      * \param[in]  updateVelocities         If the velocities should be constrained.
      * \param[in]  computeVirial            If virial should be updated.
@@ -113,6 +117,7 @@ public:
      * \param[in]  prVelocityScalingMatrix  Parrinello-Rahman velocity scaling matrix.
      */
     void integrate(GpuEventSynchronizer*             fReadyOnDevice,
+                   int64_t                           step,
                    real                              dt,
                    bool                              updateVelocities,
                    bool                              computeVirial,
@@ -148,6 +153,7 @@ public:
      * \param[in]      d_f            Device buffer with forces.
      * \param[in] idef                System topology
      * \param[in] md                  Atoms data.
+     * \param[in] globalAtomIndices   Global index of each home atom, can be empty.
      */
     void set(DeviceBuffer<Float3>          d_x,
              DeviceBuffer<Float3>          d_v,
@@ -155,7 +161,14 @@ public:
              DeviceBuffer<real>*           d_grid, 
              DeviceBuffer<Float3>          d_f,
              const InteractionDefinitions& idef,
-             const t_mdatoms&              md);
+             const t_mdatoms&              md,
+             gmx::ArrayRef<const int>      globalAtomIndices);
+
+    /*! \brief Update the SD noise amplitudes after the reference temperatures changed.
+     *
+     * \param[in] ir Input record with the reference temperatures.
+     */
+    void updateTemperatureConstants(const t_inputrec& ir);
 
     /*! \brief
      * Update PBC data.
@@ -219,8 +232,15 @@ private:
     //! Allocation size for the reciprocal masses buffer
     int numInverseMassesAlloc_ = -1;
 
+    //! Scaled constraint virial, shared by LINCS and SETTLE (6 floats: [XX, XY, XZ, YY, YZ, ZZ], GPU)
+    DeviceBuffer<float> d_constraintVirialScaled_;
+    //! Scaled constraint virial (6 floats: [XX, XY, XZ, YY, YZ, ZZ])
+    std::vector<float> h_constraintVirialScaled_;
+
     //! Leap-Frog integrator
     std::unique_ptr<LeapFrogGpu> integrator_;
+    //! Friction and noise part of the SD integrator, only used with the sd integrator
+    std::unique_ptr<SdGpu> sd_;
     //! LINCS GPU object to use for non-water constraints
     std::unique_ptr<LincsGpu> lincsGpu_;
     //! SETTLE GPU object for water constrains
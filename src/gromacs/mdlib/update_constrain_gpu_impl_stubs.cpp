@@ -71,6 +71,7 @@ UpdateConstrainGpu::UpdateConstrainGpu(const t_inputrec& /* ir   */,
 UpdateConstrainGpu::~UpdateConstrainGpu() = default;
 
 void UpdateConstrainGpu::integrate(GpuEventSynchronizer* /* fReadyOnDevice */,
+                                   const int64_t /* step */,
                                    const real /* dt */,
                                    const bool /* updateVelocities */,
                                    const bool /* computeVirial */,
@@ -79,6 +80,7 @@ void UpdateConstrainGpu::integrate(GpuEventSynchronizer* /* fReadyOnDevice */,
                                    gmx::ArrayRef<const t_grp_tcstat> /* tcstat */,
                                    const bool /* doParrinelloRahman */,
                                    const float /* dtPressureCouple */,
+                                   const bool /* isPmeRank */,
                                    const matrix /* prVelocityScalingMatrix*/)
 {
     GMX_ASSERT(!impl_,
@@ -99,9 +101,18 @@ void UpdateConstrainGpu::scaleVelocities(const matrix /* scalingMatrix */)
 
 void UpdateConstrainGpu::set(DeviceBuffer<RVec> /* d_x */,
                              DeviceBuffer<RVec> /* d_v */,
+                             const int /* realGridSize */,
+                             DeviceBuffer<real>* /* d_grid */,
                              const DeviceBuffer<RVec> /* d_f */,
                              const InteractionDefinitions& /* idef */,
-                             const t_mdatoms& /* md */)
+                             const t_mdatoms& /* md */,
+                             gmx::ArrayRef<const int> /* globalAtomIndices */)
+{
+    GMX_ASSERT(!impl_,
+               "A CPU stub for UpdateConstrain was called instead of the correct implementation.");
+}
+
+void UpdateConstrainGpu::updateTemperatureConstants(const t_inputrec& /* ir */)
 {
     GMX_ASSERT(!impl_,
                "A CPU stub for UpdateConstrain was called instead of the correct implementation.");
@@ -62,6 +62,7 @@
 #include "gromacs/mdtypes/commrec.h"
 #include "gromacs/pbcutil/ishift.h"
 #include "gromacs/pbcutil/pbc.h"
+#include "gromacs/simd/simd.h"
 #include "gromacs/timing/wallcycle.h"
 #include "gromacs/topology/ifunc.h"
 #include "gromacs/topology/mtop_util.h"
@@ -286,6 +287,8 @@ private:
     ArrayRef<const InteractionList> ilists_;
     //! Information for handling vsite threading
     ThreadingInfo threadingInfo_;
+    //! Whether F_VSITE3 positions can be constructed with SIMD, i.e. no constructing atom is a vsite
+    bool useSimdVsite3_ = false;
 };
 
 VirtualSitesHandler::~VirtualSitesHandler() = default;
@@ -899,6 +902,95 @@ static PbcMode getPbcMode(const t_pbc* pbcPtr)
     }
 }
 
+#if GMX_SIMD_HAVE_REAL
+/*! \brief Constructs the positions of F_VSITE3 sites without PBC using SIMD
+ *
+ * The vsites are processed in batches of GMX_SIMD_REAL_WIDTH, the remainder
+ * is constructed with the scalar code. As the coordinates of a whole batch are
+ * loaded before they are stored, none of the constructing atoms should be
+ * a vsite of the same type, which is checked in setVirtualSites().
+ *
+ * \param[in,out] x       Coordinates to construct vsites for
+ * \param[in]     ip      Interaction parameters
+ * \param[in]     iatoms  The F_VSITE3 interaction list atom entries
+ */
+static void constructVsite3Simd(ArrayRef<RVec> x, ArrayRef<const t_iparams> ip, ArrayRef<const int> iatoms)
+{
+    const int nral1     = 1 + NRAL(F_VSITE3);
+    const int numVsites = iatoms.ssize() / nral1;
+
+    /* gatherLoadUTranspose might load up to GMX_SIMD_REAL_WIDTH reals
+     * starting at a coordinate, we do not require x to be padded.
+     */
+    const int maxLoadAtom = x.ssize() - (GMX_SIMD_REAL_WIDTH + DIM - 1) / DIM;
+
+    real* gmx_restrict xBase = x[0];
+
+    alignas(GMX_SIMD_ALIGNMENT) std::int32_t av[GMX_SIMD_REAL_WIDTH];
+    alignas(GMX_SIMD_ALIGNMENT) std::int32_t ai[GMX_SIMD_REAL_WIDTH];
+    alignas(GMX_SIMD_ALIGNMENT) std::int32_t aj[GMX_SIMD_REAL_WIDTH];
+    alignas(GMX_SIMD_ALIGNMENT) std::int32_t ak[GMX_SIMD_REAL_WIDTH];
+    alignas(GMX_SIMD_ALIGNMENT) real         a[GMX_SIMD_REAL_WIDTH];
+    alignas(GMX_SIMD_ALIGNMENT) real         b[GMX_SIMD_REAL_WIDTH];
+
+    auto constructScalar = [x, ip, iatoms, nral1](int vsiteStart, int vsiteEnd) {
+        for (int v = vsiteStart; v < vsiteEnd; v++)
+        {
+            const int* ia = iatoms.data() + v * nral1;
+            constr_vsite3<VSiteCalculatePosition::Yes, VSiteCalculateVelocity::No>(x[ia[2]],
+                                                                                   x[ia[3]],
+                                                                                   x[ia[4]],
+                                                                                   x[ia[1]],
+                                                                                   ip[ia[0]].vsite.a,
+                                                                                   ip[ia[0]].vsite.b,
+                                                                                   nullptr,
+                                                                                   nullptr,
+                                                                                   nullptr,
+                                                                                   nullptr,
+                                                                                   nullptr);
+        }
+    };
+
+    int vsiteStart = 0;
+    for (; vsiteStart + GMX_SIMD_REAL_WIDTH <= numVsites; vsiteStart += GMX_SIMD_REAL_WIDTH)
+    {
+        int maxAtom = 0;
+        for (int s = 0; s < GMX_SIMD_REAL_WIDTH; s++)
+        {
+            const int* ia = iatoms.data() + (vsiteStart + s) * nral1;
+            av[s]         = ia[1];
+            ai[s]         = ia[2];
+            aj[s]         = ia[3];
+            ak[s]         = ia[4];
+            a[s]          = ip[ia[0]].vsite.a;
+            b[s]          = ip[ia[0]].vsite.b;
+            maxAtom       = std::max(maxAtom, std::max(ai[s], std::max(aj[s], ak[s])));
+        }
+        if (maxAtom > maxLoadAtom)
+        {
+            constructScalar(vsiteStart, vsiteStart + GMX_SIMD_REAL_WIDTH);
+            continue;
+        }
+
+        SimdReal xi, yi, zi, xj, yj, zj, xk, yk, zk;
+        gatherLoadUTranspose<3>(xBase, ai, &xi, &yi, &zi);
+        gatherLoadUTranspose<3>(xBase, aj, &xj, &yj, &zj);
+        gatherLoadUTranspose<3>(xBase, ak, &xk, &yk, &zk);
+
+        const SimdReal aS = load<SimdReal>(a);
+        const SimdReal bS = load<SimdReal>(b);
+        const SimdReal cS = SimdReal(1.0_real) - aS - bS;
+
+        const SimdReal xv = fma(aS, xj, fma(bS, xk, cS * xi));
+        const SimdReal yv = fma(aS, yj, fma(bS, yk, cS * yi));
+        const SimdReal zv = fma(aS, zj, fma(bS, zk, cS * zi));
+
+        transposeScatterStoreU<3>(xBase, av, xv, yv, zv);
+    }
+    constructScalar(vsiteStart, numVsites);
+}
+#endif // GMX_SIMD_HAVE_REAL
+
 /*! \brief Executes the vsite construction task for a single thread
  *
  * \tparam        operation  Whether we are calculating positions, velocities, or both
@@ -907,13 +999,15 @@ static PbcMode getPbcMode(const t_pbc* pbcPtr)
  * \param[in]     ip  Interaction parameters for all interaction, only vsite parameters are used
  * \param[in]     ilist  The interaction lists, only vsites are usesd
  * \param[in]     pbc_null  PBC struct, used for PBC distance calculations when !=nullptr
+ * \param[in]     useSimdVsite3  Whether F_VSITE3 positions can be constructed with SIMD
  */
 template<VSiteCalculatePosition calculatePosition, VSiteCalculateVelocity calculateVelocity>
 static void construct_vsites_thread(ArrayRef<RVec>                  x,
                                     ArrayRef<RVec>                  v,
                                     ArrayRef<const t_iparams>       ip,
                                     ArrayRef<const InteractionList> ilist,
-                                    const t_pbc*                    pbc_null)
+                                    const t_pbc*                    pbc_null,
+                                    const bool                      useSimdVsite3)
 {
     if (calculateVelocity == VSiteCalculateVelocity::Yes)
     {
@@ -956,6 +1050,18 @@ static void construct_vsites_thread(ArrayRef<RVec>                  x,
             continue;
         }
 
+#if GMX_SIMD_HAVE_REAL
+        if (ftype == F_VSITE3 && useSimdVsite3 && pbc_null == nullptr
+            && calculatePosition == VSiteCalculatePosition::Yes
+            && calculateVelocity == VSiteCalculateVelocity::No)
+        {
+            constructVsite3Simd(x, ip, ilist[ftype].iatoms);
+            continue;
+        }
+#else
+        GMX_UNUSED_VALUE(useSimdVsite3);
+#endif
+
         { // TODO remove me
             int nra = interaction_function[ftype].nratoms;
             int inc = 1 + nra;
@@ -1149,6 +1255,7 @@ static void construct_vsites_thread(ArrayRef<RVec>                  x,
  * \param[in]     ilist  The interaction lists, only vsites are usesd
  * \param[in]     domainInfo  Information about PBC and DD
  * \param[in]     box  Used for PBC when PBC is set in domainInfo
+ * \param[in]     useSimdVsite3  Whether F_VSITE3 positions can be constructed with SIMD
  */
 template<VSiteCalculatePosition calculatePosition, VSiteCalculateVelocity calculateVelocity>
 static void construct_vsites(const ThreadingInfo*            threadingInfo,
@@ -1157,7 +1264,8 @@ static void construct_vsites(const ThreadingInfo*            threadingInfo,
                              ArrayRef<const t_iparams>       ip,
                              ArrayRef<const InteractionList> ilist,
                              const DomainInfo&               domainInfo,
-                             const matrix                    box)
+                             const matrix                    box,
+                             const bool                      useSimdVsite3)
 {
     const bool useDomdec = domainInfo.useDomdec();
 
@@ -1198,7 +1306,8 @@ static void construct_vsites(const ThreadingInfo*            threadingInfo,
 
     if (threadingInfo == nullptr || threadingInfo->numThreads() == 1)
     {
-        construct_vsites_thread<calculatePosition, calculateVelocity>(x, v, ip, ilist, pbc_null);
+        construct_vsites_thread<calculatePosition, calculateVelocity>(
+                x, v, ip, ilist, pbc_null, useSimdVsite3);
     }
     else
     {
@@ -1212,7 +1321,7 @@ static void construct_vsites(const ThreadingInfo*            threadingInfo,
                            "The thread data should be initialized before calling construct_vsites");
 
                 construct_vsites_thread<calculatePosition, calculateVelocity>(
-                        x, v, ip, tData.ilist, pbc_null);
+                        x, v, ip, tData.ilist, pbc_null, useSimdVsite3);
                 if (tData.useInterdependentTask)
                 {
                     /* Here we don't need a barrier (unlike the spreading),
@@ -1220,14 +1329,19 @@ static void construct_vsites(const ThreadingInfo*            threadingInfo,
                      * or local vsites, not from non-local vsites.
                      */
                     construct_vsites_thread<calculatePosition, calculateVelocity>(
-                            x, v, ip, tData.idTask.ilist, pbc_null);
+                            x, v, ip, tData.idTask.ilist, pbc_null, useSimdVsite3);
                 }
             }
             GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
         }
         /* Now we can construct the vsites that might depend on other vsites */
         construct_vsites_thread<calculatePosition, calculateVelocity>(
-                x, v, ip, threadingInfo->threadDataNonLocalDependent().ilist, pbc_null);
+                x,
+                v,
+                ip,
+                threadingInfo->threadDataNonLocalDependent().ilist,
+                pbc_null,
+                useSimdVsite3);
     }
 }
 
@@ -1240,15 +1354,15 @@ void VirtualSitesHandler::Impl::construct(ArrayRef<RVec> x,
     {
         case VSiteOperation::Positions:
             construct_vsites<VSiteCalculatePosition::Yes, VSiteCalculateVelocity::No>(
-                    &threadingInfo_, x, v, iparams_, ilists_, domainInfo_, box);
+                    &threadingInfo_, x, v, iparams_, ilists_, domainInfo_, box, useSimdVsite3_);
             break;
         case VSiteOperation::Velocities:
             construct_vsites<VSiteCalculatePosition::No, VSiteCalculateVelocity::Yes>(
-                    &threadingInfo_, x, v, iparams_, ilists_, domainInfo_, box);
+                    &threadingInfo_, x, v, iparams_, ilists_, domainInfo_, box, useSimdVsite3_);
             break;
         case VSiteOperation::PositionsAndVelocities:
             construct_vsites<VSiteCalculatePosition::Yes, VSiteCalculateVelocity::Yes>(
-                    &threadingInfo_, x, v, iparams_, ilists_, domainInfo_, box);
+                    &threadingInfo_, x, v, iparams_, ilists_, domainInfo_, box, useSimdVsite3_);
             break;
         default: gmx_fatal(FARGS, "Unknown virtual site operation");
     }
@@ -1265,7 +1379,7 @@ void constructVirtualSites(ArrayRef<RVec> x, ArrayRef<const t_iparams> ip, Array
     // No PBC, no DD
     const DomainInfo domainInfo;
     construct_vsites<VSiteCalculatePosition::Yes, VSiteCalculateVelocity::No>(
-            nullptr, x, {}, ip, ilist, domainInfo, nullptr);
+            nullptr, x, {}, ip, ilist, domainInfo, nullptr, false);
 }
 
 #ifndef DOXYGEN
@@ -3130,6 +3244,23 @@ void VirtualSitesHandler::Impl::setVirtualSites(ArrayRef<const InteractionList>
 {
     ilists_ = ilists;
 
+    /* The SIMD construction loads all constructing atoms of a batch before
+     * storing, so we can only use it when none of them is a vsite.
+     */
+    useSimdVsite3_             = true;
+    const int           nral1  = 1 + NRAL(F_VSITE3);
+    ArrayRef<const int> iatoms = ilists[F_VSITE3].iatoms;
+    for (int i = 0; i < iatoms.ssize() && useSimdVsite3_; i += nral1)
+    {
+        for (int j = i + 2; j < i + nral1; j++)
+        {
+            if (ptype[iatoms[j]] == ParticleType::VSite)
+            {
+                useSimdVsite3_ = false;
+            }
+        }
+    }
+
     threadingInfo_.setVirtualSites(ilists, iparams_, numAtoms, homenr, ptype, domainInfo_.useDomdec());
 }
 
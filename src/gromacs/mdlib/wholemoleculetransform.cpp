@@ -37,7 +37,10 @@
 
 #include "wholemoleculetransform.h"
 
+#include <algorithm>
+
 #include "gromacs/domdec/ga2la.h"
+#include "gromacs/pbcutil/pbc.h"
 #include "gromacs/topology/mtop_util.h"
 
 namespace gmx
@@ -45,8 +48,9 @@ namespace gmx
 
 WholeMoleculeTransform::WholeMoleculeTransform(const gmx_mtop_t& mtop,
                                                const PbcType     pbcType,
-                                               const bool        useAtomReordering) :
-    pbcType_(pbcType)
+                                               const bool        useAtomReordering,
+                                               const int         numThreads) :
+    pbcType_(pbcType), numThreads_(std::max(numThreads, 1))
 {
     gmx_localtop_t localTop(mtop.ffparams);
 
@@ -68,6 +72,48 @@ WholeMoleculeTransform::WholeMoleculeTransform(const gmx_mtop_t& mtop,
         // Resize the edge color list for potential addition of non-connected atoms
         graph_.edgeColor.resize(graph_.edgeAtomEnd);
     }
+    else
+    {
+        buildFragmentTrees();
+    }
+}
+
+void WholeMoleculeTransform::buildFragmentTrees()
+{
+    fragmentAtoms_.clear();
+    fragmentParents_.clear();
+    fragmentStarts_.clear();
+
+    const int         edgeAtomBegin = graph_.edgeAtomBegin;
+    const int         numNodes      = graph_.numNodes();
+    std::vector<bool> isInFragment(numNodes, false);
+    // Using the lowest atom index as root gives the same shifts as mk_mshift()
+    for (int root = 0; root < numNodes; root++)
+    {
+        if (isInFragment[root] || graph_.edges[root].empty())
+        {
+            continue;
+        }
+        fragmentStarts_.push_back(fragmentAtoms_.size());
+        isInFragment[root] = true;
+        fragmentAtoms_.push_back(edgeAtomBegin + root);
+        fragmentParents_.push_back(-1);
+        // Breadth-first traversal, the fragment atom list serves as the queue
+        for (size_t i = fragmentStarts_.back(); i < fragmentAtoms_.size(); i++)
+        {
+            const int atom = fragmentAtoms_[i];
+            for (const int neighbor : graph_.edges[atom - edgeAtomBegin])
+            {
+                if (!isInFragment[neighbor - edgeAtomBegin])
+                {
+                    isInFragment[neighbor - edgeAtomBegin] = true;
+                    fragmentAtoms_.push_back(neighbor);
+                    fragmentParents_.push_back(atom);
+                }
+            }
+        }
+    }
+    fragmentStarts_.push_back(fragmentAtoms_.size());
 }
 
 void WholeMoleculeTransform::updateAtomOrder(ArrayRef<const int> globalAtomIndices, const gmx_ga2la_t& ga2la)
@@ -102,16 +148,92 @@ void WholeMoleculeTransform::updateAtomOrder(ArrayRef<const int> globalAtomIndic
 
     GMX_RELEASE_ASSERT(int(graph_.edges.size()) == graph_.shiftAtomEnd,
                        "We should have as many lists of edges as the system (shift) size");
+
+    buildFragmentTrees();
 }
 
 void WholeMoleculeTransform::updateForAtomPbcJumps(ArrayRef<const RVec> x, const matrix box)
 {
-    mk_mshift(nullptr, &graph_, pbcType_, box, as_rvec_array(x.data()));
+    if (pbcType_ == PbcType::Screw || fragmentStarts_.empty())
+    {
+        mk_mshift(nullptr, &graph_, pbcType_, box, as_rvec_array(x.data()));
+        return;
+    }
+
+    const int      npbcdim       = (pbcType_ == PbcType::XY ? 2 : 3);
+    const int      edgeAtomBegin = graph_.edgeAtomBegin;
+    const int      numFragments  = fragmentStarts_.size() - 1;
+    ArrayRef<IVec> ishift        = graph_.ishift;
+
+    // Atoms that are not in a fragment are not shifted
+    std::fill(ishift.begin(), ishift.begin() + graph_.shiftAtomEnd, IVec(0, 0, 0));
+
+    int numInconsistent = 0;
+#pragma omp parallel for num_threads(numThreads_) schedule(static) reduction(+ : numInconsistent)
+    for (int f = 0; f < numFragments; f++)
+    {
+        // Propagate the shifts from the root, which is not shifted, along the tree
+        for (int i = fragmentStarts_[f] + 1; i < fragmentStarts_[f + 1]; i++)
+        {
+            const int atom   = fragmentAtoms_[i];
+            const int parent = fragmentParents_[i];
+            mk_1shift_pbc(npbcdim, box, x[parent], x[atom], ishift[parent], ishift[atom]);
+        }
+        // Check that all bonds, not only those in the tree, agree with the shifts
+        for (int i = fragmentStarts_[f]; i < fragmentStarts_[f + 1]; i++)
+        {
+            const int atom = fragmentAtoms_[i];
+            for (const int neighbor : graph_.edges[atom - edgeAtomBegin])
+            {
+                ivec neighborShift;
+                mk_1shift_pbc(npbcdim, box, x[atom], x[neighbor], ishift[atom], neighborShift);
+                if (IVec(neighborShift) != ishift[neighbor])
+                {
+                    numInconsistent++;
+                }
+            }
+        }
+    }
+
+    if (numInconsistent > 0)
+    {
+        // Let the serial algorithm determine and report the shifts, e.g. for periodic molecules
+        mk_mshift(nullptr, &graph_, pbcType_, box, as_rvec_array(x.data()));
+    }
 }
 
 ArrayRef<const RVec> WholeMoleculeTransform::wholeMoleculeCoordinates(ArrayRef<const RVec> x, const matrix box)
 {
-    shift_x(&graph_, box, as_rvec_array(x.data()), as_rvec_array(wholeMoleculeCoordinates_.data()));
+    if (graph_.useScrewPbc)
+    {
+        shift_x(&graph_,
+                box,
+                as_rvec_array(x.data()),
+                as_rvec_array(wholeMoleculeCoordinates_.data()));
+
+        return wholeMoleculeCoordinates_;
+    }
+
+    const int            edgeAtomBegin = graph_.edgeAtomBegin;
+    const int            edgeAtomEnd   = graph_.edgeAtomEnd;
+    const int            numAtoms      = graph_.shiftAtomEnd;
+    ArrayRef<const IVec> ishift        = graph_.ishift;
+    ArrayRef<RVec>       xWhole        = wholeMoleculeCoordinates_;
+
+    // As shift_x(), but multi-threaded; for rectangular boxes the off-diagonal terms are zero
+#pragma omp parallel for num_threads(numThreads_) schedule(static)
+    for (int a = 0; a < numAtoms; a++)
+    {
+        if (a < edgeAtomBegin || a >= edgeAtomEnd)
+        {
+            xWhole[a] = x[a];
+            continue;
+        }
+        const IVec& s = ishift[a];
+        xWhole[a][XX] = x[a][XX] + s[XX] * box[XX][XX] + s[YY] * box[YY][XX] + s[ZZ] * box[ZZ][XX];
+        xWhole[a][YY] = x[a][YY] + s[YY] * box[YY][YY] + s[ZZ] * box[ZZ][YY];
+        xWhole[a][ZZ] = x[a][ZZ] + s[ZZ] * box[ZZ][ZZ];
+    }
 
     return wholeMoleculeCoordinates_;
 }
@@ -72,8 +72,12 @@ public:
      * \param[in] mtop               The global topology use for getting the connections between atoms
      * \param[in] pbcType            The type of PBC
      * \param[in] useAtomReordering  Whether we will use atom reordering
+     * \param[in] numThreads         The number of OpenMP threads to use
      */
-    WholeMoleculeTransform(const gmx_mtop_t& mtop, PbcType pbcType, bool useAtomReordering);
+    WholeMoleculeTransform(const gmx_mtop_t& mtop,
+                           PbcType           pbcType,
+                           bool              useAtomReordering,
+                           int               numThreads = 1);
 
     /*! \brief Changes the atom order to the one provided
      *
@@ -85,7 +89,13 @@ public:
      */
     void updateAtomOrder(ArrayRef<const int> globalAtomIndices, const gmx_ga2la_t& ga2la);
 
-    /*! \brief Updates the graph when atoms have been shifted by periodic vectors */
+    /*! \brief Updates the graph when atoms have been shifted by periodic vectors
+     *
+     * The shifts are computed in parallel over the connected fragments of the graph,
+     * along a precomputed spanning tree of each fragment. When any bond in a fragment
+     * is inconsistent with these shifts, e.g. for periodic molecules, the shifts are
+     * recomputed, and the problem is reported, by the serial graph algorithm.
+     */
     void updateForAtomPbcJumps(ArrayRef<const RVec> x, const matrix box);
 
     /*! \brief Create and return coordinates with whole molecules for input coordinates \p x
@@ -100,14 +110,25 @@ public:
     ArrayRef<const RVec> wholeMoleculeCoordinates(ArrayRef<const RVec> x, const matrix box);
 
 private:
+    //! Builds the spanning trees of the connected fragments from the current graph edges
+    void buildFragmentTrees();
+
     //! The type of PBC
     PbcType pbcType_;
+    //! The number of OpenMP threads to use
+    int numThreads_;
     //! The graph
     t_graph graph_;
     //! The atom index at which graphGlobalAtomOrderEdges_ starts
     int globalEdgeAtomBegin_;
     //! The edges for the global atom order
     ListOfLists<int> graphGlobalAtomOrderEdges_;
+    //! The atoms of all fragments, per fragment in breadth-first order from its lowest index
+    std::vector<int> fragmentAtoms_;
+    //! For each entry in \p fragmentAtoms_ the atom it is bonded to in the tree, -1 for roots
+    std::vector<int> fragmentParents_;
+    //! The start of each fragment in \p fragmentAtoms_, plus the end of the last fragment
+    std::vector<int> fragmentStarts_;
     //! Buffer for storing coordinates for whole molecules
     std::vector<RVec> wholeMoleculeCoordinates_;
 };
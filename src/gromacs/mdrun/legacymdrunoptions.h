@@ -127,7 +127,9 @@ public:
                                           { efTOP, "-mp", "membed", ffOPTRD },
                                           { efNDX, "-mn", "membed", ffOPTRD },
                                           { efXVG, "-if", "imdforces", ffOPTWR },
-                                          { efXVG, "-swap", "swapions", ffOPTWR } } };
+                                          { efXVG, "-swap", "swapions", ffOPTWR },
+                                          { efJSON, "-perf", "perf", ffOPTWR },
+                                          { efOUT, "-tuneout", "tune", ffOPTWR } } };
 
     //! Print a warning if any force is larger than this (in kJ/mol nm).
     real pforce = -1;
@@ -135,6 +137,12 @@ public:
     //! The value of the -append option
     bool appendOption = true;
 
+    //! Whether to tune the run configuration instead of running the simulation
+    bool tuneRunConfiguration = false;
+
+    //! The number of steps of each run while tuning the run configuration
+    int tuneNumSteps = 2000;
+
     /*! \brief Output context for writing text files
      *
      * \todo Clarify initialization, ownership, and lifetime. */
@@ -169,7 +177,7 @@ public:
 
     ImdOptions& imdOptions = mdrunOptions.imdOptions;
 
-    t_pargs pa[48] = {
+    t_pargs pa[50] = {
 
         { "-dd", FALSE, etRVEC, { &realddxyz }, "Domain decomposition grid, 0 is optimize" },
         { "-ddorder", FALSE, etENUM, { ddrank_opt_choices }, "DD rank order" },
@@ -382,7 +390,18 @@ public:
           etBOOL,
           { &mdrunOptions.timingOptions.resetHalfway },
           "HIDDENReset the cycle counters after half the number of steps or halfway "
-          "[TT]-maxh[tt]" }
+          "[TT]-maxh[tt]" },
+        { "-tune",
+          FALSE,
+          etBOOL,
+          { &tuneRunConfiguration },
+          "Tune the thread, rank and GPU offload setup with short runs and write the fastest "
+          "setup as mdrun arguments to [TT]-tuneout[tt]" },
+        { "-tunesteps",
+          FALSE,
+          etINT,
+          { &tuneNumSteps },
+          "Number of steps of each run with [TT]-tune[tt]" }
     };
     /*! \} */
 
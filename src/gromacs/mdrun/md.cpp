@@ -92,6 +92,7 @@
 #include "gromacs/mdlib/freeenergyparameters.h"
 #include "gromacs/mdlib/md_support.h"
 #include "gromacs/mdlib/mdatoms.h"
+#include "gromacs/mdlib/mdgraph_gpu.h"
 #include "gromacs/mdlib/mdoutf.h"
 #include "gromacs/mdlib/membed.h"
 #include "gromacs/mdlib/resethandler.h"
@@ -132,12 +133,14 @@
 #include "gromacs/mdtypes/state.h"
 #include "gromacs/mdtypes/state_propagator_data_gpu.h"
 #include "gromacs/modularsimulator/energydata.h"
+#include "gromacs/nbnxm/cpu_layout_tuning.h"
 #include "gromacs/nbnxm/gpu_data_mgmt.h"
 #include "gromacs/nbnxm/nbnxm.h"
 #include "gromacs/pbcutil/pbc.h"
 #include "gromacs/pulling/output.h"
 #include "gromacs/pulling/pull.h"
 #include "gromacs/swap/swapcoords.h"
+#include "gromacs/timing/steptimestatistics.h"
 #include "gromacs/timing/wallcycle.h"
 #include "gromacs/timing/walltime_accounting.h"
 #include "gromacs/topology/atoms.h"
@@ -342,6 +345,27 @@ void gmx::LegacySimulator::do_md()
     const bool  useGpuForNonbonded = simulationWork.useGpuNonbonded;
     const bool  useGpuForUpdate    = simulationWork.useGpuUpdate;
 
+    if (getenv("GMX_COMPENSATED_UPDATE") != nullptr)
+    {
+        if (useGpuForUpdate || ir->eI != IntegrationAlgorithm::MD)
+        {
+            GMX_LOG(mdlog.info)
+                    .asParagraph()
+                    .appendText(
+                            "GMX_COMPENSATED_UPDATE is set, but the compensated position update "
+                            "is only supported with the md integrator on the CPU; ignoring it.");
+        }
+        else
+        {
+            upd.setUseCompensatedPositionUpdate(true);
+            GMX_LOG(mdlog.info)
+                    .asParagraph()
+                    .appendText(
+                            "Using compensated summation for the position update, as requested "
+                            "by GMX_COMPENSATED_UPDATE.");
+        }
+    }
+
     /* Check for polarizable models and flexible constraints */
     shellfc = init_shell_flexcon(fplog,
                                  top_global,
@@ -488,6 +512,17 @@ void gmx::LegacySimulator::do_md()
         integrator->setPbc(PbcType::Xyz, state->box);
     }
 
+    std::unique_ptr<MdGpuGraph> mdGraph;
+    if (simulationWork.useMdGpuGraph)
+    {
+        GMX_LOG(mdlog.info)
+                .asParagraph()
+                .appendText(
+                        "The GPU work of regular steps will be captured into a graph and "
+                        "replayed until the next pair-search step.");
+        mdGraph = std::make_unique<MdGpuGraph>(*fr->deviceStreamManager, wcycle);
+    }
+
     if (useGpuForPme || simulationWork.useGpuXBufferOps || useGpuForUpdate)
     {
         changePinningPolicy(&state->x, PinningPolicy::PinnedIfSupported);
@@ -497,6 +532,22 @@ void gmx::LegacySimulator::do_md()
         changePinningPolicy(&state->v, PinningPolicy::PinnedIfSupported);
     }
 
+    // With GPU update and without DD the home atoms are in global order, so on steps where
+    // only compressed coordinates are written we only need to copy the atoms up to the last
+    // atom in the compressed output group.
+    int numAtomsForCompressedOutput = state->natoms;
+    if (useGpuForUpdate && !haveDDAtomOrdering(*cr) && ir->nstxout_compressed > 0)
+    {
+        while (numAtomsForCompressedOutput > 0
+               && getGroupType(*groups,
+                               SimulationAtomGroupType::CompressedPositionOutput,
+                               numAtomsForCompressedOutput - 1)
+                          != 0)
+        {
+            numAtomsForCompressedOutput--;
+        }
+    }
+
     // NOTE: The global state is no longer used at this point.
     // But state_global is still used as temporary storage space for writing
     // the global state to file and potentially for replica exchange.
@@ -556,6 +607,23 @@ void gmx::LegacySimulator::do_md()
                 &pme_loadbal, cr, mdlog, *ir, state->box, *fr->ic, *fr->nbv, fr->pmedata, fr->nbv->useGpu());
     }
 
+    /* Online step time statistics and straggler detection over the PP ranks */
+    std::unique_ptr<StepTimeStatistics> stepTimeStatistics;
+    if (getenv("GMX_DETECT_STRAGGLERS") != nullptr && wallcycle_have_counter())
+    {
+        stepTimeStatistics = std::make_unique<StepTimeStatistics>(mdlog, cr, ir->nstlist);
+    }
+    const bool pmeTuningIgnoresStragglers =
+            (stepTimeStatistics && getenv("GMX_PME_TUNING_IGNORE_STRAGGLERS") != nullptr);
+
+    /* With CPU non-bondeds we can time both SIMD cluster layouts */
+    std::unique_ptr<Nbnxm::CpuLayoutTuning> cpuLayoutTuning;
+    if (Nbnxm::CpuLayoutTuning::isSupported(
+                fr->nbv->kernelSetup(), cr, *ir, mdrunOptions.reproducible))
+    {
+        cpuLayoutTuning = std::make_unique<Nbnxm::CpuLayoutTuning>(fr->nbv->kernelSetup());
+    }
+
     if (!ir->bContinuation)
     {
         if (state->flags & enumValueToBitMask(StateEntry::V))
@@ -875,10 +943,21 @@ void gmx::LegacySimulator::do_md()
                            step,
                            step_rel,
                            &bPMETunePrinting,
-                           simulationWork.useGpuPmePpCommunication);
+                           simulationWork.useGpuPmePpCommunication,
+                           pmeTuningIgnoresStragglers ? stepTimeStatistics.get() : nullptr);
             hipRangePop();
         }
 
+        /* PME tuning changes the cut-off and the PP cost, so wait for it to finish.
+         * pme_loadbal only copied the pairlist radii of the original fr->nbv at init.
+         */
+        if (cpuLayoutTuning && cpuLayoutTuning->isActive() && bNStList
+            && !pme_loadbal_is_active(pme_loadbal))
+        {
+            /* This can replace fr->nbv, so it has to precede the search at this step */
+            cpuLayoutTuning->tune(mdlog, *ir, fr, cr, top_global, state->box, wcycle);
+        }
+
         wallcycle_start(wcycle, WallCycleCounter::Step);
 
         bLastStep = (step_rel == ir->nsteps);
@@ -903,6 +982,10 @@ void gmx::LegacySimulator::do_md()
             // Simulated annealing updates the reference temperature.
             auto* nonConstInputrec = const_cast<t_inputrec*>(inputrec);
             update_annealing_target_temp(nonConstInputrec, t, &upd);
+            if (useGpuForUpdate)
+            {
+                integrator->updateTemperatureConstants(*ir);
+            }
         }
 
         /* Stop Center of Mass motion */
@@ -1121,6 +1204,45 @@ void gmx::LegacySimulator::do_md()
             force_flags |= GMX_FORCE_DO_NOT_NEED_NORMAL_FORCE;
         }
 
+        // The GPU work of regular steps, which launch the same work as the previous regular
+        // step and need no results on the host, is captured into and replayed from a graph.
+        bool replayMdGpuGraphThisStep = false;
+        if (mdGraph)
+        {
+            if (bNS)
+            {
+                mdGraph->reset();
+            }
+            const bool haveCouplingThisStep =
+                    (ir->etc != TemperatureCoupling::No
+                     && do_per_step(step + ir->nsttcouple - 1, ir->nsttcouple))
+                    || (ir->epc != PressureCoupling::No
+                        && (do_per_step(step, ir->nstpcouple)
+                            || do_per_step(step + ir->nstpcouple - 1, ir->nstpcouple)));
+            const bool haveOutputThisStep =
+                    do_per_step(step, ir->nstxout) || do_per_step(step, ir->nstvout)
+                    || do_per_step(step, ir->nstfout) || do_per_step(step, ir->nstxout_compressed)
+                    || checkpointHandler->isCheckpointingStep();
+            // The velocities are copied to the host after the update when the next step
+            // computes globals.
+            const bool needStateOnHostAfterUpdate =
+                    (do_per_step(step + 1, nstglobalcomm) || step_rel + 1 == ir->nsteps);
+            const bool canUseMdGpuGraphThisStep =
+                    !bNS && !bFirstStep && !bLastStep && !bGStat && !bCalcVir && !bCalcEner
+                    && !computeDHDL && !do_ene && !do_log && !bDoReplEx && !bDoExpanded
+                    && !haveCouplingThisStep && !haveOutputThisStep && !needStateOnHostAfterUpdate
+                    && !EI_VV(ir->eI) && shellfc == nullptr && vsite == nullptr
+                    && !runScheduleWork->domainWork.haveCpuLocalForceWork
+                    && !fr->nbv->isDynamicPruningStepGpu(step);
+            mdGraph->setUseGraphThisStep(canUseMdGpuGraphThisStep);
+            if (mdGraph->graphIsCapturingThisStep())
+            {
+                mdGraph->startRecord(integrator->xUpdatedOnDeviceEvent());
+            }
+            replayMdGpuGraphThisStep =
+                    mdGraph->useGraphThisStep() && !mdGraph->graphIsCapturingThisStep();
+        }
+
         if (shellfc)
         {
             /* Now is the time to relax the shells */
@@ -1158,7 +1280,7 @@ void gmx::LegacySimulator::do_md()
                                 vsite,
                                 ddBalanceRegionHandler);
         }
-        else
+        else if (!replayMdGpuGraphThisStep)
         {
             /* The AWH history need to be saved _before_ doing force calculations where the AWH bias
                is updated (or the AWH update will be performed twice for one step when continuing).
@@ -1305,7 +1427,17 @@ void gmx::LegacySimulator::do_md()
                 || checkpointHandler->isCheckpointingStep()))
         {
             hipRangePush("GpuUpdate_localForces");
-            stateGpu->copyCoordinatesFromGpu(state->x, AtomLocality::Local);
+            const bool onlyCompressedOutput = !do_per_step(step, ir->nstxout)
+                                              && !checkpointHandler->isCheckpointingStep()
+                                              && !bLastStep;
+            if (onlyCompressedOutput && numAtomsForCompressedOutput < state->natoms)
+            {
+                stateGpu->copyCoordinateRangeFromGpu(state->x, 0, numAtomsForCompressedOutput);
+            }
+            else
+            {
+                stateGpu->copyCoordinatesFromGpu(state->x, AtomLocality::Local);
+            }
             stateGpu->waitCoordinatesReadyOnHost(AtomLocality::Local);
             hipRangePop();
         }
@@ -1510,7 +1642,12 @@ void gmx::LegacySimulator::do_md()
         }
         else
         {
-            if (useGpuForUpdate)
+            if (replayMdGpuGraphThisStep)
+            {
+                // The whole step, including the update, is launched as a single graph
+                mdGraph->launchGraphMdStep(integrator->xUpdatedOnDeviceEvent());
+            }
+            else if (useGpuForUpdate)
             {
                 // On search steps, update handles to device vectors
                 // TODO: this condition has redundant / unnecessary clauses
@@ -1522,7 +1659,10 @@ void gmx::LegacySimulator::do_md()
                                     &d_grid,
                                     stateGpu->getForces(),
                                     top->idef,
-                                    *md);
+                                    *md,
+                                    haveDDAtomOrdering(*cr)
+                                            ? gmx::ArrayRef<const int>(cr->dd->globalAtomIndices)
+                                            : gmx::ArrayRef<const int>());
 
                     // Copy data to the GPU after buffers might have been reinitialized
                     /* The velocity copy is redundant if we had Center-of-Mass motion removed on
@@ -1556,6 +1696,7 @@ void gmx::LegacySimulator::do_md()
                 // This applies Leap-Frog, LINCS and SETTLE in succession
                 integrator->integrate(stateGpu->getLocalForcesReadyOnDeviceEvent(
                                               runScheduleWork->stepWork, runScheduleWork->simulationWork),
+                                      step,
                                       ir->delta_t,
                                       true,
                                       bCalcVir,
@@ -1566,6 +1707,13 @@ void gmx::LegacySimulator::do_md()
                                       ir->nstpcouple * ir->delta_t,
                                       runScheduleWork->stepWork.haveGpuPmeOnThisRank, 
                                       M);
+
+                if (mdGraph && mdGraph->graphIsCapturingThisStep())
+                {
+                    // Nothing has been executed during the capture, launch the captured step
+                    mdGraph->endRecord();
+                    mdGraph->launchGraphMdStep(integrator->xUpdatedOnDeviceEvent());
+                }
             }
             else
             {
@@ -1672,9 +1820,13 @@ void gmx::LegacySimulator::do_md()
 
             if (useGpuForUpdate)
             {
+                // Only the angular and acceleration-corrected COM removal modes use
+                // the coordinates, linear COM removal only needs the velocities.
                 const bool coordinatesRequiredForStopCM =
                         bStopCM && (bGStat || needHalfStepKineticEnergy || doInterSimSignal)
-                        && !EI_VV(ir->eI);
+                        && !EI_VV(ir->eI)
+                        && (ir->comm_mode == ComRemovalAlgorithm::Angular
+                            || ir->comm_mode == ComRemovalAlgorithm::LinearAccelerationCorrection);
 
                 // Copy coordinates when needed to stop the CM motion or for replica exchange
                 if (coordinatesRequiredForStopCM || bDoReplEx)
@@ -1744,13 +1896,19 @@ void gmx::LegacySimulator::do_md()
                     // TODO: The special case of removing CM motion should be dealt more gracefully
                     if (useGpuForUpdate)
                     {
-                        // Issue #3988, #4106.
-                        stateGpu->resetCoordinatesCopiedToDeviceEvent(AtomLocality::Local);
-                        stateGpu->copyCoordinatesToGpu(state->x, AtomLocality::Local);
-                        // Here we block until the H2D copy completes because event sync with the
-                        // force kernels that use the coordinates on the next steps is not implemented
-                        // (not because of a race on state->x being modified on the CPU while H2D is in progress).
-                        stateGpu->waitCoordinatesCopiedToDevice(AtomLocality::Local);
+                        // Only the acceleration-corrected COM removal changes the coordinates,
+                        // otherwise the coordinates on the GPU are up to date.
+                        if (vcm.mode == ComRemovalAlgorithm::LinearAccelerationCorrection)
+                        {
+                            // Issue #3988, #4106.
+                            stateGpu->resetCoordinatesCopiedToDeviceEvent(AtomLocality::Local);
+                            stateGpu->copyCoordinatesToGpu(state->x, AtomLocality::Local);
+                            // Here we block until the H2D copy completes because event sync
+                            // with the force kernels that use the coordinates on the next steps
+                            // is not implemented (not because of a race on state->x being
+                            // modified on the CPU while H2D is in progress).
+                            stateGpu->waitCoordinatesCopiedToDevice(AtomLocality::Local);
+                        }
                         // If the COM removal changed the velocities on the CPU, this has to be accounted for.
                         if (vcm.mode != ComRemovalAlgorithm::No)
                         {
@@ -2041,6 +2199,10 @@ void gmx::LegacySimulator::do_md()
         {
             dd_cycles_add(cr->dd, cycles, ddCyclStep);
         }
+        if (stepTimeStatistics)
+        {
+            stepTimeStatistics->addStep(step, cycles, wcycle);
+        }
 
         /* increase the MD step number */
         step++;
@@ -2087,6 +2249,11 @@ void gmx::LegacySimulator::do_md()
     }
     done_mdoutf(outf);
 
+    if (stepTimeStatistics)
+    {
+        stepTimeStatistics->printSummary();
+    }
+
     if (bPMETune)
     {
         pme_loadbal_done(pme_loadbal, fplog, mdlog, fr->nbv->useGpu());
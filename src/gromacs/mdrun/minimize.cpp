@@ -898,6 +898,9 @@ class EnergyEvaluator
 {
 public:
     /*! \brief Evaluates an energy on the state in \c ems.
+     *
+     * With \p computeEnergyAndVirial=false only the forces are computed,
+     * the energies, virial and pressure are then not valid.
      *
      * \todo In practice, the same objects mu_tot, vir, and pres
      * are always passed to this function, so we would rather have
@@ -905,7 +908,14 @@ public:
      * unsuited for aggregate initialization. When the types
      * improve, the call signature of this method can be reduced.
      */
-    void run(em_state_t* ems, rvec mu_tot, tensor vir, tensor pres, int64_t count, gmx_bool bFirst, int64_t step);
+    void run(em_state_t* ems,
+             rvec        mu_tot,
+             tensor      vir,
+             tensor      pres,
+             int64_t     count,
+             gmx_bool    bFirst,
+             int64_t     step,
+             bool        computeEnergyAndVirial = true);
     //! Handles logging (deprecated).
     FILE* fplog;
     //! Handles logging.
@@ -950,7 +960,14 @@ public:
     std::vector<RVec> pairSearchCoordinates;
 };
 
-void EnergyEvaluator::run(em_state_t* ems, rvec mu_tot, tensor vir, tensor pres, int64_t count, gmx_bool bFirst, int64_t step)
+void EnergyEvaluator::run(em_state_t* ems,
+                          rvec        mu_tot,
+                          tensor      vir,
+                          tensor      pres,
+                          int64_t     count,
+                          gmx_bool    bFirst,
+                          int64_t     step,
+                          bool        computeEnergyAndVirial)
 {
     real     t;
     gmx_bool bNS;
@@ -1001,6 +1018,9 @@ void EnergyEvaluator::run(em_state_t* ems, rvec mu_tot, tensor vir, tensor pres,
 
     fr->longRangeNonbondeds->updateAfterPartition(*mdAtoms->mdatoms());
 
+    /* The virial is not touched by do_force when it is not computed */
+    clear_mat(force_vir);
+
     /* Calc force & energy on new trial position  */
     /* do_force always puts the charge groups in the box and shifts again
      * We do not unshift, so molecules are always whole in congrad.c
@@ -1032,7 +1052,8 @@ void EnergyEvaluator::run(em_state_t* ems, rvec mu_tot, tensor vir, tensor pres,
              t,
              nullptr,
              fr->longRangeNonbondeds.get(),
-             GMX_FORCE_STATECHANGED | GMX_FORCE_ALLFORCES | GMX_FORCE_VIRIAL | GMX_FORCE_ENERGY
+             GMX_FORCE_STATECHANGED | GMX_FORCE_ALLFORCES
+                     | (computeEnergyAndVirial ? GMX_FORCE_VIRIAL | GMX_FORCE_ENERGY : 0)
                      | (bNS ? GMX_FORCE_NS : 0),
              DDBalanceRegionHandler(cr));
 
@@ -1241,6 +1262,63 @@ static real pr_beta(const t_commrec*  cr,
     return sum / gmx::square(s_min->fnorm);
 }
 
+/*! \brief Returns the dot product of \p a and \p b
+ *
+ * Each OpenMP thread sums a contiguous block and the block sums are
+ * added in thread order, so the result only depends on the number of
+ * threads and is identical to a serial sum when using a single thread.
+ */
+template<typename SumType>
+static SumType dotProduct(ArrayRef<const real> a, ArrayRef<const real> b)
+{
+    GMX_ASSERT(a.size() == b.size(), "The vectors should have equal sizes");
+
+    const int            numThreads = std::max(gmx_omp_nthreads_get(ModuleMultiThread::Update), 1);
+    const int64_t        n          = a.ssize();
+    std::vector<SumType> threadSum(numThreads, 0);
+
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int thread = 0; thread < numThreads; thread++)
+    {
+        const int64_t begin = (n * thread) / numThreads;
+        const int64_t end   = (n * (thread + 1)) / numThreads;
+
+        SumType sum = 0;
+        for (int64_t i = begin; i < end; i++)
+        {
+            sum += a[i] * b[i];
+        }
+        threadSum[thread] = sum;
+    }
+
+    SumType sum = 0;
+    for (const SumType partialSum : threadSum)
+    {
+        sum += partialSum;
+    }
+
+    return sum;
+}
+
+//! Adds \p factor times \p x to \p y
+static void addScaledVector(ArrayRef<real> y, const real factor, ArrayRef<const real> x)
+{
+    GMX_ASSERT(x.size() == y.size(), "The vectors should have equal sizes");
+
+    const int gmx_unused numThreads = gmx_omp_nthreads_get(ModuleMultiThread::Update);
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int64_t i = 0; i < x.ssize(); i++)
+    {
+        y[i] += factor * x[i];
+    }
+}
+
+//! Returns a flat view of the coordinate components of the first \p numAtoms atoms in \p v
+static ArrayRef<const real> flatView(ArrayRef<const RVec> v, const int numAtoms)
+{
+    return gmx::arrayRefFromArray(v.data()[0].as_vec(), DIM * numAtoms);
+}
+
 namespace gmx
 {
 
@@ -1577,16 +1655,9 @@ void LegacySimulator::do_cg()
         observablesReducer.markAsReadyToReduce();
 
         /* Calc derivative along line */
-        const rvec*                    pc  = s_c->s.cg_p.rvec_array();
-        gmx::ArrayRef<const gmx::RVec> sfc = s_c->f.view().force();
-        double                         gpc = 0;
-        for (int i = 0; i < mdatoms->homenr; i++)
-        {
-            for (m = 0; m < DIM; m++)
-            {
-                gpc -= pc[i][m] * sfc[i][m]; /* f is negative gradient, thus the sign */
-            }
-        }
+        /* f is negative gradient, thus the sign */
+        double gpc = -dotProduct<double>(flatView(s_c->s.cg_p, mdatoms->homenr),
+                                         flatView(s_c->f.view().force(), mdatoms->homenr));
         /* Sum the gradient along the line across CPUs */
         if (PAR(cr))
         {
@@ -1695,16 +1766,9 @@ void LegacySimulator::do_cg()
                 /* p does not change within a step, but since the domain decomposition
                  * might change, we have to use cg_p of s_b here.
                  */
-                const rvec*                    pb  = s_b->s.cg_p.rvec_array();
-                gmx::ArrayRef<const gmx::RVec> sfb = s_b->f.view().force();
-                gpb                                = 0;
-                for (int i = 0; i < mdatoms->homenr; i++)
-                {
-                    for (m = 0; m < DIM; m++)
-                    {
-                        gpb -= pb[i][m] * sfb[i][m]; /* f is negative gradient, thus the sign */
-                    }
-                }
+                /* f is negative gradient, thus the sign */
+                gpb = -dotProduct<double>(flatView(s_b->s.cg_p, mdatoms->homenr),
+                                          flatView(s_b->f.view().force(), mdatoms->homenr));
                 /* Sum the gradient along the line across CPUs */
                 if (PAR(cr))
                 {
@@ -2264,11 +2328,7 @@ void LegacySimulator::do_lbfgs()
         const real* ff = static_cast<real*>(ems.f.view().force().data()[0]);
 
         // calculate line gradient in position A
-        double gpa = 0;
-        for (int i = 0; i < n; i++)
-        {
-            gpa -= s[i] * ff[i];
-        }
+        double gpa = -dotProduct<double>(s, gmx::arrayRefFromArray(ff, n));
 
         /* Calculate minimum allowed stepsize along the line, before the average (norm)
          * relative change in coordinate is smaller than precision
@@ -2370,11 +2430,7 @@ void LegacySimulator::do_lbfgs()
 
         // Calc line gradient in position C
         real*  fc  = static_cast<real*>(sc->f.view().force()[0]);
-        double gpc = 0;
-        for (int i = 0; i < n; i++)
-        {
-            gpc -= s[i] * fc[i]; /* f is negative gradient, thus the sign */
-        }
+        double gpc = -dotProduct<double>(s, gmx::arrayRefFromArray(fc, n));
         /* Sum the gradient along the line across CPUs */
         if (PAR(cr))
         {
@@ -2455,11 +2511,7 @@ void LegacySimulator::do_lbfgs()
 
                 // Calculate gradient in point B
                 real*  fb  = static_cast<real*>(sb->f.view().force()[0]);
-                double gpb = 0;
-                for (int i = 0; i < n; i++)
-                {
-                    gpb -= s[i] * fb[i]; /* f is negative gradient, thus the sign */
-                }
+                double gpb = -dotProduct<double>(s, gmx::arrayRefFromArray(fb, n));
                 /* Sum the gradient along the line across CPUs */
                 if (PAR(cr))
                 {
@@ -2557,13 +2609,8 @@ void LegacySimulator::do_lbfgs()
             dx[point][i] *= step_taken;
         }
 
-        real dgdg = 0;
-        real dgdx = 0;
-        for (int i = 0; i < n; i++)
-        {
-            dgdg += dg[point][i] * dg[point][i];
-            dgdx += dg[point][i] * dx[point][i];
-        }
+        const real dgdg = dotProduct<real>(dg[point], dg[point]);
+        const real dgdx = dotProduct<real>(dg[point], dx[point]);
 
         const real diag = dgdx / dgdg;
 
@@ -2592,18 +2639,11 @@ void LegacySimulator::do_lbfgs()
                 cp = ncorr - 1;
             }
 
-            real sq = 0;
-            for (int i = 0; i < n; i++)
-            {
-                sq += dx[cp][i] * p[i];
-            }
+            const real sq = dotProduct<real>(dx[cp], p);
 
             alpha[cp] = rho[cp] * sq;
 
-            for (int i = 0; i < n; i++)
-            {
-                p[i] -= alpha[cp] * dg[cp][i];
-            }
+            addScaledVector(p, -alpha[cp], dg[cp]);
         }
 
         for (int i = 0; i < n; i++)
@@ -2614,19 +2654,12 @@ void LegacySimulator::do_lbfgs()
         /* And then go forward again */
         for (int k = 0; k < ncorr; k++)
         {
-            real yr = 0;
-            for (int i = 0; i < n; i++)
-            {
-                yr += p[i] * dg[cp][i];
-            }
+            const real yr = dotProduct<real>(p, dg[cp]);
 
             real beta = rho[cp] * yr;
             beta      = alpha[cp] - beta;
 
-            for (int i = 0; i < n; i++)
-            {
-                p[i] += beta * dx[cp][i];
-            }
+            addScaledVector(p, beta, dx[cp]);
 
             cp++;
             if (cp >= ncorr)
@@ -3380,7 +3413,9 @@ void LegacySimulator::do_nm()
                 }
                 else
                 {
-                    energyEvaluator.run(&state_work, mu_tot, vir, pres, aid * 2 + dx, FALSE, step);
+                    // Only the forces are needed for the Hessian
+                    energyEvaluator.run(
+                            &state_work, mu_tot, vir, pres, aid * 2 + dx, FALSE, step, false);
                 }
 
                 cr->nnodes = nnodes;
@@ -51,8 +51,10 @@
 #include "config.h"
 
 #include <cmath>
+#include <cstring>
 
 #include <random>
+#include <vector>
 
 #include "gromacs/domdec/collect.h"
 #include "gromacs/gmxlib/network.h"
@@ -507,121 +509,84 @@ gmx_repl_ex_t init_replica_exchange(FILE*                            fplog,
     return re;
 }
 
-static void exchange_reals(const gmx_multisim_t gmx_unused* ms, int gmx_unused b, real* v, int n)
+/*! \brief A contiguous block of state data that is exchanged between replicas */
+struct ExchangedStateBlock
 {
-    real* buf;
-    int   i;
+    //! Pointer to the data, can be nullptr when \p numBytes is zero
+    void* data;
+    //! The number of bytes to exchange
+    size_t numBytes;
+};
 
-    if (v)
-    {
-        snew(buf, n);
-#if GMX_MPI
-        /*
-           MPI_Sendrecv(v,  n*sizeof(real),MPI_BYTE,MSRANK(ms,b),0,
-           buf,n*sizeof(real),MPI_BYTE,MSRANK(ms,b),0,
-           ms->mastersComm_,MPI_STATUS_IGNORE);
-         */
-        {
-            MPI_Request mpi_req;
+static void exchange_state(const gmx_multisim_t gmx_unused* ms, int gmx_unused b, t_state* state)
+{
+    /* When t_state changes, this code should be updated. */
+    int ngtc, nnhpres;
+    ngtc    = state->ngtc * state->nhchainlength;
+    nnhpres = state->nnhpres * state->nhchainlength;
 
-            MPI_Isend(v, n * sizeof(real), MPI_BYTE, MSRANK(ms, b), 0, ms->mastersComm_, &mpi_req);
-            MPI_Recv(buf, n * sizeof(real), MPI_BYTE, MSRANK(ms, b), 0, ms->mastersComm_, MPI_STATUS_IGNORE);
-            MPI_Wait(&mpi_req, MPI_STATUS_IGNORE);
-        }
-#endif
-        for (i = 0; i < n; i++)
+    const ExchangedStateBlock blocks[] = {
+        { state->box, sizeof(matrix) },
+        { state->box_rel, sizeof(matrix) },
+        { state->boxv, sizeof(matrix) },
+        { &state->veta, sizeof(real) },
+        { &state->vol0, sizeof(real) },
+        { state->svir_prev, sizeof(matrix) },
+        { state->fvir_prev, sizeof(matrix) },
+        { state->pres_prev, sizeof(matrix) },
+        { state->nosehoover_xi.data(), ngtc * sizeof(double) },
+        { state->nosehoover_vxi.data(), ngtc * sizeof(double) },
+        { state->nhpres_xi.data(), nnhpres * sizeof(double) },
+        { state->nhpres_vxi.data(), nnhpres * sizeof(double) },
+        { state->therm_integral.data(), state->ngtc * sizeof(double) },
+        { &state->baros_integral, sizeof(double) },
+        { state->x.rvec_array(), state->natoms * sizeof(rvec) },
+        { state->v.rvec_array(), state->natoms * sizeof(rvec) },
+    };
+
+    /* Pack all blocks in a single buffer, so that the exchange needs only
+     * one message in each direction instead of one message per field.
+     */
+    size_t bufferSize = 0;
+    for (const ExchangedStateBlock& block : blocks)
+    {
+        if (block.data != nullptr)
         {
-            v[i] = buf[i];
+            bufferSize += block.numBytes;
         }
-        sfree(buf);
     }
-}
-
+    std::vector<char> sendBuffer(bufferSize);
+    std::vector<char> recvBuffer(bufferSize);
 
-static void exchange_doubles(const gmx_multisim_t gmx_unused* ms, int gmx_unused b, double* v, int n)
-{
-    double* buf;
-    int     i;
-
-    if (v)
+    size_t offset = 0;
+    for (const ExchangedStateBlock& block : blocks)
     {
-        snew(buf, n);
-#if GMX_MPI
-        /*
-           MPI_Sendrecv(v,  n*sizeof(double),MPI_BYTE,MSRANK(ms,b),0,
-           buf,n*sizeof(double),MPI_BYTE,MSRANK(ms,b),0,
-           ms->mastersComm_,MPI_STATUS_IGNORE);
-         */
-        {
-            MPI_Request mpi_req;
-
-            MPI_Isend(v, n * sizeof(double), MPI_BYTE, MSRANK(ms, b), 0, ms->mastersComm_, &mpi_req);
-            MPI_Recv(buf, n * sizeof(double), MPI_BYTE, MSRANK(ms, b), 0, ms->mastersComm_, MPI_STATUS_IGNORE);
-            MPI_Wait(&mpi_req, MPI_STATUS_IGNORE);
-        }
-#endif
-        for (i = 0; i < n; i++)
+        if (block.data != nullptr)
         {
-            v[i] = buf[i];
+            std::memcpy(sendBuffer.data() + offset, block.data, block.numBytes);
+            offset += block.numBytes;
         }
-        sfree(buf);
     }
-}
 
-static void exchange_rvecs(const gmx_multisim_t gmx_unused* ms, int gmx_unused b, rvec* v, int n)
-{
-    rvec* buf;
-    int   i;
-
-    if (v)
-    {
-        snew(buf, n);
 #if GMX_MPI
-        /*
-           MPI_Sendrecv(v[0],  n*sizeof(rvec),MPI_BYTE,MSRANK(ms,b),0,
-           buf[0],n*sizeof(rvec),MPI_BYTE,MSRANK(ms,b),0,
-           ms->mastersComm_,MPI_STATUS_IGNORE);
-         */
-        {
-            MPI_Request mpi_req;
+    MPI_Request mpi_req;
 
-            MPI_Isend(v[0], n * sizeof(rvec), MPI_BYTE, MSRANK(ms, b), 0, ms->mastersComm_, &mpi_req);
-            MPI_Recv(buf[0], n * sizeof(rvec), MPI_BYTE, MSRANK(ms, b), 0, ms->mastersComm_, MPI_STATUS_IGNORE);
-            MPI_Wait(&mpi_req, MPI_STATUS_IGNORE);
-        }
+    MPI_Isend(sendBuffer.data(), bufferSize, MPI_BYTE, MSRANK(ms, b), 0, ms->mastersComm_, &mpi_req);
+    MPI_Recv(recvBuffer.data(), bufferSize, MPI_BYTE, MSRANK(ms, b), 0, ms->mastersComm_, MPI_STATUS_IGNORE);
+    MPI_Wait(&mpi_req, MPI_STATUS_IGNORE);
 #endif
-        for (i = 0; i < n; i++)
+
+    offset = 0;
+    for (const ExchangedStateBlock& block : blocks)
+    {
+        if (block.data != nullptr)
         {
-            copy_rvec(buf[i], v[i]);
+            std::memcpy(block.data, recvBuffer.data() + offset, block.numBytes);
+            offset += block.numBytes;
         }
-        sfree(buf);
     }
 }
 
-static void exchange_state(const gmx_multisim_t* ms, int b, t_state* state)
-{
-    /* When t_state changes, this code should be updated. */
-    int ngtc, nnhpres;
-    ngtc    = state->ngtc * state->nhchainlength;
-    nnhpres = state->nnhpres * state->nhchainlength;
-    exchange_rvecs(ms, b, state->box, DIM);
-    exchange_rvecs(ms, b, state->box_rel, DIM);
-    exchange_rvecs(ms, b, state->boxv, DIM);
-    exchange_reals(ms, b, &(state->veta), 1);
-    exchange_reals(ms, b, &(state->vol0), 1);
-    exchange_rvecs(ms, b, state->svir_prev, DIM);
-    exchange_rvecs(ms, b, state->fvir_prev, DIM);
-    exchange_rvecs(ms, b, state->pres_prev, DIM);
-    exchange_doubles(ms, b, state->nosehoover_xi.data(), ngtc);
-    exchange_doubles(ms, b, state->nosehoover_vxi.data(), ngtc);
-    exchange_doubles(ms, b, state->nhpres_xi.data(), nnhpres);
-    exchange_doubles(ms, b, state->nhpres_vxi.data(), nnhpres);
-    exchange_doubles(ms, b, state->therm_integral.data(), state->ngtc);
-    exchange_doubles(ms, b, &state->baros_integral, 1);
-    exchange_rvecs(ms, b, state->x.rvec_array(), state->natoms);
-    exchange_rvecs(ms, b, state->v.rvec_array(), state->natoms);
-}
-
 static void copy_state_serial(const t_state* src, t_state* dest)
 {
     if (dest != src)
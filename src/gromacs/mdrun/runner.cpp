@@ -77,6 +77,7 @@
 #include "gromacs/gmxlib/network.h"
 #include "gromacs/gmxlib/nrnb.h"
 #include "gromacs/gpu_utils/device_stream_manager.h"
+#include "gromacs/gpu_utils/devicememorypool.h"
 #include "gromacs/hardware/cpuinfo.h"
 #include "gromacs/hardware/detecthardware.h"
 #include "gromacs/hardware/device_management.h"
@@ -122,6 +123,7 @@
 #include "gromacs/mdtypes/fcdata.h"
 #include "gromacs/mdtypes/forcerec.h"
 #include "gromacs/mdtypes/group.h"
+#include "gromacs/mdtypes/iforceprovider.h"
 #include "gromacs/mdtypes/inputrec.h"
 #include "gromacs/mdtypes/interaction_const.h"
 #include "gromacs/mdtypes/md_enums.h"
@@ -210,6 +212,7 @@ static DevelopmentFeatureFlags manageDevelopmentFeatures(const gmx::MDLogger& md
     devFlags.enableGpuBufferOps = (GMX_GPU_CUDA || GMX_GPU_HIP || GMX_GPU_SYCL) && useGpuForNonbonded
                                   && (getenv("GMX_USE_GPU_BUFFER_OPS") != nullptr);
     devFlags.forceGpuUpdateDefault = (getenv("GMX_FORCE_UPDATE_DEFAULT_GPU") != nullptr) || GMX_FAHCORE;
+    devFlags.enableHipGraphs       = GMX_GPU_HIP && useGpuForNonbonded && (getenv("GMX_HIP_GRAPH") != nullptr);
 
     // Direct GPU communication for both halo and PP-PME is the default with thread-MPI
     // GMX_ENABLE_DIRECT_GPU_COMM permits the same default for CUDA-aware MPI.
@@ -310,6 +313,16 @@ static DevelopmentFeatureFlags manageDevelopmentFeatures(const gmx::MDLogger& md
                         "decomposition lacks substantial testing and should be used with caution.");
     }
 
+    if (devFlags.enableHipGraphs)
+    {
+        GMX_LOG(mdlog.warning)
+                .asParagraph()
+                .appendTextFormatted(
+                        "This run uses the 'HIP graph' feature, enabled by the GMX_HIP_GRAPH "
+                        "environment variable. Regular GPU-resident steps will be captured "
+                        "into a graph and replayed until the next pair-search step.");
+    }
+
     // PME decomposition is supported only with CUDA-backend in mixed mode
     // CUDA-backend also needs CUDA-aware MPI support for decomposition to work
     const bool pmeGpuDecompositionRequested =
@@ -378,6 +391,7 @@ Mdrunner Mdrunner::cloneOnSpawnedThread() const
     // original thread. Handles to the same resources can be obtained by copy.
     {
         newRunner.restraintManager_ = std::make_unique<RestraintManager>(*restraintManager_);
+        newRunner.externalForceProviders_ = externalForceProviders_;
     }
 
     // Copy members of master runner.
@@ -600,6 +614,12 @@ static bool gpuAccelerationOfNonbondedIsUseful(const MDLogger&   mdlog,
         warning     = "TPI is not implemented for GPUs.";
     }
 
+    if (ir.vdwtype == VanDerWaalsType::User)
+    {
+        gpuIsUseful = false;
+        warning     = "User tables for VdW are not implemented for GPUs, falling back to the CPU.";
+    }
+
     if (!gpuIsUseful && issueWarning)
     {
         GMX_LOG(mdlog.warning).asParagraph().appendText(warning);
@@ -658,7 +678,9 @@ static void finish_run(FILE*                     fplog,
                        gmx_walltime_accounting_t walltime_accounting,
                        nonbonded_verlet_t*       nbv,
                        const gmx_pme_t*          pme,
-                       gmx_bool                  bWriteStat)
+                       gmx_bool                  bWriteStat,
+                       const char*               performanceReportFileName,
+                       const char*               logFileName)
 {
     double delta_t = 0;
     double nbfs = 0, mflop = 0;
@@ -737,6 +759,8 @@ static void finish_run(FILE*                     fplog,
         print_dd_statistics(cr, inputrec, fplog);
     }
 
+    wallcycle_write_trace(wcycle, logFileName);
+
     /* TODO Move the responsibility for any scaling by thread counts
      * to the code that handled the thread region, so that there's a
      * mechanism to keep cycle counting working during the transition
@@ -745,6 +769,29 @@ static void finish_run(FILE*                     fplog,
     int nthreads_pme = gmx_omp_nthreads_get(ModuleMultiThread::Pme);
     wallcycle_scale_by_num_threads(
             wcycle, thisRankHasDuty(cr, DUTY_PME) && !thisRankHasDuty(cr, DUTY_PP), nthreads_pp, nthreads_pme);
+
+    if (performanceReportFileName != nullptr)
+    {
+        /* This gathers the per-rank counters, so it needs to be called before wallcycle_sum() */
+        gmx_wallclock_gpu_pme_t pmeGpuTimings = {};
+        const bool              havePmeGpu    = printReport && pme_gpu_task_enabled(pme);
+        if (havePmeGpu)
+        {
+            pme_gpu_get_timings(pme, &pmeGpuTimings);
+        }
+        wallcycle_write_report_json(
+                performanceReportFileName,
+                printReport,
+                cr,
+                wcycle,
+                elapsed_time_over_all_ranks,
+                nthreads_pp,
+                nthreads_pme,
+                (printReport && nbv != nullptr && nbv->useGpu()) ? Nbnxm::gpu_get_timings(nbv->gpu_nbv)
+                                                                 : nullptr,
+                havePmeGpu ? &pmeGpuTimings : nullptr);
+    }
+
     auto cycle_sum(wallcycle_sum(cr, wcycle));
 
     if (printReport)
@@ -1670,6 +1717,13 @@ int Mdrunner::mdrunner()
         /* Initiate forcerecord */
         fr                 = std::make_unique<t_forcerec>();
         fr->forceProviders = mdModules_->initForceProviders();
+        for (const auto& externalForceProvider : externalForceProviders_)
+        {
+            GMX_LOG(mdlog.info)
+                    .appendTextFormatted("Registering external force provider '%s'",
+                                         externalForceProvider.first.c_str());
+            fr->forceProviders->addForceProvider(externalForceProvider.second.get());
+        }
         init_forcerec(fplog,
                       mdlog,
                       runScheduleWork.simulationWork,
@@ -2120,7 +2174,11 @@ int Mdrunner::mdrunner()
                walltime_accounting,
                fr ? fr->nbv.get() : nullptr,
                pmedata,
-               EI_DYNAMICS(inputrec->eI) && !isMultiSim(ms));
+               EI_DYNAMICS(inputrec->eI) && !isMultiSim(ms),
+               opt2bSet("-perf", filenames.size(), filenames.data())
+                       ? opt2fn("-perf", filenames.size(), filenames.data())
+                       : nullptr,
+               opt2fn("-g", filenames.size(), filenames.data()));
 
 
     deviceStreamManager.reset(nullptr);
@@ -2170,6 +2228,11 @@ int Mdrunner::mdrunner()
         physicalNodeComm.barrier();
     }
 
+    if (deviceInfo != nullptr)
+    {
+        logDeviceBufferMemoryPoolUsage(mdlog);
+    }
+
     const bool usingCudaAwareMpiFeatures = GMX_LIB_MPI && GMX_GPU_CUDA
                                            && (runScheduleWork.simulationWork.useGpuDirectCommunication
                                                || runScheduleWork.simulationWork.useGpuPmeDecomposition);
@@ -2239,6 +2302,13 @@ void Mdrunner::addPotential(std::shared_ptr<gmx::IRestraintPotential> puller, co
     restraintManager_->addToSpec(std::move(puller), name);
 }
 
+void Mdrunner::addForceProvider(std::shared_ptr<gmx::IForceProvider> forceProvider,
+                                const std::string&                   name)
+{
+    GMX_RELEASE_ASSERT(forceProvider, "Cannot add a null force provider.");
+    externalForceProviders_.emplace_back(name, std::move(forceProvider));
+}
+
 Mdrunner::Mdrunner(std::unique_ptr<MDModules> mdModules) : mdModules_(std::move(mdModules)) {}
 
 Mdrunner::Mdrunner(Mdrunner&&) noexcept = default;
@@ -46,6 +46,9 @@
 
 #include <array>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "gromacs/commandline/filenm.h"
 #include "gromacs/compat/pointers.h"
@@ -73,6 +76,7 @@ namespace gmx
 
 // Todo: move to forward declaration headers...
 class MDModules;
+class IForceProvider;      // defined in mdtypes/iforceprovider.h
 class IRestraintPotential; // defined in restraint/restraintpotential.h
 class RestraintManager;
 class SimulationContext;
@@ -170,6 +174,24 @@ public:
      */
     void addPotential(std::shared_ptr<IRestraintPotential> restraint, const std::string& name);
 
+    /*!
+     * \brief Add an external force provider to be evaluated during MD integration.
+     *
+     * \param forceProvider Force provider to register with the force record
+     * \param name User-friendly plain-text name to identify the provider in the log
+     *
+     * Unlike addPotential(), the provider is registered directly in the
+     * ForceProviders of each PP rank. It receives the home-atom coordinates
+     * and writes into the force buffer of that rank through ArrayRefs, so
+     * no per-atom data is gathered or copied on its behalf.
+     *
+     * All thread-MPI ranks of the process share the same provider object,
+     * so its calculateForces() must be safe to call concurrently.
+     * \todo Mdrunner should fetch such resources from the SimulationContext
+     * rather than offering this public interface.
+     */
+    void addForceProvider(std::shared_ptr<IForceProvider> forceProvider, const std::string& name);
+
     /*! \brief Prepare the thread-MPI communicator to have \c
      * numThreadsToLaunch ranks, by spawning new thread-MPI
      * threads.
@@ -293,6 +315,13 @@ private:
      */
     std::unique_ptr<RestraintManager> restraintManager_;
 
+    /*!
+     * \brief External force providers added through addForceProvider().
+     *
+     * Shared between all runners of the process, like the restraints.
+     */
+    std::vector<std::pair<std::string, std::shared_ptr<IForceProvider>>> externalForceProviders_;
+
     /*!
      * \brief Builder for stop signal handler
      *
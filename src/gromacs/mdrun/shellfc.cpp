@@ -97,6 +97,9 @@ struct t_shell
     rvec xold;            /* The old shell coordinates */
     rvec fold;            /* The old force on the shell */
     rvec step;            /* Step size for steepest descents */
+    rvec disp;            /* Displacement from the nuclei after the last relaxation */
+    rvec dispPrev;        /* Displacement from the nuclei one relaxation earlier */
+    int  numDisp    = 0;  /* The number of valid stored displacements, at most 2 */
 };
 
 struct gmx_shellfc_t
@@ -593,6 +596,96 @@ void gmx::make_local_shells(const t_commrec* cr, const t_mdatoms& md, gmx_shellf
     }
 }
 
+//! Returns in \p center the mass weighted center of the nuclei of \p shell
+static void nucleiCenter(const t_shell&            shell,
+                         ArrayRef<const RVec>      x,
+                         gmx::ArrayRef<const real> mass,
+                         rvec                      center)
+{
+    switch (shell.nnucl)
+    {
+        case 1: copy_rvec(x[shell.nucl1], center); break;
+        case 2:
+        {
+            const real m1 = mass[shell.nucl1];
+            const real m2 = mass[shell.nucl2];
+            for (int m = 0; m < DIM; m++)
+            {
+                center[m] = (m1 * x[shell.nucl1][m] + m2 * x[shell.nucl2][m]) / (m1 + m2);
+            }
+            break;
+        }
+        case 3:
+        {
+            const real m1 = mass[shell.nucl1];
+            const real m2 = mass[shell.nucl2];
+            const real m3 = mass[shell.nucl3];
+            for (int m = 0; m < DIM; m++)
+            {
+                center[m] = (m1 * x[shell.nucl1][m] + m2 * x[shell.nucl2][m]
+                             + m3 * x[shell.nucl3][m])
+                            / (m1 + m2 + m3);
+            }
+            break;
+        }
+        default: gmx_fatal(FARGS, "Shell %d has %d nuclei!", shell.shellIndex, shell.nnucl);
+    }
+}
+
+/*! \brief Stores the displacements of the relaxed shells with respect to their nuclei
+ *
+ * Keeps the last two displacements for extrapolating the shell positions.
+ */
+static void storeShellDisplacements(ArrayRef<t_shell>         shells,
+                                    ArrayRef<const RVec>      x,
+                                    gmx::ArrayRef<const real> mass)
+{
+    for (t_shell& shell : shells)
+    {
+        rvec center;
+        nucleiCenter(shell, x, mass, center);
+        copy_rvec(shell.disp, shell.dispPrev);
+        rvec_sub(x[shell.shellIndex], center, shell.disp);
+        shell.numDisp = std::min(shell.numDisp + 1, 2);
+    }
+}
+
+/*! \brief Places shells at their nuclei plus a linear extrapolation of their displacement
+ *
+ * The shell polarization changes smoothly along the trajectory, so
+ * extrapolating the displacement with respect to the nuclei from the previous
+ * two relaxed configurations gives a much better starting point than only
+ * translating the shells with the nuclei. Shells without two stored
+ * displacements, or with a displacement change that is too large to be
+ * physical, e.g. due to periodic boundary corrections, are left untouched.
+ */
+static void extrapolateShells(ArrayRef<RVec>            x,
+                              ArrayRef<const t_shell>   shells,
+                              gmx::ArrayRef<const real> mass)
+{
+    /* Displacement changes within one step are far below this value */
+    constexpr real c_maxDisplacementChange2 = 0.1 * 0.1;
+
+    for (const t_shell& shell : shells)
+    {
+        if (shell.numDisp < 2)
+        {
+            continue;
+        }
+        rvec change;
+        rvec_sub(shell.disp, shell.dispPrev, change);
+        if (norm2(change) < c_maxDisplacementChange2)
+        {
+            rvec center;
+            nucleiCenter(shell, x, mass, center);
+            for (int m = 0; m < DIM; m++)
+            {
+                x[shell.shellIndex][m] = center[m] + shell.disp[m] + change[m];
+            }
+        }
+    }
+}
+
 static void do_1pos(rvec xnew, const rvec xold, const rvec f, real step)
 {
     real xo, yo, zo;
@@ -1050,6 +1143,12 @@ void relax_shell_flexcon(FILE*                         fplog,
     if (shfc->predictShells && !bCont && (EI_STATE_VELOCITY(inputrec->eI) || bInit))
     {
         predict_shells(fplog, x, v, inputrec->delta_t, shells, massT, bInit);
+
+        /* Use the history of relaxed shells, when present, for a better prediction */
+        if (!bInit)
+        {
+            extrapolateShells(x, shells, massT);
+        }
     }
 
     /* Calculate the forces first time around */
@@ -1342,6 +1441,22 @@ void relax_shell_flexcon(FILE*                         fplog,
     /* Copy back the coordinates and the forces */
     std::copy(pos[Min].begin(), pos[Min].end(), x.data());
     std::copy(force[Min].begin(), force[Min].end(), f->force().begin());
+
+    if (shfc->predictShells)
+    {
+        if (bConverged)
+        {
+            storeShellDisplacements(shells, x, massT);
+        }
+        else
+        {
+            /* Do not extrapolate from unconverged shell positions */
+            for (t_shell& shell : shells)
+            {
+                shell.numDisp = 0;
+            }
+        }
+    }
 }
 
 void done_shellfc(FILE* fplog, gmx_shellfc_t* shfc, int64_t numSteps)
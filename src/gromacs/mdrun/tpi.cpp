@@ -611,6 +611,8 @@ void LegacySimulator::do_tpi()
 
         bStateChanged = TRUE;
         bNS           = TRUE;
+        /* The frame atoms are put on a new grid, so their properties need to be set */
+        bool setFrameAtomProperties = true;
 
         put_atoms_in_box(fr->pbcType, box, x);
 
@@ -692,10 +694,15 @@ void LegacySimulator::do_tpi()
                 nbnxn_put_on_grid(
                         fr->nbv.get(), box, 1, x_init, x_init, nullptr, { a_tp0, a_tp1 }, -1, fr->atomInfo, x, 0, nullptr);
 
-                /* TODO: Avoid updating all atoms at every bNS step */
-                fr->nbv->setAtomProperties(gmx::constArrayRefFromArray(mdatoms->typeA, mdatoms->nr),
-                                           gmx::constArrayRefFromArray(mdatoms->chargeA, mdatoms->nr),
-                                           fr->atomInfo);
+                /* The frame atoms on grid 0 only change once per frame, so for all
+                 * but the first search we only update the inserted molecule grid.
+                 */
+                fr->nbv->setAtomProperties(
+                        setFrameAtomProperties ? gmx::AtomLocality::All : gmx::AtomLocality::NonLocal,
+                        gmx::constArrayRefFromArray(mdatoms->typeA, mdatoms->nr),
+                        gmx::constArrayRefFromArray(mdatoms->chargeA, mdatoms->nr),
+                        fr->atomInfo);
+                setFrameAtomProperties = false;
 
                 fr->nbv->constructPairlist(InteractionLocality::Local, top->excls, step, nrnb);
 
@@ -42,7 +42,9 @@
 #ifndef GMX_MODULARSIMULATOR_CHECKPOINTDATA_H
 #define GMX_MODULARSIMULATOR_CHECKPOINTDATA_H
 
+#include <algorithm>
 #include <optional>
+#include <vector>
 
 #include "gromacs/math/vectypes.h"
 #include "gromacs/utility/arrayref.h"
@@ -127,6 +129,21 @@ struct IsSerializableType
                               || std::is_same<T, float>::value || std::is_same<T, double>::value;
 };
 
+/*! \internal
+ * \ingroup module_modularsimulator
+ * \brief Struct allowing to check if a type is stored as a packed array
+ *
+ * Arrays of these types are stored as a single std::vector value in the
+ * key-value tree, which is serialized as one bulk array. This avoids
+ * allocating a tree value per element.
+ */
+template<typename T>
+struct IsPackedArrayType
+{
+    static bool const value = std::is_same<T, int>::value || std::is_same<T, int64_t>::value
+                              || std::is_same<T, float>::value || std::is_same<T, double>::value;
+};
+
 /*! \internal
  * \ingroup module_modularsimulator
  * \brief Struct allowing to check if enum has a serializable underlying type
@@ -462,12 +479,25 @@ inline std::enable_if_t<IsSerializableType<T>::value, void>
 ReadCheckpointData::arrayRef(const std::string& key, ArrayRef<T> values) const
 {
     GMX_RELEASE_ASSERT(inputTree_, "No input checkpoint data available.");
-    GMX_RELEASE_ASSERT(values.size() >= (*inputTree_)[key].asArray().values().size(),
+    const auto& storedValue = (*inputTree_)[key];
+    if constexpr (IsPackedArrayType<T>::value)
+    {
+        if (storedValue.isType<std::vector<T>>())
+        {
+            const auto& storedValues = storedValue.cast<std::vector<T>>();
+            GMX_RELEASE_ASSERT(values.size() >= storedValues.size(),
+                               "Read vector does not fit in passed ArrayRef.");
+            std::copy(storedValues.begin(), storedValues.end(), values.begin());
+            return;
+        }
+    }
+    // Arrays written before packed arrays were introduced, and non-numeric arrays
+    GMX_RELEASE_ASSERT(values.size() >= storedValue.asArray().values().size(),
                        "Read vector does not fit in passed ArrayRef.");
     auto outputIt  = values.begin();
-    auto inputIt   = (*inputTree_)[key].asArray().values().begin();
+    auto inputIt   = storedValue.asArray().values().begin();
     auto outputEnd = values.end();
-    auto inputEnd  = (*inputTree_)[key].asArray().values().end();
+    auto inputEnd  = storedValue.asArray().values().end();
     for (; outputIt != outputEnd && inputIt != inputEnd; outputIt++, inputIt++)
     {
         *outputIt = inputIt->cast<T>();
@@ -479,21 +509,42 @@ inline std::enable_if_t<IsSerializableType<T>::value, void>
 WriteCheckpointData::arrayRef(const std::string& key, ArrayRef<const T> values)
 {
     GMX_RELEASE_ASSERT(outputTreeBuilder_, "No output checkpoint data available.");
-    auto builder = outputTreeBuilder_->addUniformArray<T>(key);
-    for (const auto& value : values)
+    if constexpr (IsPackedArrayType<T>::value)
+    {
+        outputTreeBuilder_->addValue<std::vector<T>>(key,
+                                                     std::vector<T>(values.begin(), values.end()));
+    }
+    else
     {
-        builder.addValue(value);
+        auto builder = outputTreeBuilder_->addUniformArray<T>(key);
+        for (const auto& value : values)
+        {
+            builder.addValue(value);
+        }
     }
 }
 
 inline void ReadCheckpointData::arrayRef(const std::string& key, ArrayRef<RVec> values) const
 {
-    GMX_RELEASE_ASSERT(values.size() >= (*inputTree_)[key].asArray().values().size(),
+    GMX_RELEASE_ASSERT(inputTree_, "No input checkpoint data available.");
+    const auto& storedValue = (*inputTree_)[key];
+    if (storedValue.isType<std::vector<real>>())
+    {
+        const auto& storedValues = storedValue.cast<std::vector<real>>();
+        GMX_RELEASE_ASSERT(storedValues.size() % DIM == 0,
+                           "Stored RVec array has a size that is not a multiple of DIM.");
+        GMX_RELEASE_ASSERT(values.size() >= storedValues.size() / DIM,
+                           "Read vector does not fit in passed ArrayRef.");
+        std::copy(storedValues.begin(), storedValues.end(), reinterpret_cast<real*>(values.data()));
+        return;
+    }
+    // RVec arrays written before packed arrays were introduced
+    GMX_RELEASE_ASSERT(values.size() >= storedValue.asArray().values().size(),
                        "Read vector does not fit in passed ArrayRef.");
     auto outputIt  = values.begin();
-    auto inputIt   = (*inputTree_)[key].asArray().values().begin();
+    auto inputIt   = storedValue.asArray().values().begin();
     auto outputEnd = values.end();
-    auto inputEnd  = (*inputTree_)[key].asArray().values().end();
+    auto inputEnd  = storedValue.asArray().values().end();
     for (; outputIt != outputEnd && inputIt != inputEnd; outputIt++, inputIt++)
     {
         auto storedRVec = inputIt->asObject()["RVec"].asArray().values();
@@ -503,12 +554,11 @@ inline void ReadCheckpointData::arrayRef(const std::string& key, ArrayRef<RVec>
 
 inline void WriteCheckpointData::arrayRef(const std::string& key, ArrayRef<const RVec> values)
 {
-    auto builder = outputTreeBuilder_->addObjectArray(key);
-    for (const auto& value : values)
-    {
-        auto subbuilder = builder.addObject();
-        subbuilder.addUniformArray("RVec", { value[XX], value[YY], value[ZZ] });
-    }
+    GMX_RELEASE_ASSERT(outputTreeBuilder_, "No output checkpoint data available.");
+    // RVec is stored as DIM consecutive reals
+    const real* begin = reinterpret_cast<const real*>(values.data());
+    outputTreeBuilder_->addValue<std::vector<real>>(
+            key, std::vector<real>(begin, begin + DIM * values.size()));
 }
 
 inline void ReadCheckpointData::tensor(const std::string& key, ::tensor values) const
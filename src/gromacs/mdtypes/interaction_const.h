@@ -98,6 +98,21 @@ struct EwaldCorrectionTables
     AlignedVector<real> tableFDV0;
 };
 
+/* Cubic spline table for user supplied Van der Waals interactions
+ *
+ * The table stores for each point the Y,F,G,H spline coefficients of
+ * the dispersion, followed by those of the repulsion, i.e. 8 values per
+ * point, scaled by 1/6 and 1/12, respectively, to match the 6*C6 and
+ * 12*C12 parameters used in the nonbonded kernels.
+ */
+struct VdwUserTable
+{
+    // 1/table_spacing, units 1/nm
+    real scale = 0;
+    // Dispersion and repulsion YFGH data, size of array is 8*(number of points)
+    AlignedVector<real> tableYFGH;
+};
+
 /* The physical interaction parameters for non-bonded interaction calculations
  *
  * This struct contains copies of the physical interaction parameters
@@ -180,6 +195,8 @@ struct interaction_const_t
     std::unique_ptr<EwaldCorrectionTables> coulombEwaldTables;
     // Van der Waals Ewald correction table
     std::unique_ptr<EwaldCorrectionTables> vdwEwaldTables;
+    // Van der Waals user table, only present with vdwtype=user
+    std::unique_ptr<VdwUserTable> vdwUserTable;
 
     // Free-energy parameters, only present when free-energy calculations are requested
     std::unique_ptr<SoftCoreParameters> softCoreParameters;
@@ -205,6 +205,8 @@ public:
     bool haveEwaldSurfaceContribution = false;
     //! Whether to use multiple time stepping
     bool useMts = false;
+    //! Whether the GPU work of regular MD steps is captured into and replayed from a graph
+    bool useMdGpuGraph = false;
 };
 
 class MdrunScheduleWorkload
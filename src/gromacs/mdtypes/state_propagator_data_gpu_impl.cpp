@@ -172,6 +172,15 @@ void StatePropagatorDataGpu::copyCoordinatesFromGpu(gmx::ArrayRef<gmx::RVec> /*
                "GPU implementation.");
 }
 
+void StatePropagatorDataGpu::copyCoordinateRangeFromGpu(gmx::ArrayRef<gmx::RVec> /* h_x       */,
+                                                        int /* atomStart */,
+                                                        int /* numAtoms  */)
+{
+    GMX_ASSERT(!impl_,
+               "A CPU stub method from GPU state propagator data was called instead of one from "
+               "GPU implementation.");
+}
+
 DeviceBuffer<RVec> StatePropagatorDataGpu::getVelocities()
 {
     GMX_ASSERT(!impl_,
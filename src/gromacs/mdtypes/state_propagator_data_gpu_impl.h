@@ -234,6 +234,18 @@ public:
                                 AtomLocality             atomLocality,
                                 GpuEventSynchronizer*    dependency = nullptr);
 
+    /*! \brief Copy the positions of a contiguous range of local atoms from the GPU memory.
+     *
+     *  Used on output steps where only part of the coordinates is needed on the host.
+     *  Uses the local copy stream, so the copy can be waited for with
+     *  waitCoordinatesReadyOnHost(AtomLocality::Local).
+     *
+     *  \param[in] h_x        Positions buffer in the host memory.
+     *  \param[in] atomStart  Index of the first atom to copy.
+     *  \param[in] numAtoms   Number of atoms to copy.
+     */
+    void copyCoordinateRangeFromGpu(gmx::ArrayRef<gmx::RVec> h_x, int atomStart, int numAtoms);
+
     /*! \brief Wait until coordinates are available on the host.
      *
      *  \param[in] atomLocality  Locality of the particles to wait for.
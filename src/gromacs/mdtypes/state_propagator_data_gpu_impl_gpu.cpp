@@ -445,6 +445,35 @@ void StatePropagatorDataGpu::Impl::copyCoordinatesFromGpu(gmx::ArrayRef<gmx::RVe
     wallcycle_stop(wcycle_, WallCycleCounter::LaunchGpu);
 }
 
+void StatePropagatorDataGpu::Impl::copyCoordinateRangeFromGpu(gmx::ArrayRef<gmx::RVec> h_x,
+                                                              int                      atomStart,
+                                                              int                      numAtoms)
+{
+    const DeviceStream* deviceStream = xCopyStreams_[AtomLocality::Local];
+    GMX_ASSERT(deviceStream != nullptr, "No stream is valid for copying local positions.");
+    GMX_ASSERT(atomStart >= 0 && numAtoms >= 0 && atomStart + numAtoms <= numAtomsLocal_,
+               "The copy range should be within the local atoms.");
+    GMX_ASSERT(atomStart + numAtoms <= h_x.ssize(),
+               "The host buffer is smaller than the requested copy range.");
+
+    wallcycle_start_nocount(wcycle_, WallCycleCounter::LaunchGpu);
+    wallcycle_sub_start(wcycle_, WallCycleSubCounter::LaunchStatePropagatorData);
+
+    if (numAtoms != 0)
+    {
+        copyFromDeviceBuffer(reinterpret_cast<RVec*>(&h_x.data()[atomStart]),
+                             &d_x_,
+                             atomStart,
+                             numAtoms,
+                             *deviceStream,
+                             transferKind_,
+                             nullptr);
+    }
+
+    wallcycle_sub_stop(wcycle_, WallCycleSubCounter::LaunchStatePropagatorData);
+    wallcycle_stop(wcycle_, WallCycleCounter::LaunchGpu);
+}
+
 void StatePropagatorDataGpu::Impl::waitCoordinatesReadyOnHost(AtomLocality atomLocality)
 {
     wallcycle_start(wcycle_, WallCycleCounter::WaitGpuStatePropagatorData);
@@ -716,6 +745,13 @@ void StatePropagatorDataGpu::copyCoordinatesFromGpu(gmx::ArrayRef<RVec>   h_x,
     return impl_->copyCoordinatesFromGpu(h_x, atomLocality, dependency);
 }
 
+void StatePropagatorDataGpu::copyCoordinateRangeFromGpu(gmx::ArrayRef<RVec> h_x,
+                                                        int                 atomStart,
+                                                        int                 numAtoms)
+{
+    return impl_->copyCoordinateRangeFromGpu(h_x, atomStart, numAtoms);
+}
+
 void StatePropagatorDataGpu::waitCoordinatesReadyOnHost(AtomLocality atomLocality)
 {
     return impl_->waitCoordinatesReadyOnHost(atomLocality);
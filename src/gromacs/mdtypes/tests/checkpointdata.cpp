@@ -489,5 +489,24 @@ TEST_F(CheckpointDataTest, MultiDataTest)
     }
 }
 
+TEST_F(CheckpointDataTest, RVecArrayTest)
+{
+    const std::vector<RVec> inputVectors = { { 1.5, -2.25, 3 }, { 0, GMX_REAL_MAX, GMX_REAL_MIN } };
+    writeFunctions_.emplace_back([inputVectors](WriteCheckpointData* checkpointData) {
+        checkpointData->arrayRef("rvecs", makeConstArrayRef(inputVectors));
+    });
+    testFunctions_.emplace_back([inputVectors](ReadCheckpointData* checkpointData) {
+        std::vector<RVec> outputVectors(inputVectors.size());
+        checkpointData->arrayRef("rvecs", makeArrayRef(outputVectors));
+        for (size_t i = 0; i < inputVectors.size(); ++i)
+        {
+            EXPECT_EQ(outputVectors[i][XX], inputVectors[i][XX]);
+            EXPECT_EQ(outputVectors[i][YY], inputVectors[i][YY]);
+            EXPECT_EQ(outputVectors[i][ZZ], inputVectors[i][ZZ]);
+        }
+    });
+    test();
+}
+
 } // namespace
 } // namespace gmx::test
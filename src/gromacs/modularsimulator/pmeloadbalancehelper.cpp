@@ -120,7 +120,8 @@ void PmeLoadBalanceHelper::run(gmx::Step step, gmx::Time gmx_unused time)
                    step,
                    step - inputrec_->init_step,
                    &bPMETunePrinting_,
-                   false);
+                   false,
+                   nullptr);
 }
 
 void PmeLoadBalanceHelper::teardown()
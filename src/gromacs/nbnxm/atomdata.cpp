@@ -64,6 +64,7 @@
 #include "gridset.h"
 #include "nbnxm_geometry.h"
 #include "nbnxm_gpu.h"
+#include "nbnxm_simd.h"
 #include "pairlist.h"
 
 using namespace gmx; // TODO: Remove when this file is moved into gmx namespace
@@ -90,10 +91,21 @@ void nbnxn_atomdata_t::resizeForceBuffers()
     const int paddedSize =
             (numAtoms() + NBNXN_BUFFERFLAG_SIZE - 1) / NBNXN_BUFFERFLAG_SIZE * NBNXN_BUFFERFLAG_SIZE;
 
-    /* Should we let each thread allocate it's own data instead? */
-    for (nbnxn_atomdata_output_t& outBuffer : out)
+    /* With multiple output buffers, output buffer th is only written by
+     * non-bonded thread th. So we let each thread resize, and thus first
+     * touch, its own buffer to have it allocated on the NUMA node of that
+     * thread. This requires that the threads are pinned and that the same
+     * static schedule is used as in the kernel dispatch.
+     */
+    const int gmx_unused numThreads = gmx_omp_nthreads_get(ModuleMultiThread::Nonbonded);
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (gmx::index th = 0; th < gmx::ssize(out); th++)
     {
-        outBuffer.f.resize(paddedSize * fstride);
+        try
+        {
+            out[th].f.resize(paddedSize * fstride);
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
     }
 }
 
@@ -118,6 +130,7 @@ nbnxn_atomdata_output_t::nbnxn_atomdata_output_t(Nbnxm::KernelType  kernelType,
                 numEnergyGroups * numEnergyGroups * simdEnergyBufferStride * (cj_size / 2) * cj_size;
         VSvdw.resize(numElements);
         VSc.resize(numElements);
+        simdEnergyBlockIsUsed.resize(numEnergyGroups * numEnergyGroups * simdEnergyBufferStride, false);
     }
 }
 
@@ -630,6 +643,7 @@ nbnxn_atomdata_t::nbnxn_atomdata_t(gmx::PinningPolicy      pinningPolicy,
     shift_vec({}, { pinningPolicy }),
     x_({}, { pinningPolicy }),
     simdMasks(),
+    simdJClusterPrefetchDistance(c_nbnxnSimdDefaultJClusterPrefetchDistance),
     bUseBufferFlags(FALSE)
 {
     nbnxn_atomdata_params_init(
@@ -668,6 +682,18 @@ nbnxn_atomdata_t::nbnxn_atomdata_t(gmx::PinningPolicy      pinningPolicy,
     xstride = (XFormat == nbatXYZQ ? STRIDE_XYZQ : DIM);
     fstride = (FFormat == nbatXYZQ ? STRIDE_XYZQ : DIM);
 
+    const char* prefetchDistanceString = getenv("GMX_NBNXN_PREFETCH_DISTANCE");
+    if (prefetchDistanceString != nullptr && bSIMD)
+    {
+        simdJClusterPrefetchDistance = std::max(0, std::atoi(prefetchDistanceString));
+        GMX_LOG(mdlog.info)
+                .asParagraph()
+                .appendTextFormatted(
+                        "Using a j-coordinate prefetch distance of %d list entries in the SIMD "
+                        "non-bonded kernels",
+                        simdJClusterPrefetchDistance);
+    }
+
     /* Initialize the output data structures */
     for (int i = 0; i < nout; i++)
     {
@@ -695,14 +721,42 @@ static void copy_lj_to_nbat_lj_comb(gmx::ArrayRef<const real> ljparam_type, cons
     }
 }
 
+// This is slightly different from nbnxn_get_atom_range(...) at the end of the file
+// TODO: Combine if possible
+static void getAtomRanges(const Nbnxm::GridSet&   gridSet,
+                          const gmx::AtomLocality locality,
+                          int*                    gridBegin,
+                          int*                    gridEnd)
+{
+    switch (locality)
+    {
+        case gmx::AtomLocality::All:
+            *gridBegin = 0;
+            *gridEnd   = gridSet.grids().size();
+            break;
+        case gmx::AtomLocality::Local:
+            *gridBegin = 0;
+            *gridEnd   = 1;
+            break;
+        case gmx::AtomLocality::NonLocal:
+            *gridBegin = 1;
+            *gridEnd   = gridSet.grids().size();
+            break;
+        case gmx::AtomLocality::Count:
+            GMX_ASSERT(false, "Count is invalid locality specifier");
+            break;
+    }
+}
+
 /* Sets the atom type in nbnxn_atomdata_t */
-static void nbnxn_atomdata_set_atomtypes(nbnxn_atomdata_t::Params* params,
-                                         const Nbnxm::GridSet&     gridSet,
-                                         ArrayRef<const int>       atomTypes)
+static void nbnxn_atomdata_set_atomtypes(nbnxn_atomdata_t::Params*   params,
+                                         const Nbnxm::GridSet&       gridSet,
+                                         ArrayRef<const Nbnxm::Grid> grids,
+                                         ArrayRef<const int>         atomTypes)
 {
     params->type.resize(gridSet.numGridAtomsTotal());
 
-    for (const Nbnxm::Grid& grid : gridSet.grids())
+    for (const Nbnxm::Grid& grid : grids)
     {
         /* Loop over all columns and copy and fill */
         for (int i = 0; i < grid.numColumns(); i++)
@@ -721,15 +775,16 @@ static void nbnxn_atomdata_set_atomtypes(nbnxn_atomdata_t::Params* params,
 }
 
 /* Sets the LJ combination rule parameters in nbnxn_atomdata_t */
-static void nbnxn_atomdata_set_ljcombparams(nbnxn_atomdata_t::Params* params,
-                                            const int                 XFormat,
-                                            const Nbnxm::GridSet&     gridSet)
+static void nbnxn_atomdata_set_ljcombparams(nbnxn_atomdata_t::Params*   params,
+                                            const int                   XFormat,
+                                            const Nbnxm::GridSet&       gridSet,
+                                            ArrayRef<const Nbnxm::Grid> grids)
 {
     params->lj_comb.resize(gridSet.numGridAtomsTotal() * 2);
 
     if (params->ljCombinationRule != LJCombinationRule::None)
     {
-        for (const Nbnxm::Grid& grid : gridSet.grids())
+        for (const Nbnxm::Grid& grid : grids)
         {
             /* Loop over all columns and copy and fill */
             for (int i = 0; i < grid.numColumns(); i++)
@@ -764,16 +819,17 @@ static void nbnxn_atomdata_set_ljcombparams(nbnxn_atomdata_t::Params* params,
 }
 
 /* Sets the charges in nbnxn_atomdata_t *nbat */
-static void nbnxn_atomdata_set_charges(nbnxn_atomdata_t*     nbat,
-                                       const Nbnxm::GridSet& gridSet,
-                                       ArrayRef<const real>  charges)
+static void nbnxn_atomdata_set_charges(nbnxn_atomdata_t*           nbat,
+                                       const Nbnxm::GridSet&       gridSet,
+                                       ArrayRef<const Nbnxm::Grid> grids,
+                                       ArrayRef<const real>        charges)
 {
     if (nbat->XFormat != nbatXYZQ)
     {
         nbat->paramsDeprecated().q.resize(nbat->numAtoms());
     }
 
-    for (const Nbnxm::Grid& grid : gridSet.grids())
+    for (const Nbnxm::Grid& grid : grids)
     {
         /* Loop over all columns and copy and fill */
         for (int cxy = 0; cxy < grid.numColumns(); cxy++)
@@ -822,7 +878,7 @@ static void nbnxn_atomdata_set_charges(nbnxn_atomdata_t*     nbat,
  * All perturbed interactions are calculated in the free energy kernel,
  * using the original charge and LJ data, not nbnxn_atomdata_t.
  */
-static void nbnxn_atomdata_mask_fep(nbnxn_atomdata_t* nbat, const Nbnxm::GridSet& gridSet)
+static void nbnxn_atomdata_mask_fep(nbnxn_atomdata_t* nbat, ArrayRef<const Nbnxm::Grid> grids)
 {
     nbnxn_atomdata_t::Params& params = nbat->paramsDeprecated();
 
@@ -831,7 +887,7 @@ static void nbnxn_atomdata_mask_fep(nbnxn_atomdata_t* nbat, const Nbnxm::GridSet
     real* q        = formatIsXYZQ ? (nbat->x().data() + ZZ + 1) : params.q.data();
     int   stride_q = formatIsXYZQ ? STRIDE_XYZQ : 1;
 
-    for (const Nbnxm::Grid& grid : gridSet.grids())
+    for (const Nbnxm::Grid& grid : grids)
     {
         const int nsubc = (grid.geometry().isSimple) ? 1 : c_gpuNumClusterPerCell;
 
@@ -892,9 +948,10 @@ static void copy_egp_to_nbat_egps(const int*              a,
 }
 
 /* Set the energy group indices for atoms in nbnxn_atomdata_t */
-static void nbnxn_atomdata_set_energygroups(nbnxn_atomdata_t::Params* params,
-                                            const Nbnxm::GridSet&     gridSet,
-                                            ArrayRef<const int64_t>   atomInfo)
+static void nbnxn_atomdata_set_energygroups(nbnxn_atomdata_t::Params*   params,
+                                            const Nbnxm::GridSet&       gridSet,
+                                            ArrayRef<const Nbnxm::Grid> grids,
+                                            ArrayRef<const int64_t>     atomInfo)
 {
     if (params->nenergrp == 1)
     {
@@ -903,7 +960,7 @@ static void nbnxn_atomdata_set_energygroups(nbnxn_atomdata_t::Params* params,
 
     params->energrp.resize(gridSet.numGridAtomsTotal());
 
-    for (const Nbnxm::Grid& grid : gridSet.grids())
+    for (const Nbnxm::Grid& grid : grids)
     {
         /* Loop over all columns and copy and fill */
         for (int i = 0; i < grid.numColumns(); i++)
@@ -925,25 +982,32 @@ static void nbnxn_atomdata_set_energygroups(nbnxn_atomdata_t::Params* params,
 /* Sets all required atom parameter data in nbnxn_atomdata_t */
 void nbnxn_atomdata_set(nbnxn_atomdata_t*       nbat,
                         const Nbnxm::GridSet&   gridSet,
+                        const gmx::AtomLocality locality,
                         ArrayRef<const int>     atomTypes,
                         ArrayRef<const real>    atomCharges,
                         ArrayRef<const int64_t> atomInfo)
 {
     nbnxn_atomdata_t::Params& params = nbat->paramsDeprecated();
 
-    nbnxn_atomdata_set_atomtypes(&params, gridSet, atomTypes);
+    int gridBegin = 0;
+    int gridEnd   = 0;
+    getAtomRanges(gridSet, locality, &gridBegin, &gridEnd);
+    const ArrayRef<const Nbnxm::Grid> grids =
+            gridSet.grids().subArray(gridBegin, gridEnd - gridBegin);
+
+    nbnxn_atomdata_set_atomtypes(&params, gridSet, grids, atomTypes);
 
-    nbnxn_atomdata_set_charges(nbat, gridSet, atomCharges);
+    nbnxn_atomdata_set_charges(nbat, gridSet, grids, atomCharges);
 
     if (gridSet.haveFep())
     {
-        nbnxn_atomdata_mask_fep(nbat, gridSet);
+        nbnxn_atomdata_mask_fep(nbat, grids);
     }
 
     /* This must be done after masking types for FEP */
-    nbnxn_atomdata_set_ljcombparams(&params, nbat->XFormat, gridSet);
+    nbnxn_atomdata_set_ljcombparams(&params, nbat->XFormat, gridSet, grids);
 
-    nbnxn_atomdata_set_energygroups(&params, gridSet, atomInfo);
+    nbnxn_atomdata_set_energygroups(&params, gridSet, grids, atomInfo);
 }
 
 /* Copies the shift vector array to nbnxn_atomdata_t */
@@ -953,33 +1017,6 @@ void nbnxn_atomdata_copy_shiftvec(gmx_bool bDynamicBox, gmx::ArrayRef<gmx::RVec>
     std::copy(shift_vec.begin(), shift_vec.end(), nbat->shift_vec.begin());
 }
 
-// This is slightly different from nbnxn_get_atom_range(...) at the end of the file
-// TODO: Combine if possible
-static void getAtomRanges(const Nbnxm::GridSet&   gridSet,
-                          const gmx::AtomLocality locality,
-                          int*                    gridBegin,
-                          int*                    gridEnd)
-{
-    switch (locality)
-    {
-        case gmx::AtomLocality::All:
-            *gridBegin = 0;
-            *gridEnd   = gridSet.grids().size();
-            break;
-        case gmx::AtomLocality::Local:
-            *gridBegin = 0;
-            *gridEnd   = 1;
-            break;
-        case gmx::AtomLocality::NonLocal:
-            *gridBegin = 1;
-            *gridEnd   = gridSet.grids().size();
-            break;
-        case gmx::AtomLocality::Count:
-            GMX_ASSERT(false, "Count is invalid locality specifier");
-            break;
-    }
-}
-
 /* Copies (and reorders) the coordinates to nbnxn_atomdata_t */
 void nbnxn_atomdata_copy_x_to_nbat_x(const Nbnxm::GridSet&   gridSet,
                                      const gmx::AtomLocality locality,
@@ -1050,88 +1087,6 @@ void nbnxn_atomdata_x_to_nbat_x_gpu(const Nbnxm::GridSet&   gridSet,
     }
 }
 
-static void nbnxn_atomdata_clear_reals(gmx::ArrayRef<real> dest, int i0, int i1)
-{
-    for (int i = i0; i < i1; i++)
-    {
-        dest[i] = 0;
-    }
-}
-
-gmx_unused static void nbnxn_atomdata_reduce_reals(real* gmx_restrict        dest,
-                                                   gmx_bool                  bDestSet,
-                                                   const real** gmx_restrict src,
-                                                   int                       nsrc,
-                                                   int                       i0,
-                                                   int                       i1)
-{
-    if (bDestSet)
-    {
-        /* The destination buffer contains data, add to it */
-        for (int i = i0; i < i1; i++)
-        {
-            for (int s = 0; s < nsrc; s++)
-            {
-                dest[i] += src[s][i];
-            }
-        }
-    }
-    else
-    {
-        /* The destination buffer is uninitialized, set it first */
-        for (int i = i0; i < i1; i++)
-        {
-            dest[i] = src[0][i];
-            for (int s = 1; s < nsrc; s++)
-            {
-                dest[i] += src[s][i];
-            }
-        }
-    }
-}
-
-gmx_unused static void nbnxn_atomdata_reduce_reals_simd(real gmx_unused* gmx_restrict dest,
-                                                        gmx_bool gmx_unused           bDestSet,
-                                                        const gmx_unused real** gmx_restrict src,
-                                                        int gmx_unused                       nsrc,
-                                                        int gmx_unused                       i0,
-                                                        int gmx_unused                       i1)
-{
-#if GMX_SIMD
-    /* The SIMD width here is actually independent of that in the kernels,
-     * but we use the same width for simplicity (usually optimal anyhow).
-     */
-    SimdReal dest_SSE, src_SSE;
-
-    if (bDestSet)
-    {
-        for (int i = i0; i < i1; i += GMX_SIMD_REAL_WIDTH)
-        {
-            dest_SSE = load<SimdReal>(dest + i);
-            for (int s = 0; s < nsrc; s++)
-            {
-                src_SSE  = load<SimdReal>(src[s] + i);
-                dest_SSE = dest_SSE + src_SSE;
-            }
-            store(dest + i, dest_SSE);
-        }
-    }
-    else
-    {
-        for (int i = i0; i < i1; i += GMX_SIMD_REAL_WIDTH)
-        {
-            dest_SSE = load<SimdReal>(src[0] + i);
-            for (int s = 1; s < nsrc; s++)
-            {
-                src_SSE  = load<SimdReal>(src[s] + i);
-                dest_SSE = dest_SSE + src_SSE;
-            }
-            store(dest + i, dest_SSE);
-        }
-    }
-#endif
-}
-
 /* Add part of the force array(s) from nbnxn_atomdata_t to f
  *
  * Note: Adding restrict to f makes this function 50% slower with gcc 7.3
@@ -1185,54 +1140,95 @@ static void nbnxn_atomdata_add_nbat_f_to_f_part(const Nbnxm::GridSet&          g
     }
 }
 
-static void nbnxn_atomdata_add_nbat_f_to_f_reduce(nbnxn_atomdata_t* nbat, int nth)
+/*! \brief Returns the index of the x-component of grid atom \p i in a force buffer
+ *
+ * \tparam packSize  The packing size of the nbat force format, 0 for (x,y,z) with stride \p fstride
+ */
+template<int packSize>
+static inline int nbatForceIndex(int i, int fstride)
 {
-#pragma omp parallel for num_threads(nth) schedule(static)
-    for (int th = 0; th < nth; th++)
+    if constexpr (packSize == 0)
     {
-        try
-        {
-            const real* fptr[NBNXN_BUFFERFLAG_MAX_THREADS];
+        return i * fstride;
+    }
+    else
+    {
+        GMX_UNUSED_VALUE(fstride);
+
+        return atom_to_x_index<packSize>(i);
+    }
+}
+
+/* Reduce the thread force output buffers and add them to f in one pass
+ *
+ * Each thread handles a contiguous range of buffer flag blocks and only
+ * reads the output buffers with contributions in each block. The sum is
+ * converted to rvec order directly, so the forces are streamed only once.
+ * As each grid atom belongs to a single block, the threads write to
+ * disjoint elements of f.
+ */
+template<int packSize>
+static void nbnxn_atomdata_reduce_nbat_f_to_f(const Nbnxm::GridSet&   gridSet,
+                                              const nbnxn_atomdata_t& nbat,
+                                              const int               th,
+                                              const int               nth,
+                                              rvec*                   f)
+{
+    constexpr int c_componentStride = (packSize == 0 ? 1 : packSize);
+
+    gmx::ArrayRef<const gmx_bitmask_t> flags       = nbat.buffer_flags;
+    gmx::ArrayRef<const int>           atomIndices = gridSet.atomIndices();
+    const int                          numSlots    = gmx::ssize(atomIndices);
 
-            gmx::ArrayRef<const gmx_bitmask_t> flags = nbat->buffer_flags;
+    const real* fptr[NBNXN_BUFFERFLAG_MAX_THREADS];
 
-            /* Calculate the cell-block range for our thread */
-            const int b0 = (flags.size() * th) / nth;
-            const int b1 = (flags.size() * (th + 1)) / nth;
+    /* Calculate the cell-block range for our thread */
+    const int b0 = (flags.size() * th) / nth;
+    const int b1 = (flags.size() * (th + 1)) / nth;
 
-            for (int b = b0; b < b1; b++)
+    for (int b = b0; b < b1; b++)
+    {
+        int nfptr = 0;
+        for (gmx::index out = 0; out < gmx::ssize(nbat.out); out++)
+        {
+            if (bitmask_is_set(flags[b], out))
             {
-                const int i0 = b * NBNXN_BUFFERFLAG_SIZE * nbat->fstride;
-                const int i1 = (b + 1) * NBNXN_BUFFERFLAG_SIZE * nbat->fstride;
+                fptr[nfptr++] = nbat.out[out].f.data();
+            }
+        }
+        if (nfptr == 0)
+        {
+            /* No forces on the atoms in this block */
+            continue;
+        }
 
-                int nfptr = 0;
-                for (gmx::index out = 1; out < gmx::ssize(nbat->out); out++)
-                {
-                    if (bitmask_is_set(flags[b], out))
-                    {
-                        fptr[nfptr++] = nbat->out[out].f.data();
-                    }
-                }
-                if (nfptr > 0)
-                {
-#if GMX_SIMD
-                    nbnxn_atomdata_reduce_reals_simd
-#else
-                    nbnxn_atomdata_reduce_reals
-#endif
-                            (nbat->out[0].f.data(), bitmask_is_set(flags[b], 0), fptr, nfptr, i0, i1);
-                }
-                else if (!bitmask_is_set(flags[b], 0))
-                {
-                    nbnxn_atomdata_clear_reals(nbat->out[0].f, i0, i1);
-                }
+        const int i0 = b * NBNXN_BUFFERFLAG_SIZE;
+        const int i1 = std::min((b + 1) * NBNXN_BUFFERFLAG_SIZE, numSlots);
+        for (int i = i0; i < i1; i++)
+        {
+            const int a = atomIndices[i];
+            if (a < 0)
+            {
+                /* Filler particle */
+                continue;
+            }
+
+            const int fi = nbatForceIndex<packSize>(i, nbat.fstride);
+
+            rvec sum = { fptr[0][fi + XX * c_componentStride],
+                         fptr[0][fi + YY * c_componentStride],
+                         fptr[0][fi + ZZ * c_componentStride] };
+            for (int s = 1; s < nfptr; s++)
+            {
+                sum[XX] += fptr[s][fi + XX * c_componentStride];
+                sum[YY] += fptr[s][fi + YY * c_componentStride];
+                sum[ZZ] += fptr[s][fi + ZZ * c_componentStride];
             }
+            rvec_inc(f[a], sum);
         }
-        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
     }
 }
 
-
 /* Add the force array(s) from nbnxn_atomdata_t to f */
 void reduceForces(nbnxn_atomdata_t* nbat, const gmx::AtomLocality locality, const Nbnxm::GridSet& gridSet, rvec* f)
 {
@@ -1256,11 +1252,37 @@ void reduceForces(nbnxn_atomdata_t* nbat, const gmx::AtomLocality locality, cons
             gmx_incons("add_f_to_f called with nout>1 and locality!=eatAll");
         }
 
-        /* Reduce the force thread output buffers into buffer 0, before adding
-         * them to the, differently ordered, "real" force buffer.
+        GMX_ASSERT(nbat->bUseBufferFlags, "Multiple output buffers require buffer flags");
+
+        /* Reduce the force thread output buffers directly into the,
+         * differently ordered, "real" force buffer.
          */
-        nbnxn_atomdata_add_nbat_f_to_f_reduce(nbat, nth);
+#pragma omp parallel for num_threads(nth) schedule(static)
+        for (int th = 0; th < nth; th++)
+        {
+            try
+            {
+                switch (nbat->FFormat)
+                {
+                    case nbatXYZ:
+                    case nbatXYZQ:
+                        nbnxn_atomdata_reduce_nbat_f_to_f<0>(gridSet, *nbat, th, nth, f);
+                        break;
+                    case nbatX4:
+                        nbnxn_atomdata_reduce_nbat_f_to_f<c_packX4>(gridSet, *nbat, th, nth, f);
+                        break;
+                    case nbatX8:
+                        nbnxn_atomdata_reduce_nbat_f_to_f<c_packX8>(gridSet, *nbat, th, nth, f);
+                        break;
+                    default: gmx_incons("Unsupported nbnxn_atomdata_t format");
+                }
+            }
+            GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+        }
+
+        return;
     }
+
 #pragma omp parallel for num_threads(nth) schedule(static)
     for (int th = 0; th < nth; th++)
     {
@@ -48,6 +48,8 @@
 
 #include <cstdio>
 
+#include <vector>
+
 #include "gromacs/gpu_utils/devicebuffer_datatype.h"
 #include "gromacs/gpu_utils/hostallocator.h"
 #include "gromacs/math/vectypes.h"
@@ -132,6 +134,10 @@ struct nbnxn_atomdata_output_t
     AlignedVector<real> VSvdw;
     //! Temporary SIMD Coulomb group energy storage
     AlignedVector<real> VSc;
+    //! Tells for each group-pair block in VSvdw/VSc whether the current list adds to it
+    std::vector<bool> simdEnergyBlockIsUsed;
+    //! List of the group-pair block indices in VSvdw/VSc the current list adds to
+    std::vector<int> usedSimdEnergyBlocks;
 };
 
 /*! \brief Block size in atoms for the non-bonded thread force-buffer reduction.
@@ -301,6 +307,9 @@ public:
     //! Masks for handling exclusions in the SIMD kernels
     const SimdMasks simdMasks;
 
+    //! The number of j-list entries ahead for which the SIMD kernels prefetch coordinates, 0: off
+    int simdJClusterPrefetchDistance;
+
     //! Output data structures, 1 per thread
     std::vector<nbnxn_atomdata_output_t> out;
 
@@ -327,9 +336,14 @@ enum
     enbnxninitcombruleNONE
 };
 
-//! Sets the atomdata after pair search
+/*! \brief Sets the atomdata after pair search
+ *
+ * Only the atoms on the grids of \p locality are set, so the
+ * properties of the other atoms are kept.
+ */
 void nbnxn_atomdata_set(nbnxn_atomdata_t*            nbat,
                         const Nbnxm::GridSet&        gridSet,
+                        gmx::AtomLocality            locality,
                         gmx::ArrayRef<const int>     atomTypes,
                         gmx::ArrayRef<const real>    atomCharges,
                         gmx::ArrayRef<const int64_t> atomInfo);
@@ -46,6 +46,8 @@
 #include "bench_setup.h"
 
 #include <optional>
+#include <string>
+#include <vector>
 
 #include "gromacs/gmxlib/nrnb.h"
 #include "gromacs/math/units.h"
@@ -79,6 +81,43 @@
 namespace Nbnxm
 {
 
+//! The names of the kernel SIMD types for output
+static const gmx::EnumerationArray<BenchMarkKernels, const char*> c_kernelNames = { "auto",
+                                                                                    "no",
+                                                                                    "4xM",
+                                                                                    "2xMM" };
+
+//! The names of the LJ combination rules for output
+static const gmx::EnumerationArray<BenchMarkCombRule, const char*> c_combRuleNames = { "geom.",
+                                                                                       "LB",
+                                                                                       "none" };
+
+/*! \internal \brief Timings for one benchmarked stage, accumulated over all iterations */
+struct BenchStageResult
+{
+    //! The name of the stage
+    std::string name;
+    //! The number of iterations
+    int numIterations;
+    //! The number of cycles for all iterations
+    double cycles;
+    //! The number of atom pairs in the pairlist processed, 0 when not applicable
+    double numPairs;
+    //! The number of atom pairs within the cut-off processed, 0 when not applicable
+    double numUsefulPairs;
+    //! Estimate of the number of bytes read from and written to memory, 0 when not applicable
+    double numBytes;
+};
+
+/*! \internal \brief The options and timing results of one benchmark instance */
+struct BenchInstanceResult
+{
+    //! The options the instance was run with
+    KernelBenchOptions options;
+    //! The timings for all benchmarked stages
+    std::vector<BenchStageResult> stages;
+};
+
 /*! \brief Checks the kernel setup
  *
  * Returns an error string when the kernel is not available.
@@ -102,11 +141,6 @@ static std::optional<std::string> checkKernelSetup(const KernelBenchOptions& opt
         return "the requested SIMD kernel was not set up at configuration time";
     }
 
-    if (options.reportTime && (0 > gmx_cycles_calibrate(1.0)))
-    {
-        return "the -time option is not supported on this system";
-    }
-
     return {};
 }
 
@@ -174,6 +208,61 @@ static interaction_const_t setupInteractionConst(const KernelBenchOptions& optio
     return ic;
 }
 
+//! Returns the name of the Ewald exclusion correction type, empty without Ewald
+static const char* ewaldCorrectionName(const KernelBenchOptions& options)
+{
+    if (options.coulombType == BenchMarkCoulomb::ReactionField)
+    {
+        return "";
+    }
+    return (options.nbnxmSimd == BenchMarkKernels::SimdNo || options.useTabulatedEwaldCorr)
+                   ? "table"
+                   : "analytical";
+}
+
+//! Returns the atom info for the system, depending on the half-LJ option
+static gmx::ArrayRef<const int64_t> atomInfoForBench(const KernelBenchOptions&   options,
+                                                     const gmx::BenchmarkSystem& system)
+{
+    if (options.useHalfLJOptimization)
+    {
+        return system.atomInfoOxygenVdw;
+    }
+    else
+    {
+        return system.atomInfoAllVdw;
+    }
+}
+
+//! Puts the atoms of \p system on the grid and constructs the pairlist
+static void putOnGridAndSearch(nonbonded_verlet_t*          nbv,
+                               const gmx::BenchmarkSystem&  system,
+                               gmx::ArrayRef<const int64_t> atomInfo)
+{
+    t_nrnb nrnb;
+
+    GMX_RELEASE_ASSERT(!TRICLINIC(system.box), "Only rectangular unit-cells are supported here");
+    const rvec lowerCorner = { 0, 0, 0 };
+    const rvec upperCorner = { system.box[XX][XX], system.box[YY][YY], system.box[ZZ][ZZ] };
+
+    const real atomDensity = system.coordinates.size() / det(system.box);
+
+    nbnxn_put_on_grid(nbv,
+                      system.box,
+                      0,
+                      lowerCorner,
+                      upperCorner,
+                      nullptr,
+                      { 0, int(system.coordinates.size()) },
+                      atomDensity,
+                      atomInfo,
+                      system.coordinates,
+                      0,
+                      nullptr);
+
+    nbv->constructPairlist(gmx::InteractionLocality::Local, system.excls, 0, &nrnb);
+}
+
 //! Sets up and returns a Nbnxm object for the given benchmark options and system
 static std::unique_ptr<nonbonded_verlet_t> setupNbnxmForBenchInstance(const KernelBenchOptions& options,
                                                                       const gmx::BenchmarkSystem& system)
@@ -214,40 +303,11 @@ static std::unique_ptr<nonbonded_verlet_t> setupNbnxmForBenchInstance(const Kern
     auto nbv = std::make_unique<nonbonded_verlet_t>(
             std::move(pairlistSets), std::move(pairSearch), std::move(atomData), kernelSetup, nullptr, nullptr);
 
-    t_nrnb nrnb;
-
-    GMX_RELEASE_ASSERT(!TRICLINIC(system.box), "Only rectangular unit-cells are supported here");
-    const rvec lowerCorner = { 0, 0, 0 };
-    const rvec upperCorner = { system.box[XX][XX], system.box[YY][YY], system.box[ZZ][ZZ] };
-
-    gmx::ArrayRef<const int64_t> atomInfo;
-    if (options.useHalfLJOptimization)
-    {
-        atomInfo = system.atomInfoOxygenVdw;
-    }
-    else
-    {
-        atomInfo = system.atomInfoAllVdw;
-    }
-
-    const real atomDensity = system.coordinates.size() / det(system.box);
-
-    nbnxn_put_on_grid(nbv.get(),
-                      system.box,
-                      0,
-                      lowerCorner,
-                      upperCorner,
-                      nullptr,
-                      { 0, int(system.coordinates.size()) },
-                      atomDensity,
-                      atomInfo,
-                      system.coordinates,
-                      0,
-                      nullptr);
+    const gmx::ArrayRef<const int64_t> atomInfo = atomInfoForBench(options, system);
 
-    nbv->constructPairlist(gmx::InteractionLocality::Local, system.excls, 0, &nrnb);
+    putOnGridAndSearch(nbv.get(), system, atomInfo);
 
-    nbv->setAtomProperties(system.atomTypes, system.charges, atomInfo);
+    nbv->setAtomProperties(gmx::AtomLocality::All, system.atomTypes, system.charges, atomInfo);
 
     return nbv;
 }
@@ -281,13 +341,78 @@ static void expandSimdOptionAndPushBack(const KernelBenchOptions&        options
     }
 }
 
-//! Sets up and runs the requested benchmark instance and prints the results
+//! Times the grid and pairlist search and the coordinate and force buffer operations
+static void runSearchAndBufferOpsBenchmarks(nonbonded_verlet_t*            nbv,
+                                            const gmx::BenchmarkSystem&    system,
+                                            const KernelBenchOptions&      options,
+                                            std::vector<BenchStageResult>* stages)
+{
+    const int                          numIterations = options.numIterations;
+    const gmx::ArrayRef<const int64_t> atomInfo      = atomInfoForBench(options, system);
+    const int                          numAtoms      = system.coordinates.size();
+
+    gmx_cycles_t cycles = gmx_cycles_read();
+    for (int iter = 0; iter < numIterations; iter++)
+    {
+        putOnGridAndSearch(nbv, system, atomInfo);
+    }
+    cycles = gmx_cycles_read() - cycles;
+    // The search can reorder the atoms, so we need to update the atom properties
+    nbv->setAtomProperties(gmx::AtomLocality::All, system.atomTypes, system.charges, atomInfo);
+
+    const PairlistSet& pairlistSet =
+            nbv->pairlistSets().pairlistSet(gmx::InteractionLocality::Local);
+    const double numPairs =
+            pairlistSet.natpair_ljq_ + pairlistSet.natpair_lj_ + pairlistSet.natpair_q_;
+    stages->push_back(
+            { "search", numIterations, static_cast<double>(cycles), numIterations * numPairs, 0, 0 });
+
+    const nbnxn_atomdata_t& nbat = *nbv->nbat;
+
+    // Read the coordinates and atom indices, write the nbat coordinates and charges
+    const double numBytesXBufferOps = sizeof(real) * (DIM * numAtoms + nbat.xstride * nbat.numAtoms())
+                                      + sizeof(int) * nbat.numAtoms();
+    cycles = gmx_cycles_read();
+    for (int iter = 0; iter < numIterations; iter++)
+    {
+        nbv->convertCoordinates(gmx::AtomLocality::Local, system.coordinates);
+    }
+    cycles = gmx_cycles_read() - cycles;
+    stages->push_back({ "x-buffer-ops",
+                        numIterations,
+                        static_cast<double>(cycles),
+                        0,
+                        0,
+                        numIterations * numBytesXBufferOps });
+
+    // Read all (thread) force buffers and atom indices, read and write the forces
+    std::vector<gmx::RVec> forces(numAtoms, { 0.0_real, 0.0_real, 0.0_real });
+    const double           numBytesFBufferOps =
+            sizeof(real) * (nbat.out.size() * nbat.fstride * nbat.numAtoms() + 2 * DIM * numAtoms)
+            + sizeof(int) * nbat.numAtoms();
+    cycles = gmx_cycles_read();
+    for (int iter = 0; iter < numIterations; iter++)
+    {
+        nbv->atomdata_add_nbat_f_to_f(gmx::AtomLocality::Local, forces);
+    }
+    cycles = gmx_cycles_read() - cycles;
+    stages->push_back({ "f-buffer-ops",
+                        numIterations,
+                        static_cast<double>(cycles),
+                        0,
+                        0,
+                        numIterations * numBytesFBufferOps });
+}
+
+//! Sets up and runs the requested benchmark instance, prints and returns the results
 //
 // When \p doWarmup is true runs the warmup iterations instead
-// of the normal ones and does not print any results
-static void setupAndRunInstance(const gmx::BenchmarkSystem& system,
-                                const KernelBenchOptions&   options,
-                                const bool                  doWarmup)
+// of the normal ones and does not print any results.
+// Times are only reported when \p secondsPerCycle > 0.
+static BenchInstanceResult setupAndRunInstance(const gmx::BenchmarkSystem& system,
+                                               const KernelBenchOptions&   options,
+                                               const bool                  doWarmup,
+                                               const double                secondsPerCycle)
 {
     // Generate an, accurate, estimate of the number of non-zero pair interactions
     const real atomDensity = system.coordinates.size() / det(system.box);
@@ -312,22 +437,14 @@ static void setupAndRunInstance(const gmx::BenchmarkSystem& system,
         stepWork.computeEnergy = true;
     }
 
-    const gmx::EnumerationArray<BenchMarkKernels, std::string> kernelNames = {
-        "auto", "no", "4xM", "2xMM"
-    };
-
-    const gmx::EnumerationArray<BenchMarkCombRule, std::string> combruleNames = { "geom.",
-                                                                                  "LB",
-                                                                                  "none" };
-
     if (!doWarmup)
     {
         fprintf(stdout,
                 "%-7s %-4s %-5s %-4s ",
                 options.coulombType == BenchMarkCoulomb::Pme ? "Ewald" : "RF",
                 options.useHalfLJOptimization ? "half" : "all",
-                combruleNames[options.ljCombinationRule].c_str(),
-                kernelNames[options.nbnxmSimd].c_str());
+                c_combRuleNames[options.ljCombinationRule],
+                c_kernelNames[options.nbnxmSimd]);
         if (!options.outputFile.empty())
         {
             fprintf(system.csv,
@@ -343,15 +460,11 @@ static void setupAndRunInstance(const gmx::BenchmarkSystem& system,
                     options.numThreads,
                     options.numIterations,
                     options.computeVirialAndEnergy ? "yes" : "no",
-                    (options.coulombType != BenchMarkCoulomb::ReactionField)
-                            ? ((options.nbnxmSimd == BenchMarkKernels::SimdNo || options.useTabulatedEwaldCorr)
-                                       ? "table"
-                                       : "analytical")
-                            : "",
+                    ewaldCorrectionName(options),
                     options.coulombType == BenchMarkCoulomb::Pme ? "Ewald" : "RF",
                     options.useHalfLJOptimization ? "half" : "all",
-                    combruleNames[options.ljCombinationRule].c_str(),
-                    kernelNames[options.nbnxmSimd].c_str());
+                    c_combRuleNames[options.ljCombinationRule],
+                    c_kernelNames[options.nbnxmSimd]);
         }
     }
 
@@ -391,9 +504,9 @@ static void setupAndRunInstance(const gmx::BenchmarkSystem& system,
     cycles = gmx_cycles_read() - cycles;
     if (!doWarmup)
     {
-        if (options.reportTime)
+        if (options.reportTime && secondsPerCycle > 0)
         {
-            const double uSec = static_cast<double>(cycles) * gmx_cycles_calibrate(1.0) * 1.e6;
+            const double uSec = static_cast<double>(cycles) * secondsPerCycle * 1.e6;
             if (options.cyclesPerPair)
             {
                 fprintf(stdout,
@@ -454,6 +567,145 @@ static void setupAndRunInstance(const gmx::BenchmarkSystem& system,
             }
         }
     }
+
+    BenchInstanceResult result;
+    result.options = options;
+    result.stages.push_back({ "kernel",
+                              numIterations,
+                              static_cast<double>(cycles),
+                              static_cast<double>(numIterations) * numPairs,
+                              numIterations * numUsefulPairs,
+                              0 });
+
+    if (options.benchmarkSearchAndBufferOps && !doWarmup)
+    {
+        runSearchAndBufferOpsBenchmarks(nbv.get(), system, options, &result.stages);
+    }
+
+    return result;
+}
+
+//! Prints the timings of the search and buffer operation stages of all instances to stdout
+static void printSearchAndBufferOpsResults(gmx::ArrayRef<const BenchInstanceResult> results,
+                                           const bool                               reportTime,
+                                           const double                             secondsPerCycle)
+{
+    // With time reporting, which requires secondsPerCycle > 0, we report per micro second,
+    // otherwise per cycle
+    const double unitsPerCycle = (reportTime ? secondsPerCycle * 1e6 : 1.0);
+
+    fprintf(stdout, "\n");
+    fprintf(stdout,
+            "Coulomb LJ   comb. SIMD stage          %s pairs/%s bytes/%s\n",
+            reportTime ? "   usec/it." : "Mcycles/it.",
+            reportTime ? "usec " : "cycle",
+            reportTime ? "usec " : "cycle");
+    for (const auto& result : results)
+    {
+        const KernelBenchOptions& options = result.options;
+        for (const auto& stage : result.stages)
+        {
+            if (stage.name == "kernel")
+            {
+                continue;
+            }
+            const double units = stage.cycles * unitsPerCycle;
+            fprintf(stdout,
+                    "%-7s %-4s %-5s %-4s %-12s %13.4f %11.3f %11.3f\n",
+                    options.coulombType == BenchMarkCoulomb::Pme ? "Ewald" : "RF",
+                    options.useHalfLJOptimization ? "half" : "all",
+                    c_combRuleNames[options.ljCombinationRule],
+                    c_kernelNames[options.nbnxmSimd],
+                    stage.name.c_str(),
+                    units / stage.numIterations * (reportTime ? 1.0 : 1e-6),
+                    stage.numPairs / units,
+                    stage.numBytes / units);
+        }
+    }
+}
+
+/*! \brief Writes the settings and timings of all instances to a JSON file
+ *
+ * Rates per second are only written when the cycle counter could be
+ * calibrated, i.e. when \p secondsPerCycle > 0.
+ */
+static void writeJsonResults(const std::string&                       fileName,
+                             const gmx::BenchmarkSystem&              system,
+                             const KernelBenchOptions&                options,
+                             gmx::ArrayRef<const BenchInstanceResult> results,
+                             const double                             secondsPerCycle)
+{
+    FILE* fp = fopen(fileName.c_str(), "w");
+    if (fp == nullptr)
+    {
+        gmx_fatal(FARGS, "Could not open JSON output file '%s'", fileName.c_str());
+    }
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"atoms\": %zu,\n", system.coordinates.size());
+    fprintf(fp, "  \"cutoff\": %g,\n", options.pairlistCutoff);
+    fprintf(fp, "  \"threads\": %d,\n", options.numThreads);
+    fprintf(fp, "  \"iterations\": %d,\n", options.numIterations);
+    fprintf(fp, "  \"computeEnergies\": %s,\n", options.computeVirialAndEnergy ? "true" : "false");
+    fprintf(fp, "  \"benchmarks\": [\n");
+    for (gmx::index i = 0; i < results.ssize(); i++)
+    {
+        const KernelBenchOptions& instanceOptions = results[i].options;
+#if GMX_SIMD
+        const int simdWidth =
+                (instanceOptions.nbnxmSimd != BenchMarkKernels::SimdNo) ? GMX_SIMD_REAL_WIDTH : 0;
+#else
+        const int simdWidth = 0;
+#endif
+        fprintf(fp, "    {\n");
+        fprintf(fp,
+                "      \"coulomb\": \"%s\",\n",
+                instanceOptions.coulombType == BenchMarkCoulomb::Pme ? "Ewald" : "RF");
+        fprintf(fp, "      \"ewaldCorrection\": \"%s\",\n", ewaldCorrectionName(instanceOptions));
+        fprintf(fp,
+                "      \"lj\": \"%s\",\n",
+                instanceOptions.useHalfLJOptimization ? "half" : "all");
+        fprintf(fp,
+                "      \"combRule\": \"%s\",\n",
+                c_combRuleNames[instanceOptions.ljCombinationRule]);
+        fprintf(fp, "      \"simd\": \"%s\",\n", c_kernelNames[instanceOptions.nbnxmSimd]);
+        fprintf(fp, "      \"simdWidth\": %d,\n", simdWidth);
+        fprintf(fp, "      \"stages\": [\n");
+        const auto& stages = results[i].stages;
+        for (size_t s = 0; s < stages.size(); s++)
+        {
+            const BenchStageResult& stage = stages[s];
+            fprintf(fp,
+                    "        { \"name\": \"%s\", \"iterations\": %d, \"cycles\": %.0f",
+                    stage.name.c_str(),
+                    stage.numIterations,
+                    stage.cycles);
+            if (secondsPerCycle > 0)
+            {
+                const double seconds = stage.cycles * secondsPerCycle;
+                fprintf(fp, ", \"seconds\": %.6g", seconds);
+                if (stage.numPairs > 0)
+                {
+                    fprintf(fp, ", \"pairsPerSecond\": %.6g", stage.numPairs / seconds);
+                }
+                if (stage.numUsefulPairs > 0)
+                {
+                    fprintf(fp, ", \"usefulPairsPerSecond\": %.6g", stage.numUsefulPairs / seconds);
+                }
+                if (stage.numBytes > 0)
+                {
+                    fprintf(fp, ", \"bytesPerSecond\": %.6g", stage.numBytes / seconds);
+                }
+            }
+            fprintf(fp, " }%s\n", s + 1 < stages.size() ? "," : "");
+        }
+        fprintf(fp, "      ]\n");
+        fprintf(fp, "    }%s\n", i + 1 < results.ssize() ? "," : "");
+    }
+    fprintf(fp, "  ]\n");
+    fprintf(fp, "}\n");
+
+    fclose(fp);
 }
 
 void bench(const int sizeFactor, const KernelBenchOptions& options)
@@ -523,12 +775,27 @@ void bench(const int sizeFactor, const KernelBenchOptions& options)
     }
     printf("\n");
 
+    // Returns a negative value when calibration is not supported
+    const double secondsPerCycle =
+            (options.reportTime || options.benchmarkSearchAndBufferOps
+             || !options.jsonOutputFile.empty())
+                    ? gmx_cycles_calibrate(1.0)
+                    : -1;
+    // Without a calibrated cycle counter we report cycles, as pme-benchmark does
+    const bool reportTime = (options.reportTime && secondsPerCycle > 0);
+    if (options.reportTime && !reportTime)
+    {
+        fprintf(stderr,
+                "NOTE: The cycle counter can not be calibrated on this system, "
+                "reporting cycles instead of micro-seconds\n\n");
+    }
+
     if (options.numWarmupIterations > 0)
     {
-        setupAndRunInstance(system, optionsList[0], true);
+        setupAndRunInstance(system, optionsList[0], true, secondsPerCycle);
     }
 
-    if (options.reportTime)
+    if (reportTime)
     {
         fprintf(stdout,
                 "Coulomb LJ   comb. SIMD       usec         usec/it.        %s\n",
@@ -561,9 +828,19 @@ void bench(const int sizeFactor, const KernelBenchOptions& options)
         fprintf(stdout, "                                                total    useful\n");
     }
 
+    std::vector<BenchInstanceResult> results;
     for (const auto& optionsInstance : optionsList)
     {
-        setupAndRunInstance(system, optionsInstance, false);
+        results.push_back(setupAndRunInstance(system, optionsInstance, false, secondsPerCycle));
+    }
+
+    if (options.benchmarkSearchAndBufferOps)
+    {
+        printSearchAndBufferOpsResults(results, reportTime, secondsPerCycle);
+    }
+    if (!options.jsonOutputFile.empty())
+    {
+        writeJsonResults(options.jsonOutputFile, system, options, results, secondsPerCycle);
     }
 
     if (!options.outputFile.empty())
@@ -117,8 +117,12 @@ struct KernelBenchOptions
     bool cyclesPerPair = false;
     //! Report in micro seconds instead of cycles
     bool reportTime = false;
+    //! Also benchmark the grid and pairlist search and the coordinate and force buffer operations
+    bool benchmarkSearchAndBufferOps = false;
     //! Also report into a csv file
     std::string outputFile;
+    //! Also report all timings into a JSON file
+    std::string jsonOutputFile;
 };
 
 /*! \brief
@@ -127,7 +131,8 @@ struct KernelBenchOptions
  * The simulated system is a box of 1000 SPC/E water molecules scaled
  * by the factor \p sizeFactor, which has to be a power of 2.
  * One or more benchmarks are run, as specified by \p options.
- * Benchmark settings and timings are printed to stdout.
+ * Benchmark settings and timings are printed to stdout and, when requested,
+ * to csv and JSON files.
  *
  * \param[in] sizeFactor How much should the system size be increased.
  * \param[in] options How the benchmark will be run.
@@ -0,0 +1,213 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2023, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+
+/*! \internal \file
+ *
+ * \brief Implements the run-time selection between the CPU SIMD cluster layouts
+ *
+ * \ingroup module_nbnxm
+ */
+
+#include "gmxpre.h"
+
+#include "cpu_layout_tuning.h"
+
+#include <cstdlib>
+
+#include <algorithm>
+#include <limits>
+
+#include "gromacs/mdtypes/commrec.h"
+#include "gromacs/mdtypes/forcerec.h"
+#include "gromacs/mdtypes/inputrec.h"
+#include "gromacs/timing/wallcycle.h"
+#include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/logger.h"
+
+#include "nbnxm_geometry.h"
+#include "nbnxm_simd.h"
+
+namespace Nbnxm
+{
+
+//! Number of nstlist long intervals to skip at the start of the run
+static constexpr int c_numFirstIntervalsToSkip = 2;
+//! Number of nstlist long intervals to skip after switching layout, the first search allocates
+static constexpr int c_numIntervalsToSkipAfterSwitch = 1;
+//! Number of nstlist long intervals to measure with each layout
+static constexpr int c_numIntervalsToMeasure = 4;
+
+bool CpuLayoutTuning::isSupported(const KernelSetup gmx_unused& kernelSetup,
+                                  const t_commrec gmx_unused* cr,
+                                  const t_inputrec gmx_unused& ir,
+                                  bool gmx_unused              reproducible)
+{
+#if defined GMX_NBNXN_SIMD_4XN && defined GMX_NBNXN_SIMD_2XNN
+    const KernelType kernelType = kernelSetup.kernelType;
+
+    return (kernelType == KernelType::Cpu4xN_Simd_4xN || kernelType == KernelType::Cpu4xN_Simd_2xNN)
+           && !PAR(cr) && ir.nstlist > 0 && !reproducible
+           && getenv("GMX_NBNXN_SIMD_4XN") == nullptr && getenv("GMX_NBNXN_SIMD_2XNN") == nullptr
+           && getenv("GMX_NBNXN_LAYOUT_TUNING") != nullptr;
+#else
+    return false;
+#endif
+}
+
+CpuLayoutTuning::CpuLayoutTuning(const KernelSetup& kernelSetup) :
+    numIntervalsToSkip_(c_numFirstIntervalsToSkip)
+{
+    setups_[0] = kernelSetup;
+    setups_[1] = setups_[0];
+    setups_[1].kernelType = (setups_[0].kernelType == KernelType::Cpu4xN_Simd_4xN)
+                                    ? KernelType::Cpu4xN_Simd_2xNN
+                                    : KernelType::Cpu4xN_Simd_4xN;
+    cyclesPerStep_.fill(std::numeric_limits<double>::max());
+}
+
+void CpuLayoutTuning::processStepCycles(int cyclesCount, double cycles, int nstlist)
+{
+    if (!isActive_)
+    {
+        return;
+    }
+
+    /* Only use full nstlist intervals, this also skips the interval
+     * before the first call and intervals where the counters were reset.
+     */
+    const bool haveFullInterval =
+            (cyclesCountPrev_ >= 0 && cyclesCount - cyclesCountPrev_ == nstlist);
+    const double cyclesInInterval = cycles - cyclesPrev_;
+
+    cyclesCountPrev_ = cyclesCount;
+    cyclesPrev_      = cycles;
+
+    if (!haveFullInterval)
+    {
+        return;
+    }
+
+    if (numIntervalsToSkip_ > 0)
+    {
+        numIntervalsToSkip_--;
+        return;
+    }
+
+    /* Use the minimum to reduce the effect of noise from other processes */
+    cyclesPerStep_[currentSetup_] =
+            std::min(cyclesPerStep_[currentSetup_], cyclesInInterval / nstlist);
+    numIntervalsMeasured_++;
+
+    if (numIntervalsMeasured_ < c_numIntervalsToMeasure)
+    {
+        return;
+    }
+
+    if (currentSetup_ == 0)
+    {
+        currentSetup_         = 1;
+        numIntervalsToSkip_   = c_numIntervalsToSkipAfterSwitch;
+        numIntervalsMeasured_ = 0;
+        return;
+    }
+
+    currentSetup_ = (cyclesPerStep_[1] < cyclesPerStep_[0]) ? 1 : 0;
+    isActive_     = false;
+}
+
+void CpuLayoutTuning::switchLayout(const t_inputrec& ir,
+                                   t_forcerec*       fr,
+                                   const t_commrec*  cr,
+                                   const gmx_mtop_t& mtop,
+                                   matrix            box,
+                                   gmx_wallcycle*    wcycle) const
+{
+    /* Keep the, possibly tuned, pairlist radii of the current object */
+    const real rlistOuter = fr->nbv->pairlistOuterRadius();
+    const real rlistInner = fr->nbv->pairlistInnerRadius();
+
+    /* The setup has already been reported, use a silent logger */
+    fr->nbv = init_nb_verlet(gmx::MDLogger(), ir, *fr, cr, currentSetup(), mtop, box, wcycle);
+    fr->nbv->changePairlistRadii(rlistOuter, rlistInner);
+}
+
+void CpuLayoutTuning::tune(const gmx::MDLogger& mdlog,
+                           const t_inputrec&    ir,
+                           t_forcerec*          fr,
+                           const t_commrec*     cr,
+                           const gmx_mtop_t&    mtop,
+                           matrix               box,
+                           gmx_wallcycle*       wcycle)
+{
+    if (!isActive_)
+    {
+        return;
+    }
+
+    int    cyclesCount;
+    double cycles;
+    wallcycle_get(wcycle, WallCycleCounter::Step, &cyclesCount, &cycles);
+
+    processStepCycles(cyclesCount, cycles, ir.nstlist);
+
+    if (fr->nbv->kernelSetup().kernelType != currentSetup().kernelType)
+    {
+        switchLayout(ir, fr, cr, mtop, box, wcycle);
+    }
+
+    if (isActive_)
+    {
+        return;
+    }
+
+    auto layoutName = [](const KernelSetup& setup) {
+        return (setup.kernelType == KernelType::Cpu4xN_Simd_4xN) ? "4xM" : "2xMM";
+    };
+    GMX_LOG(mdlog.info)
+            .asParagraph()
+            .appendTextFormatted(
+                    "Timed the CPU nonbonded cluster layouts: %s %.3f and %s %.3f M-cycles per "
+                    "step,\n"
+                    "continuing with the %s layout using %dx%d SIMD kernels",
+                    layoutName(setups_[0]),
+                    cyclesPerStep_[0] * 1e-6,
+                    layoutName(setups_[1]),
+                    cyclesPerStep_[1] * 1e-6,
+                    layoutName(currentSetup()),
+                    IClusterSizePerKernelType[currentSetup().kernelType],
+                    JClusterSizePerKernelType[currentSetup().kernelType]);
+}
+
+} // namespace Nbnxm
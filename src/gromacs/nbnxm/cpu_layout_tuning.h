@@ -0,0 +1,164 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2023, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+
+/*! \libinternal \file
+ *
+ * \brief Declares the run-time selection between the CPU SIMD cluster layouts
+ *
+ * When both the 4xM and the 2xMM SIMD kernel layouts are compiled in,
+ * the choice made by pick_nbnxn_kernel() is based on a few simple
+ * heuristics only. The tuning implemented here measures the step time
+ * with both layouts during the first part of the run and continues
+ * with the fastest one.
+ *
+ * \inlibraryapi
+ * \ingroup module_nbnxm
+ */
+
+#ifndef NBNXM_CPU_LAYOUT_TUNING_H
+#define NBNXM_CPU_LAYOUT_TUNING_H
+
+#include <cstdint>
+
+#include <array>
+
+#include "gromacs/math/vectypes.h"
+
+#include "nbnxm.h"
+
+struct gmx_mtop_t;
+struct gmx_wallcycle;
+struct t_commrec;
+struct t_forcerec;
+struct t_inputrec;
+
+namespace gmx
+{
+class MDLogger;
+} // namespace gmx
+
+namespace Nbnxm
+{
+
+/*! \libinternal
+ * \brief Times the 4xM and 2xMM CPU layouts and switches to the fastest one
+ *
+ * The tuning should be called at every pair search step, before the step
+ * cycle counter is started. Switching layouts replaces the Nbnxm object
+ * in the force record, the new grid and pairlist are then constructed
+ * by the search at the same step. Nothing else should hold on to the
+ * Nbnxm object between steps.
+ */
+class CpuLayoutTuning
+{
+public:
+    /*! \brief Returns whether the layout can be tuned for this run
+     *
+     * This requires the user to set GMX_NBNXN_LAYOUT_TUNING, CPU SIMD
+     * non-bondeds with both layouts compiled in, a single rank,
+     * no layout chosen by the user and no request for reproducible results.
+     */
+    static bool isSupported(const KernelSetup& kernelSetup,
+                            const t_commrec*   cr,
+                            const t_inputrec&  ir,
+                            bool               reproducible);
+
+    //! Constructor, \p kernelSetup should be the setup picked at setup
+    CpuLayoutTuning(const KernelSetup& kernelSetup);
+
+    //! Returns whether the tuning is still in progress
+    bool isActive() const { return isActive_; }
+
+    //! Returns the kernel setup that should be used from now on
+    const KernelSetup& currentSetup() const { return setups_[currentSetup_]; }
+
+    /*! \brief Processes the cycles of the last nstlist steps and switches layout when needed
+     *
+     * \param[in]     mdlog   MD logger, used to report the final choice
+     * \param[in]     ir      The input parameter record
+     * \param[in,out] fr      The force record, fr->nbv is replaced on a layout switch
+     * \param[in]     cr      The communication record
+     * \param[in]     mtop    The global topology
+     * \param[in]     box     The unit cell
+     * \param[in]     wcycle  The wallcycle counters
+     */
+    void tune(const gmx::MDLogger& mdlog,
+              const t_inputrec&    ir,
+              t_forcerec*          fr,
+              const t_commrec*     cr,
+              const gmx_mtop_t&    mtop,
+              matrix               box,
+              gmx_wallcycle*       wcycle);
+
+    /*! \brief Processes the step cycle counter and updates the current setup
+     *
+     * This is the decision part of tune(), which does not replace the Nbnxm object.
+     *
+     * \param[in] cyclesCount  The cumulative count of the step cycle counter
+     * \param[in] cycles       The cumulative cycles of the step cycle counter
+     * \param[in] nstlist      The pair search interval
+     */
+    void processStepCycles(int cyclesCount, double cycles, int nstlist);
+
+private:
+    //! Replaces fr->nbv by an Nbnxm object with the current setup
+    void switchLayout(const t_inputrec& ir,
+                      t_forcerec*       fr,
+                      const t_commrec*  cr,
+                      const gmx_mtop_t& mtop,
+                      matrix            box,
+                      gmx_wallcycle*    wcycle) const;
+
+    //! The kernel setup picked at setup and the one with the other layout
+    std::array<KernelSetup, 2> setups_;
+    //! The lowest measured cycles per step for each setup
+    std::array<double, 2> cyclesPerStep_;
+    //! Index of the setup that should be in use
+    int currentSetup_ = 0;
+    //! The number of intervals left to skip before measuring
+    int numIntervalsToSkip_;
+    //! The number of intervals measured with the current setup
+    int numIntervalsMeasured_ = 0;
+    //! Whether the tuning is still in progress
+    bool isActive_ = true;
+    //! Step cycle counter cumulative count at the previous call, -1 before the first call
+    int cyclesCountPrev_ = -1;
+    //! Step cycle counter cumulative cycles at the previous call
+    double cyclesPrev_ = 0;
+};
+
+} // namespace Nbnxm
+
+#endif
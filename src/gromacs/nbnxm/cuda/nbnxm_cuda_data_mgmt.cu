@@ -123,4 +123,9 @@ DeviceBuffer<gmx::RVec> gpu_get_fshift(NbnxmGpu* nb)
     return reinterpret_cast<DeviceBuffer<gmx::RVec>>(nb->atdat->fShift);
 }
 
+std::string gpu_get_kernel_setup_description(const NbnxmGpu* /* nb */)
+{
+    return {};
+}
+
 } // namespace Nbnxm
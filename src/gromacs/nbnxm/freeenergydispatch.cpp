@@ -62,7 +62,6 @@
 #include "pairlistsets.h"
 
 FreeEnergyDispatch::FreeEnergyDispatch(const int numEnergyGroups) :
-    foreignGroupPairEnergies_(numEnergyGroups),
     threadedForceBuffer_(gmx_omp_nthreads_get(ModuleMultiThread::Nonbonded), false, numEnergyGroups),
     threadedForeignEnergyBuffer_(gmx_omp_nthreads_get(ModuleMultiThread::Nonbonded), false, numEnergyGroups)
 {
@@ -154,7 +153,7 @@ void dispatchFreeEnergyKernel(gmx::ArrayRef<const std::unique_ptr<t_nblist>>   n
                               const bool                           clearForcesAndEnergies,
                               gmx::ThreadedForceBuffer<gmx::RVec>* threadedForceBuffer,
                               gmx::ThreadedForceBuffer<gmx::RVec>* threadedForeignEnergyBuffer,
-                              gmx_grppairener_t*                   foreignGroupPairEnergies,
+                              std::vector<real>*                   foreignEnergiesAndDvdl,
                               gmx_enerdata_t*                      enerd,
                               const gmx::StepWorkload&             stepWork,
                               t_nrnb*                              nrnb)
@@ -229,42 +228,49 @@ void dispatchFreeEnergyKernel(gmx::ArrayRef<const std::unique_ptr<t_nblist>>   n
      */
     if (fepvals->n_lambda > 0 && stepWork.computeDhdl && fepvals->sc_alpha != 0)
     {
-        gmx::StepWorkload stepWorkForeignEnergies = stepWork;
-        stepWorkForeignEnergies.computeForces     = false;
-        stepWorkForeignEnergies.computeVirial     = false;
-
-        gmx::EnumerationArray<FreeEnergyPerturbationCouplingType, real> lam_i;
-        gmx::EnumerationArray<FreeEnergyPerturbationCouplingType, real> dvdl_nb = { 0 };
         const int kernelFlags = (donb_flags & ~(GMX_NONBONDED_DO_FORCE | GMX_NONBONDED_DO_SHIFTFORCE))
                                 | GMX_NONBONDED_DO_FOREIGNLAMBDA;
 
-        for (gmx::index i = 0; i < 1 + enerd->foreignLambdaTerms.numLambdas(); i++)
-        {
-            std::fill(std::begin(dvdl_nb), std::end(dvdl_nb), 0);
-            for (int j = 0; j < static_cast<int>(FreeEnergyPerturbationCouplingType::Count); j++)
-            {
-                lam_i[j] = (i == 0 ? lambda[j] : fepvals->all_lambda[j][i - 1]);
-            }
+        const int numLambdas = 1 + enerd->foreignLambdaTerms.numLambdas();
+
+        /* Each thread loops over all lambda states for its own pair list, so
+         * the list and coordinates stay in cache and we need only a single
+         * parallel region. Only the total energy and dV/dlambda are needed
+         * per lambda, which each thread stores in its own part of the buffer.
+         */
+        constexpr int c_numValuesPerLambda = 2;
+        foreignEnergiesAndDvdl->resize(nbl_fep.ssize() * numLambdas * c_numValuesPerLambda);
 
 #pragma omp parallel for schedule(static) num_threads(nbl_fep.ssize())
-            for (gmx::index th = 0; th < nbl_fep.ssize(); th++)
+        for (gmx::index th = 0; th < nbl_fep.ssize(); th++)
+        {
+            try
             {
-                try
+                // Note that here we only compute energies and dV/dlambda, but we need
+                // to pass a force buffer. No forces are compute and stored.
+                auto& threadForeignEnergyBuffer = threadedForeignEnergyBuffer->threadForceBuffer(th);
+
+                gmx::ArrayRef<real> threadVc =
+                        threadForeignEnergyBuffer.groupPairEnergies()
+                                .energyGroupPairTerms[NonBondedEnergyTerms::CoulombSR];
+                gmx::ArrayRef<real> threadVv =
+                        threadForeignEnergyBuffer.groupPairEnergies()
+                                .energyGroupPairTerms[NonBondedEnergyTerms::LJSR];
+                gmx::ArrayRef<real> threadDvdl = threadForeignEnergyBuffer.dvdl();
+
+                real* threadOutput =
+                        foreignEnergiesAndDvdl->data() + th * numLambdas * c_numValuesPerLambda;
+
+                gmx::EnumerationArray<FreeEnergyPerturbationCouplingType, real> lam_i;
+                for (int i = 0; i < numLambdas; i++)
                 {
-                    // Note that here we only compute energies and dV/dlambda, but we need
-                    // to pass a force buffer. No forces are compute and stored.
-                    auto& threadForeignEnergyBuffer = threadedForeignEnergyBuffer->threadForceBuffer(th);
+                    for (int j = 0; j < static_cast<int>(FreeEnergyPerturbationCouplingType::Count); j++)
+                    {
+                        lam_i[j] = (i == 0 ? lambda[j] : fepvals->all_lambda[j][i - 1]);
+                    }
 
                     threadForeignEnergyBuffer.clearForcesAndEnergies();
 
-                    gmx::ArrayRef<real> threadVc =
-                            threadForeignEnergyBuffer.groupPairEnergies()
-                                    .energyGroupPairTerms[NonBondedEnergyTerms::CoulombSR];
-                    gmx::ArrayRef<real> threadVv =
-                            threadForeignEnergyBuffer.groupPairEnergies()
-                                    .energyGroupPairTerms[NonBondedEnergyTerms::LJSR];
-                    gmx::ArrayRef<real> threadDvdl = threadForeignEnergyBuffer.dvdl();
-
                     gmx_nb_free_energy_kernel(*nbl_fep[th],
                                               coords,
                                               useSimd,
@@ -286,22 +292,35 @@ void dispatchFreeEnergyKernel(gmx::ArrayRef<const std::unique_ptr<t_nblist>>   n
                                               threadVc,
                                               threadVv,
                                               threadDvdl);
+
+                    real energy = 0;
+                    for (gmx::index k = 0; k < threadVc.ssize(); k++)
+                    {
+                        energy += threadVc[k] + threadVv[k];
+                    }
+                    threadOutput[i * c_numValuesPerLambda] = energy;
+                    threadOutput[i * c_numValuesPerLambda + 1] =
+                            threadDvdl[static_cast<int>(FreeEnergyPerturbationCouplingType::Vdw)]
+                            + threadDvdl[static_cast<int>(FreeEnergyPerturbationCouplingType::Coul)];
                 }
-                GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
             }
+            GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+        }
 
-            foreignGroupPairEnergies->clear();
-            threadedForeignEnergyBuffer->reduce(
-                    nullptr, nullptr, foreignGroupPairEnergies, dvdl_nb, stepWorkForeignEnergies, 0);
-
-            std::array<real, F_NRE> foreign_term = { 0 };
-            sum_epot(*foreignGroupPairEnergies, foreign_term.data());
+        // Reduce over the threads, in thread order for reproducibility
+        for (int i = 0; i < numLambdas; i++)
+        {
+            real energy = 0;
+            real dvdl   = 0;
+            for (gmx::index th = 0; th < nbl_fep.ssize(); th++)
+            {
+                const real* threadOutput =
+                        foreignEnergiesAndDvdl->data() + th * numLambdas * c_numValuesPerLambda;
+                energy += threadOutput[i * c_numValuesPerLambda];
+                dvdl += threadOutput[i * c_numValuesPerLambda + 1];
+            }
             // Accumulate the foreign energy difference and dV/dlambda into the passed enerd
-            enerd->foreignLambdaTerms.accumulate(
-                    i,
-                    foreign_term[F_EPOT],
-                    dvdl_nb[FreeEnergyPerturbationCouplingType::Vdw]
-                            + dvdl_nb[FreeEnergyPerturbationCouplingType::Coul]);
+            enerd->foreignLambdaTerms.accumulate(i, energy, dvdl);
         }
     }
 }
@@ -365,7 +384,7 @@ void FreeEnergyDispatch::dispatchFreeEnergyKernels(const PairlistSets& pairlistS
                                      clearForcesAndEnergies,
                                      &threadedForceBuffer_,
                                      &threadedForeignEnergyBuffer_,
-                                     &foreignGroupPairEnergies_,
+                                     &foreignEnergiesAndDvdl_,
                                      enerd,
                                      stepWork,
                                      nrnb);
@@ -44,6 +44,7 @@
 #define GMX_NBNXM_FREEENERGYDISPATCH_H
 
 #include <memory>
+#include <vector>
 
 #include "gromacs/math/vectypes.h"
 #include "gromacs/mdtypes/enerdata.h"
@@ -100,8 +101,8 @@ public:
                                    gmx_wallcycle*                 wcycle);
 
 private:
-    //! Temporary array for storing foreign lambda group pair energies
-    gmx_grppairener_t foreignGroupPairEnergies_;
+    //! Temporary array for storing foreign lambda energies and dVdl per thread and lambda
+    std::vector<real> foreignEnergiesAndDvdl_;
 
     //! Threaded force buffer for nonbonded FEP
     gmx::ThreadedForceBuffer<gmx::RVec> threadedForceBuffer_;
@@ -212,12 +212,17 @@ static inline void gpu_accumulate_timings(gmx_wallclock_gpu_nbnxn_t* timings,
     }
 
     /* kernel timings */
-    timings->ktime[plist->haveFreshList ? 1 : 0][didEnergyKernels ? 1 : 0].t +=
-            timers->interaction[iLocality].nb_k.getLastRangeTime();
+    const double kernelTime = timers->interaction[iLocality].nb_k.getLastRangeTime();
+    timings->ktime[plist->haveFreshList ? 1 : 0][didEnergyKernels ? 1 : 0].t += kernelTime;
 
     /* X/q H2D and F D2H timings */
-    timings->nb_h2d_t += timers->xf[atomLocality].nb_h2d.getLastRangeTime();
-    timings->nb_d2h_t += timers->xf[atomLocality].nb_d2h.getLastRangeTime();
+    const double h2dTime = timers->xf[atomLocality].nb_h2d.getLastRangeTime();
+    const double d2hTime = timers->xf[atomLocality].nb_d2h.getLastRangeTime();
+    timings->nb_h2d_t += h2dTime;
+    timings->nb_d2h_t += d2hTime;
+
+    /* Keep the time of this step, used for the DD load balancing wait estimate */
+    timings->lastStepTime[static_cast<int>(iLocality)] = kernelTime + h2dTime + d2hTime;
 
     /* Count the pruning kernel times for both cases:1st pass (at search step)
        and rolling pruning (if called at the previous step).
@@ -46,6 +46,7 @@
 #define GMX_NBNXN_GPU_DATA_MGMT_H
 
 #include <memory>
+#include <string>
 
 #include "gromacs/gpu_utils/devicebuffer_datatype.h"
 #include "gromacs/gpu_utils/gpu_macros.h"
@@ -146,6 +147,14 @@ CUDA_FUNC_QUALIFIER
 DeviceBuffer<gmx::RVec> gpu_get_fshift(NbnxmGpu gmx_unused* nb)
         CUDA_FUNC_TERM_WITH_RETURN(DeviceBuffer<gmx::RVec>{});
 
+/** Returns a description of the kernel launch setup chosen for the device, for the log;
+ *  empty when there was no choice to make.
+ *  Note: CUDA only.
+ */
+CUDA_FUNC_QUALIFIER
+std::string gpu_get_kernel_setup_description(const NbnxmGpu gmx_unused* nb)
+        CUDA_FUNC_TERM_WITH_RETURN(std::string());
+
 } // namespace Nbnxm
 
 #endif
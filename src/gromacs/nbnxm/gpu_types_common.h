@@ -131,6 +131,17 @@ struct NBAtomDataGpu
     DeviceBuffer<Float3> shiftVec;
     //! true if the shift vector has been uploaded
     bool shiftVecUploaded;
+
+#if GMX_GPU_HIP
+    /*! \brief Packed coordinates + charges, size \ref numAtoms, only used with packed j-coordinates
+     *
+     * x, y, z are stored as 16-bit (FP16 or BF16) offsets from the bounding-box center
+     * of the cluster the atom belongs to, the charge as FP32.
+     */
+    DeviceBuffer<uint3> xqPacked;
+    //! bounding-box centers of the clusters, size \ref numAtoms / cluster size, w is unused
+    DeviceBuffer<Float4> xClusterCenter;
+#endif
 };
 
 /** \internal
@@ -172,6 +183,10 @@ struct NBParamGpu
     float rlistInner_sq;
     //! True if we use dynamic pair-list pruning
     bool useDynamicPruning;
+#if GMX_GPU_HIP
+    //! True if the packed j-coordinate offsets are stored as BF16, FP16 otherwise
+    bool xqPackedUseBf16;
+#endif
 
     //! VdW shift dispersion constants
     shift_consts_t dispersion_shift;
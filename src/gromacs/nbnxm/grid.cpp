@@ -440,6 +440,29 @@ static void sort_atoms(int                            dim,
     }
 }
 
+/*! \brief Sorts particle index a on coordinates x along dim, for nearly sorted input.
+ *
+ * Produces the same order as sort_atoms(), increasing coordinates with
+ * ties ordered on index, using insertion sort. This takes time linear
+ * in n plus the number of particle pairs that are out of order.
+ */
+static void sortAtomsNearlySorted(int dim, int* a, int n, gmx::ArrayRef<const gmx::RVec> x)
+{
+    for (int i = 1; i < n; i++)
+    {
+        const int  ai = a[i];
+        const real xi = x[ai][dim];
+
+        int j = i - 1;
+        while (j >= 0 && (x[a[j]][dim] > xi || (x[a[j]][dim] == xi && a[j] > ai)))
+        {
+            a[j + 1] = a[j];
+            j--;
+        }
+        a[j + 1] = ai;
+    }
+}
+
 #if GMX_DOUBLE
 //! Returns double up to one least significant float bit smaller than x
 static double R2F_D(const float x)
@@ -1029,6 +1052,7 @@ void Grid::sortColumnsCpuGeometry(GridSetData*                   gridSetData,
                                   gmx::ArrayRef<const gmx::RVec> x,
                                   nbnxn_atomdata_t*              nbat,
                                   const gmx::Range<int>          columnRange,
+                                  const bool                     columnsAreNearlySorted,
                                   gmx::ArrayRef<int>             sort_work)
 {
     if (debug)
@@ -1052,17 +1076,24 @@ void Grid::sortColumnsCpuGeometry(GridSetData*                   gridSetData,
         const int atomOffset = firstAtomInColumn(cxy);
 
         /* Sort the atoms within each x,y column on z coordinate */
-        sort_atoms(ZZ,
-                   FALSE,
-                   dd_zone,
-                   relevantAtomsAreWithinGridBounds,
-                   gridSetData->atomIndices.data() + atomOffset,
-                   numAtoms,
-                   x,
-                   dimensions_.lowerCorner[ZZ],
-                   1.0 / dimensions_.gridSize[ZZ],
-                   numCellsZ * numAtomsPerCell,
-                   sort_work);
+        if (columnsAreNearlySorted)
+        {
+            sortAtomsNearlySorted(ZZ, gridSetData->atomIndices.data() + atomOffset, numAtoms, x);
+        }
+        else
+        {
+            sort_atoms(ZZ,
+                       FALSE,
+                       dd_zone,
+                       relevantAtomsAreWithinGridBounds,
+                       gridSetData->atomIndices.data() + atomOffset,
+                       numAtoms,
+                       x,
+                       dimensions_.lowerCorner[ZZ],
+                       1.0 / dimensions_.gridSize[ZZ],
+                       numCellsZ * numAtomsPerCell,
+                       sort_work);
+        }
 
         /* Fill the ncz cells in this column */
         const int firstCell  = firstCellInColumn(cxy);
@@ -1373,8 +1404,20 @@ void Grid::setCellIndices(int                            ddZone,
                           gmx::ArrayRef<const int64_t>   atomInfo,
                           gmx::ArrayRef<const gmx::RVec> x,
                           const int                      numAtomsMoved,
+                          const bool                     allowIncrementalBinning,
                           nbnxn_atomdata_t*              nbat)
 {
+    /* We can only bin incrementally when we have the order of the same atoms
+     * from the previous call. With the CPU geometry each column is sorted
+     * along z only and sortAtomsNearlySorted() produces the same order
+     * as sort_atoms(), so the result does not depend on the path taken.
+     */
+    const bool storeAtomOrder =
+            (allowIncrementalBinning && geometry_.isSimple && ddZone == 0 && numAtomsMoved == 0);
+    const bool binIncrementally = (storeAtomOrder && havePreviousAtomOrder_
+                                   && srcAtomBegin_ == *atomRange.begin()
+                                   && srcAtomEnd_ == *atomRange.end());
+
     cellOffset_ = cellOffset;
 
     srcAtomBegin_ = *atomRange.begin();
@@ -1461,11 +1504,25 @@ void Grid::setCellIndices(int                            ddZone,
      */
     gmx::ArrayRef<int> cells       = gridSetData->cells;
     gmx::ArrayRef<int> atomIndices = gridSetData->atomIndices;
-    for (int i : atomRange)
+    if (binIncrementally)
+    {
+        /* Fill the columns in the previous grid order. Most atoms stay
+         * in the same column and keep their order along z there.
+         */
+        for (int i : previousAtomOrder_)
+        {
+            const int cxy                                        = cells[i];
+            atomIndices[firstAtomInColumn(cxy) + cxy_na_[cxy]++] = i;
+        }
+    }
+    else
     {
-        /* At this point nbs->cell contains the local grid x,y indices */
-        const int cxy                                        = cells[i];
-        atomIndices[firstAtomInColumn(cxy) + cxy_na_[cxy]++] = i;
+        for (int i : atomRange)
+        {
+            /* At this point nbs->cell contains the local grid x,y indices */
+            const int cxy                                        = cells[i];
+            atomIndices[firstAtomInColumn(cxy) + cxy_na_[cxy]++] = i;
+        }
     }
 
     if (ddZone == 0)
@@ -1489,8 +1546,14 @@ void Grid::setCellIndices(int                            ddZone,
                                         ((thread + 1) * numColumns()) / nthread);
             if (geometry_.isSimple)
             {
-                sortColumnsCpuGeometry(
-                        gridSetData, ddZone, atomInfo, x, nbat, columnRange, gridWork[thread].sortBuffer);
+                sortColumnsCpuGeometry(gridSetData,
+                                       ddZone,
+                                       atomInfo,
+                                       x,
+                                       nbat,
+                                       columnRange,
+                                       binIncrementally,
+                                       gridWork[thread].sortBuffer);
             }
             else
             {
@@ -1506,6 +1569,20 @@ void Grid::setCellIndices(int                            ddZone,
         combine_bounding_box_pairs(*this, bb_, bbj_);
     }
 
+    /* Store the grid order as starting point for the next binning */
+    havePreviousAtomOrder_ = storeAtomOrder;
+    if (storeAtomOrder)
+    {
+        previousAtomOrder_.clear();
+        for (int i = firstAtomInColumn(0); i < atomIndexEnd(); i++)
+        {
+            if (atomIndices[i] >= 0)
+            {
+                previousAtomOrder_.push_back(atomIndices[i]);
+            }
+        }
+    }
+
     if (!geometry_.isSimple)
     {
         numClustersTotal_ = 0;
@@ -343,7 +343,13 @@ public:
                        bool               haveFep,
                        gmx::PinningPolicy pinningPolicy);
 
-    //! Sets the cell indices using indices in \p gridSetData and \p gridWork
+    /*! \brief Sets the cell indices using indices in \p gridSetData and \p gridWork
+     *
+     * When \p allowIncrementalBinning is true and the atom range is the same
+     * as at the previous call, the atoms are binned in their previous grid
+     * order, so only atoms that moved past others need to be re-sorted.
+     * The resulting order is identical to that of a full sort.
+     */
     void setCellIndices(int                            ddZone,
                         int                            cellOffset,
                         GridSetData*                   gridSetData,
@@ -352,6 +358,7 @@ public:
                         gmx::ArrayRef<const int64_t>   atomInfo,
                         gmx::ArrayRef<const gmx::RVec> x,
                         int                            numAtomsMoved,
+                        bool                           allowIncrementalBinning,
                         nbnxn_atomdata_t*              nbat);
 
     //! Determine in which grid columns atoms should go, store cells and atom counts in \p cell and \p cxy_na
@@ -379,13 +386,18 @@ private:
                   gmx::ArrayRef<const gmx::RVec> x,
                   BoundingBox gmx_unused* bb_work_aligned);
 
-    //! Spatially sort the atoms within the given column range, for CPU geometry
+    /*! \brief Spatially sort the atoms within the given column range, for CPU geometry
+     *
+     * With \p columnsAreNearlySorted the columns are filled in the previous
+     * grid order and an insertion sort is used instead of the bucket sort.
+     */
     void sortColumnsCpuGeometry(GridSetData*                   gridSetData,
                                 int                            dd_zone,
                                 gmx::ArrayRef<const int64_t>   atomInfo,
                                 gmx::ArrayRef<const gmx::RVec> x,
                                 nbnxn_atomdata_t*              nbat,
                                 gmx::Range<int>                columnRange,
+                                bool                           columnsAreNearlySorted,
                                 gmx::ArrayRef<int>             sort_work);
 
     //! Spatially sort the atoms within the given column range, for GPU geometry
@@ -415,6 +427,11 @@ private:
     //! The end of the source atom range mapped to this grid
     int srcAtomEnd_;
 
+    //! The grid order of the atoms after the last incremental-capable binning
+    std::vector<int> previousAtomOrder_;
+    //! Whether previousAtomOrder_ holds the order of the atoms in the source range
+    bool havePreviousAtomOrder_ = false;
+
     /* Grid data */
     /*! \brief The number of, non-filler, atoms for each grid column.
      *
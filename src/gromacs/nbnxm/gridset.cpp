@@ -230,8 +230,20 @@ void GridSet::putOnGrid(const matrix                   box,
     }
 
     /* Copy the already computed cell indices to the grid and sort, when needed */
-    grid.setCellIndices(
-            ddZone, cellOffset, &gridSetData_, gridWork_, atomRange, atomInfo, x, numAtomsMoved, nbat);
+    /* With domain decomposition the atoms are renumbered at every search,
+     * so the previous grid order does not help and we always sort fully.
+     */
+    const bool allowIncrementalBinning = (!domainSetup_.haveMultipleDomains && move == nullptr);
+    grid.setCellIndices(ddZone,
+                        cellOffset,
+                        &gridSetData_,
+                        gridWork_,
+                        atomRange,
+                        atomInfo,
+                        x,
+                        numAtomsMoved,
+                        allowIncrementalBinning,
+                        nbat);
 
     if (gridIndex == 0)
     {
@@ -41,12 +41,32 @@
 #ifndef GMX_NBNXN_HIP_NBNXN_HIP_H
 #define GMX_NBNXN_HIP_NBNXN_HIP_H
 
+struct NbnxmGpu;
+
 namespace Nbnxm
 {
 
 //! Set up the cache configuration for the non-bonded kernels.
 void hip_set_cacheconfig();
 
+/*! \brief Selects the launch configuration variant of the non-bonded kernels for the device.
+ *
+ * Picks the variant with the highest occupancy for the interaction types in use, unless
+ * overridden with the GMX_HIP_NB_KERNEL_VARIANT environment variable, and sets
+ * NbnxmGpu::kernelVariant and NbnxmGpu::kernelVariantDescription.
+ */
+void select_nbnxn_kernel_variant(NbnxmGpu* nb);
+
+/*! \brief Selects whether the non-bonded kernels keep the i-cluster data in registers.
+ *
+ * Keeping the i-cluster data in registers removes the shared memory use of the kernels.
+ * This is chosen when it increases the occupancy over the kernel selected otherwise,
+ * unless overridden with the GMX_HIP_NB_ICLUSTER_REGISTERS environment variable.
+ * Sets NbnxmGpu::useIClusterRegisters and extends NbnxmGpu::kernelVariantDescription.
+ * Has to be called after select_nbnxn_kernel_variant().
+ */
+void select_nbnxn_icluster_registers(NbnxmGpu* nb);
+
 } // namespace Nbnxm
 
 #endif
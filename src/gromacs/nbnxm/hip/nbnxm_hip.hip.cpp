@@ -44,6 +44,7 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "gromacs/nbnxm/nbnxm_gpu.h"
 
@@ -69,7 +70,9 @@
 #include "gromacs/nbnxm/pairlist.h"
 #include "gromacs/timing/gpu_timing.h"
 #include "gromacs/utility/cstringutil.h"
+#include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/stringutil.h"
 
 #include "nbnxm_hip_types.h"
 #include <fstream>
@@ -103,6 +106,48 @@
 #undef CALC_ENERGIES
 #undef PRUNE_NBL
 
+/*** Wave64-layout kernels, same four flavors ***/
+#define NB_WAVE64_LAYOUT
+#include "nbnxm_hip_kernels.hpp"
+#define CALC_ENERGIES
+#include "nbnxm_hip_kernels.hpp"
+#undef CALC_ENERGIES
+#define PRUNE_NBL
+#include "nbnxm_hip_kernels.hpp"
+#define CALC_ENERGIES
+#include "nbnxm_hip_kernels.hpp"
+#undef CALC_ENERGIES
+#undef PRUNE_NBL
+#undef NB_WAVE64_LAYOUT
+
+/*** Packed j-coordinate kernels, same four flavors ***/
+#define NB_PACKED_XQ
+#include "nbnxm_hip_kernels.hpp"
+#define CALC_ENERGIES
+#include "nbnxm_hip_kernels.hpp"
+#undef CALC_ENERGIES
+#define PRUNE_NBL
+#include "nbnxm_hip_kernels.hpp"
+#define CALC_ENERGIES
+#include "nbnxm_hip_kernels.hpp"
+#undef CALC_ENERGIES
+#undef PRUNE_NBL
+#undef NB_PACKED_XQ
+
+/*** Kernels keeping the i-cluster data in registers, same four flavors ***/
+#define NB_ICLUSTER_IN_REGISTERS
+#include "nbnxm_hip_kernels.hpp"
+#define CALC_ENERGIES
+#include "nbnxm_hip_kernels.hpp"
+#undef CALC_ENERGIES
+#define PRUNE_NBL
+#include "nbnxm_hip_kernels.hpp"
+#define CALC_ENERGIES
+#include "nbnxm_hip_kernels.hpp"
+#undef CALC_ENERGIES
+#undef PRUNE_NBL
+#undef NB_ICLUSTER_IN_REGISTERS
+
 /* Prune-only kernels */
 #include "nbnxm_hip_kernel_pruneonly.hpp"
 #undef FUNCTION_DECLARATION_ONLY
@@ -113,6 +158,18 @@
 #    include "nbnxm_hip_kernel_F_prune.hip.cpp"
 #    include "nbnxm_hip_kernel_VF_noprune.hip.cpp"
 #    include "nbnxm_hip_kernel_VF_prune.hip.cpp"
+#    include "nbnxm_hip_kernel_wave64_F_noprune.hip.cpp"
+#    include "nbnxm_hip_kernel_wave64_F_prune.hip.cpp"
+#    include "nbnxm_hip_kernel_wave64_VF_noprune.hip.cpp"
+#    include "nbnxm_hip_kernel_wave64_VF_prune.hip.cpp"
+#    include "nbnxm_hip_kernel_packedxq_F_noprune.hip.cpp"
+#    include "nbnxm_hip_kernel_packedxq_F_prune.hip.cpp"
+#    include "nbnxm_hip_kernel_packedxq_VF_noprune.hip.cpp"
+#    include "nbnxm_hip_kernel_packedxq_VF_prune.hip.cpp"
+#    include "nbnxm_hip_kernel_iregs_F_noprune.hip.cpp"
+#    include "nbnxm_hip_kernel_iregs_F_prune.hip.cpp"
+#    include "nbnxm_hip_kernel_iregs_VF_noprune.hip.cpp"
+#    include "nbnxm_hip_kernel_iregs_VF_prune.hip.cpp"
 #    include "nbnxm_hip_kernel_pruneonly.hip.cpp"
 #endif /* GMX_HIP_NB_SINGLE_COMPILATION_UNIT */
 
@@ -162,195 +219,347 @@ static inline int calc_nb_kernel_nblock(int nwork_units, const DeviceInformation
  *  defined in nbnxn_hip_types.h.
  */
 
+/*! \brief The kernel \p name instantiated for variant \p v of c_nbKernelVariants */
+#define NB_KFUNC(name, v) name<c_nbKernelVariants[v].threadsZ, c_nbKernelVariants[v].minBlocksDivisor>
+
+/*! \brief The table of the kernels with name suffix \p suffix for all electrostatics
+ * and VdW types, instantiated for variant \p v of c_nbKernelVariants. */
+#define NB_KFUNC_VARIANT_TABLE(suffix, v)                                   \
+    {                                                                       \
+    { NB_KFUNC(nbnxn_kernel_ElecCut_VdwLJ##suffix, v),                      \
+      NB_KFUNC(nbnxn_kernel_ElecCut_VdwLJCombGeom##suffix, v),              \
+      NB_KFUNC(nbnxn_kernel_ElecCut_VdwLJCombLB##suffix, v),                \
+      NB_KFUNC(nbnxn_kernel_ElecCut_VdwLJFsw##suffix, v),                   \
+      NB_KFUNC(nbnxn_kernel_ElecCut_VdwLJPsw##suffix, v),                   \
+      NB_KFUNC(nbnxn_kernel_ElecCut_VdwLJEwCombGeom##suffix, v),            \
+      NB_KFUNC(nbnxn_kernel_ElecCut_VdwLJEwCombLB##suffix, v) },            \
+    { NB_KFUNC(nbnxn_kernel_ElecRF_VdwLJ##suffix, v),                       \
+      NB_KFUNC(nbnxn_kernel_ElecRF_VdwLJCombGeom##suffix, v),               \
+      NB_KFUNC(nbnxn_kernel_ElecRF_VdwLJCombLB##suffix, v),                 \
+      NB_KFUNC(nbnxn_kernel_ElecRF_VdwLJFsw##suffix, v),                    \
+      NB_KFUNC(nbnxn_kernel_ElecRF_VdwLJPsw##suffix, v),                    \
+      NB_KFUNC(nbnxn_kernel_ElecRF_VdwLJEwCombGeom##suffix, v),             \
+      NB_KFUNC(nbnxn_kernel_ElecRF_VdwLJEwCombLB##suffix, v) },             \
+    { NB_KFUNC(nbnxn_kernel_ElecEwQSTab_VdwLJ##suffix, v),                  \
+      NB_KFUNC(nbnxn_kernel_ElecEwQSTab_VdwLJCombGeom##suffix, v),          \
+      NB_KFUNC(nbnxn_kernel_ElecEwQSTab_VdwLJCombLB##suffix, v),            \
+      NB_KFUNC(nbnxn_kernel_ElecEwQSTab_VdwLJFsw##suffix, v),               \
+      NB_KFUNC(nbnxn_kernel_ElecEwQSTab_VdwLJPsw##suffix, v),               \
+      NB_KFUNC(nbnxn_kernel_ElecEwQSTab_VdwLJEwCombGeom##suffix, v),        \
+      NB_KFUNC(nbnxn_kernel_ElecEwQSTab_VdwLJEwCombLB##suffix, v) },        \
+    { NB_KFUNC(nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJ##suffix, v),           \
+      NB_KFUNC(nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombGeom##suffix, v),   \
+      NB_KFUNC(nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombLB##suffix, v),     \
+      NB_KFUNC(nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJFsw##suffix, v),        \
+      NB_KFUNC(nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJPsw##suffix, v),        \
+      NB_KFUNC(nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombGeom##suffix, v), \
+      NB_KFUNC(nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombLB##suffix, v) }, \
+    { NB_KFUNC(nbnxn_kernel_ElecEw_VdwLJ##suffix, v),                       \
+      NB_KFUNC(nbnxn_kernel_ElecEw_VdwLJCombGeom##suffix, v),               \
+      NB_KFUNC(nbnxn_kernel_ElecEw_VdwLJCombLB##suffix, v),                 \
+      NB_KFUNC(nbnxn_kernel_ElecEw_VdwLJFsw##suffix, v),                    \
+      NB_KFUNC(nbnxn_kernel_ElecEw_VdwLJPsw##suffix, v),                    \
+      NB_KFUNC(nbnxn_kernel_ElecEw_VdwLJEwCombGeom##suffix, v),             \
+      NB_KFUNC(nbnxn_kernel_ElecEw_VdwLJEwCombLB##suffix, v) },             \
+    { NB_KFUNC(nbnxn_kernel_ElecEwTwinCut_VdwLJ##suffix, v),                \
+      NB_KFUNC(nbnxn_kernel_ElecEwTwinCut_VdwLJCombGeom##suffix, v),        \
+      NB_KFUNC(nbnxn_kernel_ElecEwTwinCut_VdwLJCombLB##suffix, v),          \
+      NB_KFUNC(nbnxn_kernel_ElecEwTwinCut_VdwLJFsw##suffix, v),             \
+      NB_KFUNC(nbnxn_kernel_ElecEwTwinCut_VdwLJPsw##suffix, v),             \
+      NB_KFUNC(nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombGeom##suffix, v),      \
+      NB_KFUNC(nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombLB##suffix, v) }       \
+    }
+static_assert(c_numNbKernelVariants == 3, "The kernel tables should list all variants");
+
 /*! Force-only kernel function pointers. */
-static const nbnxn_cu_kfunc_ptr_t nb_kfunc_noener_noprune_ptr[c_numElecTypes][c_numVdwTypes] = {
-    { nbnxn_kernel_ElecCut_VdwLJ_F_hip,
-      nbnxn_kernel_ElecCut_VdwLJCombGeom_F_hip,
-      nbnxn_kernel_ElecCut_VdwLJCombLB_F_hip,
-      nbnxn_kernel_ElecCut_VdwLJFsw_F_hip,
-      nbnxn_kernel_ElecCut_VdwLJPsw_F_hip,
-      nbnxn_kernel_ElecCut_VdwLJEwCombGeom_F_hip,
-      nbnxn_kernel_ElecCut_VdwLJEwCombLB_F_hip },
-    { nbnxn_kernel_ElecRF_VdwLJ_F_hip,
-      nbnxn_kernel_ElecRF_VdwLJCombGeom_F_hip,
-      nbnxn_kernel_ElecRF_VdwLJCombLB_F_hip,
-      nbnxn_kernel_ElecRF_VdwLJFsw_F_hip,
-      nbnxn_kernel_ElecRF_VdwLJPsw_F_hip,
-      nbnxn_kernel_ElecRF_VdwLJEwCombGeom_F_hip,
-      nbnxn_kernel_ElecRF_VdwLJEwCombLB_F_hip },
-    { nbnxn_kernel_ElecEwQSTab_VdwLJ_F_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJCombGeom_F_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJCombLB_F_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJFsw_F_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJPsw_F_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombGeom_F_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombLB_F_hip },
-    { nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJ_F_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombGeom_F_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombLB_F_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJFsw_F_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJPsw_F_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombGeom_F_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombLB_F_hip },
-    { nbnxn_kernel_ElecEw_VdwLJ_F_hip,
-      nbnxn_kernel_ElecEw_VdwLJCombGeom_F_hip,
-      nbnxn_kernel_ElecEw_VdwLJCombLB_F_hip,
-      nbnxn_kernel_ElecEw_VdwLJFsw_F_hip,
-      nbnxn_kernel_ElecEw_VdwLJPsw_F_hip,
-      nbnxn_kernel_ElecEw_VdwLJEwCombGeom_F_hip,
-      nbnxn_kernel_ElecEw_VdwLJEwCombLB_F_hip },
-    { nbnxn_kernel_ElecEwTwinCut_VdwLJ_F_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJCombGeom_F_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJCombLB_F_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJFsw_F_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJPsw_F_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombGeom_F_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombLB_F_hip }
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_noener_noprune_ptr[c_numNbKernelVariants][c_numElecTypes][c_numVdwTypes] = {
+    NB_KFUNC_VARIANT_TABLE(_F_hip, 0),
+    NB_KFUNC_VARIANT_TABLE(_F_hip, 1),
+    NB_KFUNC_VARIANT_TABLE(_F_hip, 2)
 };
 
 /*! Force + energy kernel function pointers. */
-static const nbnxn_cu_kfunc_ptr_t nb_kfunc_ener_noprune_ptr[c_numElecTypes][c_numVdwTypes] = {
-    { nbnxn_kernel_ElecCut_VdwLJ_VF_hip,
-      nbnxn_kernel_ElecCut_VdwLJCombGeom_VF_hip,
-      nbnxn_kernel_ElecCut_VdwLJCombLB_VF_hip,
-      nbnxn_kernel_ElecCut_VdwLJFsw_VF_hip,
-      nbnxn_kernel_ElecCut_VdwLJPsw_VF_hip,
-      nbnxn_kernel_ElecCut_VdwLJEwCombGeom_VF_hip,
-      nbnxn_kernel_ElecCut_VdwLJEwCombLB_VF_hip },
-    { nbnxn_kernel_ElecRF_VdwLJ_VF_hip,
-      nbnxn_kernel_ElecRF_VdwLJCombGeom_VF_hip,
-      nbnxn_kernel_ElecRF_VdwLJCombLB_VF_hip,
-      nbnxn_kernel_ElecRF_VdwLJFsw_VF_hip,
-      nbnxn_kernel_ElecRF_VdwLJPsw_VF_hip,
-      nbnxn_kernel_ElecRF_VdwLJEwCombGeom_VF_hip,
-      nbnxn_kernel_ElecRF_VdwLJEwCombLB_VF_hip },
-    { nbnxn_kernel_ElecEwQSTab_VdwLJ_VF_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJCombGeom_VF_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJCombLB_VF_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJFsw_VF_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJPsw_VF_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombGeom_VF_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombLB_VF_hip },
-    { nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJ_VF_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombGeom_VF_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombLB_VF_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJFsw_VF_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJPsw_VF_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombGeom_VF_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombLB_VF_hip },
-    { nbnxn_kernel_ElecEw_VdwLJ_VF_hip,
-      nbnxn_kernel_ElecEw_VdwLJCombGeom_VF_hip,
-      nbnxn_kernel_ElecEw_VdwLJCombLB_VF_hip,
-      nbnxn_kernel_ElecEw_VdwLJFsw_VF_hip,
-      nbnxn_kernel_ElecEw_VdwLJPsw_VF_hip,
-      nbnxn_kernel_ElecEw_VdwLJEwCombGeom_VF_hip,
-      nbnxn_kernel_ElecEw_VdwLJEwCombLB_VF_hip },
-    { nbnxn_kernel_ElecEwTwinCut_VdwLJ_VF_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJCombGeom_VF_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJCombLB_VF_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJFsw_VF_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJPsw_VF_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombGeom_VF_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombLB_VF_hip }
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_ener_noprune_ptr[c_numNbKernelVariants][c_numElecTypes][c_numVdwTypes] = {
+    NB_KFUNC_VARIANT_TABLE(_VF_hip, 0),
+    NB_KFUNC_VARIANT_TABLE(_VF_hip, 1),
+    NB_KFUNC_VARIANT_TABLE(_VF_hip, 2)
 };
 
 /*! Force + pruning kernel function pointers. */
-static const nbnxn_cu_kfunc_ptr_t nb_kfunc_noener_prune_ptr[c_numElecTypes][c_numVdwTypes] = {
-    { nbnxn_kernel_ElecCut_VdwLJ_F_prune_hip,
-      nbnxn_kernel_ElecCut_VdwLJCombGeom_F_prune_hip,
-      nbnxn_kernel_ElecCut_VdwLJCombLB_F_prune_hip,
-      nbnxn_kernel_ElecCut_VdwLJFsw_F_prune_hip,
-      nbnxn_kernel_ElecCut_VdwLJPsw_F_prune_hip,
-      nbnxn_kernel_ElecCut_VdwLJEwCombGeom_F_prune_hip,
-      nbnxn_kernel_ElecCut_VdwLJEwCombLB_F_prune_hip },
-    { nbnxn_kernel_ElecRF_VdwLJ_F_prune_hip,
-      nbnxn_kernel_ElecRF_VdwLJCombGeom_F_prune_hip,
-      nbnxn_kernel_ElecRF_VdwLJCombLB_F_prune_hip,
-      nbnxn_kernel_ElecRF_VdwLJFsw_F_prune_hip,
-      nbnxn_kernel_ElecRF_VdwLJPsw_F_prune_hip,
-      nbnxn_kernel_ElecRF_VdwLJEwCombGeom_F_prune_hip,
-      nbnxn_kernel_ElecRF_VdwLJEwCombLB_F_prune_hip },
-    { nbnxn_kernel_ElecEwQSTab_VdwLJ_F_prune_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJCombGeom_F_prune_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJCombLB_F_prune_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJFsw_F_prune_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJPsw_F_prune_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombGeom_F_prune_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombLB_F_prune_hip },
-    { nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJ_F_prune_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombGeom_F_prune_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombLB_F_prune_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJFsw_F_prune_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJPsw_F_prune_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombGeom_F_prune_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombLB_F_prune_hip },
-    { nbnxn_kernel_ElecEw_VdwLJ_F_prune_hip,
-      nbnxn_kernel_ElecEw_VdwLJCombGeom_F_prune_hip,
-      nbnxn_kernel_ElecEw_VdwLJCombLB_F_prune_hip,
-      nbnxn_kernel_ElecEw_VdwLJFsw_F_prune_hip,
-      nbnxn_kernel_ElecEw_VdwLJPsw_F_prune_hip,
-      nbnxn_kernel_ElecEw_VdwLJEwCombGeom_F_prune_hip,
-      nbnxn_kernel_ElecEw_VdwLJEwCombLB_F_prune_hip },
-    { nbnxn_kernel_ElecEwTwinCut_VdwLJ_F_prune_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJCombGeom_F_prune_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJCombLB_F_prune_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJFsw_F_prune_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJPsw_F_prune_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombGeom_F_prune_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombLB_F_prune_hip }
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_noener_prune_ptr[c_numNbKernelVariants][c_numElecTypes][c_numVdwTypes] = {
+    NB_KFUNC_VARIANT_TABLE(_F_prune_hip, 0),
+    NB_KFUNC_VARIANT_TABLE(_F_prune_hip, 1),
+    NB_KFUNC_VARIANT_TABLE(_F_prune_hip, 2)
 };
 
 /*! Force + energy + pruning kernel function pointers. */
-static const nbnxn_cu_kfunc_ptr_t nb_kfunc_ener_prune_ptr[c_numElecTypes][c_numVdwTypes] = {
-    { nbnxn_kernel_ElecCut_VdwLJ_VF_prune_hip,
-      nbnxn_kernel_ElecCut_VdwLJCombGeom_VF_prune_hip,
-      nbnxn_kernel_ElecCut_VdwLJCombLB_VF_prune_hip,
-      nbnxn_kernel_ElecCut_VdwLJFsw_VF_prune_hip,
-      nbnxn_kernel_ElecCut_VdwLJPsw_VF_prune_hip,
-      nbnxn_kernel_ElecCut_VdwLJEwCombGeom_VF_prune_hip,
-      nbnxn_kernel_ElecCut_VdwLJEwCombLB_VF_prune_hip },
-    { nbnxn_kernel_ElecRF_VdwLJ_VF_prune_hip,
-      nbnxn_kernel_ElecRF_VdwLJCombGeom_VF_prune_hip,
-      nbnxn_kernel_ElecRF_VdwLJCombLB_VF_prune_hip,
-      nbnxn_kernel_ElecRF_VdwLJFsw_VF_prune_hip,
-      nbnxn_kernel_ElecRF_VdwLJPsw_VF_prune_hip,
-      nbnxn_kernel_ElecRF_VdwLJEwCombGeom_VF_prune_hip,
-      nbnxn_kernel_ElecRF_VdwLJEwCombLB_VF_prune_hip },
-    { nbnxn_kernel_ElecEwQSTab_VdwLJ_VF_prune_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJCombGeom_VF_prune_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJCombLB_VF_prune_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJFsw_VF_prune_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJPsw_VF_prune_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombGeom_VF_prune_hip,
-      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombLB_VF_prune_hip },
-    { nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJ_VF_prune_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombGeom_VF_prune_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombLB_VF_prune_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJFsw_VF_prune_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJPsw_VF_prune_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombGeom_VF_prune_hip,
-      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombLB_VF_prune_hip },
-    { nbnxn_kernel_ElecEw_VdwLJ_VF_prune_hip,
-      nbnxn_kernel_ElecEw_VdwLJCombGeom_VF_prune_hip,
-      nbnxn_kernel_ElecEw_VdwLJCombLB_VF_prune_hip,
-      nbnxn_kernel_ElecEw_VdwLJFsw_VF_prune_hip,
-      nbnxn_kernel_ElecEw_VdwLJPsw_VF_prune_hip,
-      nbnxn_kernel_ElecEw_VdwLJEwCombGeom_VF_prune_hip,
-      nbnxn_kernel_ElecEw_VdwLJEwCombLB_VF_prune_hip },
-    { nbnxn_kernel_ElecEwTwinCut_VdwLJ_VF_prune_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJCombGeom_VF_prune_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJCombLB_VF_prune_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJFsw_VF_prune_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJPsw_VF_prune_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombGeom_VF_prune_hip,
-      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombLB_VF_prune_hip }
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_ener_prune_ptr[c_numNbKernelVariants][c_numElecTypes][c_numVdwTypes] = {
+    NB_KFUNC_VARIANT_TABLE(_VF_prune_hip, 0),
+    NB_KFUNC_VARIANT_TABLE(_VF_prune_hip, 1),
+    NB_KFUNC_VARIANT_TABLE(_VF_prune_hip, 2)
+};
+
+/*! Wave64-layout force-only kernel function pointers. */
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_wave64_noener_noprune_ptr[c_numElecTypes][c_numVdwTypes] = {
+    { nbnxn_kernel_ElecCut_VdwLJ_F_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJCombGeom_F_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJCombLB_F_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJFsw_F_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJPsw_F_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJEwCombGeom_F_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJEwCombLB_F_wave64_hip },
+    { nbnxn_kernel_ElecRF_VdwLJ_F_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJCombGeom_F_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJCombLB_F_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJFsw_F_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJPsw_F_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJEwCombGeom_F_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJEwCombLB_F_wave64_hip },
+    { nbnxn_kernel_ElecEwQSTab_VdwLJ_F_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJCombGeom_F_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJCombLB_F_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJFsw_F_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJPsw_F_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombGeom_F_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombLB_F_wave64_hip },
+    { nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJ_F_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombGeom_F_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombLB_F_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJFsw_F_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJPsw_F_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombGeom_F_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombLB_F_wave64_hip },
+    { nbnxn_kernel_ElecEw_VdwLJ_F_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJCombGeom_F_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJCombLB_F_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJFsw_F_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJPsw_F_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJEwCombGeom_F_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJEwCombLB_F_wave64_hip },
+    { nbnxn_kernel_ElecEwTwinCut_VdwLJ_F_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJCombGeom_F_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJCombLB_F_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJFsw_F_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJPsw_F_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombGeom_F_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombLB_F_wave64_hip }
+};
+
+/*! Wave64-layout force + energy kernel function pointers. */
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_wave64_ener_noprune_ptr[c_numElecTypes][c_numVdwTypes] = {
+    { nbnxn_kernel_ElecCut_VdwLJ_VF_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJCombGeom_VF_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJCombLB_VF_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJFsw_VF_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJPsw_VF_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJEwCombGeom_VF_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJEwCombLB_VF_wave64_hip },
+    { nbnxn_kernel_ElecRF_VdwLJ_VF_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJCombGeom_VF_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJCombLB_VF_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJFsw_VF_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJPsw_VF_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJEwCombGeom_VF_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJEwCombLB_VF_wave64_hip },
+    { nbnxn_kernel_ElecEwQSTab_VdwLJ_VF_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJCombGeom_VF_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJCombLB_VF_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJFsw_VF_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJPsw_VF_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombGeom_VF_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombLB_VF_wave64_hip },
+    { nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJ_VF_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombGeom_VF_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombLB_VF_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJFsw_VF_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJPsw_VF_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombGeom_VF_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombLB_VF_wave64_hip },
+    { nbnxn_kernel_ElecEw_VdwLJ_VF_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJCombGeom_VF_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJCombLB_VF_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJFsw_VF_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJPsw_VF_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJEwCombGeom_VF_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJEwCombLB_VF_wave64_hip },
+    { nbnxn_kernel_ElecEwTwinCut_VdwLJ_VF_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJCombGeom_VF_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJCombLB_VF_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJFsw_VF_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJPsw_VF_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombGeom_VF_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombLB_VF_wave64_hip }
+};
+
+/*! Wave64-layout force + pruning kernel function pointers. */
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_wave64_noener_prune_ptr[c_numElecTypes][c_numVdwTypes] = {
+    { nbnxn_kernel_ElecCut_VdwLJ_F_prune_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJCombGeom_F_prune_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJCombLB_F_prune_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJFsw_F_prune_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJPsw_F_prune_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJEwCombGeom_F_prune_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJEwCombLB_F_prune_wave64_hip },
+    { nbnxn_kernel_ElecRF_VdwLJ_F_prune_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJCombGeom_F_prune_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJCombLB_F_prune_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJFsw_F_prune_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJPsw_F_prune_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJEwCombGeom_F_prune_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJEwCombLB_F_prune_wave64_hip },
+    { nbnxn_kernel_ElecEwQSTab_VdwLJ_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJCombGeom_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJCombLB_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJFsw_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJPsw_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombGeom_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombLB_F_prune_wave64_hip },
+    { nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJ_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombGeom_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombLB_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJFsw_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJPsw_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombGeom_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombLB_F_prune_wave64_hip },
+    { nbnxn_kernel_ElecEw_VdwLJ_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJCombGeom_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJCombLB_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJFsw_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJPsw_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJEwCombGeom_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJEwCombLB_F_prune_wave64_hip },
+    { nbnxn_kernel_ElecEwTwinCut_VdwLJ_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJCombGeom_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJCombLB_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJFsw_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJPsw_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombGeom_F_prune_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombLB_F_prune_wave64_hip }
+};
+
+/*! Wave64-layout force + energy + pruning kernel function pointers. */
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_wave64_ener_prune_ptr[c_numElecTypes][c_numVdwTypes] = {
+    { nbnxn_kernel_ElecCut_VdwLJ_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJCombGeom_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJCombLB_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJFsw_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJPsw_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJEwCombGeom_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecCut_VdwLJEwCombLB_VF_prune_wave64_hip },
+    { nbnxn_kernel_ElecRF_VdwLJ_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJCombGeom_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJCombLB_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJFsw_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJPsw_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJEwCombGeom_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecRF_VdwLJEwCombLB_VF_prune_wave64_hip },
+    { nbnxn_kernel_ElecEwQSTab_VdwLJ_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJCombGeom_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJCombLB_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJFsw_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJPsw_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombGeom_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTab_VdwLJEwCombLB_VF_prune_wave64_hip },
+    { nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJ_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombGeom_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJCombLB_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJFsw_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJPsw_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombGeom_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwQSTabTwinCut_VdwLJEwCombLB_VF_prune_wave64_hip },
+    { nbnxn_kernel_ElecEw_VdwLJ_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJCombGeom_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJCombLB_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJFsw_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJPsw_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJEwCombGeom_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEw_VdwLJEwCombLB_VF_prune_wave64_hip },
+    { nbnxn_kernel_ElecEwTwinCut_VdwLJ_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJCombGeom_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJCombLB_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJFsw_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJPsw_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombGeom_VF_prune_wave64_hip,
+      nbnxn_kernel_ElecEwTwinCut_VdwLJEwCombLB_VF_prune_wave64_hip }
+};
+
+/*! Packed j-coordinate force-only kernel function pointers. */
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_packedxq_noener_noprune_ptr[c_numNbKernelVariants][c_numElecTypes][c_numVdwTypes] = {
+    NB_KFUNC_VARIANT_TABLE(_F_packedxq_hip, 0),
+    NB_KFUNC_VARIANT_TABLE(_F_packedxq_hip, 1),
+    NB_KFUNC_VARIANT_TABLE(_F_packedxq_hip, 2)
+};
+
+/*! Packed j-coordinate force + energy kernel function pointers. */
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_packedxq_ener_noprune_ptr[c_numNbKernelVariants][c_numElecTypes][c_numVdwTypes] = {
+    NB_KFUNC_VARIANT_TABLE(_VF_packedxq_hip, 0),
+    NB_KFUNC_VARIANT_TABLE(_VF_packedxq_hip, 1),
+    NB_KFUNC_VARIANT_TABLE(_VF_packedxq_hip, 2)
+};
+
+/*! Packed j-coordinate force + pruning kernel function pointers. */
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_packedxq_noener_prune_ptr[c_numNbKernelVariants][c_numElecTypes][c_numVdwTypes] = {
+    NB_KFUNC_VARIANT_TABLE(_F_prune_packedxq_hip, 0),
+    NB_KFUNC_VARIANT_TABLE(_F_prune_packedxq_hip, 1),
+    NB_KFUNC_VARIANT_TABLE(_F_prune_packedxq_hip, 2)
+};
+
+/*! Packed j-coordinate force + energy + pruning kernel function pointers. */
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_packedxq_ener_prune_ptr[c_numNbKernelVariants][c_numElecTypes][c_numVdwTypes] = {
+    NB_KFUNC_VARIANT_TABLE(_VF_prune_packedxq_hip, 0),
+    NB_KFUNC_VARIANT_TABLE(_VF_prune_packedxq_hip, 1),
+    NB_KFUNC_VARIANT_TABLE(_VF_prune_packedxq_hip, 2)
+};
+
+/*! Force-only kernel function pointers with the i-cluster data in registers. */
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_iregs_noener_noprune_ptr[c_numNbKernelVariants][c_numElecTypes][c_numVdwTypes] = {
+    NB_KFUNC_VARIANT_TABLE(_F_iregs_hip, 0),
+    NB_KFUNC_VARIANT_TABLE(_F_iregs_hip, 1),
+    NB_KFUNC_VARIANT_TABLE(_F_iregs_hip, 2)
+};
+
+/*! Force + energy kernel function pointers with the i-cluster data in registers. */
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_iregs_ener_noprune_ptr[c_numNbKernelVariants][c_numElecTypes][c_numVdwTypes] = {
+    NB_KFUNC_VARIANT_TABLE(_VF_iregs_hip, 0),
+    NB_KFUNC_VARIANT_TABLE(_VF_iregs_hip, 1),
+    NB_KFUNC_VARIANT_TABLE(_VF_iregs_hip, 2)
 };
 
+/*! Force + pruning kernel function pointers with the i-cluster data in registers. */
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_iregs_noener_prune_ptr[c_numNbKernelVariants][c_numElecTypes][c_numVdwTypes] = {
+    NB_KFUNC_VARIANT_TABLE(_F_prune_iregs_hip, 0),
+    NB_KFUNC_VARIANT_TABLE(_F_prune_iregs_hip, 1),
+    NB_KFUNC_VARIANT_TABLE(_F_prune_iregs_hip, 2)
+};
+
+/*! Force + energy + pruning kernel function pointers with the i-cluster data in registers. */
+static const nbnxn_cu_kfunc_ptr_t nb_kfunc_iregs_ener_prune_ptr[c_numNbKernelVariants][c_numElecTypes][c_numVdwTypes] = {
+    NB_KFUNC_VARIANT_TABLE(_VF_prune_iregs_hip, 0),
+    NB_KFUNC_VARIANT_TABLE(_VF_prune_iregs_hip, 1),
+    NB_KFUNC_VARIANT_TABLE(_VF_prune_iregs_hip, 2)
+};
+
+/*! \brief Returns whether the wave64-native nonbonded kernel layout is used on the device.
+ *
+ * The layout of nbnxm_hip_kernel_wave64.hpp is used on all devices with 64-wide
+ * wavefronts, unless disabled by setting the GMX_HIP_NB_DISABLE_WAVE64_LAYOUT
+ * environment variable.
+ */
+static inline bool useWave64KernelLayout(const DeviceInformation& deviceInfo)
+{
+    static const bool disabledByEnv = (getenv("GMX_HIP_NB_DISABLE_WAVE64_LAYOUT") != nullptr);
+
+    return deviceInfo.prop.warpSize == 64 && c_nbnxnGpuClusterpairSplit == 1 && !disabledByEnv;
+}
+
 /*! Return a pointer to the kernel version to be executed at the current step. */
 static inline nbnxn_cu_kfunc_ptr_t select_nbnxn_kernel(enum ElecType           elecType,
                                                        enum VdwType            vdwType,
                                                        bool                    bDoEne,
                                                        bool                    bDoPrune,
+                                                       bool                    bUsePackedXq,
+                                                       bool                    bUseIClusterRegisters,
+                                                       int                     kernelVariant,
                                                        const DeviceInformation gmx_unused* deviceInfo)
 {
     const int elecTypeIdx = static_cast<int>(elecType);
@@ -360,6 +569,8 @@ static inline nbnxn_cu_kfunc_ptr_t select_nbnxn_kernel(enum ElecType           e
                "The electrostatics type requested is not implemented in the HIP kernels.");
     GMX_ASSERT(vdwTypeIdx < c_numVdwTypes,
                "The VdW type requested is not implemented in the HIP kernels.");
+    GMX_ASSERT(kernelVariant >= 0 && kernelVariant < c_numNbKernelVariants,
+               "The kernel variant requested is not compiled for the HIP kernels.");
 
     /* assert assumptions made by the kernels */
     GMX_ASSERT(deviceInfo->prop.warpSize % (c_nbnxnGpuClusterSize * c_nbnxnGpuClusterSize / c_nbnxnGpuClusterpairSplit)  == 0,
@@ -367,26 +578,68 @@ static inline nbnxn_cu_kfunc_ptr_t select_nbnxn_kernel(enum ElecType           e
                "cluster_size_i*cluster_size_j/nbnxn_gpu_clusterpair_split to be dividable with the warp size "
                "of the architecture targeted.");
 
+    if (bUsePackedXq)
+    {
+        if (bDoEne)
+        {
+            return bDoPrune ? nb_kfunc_packedxq_ener_prune_ptr[kernelVariant][elecTypeIdx][vdwTypeIdx]
+                            : nb_kfunc_packedxq_ener_noprune_ptr[kernelVariant][elecTypeIdx][vdwTypeIdx];
+        }
+        else
+        {
+            return bDoPrune ? nb_kfunc_packedxq_noener_prune_ptr[kernelVariant][elecTypeIdx][vdwTypeIdx]
+                            : nb_kfunc_packedxq_noener_noprune_ptr[kernelVariant][elecTypeIdx][vdwTypeIdx];
+        }
+    }
+
+    if (bUseIClusterRegisters)
+    {
+        if (bDoEne)
+        {
+            return bDoPrune ? nb_kfunc_iregs_ener_prune_ptr[kernelVariant][elecTypeIdx][vdwTypeIdx]
+                            : nb_kfunc_iregs_ener_noprune_ptr[kernelVariant][elecTypeIdx][vdwTypeIdx];
+        }
+        else
+        {
+            return bDoPrune ? nb_kfunc_iregs_noener_prune_ptr[kernelVariant][elecTypeIdx][vdwTypeIdx]
+                            : nb_kfunc_iregs_noener_noprune_ptr[kernelVariant][elecTypeIdx][vdwTypeIdx];
+        }
+    }
+
+    if (useWave64KernelLayout(*deviceInfo))
+    {
+        if (bDoEne)
+        {
+            return bDoPrune ? nb_kfunc_wave64_ener_prune_ptr[elecTypeIdx][vdwTypeIdx]
+                            : nb_kfunc_wave64_ener_noprune_ptr[elecTypeIdx][vdwTypeIdx];
+        }
+        else
+        {
+            return bDoPrune ? nb_kfunc_wave64_noener_prune_ptr[elecTypeIdx][vdwTypeIdx]
+                            : nb_kfunc_wave64_noener_noprune_ptr[elecTypeIdx][vdwTypeIdx];
+        }
+    }
+
     if (bDoEne)
     {
         if (bDoPrune)
         {
-            return nb_kfunc_ener_prune_ptr[elecTypeIdx][vdwTypeIdx];
+            return nb_kfunc_ener_prune_ptr[kernelVariant][elecTypeIdx][vdwTypeIdx];
         }
         else
         {
-            return nb_kfunc_ener_noprune_ptr[elecTypeIdx][vdwTypeIdx];
+            return nb_kfunc_ener_noprune_ptr[kernelVariant][elecTypeIdx][vdwTypeIdx];
         }
     }
     else
     {
         if (bDoPrune)
         {
-            return nb_kfunc_noener_prune_ptr[elecTypeIdx][vdwTypeIdx];
+            return nb_kfunc_noener_prune_ptr[kernelVariant][elecTypeIdx][vdwTypeIdx];
         }
         else
         {
-            return nb_kfunc_noener_noprune_ptr[elecTypeIdx][vdwTypeIdx];
+            return nb_kfunc_noener_noprune_ptr[kernelVariant][elecTypeIdx][vdwTypeIdx];
         }
     }
 }
@@ -421,6 +674,229 @@ static inline int calc_shmem_required_nonbonded(const int               num_thre
     return shmem;
 }
 
+/*! \brief Calculates the amount of shared memory required by the wave64-layout nonbonded kernel.
+ *
+ * All i-atom data of the super-cluster is pre-loaded by the single wavefront of the
+ * block, the layout has to match the one set up in nbnxm_hip_kernel_wave64.hpp.
+ */
+static inline int calc_shmem_required_nonbonded_wave64(const NBParamGpu* nbp)
+{
+    constexpr int c_numIAtoms = c_nbnxnGpuNumClusterPerSupercluster * c_clSize;
+
+    /* i-atom x+q in shared memory */
+    int shmem = c_numIAtoms * sizeof(float4);
+
+    if (nbp->vdwType == VdwType::CutCombGeom || nbp->vdwType == VdwType::CutCombLB)
+    {
+        /* i-atom LJ combination parameters in shared memory */
+        shmem += c_numIAtoms * sizeof(float2);
+    }
+    else
+    {
+        /* i-atom types in shared memory */
+        shmem += c_numIAtoms * sizeof(int);
+    }
+
+    return shmem;
+}
+
+/*! \brief Returns the number of threads per CU in flight for \p kernel launched with
+ * blocks of \p blockSize threads using \p shmemSize bytes of dynamic shared memory. */
+static int queryNumThreadsInFlight(nbnxn_cu_kfunc_ptr_t kernel, const int blockSize, const int shmemSize)
+{
+    int numBlocks = 0;
+    checkDeviceError(hipOccupancyMaxActiveBlocksPerMultiprocessor(
+                             &numBlocks, reinterpret_cast<const void*>(kernel), blockSize, shmemSize),
+                     "Could not query the occupancy of the non-bonded kernel.");
+    return numBlocks * blockSize;
+}
+
+void select_nbnxn_kernel_variant(NbnxmGpu* nb)
+{
+    const DeviceInformation& deviceInfo = nb->deviceContext_->deviceInfo();
+    const NBParamGpu*        nbp        = nb->nbparam;
+
+    nb->kernelVariant = 0;
+    nb->kernelVariantDescription.clear();
+
+    /* The wave64 layout has a fixed launch configuration */
+    if (!nb->usePackedXq && useWave64KernelLayout(deviceInfo))
+    {
+        return;
+    }
+
+    /* Occupancy of the force-only kernel, which runs on most steps, for each variant */
+    const int shmemSize = calc_shmem_required_nonbonded(1, &deviceInfo, nbp);
+    int       numThreadsActive[c_numNbKernelVariants];
+    for (int v = 0; v < c_numNbKernelVariants; v++)
+    {
+        const int  blockSize = c_clSize * c_clSize * c_nbKernelVariants[v].threadsZ;
+        const auto kernel    = select_nbnxn_kernel(
+                nbp->elecType, nbp->vdwType, false, false, nb->usePackedXq, false, v, &deviceInfo);
+        numThreadsActive[v] = queryNumThreadsInFlight(kernel, blockSize, shmemSize);
+    }
+
+    /* Pick the variant with most threads in flight, on ties the earlier, simpler, one */
+    bool setFromEnv = false;
+    if (const char* env = getenv("GMX_HIP_NB_KERNEL_VARIANT"))
+    {
+        char*     end     = nullptr;
+        const int variant = strtol(env, &end, 10);
+        if (!end || (*end != 0) || variant < 0 || variant >= c_numNbKernelVariants)
+        {
+            gmx_fatal(FARGS,
+                      "Invalid value passed in GMX_HIP_NB_KERNEL_VARIANT=%s, an integer in the "
+                      "range 0-%d is required",
+                      env,
+                      c_numNbKernelVariants - 1);
+        }
+        nb->kernelVariant = variant;
+        setFromEnv        = true;
+    }
+    else
+    {
+        for (int v = 1; v < c_numNbKernelVariants; v++)
+        {
+            if (numThreadsActive[v] > numThreadsActive[nb->kernelVariant])
+            {
+                nb->kernelVariant = v;
+            }
+        }
+    }
+
+    const NbKernelVariant& variant = c_nbKernelVariants[nb->kernelVariant];
+    nb->kernelVariantDescription   = gmx::formatString(
+            "Using HIP non-bonded kernel variant %d (%d j-cluster(s) per block, minimum blocks "
+            "per CU divided by %d) on %s, %s: %d of max. %d threads per CU in flight",
+            nb->kernelVariant,
+            variant.threadsZ,
+            variant.minBlocksDivisor,
+            deviceInfo.prop.gcnArchName,
+            setFromEnv ? "set by GMX_HIP_NB_KERNEL_VARIANT" : "chosen by occupancy",
+            numThreadsActive[nb->kernelVariant],
+            deviceInfo.prop.maxThreadsPerMultiProcessor);
+    if (debug)
+    {
+        for (int v = 0; v < c_numNbKernelVariants; v++)
+        {
+            fprintf(debug, "Non-bonded GPU kernel variant %d: %d threads per CU in flight\n", v, numThreadsActive[v]);
+        }
+    }
+}
+
+void select_nbnxn_icluster_registers(NbnxmGpu* nb)
+{
+    const DeviceInformation& deviceInfo = nb->deviceContext_->deviceInfo();
+    const NBParamGpu*        nbp        = nb->nbparam;
+
+    nb->useIClusterRegisters = false;
+
+    /* The packed j-coordinates are only implemented with shared memory */
+    if (nb->usePackedXq)
+    {
+        return;
+    }
+
+    /* Occupancy of the force-only kernel that would be used otherwise */
+    int numThreadsShmem;
+    if (useWave64KernelLayout(deviceInfo))
+    {
+        numThreadsShmem = queryNumThreadsInFlight(
+                select_nbnxn_kernel(nbp->elecType, nbp->vdwType, false, false, false, false, 0, &deviceInfo),
+                c_clSize * c_wave64JAtomsPerLaneRow * c_wave64NumJClustersInFlight,
+                calc_shmem_required_nonbonded_wave64(nbp));
+    }
+    else
+    {
+        numThreadsShmem = queryNumThreadsInFlight(
+                select_nbnxn_kernel(
+                        nbp->elecType, nbp->vdwType, false, false, false, false, nb->kernelVariant, &deviceInfo),
+                c_clSize * c_clSize * c_nbKernelVariants[nb->kernelVariant].threadsZ,
+                calc_shmem_required_nonbonded(1, &deviceInfo, nbp));
+    }
+    const int numThreadsRegisters = queryNumThreadsInFlight(
+            select_nbnxn_kernel(nbp->elecType, nbp->vdwType, false, false, false, true, nb->kernelVariant, &deviceInfo),
+            c_clSize * c_clSize * c_nbKernelVariants[nb->kernelVariant].threadsZ,
+            0);
+
+    /* Keeping the i-cluster data in registers costs registers and extra loads,
+     * so only use it when it increases the occupancy, i.e. shared memory is the limit.
+     */
+    bool setFromEnv = false;
+    if (const char* env = getenv("GMX_HIP_NB_ICLUSTER_REGISTERS"))
+    {
+        if (strcmp(env, "0") != 0 && strcmp(env, "1") != 0)
+        {
+            gmx_fatal(FARGS, "Invalid value passed in GMX_HIP_NB_ICLUSTER_REGISTERS=%s, 0 or 1 is required", env);
+        }
+        nb->useIClusterRegisters = (strcmp(env, "1") == 0);
+        setFromEnv               = true;
+    }
+    else
+    {
+        nb->useIClusterRegisters = (numThreadsRegisters > numThreadsShmem);
+    }
+
+    if (nb->useIClusterRegisters || setFromEnv)
+    {
+        if (!nb->kernelVariantDescription.empty())
+        {
+            nb->kernelVariantDescription += "\n";
+        }
+        nb->kernelVariantDescription += gmx::formatString(
+                "%s the HIP non-bonded i-cluster data in registers instead of shared memory, %s: "
+                "%d threads per CU in flight with registers, %d with shared memory",
+                nb->useIClusterRegisters ? "Keeping" : "Not keeping",
+                setFromEnv ? "set by GMX_HIP_NB_ICLUSTER_REGISTERS" : "chosen by occupancy",
+                numThreadsRegisters,
+                numThreadsShmem);
+    }
+    if (debug)
+    {
+        fprintf(debug,
+                "Non-bonded GPU kernel i-cluster data in registers: %d, with shared memory: %d "
+                "threads per CU in flight\n",
+                numThreadsRegisters,
+                numThreadsShmem);
+    }
+}
+
+/*! \brief Packs the j-atom coordinates for the packed j-coordinate kernels in \p deviceStream.
+ *
+ * Has to be called after the x+q H2D copy or the buffer ops and before the force kernel.
+ */
+static void launchPackXqKernel(NbnxmGpu* nb, const DeviceStream& deviceStream)
+{
+    NBAtomDataGpu*       adat          = nb->atdat;
+    const DeviceContext& deviceContext = *nb->deviceContext_;
+
+    GMX_ASSERT(adat->numAtoms % c_clSize == 0,
+               "The GPU atom data should consist of whole clusters");
+    const int numClusters = adat->numAtoms / c_clSize;
+
+    reallocateDeviceBuffer(
+            &adat->xqPacked, adat->numAtoms, &nb->xqPackedSize, &nb->xqPackedSizeAlloc, deviceContext);
+    reallocateDeviceBuffer(&adat->xClusterCenter,
+                           numClusters,
+                           &nb->xClusterCenterSize,
+                           &nb->xClusterCenterSizeAlloc,
+                           deviceContext);
+
+    constexpr unsigned int c_blockSize = 64U;
+
+    KernelLaunchConfig config;
+    config.blockSize[0]     = c_blockSize;
+    config.blockSize[1]     = 1;
+    config.blockSize[2]     = 1;
+    config.gridSize[0]      = (numClusters + c_blockSize - 1) / c_blockSize;
+    config.sharedMemorySize = 0;
+
+    const auto kernel     = nbnxn_kernel_pack_xq<c_blockSize>;
+    const auto kernelArgs = prepareGpuKernelArguments(
+            kernel, config, adat, &numClusters, &nb->nbparam->xqPackedUseBf16);
+    launchGpuKernel(kernel, config, deviceStream, nullptr, "nbnxn_kernel_pack_xq", kernelArgs);
+}
+
 /*! As we execute nonbonded workload in separate streams, before launching
    the kernel we need to make sure that he following operations have completed:
    - atomdata allocation and related H2D transfers (every nstlist step);
@@ -448,6 +924,9 @@ void gpu_launch_kernel(NbnxmGpu* nb, const gmx::StepWorkload& stepWork, const In
 
     bool bDoTime = nb->bDoTime;
 
+    /* Only a rolling pruning that follows this kernel launch may use the separate stream */
+    nb->xqReadyForRollingPrune[iloc].reset();
+
     /* Don't launch the non-local kernel if there is no work to do.
        Doing the same for the local kernel is more complicated, since the
        local part of the force array also depends on the non-local kernel.
@@ -479,28 +958,54 @@ void gpu_launch_kernel(NbnxmGpu* nb, const gmx::StepWorkload& stepWork, const In
         return;
     }
 
+    if (nb->rollingPruneStream != nullptr)
+    {
+        nb->xqReadyForRollingPrune[iloc].markEvent(deviceStream);
+    }
+
     /* beginning of timed nonbonded calculation section */
     if (bDoTime)
     {
         timers->interaction[iloc].nb_k.openTimingRegion(deviceStream);
     }
 
+    if (nb->usePackedXq)
+    {
+        launchPackXqKernel(nb, deviceStream);
+    }
+
     /* Kernel launch config:
      * - The thread block dimensions match the size of i-clusters, j-clusters,
      *   and j-cluster concurrency, in x, y, and z, respectively.
      * - The 1D block-grid contains as many blocks as super-clusters.
      */
-    int num_threads_z = 1;
+    int num_threads_z = c_nbKernelVariants[nb->kernelVariant].threadsZ;
     int nblock = calc_nb_kernel_nblock(plist->nsci, &nb->deviceContext_->deviceInfo());
 
 
     KernelLaunchConfig config;
-    config.blockSize[0] = c_clSize;
-    config.blockSize[1] = c_clSize;
-    config.blockSize[2] = num_threads_z;
-    config.gridSize[0]  = nblock;
-    config.sharedMemorySize =
-            calc_shmem_required_nonbonded(num_threads_z, &nb->deviceContext_->deviceInfo(), nbp);
+    /* The packed j-coordinates and the i-cluster data in registers are only implemented
+     * in the regular kernel layout */
+    if (!nb->usePackedXq && !nb->useIClusterRegisters
+        && useWave64KernelLayout(nb->deviceContext_->deviceInfo()))
+    {
+        /* One wavefront per block, the z-dimension selects the j-cluster in flight */
+        config.blockSize[0]     = c_clSize;
+        config.blockSize[1]     = c_wave64JAtomsPerLaneRow;
+        config.blockSize[2]     = c_wave64NumJClustersInFlight;
+        config.sharedMemorySize = calc_shmem_required_nonbonded_wave64(nbp);
+    }
+    else
+    {
+        config.blockSize[0] = c_clSize;
+        config.blockSize[1] = c_clSize;
+        config.blockSize[2] = num_threads_z;
+        config.sharedMemorySize =
+                nb->useIClusterRegisters
+                        ? 0
+                        : calc_shmem_required_nonbonded(num_threads_z, &nb->deviceContext_->deviceInfo(), nbp);
+    }
+    config.gridSize[0] = nblock;
 
     if (debug)
     {
@@ -525,6 +1030,9 @@ void gpu_launch_kernel(NbnxmGpu* nb, const gmx::StepWorkload& stepWork, const In
                                 nbp->vdwType,
                                 stepWork.computeEnergy,
                                 (plist->haveFreshList && !nb->timers->interaction[iloc].didPrune),
+                                nb->usePackedXq,
+                                nb->useIClusterRegisters,
+                                nb->kernelVariant,
                                 &nb->deviceContext_->deviceInfo());
     const auto kernelArgs =
             prepareGpuKernelArguments(kernel, config, adat, nbp, plist, &stepWork.computeVirial, &plist->cj4);
@@ -592,16 +1100,80 @@ static inline int calc_shmem_required_prune(const int num_threads_z)
     return shmem;
 }
 
+/*! \brief Sorts the super-cluster list of \p plist into buckets of decreasing cost.
+ *
+ * The prune kernel has stored the bucket of each entry in plist->sci_count and the sizes
+ * of the buckets in plist->sci_histogram. With \p haveFreshList plist->sci is sorted into
+ * plist->sci_sorted, otherwise plist->sci_sorted is re-sorted in place using plist->sci
+ * as scratch space.
+ */
+static void launchSciSortKernels(gpu_plist* plist, bool haveFreshList, const DeviceStream& deviceStream)
+{
+    size_t scan_temporary_size = (size_t)plist->nscan_temporary;
+    rocprim::exclusive_scan(
+        *reinterpret_cast<void**>(&plist->scan_temporary),
+        scan_temporary_size,
+        *reinterpret_cast<int**>(&plist->sci_histogram),
+        *reinterpret_cast<int**>(&plist->sci_offset),
+        0,
+        c_sciHistogramSize,
+        ::rocprim::plus<int>(),
+        deviceStream.stream()
+    );
+
+    KernelLaunchConfig configSortSci;
+    const unsigned int items_per_block = 256 * 16;
+    configSortSci.blockSize[0] = 256;
+    configSortSci.blockSize[1] = 1;
+    configSortSci.blockSize[2] = 1;
+    configSortSci.gridSize[0]  = (plist->nsci + items_per_block - 1) / items_per_block;
+    configSortSci.sharedMemorySize = 0;
+
+    const auto kernelSciSort = haveFreshList ?
+        nbnxn_kernel_bucket_sci_sort<256, 16, true> : nbnxn_kernel_bucket_sci_sort<256, 16, false>;
+
+    const auto kernelSciSortArgs =
+            prepareGpuKernelArguments(
+                kernelSciSort,
+                configSortSci,
+                plist
+            );
+
+    launchGpuKernel(
+        kernelSciSort,
+        configSortSci,
+        deviceStream,
+        nullptr,
+        "nbnxn_kernel_sci_sort",
+        kernelSciSortArgs
+    );
+
+    if (!haveFreshList)
+    {
+        copyBetweenDeviceBuffers(
+                &plist->sci_sorted, &plist->sci, plist->nsci, deviceStream, GpuApiCallBehavior::Async, nullptr);
+    }
+}
+
 void gpu_launch_kernel_pruneonly(NbnxmGpu* nb, const InteractionLocality iloc, const int numParts)
 {
     NBAtomDataGpu*      adat         = nb->atdat;
     NBParamGpu*         nbp          = nb->nbparam;
     gpu_plist*          plist        = nb->plist[iloc];
     Nbnxm::GpuTimers*   timers       = nb->timers;
-    const DeviceStream& deviceStream = *nb->deviceStreams[iloc];
 
     bool bDoTime = nb->bDoTime;
 
+    /* The rolling pruning only reads the coordinates and rewrites the inner-list masks.
+     * The non-bonded kernel of this step can be using the old or the new masks concurrently,
+     * as both are valid lists for this step, so the pruning only needs to wait for the
+     * coordinates and to finish before the next step updates them.
+     */
+    const bool useRollingPruneStream = !plist->haveFreshList && nb->rollingPruneStream != nullptr
+                                       && nb->xqReadyForRollingPrune[iloc].isMarked();
+    const DeviceStream& deviceStream =
+            useRollingPruneStream ? *nb->rollingPruneStream : *nb->deviceStreams[iloc];
+
     if (plist->haveFreshList)
     {
         GMX_ASSERT(numParts == 1, "With first pruning we expect 1 part");
@@ -634,8 +1206,8 @@ void gpu_launch_kernel_pruneonly(NbnxmGpu* nb, const InteractionLocality iloc, c
         plist->rollingPruningPart = 0;
     }
 
-    /* Compute the number of list entries to prune in this pass */
-    int numSciInPart = (plist->nsci - part) / numParts;
+    /* Compute the number of list entries to prune in this pass, entries part, part + numParts, ... */
+    int numSciInPart = (plist->nsci - part + numParts - 1) / numParts;
 
     /* Don't launch the kernel if there is no work to do (not allowed with HIP) */
     if (numSciInPart <= 0)
@@ -689,11 +1261,16 @@ void gpu_launch_kernel_pruneonly(NbnxmGpu* nb, const InteractionLocality iloc, c
                 config.sharedMemorySize);
     }
 
-    if (plist->haveFreshList)
+    if (plist->haveFreshList || part == 0)
     {
         clearDeviceBufferAsync(&plist->sci_histogram, 0, c_sciHistogramSize, deviceStream);
     }
 
+    if (useRollingPruneStream)
+    {
+        nb->xqReadyForRollingPrune[iloc].enqueueWaitEvent(deviceStream);
+    }
+
     auto*          timingEvent  = bDoTime ? timer->fetchNextEvent() : nullptr;
     constexpr char kernelName[] = "k_pruneonly";
     const auto     kernel =
@@ -702,49 +1279,22 @@ void gpu_launch_kernel_pruneonly(NbnxmGpu* nb, const InteractionLocality iloc, c
     const auto kernelArgs = prepareGpuKernelArguments(kernel, config, adat, nbp, plist, &numParts, &part);
     launchGpuKernel(kernel, config, deviceStream, timingEvent, kernelName, kernelArgs);
 
-    /* TODO: consider a more elegant way to track which kernel has been called
-       (combined or separate 1st pass prune, rolling prune). */
-    if (plist->haveFreshList)
+    if (useRollingPruneStream)
     {
+        /* Join back, so all later work in the locality stream, including the coordinate
+         * update of the next step, is ordered after the pruning. */
+        nb->rollingPruneDone[iloc].markEvent(deviceStream);
+        nb->rollingPruneDone[iloc].enqueueWaitEvent(*nb->deviceStreams[iloc]);
+    }
 
-        size_t scan_temporary_size = (size_t)plist->nscan_temporary;
-        rocprim::exclusive_scan(
-            *reinterpret_cast<void**>(&plist->scan_temporary),
-            scan_temporary_size,
-            *reinterpret_cast<int**>(&plist->sci_histogram),
-            *reinterpret_cast<int**>(&plist->sci_offset),
-            0,
-            c_sciHistogramSize,
-            ::rocprim::plus<int>(),
-            deviceStream.stream()
-        );
-
-        KernelLaunchConfig configSortSci;
-        const unsigned int items_per_block = 256 * 16;
-        configSortSci.blockSize[0] = 256;
-        configSortSci.blockSize[1] = 1;
-        configSortSci.blockSize[2] = 1;
-        configSortSci.gridSize[0]  = (plist->nsci + items_per_block - 1) / items_per_block;
-        configSortSci.sharedMemorySize = 0;
-
-        const auto kernelSciSort = plist->haveFreshList ?
-            nbnxn_kernel_bucket_sci_sort<256, 16, true> : nbnxn_kernel_bucket_sci_sort<256, 16, false>;
-
-        const auto kernelSciSortArgs =
-                prepareGpuKernelArguments(
-                    kernelSciSort,
-                    configSortSci,
-                    plist
-                );
-
-        launchGpuKernel(
-            kernelSciSort,
-            configSortSci,
-            deviceStream,
-            nullptr,
-            "nbnxn_kernel_sci_sort",
-            kernelSciSortArgs
-        );
+    /* Sort the list by the cost estimates of the prune kernel, heaviest super-clusters
+     * first. After a rolling prune this is only possible once all parts have been
+     * pruned, and it is done in the locality stream, as the non-bonded kernel reads
+     * the sorted list.
+     */
+    if (nb->sortSciByCost && (plist->haveFreshList || part == numParts - 1))
+    {
+        launchSciSortKernels(plist, plist->haveFreshList, *nb->deviceStreams[iloc]);
     }
 
     if (plist->haveFreshList)
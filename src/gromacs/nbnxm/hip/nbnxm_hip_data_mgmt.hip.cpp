@@ -44,6 +44,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // TODO We would like to move this down, but the way NbnxmGpu
 //      is currently declared means this has to be before gpu_types.h
@@ -52,6 +53,7 @@
 // TODO Remove this comment when the above order issue is resolved
 #include "gromacs/gpu_utils/hiputils.hpp"
 #include "gromacs/gpu_utils/device_context.h"
+#include "gromacs/gpu_utils/device_stream.h"
 #include "gromacs/gpu_utils/gpu_utils.h"
 #include "gromacs/gpu_utils/gpueventsynchronizer.h"
 #include "gromacs/gpu_utils/pmalloc.h"
@@ -91,16 +93,58 @@ namespace Nbnxm
  */
 static const unsigned int gpu_min_ci_balanced_factor = 44;
 
-void gpu_init_platform_specific(NbnxmGpu* /* nb */)
+void gpu_init_platform_specific(NbnxmGpu* nb)
 {
     /* set the kernel type for the current GPU */
     /* pick L1 cache configuration */
     //hip_set_cacheconfig();
+
+    /* The rolling pruning only depends on the coordinates, so it does not need to queue
+     * behind the non-bonded kernel of its locality. Run it in a separate stream with lower
+     * priority than the non-bonded streams so it fills the GPU next to them. Timing does not
+     * work with concurrent streams, so keep the pruning in-stream when timing.
+     */
+    if (nb->nbparam->useDynamicPruning && !nb->bDoTime
+        && getenv("GMX_NB_GPU_DISABLE_PRUNE_STREAM") == nullptr)
+    {
+        nb->rollingPruneStream =
+                new DeviceStream(*nb->deviceContext_, DeviceStreamPriority::Normal, false);
+    }
+
+    /* Experimental: let the force kernels read the j-atom coordinates as 16-bit offsets
+     * from the cluster centers. The packing is done in the local stream right before
+     * the local kernel, so this is only supported without non-local work.
+     */
+    const char* packedXqEnv = getenv("GMX_HIP_NB_PACKED_XQ");
+    if (packedXqEnv != nullptr && !nb->bUseTwoStreams)
+    {
+        nb->usePackedXq              = true;
+        nb->nbparam->xqPackedUseBf16 = (strcmp(packedXqEnv, "bf16") == 0);
+    }
+    else
+    {
+        nb->nbparam->xqPackedUseBf16 = false;
+    }
+    nb->atdat->xqPacked       = nullptr;
+    nb->atdat->xClusterCenter = nullptr;
+
+    /* Without sorting, the force kernels process the list in the order of the search */
+    nb->sortSciByCost = (getenv("GMX_HIP_NB_DISABLE_SCI_SORT") == nullptr);
+
+    select_nbnxn_kernel_variant(nb);
+    select_nbnxn_icluster_registers(nb);
 }
 
-void gpu_free_platform_specific(NbnxmGpu* /* nb */)
+void gpu_free_platform_specific(NbnxmGpu* nb)
 {
-    // Nothing specific in HIP
+    delete nb->rollingPruneStream;
+    nb->rollingPruneStream = nullptr;
+
+    if (nb->usePackedXq)
+    {
+        freeDeviceBuffer(&nb->atdat->xqPacked);
+        freeDeviceBuffer(&nb->atdat->xClusterCenter);
+    }
 }
 
 int gpu_min_ci_balanced(NbnxmGpu* nb)
@@ -123,4 +167,11 @@ DeviceBuffer<gmx::RVec> gpu_get_fshift(NbnxmGpu* nb)
     return reinterpret_cast<DeviceBuffer<gmx::RVec>>(nb->atdat->fShift);
 }
 
+std::string gpu_get_kernel_setup_description(const NbnxmGpu* nb)
+{
+    assert(nb);
+
+    return nb->kernelVariantDescription;
+}
+
 } // namespace Nbnxm
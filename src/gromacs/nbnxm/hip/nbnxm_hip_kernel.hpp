@@ -122,15 +122,16 @@
  *
  */
 
-/* Kernel launch bounds for different compute capabilities. The value of NTHREAD_Z
- * determines the number of threads per block and it is chosen such that
- * 16 blocks/multiprocessor can be kept in flight.
- * - CC 3.0,3.5, and >=5.0: NTHREAD_Z=1, (64, 16) bounds
- * - CC 3.7:                NTHREAD_Z=2, (128, 16) bounds
+/* Kernel launch bounds. The number of j-clusters processed concurrently, NTHREAD_Z,
+ * and the minimum number of blocks per multiprocessor are template parameters of
+ * the kernels. The variants listed in c_nbKernelVariants are instantiated and one
+ * of them is chosen at setup based on the occupancy achieved on the device.
+ * Variants with NTHREAD_Z > 1 divide the minimum number of blocks by minBlocksDivisor
+ * to keep the same number of threads in flight.
  *
  * Note: convenience macros, need to be undef-ed at the end of the file.
  */
-#define NTHREAD_Z 1
+#define NTHREAD_Z threadsZ
 
 // MI2** GPUs (gfx90a) have one unified pool of VGPRs and AccVGPRs. AccVGPRs are not used so
 // we can use twice as many registers as on MI100 and earlier devices without spilling.
@@ -145,24 +146,84 @@
 #    endif
 #endif
 #define THREADS_PER_BLOCK (c_clSize * c_clSize * NTHREAD_Z)
+#define MIN_BLOCKS_PER_MP_VARIANT \
+    (MIN_BLOCKS_PER_MP / minBlocksDivisor > 0 ? MIN_BLOCKS_PER_MP / minBlocksDivisor : 1)
 
-__launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
-#ifdef PRUNE_NBL
+#ifdef NB_PACKED_XQ
+#    ifdef PRUNE_NBL
+#        ifdef CALC_ENERGIES
+#            define NB_KERNEL_NAME NB_KERNEL_FUNC_NAME(nbnxn_kernel, _VF_prune_packedxq_hip)
+#        else
+#            define NB_KERNEL_NAME NB_KERNEL_FUNC_NAME(nbnxn_kernel, _F_prune_packedxq_hip)
+#        endif /* CALC_ENERGIES */
+#    else
+#        ifdef CALC_ENERGIES
+#            define NB_KERNEL_NAME NB_KERNEL_FUNC_NAME(nbnxn_kernel, _VF_packedxq_hip)
+#        else
+#            define NB_KERNEL_NAME NB_KERNEL_FUNC_NAME(nbnxn_kernel, _F_packedxq_hip)
+#        endif /* CALC_ENERGIES */
+#    endif     /* PRUNE_NBL */
+#elif defined NB_ICLUSTER_IN_REGISTERS
+#    ifdef PRUNE_NBL
+#        ifdef CALC_ENERGIES
+#            define NB_KERNEL_NAME NB_KERNEL_FUNC_NAME(nbnxn_kernel, _VF_prune_iregs_hip)
+#        else
+#            define NB_KERNEL_NAME NB_KERNEL_FUNC_NAME(nbnxn_kernel, _F_prune_iregs_hip)
+#        endif /* CALC_ENERGIES */
+#    else
+#        ifdef CALC_ENERGIES
+#            define NB_KERNEL_NAME NB_KERNEL_FUNC_NAME(nbnxn_kernel, _VF_iregs_hip)
+#        else
+#            define NB_KERNEL_NAME NB_KERNEL_FUNC_NAME(nbnxn_kernel, _F_iregs_hip)
+#        endif /* CALC_ENERGIES */
+#    endif     /* PRUNE_NBL */
+#elif defined PRUNE_NBL
 #    ifdef CALC_ENERGIES
-        __global__ void NB_KERNEL_FUNC_NAME(nbnxn_kernel, _VF_prune_hip)
+#        define NB_KERNEL_NAME NB_KERNEL_FUNC_NAME(nbnxn_kernel, _VF_prune_hip)
 #    else
-        __global__ void NB_KERNEL_FUNC_NAME(nbnxn_kernel, _F_prune_hip)
+#        define NB_KERNEL_NAME NB_KERNEL_FUNC_NAME(nbnxn_kernel, _F_prune_hip)
 #    endif /* CALC_ENERGIES */
 #else
 #    ifdef CALC_ENERGIES
-        __global__ void NB_KERNEL_FUNC_NAME(nbnxn_kernel, _VF_hip)
+#        define NB_KERNEL_NAME NB_KERNEL_FUNC_NAME(nbnxn_kernel, _VF_hip)
 #    else
-        __global__ void NB_KERNEL_FUNC_NAME(nbnxn_kernel, _F_hip)
+#        define NB_KERNEL_NAME NB_KERNEL_FUNC_NAME(nbnxn_kernel, _F_hip)
 #    endif /* CALC_ENERGIES */
-#endif     /* PRUNE_NBL */
+#endif     /* NB_PACKED_XQ */
+
+/* Access to the data of atom tidxi of i-cluster i of the super-cluster, which is
+ * either kept in registers by each thread or shared through shared memory.
+ *
+ * Note: convenience macros, need to be undef-ed at the end of the file.
+ */
+#ifdef NB_ICLUSTER_IN_REGISTERS
+#    define NB_XQ_I(i) xqi_reg[i]
+#    define NB_TYPE_I(i) typei_reg[i]
+#    define NB_LJCP_I(i) ljcpi_reg[i]
+#else
+#    define NB_XQ_I(i) xqib[(i)*c_clSize + tidxi]
+#    define NB_TYPE_I(i) atib[(i)*c_clSize + tidxi]
+#    define NB_LJCP_I(i) ljcpib[(i)*c_clSize + tidxi]
+#endif
+
+/*! \brief Instantiates (with \p prefix extern: declares) the kernel for variant \p v of c_nbKernelVariants */
+#define NB_KERNEL_INSTANTIATE_VARIANT(prefix, v)                                                 \
+    prefix template __global__ void                                                              \
+    NB_KERNEL_NAME<c_nbKernelVariants[v].threadsZ, c_nbKernelVariants[v].minBlocksDivisor>(      \
+            NBAtomDataGpu, NBParamGpu, Nbnxm::gpu_plist, bool, nbnxn_cj4_t* __restrict__);
+static_assert(c_numNbKernelVariants == 3, "The instantiations below should match c_nbKernelVariants");
+
+template<int threadsZ, int minBlocksDivisor>
+__launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP_VARIANT) __global__ void NB_KERNEL_NAME
                 (NBAtomDataGpu atdat, NBParamGpu nbparam, Nbnxm::gpu_plist plist, bool bCalcFshift, nbnxn_cj4_t* __restrict__ pl_cj4)
 #ifdef FUNCTION_DECLARATION_ONLY
                         ; /* Only do function declaration, omit the function body. */
+
+// Add extern declarations so each translation unit understands that
+// there will be a definition provided.
+NB_KERNEL_INSTANTIATE_VARIANT(extern, 0)
+NB_KERNEL_INSTANTIATE_VARIANT(extern, 1)
+NB_KERNEL_INSTANTIATE_VARIANT(extern, 2)
 #else
 {
     /* convenience variables */
@@ -176,6 +237,11 @@ __launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
     float2                   ljcp_i, ljcp_j;
 #    endif
     FastBuffer<float4>   xq          = FastBuffer<float4>(atdat.xq);
+#    ifdef NB_PACKED_XQ
+    FastBuffer<uint3>    xqPacked    = FastBuffer<uint3>(atdat.xqPacked);
+    FastBuffer<float4>   xClCenter   = FastBuffer<float4>(atdat.xClusterCenter);
+    const bool           packedBf16  = nbparam.xqPackedUseBf16;
+#    endif
     float3*              f           = asFloat3(atdat.f);
     const float3*        shift_vec   = asFloat3(atdat.shiftVec);
     float                rcoulomb_sq = nbparam.rcoulomb_sq;
@@ -220,11 +286,7 @@ __launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
     unsigned int tidxi = threadIdx.x;
     unsigned int tidxj = threadIdx.y;
     unsigned int tidx  = threadIdx.y * c_clSize + threadIdx.x;
-#    if NTHREAD_Z == 1
-    unsigned int tidxz = 0;
-#    else
-    unsigned int  tidxz = threadIdx.z;
-#    endif
+    unsigned int tidxz = NTHREAD_Z == 1 ? 0 : threadIdx.z;
 
     unsigned int widx  = (c_clSize * c_clSize) == warpSize ? 0 : tidx / c_subWarp; /* warp index */
 
@@ -257,6 +319,17 @@ __launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
     /*! i-cluster interaction mask for a super-cluster with all c_nbnxnGpuNumClusterPerSupercluster=8 bits set */
     const unsigned superClInteractionMask = ((1U << c_nbnxnGpuNumClusterPerSupercluster) - 1U);
 
+#    ifdef NB_ICLUSTER_IN_REGISTERS
+    /* Each thread keeps the data of atom tidxi of all i-clusters in registers,
+     * so the kernel uses no shared memory, which can limit the occupancy otherwise.
+     */
+    float4 xqi_reg[c_nbnxnGpuNumClusterPerSupercluster];
+#        ifndef LJ_COMB
+    int    typei_reg[c_nbnxnGpuNumClusterPerSupercluster];
+#        else
+    float2 ljcpi_reg[c_nbnxnGpuNumClusterPerSupercluster];
+#        endif
+#    else
     /*********************************************************************
      * Set up shared memory pointers.
      * sm_nextSlotPtr should always be updated to point to the "next slot",
@@ -281,12 +354,43 @@ __launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
     sm_nextSlotPtr += (c_nbnxnGpuNumClusterPerSupercluster * c_clSize * sizeof(*ljcpib));
 #    endif
     /*********************************************************************/
+#    endif /* NB_ICLUSTER_IN_REGISTERS */
 
     nb_sci     = pl_sci[bidx];         /* my i super-cluster's index = current bidx */
     sci        = nb_sci.sci;           /* super-cluster */
     cij4_start = nb_sci.cj4_ind_start; /* first ...*/
     cij4_end   = nb_sci.cj4_ind_start + nb_sci.cj4_length;   /* and last index of j clusters */
 
+#    ifdef NB_ICLUSTER_IN_REGISTERS
+    /* The super-cluster data is uniform over the block, make sure it lives in scalar
+     * registers, as it is needed for addressing the i-atoms in the whole kernel. */
+    sci        = __builtin_amdgcn_readfirstlane(sci);
+    cij4_start = __builtin_amdgcn_readfirstlane(cij4_start);
+    cij4_end   = __builtin_amdgcn_readfirstlane(cij4_end);
+
+    {
+        /* Load the i-atom data of all i-clusters, the threads with equal tidxi load
+         * the same atoms, so these loads are served from the cache. */
+        const float3 shift = shift_vec[nb_sci.shift];
+#       pragma unroll
+        for (i = 0; i < c_nbnxnGpuNumClusterPerSupercluster; i++)
+        {
+            ai    = (sci * c_nbnxnGpuNumClusterPerSupercluster + i) * c_clSize + tidxi;
+            xqbuf = xq[ai];
+            // Same sign convention as in the shared memory pre-loading below
+            xqbuf.x = -(xqbuf.x + shift.x);
+            xqbuf.y = -(xqbuf.y + shift.y);
+            xqbuf.z = -(xqbuf.z + shift.z);
+            xqbuf.w *= nbparam.epsfac;
+            xqi_reg[i] = xqbuf;
+#        ifndef LJ_COMB
+            typei_reg[i] = atom_types[ai];
+#        else
+            ljcpi_reg[i] = lj_comb[ai];
+#        endif
+        }
+    }
+#    else
     // We may need only a subset of threads active for preloading i-atoms
     // depending on the super-cluster and cluster / thread-block size.
     constexpr bool c_loadUsingAllXYThreads = (c_clSize == c_nbnxnGpuNumClusterPerSupercluster);
@@ -315,6 +419,7 @@ __launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
 #    endif
     }
     __syncthreads();
+#    endif /* NB_ICLUSTER_IN_REGISTERS */
 
     for (i = 0; i < c_nbnxnGpuNumClusterPerSupercluster; i++)
     {
@@ -337,10 +442,11 @@ __launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
         && pl_cj4[cij4_start].cj[0] == sci * c_nbnxnGpuNumClusterPerSupercluster)
     {
         /* we have the diagonal: add the charge and LJ self interaction energy term */
+#       pragma unroll
         for (i = 0; i < c_nbnxnGpuNumClusterPerSupercluster; i++)
         {
 #           if defined EL_EWALD_ANY || defined EL_RF || defined EL_CUTOFF
-            qi = xqib[i * c_clSize + tidxi].w;
+            qi = NB_XQ_I(i).w;
             E_el += qi * qi;
 #            endif
 
@@ -386,7 +492,7 @@ __launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
      * The loop stride NTHREAD_Z ensures that consecutive warps-pairs are assigned
      * consecutive j4's entries.
      */
-    for (j4 = cij4_start; j4 < cij4_end; ++j4)
+    for (j4 = cij4_start + tidxz; j4 < cij4_end; j4 += NTHREAD_Z)
     {
         imask     = pl_cj4[j4].imei[widx].imask;
         /* When c_nbnxnGpuClusterpairSplit = 1, i.e. on CDNA, ROCm 5.2's compiler correctly
@@ -421,7 +527,11 @@ __launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
             aj = cj * c_clSize + tidxj;
 
             /* load j atom data */
+#    ifdef NB_PACKED_XQ
+            xqbuf = unpack_xq_j(xqPacked[aj], xClCenter[cj], packedBf16);
+#    else
             xqbuf = xq[aj];
+#    endif
             xj    = make_fast_float3(xqbuf);
             qj_f  = xqbuf.w;
 #    ifndef LJ_COMB
@@ -439,7 +549,7 @@ __launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
                     ci = sci * c_nbnxnGpuNumClusterPerSupercluster + i; /* i cluster index */
 
                     /* all threads load an atom from i cluster ci into shmem! */
-                    xqbuf = xqib[i * c_clSize + tidxi];
+                    xqbuf = NB_XQ_I(i);
                     xi    = make_fast_float3(xqbuf);
 
                     /* distance between i and j atoms */
@@ -467,14 +577,14 @@ __launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
                         qi = xqbuf.w;
 #    ifndef LJ_COMB
                         /* LJ 6*C6 and 12*C12 */
-                        typei = atib[i * c_clSize + tidxi];
+                        typei = NB_TYPE_I(i);
 #        ifdef __gfx1030__
                         c6c12 = fetch_nbfp_c6_c12(nbparam, ntypes * typei + typej);
 #        else
                         c6c12 = fetch_nbfp_c6_c12(nbparam, __mul24(ntypes, typei) + typej);
 #        endif
 #    else
-                        ljcp_i       = ljcpib[i * c_clSize + tidxi];
+                        ljcp_i       = NB_LJCP_I(i);
 #        ifdef LJ_COMB_GEOM
                         c6c12        = ljcp_i * ljcp_j;
 #        else
@@ -652,18 +762,32 @@ __launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
     float fshift_buf = 0.0F;
     float fci[c_nbnxnGpuNumClusterPerSupercluster];
 
+    /* After the reduction, this lane holds component fciComponent (if >= 0)
+     * of the force on atom fciAtom of each i-cluster. */
+#    if GMX_HIP_NB_DPP_REDUCTION
+    const unsigned int fciAtom      = tidxi;
+    const int          fciComponent = reduce_force_i_dpp_component(tidxj);
+#    else
+    const unsigned int fciAtom      = tidxj;
+    const int          fciComponent = tidxi < 3 ? static_cast<int>(tidxi) : -1;
+#    endif
+
     /* reduce i forces */
     for (i = 0; i < c_nbnxnGpuNumClusterPerSupercluster; i++)
     {
+#    if GMX_HIP_NB_DPP_REDUCTION
+        fci[i] = reduce_force_i_dpp(fci_buf[i], tidxj);
+#    else
         fci[i] = reduce_force_i_warp_shfl(fci_buf[i], tidxi, tidxj);
+#    endif
         fshift_buf += fci[i];
     }
-    if (tidxi < 3)
+    if (fciComponent >= 0)
     {
         for (i = 0; i < c_nbnxnGpuNumClusterPerSupercluster; i++)
         {
-            ai = (sci * c_nbnxnGpuNumClusterPerSupercluster + i) * c_clSize + tidxj;
-            atomic_add_force(f, ai, tidxi, fci[i]);
+            ai = (sci * c_nbnxnGpuNumClusterPerSupercluster + i) * c_clSize + fciAtom;
+            atomic_add_force(f, ai, fciComponent, fci[i]);
         }
     }
 
@@ -675,10 +799,10 @@ __launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
 #else
         const unsigned int shift_index_base = 0;
 #endif
-        if (tidxi < 3)
+        if (fciComponent >= 0)
         {
             float3* fShift = asFloat3(atdat.fShift);
-            atomic_add_force(fShift, nb_sci.shift + shift_index_base, tidxi, fshift_buf);
+            atomic_add_force(fShift, nb_sci.shift + shift_index_base, fciComponent, fshift_buf);
         }
     }
 #else
@@ -727,10 +851,20 @@ __launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
     reduce_energy_warp_shfl(E_lj, E_el, e_lj, e_el, tidx);
 #    endif
 }
+
+NB_KERNEL_INSTANTIATE_VARIANT(, 0)
+NB_KERNEL_INSTANTIATE_VARIANT(, 1)
+NB_KERNEL_INSTANTIATE_VARIANT(, 2)
 #endif /* FUNCTION_DECLARATION_ONLY */
 
+#undef NB_KERNEL_INSTANTIATE_VARIANT
+#undef NB_KERNEL_NAME
+#undef NB_XQ_I
+#undef NB_TYPE_I
+#undef NB_LJCP_I
 #undef NTHREAD_Z
 #undef MIN_BLOCKS_PER_MP
+#undef MIN_BLOCKS_PER_MP_VARIANT
 #undef THREADS_PER_BLOCK
 
 #undef EL_EWALD_ANY
@@ -103,6 +103,8 @@
  *  true a new list from immediately after pair-list generation is pruned using rlistOuter,
  *  the pruned masks are stored in a separate buffer and the outer-list is pruned
  *  using the rlistInner distance; when false only the pruning with rlistInner is performed.
+ *  Both flavors store the number of cluster pairs in range of rlistInner of each
+ *  super-cluster in plist.sci_count and plist.sci_histogram, for sorting the list by cost.
  *
  *  Kernel launch parameters:
  *   - #blocks   = #pair lists, blockId = pair list Id
@@ -285,22 +287,26 @@ nbnxn_kernel_prune_hip<false, NTHREAD_Z>(const NBAtomDataGpu, const NBParamGpu,
             {
                 /* copy the list pruned to rlistOuter to a separate buffer */
                 plist.imask[j4 * c_nbnxnGpuClusterpairSplit + widx] = imaskFull;
-
-                #ifndef __gfx1030__
-                    count += __popc(imaskNew);
-                #else
-                    count += __popc(imaskNew) + __popc(__shfl_up(imaskNew, 31, warpSize));
-                #endif
             }
             /* update the imask with only the pairs up to rlistInner */
             plist.cj4[j4].imei[widx].imask = imaskNew;
 
         }
+
+        /* Count the cluster pairs within rlistInner as the cost estimate of this
+         * super-cluster, used for sorting the list. With a rolling prune the pairs
+         * that were not checked keep their old mask, so they are counted as well.
+         */
+        #ifndef __gfx1030__
+            count += __popc(imaskNew);
+        #else
+            count += __popc(imaskNew) + __popc(__shfl_up(imaskNew, 31, warpSize));
+        #endif
         // avoid shared memory WAR hazards between loop iterations
         __builtin_amdgcn_wave_barrier();
     }
 
-    if (haveFreshList && tidx == 63)
+    if (tidx == 63)
     {
         if (threadsZ > 1)
         {
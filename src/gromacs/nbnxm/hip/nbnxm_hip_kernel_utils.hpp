@@ -49,6 +49,8 @@
 
 #include <assert.h>
 
+#include <hip/hip_fp16.h>
+
 /* Note that floating-point constants in HIP code should be suffixed
  * with f (e.g. 0.5f), to stop the compiler producing intermediate
  * code that is in double precision.
@@ -103,6 +105,38 @@ static const int __device__ c_fbufStride = c_clSizeSq;
 static const unsigned __device__ superClInteractionMask =
         ((1U << c_nbnxnGpuNumClusterPerSupercluster) - 1U);
 
+/*! \brief Number of j-clusters processed concurrently by a wavefront in the wave64 kernel layout. */
+static constexpr int c_wave64NumJClustersInFlight = 2;
+/*! \brief Number of j-atoms each lane computes interactions with in the wave64 kernel layout. */
+static constexpr int c_wave64JAtomsPerLane = 2;
+/*! \brief Number of lane rows (j-atoms) per half-wavefront in the wave64 kernel layout. */
+static constexpr int c_wave64JAtomsPerLaneRow = c_clSize / c_wave64JAtomsPerLane;
+/*! \brief Number of lanes processing one j-cluster in the wave64 kernel layout. */
+static constexpr int c_wave64HalfSize = c_clSize * c_wave64JAtomsPerLaneRow;
+
+static_assert(c_wave64HalfSize * c_wave64NumJClustersInFlight == 64,
+              "The wave64 kernel layout should cover exactly 64 lanes");
+static_assert(c_nbnxnGpuJgroupSize % c_wave64NumJClustersInFlight == 0,
+              "The wave64 kernel layout requires an even number of j-clusters per j-group");
+
+/*! \brief Launch configuration variant of the regular-layout non-bonded kernels. */
+struct NbKernelVariant
+{
+    //! Number of j-clusters processed concurrently in a block (NTHREAD_Z), the z-dimension of the block
+    int threadsZ;
+    //! Divisor of the default minimum number of blocks per multiprocessor in the launch bounds
+    int minBlocksDivisor;
+};
+
+//! Number of launch configuration variants of the regular-layout non-bonded kernels
+static constexpr int c_numNbKernelVariants = 3;
+/*! \brief The launch configuration variants the regular-layout non-bonded kernels are compiled for.
+ *
+ * The first is the default, the second processes two j-clusters per block with the same
+ * number of threads in flight, the third leaves the register allocation unconstrained.
+ */
+static constexpr NbKernelVariant c_nbKernelVariants[c_numNbKernelVariants] = { { 1, 1 }, { 2, 2 }, { 1, 8 } };
+
 static const float __device__ c_oneSixth    = 0.16666667F;
 static const float __device__ c_oneTwelveth = 0.08333333F;
 
@@ -136,6 +170,16 @@ __device__ __forceinline__ int __nb_any(int predicate,int widx)
     }
 }
 
+/*! \brief Returns whether \p predicate is true for any lane of wavefront half \p half.
+ *
+ * Used by the wave64 kernel layout where the two halves of a 64-wide wavefront
+ * process different j-clusters and can be inactive independently of each other.
+ */
+__device__ __forceinline__ bool nb_any_wave64_half(int predicate, unsigned int half)
+{
+    return ((__ballot(predicate) >> (half * c_wave64HalfSize)) & 0xffffffffULL) != 0;
+}
+
 static __forceinline__ __device__
 void float3_reduce_final(float3* input_ptr, const unsigned int size)
 {
@@ -213,6 +257,13 @@ void nbnxn_kernel_sum_up(
     }
 }
 
+/*! \brief Scatters the super-cluster list into buckets of decreasing cost.
+ *
+ * Uses the bucket index per entry in plist.sci_count and the exclusive scan of the
+ * bucket histogram in plist.sci_offset. After a fresh-list prune plist.sci is sorted into
+ * plist.sci_sorted; after a rolling prune the counts refer to the entries of plist.sci_sorted,
+ * which is then sorted into plist.sci and needs to be copied back.
+ */
 template<
     unsigned int BlockSize,
     unsigned int ItemsPerThread,
@@ -228,8 +279,8 @@ void nbnxn_kernel_bucket_sci_sort(
     const unsigned int block_id     = blockIdx.x;
     const unsigned int block_offset = blockIdx.x * BlockSize * ItemsPerThread;
 
-    const nbnxn_sci_t* pl_sci = plist.sci;
-    nbnxn_sci_t* pl_sci_sort  = plist.sci_sorted;
+    const nbnxn_sci_t* pl_sci = haveFreshList ? plist.sci : plist.sci_sorted;
+    nbnxn_sci_t* pl_sci_sort  = haveFreshList ? plist.sci_sorted : plist.sci;
     const int* pl_sci_count   = plist.sci_count;
 
     int* pl_sci_offset        = plist.sci_offset;
@@ -700,6 +751,55 @@ static __forceinline__ __device__ float reduce_force_i_warp_shfl(float3       f,
     return f.x;
 }
 
+/*! Final i-force reduction without the shuffle-based transpose of reduce_force_i_warp_shfl().
+ *
+ *  Reduces the force on i-atom tidxi over the c_clSize lane rows tidxj of a 64-wide
+ *  wavefront (lane = tidxj * c_clSize + tidxi) as a reduce-scatter of the xyz
+ *  components: the exchange between the wavefront halves halves the number of
+ *  components per lane, ds_swizzle over 16 lanes halves it again and a DPP
+ *  row_ror:8 completes the sum. This needs 4 cross-lane operations instead of 8,
+ *  of which only the two exchanges between the wavefront halves go through
+ *  ds_bpermute.
+ *
+ *  On return, lanes for which reduce_force_i_dpp_component() returns a
+ *  non-negative value hold that component of the force on i-atom tidxi.
+ */
+static __forceinline__ __device__ float reduce_force_i_dpp(float3 f, unsigned int tidxj)
+{
+    const bool upperHalf    = (tidxj & 4U) != 0; // lane bit 5
+    const bool upperQuarter = (tidxj & 2U) != 0; // lane bit 4
+
+    // Across the halves: the lower half keeps x and y, the upper half keeps z (and zero)
+    float keep0 = upperHalf ? f.z : f.x;
+    float keep1 = upperHalf ? 0.0F : f.y;
+    float send0 = upperHalf ? f.x : f.z;
+    float send1 = upperHalf ? f.y : 0.0F;
+    keep0 += __shfl_xor(send0, c_wave64HalfSize);
+    keep1 += __shfl_xor(send1, c_wave64HalfSize);
+
+    // Across quarters within the half: ds_swizzle in bit mode with and_mask=0x1f, xor_mask=0x10
+    constexpr int c_swizzleXor16 = 0x1f | (0x10 << 10);
+    float         keep           = upperQuarter ? keep1 : keep0;
+    float         send           = upperQuarter ? keep0 : keep1;
+    keep += __int_as_float(__builtin_amdgcn_ds_swizzle(__float_as_int(send), c_swizzleXor16));
+
+    // Across the two lane rows within a DPP row of 16 lanes
+    keep += warp_move_dpp<float, /* row_ror:8 */ 0x128>(keep);
+
+    return keep;
+}
+
+/*! Returns the force component held by lane row tidxj after reduce_force_i_dpp(), -1 if none.
+ *
+ *  Both lane rows of a DPP row hold the same sum, only the even one reports a component.
+ */
+static __forceinline__ __device__ int reduce_force_i_dpp_component(unsigned int tidxj)
+{
+    const int component = static_cast<int>(((tidxj & 4U) >> 1) | ((tidxj & 2U) >> 1));
+
+    return ((tidxj & 1U) == 0 && component < 3) ? component : -1;
+}
+
 /*! Final i-force reduction; this implementation works only with power of two
  *  array sizes.
  */
@@ -759,6 +859,12 @@ reduce_energy_warp_shfl(float E_lj, float E_el, float* e_lj, float* e_el, int ti
 
     E_lj += warp_move_dpp<float, 0x143>(E_lj);
     E_el += warp_move_dpp<float, 0x143>(E_el);
+#elif GMX_HIP_NB_DPP_REDUCTION
+    /* Add lane 15 of the other row of 16 lanes without going through ds_bpermute */
+    E_lj += __int_as_float(__builtin_amdgcn_permlanex16(
+            __float_as_int(E_lj), __float_as_int(E_lj), 0xffffffff, 0xffffffff, false, false));
+    E_el += __int_as_float(__builtin_amdgcn_permlanex16(
+            __float_as_int(E_el), __float_as_int(E_el), 0xffffffff, 0xffffffff, false, false));
 #else
     E_lj += __shfl(E_lj, 15);
     E_el += __shfl(E_el, 15);
@@ -772,4 +878,109 @@ reduce_energy_warp_shfl(float E_lj, float E_el, float* e_lj, float* e_el, int ti
     }
 }
 
+/*! \brief Maximum distance of a j-atom to the first atom of its cluster kept in the packed coordinates.
+ *
+ * Atoms further away, i.e. the fillers placed far away by the grid setup, are not included
+ * in the cluster bounding box and their offsets are clamped to this value. The clamped
+ * fillers still stay far beyond any cut-off from all i-clusters in the list.
+ */
+static constexpr float c_packedXqMaxOffset = 16.0F;
+
+//! Converts \p value to BF16 with round-to-nearest-even, returns the bits
+static __forceinline__ __device__ unsigned short float_to_bf16_bits(float value)
+{
+    /* The offsets are finite and clamped, so NaN/Inf don't need special treatment */
+    const unsigned int bits = __float_as_uint(value);
+    return static_cast<unsigned short>((bits + 0x7fffU + ((bits >> 16) & 1U)) >> 16);
+}
+
+//! Converts BF16 \p bits to float
+static __forceinline__ __device__ float bf16_bits_to_float(unsigned short bits)
+{
+    return __uint_as_float(static_cast<unsigned int>(bits) << 16);
+}
+
+//! Converts a coordinate offset to the 16-bit format in use, returns the bits
+static __forceinline__ __device__ unsigned int pack_offset(float offset, bool useBf16)
+{
+    return useBf16 ? float_to_bf16_bits(offset) : __half_as_ushort(__float2half_rn(offset));
+}
+
+//! Converts a 16-bit coordinate offset in the format in use to float
+static __forceinline__ __device__ float unpack_offset(unsigned int bits, bool useBf16)
+{
+    const unsigned short lowBits = static_cast<unsigned short>(bits & 0xffffU);
+    return useBf16 ? bf16_bits_to_float(lowBits) : __half2float(__ushort_as_half(lowBits));
+}
+
+/*! \brief Packs the coordinates and charges of cluster \p cluster.
+ *
+ * Stores the bounding-box center of the cluster in \p gm_xClusterCenter and for each atom
+ * the x, y, z offsets to the center as FP16 or BF16 and the FP32 charge in \p gm_xqPacked:
+ * x | y << 16 in the first, z in the low bits of the second and the charge bits in the
+ * third element. The charge is not reduced in precision, since its error would enter
+ * all pair interactions of the atom directly.
+ */
+static __forceinline__ __device__ void pack_cluster_xq(const float4* __restrict__ gm_xq,
+                                                       const int cluster,
+                                                       const bool useBf16,
+                                                       uint3* __restrict__ gm_xqPacked,
+                                                       float4* __restrict__ gm_xClusterCenter)
+{
+    const int    a0  = cluster * c_clSize;
+    const float4 xq0 = gm_xq[a0];
+
+    float3 lo = make_float3(xq0.x, xq0.y, xq0.z);
+    float3 hi = lo;
+    #pragma unroll
+    for (int i = 1; i < c_clSize; i++)
+    {
+        const float4 xqi = gm_xq[a0 + i];
+        if (fabsf(xqi.x - xq0.x) < c_packedXqMaxOffset && fabsf(xqi.y - xq0.y) < c_packedXqMaxOffset
+            && fabsf(xqi.z - xq0.z) < c_packedXqMaxOffset)
+        {
+            lo = make_float3(fminf(lo.x, xqi.x), fminf(lo.y, xqi.y), fminf(lo.z, xqi.z));
+            hi = make_float3(fmaxf(hi.x, xqi.x), fmaxf(hi.y, xqi.y), fmaxf(hi.z, xqi.z));
+        }
+    }
+    const float3 center =
+            make_float3(0.5F * (lo.x + hi.x), 0.5F * (lo.y + hi.y), 0.5F * (lo.z + hi.z));
+    gm_xClusterCenter[cluster] = make_float4(center.x, center.y, center.z, 0.0F);
+
+    #pragma unroll
+    for (int i = 0; i < c_clSize; i++)
+    {
+        const float4 xqi = gm_xq[a0 + i];
+        const float  dx  = fminf(fmaxf(xqi.x - center.x, -c_packedXqMaxOffset), c_packedXqMaxOffset);
+        const float  dy  = fminf(fmaxf(xqi.y - center.y, -c_packedXqMaxOffset), c_packedXqMaxOffset);
+        const float  dz  = fminf(fmaxf(xqi.z - center.z, -c_packedXqMaxOffset), c_packedXqMaxOffset);
+
+        gm_xqPacked[a0 + i] = make_uint3(pack_offset(dx, useBf16) | (pack_offset(dy, useBf16) << 16),
+                                         pack_offset(dz, useBf16),
+                                         __float_as_uint(xqi.w));
+    }
+}
+
+/*! \brief Unpacks the coordinates (in FP32) and the charge of a j-atom packed by pack_cluster_xq(). */
+static __forceinline__ __device__ float4 unpack_xq_j(const uint3 packed, const float4 center, const bool useBf16)
+{
+    return make_float4(center.x + unpack_offset(packed.x, useBf16),
+                       center.y + unpack_offset(packed.x >> 16, useBf16),
+                       center.z + unpack_offset(packed.y, useBf16),
+                       __uint_as_float(packed.z));
+}
+
+/*! \brief Packs the coordinates and charges of \p numClusters clusters, one thread per cluster. */
+template<unsigned int BlockSize>
+__launch_bounds__(BlockSize) __global__
+void nbnxn_kernel_pack_xq(NBAtomDataGpu atdat, int numClusters, bool useBf16)
+{
+    const int cluster = blockIdx.x * BlockSize + threadIdx.x;
+
+    if (cluster < numClusters)
+    {
+        pack_cluster_xq(atdat.xq, cluster, useBf16, atdat.xqPacked, atdat.xClusterCenter);
+    }
+}
+
 #endif /* NBNXN_HIP_KERNEL_UTILS_HPP */
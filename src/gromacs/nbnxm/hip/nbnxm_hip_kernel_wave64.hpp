@@ -0,0 +1,693 @@
+#include "hip/hip_runtime.h"
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+
+/*! \internal \file
+ *  \brief
+ *  Wave64-native HIP non-bonded kernel used through preprocessor-based code
+ *  generation of multiple kernel flavors, see nbnxm_hip_kernels.hpp.
+ *
+ *  The regular kernel in nbnxm_hip_kernel.hpp maps one c_clSize x c_clSize
+ *  cluster pair onto the thread block and processes the j-clusters of a cj4
+ *  group one after the other. This flavor is laid out for 64-wide wavefronts:
+ *  the two halves of the wavefront process two different j-clusters of the
+ *  cj4 group concurrently and each lane computes the interactions of its
+ *  i-atom with two j-atoms (tidxj and tidxj + c_clSize/2). As the lane order
+ *  of an 8x8 tile is preserved, the i-force and energy reductions are the
+ *  same wave64 DPP reduction trees as in the regular kernel, but they are done
+ *  once per pair of j-clusters instead of once per j-cluster.
+ *
+ *  Thread block layout: (c_clSize, c_clSize / 2, 2), i.e. exactly one wavefront.
+ *  - threadIdx.x: i-atom within the i-cluster
+ *  - threadIdx.y: j-atom pair within the j-cluster
+ *  - threadIdx.z: j-cluster within the currently processed pair of the cj4 group
+ *
+ *  NOTE: No include fence as it is meant to be included multiple times.
+ *
+ *  \ingroup module_nbnxm
+ */
+
+#include "gromacs/gpu_utils/hip_arch_utils.hpp"
+#include "gromacs/gpu_utils/hip_kernel_utils.hpp"
+#include "gromacs/gpu_utils/typecasts.hpp"
+#include "gromacs/math/units.h"
+#include "gromacs/math/utilities.h"
+#include "gromacs/pbcutil/ishift.h"
+/* Note that floating-point constants in HIP code should be suffixed
+ * with f (e.g. 0.5f), to stop the compiler producing intermediate
+ * code that is in double precision.
+ */
+
+#if defined EL_EWALD_ANA || defined EL_EWALD_TAB
+/* Note: convenience macro, needs to be undef-ed at the end of the file. */
+#    define EL_EWALD_ANY
+#endif
+
+#if defined LJ_EWALD_COMB_GEOM || defined LJ_EWALD_COMB_LB
+/* Note: convenience macro, needs to be undef-ed at the end of the file. */
+#    define LJ_EWALD
+#endif
+
+#if defined EL_EWALD_ANY || defined EL_RF || defined LJ_EWALD \
+        || (defined EL_CUTOFF && defined CALC_ENERGIES)
+/* Macro to control the calculation of exclusion forces in the kernel
+ * We do that with Ewald (elec/vdw) and RF. Cut-off only has exclusion
+ * energy terms.
+ *
+ * Note: convenience macro, needs to be undef-ed at the end of the file.
+ */
+#    define EXCLUSION_FORCES
+#endif
+
+#if defined LJ_COMB_GEOM || defined LJ_COMB_LB
+#    define LJ_COMB
+#endif
+
+/* See nbnxm_hip_kernel.hpp for the choice of minimum blocks per CU.
+ *
+ * Note: convenience macros, need to be undef-ed at the end of the file.
+ */
+#if defined(__gfx90a__)
+#    define MIN_BLOCKS_PER_MP 1
+#else
+#    ifdef CALC_ENERGIES
+#        define MIN_BLOCKS_PER_MP 6
+#    else
+#        define MIN_BLOCKS_PER_MP 8
+#    endif
+#endif
+#define THREADS_PER_BLOCK (c_clSize * c_wave64JAtomsPerLaneRow * c_wave64NumJClustersInFlight)
+
+__launch_bounds__(THREADS_PER_BLOCK, MIN_BLOCKS_PER_MP)
+#ifdef PRUNE_NBL
+#    ifdef CALC_ENERGIES
+        __global__ void NB_KERNEL_FUNC_NAME(nbnxn_kernel, _VF_prune_wave64_hip)
+#    else
+        __global__ void NB_KERNEL_FUNC_NAME(nbnxn_kernel, _F_prune_wave64_hip)
+#    endif /* CALC_ENERGIES */
+#else
+#    ifdef CALC_ENERGIES
+        __global__ void NB_KERNEL_FUNC_NAME(nbnxn_kernel, _VF_wave64_hip)
+#    else
+        __global__ void NB_KERNEL_FUNC_NAME(nbnxn_kernel, _F_wave64_hip)
+#    endif /* CALC_ENERGIES */
+#endif     /* PRUNE_NBL */
+                (NBAtomDataGpu atdat, NBParamGpu nbparam, Nbnxm::gpu_plist plist, bool bCalcFshift, nbnxn_cj4_t* __restrict__ pl_cj4)
+#ifdef FUNCTION_DECLARATION_ONLY
+                        ; /* Only do function declaration, omit the function body. */
+#else
+{
+    /* convenience variables */
+    const nbnxn_sci_t* pl_sci = plist.sci_sorted == nullptr ? plist.sci : plist.sci_sorted;
+    FastBuffer<nbnxn_excl_t> excl    = FastBuffer<nbnxn_excl_t>(plist.excl);
+#    ifndef LJ_COMB
+    FastBuffer<int>      atom_types  = FastBuffer<int>(atdat.atomTypes);
+    int                  ntypes      = atdat.numTypes;
+#    else
+    FastBuffer<float2> lj_comb       = FastBuffer<float2>(atdat.ljComb);
+    float2                   ljcp_i, ljcp_j[c_wave64JAtomsPerLane];
+#    endif
+    FastBuffer<float4>   xq          = FastBuffer<float4>(atdat.xq);
+    float3*              f           = asFloat3(atdat.f);
+    const float3*        shift_vec   = asFloat3(atdat.shiftVec);
+    float                rcoulomb_sq = nbparam.rcoulomb_sq;
+#    ifdef VDW_CUTOFF_CHECK
+    float                rvdw_sq     = nbparam.rvdw_sq;
+    float                vdw_in_range;
+#    endif
+#    ifdef LJ_EWALD
+    float                lje_coeff2, lje_coeff6_6;
+#    endif
+#    ifdef EL_RF
+    float                two_k_rf    = nbparam.two_k_rf;
+#    endif
+#    ifdef EL_EWALD_ANA
+    float                beta2       = nbparam.ewald_beta * nbparam.ewald_beta;
+    float                beta3       = nbparam.ewald_beta * nbparam.ewald_beta * nbparam.ewald_beta;
+#    endif
+#    ifdef PRUNE_NBL
+    float                rlist_sq    = nbparam.rlistOuter_sq;
+#    endif
+
+    unsigned int bidx = blockIdx.x;
+
+#    ifdef CALC_ENERGIES
+#        ifdef EL_EWALD_ANY
+    float                beta        = nbparam.ewald_beta;
+    float                ewald_shift = nbparam.sh_ewald;
+#        else
+    float reactionFieldShift = nbparam.c_rf;
+#        endif /* EL_EWALD_ANY */
+
+#        ifdef GMX_ENABLE_MEMORY_MULTIPLIER
+    const unsigned int energy_index_base = 1 + (bidx & (c_clEnergyMemoryMultiplier - 1));
+#        else
+    const unsigned int energy_index_base = 0;
+#        endif     /* GMX_ENABLE_MEMORY_MULTIPLIER */
+    float*               e_lj        = atdat.eLJ + energy_index_base;
+    float*               e_el        = atdat.eElec + energy_index_base;
+#    endif     /* CALC_ENERGIES */
+
+    /* thread/block/wavefront id-s */
+    unsigned int tidxi = threadIdx.x;
+    unsigned int tidxj = threadIdx.y;
+    unsigned int tidxh = threadIdx.z;
+    /* Row of the lane in the 8x8 tile, this is the same lane order as in the regular kernel */
+    unsigned int tidxjw = tidxh * c_wave64JAtomsPerLaneRow + tidxj;
+
+    int          sci, ci, cj, ai, cij4_start, cij4_end;
+    int          aj[c_wave64JAtomsPerLane];
+#    ifndef LJ_COMB
+    int          typei, typej[c_wave64JAtomsPerLane];
+#    endif
+    int          i, jh, jp, jm, j4, wexcl_idx;
+    float        qi, qj_f[c_wave64JAtomsPerLane], r2, inv_r, inv_r2;
+#    if !defined LJ_COMB_LB || defined CALC_ENERGIES
+    float        inv_r6;
+    float2       c6c12;
+#    endif
+#    ifdef LJ_COMB_LB
+    float        sigma, epsilon;
+#    endif
+    float        int_bit, F_invr;
+#    ifdef CALC_ENERGIES
+    float        E_lj, E_el;
+#    endif
+#    if defined CALC_ENERGIES || defined LJ_POT_SWITCH
+    float        E_lj_p;
+#    endif
+    unsigned int wexcl[c_wave64JAtomsPerLane], imask, mask_ji;
+    float4       xqbuf;
+    fast_float3  xi, rv, f_ij;
+    fast_float3  xj[c_wave64JAtomsPerLane], fcj_buf[c_wave64JAtomsPerLane];
+    fast_float3  fci_buf[c_nbnxnGpuNumClusterPerSupercluster]; /* i force buffer */
+    nbnxn_sci_t  nb_sci;
+
+    /*! i-cluster interaction mask for a super-cluster with all c_nbnxnGpuNumClusterPerSupercluster=8 bits set */
+    const unsigned superClInteractionMask = ((1U << c_nbnxnGpuNumClusterPerSupercluster) - 1U);
+
+    /*********************************************************************
+     * Set up shared memory pointers.
+     * sm_nextSlotPtr should always be updated to point to the "next slot",
+     * that is past the last point where data has been stored.
+     * The layout has to match calc_shmem_required_nonbonded_wave64().
+     */
+    HIP_DYNAMIC_SHARED( char, sm_dynamicShmem)
+    char*                  sm_nextSlotPtr = sm_dynamicShmem;
+    static_assert(sizeof(char) == 1,
+                  "The shared memory offset calculation assumes that char is 1 byte");
+
+    /* shmem buffer for i x+q pre-loading */
+    float4* xqib = reinterpret_cast<float4*>(sm_nextSlotPtr);
+    sm_nextSlotPtr += (c_nbnxnGpuNumClusterPerSupercluster * c_clSize * sizeof(*xqib));
+
+#    ifndef LJ_COMB
+    /* shmem buffer for i atom-type pre-loading */
+    int* atib = reinterpret_cast<int*>(sm_nextSlotPtr);
+    sm_nextSlotPtr += (c_nbnxnGpuNumClusterPerSupercluster * c_clSize * sizeof(*atib));
+#    else
+    /* shmem buffer for i-atom LJ combination parameters */
+    float2* ljcpib = reinterpret_cast<float2*>(sm_nextSlotPtr);
+    sm_nextSlotPtr += (c_nbnxnGpuNumClusterPerSupercluster * c_clSize * sizeof(*ljcpib));
+#    endif
+    /*********************************************************************/
+
+    nb_sci     = pl_sci[bidx];         /* my i super-cluster's index = current bidx */
+    sci        = nb_sci.sci;           /* super-cluster */
+    cij4_start = nb_sci.cj4_ind_start; /* first ...*/
+    cij4_end   = nb_sci.cj4_ind_start + nb_sci.cj4_length;   /* and last index of j clusters */
+
+    /* The 64 lanes exactly cover the i-atoms of the super-cluster, so all lanes
+     * pre-load one i-atom each: lane row tidxjw loads i-cluster tidxjw. */
+    static_assert(c_clSize == c_nbnxnGpuNumClusterPerSupercluster,
+                  "The wave64 kernel layout assumes as many i-clusters per super-cluster as atoms per cluster");
+    {
+        /* Pre-load i-atom x and q into shared memory */
+        ci = sci * c_nbnxnGpuNumClusterPerSupercluster + tidxjw;
+        ai = ci * c_clSize + tidxi;
+        const float3 shift = shift_vec[nb_sci.shift];
+        xqbuf = xq[ai];
+        // See nbnxm_hip_kernel.hpp for why the sign of xi is reversed
+        xqbuf.x = -(xqbuf.x + shift.x);
+        xqbuf.y = -(xqbuf.y + shift.y);
+        xqbuf.z = -(xqbuf.z + shift.z);
+        xqbuf.w *= nbparam.epsfac;
+        xqib[tidxjw * c_clSize + tidxi] = xqbuf;
+
+#    ifndef LJ_COMB
+        /* Pre-load the i-atom types into shared memory */
+        atib[tidxjw * c_clSize + tidxi] = atom_types[ai];
+#    else
+        /* Pre-load the LJ combination parameters into shared memory */
+        ljcpib[tidxjw * c_clSize + tidxi] = lj_comb[ai];
+#    endif
+    }
+    __syncthreads();
+
+    for (i = 0; i < c_nbnxnGpuNumClusterPerSupercluster; i++)
+    {
+        fci_buf[i] = make_fast_float3(0.0F);
+    }
+
+#    ifdef LJ_EWALD
+    /* TODO: we are trading registers with flops by keeping lje_coeff-s, try re-calculating it later */
+    lje_coeff2   = nbparam.ewaldcoeff_lj * nbparam.ewaldcoeff_lj;
+    lje_coeff6_6 = lje_coeff2 * lje_coeff2 * lje_coeff2 * c_oneSixth;
+#    endif
+
+
+#    ifdef CALC_ENERGIES
+    E_lj         = 0.0F;
+    E_el         = 0.0F;
+
+#        ifdef EXCLUSION_FORCES /* Ewald or RF */
+    if (nb_sci.shift == gmx::c_centralShiftIndex
+        && pl_cj4[cij4_start].cj[0] == sci * c_nbnxnGpuNumClusterPerSupercluster)
+    {
+        /* we have the diagonal: add the charge and LJ self interaction energy term */
+        for (i = 0; i < c_nbnxnGpuNumClusterPerSupercluster; i++)
+        {
+#           if defined EL_EWALD_ANY || defined EL_RF || defined EL_CUTOFF
+            qi = xqib[i * c_clSize + tidxi].w;
+            E_el += qi * qi;
+#            endif
+
+#           ifdef LJ_EWALD
+            // load only the first 4 bytes of the parameter pair (equivalent with nbfp[idx].x)
+            #if DISABLE_HIP_TEXTURES
+            E_lj += LDG(reinterpret_cast<float*>(
+                    &nbparam.nbfp[atom_types[(sci * c_nbnxnGpuNumClusterPerSupercluster + i) * c_clSize + tidxi]
+                                  * (ntypes + 1)]));
+            #else
+            E_lj += tex1Dfetch<float>(
+                    nbparam.nbfp_texobj, atom_types[(sci * c_nbnxnGpuNumClusterPerSupercluster + i) * c_clSize + tidxi]
+                                  * (ntypes + 1));
+            #endif
+#            endif
+        }
+
+        /* divide the self term(s) equally over the c_clSize lanes sharing an i-atom,
+         * then multiply with the coefficients. */
+#            ifdef LJ_EWALD
+        E_lj /= c_clSize;
+        E_lj *= 0.5F * c_oneSixth * lje_coeff6_6;
+#            endif
+
+#            if defined EL_EWALD_ANY || defined EL_RF || defined EL_CUTOFF
+        /* Correct for epsfac^2 due to adding qi^2 */
+        E_el /= nbparam.epsfac * c_clSize;
+#                if defined EL_RF || defined EL_CUTOFF
+        E_el *= -0.5F * reactionFieldShift;
+#                else
+        E_el *= -beta * M_FLOAT_1_SQRTPI; /* last factor 1/sqrt(pi) */
+#                endif
+#            endif /* EL_EWALD_ANY || defined EL_RF || defined EL_CUTOFF */
+    }
+#        endif     /* EXCLUSION_FORCES */
+
+#    endif /* CALC_ENERGIES */
+
+#    ifdef EXCLUSION_FORCES
+    int nonSelfInteraction[c_wave64JAtomsPerLane];
+#        pragma unroll
+    for (jh = 0; jh < c_wave64JAtomsPerLane; jh++)
+    {
+        nonSelfInteraction[jh] = !(nb_sci.shift == gmx::c_centralShiftIndex
+                                   & (tidxj + jh * c_wave64JAtomsPerLaneRow) <= tidxi);
+    }
+#    endif
+
+    /* loop over the j clusters = seen by any of the atoms in the current super-cluster;
+     * the two wavefront halves process the even and odd j-clusters of each cj4, resp.
+     */
+    for (j4 = cij4_start; j4 < cij4_end; ++j4)
+    {
+        /* imask and excl_ind are uniform over the wavefront, keep them in scalar registers */
+        imask = __builtin_amdgcn_readfirstlane(pl_cj4[j4].imei[0].imask);
+#    ifndef PRUNE_NBL
+        if (!imask)
+        {
+            continue;
+        }
+#    endif
+        wexcl_idx = __builtin_amdgcn_readfirstlane(pl_cj4[j4].imei[0].excl_ind);
+#        pragma unroll
+        for (jh = 0; jh < c_wave64JAtomsPerLane; jh++)
+        {
+            wexcl[jh] = excl[wexcl_idx].pair[(tidxj + jh * c_wave64JAtomsPerLaneRow) * c_clSize + tidxi];
+        }
+
+#       pragma unroll
+        for (jp = 0; jp < c_nbnxnGpuJgroupSize / c_wave64NumJClustersInFlight; jp++)
+        {
+            /* Note that from here on control flow can diverge between the wavefront halves */
+            jm = jp * c_wave64NumJClustersInFlight + tidxh;
+
+            const bool maskSet = imask & (superClInteractionMask << (jm * c_nbnxnGpuNumClusterPerSupercluster));
+            if (!maskSet)
+            {
+               continue;
+            }
+
+            mask_ji = (1U << (jm * c_nbnxnGpuNumClusterPerSupercluster));
+
+            cj = pl_cj4[j4].cj[jm];
+
+            /* load j atom data */
+#           pragma unroll
+            for (jh = 0; jh < c_wave64JAtomsPerLane; jh++)
+            {
+                aj[jh]   = cj * c_clSize + tidxj + jh * c_wave64JAtomsPerLaneRow;
+                xqbuf    = xq[aj[jh]];
+                xj[jh]   = make_fast_float3(xqbuf);
+                qj_f[jh] = xqbuf.w;
+#    ifndef LJ_COMB
+                typej[jh] = atom_types[aj[jh]];
+#    else
+                ljcp_j[jh] = lj_comb[aj[jh]];
+#    endif
+                fcj_buf[jh] = make_fast_float3(0.0F);
+            }
+
+#           pragma unroll c_nbnxnGpuNumClusterPerSupercluster
+            for (i = 0; i < c_nbnxnGpuNumClusterPerSupercluster; i++)
+            {
+                if (imask & mask_ji)
+                {
+                    ci = sci * c_nbnxnGpuNumClusterPerSupercluster + i; /* i cluster index */
+
+                    /* all threads load an atom from i cluster ci into shmem! */
+                    xqbuf = xqib[i * c_clSize + tidxi];
+                    xi    = make_fast_float3(xqbuf);
+                    qi    = xqbuf.w;
+#    ifndef LJ_COMB
+                    typei = atib[i * c_clSize + tidxi];
+#    else
+                    ljcp_i = ljcpib[i * c_clSize + tidxi];
+#    endif
+
+#    ifdef PRUNE_NBL
+                    /* If _none_ of the atoms pairs are in cutoff range,
+                       the bit corresponding to the current
+                       cluster-pair in imask gets set to 0. */
+                    if (!nb_any_wave64_half(norm2(xi + xj[0]) < rlist_sq
+                                                    || norm2(xi + xj[1]) < rlist_sq,
+                                            tidxh))
+                    {
+                        imask &= ~mask_ji;
+                    }
+#    endif
+
+#                   pragma unroll
+                    for (jh = 0; jh < c_wave64JAtomsPerLane; jh++)
+                    {
+                        /* distance between i and j atoms */
+                        rv = xi + xj[jh];
+                        r2 = norm2(rv);
+
+                        int_bit = (wexcl[jh] >> (jm * c_nbnxnGpuNumClusterPerSupercluster + i)) & 1;
+                        /* cutoff & exclusion check */
+#    ifdef EXCLUSION_FORCES
+                        if ((r2 < rcoulomb_sq) && (ci != (nonSelfInteraction[jh] ? -1 : cj)))
+#    else
+                        if ((r2 < rcoulomb_sq) * int_bit)
+#    endif
+                        {
+#    ifndef LJ_COMB
+                            /* LJ 6*C6 and 12*C12 */
+                            c6c12 = fetch_nbfp_c6_c12(nbparam, __mul24(ntypes, typei) + typej[jh]);
+#    else
+#        ifdef LJ_COMB_GEOM
+                            c6c12 = ljcp_i * ljcp_j[jh];
+#        else
+                            /* LJ 2^(1/6)*sigma and 12*epsilon */
+                            sigma   = ljcp_i.x + ljcp_j[jh].x;
+                            epsilon = ljcp_i.y * ljcp_j[jh].y;
+#            if defined CALC_ENERGIES || defined LJ_FORCE_SWITCH || defined LJ_POT_SWITCH
+                            c6c12 = convert_sigma_epsilon_to_c6_c12(sigma, epsilon);
+#            endif
+#        endif /* LJ_COMB_GEOM */
+#    endif     /* LJ_COMB */
+
+                            // Ensure distance do not become so small that r^-12 overflows
+                            r2 = fmax(r2, c_nbnxnMinDistanceSquared);
+
+                            inv_r  = __frsqrt_rn(r2);
+                            inv_r2 = inv_r * inv_r;
+#    if !defined LJ_COMB_LB || defined CALC_ENERGIES
+                            inv_r6 = inv_r2 * inv_r2 * inv_r2;
+#        ifdef EXCLUSION_FORCES
+                            /* We could mask inv_r2, but with Ewald
+                             * masking both inv_r6 and F_invr is faster */
+                            inv_r6 *= int_bit;
+#        endif /* EXCLUSION_FORCES */
+
+                            F_invr = inv_r6 * (c6c12.y * inv_r6 - c6c12.x) * inv_r2;
+#        if defined CALC_ENERGIES || defined LJ_POT_SWITCH
+                            E_lj_p = int_bit
+                                     * (c6c12.y * (inv_r6 * inv_r6 + nbparam.repulsion_shift.cpot) * c_oneTwelveth
+                                        - c6c12.x * (inv_r6 + nbparam.dispersion_shift.cpot) * c_oneSixth);
+#        endif
+#    else /* !LJ_COMB_LB || CALC_ENERGIES */
+                            float sig_r  = sigma * inv_r;
+                            float sig_r2 = sig_r * sig_r;
+                            float sig_r6 = sig_r2 * sig_r2 * sig_r2;
+#        ifdef EXCLUSION_FORCES
+                            sig_r6 *= int_bit;
+#        endif /* EXCLUSION_FORCES */
+
+                            F_invr = epsilon * sig_r6 * (sig_r6 - 1.0F) * inv_r2;
+#    endif     /* !LJ_COMB_LB || CALC_ENERGIES */
+
+#    ifdef LJ_FORCE_SWITCH
+#        ifdef CALC_ENERGIES
+                            calculate_force_switch_F_E(nbparam, c6c12, inv_r, r2, &F_invr, &E_lj_p);
+#        else
+                            calculate_force_switch_F(nbparam, c6c12, inv_r, r2, &F_invr);
+#        endif /* CALC_ENERGIES */
+#    endif     /* LJ_FORCE_SWITCH */
+
+
+#    ifdef LJ_EWALD
+#        ifdef LJ_EWALD_COMB_GEOM
+#            ifdef CALC_ENERGIES
+                            calculate_lj_ewald_comb_geom_F_E(
+                                    nbparam, typei, typej[jh], r2, inv_r2, lje_coeff2, lje_coeff6_6, int_bit, &F_invr, &E_lj_p);
+#            else
+                            calculate_lj_ewald_comb_geom_F(
+                                    nbparam, typei, typej[jh], r2, inv_r2, lje_coeff2, lje_coeff6_6, &F_invr);
+#            endif /* CALC_ENERGIES */
+#        elif defined LJ_EWALD_COMB_LB
+                            calculate_lj_ewald_comb_LB_F_E(nbparam,
+                                                           typei,
+                                                           typej[jh],
+                                                           r2,
+                                                           inv_r2,
+                                                           lje_coeff2,
+                                                           lje_coeff6_6,
+#            ifdef CALC_ENERGIES
+                                                           int_bit,
+                                                           &F_invr,
+                                                           &E_lj_p
+#            else
+                                                           0,
+                                                           &F_invr,
+                                                           nullptr
+#            endif /* CALC_ENERGIES */
+                            );
+#        endif     /* LJ_EWALD_COMB_GEOM */
+#    endif         /* LJ_EWALD */
+
+#    ifdef LJ_POT_SWITCH
+#        ifdef CALC_ENERGIES
+                            calculate_potential_switch_F_E(nbparam, inv_r, r2, &F_invr, &E_lj_p);
+#        else
+                            calculate_potential_switch_F(nbparam, inv_r, r2, &F_invr, &E_lj_p);
+#        endif /* CALC_ENERGIES */
+#    endif     /* LJ_POT_SWITCH */
+
+#    ifdef VDW_CUTOFF_CHECK
+                            /* Separate VDW cut-off check to enable twin-range cut-offs
+                             * (rvdw < rcoulomb <= rlist)
+                             */
+                            vdw_in_range = (r2 < rvdw_sq) ? 1.0F : 0.0F;
+                            F_invr *= vdw_in_range;
+#        ifdef CALC_ENERGIES
+                            E_lj_p *= vdw_in_range;
+#        endif
+#    endif /* VDW_CUTOFF_CHECK */
+
+#    ifdef CALC_ENERGIES
+                            E_lj += E_lj_p;
+#    endif
+
+
+#    ifdef EL_CUTOFF
+#        ifdef EXCLUSION_FORCES
+                            F_invr += qi * qj_f[jh] * int_bit * inv_r2 * inv_r;
+#        else
+                            F_invr += qi * qj_f[jh] * inv_r2 * inv_r;
+#        endif
+#    endif
+#    ifdef EL_RF
+                            F_invr += qi * qj_f[jh] * (int_bit * inv_r2 * inv_r - two_k_rf);
+#    endif
+#    if defined   EL_EWALD_ANA
+                            F_invr += qi * qj_f[jh]
+                                      * (int_bit * inv_r2 * inv_r + pmecorrF(beta2 * r2) * beta3);
+#    elif defined EL_EWALD_TAB
+                            F_invr += qi * qj_f[jh]
+                                      * (int_bit * inv_r2
+                                         - interpolate_coulomb_force_r(nbparam, r2 * inv_r))
+                                      * inv_r;
+#    endif /* EL_EWALD_ANA/TAB */
+
+#    ifdef CALC_ENERGIES
+#        ifdef EL_CUTOFF
+                            E_el += qi * qj_f[jh] * (int_bit * inv_r - reactionFieldShift);
+#        endif
+#        ifdef EL_RF
+                            E_el += qi * qj_f[jh]
+                                    * (int_bit * inv_r + 0.5F * two_k_rf * r2 - reactionFieldShift);
+#        endif
+#        ifdef EL_EWALD_ANY
+                            /* 1.0F - erff is faster than erfcf */
+                            E_el += qi * qj_f[jh]
+                                    * (inv_r * (int_bit - erff(r2 * inv_r * beta)) - int_bit * ewald_shift);
+#        endif /* EL_EWALD_ANY */
+#    endif
+                            f_ij = rv * F_invr;
+
+                            /* accumulate j forces in registers */
+                            fcj_buf[jh] = fcj_buf[jh] + f_ij;
+
+                            /* accumulate i forces in registers */
+                            fci_buf[i] = fci_buf[i] - f_ij;
+                        }
+                    }
+                }
+
+                /* shift the mask bit by 1 */
+                mask_ji += mask_ji;
+            }
+
+            /* reduce j forces, the 8-lane groups never cross a wavefront half */
+#           pragma unroll
+            for (jh = 0; jh < c_wave64JAtomsPerLane; jh++)
+            {
+                float r = reduce_force_j_warp_shfl(fcj_buf[jh], tidxi);
+                if (tidxi < 3)
+                {
+                    atomic_add_force(f, aj[jh], tidxi, r);
+                }
+            }
+        }
+#    ifdef PRUNE_NBL
+        /* Each half only cleared the bits of its own j-clusters, combine the two
+           halves and update the imask with the new one which does not contain the
+           out of range clusters anymore. */
+        imask &= __shfl_xor(imask, c_wave64HalfSize);
+        pl_cj4[j4].imei[0].imask = imask;
+#    endif
+    }
+
+    /* skip central shifts when summing shift forces */
+    if (nb_sci.shift == gmx::c_centralShiftIndex)
+    {
+        bCalcFshift = false;
+    }
+
+    float fshift_buf = 0.0F;
+    float fci[c_nbnxnGpuNumClusterPerSupercluster];
+
+    /* After the reduction, this lane holds component fciComponent (if >= 0)
+     * of the force on atom fciAtom of each i-cluster. */
+#    if GMX_HIP_NB_DPP_REDUCTION
+    const unsigned int fciAtom      = tidxi;
+    const int          fciComponent = reduce_force_i_dpp_component(tidxjw);
+#    else
+    const unsigned int fciAtom      = tidxjw;
+    const int          fciComponent = tidxi < 3 ? static_cast<int>(tidxi) : -1;
+#    endif
+
+    /* reduce i forces, tidxjw has the same lane position as tidxj in the regular kernel */
+    for (i = 0; i < c_nbnxnGpuNumClusterPerSupercluster; i++)
+    {
+#    if GMX_HIP_NB_DPP_REDUCTION
+        fci[i] = reduce_force_i_dpp(fci_buf[i], tidxjw);
+#    else
+        fci[i] = reduce_force_i_warp_shfl(fci_buf[i], tidxi, tidxjw);
+#    endif
+        fshift_buf += fci[i];
+    }
+    if (fciComponent >= 0)
+    {
+        for (i = 0; i < c_nbnxnGpuNumClusterPerSupercluster; i++)
+        {
+            ai = (sci * c_nbnxnGpuNumClusterPerSupercluster + i) * c_clSize + fciAtom;
+            atomic_add_force(f, ai, fciComponent, fci[i]);
+        }
+    }
+
+    /* add up local shift forces into global mem, tidxi indexes x,y,z */
+    if (bCalcFshift)
+    {
+#ifdef GMX_ENABLE_MEMORY_MULTIPLIER
+        const unsigned int shift_index_base = gmx::c_numShiftVectors * (1 + (bidx & (c_clShiftMemoryMultiplier - 1)));
+#else
+        const unsigned int shift_index_base = 0;
+#endif
+        if (fciComponent >= 0)
+        {
+            float3* fShift = asFloat3(atdat.fShift);
+            atomic_add_force(fShift, nb_sci.shift + shift_index_base, fciComponent, fshift_buf);
+        }
+    }
+
+#    ifdef CALC_ENERGIES
+    /* reduce the energies over the wavefront and store into global memory */
+    reduce_energy_warp_shfl(E_lj, E_el, e_lj, e_el, tidxjw * c_clSize + tidxi);
+#    endif
+}
+#endif /* FUNCTION_DECLARATION_ONLY */
+
+#undef MIN_BLOCKS_PER_MP
+#undef THREADS_PER_BLOCK
+
+#undef EL_EWALD_ANY
+#undef EXCLUSION_FORCES
+#undef LJ_EWALD
+
+#undef LJ_COMB
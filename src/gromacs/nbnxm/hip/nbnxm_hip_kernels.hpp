@@ -46,6 +46,13 @@
  *  require an extra distance check to enable  PP-PME load balancing
  *  (otherwise, by default rcoul == rvdw).
  *
+ *  When NB_WAVE64_LAYOUT is defined, the wave64-native kernel flavors of
+ *  nbnxm_hip_kernel_wave64.hpp are generated instead of the regular ones.
+ *  When NB_PACKED_XQ is defined, the regular kernels are generated with the
+ *  j-atom coordinates read from the packed 16-bit cluster offsets.
+ *  When NB_ICLUSTER_IN_REGISTERS is defined, the regular kernels are generated
+ *  with the i-cluster data kept in registers instead of shared memory.
+ *
  *  NOTE: No include fence as it is meant to be included multiple times.
  *
  *  \author Szilárd Páll <pall.szilard@gmail.com>
@@ -53,48 +60,54 @@
  *  \ingroup module_nbnxm
  */
 
+#ifdef NB_WAVE64_LAYOUT
+#    define NB_KERNEL_BODY "nbnxm_hip_kernel_wave64.hpp"
+#else
+#    define NB_KERNEL_BODY "nbnxm_hip_kernel.hpp"
+#endif
+
 /* Analytical plain cut-off electrostatics kernels
  */
 #define EL_CUTOFF
 
 /* cut-off + V shift LJ */
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecCut_VdwLJ##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef NB_KERNEL_FUNC_NAME
 /* cut-off + V shift LJ w geometric combination rules */
 #define LJ_COMB_GEOM
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecCut_VdwLJCombGeom##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_COMB_GEOM
 #undef NB_KERNEL_FUNC_NAME
 /* cut-off + V shift LJ w LB combination rules */
 #define LJ_COMB_LB
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecCut_VdwLJCombLB##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_COMB_LB
 #undef NB_KERNEL_FUNC_NAME
 /* LJ-Ewald w geometric combination rules */
 #define LJ_EWALD_COMB_GEOM
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecCut_VdwLJEwCombGeom##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_EWALD_COMB_GEOM
 #undef NB_KERNEL_FUNC_NAME
 /* LJ-Ewald w LB combination rules */
 #define LJ_EWALD_COMB_LB
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecCut_VdwLJEwCombLB##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_EWALD_COMB_LB
 #undef NB_KERNEL_FUNC_NAME
 /* F switch LJ */
 #define LJ_FORCE_SWITCH
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecCut_VdwLJFsw##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_FORCE_SWITCH
 #undef NB_KERNEL_FUNC_NAME
 /* V switch LJ */
 #define LJ_POT_SWITCH
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecCut_VdwLJPsw##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_POT_SWITCH
 #undef NB_KERNEL_FUNC_NAME
 
@@ -107,42 +120,42 @@
 
 /* cut-off + V shift LJ */
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecRF_VdwLJ##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef NB_KERNEL_FUNC_NAME
 /* cut-off + V shift LJ w geometric combination rules */
 #define LJ_COMB_GEOM
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecRF_VdwLJCombGeom##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_COMB_GEOM
 #undef NB_KERNEL_FUNC_NAME
 /* cut-off + V shift LJ w LB combination rules */
 #define LJ_COMB_LB
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecRF_VdwLJCombLB##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_COMB_LB
 #undef NB_KERNEL_FUNC_NAME
 /* LJ-Ewald w geometric combination rules */
 #define LJ_EWALD_COMB_GEOM
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecRF_VdwLJEwCombGeom##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_EWALD_COMB_GEOM
 #undef NB_KERNEL_FUNC_NAME
 /* LJ-Ewald w LB combination rules */
 #define LJ_EWALD_COMB_LB
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecRF_VdwLJEwCombLB##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_EWALD_COMB_LB
 #undef NB_KERNEL_FUNC_NAME
 /* F switch LJ */
 #define LJ_FORCE_SWITCH
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecRF_VdwLJFsw##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_FORCE_SWITCH
 #undef NB_KERNEL_FUNC_NAME
 /* V switch LJ */
 #define LJ_POT_SWITCH
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecRF_VdwLJPsw##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_POT_SWITCH
 #undef NB_KERNEL_FUNC_NAME
 
@@ -155,42 +168,42 @@
 
 /* cut-off + V shift LJ */
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEw_VdwLJ##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef NB_KERNEL_FUNC_NAME
 /* cut-off + V shift LJ w geometric combination rules */
 #define LJ_COMB_GEOM
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEw_VdwLJCombGeom##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_COMB_GEOM
 #undef NB_KERNEL_FUNC_NAME
 /* cut-off + V shift LJ w LB combination rules */
 #define LJ_COMB_LB
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEw_VdwLJCombLB##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_COMB_LB
 #undef NB_KERNEL_FUNC_NAME
 /* LJ-Ewald w geometric combination rules */
 #define LJ_EWALD_COMB_GEOM
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEw_VdwLJEwCombGeom##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_EWALD_COMB_GEOM
 #undef NB_KERNEL_FUNC_NAME
 /* LJ-Ewald w LB combination rules */
 #define LJ_EWALD_COMB_LB
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEw_VdwLJEwCombLB##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_EWALD_COMB_LB
 #undef NB_KERNEL_FUNC_NAME
 /* F switch LJ */
 #define LJ_FORCE_SWITCH
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEw_VdwLJFsw##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_FORCE_SWITCH
 #undef NB_KERNEL_FUNC_NAME
 /* V switch LJ */
 #define LJ_POT_SWITCH
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEw_VdwLJPsw##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_POT_SWITCH
 #undef NB_KERNEL_FUNC_NAME
 
@@ -204,42 +217,42 @@
 
 /* cut-off + V shift LJ */
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwTwinCut_VdwLJ##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef NB_KERNEL_FUNC_NAME
 /* cut-off + V shift LJ w geometric combination rules */
 #define LJ_COMB_GEOM
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwTwinCut_VdwLJCombGeom##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_COMB_GEOM
 #undef NB_KERNEL_FUNC_NAME
 /* cut-off + V shift LJ w LB combination rules */
 #define LJ_COMB_LB
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwTwinCut_VdwLJCombLB##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_COMB_LB
 #undef NB_KERNEL_FUNC_NAME
 /* LJ-Ewald w geometric combination rules */
 #define LJ_EWALD_COMB_GEOM
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwTwinCut_VdwLJEwCombGeom##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_EWALD_COMB_GEOM
 #undef NB_KERNEL_FUNC_NAME
 /* LJ-Ewald w LB combination rules */
 #define LJ_EWALD_COMB_LB
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwTwinCut_VdwLJEwCombLB##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_EWALD_COMB_LB
 #undef NB_KERNEL_FUNC_NAME
 /* F switch LJ */
 #define LJ_FORCE_SWITCH
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwTwinCut_VdwLJFsw##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_FORCE_SWITCH
 #undef NB_KERNEL_FUNC_NAME
 /* V switch LJ */
 #define LJ_POT_SWITCH
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwTwinCut_VdwLJPsw##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_POT_SWITCH
 #undef NB_KERNEL_FUNC_NAME
 
@@ -252,42 +265,42 @@
 
 /* cut-off + V shift LJ */
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTab_VdwLJ##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef NB_KERNEL_FUNC_NAME
 /* cut-off + V shift LJ w geometric combination rules */
 #define LJ_COMB_GEOM
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTab_VdwLJCombGeom##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_COMB_GEOM
 #undef NB_KERNEL_FUNC_NAME
 /* cut-off + V shift LJ w LB combination rules */
 #define LJ_COMB_LB
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTab_VdwLJCombLB##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_COMB_LB
 #undef NB_KERNEL_FUNC_NAME
 /* LJ-Ewald w geometric combination rules */
 #define LJ_EWALD_COMB_GEOM
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTab_VdwLJEwCombGeom##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_EWALD_COMB_GEOM
 #undef NB_KERNEL_FUNC_NAME
 /* LJ-Ewald w LB combination rules */
 #define LJ_EWALD_COMB_LB
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTab_VdwLJEwCombLB##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_EWALD_COMB_LB
 #undef NB_KERNEL_FUNC_NAME
 /* F switch LJ */
 #define LJ_FORCE_SWITCH
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTab_VdwLJFsw##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_FORCE_SWITCH
 #undef NB_KERNEL_FUNC_NAME
 /* V switch LJ */
 #define LJ_POT_SWITCH
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTab_VdwLJPsw##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_POT_SWITCH
 #undef NB_KERNEL_FUNC_NAME
 
@@ -300,44 +313,46 @@
 
 /* cut-off + V shift LJ */
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTabTwinCut_VdwLJ##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef NB_KERNEL_FUNC_NAME
 /* cut-off + V shift LJ w geometric combination rules */
 #define LJ_COMB_GEOM
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTabTwinCut_VdwLJCombGeom##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_COMB_GEOM
 #undef NB_KERNEL_FUNC_NAME
 /* cut-off + V shift LJ w LB combination rules */
 #define LJ_COMB_LB
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTabTwinCut_VdwLJCombLB##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_COMB_LB
 #undef NB_KERNEL_FUNC_NAME
 /* LJ-Ewald w geometric combination rules */
 #define LJ_EWALD_COMB_GEOM
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTabTwinCut_VdwLJEwCombGeom##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_EWALD_COMB_GEOM
 #undef NB_KERNEL_FUNC_NAME
 /* LJ-Ewald w LB combination rules */
 #define LJ_EWALD_COMB_LB
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTabTwinCut_VdwLJEwCombLB##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_EWALD_COMB_LB
 #undef NB_KERNEL_FUNC_NAME
 /* F switch LJ */
 #define LJ_FORCE_SWITCH
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTabTwinCut_VdwLJFsw##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_FORCE_SWITCH
 #undef NB_KERNEL_FUNC_NAME
 /* V switch LJ */
 #define LJ_POT_SWITCH
 #define NB_KERNEL_FUNC_NAME(x, ...) x##_ElecEwQSTabTwinCut_VdwLJPsw##__VA_ARGS__
-#include "nbnxm_hip_kernel.hpp"
+#include NB_KERNEL_BODY
 #undef LJ_POT_SWITCH
 #undef NB_KERNEL_FUNC_NAME
 
 #undef EL_EWALD_TAB
 #undef VDW_CUTOFF_CHECK
+
+#undef NB_KERNEL_BODY
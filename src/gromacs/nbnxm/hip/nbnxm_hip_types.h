@@ -46,6 +46,8 @@
 #ifndef NBNXM_HIP_TYPES_H
 #define NBNXM_HIP_TYPES_H
 
+#include <string>
+
 #include "gromacs/gpu_utils/hip_arch_utils.hpp"
 #include "gromacs/gpu_utils/hiputils.hpp"
 #include "gromacs/gpu_utils/devicebuffer.h"
@@ -119,6 +121,39 @@ struct NbnxmGpu
     NBStagingData nbst;
     /*! \brief local and non-local GPU streams */
     gmx::EnumerationArray<Nbnxm::InteractionLocality, const DeviceStream*> deviceStreams;
+    /*! \brief Lower-priority stream for rolling pruning, nullptr when pruning is
+     * done in the local/non-local streams. */
+    DeviceStream* rollingPruneStream = nullptr;
+    /*! \brief Events marked when the coordinates used by the non-bonded kernel of the
+     * respective locality are ready, the rolling pruning can start from there. */
+    gmx::EnumerationArray<Nbnxm::InteractionLocality, GpuEventSynchronizer> xqReadyForRollingPrune;
+    /*! \brief Events marked when the rolling pruning in the respective locality is done */
+    gmx::EnumerationArray<Nbnxm::InteractionLocality, GpuEventSynchronizer> rollingPruneDone;
+
+    /*! \brief True if the force kernels read the packed 16-bit j-coordinates
+     * (experimental, set with the GMX_HIP_NB_PACKED_XQ environment variable). */
+    bool usePackedXq = false;
+    //! number of elements in atdat->xqPacked
+    int xqPackedSize = -1;
+    //! number of elements allocated in atdat->xqPacked
+    int xqPackedSizeAlloc = -1;
+    //! number of elements in atdat->xClusterCenter
+    int xClusterCenterSize = -1;
+    //! number of elements allocated in atdat->xClusterCenter
+    int xClusterCenterSizeAlloc = -1;
+
+    /*! \brief True if the super-cluster list is sorted by decreasing cost after each
+     * prune, so the heaviest work is started first (disabled with GMX_HIP_NB_DISABLE_SCI_SORT). */
+    bool sortSciByCost = true;
+
+    /*! \brief True if the force kernels keep the i-cluster data in registers instead of
+     * shared memory, see select_nbnxn_icluster_registers(). */
+    bool useIClusterRegisters = false;
+
+    //! index into c_nbKernelVariants of the launch configuration of the regular-layout kernels
+    int kernelVariant = 0;
+    //! description of the kernel variant choice for the log, empty when there is no choice
+    std::string kernelVariantDescription;
 
     /*! \brief Event triggered when the non-local non-bonded
      * kernel is done (and the local transfer can proceed) */
@@ -114,7 +114,8 @@ CoulombKernelType getCoulombKernelType(Nbnxm::EwaldExclusionType ewaldExclusionT
  * \p vdwktNR is the number of VdW treatments for the SIMD kernels.
  * \p vdwktNR_ref is the number of VdW treatments for the C reference kernels.
  * These two numbers differ, because currently only the reference kernels
- * support LB combination rules for the LJ-Ewald grid part.
+ * support LB combination rules for the LJ-Ewald grid part and
+ * user supplied (tabulated) Van der Waals interactions.
  */
 enum
 {
@@ -125,8 +126,9 @@ enum
     vdwktLJPOTSWITCH,
     vdwktLJEWALDCOMBGEOM,
     vdwktLJEWALDCOMBLB,
-    vdwktNR = vdwktLJEWALDCOMBLB,
-    vdwktNR_ref
+    vdwktUSERTAB,
+    vdwktNR     = vdwktLJEWALDCOMBLB,
+    vdwktNR_ref = vdwktUSERTAB + 1
 };
 
 //! \brief Lookup function for Vdw kernel type
@@ -36,6 +36,9 @@
 
 #include "gmxpre.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "gromacs/gmxlib/nrnb.h"
 #include "gromacs/math/vectypes.h"
 #include "gromacs/mdlib/enerdata_utils.h"
@@ -76,6 +79,8 @@
 #undef INCLUDE_FUNCTION_TABLES
 
 /*! \brief Clears the energy group output buffers
+ *
+ * The SIMD energy buffers are cleared by clearUsedGroupEnergySimdBlocks().
  *
  * \param[in,out] out  nbnxn kernel output struct
  */
@@ -83,15 +88,100 @@ static void clearGroupEnergies(nbnxn_atomdata_output_t* out)
 {
     std::fill(out->Vvdw.begin(), out->Vvdw.end(), 0.0_real);
     std::fill(out->Vc.begin(), out->Vc.end(), 0.0_real);
-    std::fill(out->VSvdw.begin(), out->VSvdw.end(), 0.0_real);
-    std::fill(out->VSc.begin(), out->VSc.end(), 0.0_real);
+}
+
+/*! \brief Determines and clears the group-pair blocks of the SIMD energy buffers used by a list
+ *
+ * The SIMD energy buffers have a block for each i-group vs combination
+ * of the groups of two j-atoms. Their number grows with the cube of
+ * the number of energy groups, but only the blocks for group pairs that
+ * occur in the pairlist are written by the kernel. Here we collect those
+ * from the cluster groups in the list, so clearing and reducing the
+ * buffers only costs work for the group pairs that actually interact.
+ *
+ * \tparam        unrollj     The unroll size for j-particles in the SIMD kernel
+ * \param[in]     pairlist    The pairlist that the kernel will process
+ * \param[in]     nbatParams  The atom data parameters, with the packed energy groups
+ * \param[in,out] out         Struct with energy buffers
+ */
+template<int unrollj>
+static void clearUsedGroupEnergySimdBlocks(const NbnxnPairlistCpu&         pairlist,
+                                           const nbnxn_atomdata_t::Params& nbatParams,
+                                           nbnxn_atomdata_output_t*        out)
+{
+    const int iShift = nbatParams.neg_2log;
+    const int iMask  = (1 << iShift) - 1;
+    const int jShift = 2 * nbatParams.neg_2log;
+    const int jMask  = (1 << jShift) - 1;
+    /* The number of blocks per i-group, the two j-groups are stored with size 2^neg_2log */
+    const int numBlocksPerIGroup = nbatParams.nenergrp * (1 << nbatParams.neg_2log);
+    /* The energy groups of two j-atoms are packed in one combination index */
+    constexpr int c_numJPairsPerCluster = unrollj / 2;
+
+    std::vector<bool>& blockIsUsed = out->simdEnergyBlockIsUsed;
+    std::vector<int>&  usedBlocks  = out->usedSimdEnergyBlocks;
+    usedBlocks.clear();
+
+    auto markBlock = [&blockIsUsed, &usedBlocks](int block) {
+        if (!blockIsUsed[block])
+        {
+            blockIsUsed[block] = true;
+            usedBlocks.push_back(block);
+        }
+    };
+
+    const int* energrp = nbatParams.energrp.data();
+
+    for (const nbnxn_ci_t& ciEntry : pairlist.ci)
+    {
+        /* Collect the distinct groups of the i-cluster, usually only one */
+        const int egps_i = energrp[ciEntry.ci];
+        int       iGroupOffsets[c_nbnxnCpuIClusterSize];
+        int       numIGroups = 0;
+        for (int ia = 0; ia < c_nbnxnCpuIClusterSize; ia++)
+        {
+            const int iGroup       = (egps_i >> (ia * iShift)) & iMask;
+            const int iGroupOffset = iGroup * numBlocksPerIGroup;
+            if (std::find(iGroupOffsets, iGroupOffsets + numIGroups, iGroupOffset)
+                == iGroupOffsets + numIGroups)
+            {
+                iGroupOffsets[numIGroups++] = iGroupOffset;
+            }
+            /* The self-interaction terms are added to the block of the i-group with itself */
+            markBlock(iGroupOffset + iGroup);
+        }
+
+        for (int cjIndex = ciEntry.cj_ind_start; cjIndex < ciEntry.cjIndEnd(); cjIndex++)
+        {
+            const int cj = pairlist.cj[cjIndex].cj;
+            for (int p = 0; p < c_numJPairsPerCluster; p++)
+            {
+                /* Energy groups are stored per i-cluster, two j-atom pairs per entry */
+                const int jPair   = cj * c_numJPairsPerCluster + p;
+                const int egps_j  = energrp[jPair >> 1];
+                const int jGroups = (egps_j >> ((jPair & 1) * jShift)) & jMask;
+                for (int i = 0; i < numIGroups; i++)
+                {
+                    markBlock(iGroupOffsets[i] + jGroups);
+                }
+            }
+        }
+    }
+
+    constexpr int c_blockSize = (unrollj / 2) * unrollj;
+    for (const int block : usedBlocks)
+    {
+        std::fill_n(out->VSvdw.begin() + block * c_blockSize, c_blockSize, 0.0_real);
+        std::fill_n(out->VSc.begin() + block * c_blockSize, c_blockSize, 0.0_real);
+    }
 }
 
 /*! \brief Reduce the group-pair energy buffers produced by a SIMD kernel
  * to single terms in the output buffers.
  *
  * The SIMD kernels produce a large number of energy buffer in SIMD registers
- * to avoid scattered reads and writes.
+ * to avoid scattered reads and writes. Only the blocks collected by
+ * clearUsedGroupEnergySimdBlocks() are reduced.
  *
  * \tparam        unrollj         The unroll size for j-particles in the SIMD kernel
  * \param[in]     numGroups       The number of energy groups
@@ -103,33 +193,34 @@ static void reduceGroupEnergySimdBuffers(int numGroups, int numGroups_2log, nbnx
 {
     const int unrollj_half = unrollj / 2;
     /* Energies are stored in SIMD registers with size 2^numGroups_2log */
-    const int numGroupsStorage = (1 << numGroups_2log);
+    const int numGroupsStorage   = (1 << numGroups_2log);
+    const int numBlocksPerIGroup = numGroups * numGroupsStorage;
 
     const real* gmx_restrict vVdwSimd     = out->VSvdw.data();
     const real* gmx_restrict vCoulombSimd = out->VSc.data();
     real* gmx_restrict       vVdw         = out->Vvdw.data();
     real* gmx_restrict       vCoulomb     = out->Vc.data();
 
-    /* The size of the SIMD energy group buffer array is:
-     * numGroups*numGroups*numGroupsStorage*unrollj_half*simd_width
+    /* The SIMD energy group buffer array consists of blocks of size
+     * unrollj_half*simd_width, indexed as (i*numGroups + j1)*numGroupsStorage + j0
      */
-    for (int i = 0; i < numGroups; i++)
+    for (const int block : out->usedSimdEnergyBlocks)
     {
-        for (int j1 = 0; j1 < numGroups; j1++)
+        const int i  = block / numBlocksPerIGroup;
+        const int j1 = (block % numBlocksPerIGroup) / numGroupsStorage;
+        const int j0 = block % numGroupsStorage;
+
+        int c = block * unrollj_half * unrollj;
+        for (int s = 0; s < unrollj_half; s++)
         {
-            for (int j0 = 0; j0 < numGroups; j0++)
-            {
-                int c = ((i * numGroups + j1) * numGroupsStorage + j0) * unrollj_half * unrollj;
-                for (int s = 0; s < unrollj_half; s++)
-                {
-                    vVdw[i * numGroups + j0] += vVdwSimd[c + 0];
-                    vVdw[i * numGroups + j1] += vVdwSimd[c + 1];
-                    vCoulomb[i * numGroups + j0] += vCoulombSimd[c + 0];
-                    vCoulomb[i * numGroups + j1] += vCoulombSimd[c + 1];
-                    c += unrollj + 2;
-                }
-            }
+            vVdw[i * numGroups + j0] += vVdwSimd[c + 0];
+            vVdw[i * numGroups + j1] += vVdwSimd[c + 1];
+            vCoulomb[i * numGroups + j0] += vCoulombSimd[c + 0];
+            vCoulomb[i * numGroups + j1] += vCoulombSimd[c + 1];
+            c += unrollj + 2;
         }
+
+        out->simdEnergyBlockIsUsed[block] = false;
     }
 }
 
@@ -213,6 +304,13 @@ int getVdwKernelType(const Nbnxm::KernelType    kernelType,
             return vdwktLJEWALDCOMBLB;
         }
     }
+    else if (vanDerWaalsType == VanDerWaalsType::User)
+    {
+        /* At setup we (should have) selected the C reference kernel */
+        GMX_RELEASE_ASSERT(kernelType == Nbnxm::KernelType::Cpu4x4_PlainC,
+                           "Only the C reference nbnxn kernel supports user VdW tables");
+        return vdwktUSERTAB;
+    }
     else
     {
         std::string errorMsg = gmx::formatString("Unsupported VdW interaction type %s (%d)",
@@ -337,46 +435,30 @@ static void nbnxn_kernel_cpu(const PairlistSet&             pairlistSet,
             /* Calculate energy group contributions */
             clearGroupEnergies(out);
 
-            int unrollj = 0;
-
             switch (kernelSetup.kernelType)
             {
                 case Nbnxm::KernelType::Cpu4x4_PlainC:
-                    unrollj = c_nbnxnCpuIClusterSize;
                     nbnxn_kernel_energrp_ref[coulkt][vdwkt](pairlist, nbat, &ic, shiftVecPointer, out);
                     break;
 #ifdef GMX_NBNXN_SIMD_2XNN
                 case Nbnxm::KernelType::Cpu4xN_Simd_2xNN:
-                    unrollj = GMX_SIMD_REAL_WIDTH / 2;
+                    clearUsedGroupEnergySimdBlocks<GMX_SIMD_REAL_WIDTH / 2>(*pairlist, nbatParams, out);
                     nbnxm_kernel_energrp_simd_2xmm[coulkt][vdwkt](
                             pairlist, nbat, &ic, shiftVecPointer, out);
+                    reduceGroupEnergySimdBuffers<GMX_SIMD_REAL_WIDTH / 2>(
+                            nbatParams.nenergrp, nbatParams.neg_2log, out);
                     break;
 #endif
 #ifdef GMX_NBNXN_SIMD_4XN
                 case Nbnxm::KernelType::Cpu4xN_Simd_4xN:
-                    unrollj = GMX_SIMD_REAL_WIDTH;
+                    clearUsedGroupEnergySimdBlocks<GMX_SIMD_REAL_WIDTH>(*pairlist, nbatParams, out);
                     nbnxm_kernel_energrp_simd_4xm[coulkt][vdwkt](pairlist, nbat, &ic, shiftVecPointer, out);
+                    reduceGroupEnergySimdBuffers<GMX_SIMD_REAL_WIDTH>(
+                            nbatParams.nenergrp, nbatParams.neg_2log, out);
                     break;
 #endif
                 default: GMX_RELEASE_ASSERT(false, "Unsupported kernel architecture");
             }
-
-            if (kernelSetup.kernelType != Nbnxm::KernelType::Cpu4x4_PlainC)
-            {
-                switch (unrollj)
-                {
-                    case 2:
-                        reduceGroupEnergySimdBuffers<2>(nbatParams.nenergrp, nbatParams.neg_2log, out);
-                        break;
-                    case 4:
-                        reduceGroupEnergySimdBuffers<4>(nbatParams.nenergrp, nbatParams.neg_2log, out);
-                        break;
-                    case 8:
-                        reduceGroupEnergySimdBuffers<8>(nbatParams.nenergrp, nbatParams.neg_2log, out);
-                        break;
-                    default: GMX_RELEASE_ASSERT(false, "Unsupported j-unroll size");
-                }
-            }
         }
     }
     wallcycle_sub_stop(wcycle, WallCycleSubCounter::NonbondedKernel);
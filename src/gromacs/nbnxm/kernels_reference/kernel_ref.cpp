@@ -73,6 +73,9 @@
 #undef LJ_EWALD_COMB_LB
 #undef LJ_CUT
 #undef LJ_EWALD
+#define LJ_USER_TAB
+#include "kernel_ref_includes.h"
+#undef LJ_USER_TAB
 #undef CALC_COUL_RF
 
 
@@ -97,6 +100,9 @@
 #undef LJ_EWALD_COMB_LB
 #undef LJ_CUT
 #undef LJ_EWALD
+#define LJ_USER_TAB
+#include "kernel_ref_includes.h"
+#undef LJ_USER_TAB
 /* Twin-range cut-off kernels */
 #define VDW_CUTOFF_CHECK
 #define LJ_CUT
@@ -118,5 +124,8 @@
 #undef LJ_EWALD_COMB_LB
 #undef LJ_CUT
 #undef LJ_EWALD
+#define LJ_USER_TAB
+#include "kernel_ref_includes.h"
+#undef LJ_USER_TAB
 #undef VDW_CUTOFF_CHECK
 #undef CALC_COUL_TAB
@@ -55,7 +55,7 @@
 
         for (int j = 0; j < UNROLLJ; j++)
         {
-            real FrLJ6 = 0, FrLJ12 = 0, frLJ = 0;
+            real gmx_unused FrLJ6 = 0, FrLJ12 = 0, frLJ = 0;
 
             /* A multiply mask used to zero an interaction
              * when either the distance cutoff is exceeded, or
@@ -129,6 +129,41 @@
 #    endif
 #endif
 
+#ifdef LJ_USER_TAB
+                {
+                    /* Cubic spline table lookup of dispersion and repulsion.
+                     * r is zero beyond the cut-off, as rinv is masked.
+                     */
+#    ifdef VDW_CUTOFF_CHECK
+                    /* The table only covers the VdW cut-off */
+                    const real r_tab = (rsq < rvdw2) ? rsq * rinv : 0;
+#    else
+                    const real r_tab = rsq * rinv;
+#    endif
+                    const real rt   = r_tab * tab_vdw_scale;
+                    const int  ri   = int(rt);
+                    const real eps  = rt - static_cast<real>(ri);
+                    const real eps2 = eps * eps;
+
+                    const real* tab = tab_vdw_YFGH + ri * 8;
+
+                    const real GepsD  = eps * tab[2];
+                    const real Heps2D = eps2 * tab[3];
+                    const real FpD    = tab[1] + GepsD + Heps2D;
+                    const real FFD    = FpD + GepsD + 2 * Heps2D;
+
+                    const real GepsR  = eps * tab[6];
+                    const real Heps2R = eps2 * tab[7];
+                    const real FpR    = tab[5] + GepsR + Heps2R;
+                    const real FFR    = FpR + GepsR + 2 * Heps2R;
+
+                    frLJ = -interact * (c6 * FFD + c12 * FFR) * tab_vdw_scale * r_tab;
+#    ifdef CALC_ENERGIES
+                    VLJ = c6 * (tab[0] + eps * FpD) + c12 * (tab[4] + eps * FpR);
+#    endif
+                }
+#endif
+
 #if defined LJ_FORCE_SWITCH || defined LJ_POT_SWITCH
                 /* Force or potential switching from ic->rvdw_switch */
                 real r   = rsq * rinv;
@@ -78,6 +78,8 @@ static_assert(UNROLLI == c_nbnxnCpuIClusterSize, "UNROLLI should match the i-clu
 #    else
 #        define NBK_FUNC_NAME(feg) NBK_FUNC_NAME2(_VdwLJEwCombLB, feg)
 #    endif
+#elif defined LJ_USER_TAB
+#    define NBK_FUNC_NAME(feg) NBK_FUNC_NAME2(_VdwUserTab, feg)
 #else
 #    error "No VdW type defined"
 #endif
@@ -139,6 +141,11 @@ void
     const real* ljc = nbatParams.nbfp_comb.data();
 #endif
 
+#ifdef LJ_USER_TAB
+    const real  tab_vdw_scale = ic->vdwUserTable->scale;
+    const real* tab_vdw_YFGH  = ic->vdwUserTable->tableYFGH.data();
+#endif
+
 #ifdef CALC_COUL_RF
     const real k_rf2 = 2 * ic->reactionFieldCoefficient;
 #    ifdef CALC_ENERGIES
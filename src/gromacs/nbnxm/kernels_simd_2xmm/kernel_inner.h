@@ -212,6 +212,15 @@
     const int ajy = ajx + STRIDE;
     const int ajz = ajy + STRIDE;
 
+    /* Prefetch the coordinates of a j-cluster further down the list */
+    if (jClusterPrefetchDistance > 0 && cjind + jClusterPrefetchDistance < numJClusterEntries)
+    {
+        const int ajxPrefetch = l_cj[cjind + jClusterPrefetchDistance].cj * UNROLLJ * DIM;
+        simdPrefetch(x + ajxPrefetch);
+        simdPrefetch(x + ajxPrefetch + STRIDE);
+        simdPrefetch(x + ajxPrefetch + 2 * STRIDE);
+    }
+
 #ifdef CHECK_EXCLS
     gmx_load_simd_2xnn_interactions(
             static_cast<int>(l_cj[cjind].excl), filter_S0, filter_S2, &interact_S0, &interact_S2);
@@ -262,6 +262,20 @@
     const int ajy = ajx + STRIDE;
     const int ajz = ajy + STRIDE;
 
+    /* Prefetch the coordinates of a j-cluster further down the list */
+    if (jClusterPrefetchDistance > 0 && cjind + jClusterPrefetchDistance < numJClusterEntries)
+    {
+        const int cjPrefetch = l_cj[cjind + jClusterPrefetchDistance].cj;
+#    if UNROLLJ == STRIDE
+        const int ajxPrefetch = cjPrefetch * UNROLLJ * DIM;
+#    else
+        const int ajxPrefetch = (cjPrefetch >> 1) * DIM * STRIDE + (cjPrefetch & 1) * UNROLLJ;
+#    endif
+        simdPrefetch(x + ajxPrefetch);
+        simdPrefetch(x + ajxPrefetch + STRIDE);
+        simdPrefetch(x + ajxPrefetch + 2 * STRIDE);
+    }
+
 #    ifdef CHECK_EXCLS
     gmx_load_simd_4xn_interactions(static_cast<int>(l_cj[cjind].excl),
                                    filter_S0,
@@ -352,6 +352,10 @@
 
     const nbnxn_cj_t* l_cj = nbl->cj.data();
 
+    /* For prefetching of j-coordinates in kernel_inner.h */
+    const int jClusterPrefetchDistance = nbat->simdJClusterPrefetchDistance;
+    const int numJClusterEntries       = nbl->cj.size();
+
     for (const nbnxn_ci_t& ciEntry : nbl->ci)
     {
         const int ish    = (ciEntry.shift & NBNXN_CI_SHIFT);
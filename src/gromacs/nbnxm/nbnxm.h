@@ -316,8 +316,15 @@ public:
                            int64_t                      step,
                            t_nrnb*                      nrnb) const;
 
-    //! Updates all the atom properties in Nbnxm
-    void setAtomProperties(gmx::ArrayRef<const int>     atomTypes,
+    /*!\brief Updates the atom properties in Nbnxm for the given locality.
+     *
+     * \param[in] locality     Whether properties of all, local or non-local atoms should be set.
+     * \param[in] atomTypes    The atom types, indexed by atom.
+     * \param[in] atomCharges  The atom charges, indexed by atom.
+     * \param[in] atomInfo     The atom information flags, indexed by atom.
+     */
+    void setAtomProperties(gmx::AtomLocality            locality,
+                           gmx::ArrayRef<const int>     atomTypes,
                            gmx::ArrayRef<const real>    atomCharges,
                            gmx::ArrayRef<const int64_t> atomInfo) const;
 
@@ -461,6 +468,20 @@ std::unique_ptr<nonbonded_verlet_t> init_nb_verlet(const gmx::MDLogger& mdlog,
                                                    matrix                          box,
                                                    gmx_wallcycle*                  wcycle);
 
+/*! \brief Creates an Nbnxm object for CPU non-bondeds with a given kernel setup
+ *
+ * This is used to switch between CPU cluster layouts at run time.
+ * Only single-domain CPU kernel setups are supported.
+ */
+std::unique_ptr<nonbonded_verlet_t> init_nb_verlet(const gmx::MDLogger&      mdlog,
+                                                   const t_inputrec&         inputrec,
+                                                   const t_forcerec&         forcerec,
+                                                   const t_commrec*          commrec,
+                                                   const Nbnxm::KernelSetup& kernelSetup,
+                                                   const gmx_mtop_t&         mtop,
+                                                   matrix                    box,
+                                                   gmx_wallcycle*            wcycle);
+
 } // namespace Nbnxm
 
 /*! \brief Put the atoms on the pair search grid.
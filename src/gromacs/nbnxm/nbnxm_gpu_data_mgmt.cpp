@@ -258,6 +258,7 @@ static inline void init_timings(gmx_wallclock_gpu_nbnxn_t* t)
     t->pl_h2d_c = 0;
     for (int i = 0; i < 2; i++)
     {
+        t->lastStepTime[i] = 0.0;
         for (int j = 0; j < 2; j++)
         {
             t->ktime[i][j].t = 0.0;
@@ -42,10 +42,13 @@
 
 #include "gmxpre.h"
 
+#include <algorithm>
 #include <memory>
+#include <string>
 
 #include "gromacs/domdec/domdec.h"
 #include "gromacs/domdec/domdec_struct.h"
+#include "gromacs/ewald/ewald_utils.h"
 #include "gromacs/hardware/hw_info.h"
 #include "gromacs/mdlib/gmx_omp_nthreads.h"
 #include "gromacs/mdtypes/commrec.h"
@@ -101,10 +104,38 @@ static bool nbnxn_simd_supported(const gmx::MDLogger& mdlog, const t_inputrec& i
                         "back to plain C kernels");
         return FALSE;
     }
+    if (inputrec.vdwtype == VanDerWaalsType::User)
+    {
+        GMX_LOG(mdlog.warning)
+                .asParagraph()
+                .appendText(
+                        "User tables for VdW are not supported with SIMD kernels, falling back "
+                        "to plain C kernels");
+        return FALSE;
+    }
 
     return TRUE;
 }
 
+/*! \brief Returns whether the analytical Ewald correction is within its accuracy range
+ *
+ * The polynomial approximations pmeForceCorrection() and
+ * pmePotentialCorrection() are accurate up to beta*r = 4, which covers
+ * the cut-off for ewald-rtol down to about 1e-8. For smaller tolerances
+ * the tabulated correction is used.
+ */
+static bool analyticalEwaldCorrectionIsAccurate(const t_inputrec& inputrec)
+{
+    if (!EEL_PME_EWALD(inputrec.coulombtype))
+    {
+        return true;
+    }
+
+    const real c_maxBetaR = 4;
+
+    return calc_ewaldcoeff_q(inputrec.rcoulomb, inputrec.ewald_rtol) * inputrec.rcoulomb <= c_maxBetaR;
+}
+
 /*! \brief Returns the most suitable CPU kernel type and Ewald handling */
 static KernelSetup pick_nbnxn_kernel_cpu(const t_inputrec gmx_unused& inputrec,
                                          const gmx_hw_info_t gmx_unused& hardwareInfo)
@@ -185,17 +216,19 @@ static KernelSetup pick_nbnxn_kernel_cpu(const t_inputrec gmx_unused& inputrec,
          * the SIMD kernel.
          * Since table lookup's don't parallelize with SIMD, analytical
          * will probably always be faster for a SIMD width of 8 or more.
-         * With FMA analytical is sometimes faster for a width if 4 as well.
-         * In single precision, this is faster on Bulldozer.
-         * On AMD Zen, tabulated Ewald kernels are faster on all 4 combinations
+         * With FMA analytical is faster for a width of 4 as well, also
+         * in double precision where the table gathers are relatively
+         * the most expensive. Without FMA, in single precision, this is
+         * faster on Bulldozer.
+         * On AMD Zen1, tabulated Ewald kernels are faster on all 4 combinations
          * of single or double precision and 128 or 256-bit AVX2.
          */
         MSVC_DIAGNOSTIC_IGNORE(6285) // Always zero because compile time constant
         if (
 #if GMX_SIMD
-                (GMX_SIMD_REAL_WIDTH >= 8 || (GMX_SIMD_REAL_WIDTH >= 4 && GMX_SIMD_HAVE_FMA && !GMX_DOUBLE)) &&
+                (GMX_SIMD_REAL_WIDTH >= 8 || (GMX_SIMD_REAL_WIDTH >= 4 && GMX_SIMD_HAVE_FMA)) &&
 #endif
-                !hardwareInfo.haveAmdZen1Cpu)
+                !hardwareInfo.haveAmdZen1Cpu && analyticalEwaldCorrectionIsAccurate(inputrec))
         {
             kernelSetup.ewaldExclusionType = EwaldExclusionType::Analytical;
         }
@@ -414,38 +447,20 @@ static int getENbnxnInitCombRule(const t_forcerec& forcerec)
     }
 }
 
-std::unique_ptr<nonbonded_verlet_t> init_nb_verlet(const gmx::MDLogger& mdlog,
-                                                   const t_inputrec&    inputrec,
-                                                   const t_forcerec&    forcerec,
-                                                   const t_commrec*     commrec,
-                                                   const gmx_hw_info_t& hardwareInfo,
-                                                   bool                 useGpuForNonbonded,
-                                                   const gmx::DeviceStreamManager* deviceStreamManager,
-                                                   const gmx_mtop_t&               mtop,
-                                                   matrix                          box,
-                                                   gmx_wallcycle*                  wcycle)
+/*! \brief Creates an Nbnxm object for an already chosen kernel setup */
+static std::unique_ptr<nonbonded_verlet_t>
+initNbnxmWithKernelSetup(const gmx::MDLogger&            mdlog,
+                         const t_inputrec&               inputrec,
+                         const t_forcerec&               forcerec,
+                         const t_commrec*                commrec,
+                         const Nbnxm::KernelSetup&       kernelSetup,
+                         bool                            useGpuForNonbonded,
+                         const gmx::DeviceStreamManager* deviceStreamManager,
+                         const gmx_mtop_t&               mtop,
+                         matrix                          box,
+                         gmx_wallcycle*                  wcycle)
 {
-    const bool emulateGpu = (getenv("GMX_EMULATE_GPU") != nullptr);
-
-    GMX_RELEASE_ASSERT(!(emulateGpu && useGpuForNonbonded),
-                       "When GPU emulation is active, there cannot be a GPU assignment");
-
-    NonbondedResource nonbondedResource;
-    if (useGpuForNonbonded)
-    {
-        nonbondedResource = NonbondedResource::Gpu;
-    }
-    else if (emulateGpu)
-    {
-        nonbondedResource = NonbondedResource::EmulateGpu;
-    }
-    else
-    {
-        nonbondedResource = NonbondedResource::Cpu;
-    }
-
-    Nbnxm::KernelSetup kernelSetup = pick_nbnxn_kernel(
-            mdlog, forcerec.use_simd_kernels, hardwareInfo, nonbondedResource, inputrec);
+    const bool emulateGpu = (kernelSetup.kernelType == KernelType::Cpu8x8x8_PlainC);
 
     const bool haveMultipleDomains = havePPDomainDecomposition(commrec);
 
@@ -494,6 +509,12 @@ std::unique_ptr<nonbonded_verlet_t> init_nb_verlet(const gmx::MDLogger& mdlog,
         gpu_nbv = gpu_init(
                 *deviceStreamManager, forcerec.ic.get(), pairlistParams, nbat.get(), haveMultipleDomains);
 
+        const std::string kernelSetupDescription = gpu_get_kernel_setup_description(gpu_nbv);
+        if (!kernelSetupDescription.empty())
+        {
+            GMX_LOG(mdlog.info).asParagraph().appendText(kernelSetupDescription);
+        }
+
         minimumIlistCountForGpuBalancing = getMinimumIlistCountForGpuBalancing(gpu_nbv);
         maximumIlistCountForGpuBalancing = getMaximumIlistCountForGpuBalancing();
     }
@@ -505,6 +526,19 @@ std::unique_ptr<nonbonded_verlet_t> init_nb_verlet(const gmx::MDLogger& mdlog,
             maximumIlistCountForGpuBalancing
     );
 
+    if (getenv("GMX_TUNE_DYNAMICPRUNING") != nullptr && pairlistParams.useDynamicPruning
+        && !sc_isGpuPairListType[pairlistParams.pairlistType])
+    {
+        pairlistSets->enableInnerBufferTuning(std::max(forcerec.ic->rvdw, forcerec.ic->rcoulomb));
+
+        GMX_LOG(mdlog.info)
+                .asParagraph()
+                .appendTextFormatted(
+                        "Tuning the inner pair-list buffer during the run, starting from "
+                        "rlist=%.3f nm",
+                        pairlistParams.rlistInner);
+    }
+
     auto pairSearch = std::make_unique<PairSearch>(
             inputrec.pbcType,
             EI_TPI(inputrec.eI),
@@ -519,6 +553,60 @@ std::unique_ptr<nonbonded_verlet_t> init_nb_verlet(const gmx::MDLogger& mdlog,
             std::move(pairlistSets), std::move(pairSearch), std::move(nbat), kernelSetup, gpu_nbv, wcycle);
 }
 
+std::unique_ptr<nonbonded_verlet_t> init_nb_verlet(const gmx::MDLogger& mdlog,
+                                                   const t_inputrec&    inputrec,
+                                                   const t_forcerec&    forcerec,
+                                                   const t_commrec*     commrec,
+                                                   const gmx_hw_info_t& hardwareInfo,
+                                                   bool                 useGpuForNonbonded,
+                                                   const gmx::DeviceStreamManager* deviceStreamManager,
+                                                   const gmx_mtop_t&               mtop,
+                                                   matrix                          box,
+                                                   gmx_wallcycle*                  wcycle)
+{
+    const bool emulateGpu = (getenv("GMX_EMULATE_GPU") != nullptr);
+
+    GMX_RELEASE_ASSERT(!(emulateGpu && useGpuForNonbonded),
+                       "When GPU emulation is active, there cannot be a GPU assignment");
+
+    NonbondedResource nonbondedResource;
+    if (useGpuForNonbonded)
+    {
+        nonbondedResource = NonbondedResource::Gpu;
+    }
+    else if (emulateGpu)
+    {
+        nonbondedResource = NonbondedResource::EmulateGpu;
+    }
+    else
+    {
+        nonbondedResource = NonbondedResource::Cpu;
+    }
+
+    Nbnxm::KernelSetup kernelSetup = pick_nbnxn_kernel(
+            mdlog, forcerec.use_simd_kernels, hardwareInfo, nonbondedResource, inputrec);
+
+    return initNbnxmWithKernelSetup(
+            mdlog, inputrec, forcerec, commrec, kernelSetup, useGpuForNonbonded, deviceStreamManager, mtop, box, wcycle);
+}
+
+std::unique_ptr<nonbonded_verlet_t> init_nb_verlet(const gmx::MDLogger&      mdlog,
+                                                   const t_inputrec&         inputrec,
+                                                   const t_forcerec&         forcerec,
+                                                   const t_commrec*          commrec,
+                                                   const Nbnxm::KernelSetup& kernelSetup,
+                                                   const gmx_mtop_t&         mtop,
+                                                   matrix                    box,
+                                                   gmx_wallcycle*            wcycle)
+{
+    GMX_RELEASE_ASSERT(kernelSetup.kernelType != KernelType::Gpu8x8x8
+                               && kernelSetup.kernelType != KernelType::Cpu8x8x8_PlainC,
+                       "Only CPU kernel setups can be passed explicitly");
+
+    return initNbnxmWithKernelSetup(
+            mdlog, inputrec, forcerec, commrec, kernelSetup, false, nullptr, mtop, box, wcycle);
+}
+
 } // namespace Nbnxm
 
 nonbonded_verlet_t::nonbonded_verlet_t(std::unique_ptr<PairlistSets>     pairlistSets,
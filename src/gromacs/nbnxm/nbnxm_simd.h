@@ -69,4 +69,20 @@
 
 #endif // GMX_SIMD && GMX_USE_SIMD_KERNELS
 
+/*! \brief The default number of j-cluster list entries ahead of the current entry
+ * for which the SIMD kernels prefetch the j-coordinates, 0 disables prefetching
+ *
+ * The j-coordinate loads are random access for the parts of the list with
+ * non-local or periodic image j-clusters, which, for large systems, can cause
+ * cache miss stalls that the hardware prefetchers do not prevent. Prefetching
+ * is enabled by default for the x86 SIMD setups used on compute servers.
+ * The distance can be set at run time with the environment variable
+ * GMX_NBNXN_PREFETCH_DISTANCE.
+ */
+#if GMX_SIMD_X86_AVX2_256 || GMX_SIMD_X86_AVX_512
+static constexpr int c_nbnxnSimdDefaultJClusterPrefetchDistance = 4;
+#else
+static constexpr int c_nbnxnSimdDefaultJClusterPrefetchDistance = 0;
+#endif
+
 #endif
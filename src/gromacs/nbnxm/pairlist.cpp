@@ -45,6 +45,7 @@
 #include <cstring>
 
 #include <algorithm>
+#include <vector>
 
 #include "gromacs/domdec/domdec_struct.h"
 #include "gromacs/gmxlib/nrnb.h"
@@ -62,6 +63,7 @@
 #include "gromacs/pbcutil/pbc.h"
 #include "gromacs/simd/simd.h"
 #include "gromacs/simd/vector_operations.h"
+#include "gromacs/timing/wallcycle.h"
 #include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxomp.h"
@@ -2957,6 +2959,60 @@ static int get_ci_block_size(const Grid& iGrid, const bool haveMultipleDomains,
     return ci_block;
 }
 
+/*! \brief Estimate of the search cost of an i-cell, excluding its j-clusters
+ *
+ * This is expressed in units of the cost of adding a j-cluster to the list
+ * and accounts for the bounding-box checks against all j-columns in range.
+ */
+static constexpr float c_iCellSearchOverheadInJClusters = 4.0F;
+
+/*! \brief Divides the i-cells of \p iGrid in contiguous ranges of equal estimated work
+ *
+ * The work estimate per i-cell for each column is taken from \p columnCellWork,
+ * which is the average number of j-clusters per i-cell in that column
+ * in the previous list. The range for list \p l is stored as
+ * [\p ciBoundaries[l], \p ciBoundaries[l+1]).
+ */
+static void divideICellsByWorkEstimate(const Grid&                iGrid,
+                                       gmx::ArrayRef<const float> columnCellWork,
+                                       gmx::ArrayRef<int>         ciBoundaries)
+{
+    const int numLists = ciBoundaries.ssize() - 1;
+
+    double totalWork = 0;
+    for (int column = 0; column < iGrid.numColumns(); column++)
+    {
+        totalWork += iGrid.numCellsInColumn(column)
+                     * (columnCellWork[column] + c_iCellSearchOverheadInJClusters);
+    }
+
+    ciBoundaries[0] = 0;
+    int    list     = 1;
+    double workDone = 0;
+    for (int column = 0; column < iGrid.numColumns() && list < numLists; column++)
+    {
+        const int    numCells   = iGrid.numCellsInColumn(column);
+        const double cellWork   = columnCellWork[column] + c_iCellSearchOverheadInJClusters;
+        const double columnWork = numCells * cellWork;
+        /* Place all list boundaries that fall within this column,
+         * assuming uniform work over the cells in the column.
+         */
+        while (list < numLists && workDone + columnWork >= list * totalWork / numLists)
+        {
+            const int numCellsBefore =
+                    static_cast<int>((list * totalWork / numLists - workDone) / cellWork + 0.5);
+            ciBoundaries[list] =
+                    iGrid.firstCellInColumn(column) + std::min(numCellsBefore, numCells);
+            list++;
+        }
+        workDone += columnWork;
+    }
+    for (; list <= numLists; list++)
+    {
+        ciBoundaries[list] = iGrid.numCells();
+    }
+}
+
 /* Returns the number of bits to right-shift a cluster index to obtain
  * the corresponding force buffer flag index.
  */
@@ -3056,6 +3112,80 @@ static void incrementNumSimpleJClustersInList(NbnxnPairlistGpu gmx_unused* nbl,
 {
 }
 
+static void compactExclusionMasks(NbnxnPairlistCpu gmx_unused* nbl) {}
+
+//! Returns a hash of the interaction bits of \p mask
+static inline uint32_t exclusionMaskHash(const nbnxn_excl_t& mask)
+{
+    /* FNV-1a over the mask words */
+    uint32_t hash = 2166136261U;
+    for (const unsigned int pairEntry : mask.pair)
+    {
+        hash = (hash ^ pairEntry) * 16777619U;
+    }
+    return hash;
+}
+
+/* Removes duplicate exclusion masks from the list and renumbers the references in the cj4 entries.
+ *
+ * Most masks are copies of a few patterns, such as the self cluster-pair masks of identical
+ * molecules, so this considerably reduces the exclusion data that is transferred to the GPU.
+ * Entry 0, without exclusions, stays in place: groups without exclusions do not store masks.
+ */
+static void compactExclusionMasks(NbnxnPairlistGpu* nbl)
+{
+    const int numMasks = nbl->excl.size();
+    if (numMasks <= 1)
+    {
+        return;
+    }
+
+    std::vector<int>& hashTable = nbl->work->exclHashTable;
+    std::vector<int>& indexMap  = nbl->work->exclIndexMap;
+
+    /* Open addressing with at least half of the slots empty */
+    int tableSize = 1;
+    while (tableSize < 2 * numMasks)
+    {
+        tableSize *= 2;
+    }
+    hashTable.assign(tableSize, -1);
+    indexMap.resize(numMasks);
+
+    /* Compact in place, the unique masks are moved to the start of the array */
+    int numUniqueMasks = 0;
+    for (int m = 0; m < numMasks; m++)
+    {
+        int slot = exclusionMaskHash(nbl->excl[m]) & (tableSize - 1);
+        while (hashTable[slot] >= 0
+               && std::memcmp(nbl->excl[hashTable[slot]].pair, nbl->excl[m].pair, sizeof(nbl->excl[m].pair)) != 0)
+        {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        if (hashTable[slot] < 0)
+        {
+            nbl->excl[numUniqueMasks] = nbl->excl[m];
+            hashTable[slot]           = numUniqueMasks;
+            numUniqueMasks++;
+        }
+        indexMap[m] = hashTable[slot];
+    }
+
+    if (numUniqueMasks == numMasks)
+    {
+        return;
+    }
+
+    for (nbnxn_cj4_t& cj4 : nbl->cj4)
+    {
+        for (nbnxn_im_ei_t& imei : cj4.imei)
+        {
+            imei.excl_ind = indexMap[imei.excl_ind];
+        }
+    }
+    nbl->excl.resize(numUniqueMasks);
+}
+
 static void checkListSizeConsistency(const NbnxnPairlistCpu& nbl, const bool haveFreeEnergy)
 {
     GMX_RELEASE_ASSERT(static_cast<size_t>(nbl.ncjInUse) == nbl.cj.size() || haveFreeEnergy,
@@ -3107,6 +3237,8 @@ static void nbnxn_make_pairlist_part(const Nbnxm::GridSet&   gridSet,
                                      real                    rlist,
                                      const PairlistType      pairlistType,
                                      int                     ci_block,
+                                     int                     ciBegin,
+                                     int                     ciEnd,
                                      gmx_bool                bFBufferFlag,
                                      int                     nsubpair_max,
                                      int                     length_limit,
@@ -3245,14 +3377,16 @@ static void nbnxn_make_pairlist_part(const Nbnxm::GridSet&   gridSet,
     const real listRangeBBToJCell2 =
             gmx::square(listRangeForBoundingBoxToGridCell(rlist, jGrid.dimensions()));
 
+    const bool recordColumnWork = !work->iColumnNumJClusters.empty();
+
     /* Initially ci_b and ci to 1 before where we want them to start,
      * as they will both be incremented in next_ci.
      */
     int ci_b = -1;
-    int ci   = th * ci_block - 1;
+    int ci   = ciBegin - 1;
     int ci_x = 0;
     int ci_y = 0;
-    while (next_ci(iGrid, nth, ci_block, &ci_x, &ci_y, &ci_b, &ci))
+    while (next_ci(iGrid, nth, ci_block, &ci_x, &ci_y, &ci_b, &ci) && ci < ciEnd)
     {
         if (bSimple && flags_i[ci] == 0)
         {
@@ -3589,10 +3723,18 @@ static void nbnxn_make_pairlist_part(const Nbnxm::GridSet&   gridSet,
         {
             bitmask_init_bit(&(work->buffer_flags[(iGrid.cellOffset() + ci) >> gridi_flag_shift]), th);
         }
+
+        if (recordColumnWork)
+        {
+            work->iColumnNumJClusters[ci_x * iGridDims.numCells[YY] + ci_y] +=
+                    getNumSimpleJClustersInList(*nbl) - ncj_old_i;
+        }
     }
 
     work->ndistc = numDistanceChecks;
 
+    compactExclusionMasks(nbl);
+
     checkListSizeConsistency(*nbl, haveFep);
 
     if (debug)
@@ -3995,7 +4137,8 @@ void PairlistSet::constructPairlists(gmx::InteractionLocality      locality,
                                      const int                     minimumIlistCountForGpuBalancing,
                                      const int                     maximumIlistCountForGpuBalancing,
                                      t_nrnb*                       nrnb,
-                                     SearchCycleCounting*          searchCycleCounting)
+                                     SearchCycleCounting*          searchCycleCounting,
+                                     gmx_wallcycle*                wcycle)
 {
     const real rlist = params_.rlistOuter;
 
@@ -4095,6 +4238,23 @@ void PairlistSet::constructPairlists(gmx::InteractionLocality      locality,
             const int ci_block =
                     get_ci_block_size(iGrid, gridSet.domainSetup().haveMultipleDomains, numLists);
 
+            /* Without domain decomposition there is a single grid and we can
+             * divide the i-cells over the CPU lists using the j-cluster counts
+             * per column of the previous search as a work estimate. This
+             * avoids imbalance for inhomogeneous systems, e.g. membranes.
+             */
+            const bool useWorkEstimate =
+                    isCpuType_ && !gridSet.domainSetup().haveMultipleDomains && numLists > 1;
+            const bool haveWorkEstimate =
+                    useWorkEstimate
+                    && gmx::ssize(iColumnCellWorkEstimate_) == iGrid.numColumns();
+            std::vector<int> ciBoundaries;
+            if (haveWorkEstimate)
+            {
+                ciBoundaries.resize(numLists + 1);
+                divideICellsByWorkEstimate(iGrid, iColumnCellWorkEstimate_, ciBoundaries);
+            }
+
             /* With GPU: generate progressively smaller lists for
              * load balancing for local only or non-local with 2 zones.
              */
@@ -4126,7 +4286,22 @@ void PairlistSet::constructPairlists(gmx::InteractionLocality      locality,
 
                     t_nblist* fepListPtr = (fepLists_.empty() ? nullptr : fepLists_[th].get());
 
-                    /* Divide the i cells equally over the pairlists */
+                    if (useWorkEstimate)
+                    {
+                        work.iColumnNumJClusters.assign(iGrid.numColumns(), 0);
+                    }
+                    else
+                    {
+                        work.iColumnNumJClusters.clear();
+                    }
+
+                    /* Divide the i cells over the pairlists, either in blocks
+                     * of equal size or in one range per list of equal estimated work.
+                     */
+                    const int ciBlock = (haveWorkEstimate ? iGrid.numCells() : ci_block);
+                    const int ciBegin = (haveWorkEstimate ? ciBoundaries[th] : th * ci_block);
+                    const int ciEnd = (haveWorkEstimate ? ciBoundaries[th + 1] : iGrid.numCells());
+
                     if (isCpuType_)
                     {
                         nbnxn_make_pairlist_part(gridSet,
@@ -4137,7 +4312,9 @@ void PairlistSet::constructPairlists(gmx::InteractionLocality      locality,
                                                  exclusions,
                                                  rlist,
                                                  params_.pairlistType,
-                                                 ci_block,
+                                                 ciBlock,
+                                                 ciBegin,
+                                                 ciEnd,
                                                  nbat->bUseBufferFlags,
                                                  nsubpair_target,
                                                  length_limit,
@@ -4158,7 +4335,9 @@ void PairlistSet::constructPairlists(gmx::InteractionLocality      locality,
                                                  exclusions,
                                                  rlist,
                                                  params_.pairlistType,
-                                                 ci_block,
+                                                 ciBlock,
+                                                 ciBegin,
+                                                 ciEnd,
                                                  nbat->bUseBufferFlags,
                                                  nsubpair_target,
                                                  length_limit,
@@ -4176,6 +4355,36 @@ void PairlistSet::constructPairlists(gmx::InteractionLocality      locality,
             }
             searchCycleCounting->stop(enbsCCsearch);
 
+            /* Record the time lost by threads waiting for the slowest one */
+            gmx_cycles_t maxThreadCycles = 0;
+            gmx_cycles_t sumThreadCycles = 0;
+            for (int th = 0; th < numLists; th++)
+            {
+                const gmx_cycles_t threadCycles = searchWork[th].cycleCounter.lastCycles();
+                maxThreadCycles                 = std::max(maxThreadCycles, threadCycles);
+                sumThreadCycles += threadCycles;
+            }
+            wallcycle_sub_add(wcycle,
+                              WallCycleSubCounter::NBSSearchImbalance,
+                              maxThreadCycles - sumThreadCycles / numLists);
+
+            if (useWorkEstimate)
+            {
+                /* Store the average work per i-cell in each column for the next search */
+                iColumnCellWorkEstimate_.resize(iGrid.numColumns());
+                for (int column = 0; column < iGrid.numColumns(); column++)
+                {
+                    int numJClusters = 0;
+                    for (int th = 0; th < numLists; th++)
+                    {
+                        numJClusters += searchWork[th].iColumnNumJClusters[column];
+                    }
+                    const int numCells = iGrid.numCellsInColumn(column);
+                    iColumnCellWorkEstimate_[column] =
+                            (numCells > 0 ? numJClusters / static_cast<float>(numCells) : 0.0F);
+                }
+            }
+
             int np_tot = 0;
             int np_noq = 0;
             int np_hlj = 0;
@@ -4312,6 +4521,9 @@ void PairlistSet::constructPairlists(gmx::InteractionLocality      locality,
     {
         prepareListsForDynamicPruning(cpuLists_);
     }
+
+    /* The inner lists are only valid after the first pruning pass */
+    haveValidInnerLists_ = false;
 }
 
 void PairlistSets::construct(const InteractionLocality iLocality,
@@ -4319,7 +4531,8 @@ void PairlistSets::construct(const InteractionLocality iLocality,
                              nbnxn_atomdata_t*         nbat,
                              const ListOfLists<int>&   exclusions,
                              const int64_t             step,
-                             t_nrnb*                   nrnb)
+                             t_nrnb*                   nrnb,
+                             gmx_wallcycle*            wcycle)
 {
     const auto& gridSet = pairSearch->gridSet();
     const auto* ddZones = gridSet.domainSetup().zones;
@@ -4341,7 +4554,8 @@ void PairlistSets::construct(const InteractionLocality iLocality,
                                               minimumIlistCountForGpuBalancing_,
                                               maximumIlistCountForGpuBalancing_,
                                               nrnb,
-                                              &pairSearch->cycleCounting_);
+                                              &pairSearch->cycleCounting_,
+                                              wcycle);
 
     if (iLocality == InteractionLocality::Local)
     {
@@ -4371,7 +4585,8 @@ void nonbonded_verlet_t::constructPairlist(const InteractionLocality iLocality,
                                            int64_t                   step,
                                            t_nrnb*                   nrnb) const
 {
-    pairlistSets_->construct(iLocality, pairSearch_.get(), nbat.get(), exclusions, step, nrnb);
+    pairlistSets_->construct(
+            iLocality, pairSearch_.get(), nbat.get(), exclusions, step, nrnb, wcycle_);
 
     if (useGpu())
     {
@@ -51,6 +51,7 @@
 #define GMX_NBNXM_PAIRLISTSET_H
 
 #include <memory>
+#include <vector>
 
 #include "gromacs/math/vectypes.h"
 #include "gromacs/mdtypes/locality.h"
@@ -59,6 +60,7 @@
 
 #include "pairlist.h"
 
+struct gmx_wallcycle;
 struct nbnxn_atomdata_t;
 struct PairlistParams;
 struct PairsearchWork;
@@ -96,11 +98,27 @@ public:
                             int                           minimumIlistCountForGpuBalancing,
                             int                           maximumIlistCountForGpuBalancing,
                             t_nrnb*                       nrnb,
-                            SearchCycleCounting*          searchCycleCounting);
+                            SearchCycleCounting*          searchCycleCounting,
+                            gmx_wallcycle*                wcycle);
 
     //! Dispatch the kernel for dynamic pairlist pruning
     void dispatchPruneKernel(const nbnxn_atomdata_t* nbat, gmx::ArrayRef<const gmx::RVec> shift_vec);
 
+    //! Returns whether the inner, pruned, CPU lists have been produced from the current outer lists
+    bool haveValidInnerLists() const { return haveValidInnerLists_; }
+
+    /*! \brief Returns the number of cluster pairs missing from the inner lists
+     *
+     * Counts the cluster pairs in the outer lists that are not present
+     * in the current inner lists, but that have at least one atom pair
+     * within \p interactionCutoff with the coordinates in \p nbat.
+     * Such pairs indicate that the inner list buffer was too short over
+     * the last pruning interval. Can only be called with valid inner lists.
+     */
+    int countMissedClusterPairs(const nbnxn_atomdata_t*        nbat,
+                                gmx::ArrayRef<const gmx::RVec> shift_vec,
+                                real                           interactionCutoff) const;
+
     //! Returns the lists of CPU pairlists
     gmx::ArrayRef<const NbnxnPairlistCpu> cpuLists() const { return cpuLists_; }
 
@@ -135,6 +153,14 @@ private:
     gmx_bool isCpuType_;
     //! Lists for perturbed interactions in simple atom-atom layout
     std::vector<std::unique_ptr<t_nblist>> fepLists_;
+    //! Tells whether the inner CPU lists have been pruned from the current outer lists
+    bool haveValidInnerLists_ = false;
+    /*! \brief Work estimate per i-cell for each column of the i-grid from the previous search
+     *
+     * Used to divide the i-cells over the CPU lists. Only used and valid
+     * without domain decomposition and when the column count matches the grid.
+     */
+    std::vector<float> iColumnCellWorkEstimate_;
 
 public:
     /* Pair counts for flop counting */
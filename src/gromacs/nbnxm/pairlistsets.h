@@ -54,6 +54,7 @@
 
 #include "pairlistparams.h"
 
+struct gmx_wallcycle;
 struct nbnxn_atomdata_t;
 class PairlistSet;
 enum class PairlistType;
@@ -82,7 +83,8 @@ public:
                    nbnxn_atomdata_t*            nbat,
                    const gmx::ListOfLists<int>& exclusions,
                    int64_t                      step,
-                   t_nrnb*                      nrnb);
+                   t_nrnb*                      nrnb,
+                   gmx_wallcycle*               wcycle);
 
     //! Dispatches the dynamic pruning kernel for the given locality
     void dispatchPruneKernel(gmx::InteractionLocality       iLocality,
@@ -114,13 +116,26 @@ public:
                 && (params_.haveMultipleDomains || age % (2 * params_.mtsFactor) == 0));
     }
 
-    //! Changes the pair-list outer and inner radius
+    //! Changes the pair-list outer and inner radius, this ends inner buffer tuning
     void changePairlistRadii(real rlistOuter, real rlistInner)
     {
         params_.rlistOuter = rlistOuter;
         params_.rlistInner = rlistInner;
+
+        innerBufferTuning_.isActive = false;
     }
 
+    /*! \brief Enables tuning of the inner pair-list buffer during the run
+     *
+     * The inner buffer is reduced stepwise, starting from the current,
+     * analytically estimated, inner radius, as long as no cluster pairs
+     * within \p interactionCutoff are missed by the pruned lists.
+     * When a miss is observed, the buffer is increased by one step and
+     * kept at that size. The inner radius never exceeds its initial value.
+     * Only applies to CPU lists with dynamic pruning.
+     */
+    void enableInnerBufferTuning(real interactionCutoff);
+
     //! Returns the pair-list set for the given locality
     const PairlistSet& pairlistSet(gmx::InteractionLocality iLocality) const
     {
@@ -150,8 +165,34 @@ private:
         }
     }
 
+    //! Checks the local inner list for missed pairs and updates the inner radius
+    void tuneInnerBuffer(const nbnxn_atomdata_t* nbat, gmx::ArrayRef<const gmx::RVec> shift_vec);
+
+    //! State for tuning the inner pair-list buffer during the run
+    struct InnerBufferTuning
+    {
+        //! Whether tuning is active
+        bool isActive = false;
+        //! Whether the buffer has converged, after which we only check for misses
+        bool hasConverged = false;
+        //! The maximum of the cut-off distances of the interactions
+        real interactionCutoff = 0;
+        //! The initial inner radius, never exceeded
+        real maxRlistInner = 0;
+        //! The minimum inner radius we allow
+        real minRlistInner = 0;
+        //! The step size for changing the inner radius
+        real radiusStep = 0;
+        //! The number of pruning steps since tuning started
+        int numPruneSteps = 0;
+        //! The number of consecutive checks without misses at the current radius
+        int numCleanChecks = 0;
+    };
+
     //! Parameters for the search and list pruning setup
     PairlistParams params_;
+    //! Inner pair-list buffer tuning state
+    InnerBufferTuning innerBufferTuning_;
     //! Pair list balancing parameter for use with GPU
     int minimumIlistCountForGpuBalancing_;
     //! Pair list balancing parameter for use with GPU
@@ -140,6 +140,11 @@ struct NbnxnPairlistGpuWork
     //! Second sci array, for sorting
     gmx::HostVector<nbnxn_sci_t> sci_sort;
 
+    //! Hash table for finding duplicate exclusion masks, stores indices into the list excl array
+    std::vector<int> exclHashTable;
+    //! Maps the exclusion mask indices before deduplication to those after
+    std::vector<int> exclIndexMap;
+
     //! Protect data from cache pollution between threads
     gmx_cache_protect_t cp1;
 };
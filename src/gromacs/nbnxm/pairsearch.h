@@ -82,12 +82,16 @@ public:
     //! Stop counting cycles
     void stop()
     {
-        cycles_ += gmx_cycles_read() - start_;
+        lastCycles_ = gmx_cycles_read() - start_;
+        cycles_ += lastCycles_;
         count_++;
     }
     //! Return the number of periods of cycle counting
     int count() const { return count_; }
 
+    //! Return the number of cycles in the most recent counting period
+    gmx_cycles_t lastCycles() const { return lastCycles_; }
+
     //! Return the average number of million cycles per counting period
     double averageMCycles() const
     {
@@ -108,6 +112,8 @@ private:
     gmx_cycles_t cycles_ = 0;
     //! Cycle count at the most recent start
     gmx_cycles_t start_ = 0;
+    //! Cycles in the most recent counting period
+    gmx_cycles_t lastCycles_ = 0;
 };
 
 //! Local cycle count enum for profiling different parts of search
@@ -162,6 +168,9 @@ struct PairsearchWork
     //! Number of distance checks for flop counting
     int ndistc;
 
+    //! Number of j-clusters put in the list of this thread for each i-grid column
+    std::vector<int> iColumnNumJClusters;
+
 
     //! Temporary FEP list for load balancing
     std::unique_ptr<t_nblist> nbl_fep;
@@ -36,9 +36,14 @@
 
 #include "gmxpre.h"
 
+#include <cstdio>
+
+#include <algorithm>
+
 #include "gromacs/mdlib/gmx_omp_nthreads.h"
 #include "gromacs/nbnxm/nbnxm.h"
 #include "gromacs/timing/wallcycle.h"
+#include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxassert.h"
 
 #include "clusterdistancekerneltype.h"
@@ -50,13 +55,205 @@
 #include "kernels_simd_2xmm/kernel_prune.h"
 #include "kernels_simd_4xm/kernel_prune.h"
 
+//! The number of consecutive checks without misses required before reducing the inner buffer
+static constexpr int c_numCleanChecksBeforeShrinking = 10;
+//! The interval, in pruning steps, for checking for misses after the buffer converged
+static constexpr int c_convergedCheckInterval = 10;
+//! The inner buffer is changed in steps of this fraction of the initial buffer
+static constexpr real c_innerBufferStepFraction = 0.1;
+//! The inner buffer is never reduced below this fraction of the initial buffer
+static constexpr real c_minInnerBufferFraction = 0.5;
+
+void PairlistSets::enableInnerBufferTuning(const real interactionCutoff)
+{
+    GMX_RELEASE_ASSERT(params_.useDynamicPruning && !sc_isGpuPairListType[params_.pairlistType],
+                       "Inner buffer tuning requires dynamic pruning of CPU lists");
+
+    const real initialBuffer = params_.rlistInner - interactionCutoff;
+
+    InnerBufferTuning& tuning = innerBufferTuning_;
+    tuning.isActive           = (initialBuffer > 0);
+    tuning.hasConverged       = false;
+    tuning.interactionCutoff  = interactionCutoff;
+    tuning.maxRlistInner      = params_.rlistInner;
+    tuning.minRlistInner      = interactionCutoff + c_minInnerBufferFraction * initialBuffer;
+    tuning.radiusStep         = c_innerBufferStepFraction * initialBuffer;
+    tuning.numPruneSteps      = 0;
+    tuning.numCleanChecks     = 0;
+}
+
+void PairlistSets::tuneInnerBuffer(const nbnxn_atomdata_t* nbat, gmx::ArrayRef<const gmx::RVec> shift_vec)
+{
+    InnerBufferTuning& tuning = innerBufferTuning_;
+
+    const bool checkThisStep =
+            (!tuning.hasConverged || tuning.numPruneSteps % c_convergedCheckInterval == 0);
+    tuning.numPruneSteps++;
+
+    if (!checkThisStep || !localSet_->haveValidInnerLists())
+    {
+        return;
+    }
+
+    const int numMissed =
+            localSet_->countMissedClusterPairs(nbat, shift_vec, tuning.interactionCutoff);
+
+    const real rlistInnerOld = params_.rlistInner;
+    if (numMissed > 0)
+    {
+        /* The buffer was too short, increase it and keep it there */
+        params_.rlistInner    = std::min(params_.rlistInner + tuning.radiusStep, tuning.maxRlistInner);
+        tuning.hasConverged   = true;
+        tuning.numCleanChecks = 0;
+    }
+    else if (!tuning.hasConverged)
+    {
+        tuning.numCleanChecks++;
+        if (tuning.numCleanChecks >= c_numCleanChecksBeforeShrinking)
+        {
+            tuning.numCleanChecks = 0;
+            /* Allow for rounding errors in the comparison with the minimum */
+            if (params_.rlistInner - tuning.radiusStep >= tuning.minRlistInner - 0.5 * tuning.radiusStep)
+            {
+                params_.rlistInner -= tuning.radiusStep;
+            }
+            else
+            {
+                tuning.hasConverged = true;
+            }
+        }
+    }
+
+    if (debug && params_.rlistInner != rlistInnerOld)
+    {
+        fprintf(debug,
+                "Inner buffer tuning: %d missed cluster pairs, changed rlistInner from %.4f to %.4f "
+                "nm\n",
+                numMissed,
+                rlistInnerOld,
+                params_.rlistInner);
+    }
+}
+
 void PairlistSets::dispatchPruneKernel(const gmx::InteractionLocality iLocality,
                                        const nbnxn_atomdata_t*        nbat,
                                        gmx::ArrayRef<const gmx::RVec> shift_vec)
 {
+    if (iLocality == gmx::InteractionLocality::Local && innerBufferTuning_.isActive)
+    {
+        /* Check the current inner list before the pruning overwrites it */
+        tuneInnerBuffer(nbat, shift_vec);
+    }
+
     pairlistSet(iLocality).dispatchPruneKernel(nbat, shift_vec);
 }
 
+//! Returns the x/y/z coordinate \p d of atom \p a in the nbat coordinate layout
+static inline real nbatCoordinate(const real* x, const int xFormat, const int a, const int d)
+{
+    switch (xFormat)
+    {
+        case nbatXYZ: return x[a * STRIDE_XYZ + d];
+        case nbatXYZQ: return x[a * STRIDE_XYZQ + d];
+        case nbatX4: return x[atom_to_x_index<c_packX4>(a) + d * c_packX4];
+        case nbatX8: return x[atom_to_x_index<c_packX8>(a) + d * c_packX8];
+        default: GMX_ASSERT(false, "Unhandled nbat coordinate format"); return 0;
+    }
+}
+
+/*! \brief Returns the number of cluster pairs in the outer list of \p nbl that are not in the inner list but within range
+ *
+ * The inner list entries are an ordered subset of the outer list entries,
+ * so we can find the missing entries by walking through both lists.
+ */
+static int countMissedClusterPairsInList(const NbnxnPairlistCpu&        nbl,
+                                         const nbnxn_atomdata_t&        nbat,
+                                         gmx::ArrayRef<const gmx::RVec> shift_vec,
+                                         const real                     interactionCutoff)
+{
+    const real* x        = nbat.x().data();
+    const int   xFormat  = nbat.XFormat;
+    const int   fillType = nbat.params().numTypes - 1;
+    const int*  type     = nbat.params().type.data();
+    const real  rc2      = interactionCutoff * interactionCutoff;
+
+    int numMissed = 0;
+
+    size_t ciInnerIndex = 0;
+    for (const nbnxn_ci_t& ciOuter : nbl.ciOuter)
+    {
+        const nbnxn_ci_t* ciInner = nullptr;
+        if (ciInnerIndex < nbl.ci.size() && nbl.ci[ciInnerIndex].ci == ciOuter.ci
+            && nbl.ci[ciInnerIndex].shift == ciOuter.shift)
+        {
+            ciInner = &nbl.ci[ciInnerIndex++];
+        }
+        int cjInnerIndex = (ciInner ? ciInner->cj_ind_start : 0);
+
+        const int       ish = (ciOuter.shift & NBNXN_CI_SHIFT);
+        const gmx::RVec shift(shift_vec[ish]);
+
+        for (int cjIndex = ciOuter.cj_ind_start; cjIndex < ciOuter.cjIndEnd(); cjIndex++)
+        {
+            const int cj = nbl.cjOuter[cjIndex].cj;
+            if (ciInner && cjInnerIndex < ciInner->cjIndEnd() && nbl.cj[cjInnerIndex].cj == cj)
+            {
+                cjInnerIndex++;
+                continue;
+            }
+
+            bool isInRange = false;
+            for (int i = 0; i < nbl.na_ci && !isInRange; i++)
+            {
+                const int ai = ciOuter.ci * nbl.na_ci + i;
+                if (type[ai] == fillType)
+                {
+                    continue;
+                }
+                for (int j = 0; j < nbl.na_cj && !isInRange; j++)
+                {
+                    const int aj = cj * nbl.na_cj + j;
+                    if (type[aj] == fillType)
+                    {
+                        continue;
+                    }
+                    real rsq = 0;
+                    for (int d = 0; d < DIM; d++)
+                    {
+                        const real dx = nbatCoordinate(x, xFormat, ai, d) + shift[d]
+                                        - nbatCoordinate(x, xFormat, aj, d);
+                        rsq += dx * dx;
+                    }
+                    isInRange = (rsq < rc2);
+                }
+            }
+            if (isInRange)
+            {
+                numMissed++;
+            }
+        }
+    }
+
+    return numMissed;
+}
+
+int PairlistSet::countMissedClusterPairs(const nbnxn_atomdata_t*        nbat,
+                                         gmx::ArrayRef<const gmx::RVec> shift_vec,
+                                         const real                     interactionCutoff) const
+{
+    GMX_ASSERT(haveValidInnerLists_, "Can only count missed pairs with valid inner lists");
+
+    const int numLists  = cpuLists_.size();
+    int       numMissed = 0;
+#pragma omp parallel for schedule(static) num_threads(numLists) reduction(+ : numMissed)
+    for (int i = 0; i < numLists; i++)
+    {
+        numMissed += countMissedClusterPairsInList(cpuLists_[i], *nbat, shift_vec, interactionCutoff);
+    }
+
+    return numMissed;
+}
+
 void PairlistSet::dispatchPruneKernel(const nbnxn_atomdata_t* nbat, gmx::ArrayRef<const gmx::RVec> shift_vec)
 {
     const real rlistInner = params_.rlistInner;
@@ -90,6 +287,8 @@ void PairlistSet::dispatchPruneKernel(const nbnxn_atomdata_t* nbat, gmx::ArrayRe
             default: GMX_RELEASE_ASSERT(false, "kernel type not handled (yet)");
         }
     }
+
+    haveValidInnerLists_ = true;
 }
 
 void nonbonded_verlet_t::dispatchPruneKernelCpu(const gmx::InteractionLocality iLocality,
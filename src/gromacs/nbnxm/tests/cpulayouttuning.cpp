@@ -0,0 +1,170 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for the run-time selection between the CPU SIMD cluster layouts.
+ *
+ * \ingroup module_nbnxm
+ */
+#include "gmxpre.h"
+
+#include "gromacs/nbnxm/cpu_layout_tuning.h"
+
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/mdtypes/commrec.h"
+#include "gromacs/mdtypes/inputrec.h"
+#include "gromacs/nbnxm/nbnxm.h"
+
+namespace gmx
+{
+
+namespace test
+{
+
+namespace
+{
+
+using Nbnxm::CpuLayoutTuning;
+using Nbnxm::KernelSetup;
+using Nbnxm::KernelType;
+
+//! The pair search interval used in the tests
+constexpr int c_nstlist = 10;
+
+/*! \brief Feeds the step cycle counter of a run with \p cyclesPerStep4xN and \p cyclesPerStep2xNN
+ * to \p tuning until it is done, returns the number of calls made
+ */
+int runTuning(CpuLayoutTuning* tuning, double cyclesPerStep4xN, double cyclesPerStep2xNN)
+{
+    int    numCalls    = 0;
+    int    cyclesCount = 0;
+    double cycles      = 0;
+    while (tuning->isActive() && numCalls < 100)
+    {
+        tuning->processStepCycles(cyclesCount, cycles, c_nstlist);
+        numCalls++;
+        const bool use4xN = (tuning->currentSetup().kernelType == KernelType::Cpu4xN_Simd_4xN);
+        cyclesCount += c_nstlist;
+        cycles += c_nstlist * (use4xN ? cyclesPerStep4xN : cyclesPerStep2xNN);
+    }
+    return numCalls;
+}
+
+//! Returns a kernel setup with \p kernelType
+KernelSetup kernelSetup(KernelType kernelType)
+{
+    KernelSetup setup;
+    setup.kernelType = kernelType;
+    return setup;
+}
+
+TEST(CpuLayoutTuningTest, StartsWithTheInitialSetup)
+{
+    CpuLayoutTuning tuning(kernelSetup(KernelType::Cpu4xN_Simd_2xNN));
+    EXPECT_TRUE(tuning.isActive());
+    EXPECT_EQ(tuning.currentSetup().kernelType, KernelType::Cpu4xN_Simd_2xNN);
+}
+
+TEST(CpuLayoutTuningTest, SwitchesToTheFasterLayout)
+{
+    CpuLayoutTuning tuning(kernelSetup(KernelType::Cpu4xN_Simd_4xN));
+    const int       numCalls = runTuning(&tuning, 1000, 800);
+    EXPECT_FALSE(tuning.isActive());
+    EXPECT_EQ(tuning.currentSetup().kernelType, KernelType::Cpu4xN_Simd_2xNN);
+    // One call to start, 2+4 intervals with the first and 1+4 with the second layout
+    EXPECT_EQ(numCalls, 12);
+}
+
+TEST(CpuLayoutTuningTest, SwitchesBackToTheInitialLayoutWhenItIsFaster)
+{
+    CpuLayoutTuning tuning(kernelSetup(KernelType::Cpu4xN_Simd_4xN));
+    runTuning(&tuning, 800, 1000);
+    EXPECT_FALSE(tuning.isActive());
+    EXPECT_EQ(tuning.currentSetup().kernelType, KernelType::Cpu4xN_Simd_4xN);
+}
+
+TEST(CpuLayoutTuningTest, TimesTheOtherLayoutAfterTheFirstIntervals)
+{
+    CpuLayoutTuning tuning(kernelSetup(KernelType::Cpu4xN_Simd_2xNN));
+    int             cyclesCount = 0;
+    for (int call = 0; call < 7; call++)
+    {
+        EXPECT_EQ(tuning.currentSetup().kernelType, KernelType::Cpu4xN_Simd_2xNN);
+        tuning.processStepCycles(cyclesCount, cyclesCount * 100.0, c_nstlist);
+        cyclesCount += c_nstlist;
+    }
+    EXPECT_TRUE(tuning.isActive());
+    EXPECT_EQ(tuning.currentSetup().kernelType, KernelType::Cpu4xN_Simd_4xN);
+}
+
+TEST(CpuLayoutTuningTest, IgnoresIntervalsThatAreNotFull)
+{
+    CpuLayoutTuning tuning(kernelSetup(KernelType::Cpu4xN_Simd_4xN));
+    // Counter resets and intervals without a pair search step do not count
+    int cyclesCount = 0;
+    for (int call = 0; call < 20; call++)
+    {
+        tuning.processStepCycles(cyclesCount, cyclesCount * 100.0, c_nstlist);
+        cyclesCount = (call % 2 == 0) ? cyclesCount + 2 * c_nstlist : 0;
+    }
+    EXPECT_TRUE(tuning.isActive());
+    EXPECT_EQ(tuning.currentSetup().kernelType, KernelType::Cpu4xN_Simd_4xN);
+}
+
+TEST(CpuLayoutTuningTest, IsNotSupportedWithReproducibleResultsOrByDefault)
+{
+    t_commrec cr;
+    cr.sizeOfDefaultCommunicator = 1;
+    t_inputrec ir;
+    ir.nstlist = c_nstlist;
+    for (const KernelType kernelType :
+         { KernelType::Cpu4xN_Simd_4xN, KernelType::Cpu4xN_Simd_2xNN })
+    {
+        EXPECT_FALSE(CpuLayoutTuning::isSupported(kernelSetup(kernelType), &cr, ir, true));
+        if (std::getenv("GMX_NBNXN_LAYOUT_TUNING") == nullptr)
+        {
+            EXPECT_FALSE(CpuLayoutTuning::isSupported(kernelSetup(kernelType), &cr, ir, false));
+        }
+    }
+}
+
+} // namespace
+
+} // namespace test
+
+} // namespace gmx
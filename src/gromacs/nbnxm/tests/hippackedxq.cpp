@@ -0,0 +1,218 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests the accuracy of the packed FP16/BF16 j-coordinates of the HIP non-bonded
+ * kernels against the FP32 coordinates on the nbnxm benchmark system.
+ *
+ * \ingroup module_nbnxm
+ */
+#include "gmxpre.h"
+
+#include "config.h"
+
+#if GMX_GPU_HIP
+
+#    include <cmath>
+
+#    include <algorithm>
+#    include <vector>
+
+#    include <gtest/gtest.h>
+
+#    include "gromacs/hardware/device_information.h"
+#    include "gromacs/hardware/device_management.h"
+#    include "gromacs/math/vec.h"
+#    include "gromacs/nbnxm/benchmark/bench_system.h"
+#    include "gromacs/nbnxm/pairlistparams.h"
+#    include "gromacs/utility/real.h"
+
+#    include "testutils/test_hardware_environment.h"
+#    include "testutils/testasserts.h"
+
+#    include "hippackedxq_runner.h"
+
+namespace gmx
+{
+
+namespace test
+{
+
+namespace
+{
+
+//! The cut-off used for the pair checks
+constexpr float c_cutoff = 1.0F;
+//! Pairs closer than this are not checked, the closest intermolecular pairs in water are further apart
+constexpr float c_minPairDistance = 0.25F;
+//! Grid cells of approximately this size are used for the clusters
+constexpr float c_targetCellSize = 0.45F;
+//! Coordinate of the filler atoms, as in the nbnxm grid setup
+constexpr float c_fillerCoordinate = -1000000.0F;
+
+//! Test fixture holding the benchmark system atoms in cluster order
+class HipPackedXqTest : public ::testing::TestWithParam<bool>
+{
+public:
+    HipPackedXqTest() : system_(1, "")
+    {
+        /* Sort the atoms over a grid and pad each cell with fillers to whole clusters,
+         * as the nbnxm grid does, so the cluster extents are similar to those in mdrun.
+         */
+        constexpr int clusterSize = c_nbnxnGpuClusterSize;
+
+        const int numCells = std::max(1, static_cast<int>(system_.box[XX][XX] / c_targetCellSize));
+        cellSize_          = system_.box[XX][XX] / numCells;
+        std::vector<std::vector<int>> cells(numCells * numCells * numCells);
+        for (size_t a = 0; a < system_.coordinates.size(); a++)
+        {
+            int cellIndex = 0;
+            for (int d = 0; d < DIM; d++)
+            {
+                const int c = std::clamp(static_cast<int>(system_.coordinates[a][d] / cellSize_), 0, numCells - 1);
+                cellIndex   = cellIndex * numCells + c;
+            }
+            cells[cellIndex].push_back(a);
+        }
+        for (const auto& cell : cells)
+        {
+            for (size_t i = 0; i < cell.size(); i++)
+            {
+                coordinates_.push_back(system_.coordinates[cell[i]]);
+                charges_.push_back(system_.charges[cell[i]]);
+                isFiller_.push_back(false);
+            }
+            while (coordinates_.size() % clusterSize != 0)
+            {
+                coordinates_.push_back({ c_fillerCoordinate, c_fillerCoordinate, c_fillerCoordinate });
+                charges_.push_back(0.0F);
+                isFiller_.push_back(true);
+            }
+        }
+    }
+
+    //! The relative rounding error of the format of the coordinate offsets
+    static float offsetEpsilon(bool useBf16) { return useBf16 ? 1.0F / (1 << 8) : 1.0F / (1 << 11); }
+
+    //! The benchmark system
+    BenchmarkSystem system_;
+    //! The grid cell size
+    float cellSize_;
+    //! The coordinates in cluster order
+    std::vector<RVec> coordinates_;
+    //! The charges in cluster order
+    std::vector<float> charges_;
+    //! Whether the atom is a filler
+    std::vector<bool> isFiller_;
+};
+
+TEST_P(HipPackedXqTest, MatchesFp32Coordinates)
+{
+    const bool useBf16 = GetParam();
+
+    /* The offsets are bounded by half the bounding box of the cluster, i.e. of the cell */
+    const float maxOffsetError = offsetEpsilon(useBf16) * 0.5F * cellSize_;
+    /* Only the j-atom coordinates are packed, so the distance error is bounded by the j-atom error */
+    const float maxPairDistanceError = std::sqrt(3.0F) * maxOffsetError;
+    const float r2Tolerance = 2.0F * maxPairDistanceError / c_minPairDistance + 1e-6F;
+    /* The charges are kept in FP32, so only the distance contributes to the force error */
+    const float forceTolerance = r2Tolerance;
+
+    for (const auto& testDevice : getTestHardwareEnvironment()->getTestDeviceList())
+    {
+        setActiveDevice(testDevice->deviceInfo());
+
+        const HipPackedXqOutput output = runHipPackedXq(coordinates_, charges_, useBf16, *testDevice);
+
+        const int numAtoms = coordinates_.size();
+        for (int a = 0; a < numAtoms; a++)
+        {
+            if (isFiller_[a])
+            {
+                continue;
+            }
+            EXPECT_EQ(charges_[a], output.charges[a]);
+            for (int d = 0; d < DIM; d++)
+            {
+                EXPECT_NEAR(coordinates_[a][d],
+                            output.coordinates[a][d],
+                            maxOffsetError + 4 * GMX_FLOAT_EPS * std::abs(coordinates_[a][d]));
+            }
+        }
+
+        float maxR2Error    = 0;
+        float maxForceError = 0;
+        float minFillerDistance2 = GMX_FLOAT_MAX;
+        for (int i = 0; i < numAtoms; i++)
+        {
+            if (isFiller_[i])
+            {
+                continue;
+            }
+            for (int j = 0; j < numAtoms; j++)
+            {
+                const RVec dxPacked = coordinates_[i] - output.coordinates[j];
+                const float r2Packed = norm2(dxPacked);
+                if (isFiller_[j])
+                {
+                    minFillerDistance2 = std::min(minFillerDistance2, r2Packed);
+                    continue;
+                }
+                const float r2 = norm2(coordinates_[i] - coordinates_[j]);
+                if (r2 < c_minPairDistance * c_minPairDistance || r2 >= c_cutoff * c_cutoff)
+                {
+                    continue;
+                }
+                maxR2Error = std::max(maxR2Error, std::abs(r2Packed - r2) / r2);
+                /* Relative error of the Coulomb pair force qi*qj/r^2 */
+                const float force       = charges_[i] * charges_[j] / r2;
+                const float forcePacked = charges_[i] * output.charges[j] / r2Packed;
+                maxForceError = std::max(maxForceError, std::abs(forcePacked - force) / std::abs(force));
+            }
+        }
+        EXPECT_LT(maxR2Error, r2Tolerance);
+        EXPECT_LT(maxForceError, forceTolerance);
+        /* The clamped fillers should stay far beyond the cut-off from all atoms */
+        EXPECT_GT(minFillerDistance2, 4 * c_cutoff * c_cutoff);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Fp16AndBf16, HipPackedXqTest, ::testing::Bool());
+
+} // namespace
+} // namespace test
+} // namespace gmx
+
+#endif // GMX_GPU_HIP
@@ -0,0 +1,82 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Declares the runner for the tests of the packed j-coordinates of the HIP non-bonded kernels.
+ *
+ * \ingroup module_nbnxm
+ */
+#ifndef GMX_NBNXM_TESTS_HIPPACKEDXQ_RUNNER_H
+#define GMX_NBNXM_TESTS_HIPPACKEDXQ_RUNNER_H
+
+#include <vector>
+
+#include "gromacs/math/vectypes.h"
+#include "gromacs/utility/arrayref.h"
+
+namespace gmx
+{
+
+namespace test
+{
+
+class TestDevice;
+
+/*! \brief Coordinates and charges as seen by the packed j-coordinate kernels. */
+struct HipPackedXqOutput
+{
+    //! The coordinates after packing and unpacking
+    std::vector<RVec> coordinates;
+    //! The charges after packing and unpacking
+    std::vector<float> charges;
+};
+
+/*! \brief Packs and unpacks coordinates and charges on the device as the HIP non-bonded kernels do.
+ *
+ * \param[in]  coordinates The coordinates of whole clusters in nbnxm order
+ * \param[in]  charges     The charges of the atoms
+ * \param[in]  useBf16     Whether to use BF16 coordinate offsets instead of FP16
+ * \param[in]  testDevice  The device to run on
+ * \returns the coordinates and charges as unpacked in the kernels
+ */
+HipPackedXqOutput runHipPackedXq(ArrayRef<const RVec>  coordinates,
+                                 ArrayRef<const float> charges,
+                                 bool                  useBf16,
+                                 const TestDevice&     testDevice);
+
+} // namespace test
+} // namespace gmx
+
+#endif
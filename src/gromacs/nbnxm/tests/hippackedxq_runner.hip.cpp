@@ -0,0 +1,148 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Runner for the tests of the packed j-coordinates of the HIP non-bonded kernels.
+ *
+ * \ingroup module_nbnxm
+ */
+#include "gmxpre.h"
+
+#include "hippackedxq_runner.h"
+
+#include <vector>
+
+#include "gromacs/gpu_utils/devicebuffer.h"
+#include "gromacs/gpu_utils/hiputils.hpp"
+#include "gromacs/gpu_utils/typecasts.hpp"
+#include "gromacs/hardware/device_information.h"
+#include "gromacs/nbnxm/hip/nbnxm_hip_kernel_utils.hpp"
+
+#include "testutils/test_device.h"
+
+namespace gmx
+{
+
+namespace test
+{
+
+/*! \brief Kernel unpacking the coordinates and charges of all atoms as the non-bonded kernels do.
+ *
+ * \param[in]  atdat      The atom data with the packed coordinates and cluster centers
+ * \param[in]  numAtoms   The number of atoms
+ * \param[in]  useBf16    Whether the coordinate offsets are stored as BF16
+ * \param[out] gm_xq      The unpacked coordinates and charges
+ */
+static __global__ void unpackXqKernel(NBAtomDataGpu atdat, int numAtoms, bool useBf16, float4* gm_xq)
+{
+    const int atom = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (atom < numAtoms)
+    {
+        gm_xq[atom] = unpack_xq_j(atdat.xqPacked[atom], atdat.xClusterCenter[atom / c_clSize], useBf16);
+    }
+}
+
+HipPackedXqOutput runHipPackedXq(ArrayRef<const RVec>  coordinates,
+                                 ArrayRef<const float> charges,
+                                 bool                  useBf16,
+                                 const TestDevice&     testDevice)
+{
+    const DeviceContext& deviceContext = testDevice.deviceContext();
+    const DeviceStream&  deviceStream  = testDevice.deviceStream();
+
+    setActiveDevice(testDevice.deviceInfo());
+
+    const int numAtoms = coordinates.ssize();
+    GMX_RELEASE_ASSERT(numAtoms % c_clSize == 0, "Need whole clusters");
+    GMX_RELEASE_ASSERT(charges.ssize() == numAtoms, "Need one charge per atom");
+    const int numClusters = numAtoms / c_clSize;
+
+    std::vector<float4> xq(numAtoms);
+    for (int a = 0; a < numAtoms; a++)
+    {
+        xq[a] = make_float4(coordinates[a][XX], coordinates[a][YY], coordinates[a][ZZ], charges[a]);
+    }
+
+    NBAtomDataGpu        atdat{};
+    DeviceBuffer<float4> d_xqUnpacked;
+    allocateDeviceBuffer(&atdat.xq, numAtoms, deviceContext);
+    allocateDeviceBuffer(&atdat.xqPacked, numAtoms, deviceContext);
+    allocateDeviceBuffer(&atdat.xClusterCenter, numClusters, deviceContext);
+    allocateDeviceBuffer(&d_xqUnpacked, numAtoms, deviceContext);
+
+    copyToDeviceBuffer(&atdat.xq, xq.data(), 0, numAtoms, deviceStream, GpuApiCallBehavior::Sync, nullptr);
+
+    constexpr unsigned int c_blockSize = 64U;
+
+    KernelLaunchConfig config;
+    config.blockSize[0]     = c_blockSize;
+    config.blockSize[1]     = 1;
+    config.blockSize[2]     = 1;
+    config.gridSize[0]      = (numClusters + c_blockSize - 1) / c_blockSize;
+    config.sharedMemorySize = 0;
+
+    const auto packKernel     = nbnxn_kernel_pack_xq<c_blockSize>;
+    const auto packKernelArgs = prepareGpuKernelArguments(packKernel, config, &atdat, &numClusters, &useBf16);
+    launchGpuKernel(packKernel, config, deviceStream, nullptr, "nbnxn_kernel_pack_xq", packKernelArgs);
+
+    config.gridSize[0]          = (numAtoms + c_blockSize - 1) / c_blockSize;
+    const auto unpackKernel     = unpackXqKernel;
+    const auto unpackKernelArgs = prepareGpuKernelArguments(
+            unpackKernel, config, &atdat, &numAtoms, &useBf16, &d_xqUnpacked);
+    launchGpuKernel(unpackKernel, config, deviceStream, nullptr, "unpackXqKernel", unpackKernelArgs);
+
+    copyFromDeviceBuffer(
+            xq.data(), &d_xqUnpacked, 0, numAtoms, deviceStream, GpuApiCallBehavior::Sync, nullptr);
+
+    freeDeviceBuffer(&atdat.xq);
+    freeDeviceBuffer(&atdat.xqPacked);
+    freeDeviceBuffer(&atdat.xClusterCenter);
+    freeDeviceBuffer(&d_xqUnpacked);
+
+    HipPackedXqOutput output;
+    output.coordinates.resize(numAtoms);
+    output.charges.resize(numAtoms);
+    for (int a = 0; a < numAtoms; a++)
+    {
+        output.coordinates[a] = { xq[a].x, xq[a].y, xq[a].z };
+        output.charges[a]     = xq[a].w;
+    }
+
+    return output;
+}
+
+} // namespace test
+} // namespace gmx
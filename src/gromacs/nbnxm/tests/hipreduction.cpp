@@ -0,0 +1,119 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests that the DPP/ds_swizzle based reductions of the HIP non-bonded
+ * kernels agree with the shuffle-based ones and with a reference sum.
+ *
+ * \ingroup module_nbnxm
+ */
+#include "gmxpre.h"
+
+#include "config.h"
+
+#if GMX_GPU_HIP
+
+#    include <vector>
+
+#    include <gtest/gtest.h>
+
+#    include "gromacs/hardware/device_information.h"
+#    include "gromacs/hardware/device_management.h"
+#    include "gromacs/nbnxm/pairlistparams.h"
+#    include "gromacs/random/threefry.h"
+#    include "gromacs/random/uniformrealdistribution.h"
+
+#    include "testutils/test_hardware_environment.h"
+#    include "testutils/testasserts.h"
+#    include "testutils/testmatchers.h"
+
+#    include "hipreduction_runner.h"
+
+namespace gmx
+{
+
+namespace test
+{
+
+namespace
+{
+
+TEST(HipReductionTest, DppReductionMatchesShuffleReduction)
+{
+    constexpr int c_clusterSize = c_nbnxnGpuClusterSize;
+    constexpr int c_numLanes    = c_clusterSize * c_clusterSize;
+
+    DefaultRandomEngine                rng(1234);
+    UniformRealDistribution<float>     dist(-1.0F, 1.0F);
+    std::vector<RVec>                  forces(c_numLanes);
+    std::vector<float>                 energies(2 * c_numLanes);
+    std::vector<RVec>                  referenceForces(c_clusterSize, { 0.0F, 0.0F, 0.0F });
+    float                              referenceEnergies[2] = { 0.0F, 0.0F };
+    for (int lane = 0; lane < c_numLanes; lane++)
+    {
+        forces[lane] = { dist(rng), dist(rng), dist(rng) };
+        /* Lanes with the same i index, lane % clusterSize, contribute to the same i-atom */
+        referenceForces[lane % c_clusterSize] += forces[lane];
+        for (int e = 0; e < 2; e++)
+        {
+            energies[2 * lane + e] = dist(rng);
+            referenceEnergies[e] += energies[2 * lane + e];
+        }
+    }
+
+    const FloatingPointTolerance tolerance = relativeToleranceAsFloatingPoint(c_numLanes, 1e-5);
+
+    for (const auto& testDevice : getTestHardwareEnvironment()->getTestDeviceList())
+    {
+        if (testDevice->deviceInfo().prop.warpSize != c_numLanes)
+        {
+            continue;
+        }
+        setActiveDevice(testDevice->deviceInfo());
+
+        const HipReductionOutput output = runHipReductions(forces, energies, *testDevice);
+
+        EXPECT_THAT(output.forcesShuffle, testing::Pointwise(RVecEq(tolerance), referenceForces));
+        EXPECT_THAT(output.forcesDpp, testing::Pointwise(RVecEq(tolerance), referenceForces));
+        EXPECT_FLOAT_EQ_TOL(referenceEnergies[0], output.energies[0], tolerance);
+        EXPECT_FLOAT_EQ_TOL(referenceEnergies[1], output.energies[1], tolerance);
+    }
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
+
+#endif // GMX_GPU_HIP
@@ -0,0 +1,82 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Declares the runners for the tests of the HIP non-bonded kernel reductions.
+ *
+ * \ingroup module_nbnxm
+ */
+#ifndef GMX_NBNXM_TESTS_HIPREDUCTION_RUNNER_H
+#define GMX_NBNXM_TESTS_HIPREDUCTION_RUNNER_H
+
+#include <vector>
+
+#include "gromacs/math/vectypes.h"
+#include "gromacs/utility/arrayref.h"
+
+namespace gmx
+{
+
+namespace test
+{
+
+class TestDevice;
+
+/*! \brief Results of the reductions of one 8x8 tile of lanes. */
+struct HipReductionOutput
+{
+    //! The i-forces from the shuffle-based reduction
+    std::vector<RVec> forcesShuffle;
+    //! The i-forces from the DPP/ds_swizzle based reduction
+    std::vector<RVec> forcesDpp;
+    //! The two energies summed over all lanes
+    float energies[2];
+};
+
+/*! \brief Runs the i-force and energy reductions of the HIP non-bonded kernels on the device.
+ *
+ * \param[in]  forces     The force of each of the 64 lanes, lane = j * clusterSize + i
+ * \param[in]  energies   The two energies of each of the 64 lanes
+ * \param[in]  testDevice The device to run on, needs to have 64-wide wavefronts
+ * \returns the reduced forces on the i-atoms and the reduced energies
+ */
+HipReductionOutput runHipReductions(ArrayRef<const RVec>  forces,
+                                    ArrayRef<const float> energies,
+                                    const TestDevice&     testDevice);
+
+} // namespace test
+} // namespace gmx
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Runners for the tests of the HIP non-bonded kernel reductions.
+ *
+ * \ingroup module_nbnxm
+ */
+#include "gmxpre.h"
+
+#include "hipreduction_runner.h"
+
+#include <vector>
+
+#include "gromacs/gpu_utils/devicebuffer.h"
+#include "gromacs/gpu_utils/hiputils.hpp"
+#include "gromacs/gpu_utils/typecasts.hpp"
+#include "gromacs/hardware/device_information.h"
+#include "gromacs/nbnxm/hip/nbnxm_hip_kernel_utils.hpp"
+
+#include "testutils/test_device.h"
+
+namespace gmx
+{
+
+namespace test
+{
+
+/*! \brief Kernel running both i-force reductions and the energy reduction on one 8x8 tile.
+ *
+ * \param[in]  gm_forces        Force per lane
+ * \param[in]  gm_energies      Two energies per lane
+ * \param[out] gm_forcesShuffle Reduced i-forces using reduce_force_i_warp_shfl()
+ * \param[out] gm_forcesDpp     Reduced i-forces using reduce_force_i_dpp()
+ * \param[out] gm_energySums    Reduced energies, has to be zeroed before the launch
+ */
+static __global__ void reductionKernel(const float3* gm_forces,
+                                       const float*  gm_energies,
+                                       float*        gm_forcesShuffle,
+                                       float*        gm_forcesDpp,
+                                       float*        gm_energySums)
+{
+    const unsigned int tidxi = threadIdx.x;
+    const unsigned int tidxj = threadIdx.y;
+    const unsigned int tidx  = tidxj * c_clSize + tidxi;
+
+    const float3 f = gm_forces[tidx];
+
+    /* The shuffle path holds component tidxi of the force on atom tidxj */
+    const float fShuffle = reduce_force_i_warp_shfl(f, tidxi, tidxj);
+    if (tidxi < 3)
+    {
+        gm_forcesShuffle[tidxj * 3 + tidxi] = fShuffle;
+    }
+
+    /* The DPP path holds a lane-row dependent component of the force on atom tidxi */
+    const float fDpp      = reduce_force_i_dpp(f, tidxj);
+    const int   component = reduce_force_i_dpp_component(tidxj);
+    if (component >= 0)
+    {
+        gm_forcesDpp[tidxi * 3 + component] = fDpp;
+    }
+
+    reduce_energy_warp_shfl(
+            gm_energies[2 * tidx], gm_energies[2 * tidx + 1], gm_energySums, gm_energySums + 1, tidx);
+}
+
+HipReductionOutput runHipReductions(ArrayRef<const RVec>  forces,
+                                    ArrayRef<const float> energies,
+                                    const TestDevice&     testDevice)
+{
+    const DeviceContext& deviceContext = testDevice.deviceContext();
+    const DeviceStream&  deviceStream  = testDevice.deviceStream();
+
+    setActiveDevice(testDevice.deviceInfo());
+
+    constexpr int c_numLanes = c_clSize * c_clSize;
+    GMX_RELEASE_ASSERT(forces.ssize() == c_numLanes, "Need one force per lane");
+    GMX_RELEASE_ASSERT(energies.ssize() == 2 * c_numLanes, "Need two energies per lane");
+
+    DeviceBuffer<float3> d_forces;
+    DeviceBuffer<float>  d_energies;
+    DeviceBuffer<float>  d_forcesShuffle;
+    DeviceBuffer<float>  d_forcesDpp;
+    DeviceBuffer<float>  d_energySums;
+    allocateDeviceBuffer(&d_forces, c_numLanes, deviceContext);
+    allocateDeviceBuffer(&d_energies, 2 * c_numLanes, deviceContext);
+    allocateDeviceBuffer(&d_forcesShuffle, c_clSize * DIM, deviceContext);
+    allocateDeviceBuffer(&d_forcesDpp, c_clSize * DIM, deviceContext);
+    allocateDeviceBuffer(&d_energySums, 2, deviceContext);
+
+    copyToDeviceBuffer(&d_forces,
+                       reinterpret_cast<const float3*>(forces.data()),
+                       0,
+                       c_numLanes,
+                       deviceStream,
+                       GpuApiCallBehavior::Sync,
+                       nullptr);
+    copyToDeviceBuffer(
+            &d_energies, energies.data(), 0, 2 * c_numLanes, deviceStream, GpuApiCallBehavior::Sync, nullptr);
+    clearDeviceBufferAsync(&d_energySums, 0, 2, deviceStream);
+
+    KernelLaunchConfig config;
+    config.gridSize[0]      = 1;
+    config.blockSize[0]     = c_clSize;
+    config.blockSize[1]     = c_clSize;
+    config.blockSize[2]     = 1;
+    config.sharedMemorySize = 0;
+
+    const auto kernelPtr  = reductionKernel;
+    const auto kernelArgs = prepareGpuKernelArguments(
+            kernelPtr, config, &d_forces, &d_energies, &d_forcesShuffle, &d_forcesDpp, &d_energySums);
+    launchGpuKernel(kernelPtr, config, deviceStream, nullptr, "reductionKernel", kernelArgs);
+
+    HipReductionOutput output;
+    output.forcesShuffle.resize(c_clSize);
+    output.forcesDpp.resize(c_clSize);
+    copyFromDeviceBuffer(output.forcesShuffle.data()->as_vec(),
+                         &d_forcesShuffle,
+                         0,
+                         c_clSize * DIM,
+                         deviceStream,
+                         GpuApiCallBehavior::Sync,
+                         nullptr);
+    copyFromDeviceBuffer(output.forcesDpp.data()->as_vec(),
+                         &d_forcesDpp,
+                         0,
+                         c_clSize * DIM,
+                         deviceStream,
+                         GpuApiCallBehavior::Sync,
+                         nullptr);
+    copyFromDeviceBuffer(output.energies, &d_energySums, 0, 2, deviceStream, GpuApiCallBehavior::Sync, nullptr);
+
+    freeDeviceBuffer(&d_forces);
+    freeDeviceBuffer(&d_energies);
+    freeDeviceBuffer(&d_forcesShuffle);
+    freeDeviceBuffer(&d_forcesDpp);
+    freeDeviceBuffer(&d_energySums);
+
+    return output;
+}
+
+} // namespace test
+} // namespace gmx
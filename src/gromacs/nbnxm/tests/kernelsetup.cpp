@@ -201,6 +201,16 @@ TEST(KernelSetupTest, getVdwKernelTypeLjCutPotSwitch)
               vdwktLJPOTSWITCH);
 }
 
+TEST(KernelSetupTest, getVdwKernelTypeUserTable)
+{
+    EXPECT_EQ(getVdwKernelType(Nbnxm::KernelType::Cpu4x4_PlainC,
+                               LJCombinationRule::None,
+                               VanDerWaalsType::User,
+                               InteractionModifiers::None,
+                               LongRangeVdW::Count),
+              vdwktUSERTAB);
+}
+
 TEST(KernelSetupTest, getVdwKernelTypeAllCountThrows)
 {
     // Count cannot be used for VanDerWaalsType or InteractionModifiers because of calls to
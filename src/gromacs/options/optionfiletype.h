@@ -63,6 +63,7 @@ enum class OptionFileType : int
     GenericData,
     Csv,
     QMInput,
+    Json,
     Count
 };
 
@@ -568,6 +568,28 @@ static void mk_1shift_screw(const matrix box, const rvec hbox, const rvec xi, co
     }
 }
 
+void mk_1shift_pbc(int          npbcdim,
+                   const matrix box,
+                   const rvec   xi,
+                   const rvec   xj,
+                   const ivec   mi,
+                   ivec         mj)
+{
+    rvec hbox;
+    for (int m = 0; (m < DIM); m++)
+    {
+        hbox[m] = box[m][m] * 0.5;
+    }
+    if (TRICLINIC(box))
+    {
+        mk_1shift_tric(npbcdim, box, hbox, xi, xj, mi, mj);
+    }
+    else
+    {
+        mk_1shift(npbcdim, hbox, xi, xj, mi, mj);
+    }
+}
+
 static int mk_grey(ArrayRef<egCol> edgeColor,
                    t_graph*        g,
                    int*            AtomI,
@@ -142,6 +142,17 @@ void p_graph(FILE* log, const char* title, const t_graph* g);
 void mk_mshift(FILE* log, t_graph* g, PbcType pbcType, const matrix box, const rvec x[]);
 /* Calculate the mshift codes, based on the connection graph in g. */
 
+void mk_1shift_pbc(int          npbcdim,
+                   const matrix box,
+                   const rvec   xi,
+                   const rvec   xj,
+                   const ivec   mi,
+                   ivec         mj);
+/* Calculate the mshift code mj of atom j, bonded to atom i with mshift code mi,
+ * using the same criterion as mk_mshift() for rectangular and triclinic boxes.
+ * Does not support screw PBC.
+ */
+
 void shift_x(const t_graph* g, const matrix box, const rvec x[], rvec x_s[]);
 /* Add the shift vector to x, and store in x_s (may be same array as x) */
 
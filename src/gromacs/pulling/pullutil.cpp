@@ -42,6 +42,8 @@
 #include <cassert>
 #include <cstdlib>
 
+#include <vector>
+
 #include "gromacs/fileio/confio.h"
 #include "gromacs/gmxlib/network.h"
 #include "gromacs/math/functions.h"
@@ -171,6 +173,92 @@ static void pull_set_pbcatoms(const t_commrec* cr, struct pull_t* pull, ArrayRef
     }
 }
 
+//! Partial sums over the reference group atoms for a cylinder group
+struct CylinderSums
+{
+    //! Sum of mass times weight times axial location
+    double sum_a = 0;
+    //! Sum of mass times weight
+    double wmass = 0;
+    //! Sum of mass times weight squared
+    double wwmass = 0;
+    //! Sum of mass times the radial weight derivative
+    dvec radf_fac0 = { 0, 0, 0 };
+    //! Sum of mass times the radial weight derivative times axial location
+    dvec radf_fac1 = { 0, 0, 0 };
+};
+
+/*! \brief Computes the cylinder weights and partial sums for atoms ind_start to ind_end
+ * of the reference group \p pref, stores the weights in \p pdyna and adds to \p sums.
+ */
+static void sum_cyl_refgrp_part(const pull_group_work_t& pref,
+                                pull_group_work_t*       pdyna,
+                                int                      ind_start,
+                                int                      ind_end,
+                                ArrayRef<const real>     masses,
+                                ArrayRef<const RVec>     x,
+                                const t_pbc&             pbc,
+                                const rvec               reference,
+                                const rvec               direction,
+                                double                   inv_cyl_r2,
+                                CylinderSums*            sums)
+{
+    auto localAtomIndices = pref.atomSet.localIndex();
+
+    for (int indexInSet = ind_start; indexInSet < ind_end; indexInSet++)
+    {
+        int  atomIndex = localAtomIndices[indexInSet];
+        rvec dx;
+        pbc_dx_aiuc(&pbc, x[atomIndex], reference, dx);
+        double axialLocation = iprod(direction, dx);
+        dvec   radialLocation;
+        double dr2 = 0;
+        for (int m = 0; m < DIM; m++)
+        {
+            /* Determine the radial components */
+            radialLocation[m] = dx[m] - axialLocation * direction[m];
+            dr2 += gmx::square(radialLocation[m]);
+        }
+        double dr2_rel = dr2 * inv_cyl_r2;
+
+        if (dr2_rel < 1)
+        {
+            /* add atom to sum of COM and to weight array */
+
+            double mass = masses[atomIndex];
+            /* The radial weight function is 1-2x^2+x^4,
+             * where x=r/cylinder_r. Since this function depends
+             * on the radial component, we also get radial forces
+             * on both groups.
+             */
+            double weight                   = 1 + (-2 + dr2_rel) * dr2_rel;
+            double dweight_r                = (-4 + 4 * dr2_rel) * inv_cyl_r2;
+            pdyna->localWeights[indexInSet] = weight;
+            sums->sum_a += mass * weight * axialLocation;
+            sums->wmass += mass * weight;
+            sums->wwmass += mass * weight * weight;
+            dvec mdw;
+            dsvmul(mass * dweight_r, radialLocation, mdw);
+            copy_dvec(mdw, pdyna->mdw[indexInSet]);
+            /* Currently we only have the axial component of the
+             * offset from the cylinder COM up to an unkown offset.
+             * We add this offset after the reduction needed
+             * for determining the COM of the cylinder group.
+             */
+            pdyna->dv[indexInSet] = axialLocation;
+            for (int m = 0; m < DIM; m++)
+            {
+                sums->radf_fac0[m] += mdw[m];
+                sums->radf_fac1[m] += mdw[m] * axialLocation;
+            }
+        }
+        else
+        {
+            pdyna->localWeights[indexInSet] = 0;
+        }
+    }
+}
+
 static void make_cyl_refgrps(const t_commrec*     cr,
                              pull_t*              pull,
                              ArrayRef<const real> masses,
@@ -189,14 +277,7 @@ static void make_cyl_refgrps(const t_commrec*     cr,
     int bufferOffset = 0;
     for (pull_coord_work_t& pcrd : pull->coord)
     {
-        double sum_a, wmass, wwmass;
-        dvec   radf_fac0, radf_fac1;
-
-        sum_a  = 0;
-        wmass  = 0;
-        wwmass = 0;
-        clear_dvec(radf_fac0);
-        clear_dvec(radf_fac1);
+        CylinderSums sums;
 
         if (pcrd.params.eGeom == PullGroupGeometry::Cylinder)
         {
@@ -234,56 +315,49 @@ static void make_cyl_refgrps(const t_commrec*     cr,
             pdyna.dv.resize(localAtomIndices.size());
 
             /* loop over all atoms in the main ref group */
-            for (gmx::index indexInSet = 0; indexInSet < localAtomIndices.ssize(); indexInSet++)
+            const int numThreads = pref.numThreads();
+            if (numThreads == 1)
             {
-                int  atomIndex = localAtomIndices[indexInSet];
-                rvec dx;
-                pbc_dx_aiuc(&pbc, x[atomIndex], reference, dx);
-                double axialLocation = iprod(direction, dx);
-                dvec   radialLocation;
-                double dr2 = 0;
-                for (int m = 0; m < DIM; m++)
-                {
-                    /* Determine the radial components */
-                    radialLocation[m] = dx[m] - axialLocation * direction[m];
-                    dr2 += gmx::square(radialLocation[m]);
-                }
-                double dr2_rel = dr2 * inv_cyl_r2;
-
-                if (dr2_rel < 1)
+                sum_cyl_refgrp_part(pref,
+                                    &pdyna,
+                                    0,
+                                    localAtomIndices.ssize(),
+                                    masses,
+                                    x,
+                                    pbc,
+                                    reference,
+                                    direction,
+                                    inv_cyl_r2,
+                                    &sums);
+            }
+            else
+            {
+                std::vector<CylinderSums> threadSums(numThreads);
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+                for (int th = 0; th < numThreads; th++)
                 {
-                    /* add atom to sum of COM and to weight array */
-
-                    double mass = masses[atomIndex];
-                    /* The radial weight function is 1-2x^2+x^4,
-                     * where x=r/cylinder_r. Since this function depends
-                     * on the radial component, we also get radial forces
-                     * on both groups.
-                     */
-                    double weight                  = 1 + (-2 + dr2_rel) * dr2_rel;
-                    double dweight_r               = (-4 + 4 * dr2_rel) * inv_cyl_r2;
-                    pdyna.localWeights[indexInSet] = weight;
-                    sum_a += mass * weight * axialLocation;
-                    wmass += mass * weight;
-                    wwmass += mass * weight * weight;
-                    dvec mdw;
-                    dsvmul(mass * dweight_r, radialLocation, mdw);
-                    copy_dvec(mdw, pdyna.mdw[indexInSet]);
-                    /* Currently we only have the axial component of the
-                     * offset from the cylinder COM up to an unkown offset.
-                     * We add this offset after the reduction needed
-                     * for determining the COM of the cylinder group.
-                     */
-                    pdyna.dv[indexInSet] = axialLocation;
-                    for (int m = 0; m < DIM; m++)
-                    {
-                        radf_fac0[m] += mdw[m];
-                        radf_fac1[m] += mdw[m] * axialLocation;
-                    }
+                    int ind_start = (localAtomIndices.size() * (th + 0)) / numThreads;
+                    int ind_end   = (localAtomIndices.size() * (th + 1)) / numThreads;
+                    sum_cyl_refgrp_part(pref,
+                                        &pdyna,
+                                        ind_start,
+                                        ind_end,
+                                        masses,
+                                        x,
+                                        pbc,
+                                        reference,
+                                        direction,
+                                        inv_cyl_r2,
+                                        &threadSums[th]);
                 }
-                else
+                /* Reduce the thread contributions in a fixed order */
+                for (const CylinderSums& threadSum : threadSums)
                 {
-                    pdyna.localWeights[indexInSet] = 0;
+                    sums.sum_a += threadSum.sum_a;
+                    sums.wmass += threadSum.wmass;
+                    sums.wwmass += threadSum.wwmass;
+                    dvec_inc(sums.radf_fac0, threadSum.radf_fac0);
+                    dvec_inc(sums.radf_fac1, threadSum.radf_fac1);
                 }
             }
         }
@@ -292,17 +366,17 @@ static void make_cyl_refgrps(const t_commrec*     cr,
                                              c_cylinderBufferStride);
         bufferOffset += c_cylinderBufferStride;
 
-        buffer[0] = wmass;
-        buffer[1] = wwmass;
-        buffer[2] = sum_a;
+        buffer[0] = sums.wmass;
+        buffer[1] = sums.wwmass;
+        buffer[2] = sums.sum_a;
 
-        buffer[3] = radf_fac0[XX];
-        buffer[4] = radf_fac0[YY];
-        buffer[5] = radf_fac0[ZZ];
+        buffer[3] = sums.radf_fac0[XX];
+        buffer[4] = sums.radf_fac0[YY];
+        buffer[5] = sums.radf_fac0[ZZ];
 
-        buffer[6] = radf_fac1[XX];
-        buffer[7] = radf_fac1[YY];
-        buffer[8] = radf_fac1[ZZ];
+        buffer[6] = sums.radf_fac1[XX];
+        buffer[7] = sums.radf_fac1[YY];
+        buffer[8] = sums.radf_fac1[ZZ];
     }
 
     if (cr != nullptr && PAR(cr))
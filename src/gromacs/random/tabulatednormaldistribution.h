@@ -166,8 +166,8 @@ public:
      *  This routine returns a new a std::array with the table data.
      *
      *  This routine is used to help construct objects of this class,
-     *  and is exposed only to permit testing. Normal code should not
-     *  need to call this function.
+     *  and is exposed to permit testing and to let GPU code upload the
+     *  same table. Normal code should not need to call this function.
      */
     static std::array<RealType, 1 << tableBits> makeTable()
     {
@@ -42,6 +42,8 @@
 
 #include "gromacs/random/threefry.h"
 
+#include <array>
+
 #include <gtest/gtest.h>
 
 #include "gromacs/utility/exceptions.h"
@@ -218,6 +220,28 @@ TEST_F(ThreeFry2x64Test, Discard)
     EXPECT_EQ(rngA, rngB);
 }
 
+TEST_F(ThreeFry2x64Test, FirstValuesMatchRestart)
+{
+    gmx::ThreeFry2x64<0>     rngA(123456, gmx::RandomDomain::UpdateCoordinates);
+    gmx::ThreeFry2x64Fast<8> rngB(123456, gmx::RandomDomain::Other);
+
+    std::array<uint64_t, 7> ctr0;
+    std::array<uint64_t, 7> ctr1;
+    for (std::size_t i = 0; i < ctr0.size(); i++)
+    {
+        ctr0[i] = 1000 + i / 3;
+        ctr1[i] = 17 * i;
+    }
+    const auto valuesA = rngA.firstValues(ctr0, ctr1);
+    const auto valuesB = rngB.firstValues(ctr0, ctr1);
+    for (std::size_t i = 0; i < ctr0.size(); i++)
+    {
+        rngA.restart(ctr0[i], ctr1[i]);
+        EXPECT_EQ(rngA(), valuesA[i]);
+        rngB.restart(ctr0[i], ctr1[i]);
+        EXPECT_EQ(rngB(), valuesB[i]);
+    }
+}
 
 TEST_F(ThreeFry2x64Test, InvalidCounter)
 {
@@ -225,6 +249,9 @@ TEST_F(ThreeFry2x64Test, InvalidCounter)
 
     // Highest 10 bits of counter reserved for the internal counter.
     EXPECT_THROW_GMX(rngA.restart(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF), gmx::InternalError);
+    EXPECT_THROW_GMX(rngA.firstValues(std::array<uint64_t, 1>{ { 0 } },
+                                      std::array<uint64_t, 1>{ { 0xFFFFFFFFFFFFFFFF } }),
+                     gmx::InternalError);
 }
 
 TEST_F(ThreeFry2x64Test, ExhaustInternalCounter)
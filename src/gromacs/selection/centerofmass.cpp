@@ -484,6 +484,62 @@ void gmx_calc_comg_f_block(const gmx_mtop_t* top,
     }
 }
 
+void gmx_calc_comg_block_masses(const real     mass[],
+                                rvec           x[],
+                                const t_block* block,
+                                const int      index[],
+                                bool           bMass,
+                                rvec           xout[])
+{
+    if (!bMass)
+    {
+        gmx_calc_cog_block(nullptr, x, block, index, xout);
+        return;
+    }
+    for (int b = 0; b < block->nr; ++b)
+    {
+        real xb[DIM] = { 0, 0, 0 };
+        real mtot    = 0;
+        for (int i = block->index[b]; i < block->index[b + 1]; ++i)
+        {
+            const real* xi = x[index[i]];
+            xb[XX] += mass[i] * xi[XX];
+            xb[YY] += mass[i] * xi[YY];
+            xb[ZZ] += mass[i] * xi[ZZ];
+            mtot += mass[i];
+        }
+        svmul(1.0 / mtot, xb, xout[b]);
+    }
+}
+
+void gmx_calc_comg_f_block_masses(const real     mass[],
+                                  rvec           f[],
+                                  const t_block* block,
+                                  const int      index[],
+                                  bool           bMass,
+                                  rvec           fout[])
+{
+    if (bMass)
+    {
+        gmx_calc_com_f_block(nullptr, f, block, index, fout);
+        return;
+    }
+    for (int b = 0; b < block->nr; ++b)
+    {
+        real fb[DIM] = { 0, 0, 0 };
+        real mtot    = 0;
+        for (int i = block->index[b]; i < block->index[b + 1]; ++i)
+        {
+            const real* fi = f[index[i]];
+            fb[XX] += fi[XX] / mass[i];
+            fb[YY] += fi[YY] / mass[i];
+            fb[ZZ] += fi[ZZ] / mass[i];
+            mtot += mass[i];
+        }
+        svmul(mtot / (block->index[b + 1] - block->index[b]), fb, fout[b]);
+    }
+}
+
 /*!
  * \param[in]  top   Topology structure with masses
  *   (can be NULL if \p bMASS==false).
@@ -66,6 +66,11 @@
  * group (as a \c t_block structure), and calculate the centers for
  * each group defined by the \c t_block structure separately.
  *
+ * The functions gmx_calc_comg_block_masses() and gmx_calc_comg_f_block_masses()
+ * work in the same way, but take the masses of the atoms as an array instead
+ * of looking them up in the topology. This is faster when the same centers
+ * are calculated for many frames.
+ *
  * Finally, there is a function gmx_calc_comg_blocka() that takes both the
  * index group and the partitioning as a single \c t_blocka structure.
  *
@@ -162,6 +167,40 @@ void gmx_calc_comg_f_block(const gmx_mtop_t* top,
                            const int         index[],
                            bool              bMass,
                            rvec              fout[]);
+/*! \brief
+ * Calculate centers of mass/geometry for a blocked index with given masses.
+ *
+ * \param[in]  mass  Mass of each atom in \p index (i.e., \p mass[i] is
+ *   the mass of atom \p index[i]); can be NULL if \p bMass==false.
+ * \param[in]  x     Position vectors of all atoms.
+ * \param[in]  block t_block structure that divides \p index into blocks.
+ * \param[in]  index Indices of atoms.
+ * \param[in]  bMass If true, mass weighting is used.
+ * \param[out] xout  \p block->nr COM/COG positions.
+ */
+void gmx_calc_comg_block_masses(const real     mass[],
+                                rvec           x[],
+                                const t_block* block,
+                                const int      index[],
+                                bool           bMass,
+                                rvec           xout[]);
+/*! \brief
+ * Calculate forces on centers of mass/geometry for a blocked index with given masses.
+ *
+ * \param[in]  mass  Mass of each atom in \p index (i.e., \p mass[i] is
+ *   the mass of atom \p index[i]); can be NULL if \p bMass==true.
+ * \param[in]  f     Forces on all atoms.
+ * \param[in]  block t_block structure that divides \p index into blocks.
+ * \param[in]  index Indices of atoms.
+ * \param[in]  bMass If true, force on COM is calculated.
+ * \param[out] fout  \p block->nr forces on the COM/COG positions.
+ */
+void gmx_calc_comg_f_block_masses(const real     mass[],
+                                  rvec           f[],
+                                  const t_block* block,
+                                  const int      index[],
+                                  bool           bMass,
+                                  rvec           fout[]);
 /** Calculate centers of mass/geometry for a set of blocks; */
 void gmx_calc_comg_blocka(const gmx_mtop_t* top, rvec x[], const t_blocka* block, bool bMass, rvec xout[]);
 /** Calculate forces on centers of mass/geometry for a set of blocks; */
@@ -49,6 +49,19 @@
  * converting selections by residue/molecule into selections by atom
  * when necessary.
  *
+ * \todo
+ * Dynamic selections are evaluated from scratch for every frame, even if
+ * most atoms keep the same value of a geometric predicate between frames.
+ * Incremental evaluation, similar to a buffered pair list, could help for
+ * expensive keywords such as \p within and \p insolidangle: the method
+ * would evaluate with a buffer added to the cutoff, store the atom
+ * positions, and later evaluate only the atoms that have moved by more
+ * than the buffer (taking the motion of the reference positions into
+ * account).  This would need a way for methods to keep state between
+ * frames that is invalidated when their input group changes, and the
+ * evaluation code would need to know which subexpression values are safe
+ * to keep.
+ *
  * \author Teemu Murtola <teemu.murtola@gmail.com>
  * \ingroup module_selection
  */
@@ -125,6 +125,7 @@ public:
     typedef AnalysisNeighborhoodPairSearch::ImplPointer PairSearchImplPointer;
     typedef std::vector<PairSearchImplPointer>          PairSearchList;
     typedef std::vector<std::vector<int>>               CellList;
+    typedef std::vector<std::vector<RVec>>              CellPositionList;
 
     explicit AnalysisNeighborhoodSearchImpl(real cutoff);
     ~AnalysisNeighborhoodSearchImpl();
@@ -157,9 +158,32 @@ private:
      *     be forced to use a single cell.
      * \param[in] posCount     Number of positions that will be put on the
      *     grid.
+     * \param[in] x            Positions that will be put on the grid.
      * \returns   `false` if grid search is not suitable.
+     *
+     * \p gridOrigin_ and \p bGridPBC_ should be initialized.
+     */
+    bool initGridCells(const matrix box, bool bSingleCell[DIM], int posCount, const rvec x[]);
+    /*! \brief
+     * Estimates the fraction of the grid volume that contains positions.
+     *
+     * \param[in] box         Box vectors as for initGridCells().
+     * \param[in] bSingleCell Dimensions that use a single grid cell.
+     * \param[in] cellSize    Approximate grid cell size to use for the
+     *     estimate.
+     * \param[in] posCount    Number of positions in \p x.
+     * \param[in] x           Positions that will be put on the grid.
+     * \returns   Fraction of cells of size \p cellSize that contain at
+     *     least one position.
+     *
+     * Triclinic shifts are ignored, as this is only used as an estimate
+     * for selecting the grid cell size.
      */
-    bool initGridCells(const matrix box, bool bSingleCell[DIM], int posCount);
+    real estimateOccupiedFraction(const matrix box,
+                                  const bool   bSingleCell[DIM],
+                                  real         cellSize,
+                                  int          posCount,
+                                  const rvec   x[]) const;
     /*! \brief
      * Sets ua a search grid for a given box.
      *
@@ -205,7 +229,8 @@ private:
      * \param[in]  i    Index to add.
      *
      * \p cell should satisfy the conditions that \p mapPointToGridCell()
-     * produces.
+     * produces. The in-unit-cell position of \p i should already be
+     * stored in \p xref_.
      */
     void addToGridCell(const rvec cell, int i);
     /*! \brief
@@ -320,6 +345,14 @@ private:
     ivec ncelldim_;
     //! Data structure to hold the grid cell contents.
     CellList cells_;
+    /*! \brief
+     * Positions of the points in each grid cell, in the same order as in
+     * \p cells_.
+     *
+     * Storing the positions per cell makes the pair loop read them
+     * contiguously, instead of through the indices in \p cells_.
+     */
+    CellPositionList cellPositions_;
 
     std::mutex     createPairSearchMutex_;
     PairSearchList pairSearchList_;
@@ -468,7 +501,55 @@ AnalysisNeighborhoodSearchImpl::PairSearchImplPointer AnalysisNeighborhoodSearch
     return pairSearch;
 }
 
-bool AnalysisNeighborhoodSearchImpl::initGridCells(const matrix box, bool bSingleCell[DIM], int posCount)
+real AnalysisNeighborhoodSearchImpl::estimateOccupiedFraction(const matrix box,
+                                                              const bool   bSingleCell[DIM],
+                                                              real         cellSize,
+                                                              int          posCount,
+                                                              const rvec   x[]) const
+{
+    ivec cellCount;
+    int  totalCellCount = 1;
+    for (int dd = 0; dd < DIM; ++dd)
+    {
+        cellCount[dd] = bSingleCell[dd] ? 1 : std::max(1, static_cast<int>(box[dd][dd] / cellSize));
+        totalCellCount *= cellCount[dd];
+    }
+    std::vector<bool> isOccupied(totalCellCount, false);
+    int               occupiedCount = 0;
+    for (int i = 0; i < posCount; ++i)
+    {
+        int ci = 0;
+        for (int dd = DIM - 1; dd >= 0; --dd)
+        {
+            int cellIndex = static_cast<int>(
+                    std::floor((x[i][dd] - gridOrigin_[dd]) * cellCount[dd] / box[dd][dd]));
+            if (bGridPBC_[dd])
+            {
+                cellIndex %= cellCount[dd];
+                if (cellIndex < 0)
+                {
+                    cellIndex += cellCount[dd];
+                }
+            }
+            else
+            {
+                cellIndex = std::clamp(cellIndex, 0, cellCount[dd] - 1);
+            }
+            ci = ci * cellCount[dd] + cellIndex;
+        }
+        if (!isOccupied[ci])
+        {
+            isOccupied[ci] = true;
+            ++occupiedCount;
+        }
+    }
+    return static_cast<real>(occupiedCount) / totalCellCount;
+}
+
+bool AnalysisNeighborhoodSearchImpl::initGridCells(const matrix box,
+                                                   bool         bSingleCell[DIM],
+                                                   int          posCount,
+                                                   const rvec   x[])
 {
     // Determine the size of cubes where there are on average 10 positions.
     // The loop takes care of cases where some of the box edges are shorter
@@ -511,6 +592,26 @@ bool AnalysisNeighborhoodSearchImpl::initGridCells(const matrix box, bool bSingl
         targetsize   = pow(volume * 10 / posCount, static_cast<real>(1. / dimCount));
         prevDimCount = dimCount;
     }
+    // For inhomogeneous distributions (e.g., a droplet or a membrane in
+    // vacuum), most of the positions are in a small part of the volume, and
+    // cells based on the average density would contain far too many
+    // positions.  Estimate the occupied part of the volume from a histogram
+    // with the cube size determined above, and shrink the cubes such that
+    // there are on average 10 positions per cell in the occupied part.
+    // Smaller cells do not change the results, only the cost.  The shrinking
+    // is limited to keep the number of cells no larger than the number of
+    // positions.
+    if (prevDimCount > 0 && prevDimCount < 4)
+    {
+        const real occupiedFraction =
+                estimateOccupiedFraction(box, bSingleCell, targetsize, posCount, x);
+        const real minOccupiedFraction = 0.1;
+        if (occupiedFraction < 1)
+        {
+            targetsize *= pow(std::max(occupiedFraction, minOccupiedFraction),
+                              static_cast<real>(1. / prevDimCount));
+        }
+    }
 
     int totalCellCount = 1;
     for (int dd = 0; dd < DIM; ++dd)
@@ -543,10 +644,12 @@ bool AnalysisNeighborhoodSearchImpl::initGridCells(const matrix box, bool bSingl
     if (cells_.size() < static_cast<size_t>(totalCellCount))
     {
         cells_.resize(totalCellCount);
+        cellPositions_.resize(totalCellCount);
     }
     for (int ci = 0; ci < totalCellCount; ++ci)
     {
         cells_[ci].clear();
+        cellPositions_[ci].clear();
     }
     return true;
 }
@@ -612,7 +715,7 @@ bool AnalysisNeighborhoodSearchImpl::initGrid(const t_pbc& pbc, int posCount, co
         }
     }
 
-    if (!initGridCells(box, bSingleCell, posCount))
+    if (!initGridCells(box, bSingleCell, posCount, x))
     {
         return false;
     }
@@ -713,6 +816,7 @@ void AnalysisNeighborhoodSearchImpl::addToGridCell(const rvec cell, int i)
 {
     const int ci = getGridCellIndex(cell);
     cells_[ci].push_back(i);
+    cellPositions_[ci].push_back(xref_[i]);
 }
 
 void AnalysisNeighborhoodSearchImpl::initCellRange(const rvec centerCell, ivec currCell, ivec upperBound, int dim) const
@@ -1079,7 +1183,8 @@ bool AnalysisNeighborhoodPairSearchImpl::searchNext(Action action)
                 {
                     continue;
                 }
-                const int cellSize = ssize(search_.cells_[ci]);
+                const int   cellSize      = ssize(search_.cells_[ci]);
+                const RVec* cellPositions = search_.cellPositions_[ci].data();
                 for (; cai < cellSize; ++cai)
                 {
                     const int i = search_.cells_[ci][cai];
@@ -1092,7 +1197,7 @@ bool AnalysisNeighborhoodPairSearchImpl::searchNext(Action action)
                         continue;
                     }
                     rvec dx;
-                    rvec_sub(search_.xref_[i], xtest_, dx);
+                    rvec_sub(cellPositions[cai], xtest_, dx);
                     rvec_sub(dx, shift, dx);
                     const real r2 = search_.bXY_ ? dx[XX] * dx[XX] + dx[YY] * dx[YY] : norm2(dx);
                     if (r2 <= search_.cutoff2_)
@@ -72,6 +72,8 @@
 
 #include "gromacs/math/vec.h"
 #include "gromacs/selection/indexutil.h"
+#include "gromacs/topology/mtop_lookup.h"
+#include "gromacs/topology/topology.h"
 #include "gromacs/trajectory/trajectoryframe.h"
 #include "gromacs/utility/arrayref.h"
 #include "gromacs/utility/exceptions.h"
@@ -146,6 +148,34 @@ public:
         return tmpFrameAtoms_;
     }
 
+    /*! \brief
+     * Returns the masses of given topology atoms.
+     *
+     * The masses of all atoms are looked up from the topology only once,
+     * which is much faster than looking them up for each atom for each frame.
+     * As with getFrameIndices(), a temporary array is used for the result.
+     */
+    ArrayRef<const real> getMasses(int size, const int index[])
+    {
+        if (atomMasses_.empty())
+        {
+            GMX_RELEASE_ASSERT(gmx_mtop_has_masses(top_),
+                               "No masses available while mass weighting was requested");
+            atomMasses_.resize(top_->natoms);
+            int molb = 0;
+            for (int i = 0; i < top_->natoms; ++i)
+            {
+                atomMasses_[i] = mtopGetAtomMass(*top_, i, &molb);
+            }
+        }
+        tmpMasses_.resize(size);
+        for (int i = 0; i < size; ++i)
+        {
+            tmpMasses_[i] = atomMasses_[index[i]];
+        }
+        return tmpMasses_;
+    }
+
     /*! \brief
      * Topology data.
      *
@@ -163,6 +193,10 @@ public:
     std::vector<int> mapToFrameAtoms_;
     //! Working array for updating positions.
     std::vector<int> tmpFrameAtoms_;
+    //! Masses of all atoms in the topology (empty until first needed).
+    std::vector<real> atomMasses_;
+    //! Working array for the masses of the atoms in a calculation.
+    std::vector<real> tmpMasses_;
 };
 
 } // namespace gmx
@@ -453,6 +487,7 @@ PositionCalculationCollection::~PositionCalculationCollection() {}
 void PositionCalculationCollection::setTopology(const gmx_mtop_t* top)
 {
     impl_->top_ = top;
+    impl_->atomMasses_.clear();
 }
 
 void PositionCalculationCollection::printTree(FILE* fp) const
@@ -1337,20 +1372,33 @@ void gmx_ana_poscalc_update(gmx_ana_poscalc_t* pc,
                 }
                 break;
             default:
+            {
                 // TODO: It would probably be better to do this without the type casts.
-                gmx_calc_comg_block(
-                        top, fr->x, reinterpret_cast<t_block*>(&pc->b), index.data(), bMass, p->x);
-                if (p->v && fr->bV)
+                const t_block* block = reinterpret_cast<t_block*>(&pc->b);
+                const bool     bF    = (p->f && fr->bF);
+                if (bMass || bF)
                 {
-                    gmx_calc_comg_block(
-                            top, fr->v, reinterpret_cast<t_block*>(&pc->b), index.data(), bMass, p->v);
+                    const real* mass = pc->coll->getMasses(pc->b.nra, pc->b.a).data();
+                    gmx_calc_comg_block_masses(mass, fr->x, block, index.data(), bMass, p->x);
+                    if (p->v && fr->bV)
+                    {
+                        gmx_calc_comg_block_masses(mass, fr->v, block, index.data(), bMass, p->v);
+                    }
+                    if (bF)
+                    {
+                        gmx_calc_comg_f_block_masses(mass, fr->f, block, index.data(), bMass, p->f);
+                    }
                 }
-                if (p->f && fr->bF)
+                else
                 {
-                    gmx_calc_comg_f_block(
-                            top, fr->f, reinterpret_cast<t_block*>(&pc->b), index.data(), bMass, p->f);
+                    gmx_calc_comg_block(top, fr->x, block, index.data(), bMass, p->x);
+                    if (p->v && fr->bV)
+                    {
+                        gmx_calc_comg_block(top, fr->v, block, index.data(), bMass, p->v);
+                    }
                 }
                 break;
+            }
         }
     }
 }
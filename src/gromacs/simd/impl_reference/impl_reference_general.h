@@ -67,7 +67,7 @@ namespace gmx
  *        but if the pointer is not aligned the prefetch might start at the
  *        lower cache line boundary (meaning fewer bytes are prefetched).
  */
-static inline void gmx_unused simdPrefetch(void gmx_unused* m)
+static inline void gmx_unused simdPrefetch(const void gmx_unused* m)
 {
     // Do nothing for reference implementation
 }
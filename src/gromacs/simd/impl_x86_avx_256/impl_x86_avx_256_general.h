@@ -41,7 +41,7 @@
 namespace gmx
 {
 
-static inline void simdPrefetch(void* m)
+static inline void simdPrefetch(const void* m)
 {
     _mm_prefetch(reinterpret_cast<const char*>(m), _MM_HINT_T0);
 }
@@ -81,6 +81,21 @@ namespace gmx
  *  \{
  */
 
+/*! \brief Accuracy tier of SIMD math functions.
+ *
+ *  Some callers, e.g. analysis histogramming or grid corrections that are
+ *  anyway limited by other approximations, do not need the full accuracy of
+ *  the default math functions. The functions that accept this as their first
+ *  template parameter then use shorter polynomials and fewer Newton-Raphson
+ *  iterations. The reduced tiers must always be requested explicitly at the
+ *  call site, so the default accuracy of existing code is never affected.
+ */
+enum class MathAccuracy
+{
+    Full,        //!< Full accuracy of the SIMD precision used, same as the default functions.
+    Reduced12Bit //!< At least 12 bits, i.e. a relative error below 2.5e-4, in both precisions.
+};
+
 /*! \} */
 
 #    if GMX_SIMD_HAVE_FLOAT
@@ -5230,6 +5245,240 @@ static inline Simd4Float gmx_simdcall invsqrtSingleAccuracy(Simd4Float x)
 }
 #    endif // GMX_SIMD4_HAVE_FLOAT
 
+/*! \name SIMD math functions with selectable accuracy
+ *
+ *  These functions take a gmx::MathAccuracy as their first template
+ *  parameter. With MathAccuracy::Full they are identical to the default
+ *  functions, while the reduced tiers trade accuracy for speed with
+ *  algorithms that are generic for all SIMD architectures.
+ *  \{
+ */
+
+#    if GMX_SIMD_HAVE_FLOAT
+/*! \brief Calculate 1/sqrt(x) for SIMD float with selectable accuracy.
+ *
+ *  \tparam accuracy The accuracy tier. Reduced12Bit performs only as many
+ *                   Newton-Raphson iterations on the hardware lookup as are
+ *                   needed for 12 bits, which is often none.
+ *
+ *  \param x Argument that must be larger than GMX_FLOAT_MIN and smaller than
+ *           GMX_FLOAT_MAX, see invsqrt().
+ *
+ *  \return 1/sqrt(x). Result is undefined if your argument was invalid.
+ */
+template<MathAccuracy accuracy>
+static inline SimdFloat gmx_simdcall invsqrt(SimdFloat x)
+{
+    if (accuracy == MathAccuracy::Full)
+    {
+        return invsqrt(x);
+    }
+    SimdFloat lu = rsqrt(x);
+#        if (GMX_SIMD_RSQRT_BITS < 12)
+    lu = rsqrtIter(lu, x);
+#        endif
+#        if (GMX_SIMD_RSQRT_BITS * 2 < 12)
+    lu = rsqrtIter(lu, x);
+#        endif
+    return lu;
+}
+
+/*! \brief SIMD float exp(x) with selectable accuracy.
+ *
+ *  \tparam accuracy The accuracy tier. Reduced12Bit evaluates 2^f on the
+ *                   fractional part with a third-order minimax polynomial
+ *                   (relative error 1.0e-4) and skips the extended-precision
+ *                   argument reduction of exp().
+ *  \tparam opt      Math optimization, with the same meaning as for exp().
+ *
+ *  \param x Argument, with the same range restrictions as for exp().
+ *
+ *  \result exp(x).
+ */
+template<MathAccuracy accuracy, MathOptimization opt = MathOptimization::Safe>
+static inline SimdFloat gmx_simdcall exp(SimdFloat x)
+{
+    if (accuracy == MathAccuracy::Full)
+    {
+        return exp<opt>(x);
+    }
+    const SimdFloat argscale(1.44269504088896341F);
+    const SimdFloat CC3(0.055009227246046066F);
+    const SimdFloat CC2(0.24221171438694F);
+    const SimdFloat CC1(0.693282961845398F);
+    const SimdFloat one(1.0F);
+
+    // See exp() for why the argument is limited in the safe version
+    if (opt == MathOptimization::Safe)
+    {
+        x = max(x, SimdFloat(std::numeric_limits<std::int32_t>::lowest()) / argscale);
+    }
+
+    SimdFloat y        = x * argscale;
+    SimdFloat fexppart = ldexp<opt>(one, cvtR2I(y));
+    SimdFloat f        = y - round(y);
+
+    SimdFloat p = fma(CC3, f, CC2);
+    p           = fma(p, f, CC1);
+    p           = fma(p, f, one);
+    return p * fexppart;
+}
+
+/*! \brief SIMD float erfc(x) with selectable accuracy.
+ *
+ *  \tparam accuracy The accuracy tier. Reduced12Bit uses a single fifth-order
+ *                   polynomial in t=1/(1+x/2) for erfc(x)exp(x^2)/t and the
+ *                   reduced-accuracy exp(), instead of the three-range
+ *                   approximation of erfc().
+ *
+ *  \param x The value to calculate erfc(x) for.
+ *
+ *  \result erfc(x). As for erfc(), the relative accuracy is not maintained
+ *          for results close to the smallest representable numbers.
+ */
+template<MathAccuracy accuracy>
+static inline SimdFloat gmx_simdcall erfc(SimdFloat x)
+{
+    if (accuracy == MathAccuracy::Full)
+    {
+        return erfc(x);
+    }
+    // Coefficients for minimax approximation of erfc(y)*exp(y^2)/t=P(t), t=1/(1+y/2), y in [0,9]
+    const SimdFloat CE5(-0.0532984733581543F);
+    const SimdFloat CE4(-0.02372961863875389F);
+    const SimdFloat CE3(0.32033661007881165F);
+    const SimdFloat CE2(0.17988795042037964F);
+    const SimdFloat CE1(0.2956939935684204F);
+    const SimdFloat CE0(0.28108644485473633F);
+    const SimdFloat half(0.5F);
+    const SimdFloat one(1.0F);
+    const SimdFloat two(2.0F);
+
+    SimdFloat y = abs(x);
+    SimdFloat t = inv(fma(half, y, one));
+
+    SimdFloat p = fma(CE5, t, CE4);
+    p           = fma(p, t, CE3);
+    p           = fma(p, t, CE2);
+    p           = fma(p, t, CE1);
+    p           = fma(p, t, CE0);
+
+    SimdFloat res = t * p * exp<accuracy>(-y * y);
+
+    // erfc(-x) = 2 - erfc(x)
+    return blend(res, two - res, x < setZero());
+}
+#    endif // GMX_SIMD_HAVE_FLOAT
+
+#    if GMX_SIMD_HAVE_DOUBLE
+/*! \brief Calculate 1/sqrt(x) for SIMD double with selectable accuracy.
+ *
+ *  \tparam accuracy The accuracy tier, see the SIMD float version.
+ *
+ *  \param x Argument that must be larger than GMX_FLOAT_MIN and smaller than
+ *           GMX_FLOAT_MAX, see invsqrt().
+ *
+ *  \return 1/sqrt(x). Result is undefined if your argument was invalid.
+ */
+template<MathAccuracy accuracy>
+static inline SimdDouble gmx_simdcall invsqrt(SimdDouble x)
+{
+    if (accuracy == MathAccuracy::Full)
+    {
+        return invsqrt(x);
+    }
+    SimdDouble lu = rsqrt(x);
+#        if (GMX_SIMD_RSQRT_BITS < 12)
+    lu = rsqrtIter(lu, x);
+#        endif
+#        if (GMX_SIMD_RSQRT_BITS * 2 < 12)
+    lu = rsqrtIter(lu, x);
+#        endif
+    return lu;
+}
+
+/*! \brief SIMD double exp(x) with selectable accuracy.
+ *
+ *  \tparam accuracy The accuracy tier, see the SIMD float version.
+ *  \tparam opt      Math optimization, with the same meaning as for exp().
+ *
+ *  \param x Argument, with the same range restrictions as for exp().
+ *
+ *  \result exp(x).
+ */
+template<MathAccuracy accuracy, MathOptimization opt = MathOptimization::Safe>
+static inline SimdDouble gmx_simdcall exp(SimdDouble x)
+{
+    if (accuracy == MathAccuracy::Full)
+    {
+        return exp<opt>(x);
+    }
+    const SimdDouble argscale(1.44269504088896340735992468100);
+    const SimdDouble CC3(0.055009227246046066);
+    const SimdDouble CC2(0.24221171438694);
+    const SimdDouble CC1(0.693282961845398);
+    const SimdDouble one(1.0);
+
+    // See exp() for why the argument is limited in the safe version
+    if (opt == MathOptimization::Safe)
+    {
+        x = max(x, SimdDouble(std::numeric_limits<std::int32_t>::lowest()) / argscale);
+    }
+
+    SimdDouble y        = x * argscale;
+    SimdDouble fexppart = ldexp<opt>(one, cvtR2I(y));
+    SimdDouble f        = y - round(y);
+
+    SimdDouble p = fma(CC3, f, CC2);
+    p            = fma(p, f, CC1);
+    p            = fma(p, f, one);
+    return p * fexppart;
+}
+
+/*! \brief SIMD double erfc(x) with selectable accuracy.
+ *
+ *  \tparam accuracy The accuracy tier, see the SIMD float version.
+ *
+ *  \param x The value to calculate erfc(x) for.
+ *
+ *  \result erfc(x).
+ */
+template<MathAccuracy accuracy>
+static inline SimdDouble gmx_simdcall erfc(SimdDouble x)
+{
+    if (accuracy == MathAccuracy::Full)
+    {
+        return erfc(x);
+    }
+    // Coefficients for minimax approximation of erfc(y)*exp(y^2)/t=P(t), t=1/(1+y/2), y in [0,9]
+    const SimdDouble CE5(-0.0532984733581543);
+    const SimdDouble CE4(-0.02372961863875389);
+    const SimdDouble CE3(0.32033661007881165);
+    const SimdDouble CE2(0.17988795042037964);
+    const SimdDouble CE1(0.2956939935684204);
+    const SimdDouble CE0(0.28108644485473633);
+    const SimdDouble half(0.5);
+    const SimdDouble one(1.0);
+    const SimdDouble two(2.0);
+
+    SimdDouble y = abs(x);
+    SimdDouble t = invSingleAccuracy(fma(half, y, one));
+
+    SimdDouble p = fma(CE5, t, CE4);
+    p            = fma(p, t, CE3);
+    p            = fma(p, t, CE2);
+    p            = fma(p, t, CE1);
+    p            = fma(p, t, CE0);
+
+    SimdDouble res = t * p * exp<accuracy>(-y * y);
+
+    // erfc(-x) = 2 - erfc(x)
+    return blend(res, two - res, x < setZero());
+}
+#    endif // GMX_SIMD_HAVE_DOUBLE
+
+/*! \} */
+
 /*! \}   end of addtogroup module_simd */
 /*! \endcond  end of condition libabl */
 
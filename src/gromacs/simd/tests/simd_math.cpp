@@ -861,6 +861,55 @@ TEST_F(SimdMathTest, erfc)
     GMX_EXPECT_SIMD_FUNC_NEAR(refErfc, erfc, settings);
 }
 
+// Functions with a reduced accuracy tier, tested with a relative tolerance of 2^-12
+
+//! Ulp tolerance corresponding to the MathAccuracy::Reduced12Bit tier
+const std::int64_t c_reduced12BitUlpTol = (1.0 / 4096) / GMX_REAL_EPS;
+
+TEST_F(SimdMathTest, invsqrtReduced12Bit)
+{
+    const real      low  = std::numeric_limits<float>::min();
+    const real      high = std::numeric_limits<float>::max();
+    CompareSettings settings{ Range(low, high), c_reduced12BitUlpTol, absTol_, MatchRule::Normal };
+
+    GMX_EXPECT_SIMD_FUNC_NEAR(refInvsqrt, invsqrt<MathAccuracy::Reduced12Bit>, settings);
+}
+
+TEST_F(SimdMathTest, expReduced12Bit)
+{
+    // See test of exp() for comments about test ranges
+    const real lowestRealThatProducesNormal = (std::numeric_limits<real>::min_exponent - 1)
+                                              * std::log(2.0)
+                                              * (1 - std::numeric_limits<real>::epsilon());
+    const real highestRealThatProducesNormal =
+            (std::numeric_limits<real>::max_exponent - 1) * std::log(2.0);
+
+    CompareSettings settings{ Range(lowestRealThatProducesNormal, highestRealThatProducesNormal),
+                              c_reduced12BitUlpTol,
+                              absTol_,
+                              MatchRule::Normal };
+    GMX_EXPECT_SIMD_FUNC_NEAR(std::exp, exp<MathAccuracy::Reduced12Bit>, settings);
+    GMX_EXPECT_SIMD_FUNC_NEAR(
+            std::exp, (exp<MathAccuracy::Reduced12Bit, MathOptimization::Unsafe>), settings);
+}
+
+TEST_F(SimdMathTest, erfcReduced12Bit)
+{
+    CompareSettings settings{
+        Range(-9, 9), c_reduced12BitUlpTol, std::numeric_limits<real>::min(), MatchRule::Normal
+    };
+    GMX_EXPECT_SIMD_FUNC_NEAR(refErfc, erfc<MathAccuracy::Reduced12Bit>, settings);
+}
+
+TEST_F(SimdMathTest, fullAccuracyTierMatchesDefault)
+{
+    const SimdReal x = setSimdRealFrom3R(0.25, 1.5, 3.75);
+
+    GMX_EXPECT_SIMD_REAL_EQ(invsqrt(x), invsqrt<MathAccuracy::Full>(x));
+    GMX_EXPECT_SIMD_REAL_EQ(exp(x), exp<MathAccuracy::Full>(x));
+    GMX_EXPECT_SIMD_REAL_EQ(erfc(x), erfc<MathAccuracy::Full>(x));
+}
+
 TEST_F(SimdMathTest, sin)
 {
     CompareSettings settings{ Range(-8 * M_PI, 8 * M_PI), ulpTol_, absTol_, MatchRule::Normal };
@@ -2040,6 +2040,115 @@ static void apply_modified_positions(swap_group* g, rvec x[])
 }
 
 
+/*! \internal \brief A solvent molecule and ion selected for exchanging positions */
+struct SwapPair
+{
+    //! The group of the ion
+    swap_group* ionGroup;
+    //! Collective index of the first atom of the solvent molecule
+    int isol;
+    //! Collective index of the first atom of the ion
+    int iion;
+};
+
+
+/*! \brief Assemble the positions of the first atom of each molecule of a group.
+ *
+ * Only the first atoms are needed for sorting the molecules into the compartments,
+ * so we reduce an array of one position per molecule instead of the whole group.
+ * The other entries of the collective array are not touched.
+ */
+static void communicate_first_atom_positions(const t_commrec* cr, swap_group* g, const rvec x[])
+{
+    const int              numMolecules = g->atomset.numAtomsGlobal() / g->apm;
+    std::vector<gmx::RVec> firstAtomPositions(numMolecules, { 0, 0, 0 });
+
+    auto collectiveIndex = g->atomset.collectiveIndex().begin();
+    for (const auto localIndex : g->atomset.localIndex())
+    {
+        if (*collectiveIndex % g->apm == 0)
+        {
+            copy_rvec(x[localIndex], firstAtomPositions[*collectiveIndex / g->apm]);
+        }
+        ++collectiveIndex;
+    }
+
+    if (PAR(cr))
+    {
+        gmx_sum(numMolecules * DIM, firstAtomPositions[0], cr);
+    }
+
+    for (int iMol = 0; iMol < numMolecules; iMol++)
+    {
+        copy_rvec(firstAtomPositions[iMol], g->xc[iMol * g->apm]);
+    }
+}
+
+
+/*! \brief Assemble all atom positions of the molecules with a non-negative entry in
+ * \p slotOfMolecule, which holds the order of the molecules in the reduction buffer.
+ */
+static void communicate_selected_molecule_positions(const t_commrec*        cr,
+                                                    swap_group*             g,
+                                                    const rvec              x[],
+                                                    const std::vector<int>& slotOfMolecule,
+                                                    int                     numSelected)
+{
+    if (numSelected == 0)
+    {
+        return;
+    }
+
+    std::vector<gmx::RVec> selectedPositions(numSelected * g->apm, { 0, 0, 0 });
+
+    auto collectiveIndex = g->atomset.collectiveIndex().begin();
+    for (const auto localIndex : g->atomset.localIndex())
+    {
+        const int slot = slotOfMolecule[*collectiveIndex / g->apm];
+        if (slot >= 0)
+        {
+            copy_rvec(x[localIndex], selectedPositions[slot * g->apm + *collectiveIndex % g->apm]);
+        }
+        ++collectiveIndex;
+    }
+
+    if (PAR(cr))
+    {
+        gmx_sum(numSelected * g->apm * DIM, selectedPositions[0], cr);
+    }
+
+    for (size_t iMol = 0; iMol < slotOfMolecule.size(); iMol++)
+    {
+        const int slot = slotOfMolecule[iMol];
+        if (slot >= 0)
+        {
+            for (int a = 0; a < g->apm; a++)
+            {
+                copy_rvec(selectedPositions[slot * g->apm + a], g->xc[iMol * g->apm + a]);
+            }
+        }
+    }
+}
+
+
+/*! \brief Write back the modified local positions of the molecules with a non-negative
+ * entry in \p slotOfMolecule. */
+static void apply_modified_molecule_positions(swap_group*             g,
+                                              const std::vector<int>& slotOfMolecule,
+                                              rvec                    x[])
+{
+    auto collectiveIndex = g->atomset.collectiveIndex().begin();
+    for (const auto localIndex : g->atomset.localIndex())
+    {
+        if (slotOfMolecule[*collectiveIndex / g->apm] >= 0)
+        {
+            copy_rvec(g->xc[*collectiveIndex], x[localIndex]);
+        }
+        ++collectiveIndex;
+    }
+}
+
+
 gmx_bool do_swapcoords(t_commrec*        cr,
                        int64_t           step,
                        double            t,
@@ -2128,20 +2237,11 @@ gmx_bool do_swapcoords(t_commrec*        cr,
     if (bSwap)
     {
         /* Since we here know that we have to perform ion/water position exchanges,
-         * we now assemble the solvent positions */
+         * we now assemble the solvent positions. Sorting only needs the first atom
+         * of each molecule, the complete molecules are assembled after selecting
+         * which of them are swapped. */
         t_swapgrp* g = &(s->group[static_cast<int>(SwapGroupSplittingType::Solvent)]);
-        communicate_group_positions(cr,
-                                    g->xc,
-                                    nullptr,
-                                    nullptr,
-                                    FALSE,
-                                    x,
-                                    g->atomset.numAtomsGlobal(),
-                                    g->atomset.numAtomsLocal(),
-                                    g->atomset.localIndex().data(),
-                                    g->atomset.collectiveIndex().data(),
-                                    nullptr,
-                                    nullptr);
+        communicate_first_atom_positions(cr, g, x);
 
         /* Determine how many molecules of solvent each compartment contains */
         sortMoleculesIntoCompartments(g, cr, sc, s, box, step, s->fpout, bRerun, TRUE);
@@ -2164,8 +2264,10 @@ gmx_bool do_swapcoords(t_commrec*        cr,
             }
         }
 
-        /* Now actually perform the particle exchanges, one swap group after another */
+        /* Now select the particle exchanges, one swap group after another */
         gsol = &s->group[static_cast<int>(SwapGroupSplittingType::Solvent)];
+        std::vector<SwapPair> swapPairs;
+        std::vector<int>      solventSlotOfMolecule(gsol->atomset.numAtomsGlobal() / gsol->apm, -1);
         for (int ig = static_cast<int>(SwapGroupSplittingType::Count); ig < s->ngrp; ig++)
         {
             int        nswaps = 0;
@@ -2185,13 +2287,9 @@ gmx_bool do_swapcoords(t_commrec*        cr,
                     /* Get the xc-index of a particle from the other compartment */
                     iion = get_index_of_distant_atom(&g->comp[otherC], g->molname);
 
-                    get_molecule_center(&gsol->xc[isol], gsol->apm, gsol->m, com_solvent, s->pbc);
-                    get_molecule_center(&g->xc[iion], g->apm, g->m, com_particle, s->pbc);
-
-                    /* Subtract solvent molecule's center of mass and add swap particle's center of mass */
-                    translate_positions(&gsol->xc[isol], gsol->apm, com_solvent, com_particle, s->pbc);
-                    /* Similarly for the swap particle, subtract com_particle and add com_solvent */
-                    translate_positions(&g->xc[iion], g->apm, com_particle, com_solvent, s->pbc);
+                    /* The positions are exchanged below, once the solvent molecules are assembled */
+                    solventSlotOfMolecule[isol / gsol->apm] = swapPairs.size();
+                    swapPairs.push_back({ g, isol, iion });
 
                     /* Keep track of the changes */
                     g->vacancy[thisC]--;
@@ -2232,14 +2330,34 @@ gmx_bool do_swapcoords(t_commrec*        cr,
             }
         }
 
+        /* Assemble the complete solvent molecules that take part in a swap */
+        communicate_selected_molecule_positions(cr, gsol, x, solventSlotOfMolecule, swapPairs.size());
+
+        /* Now actually perform the particle exchanges. Each molecule takes part
+         * in at most one exchange, so the order does not matter. */
+        for (const SwapPair& swapPair : swapPairs)
+        {
+            t_swapgrp* g = swapPair.ionGroup;
+
+            get_molecule_center(&gsol->xc[swapPair.isol], gsol->apm, gsol->m, com_solvent, s->pbc);
+            get_molecule_center(&g->xc[swapPair.iion], g->apm, g->m, com_particle, s->pbc);
+
+            /* Subtract solvent molecule's center of mass and add swap particle's center of mass */
+            translate_positions(&gsol->xc[swapPair.isol], gsol->apm, com_solvent, com_particle, s->pbc);
+            /* Similarly for the swap particle, subtract com_particle and add com_solvent */
+            translate_positions(&g->xc[swapPair.iion], g->apm, com_particle, com_solvent, s->pbc);
+        }
+
         if (s->fpout != nullptr)
         {
             print_ionlist(s, t, "  # after swap");
         }
 
-        /* For the solvent and user-defined swap groups, each rank writes back its
-         * (possibly modified) local positions to the official position array. */
-        for (int ig = static_cast<int>(SwapGroupSplittingType::Solvent); ig < s->ngrp; ig++)
+        /* For the user-defined swap groups, each rank writes back its (possibly
+         * modified) local positions to the official position array. For the
+         * solvent, only the swapped molecules have been assembled and modified. */
+        apply_modified_molecule_positions(gsol, solventSlotOfMolecule, x);
+        for (int ig = static_cast<int>(SwapGroupSplittingType::Count); ig < s->ngrp; ig++)
         {
             t_swapgrp* g = &s->group[ig];
             apply_modified_positions(g, x);
@@ -654,9 +654,9 @@ bool decideWhetherToUseGpuForUpdate(const bool                     isDomainDecom
     {
         errorMessage += "Only CUDA, HIP and SYCL builds are supported.\n";
     }
-    if (inputrec.eI != IntegrationAlgorithm::MD)
+    if (inputrec.eI != IntegrationAlgorithm::MD && inputrec.eI != IntegrationAlgorithm::SD1)
     {
-        errorMessage += "Only the md integrator is supported.\n";
+        errorMessage += "Only the md and sd integrators are supported.\n";
     }
     if (inputrec.etc == TemperatureCoupling::NoseHoover)
     {
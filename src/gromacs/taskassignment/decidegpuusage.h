@@ -88,6 +88,8 @@ struct DevelopmentFeatureFlags
     bool canUseCudaAwareMpi = false;
     //! True if GPU PME-decomposition is enabled
     bool enableGpuPmeDecomposition = false;
+    //! True if capturing GPU-resident MD steps into HIP graphs is enabled
+    bool enableHipGraphs = false;
 };
 
 
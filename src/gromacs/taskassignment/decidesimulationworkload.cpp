@@ -44,6 +44,8 @@
 #include "decidesimulationworkload.h"
 
 #include "gromacs/ewald/pme.h"
+#include "gromacs/gpu_utils/gpu_utils.h"
+#include "gromacs/mdtypes/inputrec.h"
 #include "gromacs/mdtypes/multipletimestepping.h"
 #include "gromacs/taskassignment/decidegpuusage.h"
 #include "gromacs/taskassignment/taskassignment.h"
@@ -104,6 +106,14 @@ SimulationWorkload createSimulationWorkload(const t_inputrec& inputrec,
             (devFlags.enableGpuBufferOps || featuresRequireGpuBufferOps) && !inputrec.useMts;
     simulationWorkload.useGpuFBufferOps =
             (devFlags.enableGpuBufferOps || featuresRequireGpuBufferOps) && !inputrec.useMts;
+    // Graphs require all work of a regular step on a single GPU with a fixed box, so that
+    // the launched work does not change between pair-search steps. The SD update uses
+    // the step as random counter, which would be frozen into the graph.
+    simulationWorkload.useMdGpuGraph =
+            devFlags.enableHipGraphs && useGpuForNonbonded && useGpuForUpdate
+            && !havePpDomainDecomposition && !haveSeparatePmeRank && !inputrec.useMts
+            && (pmeRunMode == PmeRunMode::GPU || pmeRunMode == PmeRunMode::None)
+            && !inputrecDynamicBox(&inputrec) && !EI_SD(inputrec.eI) && !decideGpuTimingsUsage();
     if (simulationWorkload.useGpuXBufferOps || simulationWorkload.useGpuFBufferOps)
     {
         GMX_ASSERT(simulationWorkload.useGpuNonbonded,
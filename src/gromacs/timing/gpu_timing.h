@@ -89,6 +89,7 @@ struct gmx_wallclock_gpu_nbnxn_t
     double                   nb_h2d_t; /**< host to device transfer time in nb calculation  */
     double                   nb_d2h_t; /**< device to host transfer time in nb calculation */
     int                      nb_c;     /**< total call count of the nonbonded gpu operations */
+    double lastStepTime[2]; /**< kernel plus X/F transfer time of the last step, per interaction locality */
     double                   pl_h2d_t; /**< pair search step host to device transfer time */
     int                      pl_h2d_c; /**< pair search step  host to device transfer call count */
 };
@@ -0,0 +1,178 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Implements the reader for CPU hardware performance counters
+ *
+ * \ingroup module_timing
+ */
+#include "gmxpre.h"
+
+#include "hardwarecounters.h"
+
+#include "config.h"
+
+#if HAVE_LINUX_PERF_EVENT_H
+#    include <linux/perf_event.h>
+#    include <sys/ioctl.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+#include <cstring>
+
+#include <algorithm>
+
+#include "gromacs/utility/enumerationhelpers.h"
+
+namespace gmx
+{
+
+const char* enumValueToString(HardwareEvent event)
+{
+    constexpr EnumerationArray<HardwareEvent, const char*> hardwareEventNames = {
+        "Core cycles", "Instructions", "Cache misses"
+    };
+    return hardwareEventNames[event];
+}
+
+#if HAVE_LINUX_PERF_EVENT_H
+
+namespace
+{
+
+//! Returns the perf_event_open config value for \p event
+uint64_t perfEventConfig(HardwareEvent event)
+{
+    switch (event)
+    {
+        case HardwareEvent::CoreCycles: return PERF_COUNT_HW_CPU_CYCLES;
+        case HardwareEvent::Instructions: return PERF_COUNT_HW_INSTRUCTIONS;
+        case HardwareEvent::CacheMisses: return PERF_COUNT_HW_CACHE_MISSES;
+        default: return PERF_COUNT_HW_MAX;
+    }
+}
+
+//! Opens a counter for \p event of the calling thread, returns -1 on failure
+int openPerfEvent(HardwareEvent event, int groupFileDescriptor)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.size           = sizeof(attr);
+    attr.config         = perfEventConfig(event);
+    attr.disabled       = (groupFileDescriptor == -1) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_GROUP;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFileDescriptor, 0));
+}
+
+} // namespace
+
+std::unique_ptr<HardwareCounters> HardwareCounters::create()
+{
+    std::array<int, c_numHardwareEvents> fileDescriptors;
+    fileDescriptors.fill(-1);
+    bool haveAllEvents = true;
+    for (auto event : EnumerationWrapper<HardwareEvent>{})
+    {
+        fileDescriptors[static_cast<int>(event)] = openPerfEvent(event, fileDescriptors[0]);
+        haveAllEvents = haveAllEvents && (fileDescriptors[static_cast<int>(event)] != -1);
+    }
+    /* The destructor closes the events that were opened */
+    std::unique_ptr<HardwareCounters> counters(new HardwareCounters(fileDescriptors));
+    if (!haveAllEvents)
+    {
+        return nullptr;
+    }
+
+    ioctl(fileDescriptors[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fileDescriptors[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+    return counters;
+}
+
+HardwareCounters::HardwareCounters(const std::array<int, c_numHardwareEvents>& fileDescriptors) :
+    fileDescriptors_(fileDescriptors)
+{
+}
+
+HardwareCounters::~HardwareCounters()
+{
+    for (const int fileDescriptor : fileDescriptors_)
+    {
+        if (fileDescriptor != -1)
+        {
+            close(fileDescriptor);
+        }
+    }
+}
+
+HardwareEventCounts HardwareCounters::read() const
+{
+    /* With PERF_FORMAT_GROUP the number of events is followed by their values */
+    std::array<uint64_t, 1 + c_numHardwareEvents> buffer = {};
+    HardwareEventCounts                            counts = {};
+    if (::read(fileDescriptors_[0], buffer.data(), sizeof(buffer)) == sizeof(buffer))
+    {
+        std::copy(buffer.begin() + 1, buffer.end(), counts.begin());
+    }
+    return counts;
+}
+
+#else
+
+std::unique_ptr<HardwareCounters> HardwareCounters::create()
+{
+    return nullptr;
+}
+
+HardwareCounters::HardwareCounters(const std::array<int, c_numHardwareEvents>& fileDescriptors) :
+    fileDescriptors_(fileDescriptors)
+{
+}
+
+HardwareCounters::~HardwareCounters() = default;
+
+HardwareEventCounts HardwareCounters::read() const
+{
+    return {};
+}
+
+#endif
+
+} // namespace gmx
@@ -0,0 +1,104 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \libinternal \file
+ *
+ * \brief Declares a reader for CPU hardware performance counters
+ *
+ * On Linux the core cycles, instructions and last-level cache misses
+ * of the calling thread are read with perf_event_open. Threads started
+ * by the calling thread, such as OpenMP worker threads, are not
+ * included.
+ *
+ * \inlibraryapi
+ * \ingroup module_timing
+ */
+#ifndef GMX_TIMING_HARDWARECOUNTERS_H
+#define GMX_TIMING_HARDWARECOUNTERS_H
+
+#include <cstdint>
+
+#include <array>
+#include <memory>
+
+namespace gmx
+{
+
+//! The hardware events that are counted
+enum class HardwareEvent : int
+{
+    CoreCycles,
+    Instructions,
+    CacheMisses,
+    Count
+};
+
+//! Returns the name of \p event
+const char* enumValueToString(HardwareEvent event);
+
+//! The number of hardware events that are counted
+static constexpr int c_numHardwareEvents = static_cast<int>(HardwareEvent::Count);
+
+//! Counts of all hardware events, indexed by HardwareEvent
+using HardwareEventCounts = std::array<uint64_t, c_numHardwareEvents>;
+
+/*! \libinternal \brief
+ * Reads the hardware event counters of the calling thread
+ */
+class HardwareCounters
+{
+public:
+    /*! \brief Returns counters for the calling thread
+     *
+     * Returns nullptr when hardware counters are not supported on this
+     * system or not accessible, e.g. due to kernel.perf_event_paranoid.
+     */
+    static std::unique_ptr<HardwareCounters> create();
+
+    ~HardwareCounters();
+
+    //! Returns the current counts of all events
+    HardwareEventCounts read() const;
+
+private:
+    //! Constructor, only to be called by create()
+    explicit HardwareCounters(const std::array<int, c_numHardwareEvents>& fileDescriptors);
+
+    //! The file descriptors of the events, the first is the group leader
+    std::array<int, c_numHardwareEvents> fileDescriptors_;
+};
+
+} // namespace gmx
+
+#endif
@@ -0,0 +1,395 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Implements online statistics of the step times and detection of straggler ranks
+ *
+ * \ingroup module_timing
+ */
+#include "gmxpre.h"
+
+#include "steptimestatistics.h"
+
+#include "config.h"
+
+#include <cmath>
+
+#include <algorithm>
+
+#include "gromacs/mdtypes/commrec.h"
+#include "gromacs/timing/wallcycle.h"
+#include "gromacs/utility/basedefinitions.h"
+#include "gromacs/utility/cstringutil.h"
+#include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/logger.h"
+#include "gromacs/utility/strconvert.h"
+#include "gromacs/utility/stringutil.h"
+#include "gromacs/utility/sysinfo.h"
+
+namespace gmx
+{
+
+namespace
+{
+
+//! The counters in which ranks wait for communication with other ranks
+constexpr std::array<WallCycleCounter, 6> c_communicationCounters = {
+    WallCycleCounter::DDCommLoad, WallCycleCounter::DDCommBound, WallCycleCounter::MoveX,
+    WallCycleCounter::MoveF,      WallCycleCounter::PpPmeWaitRecvF, WallCycleCounter::MoveE
+};
+
+//! The number of values per rank in the summary: three percentiles, the maximum and the outliers
+constexpr int c_numSummaryValues = 5;
+
+//! Returns the median of \p values
+double median(ArrayRef<const double> values)
+{
+    std::vector<double> sorted(values.begin(), values.end());
+    auto                middle = sorted.begin() + sorted.size() / 2;
+    std::nth_element(sorted.begin(), middle, sorted.end());
+    return *middle;
+}
+
+//! Returns the smallest multiple of \p nstlist of at least c_minWindowSteps steps
+int windowStepsForNstlist(int nstlist)
+{
+    const int interval = std::max(nstlist, 1);
+    return interval * ((StepTimeStatistics::c_minWindowSteps + interval - 1) / interval);
+}
+
+} // namespace
+
+StragglerDetector::StragglerDetector(int numRanks) :
+    relativeLoad_(numRanks, 1.0),
+    relativeLoadAverage_(numRanks, 1.0),
+    previousRelativeLoadAverage_(numRanks, 1.0),
+    isStraggler_(numRanks, false),
+    numStragglerWindows_(numRanks, 0)
+{
+}
+
+std::vector<int> StragglerDetector::addWindow(ArrayRef<const double> busyCycles)
+{
+    GMX_RELEASE_ASSERT(busyCycles.ssize() == gmx::ssize(relativeLoad_),
+                       "We need the busy cycles of all ranks");
+
+    std::vector<int> newStragglers;
+
+    lastWindowHadStraggler_ = false;
+
+    const double medianBusyCycles = median(busyCycles);
+    if (medianBusyCycles <= 0)
+    {
+        return newStragglers;
+    }
+
+    for (int rank = 0; rank < busyCycles.ssize(); rank++)
+    {
+        relativeLoad_[rank]                = busyCycles[rank] / medianBusyCycles;
+        previousRelativeLoadAverage_[rank] = relativeLoadAverage_[rank];
+        if (numWindows_ == 0)
+        {
+            /* The first window only sets the reference */
+            relativeLoadAverage_[rank] = relativeLoad_[rank];
+            continue;
+        }
+
+        const bool isStraggler =
+                (relativeLoad_[rank] > 1
+                 && relativeLoad_[rank] > c_stragglerFactor * relativeLoadAverage_[rank]);
+        if (isStraggler)
+        {
+            numStragglerWindows_[rank]++;
+            if (!isStraggler_[rank])
+            {
+                newStragglers.push_back(rank);
+            }
+        }
+        isStraggler_[rank]      = isStraggler;
+        lastWindowHadStraggler_ = lastWindowHadStraggler_ || isStraggler;
+
+        relativeLoadAverage_[rank] +=
+                c_averageWeight * (relativeLoad_[rank] - relativeLoadAverage_[rank]);
+    }
+    numWindows_++;
+
+    return newStragglers;
+}
+
+StepTimeStatistics::StepTimeStatistics(const MDLogger& mdlog, const t_commrec* cr, int nstlist) :
+    mdlog_(mdlog),
+    windowSteps_(windowStepsForNstlist(nstlist)),
+    communicator_(MPI_COMM_NULL),
+    numRanks_(1),
+    isMaster_(true)
+{
+    if (cr != nullptr && cr->sizeOfMyGroupCommunicator > 1)
+    {
+        communicator_ = cr->mpi_comm_mygroup;
+        numRanks_     = cr->sizeOfMyGroupCommunicator;
+        isMaster_     = (cr->nodeid == 0);
+    }
+
+    std::vector<char> hostNameBuffer(STRLEN);
+    gmx_gethostname(hostNameBuffer.data(), STRLEN);
+    int simulationRank = (cr != nullptr ? cr->sim_nodeid : 0);
+
+    std::vector<char> hostNameBuffers(isMaster_ ? numRanks_ * STRLEN : 0);
+    simulationRanks_.resize(isMaster_ ? numRanks_ : 0);
+    if (numRanks_ > 1)
+    {
+#if GMX_MPI
+        MPI_Gather(hostNameBuffer.data(),
+                   STRLEN,
+                   MPI_CHAR,
+                   hostNameBuffers.data(),
+                   STRLEN,
+                   MPI_CHAR,
+                   0,
+                   communicator_);
+        MPI_Gather(
+                &simulationRank, 1, MPI_INT, simulationRanks_.data(), 1, MPI_INT, 0, communicator_);
+#endif
+    }
+    else
+    {
+        hostNameBuffers    = hostNameBuffer;
+        simulationRanks_[0] = simulationRank;
+    }
+
+    if (isMaster_)
+    {
+        for (int rank = 0; rank < numRanks_; rank++)
+        {
+            hostNames_.emplace_back(hostNameBuffers.data() + rank * STRLEN);
+        }
+        detector_.emplace(numRanks_);
+    }
+}
+
+void StepTimeStatistics::addStep(int64_t step, double stepCycles, const gmx_wallcycle* wcycle)
+{
+    const int bin = static_cast<int>(c_binsPerOctave * std::log2(std::max(stepCycles, 1.0)));
+    histogram_[std::min(bin, c_numBins - 1)]++;
+    numSteps_++;
+    maxCycles_ = std::max(maxCycles_, stepCycles);
+    if (outlierThreshold_ > 0 && stepCycles > outlierThreshold_)
+    {
+        numOutliers_++;
+    }
+
+    double communicationCycles = 0;
+    if (wcycle != nullptr)
+    {
+        for (const WallCycleCounter counter : c_communicationCounters)
+        {
+            communicationCycles += wcycle->wcc[counter].c;
+        }
+    }
+    if (communicationCycles < previousCommunicationCycles_)
+    {
+        /* The cycle counters have been reset */
+        previousCommunicationCycles_ = 0;
+    }
+    windowBusyCycles_ +=
+            std::max(stepCycles - (communicationCycles - previousCommunicationCycles_), 0.0);
+    previousCommunicationCycles_ = communicationCycles;
+    windowNumSteps_++;
+
+    /* All ranks end the window at the same step, before a search step */
+    if ((step + 1) % windowSteps_ == 0)
+    {
+        finishWindow(step);
+    }
+}
+
+double StepTimeStatistics::percentile(double fraction) const
+{
+    if (numSteps_ == 0)
+    {
+        return 0;
+    }
+
+    const int64_t numStepsBelow = std::max(static_cast<int64_t>(std::ceil(fraction * numSteps_)),
+                                           static_cast<int64_t>(1));
+    int64_t       count         = 0;
+    int           bin           = 0;
+    while (bin < c_numBins - 1 && count + histogram_[bin] < numStepsBelow)
+    {
+        count += histogram_[bin];
+        bin++;
+    }
+
+    /* Return the center of the bin, the histogram does not resolve more */
+    return std::exp2((bin + 0.5) / c_binsPerOctave);
+}
+
+void StepTimeStatistics::finishWindow(int64_t step)
+{
+    const double busyCycles = (windowNumSteps_ > 0 ? windowBusyCycles_ / windowNumSteps_ : 0);
+    windowBusyCycles_       = 0;
+    windowNumSteps_         = 0;
+
+    outlierThreshold_ = c_outlierFactor * percentile(0.5);
+
+    std::vector<double> busyCyclesOfRanks(isMaster_ ? numRanks_ : 0);
+    if (numRanks_ > 1)
+    {
+#if GMX_MPI
+        MPI_Gather(&busyCycles,
+                   1,
+                   MPI_DOUBLE,
+                   busyCyclesOfRanks.data(),
+                   1,
+                   MPI_DOUBLE,
+                   0,
+                   communicator_);
+#endif
+    }
+    else
+    {
+        busyCyclesOfRanks[0] = busyCycles;
+    }
+
+    int haveStraggler = 0;
+    if (isMaster_)
+    {
+        for (const int rank : detector_->addWindow(busyCyclesOfRanks))
+        {
+            GMX_LOG(mdlog_.warning)
+                    .appendTextFormatted(
+                            "step %s: rank %d on host %s is straggling, its busy time is %.0f%% "
+                            "of the median rank, compared to %.0f%% before",
+                            int64ToString(step).c_str(),
+                            simulationRanks_[rank],
+                            hostNames_[rank].c_str(),
+                            100 * detector_->relativeLoad(rank),
+                            100 * detector_->previousRelativeLoadAverage(rank));
+        }
+        haveStraggler = (detector_->lastWindowHadStraggler() ? 1 : 0);
+    }
+    if (numRanks_ > 1)
+    {
+#if GMX_MPI
+        MPI_Bcast(&haveStraggler, 1, MPI_INT, 0, communicator_);
+#endif
+    }
+    if (haveStraggler)
+    {
+        numStragglerWindows_++;
+    }
+}
+
+void StepTimeStatistics::printSummary() const
+{
+    const std::array<double, c_numSummaryValues> summary = { percentile(0.5),
+                                                             percentile(0.9),
+                                                             percentile(0.99),
+                                                             maxCycles_,
+                                                             static_cast<double>(numOutliers_) };
+
+    std::vector<double> summaryOfRanks(isMaster_ ? numRanks_ * c_numSummaryValues : 0);
+    if (numRanks_ > 1)
+    {
+#if GMX_MPI
+        MPI_Gather(summary.data(),
+                   c_numSummaryValues,
+                   MPI_DOUBLE,
+                   summaryOfRanks.data(),
+                   c_numSummaryValues,
+                   MPI_DOUBLE,
+                   0,
+                   communicator_);
+#endif
+    }
+    else
+    {
+        std::copy(summary.begin(), summary.end(), summaryOfRanks.begin());
+    }
+
+    if (!isMaster_)
+    {
+        return;
+    }
+
+    std::string text = formatString(
+            "Step time statistics over %s steps in M-cycles, outliers take more than %g times "
+            "the median step:\n",
+            int64ToString(numSteps_).c_str(),
+            c_outlierFactor);
+    text += formatString(
+            "%-14s %10s %10s %10s %10s %10s\n", "", "50%", "90%", "99%", "max", "outliers");
+    /* Print the minimum, median and maximum over the ranks of each value */
+    const std::array<const char*, 3> statisticNames = { "min. of ranks", "median",
+                                                        "max. of ranks" };
+    const int numStatistics = (numRanks_ > 1 ? 3 : 1);
+    for (int statistic = 0; statistic < numStatistics; statistic++)
+    {
+        text += formatString("%-14s", numRanks_ > 1 ? statisticNames[statistic] : "");
+        for (int value = 0; value < c_numSummaryValues; value++)
+        {
+            std::vector<double> valueOfRanks(numRanks_);
+            for (int rank = 0; rank < numRanks_; rank++)
+            {
+                valueOfRanks[rank] = summaryOfRanks[rank * c_numSummaryValues + value];
+            }
+            double result;
+            switch (statistic)
+            {
+                case 0: result = *std::min_element(valueOfRanks.begin(), valueOfRanks.end()); break;
+                case 1: result = median(valueOfRanks); break;
+                default: result = *std::max_element(valueOfRanks.begin(), valueOfRanks.end());
+            }
+            /* The last value is the number of outliers */
+            text += (value < c_numSummaryValues - 1 ? formatString(" %10.3f", result * 1e-6)
+                                                    : formatString(" %10.0f", result));
+        }
+        text += "\n";
+    }
+    for (int rank = 0; rank < numRanks_; rank++)
+    {
+        if (detector_->numStragglerWindows(rank) > 0)
+        {
+            text += formatString("Rank %d on host %s was straggling in %d windows of %d steps\n",
+                                 simulationRanks_[rank],
+                                 hostNames_[rank].c_str(),
+                                 detector_->numStragglerWindows(rank),
+                                 windowSteps_);
+        }
+    }
+    GMX_LOG(mdlog_.info).asParagraph().appendText(text);
+}
+
+} // namespace gmx
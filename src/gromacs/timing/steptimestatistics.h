@@ -0,0 +1,226 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \libinternal \file
+ *
+ * \brief Declares online statistics of the step times and detection of straggler ranks
+ *
+ * \inlibraryapi
+ * \ingroup module_timing
+ */
+#ifndef GMX_TIMING_STEPTIMESTATISTICS_H
+#define GMX_TIMING_STEPTIMESTATISTICS_H
+
+#include <cstdint>
+
+#include <array>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/gmxmpi.h"
+
+struct gmx_wallcycle;
+struct t_commrec;
+
+namespace gmx
+{
+
+class MDLogger;
+
+/*! \libinternal \brief
+ * Detects ranks that become transiently slower than the other ranks
+ *
+ * For every window of steps, the busy cycles of each rank are divided
+ * by the median over the ranks. A rank is a straggler when this relative
+ * load is above one and c_stragglerFactor times larger than its running
+ * average over earlier windows. So static load imbalance is not reported,
+ * but a rank that slows down due to e.g. OS jitter or a throttled GPU is.
+ */
+class StragglerDetector
+{
+public:
+    //! A rank is a straggler when its relative load increases by more than this factor
+    static constexpr double c_stragglerFactor = 1.2;
+    //! The weight of a window in the running average of the relative load
+    static constexpr double c_averageWeight = 0.1;
+
+    //! Constructor for \p numRanks ranks
+    explicit StragglerDetector(int numRanks);
+
+    /*! \brief Adds the average busy cycles per step of all ranks over a window
+     *
+     * \returns the ranks that are a straggler now, but were not in the previous window
+     */
+    std::vector<int> addWindow(ArrayRef<const double> busyCycles);
+
+    //! Returns whether the last window added had one or more stragglers
+    bool lastWindowHadStraggler() const { return lastWindowHadStraggler_; }
+    //! Returns the load of \p rank, relative to the median, in the last window
+    double relativeLoad(int rank) const { return relativeLoad_[rank]; }
+    //! Returns the running average of the relative load of \p rank before the last window
+    double previousRelativeLoadAverage(int rank) const
+    {
+        return previousRelativeLoadAverage_[rank];
+    }
+    //! Returns the number of windows in which \p rank was a straggler
+    int numStragglerWindows(int rank) const { return numStragglerWindows_[rank]; }
+
+private:
+    //! The number of windows added
+    int64_t numWindows_ = 0;
+    //! The load relative to the median in the last window, per rank
+    std::vector<double> relativeLoad_;
+    //! The running average of the relative load, per rank
+    std::vector<double> relativeLoadAverage_;
+    //! The running average of the relative load before the last window, per rank
+    std::vector<double> previousRelativeLoadAverage_;
+    //! Whether each rank was a straggler in the last window
+    std::vector<bool> isStraggler_;
+    //! The number of windows in which each rank was a straggler
+    std::vector<int> numStragglerWindows_;
+    //! Whether the last window had a straggler
+    bool lastWindowHadStraggler_ = false;
+};
+
+/*! \libinternal \brief
+ * Online statistics of the step times of this rank and detection of straggler ranks
+ *
+ * The step cycles are added to a logarithmic histogram, which provides
+ * percentiles at constant cost and memory. Steps that take more than
+ * c_outlierFactor times the median step are counted as outliers.
+ *
+ * The busy cycles of a step are the step cycles minus the cycles spent
+ * in communication with other ranks, where the fast ranks wait for the
+ * slow ones. At the end of each window of steps, the average busy cycles
+ * of all ranks are gathered on the master rank, which passes them to
+ * StragglerDetector, logs new stragglers with their hostnames and
+ * broadcasts whether the window had a straggler. This costs one gather
+ * and one broadcast per window.
+ *
+ * All ranks of the group in \p cr should call addStep() for every step.
+ */
+class StepTimeStatistics
+{
+public:
+    //! Steps taking more than this factor times the median step are outliers
+    static constexpr double c_outlierFactor = 1.5;
+    //! The minimum number of steps in a window
+    static constexpr int c_minWindowSteps = 20;
+    //! The number of histogram bins per factor of two in the step cycles
+    static constexpr int c_binsPerOctave = 16;
+    //! The number of histogram bins, covers up to 2^64 cycles
+    static constexpr int c_numBins = 64 * c_binsPerOctave;
+
+    /*! \brief Constructor, collective over the ranks in the group of \p cr
+     *
+     * \param[in] mdlog    Logger for straggler notes and the summary
+     * \param[in] cr       Communication record, can be nullptr for a single rank
+     * \param[in] nstlist  The pair search interval, the windows are a multiple
+     *                     of this, so they match the PME tuning intervals
+     */
+    StepTimeStatistics(const MDLogger& mdlog, const t_commrec* cr, int nstlist);
+
+    /*! \brief Adds the cycles of a step, collective at the last step of each window
+     *
+     * \param[in] step        The step that just finished
+     * \param[in] stepCycles  The cycles of the step
+     * \param[in] wcycle      The cycle counters, for the communication cycles, can be nullptr
+     */
+    void addStep(int64_t step, double stepCycles, const gmx_wallcycle* wcycle);
+
+    //! Returns the number of steps added
+    int64_t numSteps() const { return numSteps_; }
+    //! Returns the number of steps longer than c_outlierFactor times the median
+    int64_t numOutliers() const { return numOutliers_; }
+    //! Returns the largest step cycles
+    double maxCycles() const { return maxCycles_; }
+    //! Returns the step cycles below which a \p fraction of the steps lies, 0 without steps
+    double percentile(double fraction) const;
+
+    /*! \brief Returns the number of windows with one or more stragglers on any rank
+     *
+     * Users of the step timings can compare this with the value of an
+     * earlier call to find out whether a straggler affected their timings.
+     */
+    int64_t numStragglerWindows() const { return numStragglerWindows_; }
+
+    //! Prints the percentiles over the ranks and the stragglers to the log, collective
+    void printSummary() const;
+
+private:
+    //! Ends the current window, collective
+    void finishWindow(int64_t step);
+
+    //! The logger
+    const MDLogger& mdlog_;
+    //! The steps in a window
+    int windowSteps_;
+    //! The communicator of the group, MPI_COMM_NULL for a single rank
+    MPI_Comm communicator_;
+    //! The number of ranks in the group
+    int numRanks_;
+    //! Whether this rank is rank 0 in the group, which logs
+    bool isMaster_;
+    //! The hostname of each rank, only on the master rank
+    std::vector<std::string> hostNames_;
+    //! The rank in the simulation of each rank in the group, only on the master rank
+    std::vector<int> simulationRanks_;
+    //! The straggler detector, only on the master rank
+    std::optional<StragglerDetector> detector_;
+
+    //! The number of steps per histogram bin
+    std::array<int64_t, c_numBins> histogram_ = {};
+    //! The number of steps added
+    int64_t numSteps_ = 0;
+    //! The number of outlier steps
+    int64_t numOutliers_ = 0;
+    //! The largest step cycles
+    double maxCycles_ = 0;
+    //! Steps above this number of cycles are outliers, set at the end of each window
+    double outlierThreshold_ = 0;
+    //! The communication cycles at the end of the previous step
+    double previousCommunicationCycles_ = 0;
+    //! The busy cycles accumulated in the current window
+    double windowBusyCycles_ = 0;
+    //! The number of steps in the current window
+    int windowNumSteps_ = 0;
+    //! The number of windows with stragglers
+    int64_t numStragglerWindows_ = 0;
+};
+
+} // namespace gmx
+
+#endif
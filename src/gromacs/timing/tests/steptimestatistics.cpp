@@ -0,0 +1,130 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for the step time statistics and straggler detection
+ *
+ * \ingroup module_timing
+ */
+
+#include "gmxpre.h"
+
+#include "gromacs/timing/steptimestatistics.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/utility/logger.h"
+
+#include "testutils/testasserts.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+TEST(StragglerDetectorTest, IgnoresStaticImbalance)
+{
+    StragglerDetector         detector(4);
+    const std::vector<double> busyCycles = { 1.0e6, 1.1e6, 1.6e6, 1.0e6 };
+    for (int window = 0; window < 10; window++)
+    {
+        EXPECT_TRUE(detector.addWindow(busyCycles).empty());
+        EXPECT_FALSE(detector.lastWindowHadStraggler());
+    }
+    EXPECT_EQ(0, detector.numStragglerWindows(2));
+}
+
+TEST(StragglerDetectorTest, DetectsTransientStraggler)
+{
+    StragglerDetector         detector(4);
+    const std::vector<double> busyCycles         = { 1.0e6, 1.0e6, 1.0e6, 1.0e6 };
+    const std::vector<double> busyCyclesStraggle = { 1.0e6, 1.0e6, 1.5e6, 1.0e6 };
+
+    detector.addWindow(busyCycles);
+    detector.addWindow(busyCycles);
+
+    const std::vector<int> newStragglers = detector.addWindow(busyCyclesStraggle);
+    ASSERT_EQ(1, gmx::ssize(newStragglers));
+    EXPECT_EQ(2, newStragglers[0]);
+    EXPECT_TRUE(detector.lastWindowHadStraggler());
+    EXPECT_DOUBLE_EQ(1.5, detector.relativeLoad(2));
+    EXPECT_DOUBLE_EQ(1.0, detector.previousRelativeLoadAverage(2));
+
+    // A straggler that persists is only reported when it starts straggling
+    EXPECT_TRUE(detector.addWindow(busyCyclesStraggle).empty());
+    EXPECT_TRUE(detector.lastWindowHadStraggler());
+
+    detector.addWindow(busyCycles);
+    EXPECT_FALSE(detector.lastWindowHadStraggler());
+    EXPECT_EQ(2, detector.numStragglerWindows(2));
+    EXPECT_EQ(0, detector.numStragglerWindows(0));
+}
+
+TEST(StepTimeStatisticsTest, ComputesPercentilesAndOutliers)
+{
+    MDLogger           mdlog;
+    const int          nstlist = 10;
+    StepTimeStatistics statistics(mdlog, nullptr, nstlist);
+
+    // The first window sets the outlier threshold
+    for (int step = 0; step < StepTimeStatistics::c_minWindowSteps; step++)
+    {
+        statistics.addStep(step, 1.0e6, nullptr);
+    }
+    EXPECT_EQ(0, statistics.numOutliers());
+    for (int step = StepTimeStatistics::c_minWindowSteps; step < 100; step++)
+    {
+        statistics.addStep(step, step % 10 == 0 ? 4.0e6 : 1.0e6, nullptr);
+    }
+
+    EXPECT_EQ(100, statistics.numSteps());
+    EXPECT_EQ(8, statistics.numOutliers());
+    EXPECT_DOUBLE_EQ(4.0e6, statistics.maxCycles());
+    // The histogram has a resolution of 1/16 of a factor of two
+    const real tolerance = 0.05;
+    EXPECT_NEAR(1.0, statistics.percentile(0.5) / 1.0e6, tolerance);
+    EXPECT_NEAR(1.0, statistics.percentile(0.9) / 1.0e6, tolerance);
+    EXPECT_NEAR(1.0, statistics.percentile(0.99) / 4.0e6, tolerance);
+    // A single rank can not straggle
+    EXPECT_EQ(0, statistics.numStragglerWindows());
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
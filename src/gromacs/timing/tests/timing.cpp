@@ -47,9 +47,12 @@
 
 #include "gromacs/timing/cyclecounter.h"
 #include "gromacs/timing/wallcycle.h"
+#include "gromacs/timing/wallcyclereporting.h"
+#include "gromacs/utility/textreader.h"
 
 #include "testutils/refdata.h"
 #include "testutils/testasserts.h"
+#include "testutils/testfilemanager.h"
 
 namespace gmx
 {
@@ -130,6 +133,46 @@ TEST_F(TimingTest, SubElementNoCountingWorks)
     }
 }
 
+//! Test that the trace ring buffer keeps the most recent regions
+TEST_F(TimingTest, TraceKeepsMostRecentRegions)
+{
+    // This is normally set up by wallcycle_init() when GMX_CYCLE_TRACE is set
+    wcycle->traceEvents.resize(2);
+
+    for (WallCycleCounter probe :
+         { WallCycleCounter::Run, WallCycleCounter::Step, WallCycleCounter::Force })
+    {
+        wallcycle_start(wcycle.get(), probe);
+        wallcycle_stop(wcycle.get(), probe);
+    }
+
+    EXPECT_EQ(wcycle->numTraceEventsRecorded, 3);
+    // The oldest region, Run, has been overwritten by Force
+    EXPECT_EQ(wcycle->traceEvents[0].counter, WallCycleCounter::Force);
+    EXPECT_EQ(wcycle->traceEvents[1].counter, WallCycleCounter::Step);
+    EXPECT_GE(wcycle->traceEvents[0].start, wcycle->traceEvents[1].stop);
+}
+
+//! Test that the trace is written next to the log file, so it follows -deffnm and -multidir
+TEST_F(TimingTest, TraceIsNamedAfterTheLogFile)
+{
+    if (gmx_cycles_calibrate(0.1) <= 0)
+    {
+        GTEST_SKIP() << "The trace needs a calibrated cycle counter";
+    }
+    wcycle->traceEvents.resize(2);
+    wallcycle_start(wcycle.get(), WallCycleCounter::Run);
+    wallcycle_stop(wcycle.get(), WallCycleCounter::Run);
+
+    TestFileManager   fileManager;
+    const std::string logFileName = fileManager.getTemporaryFilePath("md.log");
+    const std::string traceFileName = fileManager.getTemporaryFilePath("md_cycletrace_rank0.json");
+    wallcycle_write_trace(wcycle.get(), logFileName.c_str());
+
+    const std::string trace = TextReader::readFileToString(traceFileName);
+    EXPECT_NE(trace.find("\"name\": \"Run\""), std::string::npos);
+}
+
 //! Test whether the we can run the cycle counter.
 TEST_F(TimingTest, RunWallCycle)
 {
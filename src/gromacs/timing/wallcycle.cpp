@@ -43,8 +43,10 @@
 
 #include <cstdlib>
 
+#include <algorithm>
 #include <array>
 #include <memory>
+#include <tuple>
 #include <vector>
 
 #include "gromacs/math/functions.h"
@@ -54,10 +56,13 @@
 #include "gromacs/timing/wallcyclereporting.h"
 #include "gromacs/utility/arrayref.h"
 #include "gromacs/utility/cstringutil.h"
+#include "gromacs/utility/baseversion.h"
 #include "gromacs/utility/enumerationhelpers.h"
+#include "gromacs/utility/futil.h"
 #include "gromacs/utility/gmxassert.h"
 #include "gromacs/utility/gmxmpi.h"
 #include "gromacs/utility/logger.h"
+#include "gromacs/utility/path.h"
 #include "gromacs/utility/smalloc.h"
 #include "gromacs/utility/snprintf.h"
 #include "gromacs/utility/stringutil.h"
@@ -137,10 +142,12 @@ const char* enumValuetoString(WallCycleSubCounter enumValue)
         "DD make constr.",
         "DD top. other",
         "DD GPU ops.",
+        "DD halo wait",
         "NS grid local",
         "NS grid non-loc.",
         "NS search local",
         "NS search non-loc.",
+        "NS search imbalance",
         "Bonded F",
         "Bonded-FEP F",
         "Restraints F",
@@ -163,6 +170,7 @@ const char* enumValuetoString(WallCycleSubCounter enumValue)
         "Launch GPU Comm. coord.",
         "Launch GPU Comm. force.",
         "Launch GPU update",
+        "MD GPU graph",
         "Test subcounter"
     };
     return wallCycleSubCounterNames[enumValue];
@@ -223,6 +231,33 @@ std::unique_ptr<gmx_wallcycle> wallcycle_init(FILE* fplog, int resetstep, const
         wc->wcc_all.resize(sc_numWallCycleCountersSquared);
     }
 
+    if (getenv("GMX_CYCLE_HARDWARE_COUNTERS") != nullptr)
+    {
+        wc->hardwareCounters = gmx::HardwareCounters::create();
+        if (fplog)
+        {
+            fprintf(fplog,
+                    wc->hardwareCounters ? "\nWill count hardware events of the main thread\n\n"
+                                         : "\nHardware event counters are not available\n\n");
+        }
+    }
+
+    wc->numTraceEventsRecorded = 0;
+    if (const char* traceEnv = getenv("GMX_CYCLE_TRACE"))
+    {
+        const long numTraceEvents = strtol(traceEnv, nullptr, 10);
+        if (numTraceEvents > 0)
+        {
+            if (fplog)
+            {
+                fprintf(fplog,
+                        "\nWill store the last %ld timed regions for a timeline trace\n\n",
+                        numTraceEvents);
+            }
+            wc->traceEvents.resize(numTraceEvents);
+        }
+    }
+
 #if DEBUG_WCYCLE
     wc->count_depth  = 0;
     wc->isMasterRank = MASTER(cr);
@@ -317,6 +352,10 @@ void wallcycle_reset_all(gmx_wallcycle* wc)
         counter.n = 0;
         counter.c = 0;
     }
+    for (auto& counts : wc->hardwareCounts)
+    {
+        counts.fill(0);
+    }
 }
 
 static bool is_pme_counter(WallCycleCounter ewc)
@@ -889,6 +928,32 @@ void wallcycle_print(FILE*                            fplog,
         fprintf(fplog, "%s\n", hline);
     }
 
+    if (wc->hardwareCounters)
+    {
+        fprintf(fplog, " Hardware events of the main thread of this rank\n");
+        fprintf(fplog, "%s\n", hline);
+        fprintf(fplog, " Computing:           G-Core-cycles  G-Instructions    IPC   Misses/kInstr\n");
+        fprintf(fplog, "%s\n", hline);
+        for (auto key : keysOf(wc->wcc))
+        {
+            const gmx::HardwareEventCounts& counts = wc->hardwareCounts[key];
+            const double coreCycles = counts[static_cast<int>(gmx::HardwareEvent::CoreCycles)];
+            const double instructions = counts[static_cast<int>(gmx::HardwareEvent::Instructions)];
+            const double cacheMisses  = counts[static_cast<int>(gmx::HardwareEvent::CacheMisses)];
+            if (wc->wcc[key].n > 0 && coreCycles > 0 && instructions > 0)
+            {
+                fprintf(fplog,
+                        " %-19.19s %14.3f %15.3f %6.2f %15.3f\n",
+                        enumValuetoString(key),
+                        coreCycles * 1e-9,
+                        instructions * 1e-9,
+                        instructions / coreCycles,
+                        1000 * cacheMisses / instructions);
+            }
+        }
+        fprintf(fplog, "%s\n", hline);
+    }
+
     /* print GPU timing summary */
     double tot_gpu = 0.0;
     if (gpu_pme_t)
@@ -1091,6 +1156,267 @@ void wallcycle_print(FILE*                            fplog,
     }
 }
 
+//! Writes the call count and cycles of one counter as a JSON object member
+static void printJsonCounter(FILE* fp, const char* name, double numCalls, double cycles, bool isLast)
+{
+    fprintf(fp,
+            "        \"%s\": { \"calls\": %.0f, \"cycles\": %.0f }%s\n",
+            name,
+            numCalls,
+            cycles,
+            isLast ? "" : ",");
+}
+
+//! Writes the count and time in milliseconds of one GPU timer as a JSON object member
+static void printJsonGpuTiming(FILE* fp, const char* name, int count, double timeMs, bool isLast)
+{
+    fprintf(fp, "    \"%s\": { \"count\": %d, \"ms\": %.6g }%s\n", name, count, timeMs, isLast ? "" : ",");
+}
+
+void wallcycle_write_report_json(const char*                      fileName,
+                                 bool                             writeReport,
+                                 const t_commrec*                 cr,
+                                 const gmx_wallcycle*             wc,
+                                 double                           realtime,
+                                 int                              nth_pp,
+                                 int                              nth_pme,
+                                 const gmx_wallclock_gpu_nbnxn_t* gpu_nbnxn_t,
+                                 const gmx_wallclock_gpu_pme_t*   gpu_pme_t)
+{
+    if (wc == nullptr)
+    {
+        return;
+    }
+
+    /* Per rank: duties, thread count, invalid-count flag, hardware-counter flag,
+     * then the call counts and cycles of all counters and, when enabled,
+     * of all sub-counters, followed by the hardware event counts of all counters.
+     */
+    const int c_numRankValues  = 5;
+    const int numSubCounters   = sc_useCycleSubcounters ? sc_numWallCycleSubCounters : 0;
+    const int numValuesPerRank = c_numRankValues + 2 * (sc_numWallCycleCounters + numSubCounters)
+                                 + gmx::c_numHardwareEvents * sc_numWallCycleCounters;
+
+    const bool          isPPRank  = thisRankHasDuty(cr, DUTY_PP);
+    const bool          isPmeRank = thisRankHasDuty(cr, DUTY_PME);
+    std::vector<double> rankValues;
+    rankValues.reserve(numValuesPerRank);
+    rankValues.push_back(isPPRank ? 1 : 0);
+    rankValues.push_back(isPmeRank ? 1 : 0);
+    rankValues.push_back(isPPRank ? nth_pp : nth_pme);
+    rankValues.push_back(wc->haveInvalidCount ? 1 : 0);
+    rankValues.push_back(wc->hardwareCounters ? 1 : 0);
+    for (auto key : keysOf(wc->wcc))
+    {
+        rankValues.push_back(static_cast<double>(wc->wcc[key].n));
+        rankValues.push_back(static_cast<double>(wc->wcc[key].c));
+    }
+    if (sc_useCycleSubcounters)
+    {
+        for (auto key : keysOf(wc->wcsc))
+        {
+            rankValues.push_back(static_cast<double>(wc->wcsc[key].n));
+            rankValues.push_back(static_cast<double>(wc->wcsc[key].c));
+        }
+    }
+    for (const gmx::HardwareEventCounts& counts : wc->hardwareCounts)
+    {
+        for (const uint64_t count : counts)
+        {
+            rankValues.push_back(static_cast<double>(count));
+        }
+    }
+
+    const int           numRanks = cr->nnodes;
+    std::vector<double> allValues;
+    if (numRanks > 1)
+    {
+#if GMX_MPI
+        if (MASTER(cr))
+        {
+            allValues.resize(numRanks * numValuesPerRank);
+        }
+        MPI_Gather(rankValues.data(),
+                   numValuesPerRank,
+                   MPI_DOUBLE,
+                   allValues.data(),
+                   numValuesPerRank,
+                   MPI_DOUBLE,
+                   0,
+                   cr->mpi_comm_mysim);
+#endif
+    }
+    else
+    {
+        allValues = rankValues;
+    }
+
+    if (!writeReport)
+    {
+        return;
+    }
+
+    FILE* fp = gmx_ffopen(fileName, "w");
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"formatVersion\": %d,\n", c_performanceReportFormatVersion);
+    fprintf(fp, "  \"gromacsVersion\": \"%s\",\n", gmx_version());
+    fprintf(fp, "  \"wallTimeSeconds\": %.6g,\n", realtime);
+    fprintf(fp, "  \"ranks\": [\n");
+    for (int rank = 0; rank < numRanks; rank++)
+    {
+        const double* values = allValues.data() + rank * numValuesPerRank;
+        const char*   duty   = (values[0] != 0 && values[1] != 0) ? "pp+pme"
+                               : (values[0] != 0)                ? "pp"
+                                                                 : "pme";
+        fprintf(fp, "    {\n");
+        fprintf(fp, "      \"rank\": %d,\n", rank);
+        fprintf(fp, "      \"duty\": \"%s\",\n", duty);
+        fprintf(fp, "      \"threads\": %.0f,\n", values[2]);
+        fprintf(fp, "      \"validCycleCounts\": %s,\n", values[3] != 0 ? "false" : "true");
+        const bool haveHardwareCounts = (values[4] != 0);
+        fprintf(fp, "      \"counters\": {\n");
+        const double* counterValues = values + c_numRankValues;
+        for (auto key : keysOf(wc->wcc))
+        {
+            const int i = static_cast<int>(key);
+            printJsonCounter(fp,
+                             enumValuetoString(key),
+                             counterValues[2 * i],
+                             counterValues[2 * i + 1],
+                             i + 1 == sc_numWallCycleCounters);
+        }
+        fprintf(fp, "      }%s\n", (sc_useCycleSubcounters || haveHardwareCounts) ? "," : "");
+        if (sc_useCycleSubcounters)
+        {
+            fprintf(fp, "      \"subCounters\": {\n");
+            const double* subCounterValues = counterValues + 2 * sc_numWallCycleCounters;
+            for (auto key : keysOf(wc->wcsc))
+            {
+                const int i = static_cast<int>(key);
+                printJsonCounter(fp,
+                                 enumValuetoString(key),
+                                 subCounterValues[2 * i],
+                                 subCounterValues[2 * i + 1],
+                                 i + 1 == sc_numWallCycleSubCounters);
+            }
+            fprintf(fp, "      }%s\n", haveHardwareCounts ? "," : "");
+        }
+        if (haveHardwareCounts)
+        {
+            /* These are the counts of the main thread of the rank only */
+            fprintf(fp, "      \"hardwareEvents\": {\n");
+            const double* hardwareValues =
+                    counterValues + 2 * (sc_numWallCycleCounters + numSubCounters);
+            for (auto key : keysOf(wc->wcc))
+            {
+                const int     i      = static_cast<int>(key);
+                const double* counts = hardwareValues + i * gmx::c_numHardwareEvents;
+                fprintf(fp, "        \"%s\": {", enumValuetoString(key));
+                for (int e = 0; e < gmx::c_numHardwareEvents; e++)
+                {
+                    fprintf(fp,
+                            " \"%s\": %.0f%s",
+                            gmx::enumValueToString(static_cast<gmx::HardwareEvent>(e)),
+                            counts[e],
+                            e + 1 < gmx::c_numHardwareEvents ? "," : "");
+                }
+                fprintf(fp, " }%s\n", i + 1 == sc_numWallCycleCounters ? "" : ",");
+            }
+            fprintf(fp, "      }\n");
+        }
+        fprintf(fp, "    }%s\n", rank + 1 < numRanks ? "," : "");
+    }
+    fprintf(fp, "  ],\n");
+
+    /* As in the log file, the GPU timings are those of the master rank */
+    fprintf(fp, "  \"gpuTimings\": {\n");
+    std::vector<std::tuple<const char*, int, double>> gpuTimings;
+    if (gpu_nbnxn_t)
+    {
+        const char* kernelNames[2][2] = { { "Nonbonded F kernel", "Nonbonded F+ene k." },
+                                          { "Nonbonded F+prune k.", "Nonbonded F+ene+prune k." } };
+        gpuTimings.emplace_back("Pair list H2D", gpu_nbnxn_t->pl_h2d_c, gpu_nbnxn_t->pl_h2d_t);
+        gpuTimings.emplace_back("X / q H2D", gpu_nbnxn_t->nb_c, gpu_nbnxn_t->nb_h2d_t);
+        for (int i = 0; i < 2; i++)
+        {
+            for (int j = 0; j < 2; j++)
+            {
+                gpuTimings.emplace_back(
+                        kernelNames[i][j], gpu_nbnxn_t->ktime[i][j].c, gpu_nbnxn_t->ktime[i][j].t);
+            }
+        }
+        gpuTimings.emplace_back("Pruning kernel", gpu_nbnxn_t->pruneTime.c, gpu_nbnxn_t->pruneTime.t);
+        gpuTimings.emplace_back("F D2H", gpu_nbnxn_t->nb_c, gpu_nbnxn_t->nb_d2h_t);
+        gpuTimings.emplace_back("Dynamic pruning",
+                                gpu_nbnxn_t->dynamicPruneTime.c,
+                                gpu_nbnxn_t->dynamicPruneTime.t);
+    }
+    if (gpu_pme_t)
+    {
+        for (auto key : keysOf(gpu_pme_t->timing))
+        {
+            gpuTimings.emplace_back(
+                    enumValuetoString(key), gpu_pme_t->timing[key].c, gpu_pme_t->timing[key].t);
+        }
+    }
+    for (size_t i = 0; i < gpuTimings.size(); i++)
+    {
+        printJsonGpuTiming(fp,
+                           std::get<0>(gpuTimings[i]),
+                           std::get<1>(gpuTimings[i]),
+                           std::get<2>(gpuTimings[i]),
+                           i + 1 == gpuTimings.size());
+    }
+    fprintf(fp, "  }\n");
+    fprintf(fp, "}\n");
+
+    gmx_ffclose(fp);
+}
+
+void wallcycle_write_trace(const gmx_wallcycle* wc, const char* logFileName)
+{
+    if (wc == nullptr || wc->traceEvents.empty() || wc->numTraceEventsRecorded == 0)
+    {
+        return;
+    }
+
+    const double secondsPerCycle = gmx_cycles_calibrate(0.1);
+    if (secondsPerCycle <= 0)
+    {
+        return;
+    }
+
+    const int64_t numTraceEvents = std::min(wc->numTraceEventsRecorded, gmx::ssize(wc->traceEvents));
+    const int64_t firstIndex     = wc->numTraceEventsRecorded - numTraceEvents;
+    gmx_cycles_t  firstStart     = wc->traceEvents[firstIndex % wc->traceEvents.size()].start;
+    for (int64_t i = firstIndex; i < wc->numTraceEventsRecorded; i++)
+    {
+        firstStart = std::min(firstStart, wc->traceEvents[i % wc->traceEvents.size()].start);
+    }
+
+    /* The regions are stored in the order they finished, which is fine for trace viewers */
+    const int         rank     = (wc->cr != nullptr) ? wc->cr->sim_nodeid : 0;
+    const std::string fileName = gmx::Path::stripExtension(logFileName)
+                                 + gmx::formatString("_cycletrace_rank%d.json", rank);
+    FILE*             fp       = gmx_ffopen(fileName, "w");
+    fprintf(fp, "{ \"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    for (int64_t i = firstIndex; i < wc->numTraceEventsRecorded; i++)
+    {
+        const WallCycleTraceEvent& event = wc->traceEvents[i % wc->traceEvents.size()];
+        fprintf(fp,
+                "{ \"name\": \"%s\", \"ph\": \"X\", \"pid\": %d, \"tid\": 0, \"ts\": %.3f, "
+                "\"dur\": %.3f }%s\n",
+                enumValuetoString(event.counter),
+                rank,
+                (event.start - firstStart) * secondsPerCycle * 1e6,
+                (event.stop >= event.start ? event.stop - event.start : 0) * secondsPerCycle * 1e6,
+                i + 1 < wc->numTraceEventsRecorded ? "," : "");
+    }
+    fprintf(fp, "] }\n");
+    gmx_ffclose(fp);
+}
+
 int64_t wcycle_get_reset_counters(gmx_wallcycle* wc)
 {
     if (wc == nullptr)
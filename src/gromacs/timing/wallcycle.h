@@ -54,6 +54,7 @@
 #endif
 
 #include "gromacs/timing/cyclecounter.h"
+#include "gromacs/timing/hardwarecounters.h"
 #include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/enumerationhelpers.h"
 
@@ -138,10 +139,12 @@ enum class WallCycleSubCounter : int
     DDMakeConstr,
     DDTopOther,
     DDGpu,
+    DDHaloWait,
     NBSGridLocal,
     NBSGridNonLocal,
     NBSSearchLocal,
     NBSSearchNonLocal,
+    NBSSearchImbalance,
     Listed,
     ListedFep,
     Restraints,
@@ -164,6 +167,7 @@ enum class WallCycleSubCounter : int
     LaunchGpuMoveX,
     LaunchGpuMoveF,
     LaunchGpuUpdateConstrain,
+    MdGpuGraph,
     Test,
     Count
 };
@@ -186,6 +190,17 @@ struct wallcc_t
 static constexpr int c_MaxWallCycleDepth = 6;
 #endif
 
+//! A completed counter region, stored for the timeline trace
+struct WallCycleTraceEvent
+{
+    //! The counter of the region
+    WallCycleCounter counter;
+    //! The cycle count at the start of the region
+    gmx_cycles_t start;
+    //! The cycle count at the end of the region
+    gmx_cycles_t stop;
+};
+
 
 struct gmx_wallcycle
 {
@@ -206,6 +221,13 @@ struct gmx_wallcycle
     int64_t                                              reset_counters;
     const t_commrec*                                     cr;
     gmx::EnumerationArray<WallCycleSubCounter, wallcc_t> wcsc;
+    /* ring buffer with the most recent regions, only used with GMX_CYCLE_TRACE */
+    std::vector<WallCycleTraceEvent> traceEvents;
+    int64_t                          numTraceEventsRecorded;
+    /* hardware event counts of the calling thread, only used with GMX_CYCLE_HARDWARE_COUNTERS */
+    std::unique_ptr<gmx::HardwareCounters>                            hardwareCounters;
+    gmx::EnumerationArray<WallCycleCounter, gmx::HardwareEventCounts> hardwareCountsStart;
+    gmx::EnumerationArray<WallCycleCounter, gmx::HardwareEventCounts> hardwareCounts;
 };
 
 //! Returns if cycle counting is supported
@@ -226,6 +248,14 @@ inline void wallcycle_all_start(gmx_wallcycle* wc, WallCycleCounter ewc, gmx_cyc
     wc->cycle_prev = cycle;
 }
 
+//! Stores a completed region in the trace ring buffer, overwriting the oldest one when full
+inline void wallcycle_trace_add(gmx_wallcycle* wc, WallCycleCounter ewc, gmx_cycles_t start, gmx_cycles_t stop)
+{
+    const size_t index     = wc->numTraceEventsRecorded % wc->traceEvents.size();
+    wc->traceEvents[index] = { ewc, start, stop };
+    wc->numTraceEventsRecorded++;
+}
+
 inline void wallcycle_all_stop(gmx_wallcycle* wc, WallCycleCounter ewc, gmx_cycles_t cycle)
 {
     const int prev    = static_cast<int>(wc->ewc_prev);
@@ -250,6 +280,10 @@ inline void wallcycle_start(gmx_wallcycle* wc, WallCycleCounter ewc)
 #if DEBUG_WCYCLE
     debug_start_check(wc, ewc);
 #endif
+    if (wc->hardwareCounters)
+    {
+        wc->hardwareCountsStart[ewc] = wc->hardwareCounters->read();
+    }
     gmx_cycles_t cycle = gmx_cycles_read();
     wc->wcc[ewc].start = cycle;
     if (!wc->wcc_all.empty())
@@ -313,6 +347,18 @@ inline double wallcycle_stop(gmx_wallcycle* wc, WallCycleCounter ewc)
     }
     wc->wcc[ewc].c += last;
     wc->wcc[ewc].n++;
+    if (wc->hardwareCounters)
+    {
+        const gmx::HardwareEventCounts counts = wc->hardwareCounters->read();
+        for (int e = 0; e < gmx::c_numHardwareEvents; e++)
+        {
+            wc->hardwareCounts[ewc][e] += counts[e] - wc->hardwareCountsStart[ewc][e];
+        }
+    }
+    if (!wc->traceEvents.empty())
+    {
+        wallcycle_trace_add(wc, ewc, wc->wcc[ewc].start, cycle);
+    }
     if (!wc->wcc_all.empty())
     {
         wc->wc_depth--;
@@ -369,6 +415,16 @@ inline void wallcycle_sub_start(gmx_wallcycle* wc, WallCycleSubCounter ewcs)
     }
 }
 
+//! Add \p cycles, measured elsewhere, to ewcs and increase the call count
+inline void wallcycle_sub_add(gmx_wallcycle* wc, WallCycleSubCounter ewcs, gmx_cycles_t cycles)
+{
+    if (sc_useCycleSubcounters && wc != nullptr)
+    {
+        wc->wcsc[ewcs].c += cycles;
+        wc->wcsc[ewcs].n++;
+    }
+}
+
 //! Set the start sub cycle count for ewcs without increasing the call count
 inline void wallcycle_sub_start_nocount(gmx_wallcycle* wc, WallCycleSubCounter ewcs)
 {
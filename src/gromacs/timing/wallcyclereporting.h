@@ -78,4 +78,29 @@ void wallcycle_print(FILE*                            fplog,
                      const gmx_wallclock_gpu_pme_t*   gpu_pme_t);
 /* Print the cycle and time accounting */
 
+//! Version of the JSON performance report format, increase when changing its layout
+static constexpr int c_performanceReportFormatVersion = 1;
+
+void wallcycle_write_report_json(const char*                      fileName,
+                                 bool                             writeReport,
+                                 const t_commrec*                 cr,
+                                 const gmx_wallcycle*             wc,
+                                 double                           realtime,
+                                 int                              nth_pp,
+                                 int                              nth_pme,
+                                 const gmx_wallclock_gpu_nbnxn_t* gpu_nbnxn_t,
+                                 const gmx_wallclock_gpu_pme_t*   gpu_pme_t);
+/* Gather the call counts and cycles of all counters of all ranks in
+   cr->mpi_comm_mysim and, when writeReport is true, let the master rank
+   write them together with the GPU timings to fileName in JSON format.
+   Must be called on all ranks after wallcycle_scale_by_num_threads() and
+   before wallcycle_sum(), which replaces the call counts by their maxima. */
+
+void wallcycle_write_trace(const gmx_wallcycle* wc, const char* logFileName);
+/* When GMX_CYCLE_TRACE was set, write the stored regions of this rank
+   as complete events in the Chrome trace JSON format to
+   <logFileName without extension>_cycletrace_rank<rank>.json, for viewing
+   with e.g. Perfetto. Using the log file name, the trace files follow
+   mdrun -deffnm and -multidir. */
+
 #endif
@@ -106,7 +106,7 @@ static void comp_tpx(const char* fn1, const char* fn2, gmx_bool bRMSD, real ftol
     for (i = 0; i < (fn2 ? 2 : 1); i++)
     {
         ir[i] = new t_inputrec();
-        read_tpx_state(ff[i], ir[i], &state[i], &(mtop[i]));
+        read_tpx_state_no_broadcast(ff[i], ir[i], &state[i], &(mtop[i]));
         gmx::MDModules().adjustInputrecBasedOnModules(ir[i]);
     }
     if (fn2)
@@ -300,7 +300,7 @@ static void chk_trj(const gmx_output_env_t* oenv, const char* fn, const char* tp
     std::unique_ptr<gmx_localtop_t> top;
     if (tpr)
     {
-        read_tpx_state(tpr, &ir, &state, &mtop);
+        read_tpx_state_no_broadcast(tpr, &ir, &state, &mtop);
         top = std::make_unique<gmx_localtop_t>(mtop.ffparams);
         gmx_mtop_generate_local_top(mtop, top.get(), ir.efep != FreeEnergyPerturbationType::No);
     }
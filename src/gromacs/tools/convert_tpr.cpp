@@ -423,7 +423,7 @@ int ConvertTpr::run()
 
     t_inputrec  irInstance;
     t_inputrec* ir = &irInstance;
-    read_tpx_state(inputTprFileName_.c_str(), ir, &state, &mtop);
+    read_tpx_state_no_broadcast(inputTprFileName_.c_str(), ir, &state, &mtop);
 
 
     if (extendTimeIsSet_ || maxStepsIsSet_ || runToMaxTimeIsSet_)
@@ -105,7 +105,7 @@ void list_tpr(const char* fn,
     TpxFileHeader tpx = readTpxHeader(fn, true);
     t_inputrec    ir;
 
-    read_tpx_state(fn, tpx.bIr ? &ir : nullptr, &state, tpx.bTop ? &mtop : nullptr);
+    read_tpx_state_no_broadcast(fn, tpx.bIr ? &ir : nullptr, &state, tpx.bTop ? &mtop : nullptr);
     if (tpx.bIr && !bOriginalInputrec)
     {
         MDModules().adjustInputrecBasedOnModules(&ir);
@@ -43,10 +43,13 @@
 #include <cmath>
 
 #include <algorithm>
+#include <memory>
+#include <vector>
 
 #include "gromacs/commandline/pargs.h"
 #include "gromacs/ewald/ewald_utils.h"
 #include "gromacs/ewald/pme.h"
+#include "gromacs/ewald/pme_error_estimate.h"
 #include "gromacs/fft/calcgrid.h"
 #include "gromacs/fileio/checkpoint.h"
 #include "gromacs/fileio/tpxio.h"
@@ -65,10 +68,10 @@
 #include "gromacs/topology/topology.h"
 #include "gromacs/utility/arraysize.h"
 #include "gromacs/utility/fatalerror.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/pleasecite.h"
 #include "gromacs/utility/smalloc.h"
 
-/* #define TAKETIME */
 /* #define DEBUG  */
 
 /* Enum for situations that can occur during log file parsing */
@@ -185,210 +188,6 @@ static real estimate_direct(t_inputinfo* info)
     return gmx::c_one4PiEps0 * e_dir;
 }
 
-#define SUMORDER 6
-
-/* the following 4 functions determine polynomials required for the reciprocal error estimate */
-
-static inline real eps_poly1(real m, /* grid coordinate in certain direction */
-                             real K, /* grid size in corresponding direction */
-                             real n) /* spline interpolation order of the SPME */
-{
-    int  i;
-    real nom   = 0; /* nominator */
-    real denom = 0; /* denominator */
-    real tmp   = 0;
-
-    if (m == 0.0)
-    {
-        return 0.0;
-    }
-
-    for (i = -SUMORDER; i < 0; i++)
-    {
-        tmp = m / K + i;
-        tmp *= 2.0 * M_PI;
-        nom += std::pow(tmp, -n);
-    }
-
-    for (i = SUMORDER; i > 0; i--)
-    {
-        tmp = m / K + i;
-        tmp *= 2.0 * M_PI;
-        nom += std::pow(tmp, -n);
-    }
-
-    tmp = m / K;
-    tmp *= 2.0 * M_PI;
-    denom = std::pow(tmp, -n) + nom;
-
-    return -nom / denom;
-}
-
-static inline real eps_poly2(real m, /* grid coordinate in certain direction */
-                             real K, /* grid size in corresponding direction */
-                             real n) /* spline interpolation order of the SPME */
-{
-    int  i;
-    real nom   = 0; /* nominator */
-    real denom = 0; /* denominator */
-    real tmp   = 0;
-
-    if (m == 0.0)
-    {
-        return 0.0;
-    }
-
-    for (i = -SUMORDER; i < 0; i++)
-    {
-        tmp = m / K + i;
-        tmp *= 2.0 * M_PI;
-        nom += std::pow(tmp, -2 * n);
-    }
-
-    for (i = SUMORDER; i > 0; i--)
-    {
-        tmp = m / K + i;
-        tmp *= 2.0 * M_PI;
-        nom += std::pow(tmp, -2 * n);
-    }
-
-    for (i = -SUMORDER; i < SUMORDER + 1; i++)
-    {
-        tmp = m / K + i;
-        tmp *= 2.0 * M_PI;
-        denom += std::pow(tmp, -n);
-    }
-    tmp = eps_poly1(m, K, n);
-    return nom / denom / denom + tmp * tmp;
-}
-
-static inline real eps_poly3(real m, /* grid coordinate in certain direction */
-                             real K, /* grid size in corresponding direction */
-                             real n) /* spline interpolation order of the SPME */
-{
-    int  i;
-    real nom   = 0; /* nominator */
-    real denom = 0; /* denominator */
-    real tmp   = 0;
-
-    if (m == 0.0)
-    {
-        return 0.0;
-    }
-
-    for (i = -SUMORDER; i < 0; i++)
-    {
-        tmp = m / K + i;
-        tmp *= 2.0 * M_PI;
-        nom += i * std::pow(tmp, -2 * n);
-    }
-
-    for (i = SUMORDER; i > 0; i--)
-    {
-        tmp = m / K + i;
-        tmp *= 2.0 * M_PI;
-        nom += i * std::pow(tmp, -2 * n);
-    }
-
-    for (i = -SUMORDER; i < SUMORDER + 1; i++)
-    {
-        tmp = m / K + i;
-        tmp *= 2.0 * M_PI;
-        denom += std::pow(tmp, -n);
-    }
-
-    return 2.0 * M_PI * nom / denom / denom;
-}
-
-static inline real eps_poly4(real m, /* grid coordinate in certain direction */
-                             real K, /* grid size in corresponding direction */
-                             real n) /* spline interpolation order of the SPME */
-{
-    int  i;
-    real nom   = 0; /* nominator */
-    real denom = 0; /* denominator */
-    real tmp   = 0;
-
-    if (m == 0.0)
-    {
-        return 0.0;
-    }
-
-    for (i = -SUMORDER; i < 0; i++)
-    {
-        tmp = m / K + i;
-        tmp *= 2.0 * M_PI;
-        nom += i * i * std::pow(tmp, -2 * n);
-    }
-
-    for (i = SUMORDER; i > 0; i--)
-    {
-        tmp = m / K + i;
-        tmp *= 2.0 * M_PI;
-        nom += i * i * std::pow(tmp, -2 * n);
-    }
-
-    for (i = -SUMORDER; i < SUMORDER + 1; i++)
-    {
-        tmp = m / K + i;
-        tmp *= 2.0 * M_PI;
-        denom += std::pow(tmp, -n);
-    }
-
-    return 4.0 * M_PI * M_PI * nom / denom / denom;
-}
-
-static inline real eps_self(real m,     /* grid coordinate in certain direction */
-                            real K,     /* grid size in corresponding direction */
-                            rvec rboxv, /* reciprocal box vector */
-                            real n,     /* spline interpolation order of the SPME */
-                            rvec x)     /* coordinate of charge */
-{
-    int  i;
-    real tmp    = 0; /* temporary variables for computations */
-    real tmp1   = 0; /* temporary variables for computations */
-    real tmp2   = 0; /* temporary variables for computations */
-    real rcoord = 0; /* coordinate in certain reciprocal space direction */
-    real nom    = 0; /* nominator */
-    real denom  = 0; /* denominator */
-
-
-    if (m == 0.0)
-    {
-        return 0.0;
-    }
-
-    rcoord = iprod(rboxv, x);
-
-
-    for (i = -SUMORDER; i < 0; i++)
-    {
-        tmp  = -std::sin(2.0 * M_PI * i * K * rcoord);
-        tmp1 = 2.0 * M_PI * m / K + 2.0 * M_PI * i;
-        tmp2 = std::pow(tmp1, -n);
-        nom += tmp * tmp2 * i;
-        denom += tmp2;
-    }
-
-    for (i = SUMORDER; i > 0; i--)
-    {
-        tmp  = -std::sin(2.0 * M_PI * i * K * rcoord);
-        tmp1 = 2.0 * M_PI * m / K + 2.0 * M_PI * i;
-        tmp2 = std::pow(tmp1, -n);
-        nom += tmp * tmp2 * i;
-        denom += tmp2;
-    }
-
-
-    tmp  = 2.0 * M_PI * m / K;
-    tmp1 = pow(tmp, -n);
-    denom += tmp1;
-
-    return 2.0 * M_PI * nom / denom * K;
-}
-
-#undef SUMORDER
-
 /* The following routine is just a copy from pme.c */
 
 static void calc_recipbox(matrix box, matrix recipbox)
@@ -409,374 +208,114 @@ static void calc_recipbox(matrix box, matrix recipbox)
 }
 
 
-/* Estimate the reciprocal space part error of the SPME Ewald sum. */
-static real estimate_reciprocal(t_inputinfo* info,
-                                rvec         x[], /* array of particles */
-                                const real   q[], /* array of charges */
-                                int          nr,  /* number of charges = size of the charge array */
-                                FILE gmx_unused* fp_out,
-                                gmx_bool         bVerbose,
-                                int  seed,     /* The seed for the random number generator */
-                                int* nsamples, /* Return the number of samples used if Monte Carlo
-                                                * algorithm is used for self energy error estimate */
-                                t_commrec* cr)
+/* Draw the indices of the charges used for the Monte Carlo estimate of the
+ * self-interaction error term. Returns an empty list when all charges are used.
+ */
+static std::vector<int> draw_self_term_samples(const t_inputinfo* info,
+                                               int                nr,
+                                               int                seed,
+                                               gmx_bool           bVerbose)
 {
-    real     e_rec   = 0; /* reciprocal error estimate */
-    real     e_rec1  = 0; /* Error estimate term 1*/
-    real     e_rec2  = 0; /* Error estimate term 2*/
-    real     e_rec3  = 0; /* Error estimate term 3 */
-    real     e_rec3x = 0; /* part of Error estimate term 3 in x */
-    real     e_rec3y = 0; /* part of Error estimate term 3 in y */
-    real     e_rec3z = 0; /* part of Error estimate term 3 in z */
-    int      i, ci;
-    int      nx, ny, nz; /* grid coordinates */
-    real     q2_all = 0; /* sum of squared charges */
-    rvec     gridpx;     /* reciprocal grid point in x direction*/
-    rvec     gridpxy;    /* reciprocal grid point in x and y direction*/
-    rvec     gridp;      /* complete reciprocal grid point in 3 directions*/
-    rvec     tmpvec;     /* template to create points from basis vectors */
-    rvec     tmpvec2;    /* template to create points from basis vectors */
-    real     coeff  = 0; /* variable to compute coefficients of the error estimate */
-    real     coeff2 = 0; /* variable to compute coefficients of the error estimate */
-    real     tmp    = 0; /* variables to compute different factors from vectors */
-    real     tmp1   = 0;
-    real     tmp2   = 0;
-    gmx_bool bFraction;
-
-    int* numbers = nullptr;
-
-    /* Index variables for parallel work distribution */
-    int startglobal, stopglobal;
-    int startlocal, stoplocal;
-    int x_per_core;
-    int xtot;
-
-#ifdef TAKETIME
-    double t0 = 0.0;
-    double t1 = 0.0;
-#endif
-
-    GMX_RELEASE_ASSERT(q != nullptr, "Must have charges");
-
-    if (seed == 0)
-    {
-        seed = static_cast<int>(gmx::makeRandomSeed());
-    }
-    fprintf(stderr, "Using random seed %d.\n", seed);
+    std::vector<int> samples;
 
-    gmx::DefaultRandomEngine         rng(seed);
-    gmx::UniformIntDistribution<int> dist(0, nr - 1);
-
-    clear_rvec(gridpx);
-    clear_rvec(gridpxy);
-    clear_rvec(gridp);
-    clear_rvec(tmpvec);
-    clear_rvec(tmpvec2);
-
-    for (i = 0; i < nr; i++)
-    {
-        q2_all += q[i] * q[i];
-    }
-
-    /* Calculate indices for work distribution */
-    startglobal = -info->nkx[0] / 2;
-    stopglobal  = info->nkx[0] / 2;
-    xtot        = stopglobal * 2 + 1;
-    if (PAR(cr))
+    /* Use just a fraction of all charges to estimate the self energy error term? */
+    if ((info->fracself > 0.0) && (info->fracself < 1.0))
     {
-        x_per_core = static_cast<int>(std::ceil(static_cast<real>(xtot) / cr->nnodes));
-        startlocal = startglobal + x_per_core * cr->nodeid;
-        stoplocal  = startlocal + x_per_core - 1;
-        if (stoplocal > stopglobal)
+        if (seed == 0)
         {
-            stoplocal = stopglobal;
+            seed = static_cast<int>(gmx::makeRandomSeed());
         }
-    }
-    else
-    {
-        startlocal = startglobal;
-        stoplocal  = stopglobal;
-        x_per_core = xtot;
-    }
+        fprintf(stderr, "Using random seed %d.\n", seed);
 
-#if GMX_LIB_MPI
-#    ifdef TAKETIME
-    if (MASTER(cr))
-    {
-        t0 = MPI_Wtime();
-    }
-#    endif
-#endif
-
-    if (MASTER(cr))
-    {
+        gmx::DefaultRandomEngine         rng(seed);
+        gmx::UniformIntDistribution<int> dist(0, nr - 1);
 
-        fprintf(stderr, "Calculating reciprocal error part 1 ...");
-    }
-
-    for (nx = startlocal; nx <= stoplocal; nx++)
-    {
-        svmul(nx, info->recipbox[XX], gridpx);
-        for (ny = -info->nky[0] / 2; ny < info->nky[0] / 2 + 1; ny++)
+        /* The number of samples taken for the Monte Carlo calculation
+         * of the average of term IV of equation 35 in Wang2010 */
+        samples.resize(static_cast<int>(std::ceil(info->fracself * nr)));
+        for (int& sample : samples)
         {
-            svmul(ny, info->recipbox[YY], tmpvec);
-            rvec_add(gridpx, tmpvec, gridpxy);
-            for (nz = -info->nkz[0] / 2; nz < info->nkz[0] / 2 + 1; nz++)
-            {
-                if (0 == nx && 0 == ny && 0 == nz)
-                {
-                    continue;
-                }
-                svmul(nz, info->recipbox[ZZ], tmpvec);
-                rvec_add(gridpxy, tmpvec, gridp);
-                tmp = norm2(gridp);
-                coeff = std::exp(-1.0 * M_PI * M_PI * tmp / info->ewald_beta[0] / info->ewald_beta[0]);
-                coeff /= 2.0 * M_PI * info->volume * tmp;
-                coeff2 = tmp;
-
-
-                tmp = eps_poly2(nx, info->nkx[0], info->pme_order[0]);
-                tmp += eps_poly2(ny, info->nkx[0], info->pme_order[0]);
-                tmp += eps_poly2(nz, info->nkx[0], info->pme_order[0]);
-
-                tmp1 = eps_poly1(nx, info->nkx[0], info->pme_order[0]);
-                tmp2 = eps_poly1(ny, info->nky[0], info->pme_order[0]);
-
-                tmp += 2.0 * tmp1 * tmp2;
-
-                tmp1 = eps_poly1(nz, info->nkz[0], info->pme_order[0]);
-                tmp2 = eps_poly1(ny, info->nky[0], info->pme_order[0]);
-
-                tmp += 2.0 * tmp1 * tmp2;
-
-                tmp1 = eps_poly1(nz, info->nkz[0], info->pme_order[0]);
-                tmp2 = eps_poly1(nx, info->nkx[0], info->pme_order[0]);
-
-                tmp += 2.0 * tmp1 * tmp2;
-
-                tmp1 = eps_poly1(nx, info->nkx[0], info->pme_order[0]);
-                tmp1 += eps_poly1(ny, info->nky[0], info->pme_order[0]);
-                tmp1 += eps_poly1(nz, info->nkz[0], info->pme_order[0]);
-
-                tmp += tmp1 * tmp1;
-
-                e_rec1 += 32.0 * M_PI * M_PI * coeff * coeff * coeff2 * tmp * q2_all * q2_all / nr;
-
-                tmp1 = eps_poly3(nx, info->nkx[0], info->pme_order[0]);
-                tmp1 *= info->nkx[0];
-                tmp2 = iprod(gridp, info->recipbox[XX]);
-
-                tmp = tmp1 * tmp2;
-
-                tmp1 = eps_poly3(ny, info->nky[0], info->pme_order[0]);
-                tmp1 *= info->nky[0];
-                tmp2 = iprod(gridp, info->recipbox[YY]);
-
-                tmp += tmp1 * tmp2;
-
-                tmp1 = eps_poly3(nz, info->nkz[0], info->pme_order[0]);
-                tmp1 *= info->nkz[0];
-                tmp2 = iprod(gridp, info->recipbox[ZZ]);
-
-                tmp += tmp1 * tmp2;
-
-                tmp *= 4.0 * M_PI;
-
-                tmp1 = eps_poly4(nx, info->nkx[0], info->pme_order[0]);
-                tmp1 *= norm2(info->recipbox[XX]);
-                tmp1 *= info->nkx[0] * info->nkx[0];
-
-                tmp += tmp1;
-
-                tmp1 = eps_poly4(ny, info->nky[0], info->pme_order[0]);
-                tmp1 *= norm2(info->recipbox[YY]);
-                tmp1 *= info->nky[0] * info->nky[0];
-
-                tmp += tmp1;
-
-                tmp1 = eps_poly4(nz, info->nkz[0], info->pme_order[0]);
-                tmp1 *= norm2(info->recipbox[ZZ]);
-                tmp1 *= info->nkz[0] * info->nkz[0];
-
-                tmp += tmp1;
-
-                e_rec2 += 4.0 * coeff * coeff * tmp * q2_all * q2_all / nr;
-            }
+            sample = dist(rng); // [0,nr-1]
         }
-        if (MASTER(cr))
+
+        if (bVerbose)
         {
-            fprintf(stderr,
-                    "\rCalculating reciprocal error part 1 ... %3.0f%%",
-                    100.0 * (nx - startlocal + 1) / (x_per_core));
-            fflush(stderr);
+            fprintf(stdout,
+                    "Using %zu sample%s to approximate the self interaction error term.\n",
+                    samples.size(),
+                    samples.size() == 1 ? "" : "s");
         }
     }
 
-    if (MASTER(cr))
-    {
-        fprintf(stderr, "\n");
-    }
+    return samples;
+}
 
-    /* Use just a fraction of all charges to estimate the self energy error term? */
-    bFraction = (info->fracself > 0.0) && (info->fracself < 1.0);
 
-    if (bFraction)
-    {
-        /* Here xtot is the number of samples taken for the Monte Carlo calculation
-         * of the average of term IV of equation 35 in Wang2010. Round up to a
-         * number of samples that is divisible by the number of nodes */
-        x_per_core = static_cast<int>(std::ceil(info->fracself * nr / cr->nnodes));
-        xtot       = x_per_core * cr->nnodes;
-    }
-    else
+/* Estimate the reciprocal space part error of the SPME Ewald sum.
+ * Only the master rank computes the estimate, which is multi-threaded and
+ * reuses the grid-dependent tables of the estimator between calls. Other
+ * ranks return zero and get the estimate through bcast_info().
+ */
+static real estimate_reciprocal(const t_inputinfo*                info,
+                                gmx::PmeReciprocalErrorEstimator* estimator,
+                                const t_commrec*                  cr)
+{
+    if (!MASTER(cr))
     {
-        /* In this case we use all nr particle positions */
-        xtot       = nr;
-        x_per_core = static_cast<int>(std::ceil(static_cast<real>(xtot) / cr->nnodes));
+        return 0;
     }
 
-    startlocal = x_per_core * cr->nodeid;
-    stoplocal  = std::min(startlocal + x_per_core, xtot); /* min needed if xtot == nr */
+    const ivec gridSize = { info->nkx[0], info->nky[0], info->nkz[0] };
 
-    if (bFraction)
-    {
-        /* Make shure we get identical results in serial and parallel. Therefore,
-         * take the sample indices from a single, global random number array that
-         * is constructed on the master node and that only depends on the seed */
-        snew(numbers, xtot);
-        if (MASTER(cr))
-        {
-            for (i = 0; i < xtot; i++)
-            {
-                numbers[i] = dist(rng); // [0,nr-1]
-            }
-        }
-        /* Broadcast the random number array to the other nodes */
-        if (PAR(cr))
-        {
-            nblock_bc(cr->mpi_comm_mygroup, xtot, numbers);
-        }
+    return estimator->estimate(gridSize, info->ewald_beta[0]);
+}
 
-        if (bVerbose && MASTER(cr))
-        {
-            fprintf(stdout,
-                    "Using %d sample%s to approximate the self interaction error term",
-                    xtot,
-                    xtot == 1 ? "" : "s");
-            if (PAR(cr))
-            {
-                fprintf(stdout, " (%d sample%s per rank)", x_per_core, x_per_core == 1 ? "" : "s");
-            }
-            fprintf(stdout, ".\n");
-        }
-    }
 
-    /* Return the number of positions used for the Monte Carlo algorithm */
-    *nsamples = xtot;
+/* Estimate the additional force error when the PME FFT transposes use FP16 storage,
+ * as enabled by GMX_PME_FFT_HALF_COMM, with respect to full-precision PME.
+ *
+ * Rounding to FP16 gives a relative RMS error of 2^-11/sqrt(3) per grid value and
+ * transpose. With at most two transposes for each of the forward and backward FFT,
+ * the error is 2x this times the RMS reciprocal-space force, which we estimate
+ * assuming uncorrelated charge positions. For condensed phases this is an upper
+ * estimate, since screening lowers the reciprocal-space forces.
+ */
+static real estimate_half_comm(const t_inputinfo* info)
+{
+    const double beta = info->ewald_beta[0];
 
-    for (i = startlocal; i < stoplocal; i++)
+    double sum = 0;
+    for (int nx = -info->nkx[0] / 2; nx < info->nkx[0] / 2 + 1; nx++)
     {
-        e_rec3x = 0;
-        e_rec3y = 0;
-        e_rec3z = 0;
-
-        if (bFraction)
+        for (int ny = -info->nky[0] / 2; ny < info->nky[0] / 2 + 1; ny++)
         {
-            /* Randomly pick a charge */
-            ci = numbers[i];
-        }
-        else
-        {
-            /* Use all charges */
-            ci = i;
-        }
-
-        /* for(nx=startlocal; nx<=stoplocal; nx++)*/
-        for (nx = -info->nkx[0] / 2; nx < info->nkx[0] / 2 + 1; nx++)
-        {
-            svmul(nx, info->recipbox[XX], gridpx);
-            for (ny = -info->nky[0] / 2; ny < info->nky[0] / 2 + 1; ny++)
+            for (int nz = -info->nkz[0] / 2; nz < info->nkz[0] / 2 + 1; nz++)
             {
-                svmul(ny, info->recipbox[YY], tmpvec);
-                rvec_add(gridpx, tmpvec, gridpxy);
-                for (nz = -info->nkz[0] / 2; nz < info->nkz[0] / 2 + 1; nz++)
+                if (nx == 0 && ny == 0 && nz == 0)
                 {
-
-                    if (0 == nx && 0 == ny && 0 == nz)
-                    {
-                        continue;
-                    }
-
-                    svmul(nz, info->recipbox[ZZ], tmpvec);
-                    rvec_add(gridpxy, tmpvec, gridp);
-                    tmp = norm2(gridp);
-                    coeff = std::exp(-1.0 * M_PI * M_PI * tmp / info->ewald_beta[0] / info->ewald_beta[0]);
-                    coeff /= tmp;
-                    e_rec3x += coeff
-                               * eps_self(nx, info->nkx[0], info->recipbox[XX], info->pme_order[0], x[ci]);
-                    e_rec3y += coeff
-                               * eps_self(ny, info->nky[0], info->recipbox[YY], info->pme_order[0], x[ci]);
-                    e_rec3z += coeff
-                               * eps_self(nz, info->nkz[0], info->recipbox[ZZ], info->pme_order[0], x[ci]);
+                    continue;
+                }
+                rvec k;
+                for (int d = 0; d < DIM; d++)
+                {
+                    k[d] = 2.0 * M_PI
+                           * (nx * info->recipbox[XX][d] + ny * info->recipbox[YY][d]
+                              + nz * info->recipbox[ZZ][d]);
                 }
+                const double k2 = norm2(k);
+                sum += std::exp(-k2 / (2 * beta * beta)) / k2;
             }
         }
-
-        clear_rvec(tmpvec2);
-
-        svmul(e_rec3x, info->recipbox[XX], tmpvec);
-        rvec_inc(tmpvec2, tmpvec);
-        svmul(e_rec3y, info->recipbox[YY], tmpvec);
-        rvec_inc(tmpvec2, tmpvec);
-        svmul(e_rec3z, info->recipbox[ZZ], tmpvec);
-        rvec_inc(tmpvec2, tmpvec);
-
-        e_rec3 += q[ci] * q[ci] * q[ci] * q[ci] * norm2(tmpvec2)
-                  / (xtot * M_PI * info->volume * M_PI * info->volume);
-        if (MASTER(cr))
-        {
-            fprintf(stderr, "\rCalculating reciprocal error part 2 ... %3.0f%%", 100.0 * (i + 1) / stoplocal);
-            fflush(stderr);
-        }
-    }
-
-    if (MASTER(cr))
-    {
-        fprintf(stderr, "\n");
-    }
-
-#if GMX_LIB_MPI
-#    ifdef TAKETIME
-    if (MASTER(cr))
-    {
-        t1 = MPI_Wtime() - t0;
-        fprintf(fp_out, "Recip. err. est. took   : %lf s\n", t1);
-    }
-#    endif
-#endif
-
-#ifdef DEBUG
-    if (PAR(cr))
-    {
-        fprintf(stderr, "Rank %3d: nx=[%3d...%3d]  e_rec3=%e\n", cr->nodeid, startlocal, stoplocal, e_rec3);
     }
-#endif
 
-    if (PAR(cr))
-    {
-        gmx_sum(1, &e_rec1, cr);
-        gmx_sum(1, &e_rec2, cr);
-        gmx_sum(1, &e_rec3, cr);
-    }
-
-    /* e_rec1*=8.0 * q2_all / info->volume / info->volume / nr ;
-       e_rec2*=  q2_all / M_PI / M_PI / info->volume / info->volume / nr ;
-       e_rec3/= M_PI * M_PI * info->volume * info->volume * nr ;
-     */
-    e_rec = std::sqrt(e_rec1 + e_rec2 + e_rec3);
+    /* The RMS reciprocal-space field at a random position and the RMS force */
+    const double fieldRms = 4.0 * M_PI * std::sqrt(info->q2all * sum) / info->volume;
+    const double forceRms = std::sqrt(info->q2all / info->q2allnr) * fieldRms;
 
+    const double relativeRoundingError = std::ldexp(1.0, -11) / std::sqrt(3.0);
+    const int    numTransposes         = 4;
 
-    return gmx::c_one4PiEps0 * e_rec;
+    return gmx::c_one4PiEps0 * relativeRoundingError * std::sqrt(numTransposes) * forceRms;
 }
 
 
@@ -854,7 +393,7 @@ static void read_tpr_file(const char*  fn_sim_tpr,
                           real         user_beta,
                           real         fracself)
 {
-    read_tpx_state(fn_sim_tpr, ir, state, mtop);
+    read_tpx_state_no_broadcast(fn_sim_tpr, ir, state, mtop);
 
     /* The values of the original tpr input file are save in the first
      * place [0] of the arrays */
@@ -931,7 +470,7 @@ static void estimate_PME_error(t_inputinfo*      info,
     real  beta  = 0.0;     /* splitting parameter beta */
     real  beta0 = 0.0;     /* splitting parameter beta */
     int   ncharges;        /* The number of atoms with charges */
-    int   nsamples;        /* The number of samples used for the calculation of the
+    int   nsamples = 0;    /* The number of samples used for the calculation of the
                             * self-energy error term */
     int i = 0;
 
@@ -942,6 +481,21 @@ static void estimate_PME_error(t_inputinfo*      info,
 
     /* Prepare an x and q array with only the charged atoms */
     ncharges = prepare_x_q(&q, &x, mtop, state->x.rvec_array(), cr);
+
+    std::unique_ptr<gmx::PmeReciprocalErrorEstimator> recipErrorEstimator;
+    if (MASTER(cr))
+    {
+        const std::vector<int> samples = draw_self_term_samples(info, ncharges, seed, bVerbose);
+        recipErrorEstimator = std::make_unique<gmx::PmeReciprocalErrorEstimator>(
+                gmx::constArrayRefFromArray(reinterpret_cast<const gmx::RVec*>(x), ncharges),
+                gmx::constArrayRefFromArray(q, ncharges),
+                samples,
+                info->recipbox,
+                info->volume,
+                info->pme_order[0],
+                gmx_omp_get_max_threads());
+        nsamples = recipErrorEstimator->numSelfTermSamples();
+    }
     if (MASTER(cr))
     {
         calc_q2all(mtop, &(info->q2all), &(info->q2allnr));
@@ -967,7 +521,7 @@ static void estimate_PME_error(t_inputinfo*      info,
     info->e_dir[0] = estimate_direct(info);
 
     /* Calculate reciprocal space error */
-    info->e_rec[0] = estimate_reciprocal(info, x, q, ncharges, fp_out, bVerbose, seed, &nsamples, cr);
+    info->e_rec[0] = estimate_reciprocal(info, recipErrorEstimator.get(), cr);
 
     if (PAR(cr))
     {
@@ -976,12 +530,15 @@ static void estimate_PME_error(t_inputinfo*      info,
 
     if (MASTER(cr))
     {
+        const real e_half = estimate_half_comm(info);
         fprintf(fp_out, "Direct space error est. : %10.3e kJ/(mol*nm)\n", info->e_dir[0]);
         fprintf(fp_out, "Reciprocal sp. err. est.: %10.3e kJ/(mol*nm)\n", info->e_rec[0]);
+        fprintf(fp_out, "FP16 FFT comm. err. est.: %10.3e kJ/(mol*nm)\n", e_half);
         fprintf(fp_out, "Self-energy error term was estimated using %d samples\n", nsamples);
         fflush(fp_out);
         fprintf(stderr, "Direct space error est. : %10.3e kJ/(mol*nm)\n", info->e_dir[0]);
         fprintf(stderr, "Reciprocal sp. err. est.: %10.3e kJ/(mol*nm)\n", info->e_rec[0]);
+        fprintf(stderr, "FP16 FFT comm. err. est.: %10.3e kJ/(mol*nm)\n", e_half);
     }
 
     i = 0;
@@ -1005,7 +562,7 @@ static void estimate_PME_error(t_inputinfo*      info,
             info->ewald_beta[0] -= 0.1;
         }
         info->e_dir[0] = estimate_direct(info);
-        info->e_rec[0] = estimate_reciprocal(info, x, q, ncharges, fp_out, bVerbose, seed, &nsamples, cr);
+        info->e_rec[0] = estimate_reciprocal(info, recipErrorEstimator.get(), cr);
 
         if (PAR(cr))
         {
@@ -1026,8 +583,7 @@ static void estimate_PME_error(t_inputinfo*      info,
             derr0               = derr;
 
             info->e_dir[0] = estimate_direct(info);
-            info->e_rec[0] =
-                    estimate_reciprocal(info, x, q, ncharges, fp_out, bVerbose, seed, &nsamples, cr);
+            info->e_rec[0] = estimate_reciprocal(info, recipErrorEstimator.get(), cr);
 
             if (PAR(cr))
             {
@@ -1056,11 +612,14 @@ static void estimate_PME_error(t_inputinfo*      info,
         {
             /* Write some info to log file */
             fflush(fp_out);
+            const real e_half = estimate_half_comm(info);
             fprintf(fp_out, "=========  After tuning ========\n");
             fprintf(fp_out, "Direct space error est. : %10.3e kJ/(mol*nm)\n", info->e_dir[0]);
             fprintf(fp_out, "Reciprocal sp. err. est.: %10.3e kJ/(mol*nm)\n", info->e_rec[0]);
+            fprintf(fp_out, "FP16 FFT comm. err. est.: %10.3e kJ/(mol*nm)\n", e_half);
             fprintf(stderr, "Direct space error est. : %10.3e kJ/(mol*nm)\n", info->e_dir[0]);
             fprintf(stderr, "Reciprocal sp. err. est.: %10.3e kJ/(mol*nm)\n", info->e_rec[0]);
+            fprintf(stderr, "FP16 FFT comm. err. est.: %10.3e kJ/(mol*nm)\n", e_half);
             fprintf(fp_out, "Ewald_rtol              : %g\n", info->ewald_rtol[0]);
             fprintf(fp_out, "Ewald parameter beta    : %g\n", info->ewald_beta[0]);
             fflush(fp_out);
@@ -1080,6 +639,10 @@ int gmx_pme_error(int argc, char* argv[])
         "is computationally demanding. However, a good a approximation is to",
         "just use a fraction of the particles for this term which can be",
         "indicated by the flag [TT]-self[tt].[PAR]",
+        "The error is also estimated for storing the grid data in FP16 during the",
+        "parallel FFT transposes, as enabled by the environment variable",
+        "[TT]GMX_PME_FFT_HALF_COMM[tt], relative to full-precision PME.",
+        "Check that this is well below the reciprocal space error before enabling it.[PAR]",
     };
 
     real          fs        = 0.0; /* 0 indicates: not set by the user */
@@ -151,6 +151,32 @@ static void scan_trj_files(gmx::ArrayRef<const std::string> files,
     fprintf(stderr, "\n");
 }
 
+/*! \brief Reads the next frame of \p fio into \p xtcFrame, keeping the compressed coordinates
+ *
+ * Sets the frame header information in \p fr, so the frame selection can
+ * use the same code as with decompressed frames.
+ */
+static bool readNextXtcPassThroughFrame(t_fileio*               fio,
+                                        t_xtc_compressed_frame* xtcFrame,
+                                        t_trxframe*             fr)
+{
+    gmx_bool bOK;
+    if (!read_next_xtc_compressed(fio, xtcFrame, &bOK))
+    {
+        if (!bOK)
+        {
+            fprintf(stderr, "\nWARNING: Incomplete frame after time %g\n", fr->time);
+        }
+        return false;
+    }
+    fr->natoms = xtcFrame->natoms;
+    fr->bStep  = TRUE;
+    fr->step   = xtcFrame->step;
+    fr->bTime  = TRUE;
+    fr->time   = xtcFrame->time;
+    return true;
+}
+
 static void sort_files(gmx::ArrayRef<std::string> files, real* settime)
 {
     for (gmx::index i = 0; i < files.ssize(); i++)
@@ -437,6 +463,9 @@ int gmx_trjcat(int argc, char* argv[])
         "such that a command like [TT]gmx trjcat -f *.trr -o fixed.trr[tt] should do ",
         "the trick. Using [TT]-cat[tt], you can simply paste several files ",
         "together without removal of frames with identical time stamps.[PAR]",
+        "When both input and output are [REF].xtc[ref] files and no index group",
+        "is selected, the compressed coordinates are copied unchanged, without",
+        "decompressing and compressing them again.[PAR]",
         "One important option is inferred when the output file is amongst the",
         "input files. In that case that particular file will be appended to",
         "which implies you do not need to store double the amount of data.",
@@ -785,6 +814,11 @@ int gmx_trjcat(int argc, char* argv[])
             }
             frout = fr;
         }
+        /* XTC frames can be copied without touching the compressed coordinates */
+        const bool             bPassThrough = (ftpin == efXTC && ftpout == efXTC && !bIndex);
+        t_fileio*              xtcIn        = nullptr;
+        t_xtc_compressed_frame xtcFrame;
+
         /* Lets stitch up some files */
         timestep = timest[0];
         for (size_t i = n_append + 1; i < inFilesEdited.size(); i++)
@@ -844,7 +878,19 @@ int gmx_trjcat(int argc, char* argv[])
             {
                 timestep = timest[i];
             }
-            read_first_frame(oenv, &status, inFilesEdited[i].c_str(), &fr, FLAGS);
+            if (bPassThrough)
+            {
+                xtcIn = open_xtc(inFilesEdited[i].c_str(), "r");
+                clear_trxframe(&fr, TRUE);
+                if (!readNextXtcPassThroughFrame(xtcIn, &xtcFrame, &fr))
+                {
+                    gmx_fatal(FARGS, "Reading first frame from %s", inFilesEdited[i].c_str());
+                }
+            }
+            else
+            {
+                read_first_frame(oenv, &status, inFilesEdited[i].c_str(), &fr, FLAGS);
+            }
             if (!fr.bTime)
             {
                 fr.time = 0;
@@ -932,7 +978,18 @@ int gmx_trjcat(int argc, char* argv[])
                             bNewFile = FALSE;
                         }
 
-                        if (bIndex)
+                        if (bPassThrough)
+                        {
+                            xtcFrame.time = frout.time;
+                            if (!write_xtc_compressed(trx_get_fileio(trxout), &xtcFrame))
+                            {
+                                gmx_fatal(FARGS,
+                                          "Error writing frame at time %g to %s",
+                                          frout.time,
+                                          out_file);
+                            }
+                        }
+                        else if (bIndex)
                         {
                             write_trxframe_indexed(trxout, &frout, isize, index, nullptr);
                         }
@@ -951,9 +1008,17 @@ int gmx_trjcat(int argc, char* argv[])
                         }
                     }
                 }
-            } while (read_next_frame(oenv, status, &fr));
+            } while (bPassThrough ? readNextXtcPassThroughFrame(xtcIn, &xtcFrame, &fr)
+                                  : read_next_frame(oenv, status, &fr));
 
-            close_trx(status);
+            if (bPassThrough)
+            {
+                close_xtc(xtcIn);
+            }
+            else
+            {
+                close_trx(status);
+            }
         }
         if (trxout)
         {
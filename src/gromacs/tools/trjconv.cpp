@@ -55,6 +55,7 @@
 #include "gromacs/fileio/pdbio.h"
 #include "gromacs/fileio/tngio.h"
 #include "gromacs/fileio/tpxio.h"
+#include "gromacs/fileio/trajectorywriterthread.h"
 #include "gromacs/fileio/trrio.h"
 #include "gromacs/fileio/trxio.h"
 #include "gromacs/fileio/xtcio.h"
@@ -575,6 +576,8 @@ int gmx_trjconv(int argc, char* argv[])
 
     FILE*        out    = nullptr;
     t_trxstatus* trxout = nullptr;
+    /* Writes XTC and TRR frames asynchronously if set */
+    std::unique_ptr<gmx::TrajectoryWriterThread> trajectoryWriter;
     t_trxstatus* trxin;
     int          file_nr;
     t_trxframe   fr, frout, nextFrame, previousFrame, *frameToDump = nullptr;
@@ -1065,6 +1068,10 @@ int gmx_trjconv(int argc, char* argv[])
                     {
                         trxout = open_trx(out_file, filemode);
                     }
+                    if (getenv("GMX_TRAJECTORY_WRITER_THREAD") != nullptr)
+                    {
+                        trajectoryWriter = std::make_unique<gmx::TrajectoryWriterThread>();
+                    }
                     break;
                 case efGRO:
                 case efG96:
@@ -1489,11 +1496,22 @@ int gmx_trjconv(int argc, char* argv[])
                                 {
                                     if (trxout)
                                     {
+                                        if (trajectoryWriter)
+                                        {
+                                            trajectoryWriter->flush();
+                                        }
                                         close_trx(trxout);
                                     }
                                     trxout = open_trx(out_file2, filemode);
                                 }
-                                write_trxframe(trxout, &frout, gc);
+                                if (trajectoryWriter)
+                                {
+                                    trajectoryWriter->writeTrxFrame(trxout, frout);
+                                }
+                                else
+                                {
+                                    write_trxframe(trxout, &frout, gc);
+                                }
                                 break;
                             case efGRO:
                             case efG96:
@@ -1644,6 +1662,10 @@ int gmx_trjconv(int argc, char* argv[])
             gmx_rmpbc_done(gpbc);
         }
 
+        if (trajectoryWriter)
+        {
+            trajectoryWriter->flush();
+        }
         if (trxout)
         {
             close_trx(trxout);
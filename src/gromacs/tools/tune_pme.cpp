@@ -877,7 +877,7 @@ static void modify_PMEsettings(int64_t     simsteps,    /* Set this value as num
 
     t_inputrec  irInstance;
     t_inputrec* ir = &irInstance;
-    read_tpx_state(fn_best_tpr, ir, &state, &mtop);
+    read_tpx_state_no_broadcast(fn_best_tpr, ir, &state, &mtop);
 
     /* Reset nsteps and init_step to the value of the input .tpr file */
     ir->nsteps    = simsteps;
@@ -940,7 +940,7 @@ static void make_benchmark_tprs(const char* fn_sim_tpr,  /* READ : User-provided
 
     t_inputrec  irInstance;
     t_inputrec* ir = &irInstance;
-    read_tpx_state(fn_sim_tpr, ir, &state, &mtop);
+    read_tpx_state_no_broadcast(fn_sim_tpr, ir, &state, &mtop);
 
     /* Check if some kind of PME was chosen */
     if (EEL_PME(ir->coulombtype) == FALSE)
@@ -2077,7 +2077,7 @@ static float inspect_tpr(int nfile, t_filenm fnm[], real* rcoulomb)
     /* Check tpr file for options that trigger extra output files */
     t_inputrec  irInstance;
     t_inputrec* ir = &irInstance;
-    read_tpx_state(opt2fn("-s", nfile, fnm), ir, &state, &mtop);
+    read_tpx_state_no_broadcast(opt2fn("-s", nfile, fnm), ir, &state, &mtop);
     bFree = (FreeEnergyPerturbationType::No != ir->efep);
     bNM   = (IntegrationAlgorithm::NM == ir->eI);
     bSwap = (SwapType::No != ir->eSwapCoords);
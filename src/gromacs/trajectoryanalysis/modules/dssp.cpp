@@ -0,0 +1,933 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements gmx::analysismodules::Dssp.
+ *
+ * The assignment follows the algorithm of Kabsch and Sander as implemented
+ * in the DSSP program: backbone hydrogen bonds are found from the
+ * electrostatic energy between the N-H and C=O groups, and helices, turns,
+ * bridges, strands and bends are assigned from the hydrogen-bond patterns
+ * and the backbone geometry.
+ *
+ * \ingroup module_trajectoryanalysis
+ */
+#include "gmxpre.h"
+
+#include "dssp.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gromacs/analysisdata/analysisdata.h"
+#include "gromacs/analysisdata/modules/plot.h"
+#include "gromacs/math/units.h"
+#include "gromacs/math/vec.h"
+#include "gromacs/options/basicoptions.h"
+#include "gromacs/options/filenameoption.h"
+#include "gromacs/options/ioptionscontainer.h"
+#include "gromacs/pbcutil/pbc.h"
+#include "gromacs/selection/nbsearch.h"
+#include "gromacs/selection/selection.h"
+#include "gromacs/selection/selectionoption.h"
+#include "gromacs/topology/topology.h"
+#include "gromacs/trajectory/trajectoryframe.h"
+#include "gromacs/trajectoryanalysis/analysissettings.h"
+#include "gromacs/trajectoryanalysis/topologyinformation.h"
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/enumerationhelpers.h"
+#include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/pleasecite.h"
+#include "gromacs/utility/stringutil.h"
+#include "gromacs/utility/textwriter.h"
+
+namespace gmx
+{
+
+namespace analysismodules
+{
+
+namespace
+{
+
+//! \addtogroup module_trajectoryanalysis
+//! \{
+
+//! Secondary structure types assigned to residues.
+enum class SecondaryStructureType : int
+{
+    Loop,
+    AlphaHelix,
+    Bridge,
+    Strand,
+    Helix310,
+    HelixPi,
+    Turn,
+    Bend,
+    Count
+};
+
+//! One-letter codes corresponding to SecondaryStructureType.
+const EnumerationArray<SecondaryStructureType, char> c_secondaryStructureCodes = {
+    { '~', 'H', 'B', 'E', 'G', 'I', 'T', 'S' }
+};
+//! Legends corresponding to SecondaryStructureType.
+const EnumerationArray<SecondaryStructureType, const char*> c_secondaryStructureNames = {
+    { "Loop", "A-Helix", "B-Bridge", "B-Strand", "3-Helix", "5-Helix", "Turn", "Bend" }
+};
+
+//! Character written for a chain break between two residues.
+const char c_chainBreakCode = '=';
+
+//! Maximum C-N distance (nm) between consecutive residues that are bonded.
+const real c_maxPeptideBondLength = 0.25;
+//! N-H bond length (nm) used to place the amide hydrogen.
+const real c_amideHydrogenDistance = 0.1;
+//! Electrostatic coupling constant of the hydrogen-bond energy (kcal/mol nm).
+const real c_hbondCouplingConstant = -27.888 * 0.1;
+//! Distance (nm) below which the hydrogen-bond energy is set to its minimum.
+const real c_minimalHBondDistance = 0.05;
+//! Lowest hydrogen-bond energy (kcal/mol).
+const real c_minHBondEnergy = -9.9;
+//! Energy (kcal/mol) below which a hydrogen bond is present.
+const real c_maxHBondEnergy = -0.5;
+//! Minimum angle (degrees) between CA(i-2)-CA(i) and CA(i)-CA(i+2) for a bend.
+const real c_minBendAngle = 70;
+
+//! Atom indices of the backbone of one residue.
+struct BackboneResidue
+{
+    //! Index of the N atom.
+    int n;
+    //! Index of the CA atom.
+    int ca;
+    //! Index of the C atom.
+    int c;
+    //! Index of the O atom.
+    int o;
+    //! Whether the residue is a proline, which has no amide hydrogen.
+    bool isProline;
+    //! Chain identifier, bulges are only linked within one chain.
+    char chainId;
+};
+
+//! One of the two strongest hydrogen bonds of a residue.
+struct HBondPartner
+{
+    //! Index of the partner residue, -1 if none.
+    int residue = -1;
+    //! Energy of the hydrogen bond (kcal/mol).
+    real energy = 0;
+};
+
+//! Role of a residue in the n-turns of a given stride.
+enum class HelixFlag : int
+{
+    None,
+    Start,
+    End,
+    StartEnd,
+    Middle
+};
+
+//! Type of a beta bridge.
+enum class BridgeType : int
+{
+    None,
+    Parallel,
+    AntiParallel
+};
+
+//! Ladder of consecutive beta bridges between residues \c i and \c j.
+struct Bridge
+{
+    //! Type of the bridges in the ladder.
+    BridgeType type;
+    //! Residues on the first side of the ladder.
+    std::deque<int> i;
+    //! Residues on the second side of the ladder.
+    std::deque<int> j;
+};
+
+/*! \brief
+ * Assigns secondary structure to the residues of one frame.
+ *
+ * Holds the work arrays for the assignment, so that one object can be reused
+ * for all frames analyzed by one thread.
+ */
+class SecondaryStructureAssigner
+{
+public:
+    /*! \brief
+     * Assigns secondary structure for a frame.
+     *
+     * \param[in]  residues  Backbone atoms of the residues.
+     * \param[in]  x         Coordinates of the frame.
+     * \param[in]  pbc       Periodic boundary conditions, can be nullptr.
+     * \param[in]  nb        Neighborhood search with the CA-CA cutoff.
+     * \param[out] result    Secondary structure string, with chain breaks.
+     * \param[out] counts    Number of residues of each type.
+     */
+    void assign(ArrayRef<const BackboneResidue>                 residues,
+                const rvec*                                     x,
+                const t_pbc*                                    pbc,
+                AnalysisNeighborhood*                           nb,
+                std::string*                                    result,
+                EnumerationArray<SecondaryStructureType, int>* counts);
+
+private:
+    //! Returns the vector from \p x2 to \p x1, taking PBC into account.
+    void computeDx(const rvec x1, const rvec x2, rvec dx) const
+    {
+        if (pbc_ != nullptr)
+        {
+            pbc_dx(pbc_, x1, x2, dx);
+        }
+        else
+        {
+            rvec_sub(x1, x2, dx);
+        }
+    }
+    //! Returns the distance between \p x1 and \p x2, taking PBC into account.
+    real distance(const rvec x1, const rvec x2) const
+    {
+        rvec dx;
+        computeDx(x1, x2, dx);
+        return norm(dx);
+    }
+    //! Returns true when residues \p a to \p b are all connected.
+    bool noChainBreak(int a, int b) const { return breakCount_[a] == breakCount_[b]; }
+    //! Returns true when the N-H of \p donor is hydrogen bonded to the C=O of \p acceptor.
+    bool testBond(int donor, int acceptor) const
+    {
+        const std::array<HBondPartner, 2>& partners = acceptors_[donor];
+        return (partners[0].residue == acceptor && partners[0].energy < c_maxHBondEnergy)
+               || (partners[1].residue == acceptor && partners[1].energy < c_maxHBondEnergy);
+    }
+    //! Returns true when residue \p i starts an n-turn of \p stride.
+    bool isHelixStart(int stride, int i) const
+    {
+        const HelixFlag flag = helixFlags_[stride - 3][i];
+        return flag == HelixFlag::Start || flag == HelixFlag::StartEnd;
+    }
+
+    //! Computes the hydrogen-bond energy between \p donor and \p acceptor and stores it.
+    void calculateHBondEnergy(int donor, int acceptor);
+    //! Computes the hydrogen bonds between all residue pairs with CA atoms within the cutoff.
+    void calculateHBonds(AnalysisNeighborhood* nb);
+    //! Returns the type of bridge between residues \p i and \p j.
+    BridgeType testBridge(int i, int j) const;
+    //! Assigns bridges and strands.
+    void calculateBetaSheets();
+    //! Assigns helices, turns and bends.
+    void calculateHelicesTurnsAndBends();
+
+    //! Backbone atom indices of the residues.
+    ArrayRef<const BackboneResidue> residues_;
+    //! Coordinates of the current frame.
+    const rvec* x_ = nullptr;
+    //! PBC of the current frame.
+    const t_pbc* pbc_ = nullptr;
+    //! Position of the amide hydrogen of each residue.
+    std::vector<RVec> hydrogen_;
+    //! CA positions, used for the neighborhood search and bends.
+    std::vector<RVec> caPositions_;
+    //! Number of chain breaks up to and including each residue.
+    std::vector<int> breakCount_;
+    //! Two strongest bonds where the N-H of each residue is the donor.
+    std::vector<std::array<HBondPartner, 2>> acceptors_;
+    //! Two strongest bonds where the C=O of each residue is the acceptor.
+    std::vector<std::array<HBondPartner, 2>> donors_;
+    //! Pairs of residues within the cutoff, sorted for a deterministic result.
+    std::vector<std::pair<int, int>> pairs_;
+    //! Flags for n-turns with n = 3, 4, 5.
+    std::array<std::vector<HelixFlag>, 3> helixFlags_;
+    //! Assigned secondary structure of each residue.
+    std::vector<SecondaryStructureType> secondaryStructure_;
+    //! Ladders found in the current frame.
+    std::vector<Bridge> bridges_;
+};
+
+void SecondaryStructureAssigner::calculateHBondEnergy(int donor, int acceptor)
+{
+    if (residues_[donor].isProline)
+    {
+        return;
+    }
+    const BackboneResidue& d = residues_[donor];
+    const BackboneResidue& a = residues_[acceptor];
+
+    const real distanceHO = distance(hydrogen_[donor], x_[a.o]);
+    const real distanceHC = distance(hydrogen_[donor], x_[a.c]);
+    const real distanceNC = distance(x_[d.n], x_[a.c]);
+    const real distanceNO = distance(x_[d.n], x_[a.o]);
+
+    real energy;
+    if (distanceHO < c_minimalHBondDistance || distanceHC < c_minimalHBondDistance
+        || distanceNC < c_minimalHBondDistance || distanceNO < c_minimalHBondDistance)
+    {
+        energy = c_minHBondEnergy;
+    }
+    else
+    {
+        energy = c_hbondCouplingConstant / distanceHO - c_hbondCouplingConstant / distanceHC
+                 + c_hbondCouplingConstant / distanceNC - c_hbondCouplingConstant / distanceNO;
+        // DSSP works with energies rounded to 0.001 kcal/mol
+        energy = std::max(c_minHBondEnergy, std::round(energy * 1000) / 1000);
+    }
+
+    std::array<HBondPartner, 2>& donorBonds = acceptors_[donor];
+    if (energy < donorBonds[0].energy)
+    {
+        donorBonds[1] = donorBonds[0];
+        donorBonds[0] = { acceptor, energy };
+    }
+    else if (energy < donorBonds[1].energy)
+    {
+        donorBonds[1] = { acceptor, energy };
+    }
+
+    std::array<HBondPartner, 2>& acceptorBonds = donors_[acceptor];
+    if (energy < acceptorBonds[0].energy)
+    {
+        acceptorBonds[1] = acceptorBonds[0];
+        acceptorBonds[0] = { donor, energy };
+    }
+    else if (energy < acceptorBonds[1].energy)
+    {
+        acceptorBonds[1] = { donor, energy };
+    }
+}
+
+void SecondaryStructureAssigner::calculateHBonds(AnalysisNeighborhood* nb)
+{
+    const int nres = residues_.ssize();
+
+    pairs_.clear();
+    AnalysisNeighborhoodSearch search =
+            nb->initSearch(pbc_, AnalysisNeighborhoodPositions(caPositions_));
+    AnalysisNeighborhoodPairSearch pairSearch = search.startSelfPairSearch();
+    AnalysisNeighborhoodPair       pair;
+    while (pairSearch.findNextPair(&pair))
+    {
+        pairs_.emplace_back(std::min(pair.refIndex(), pair.testIndex()),
+                            std::max(pair.refIndex(), pair.testIndex()));
+    }
+    // The two strongest bonds of a residue can depend on the order in which
+    // equal energies are found, so process the pairs in residue order.
+    std::sort(pairs_.begin(), pairs_.end());
+
+    acceptors_.assign(nres, {});
+    donors_.assign(nres, {});
+    for (const auto& residuePair : pairs_)
+    {
+        const int i = residuePair.first;
+        const int j = residuePair.second;
+        calculateHBondEnergy(i, j);
+        if (j != i + 1)
+        {
+            calculateHBondEnergy(j, i);
+        }
+    }
+}
+
+BridgeType SecondaryStructureAssigner::testBridge(int i, int j) const
+{
+    const int a = i - 1;
+    const int b = i;
+    const int c = i + 1;
+    const int d = j - 1;
+    const int e = j;
+    const int f = j + 1;
+
+    if (noChainBreak(a, c) && noChainBreak(d, f))
+    {
+        if ((testBond(c, e) && testBond(e, a)) || (testBond(f, b) && testBond(b, d)))
+        {
+            return BridgeType::Parallel;
+        }
+        if ((testBond(c, d) && testBond(f, a)) || (testBond(e, b) && testBond(b, e)))
+        {
+            return BridgeType::AntiParallel;
+        }
+    }
+    return BridgeType::None;
+}
+
+void SecondaryStructureAssigner::calculateBetaSheets()
+{
+    const int nres = residues_.ssize();
+
+    bridges_.clear();
+    for (int i = 1; i + 4 < nres; ++i)
+    {
+        for (int j = i + 3; j + 1 < nres; ++j)
+        {
+            const BridgeType type = testBridge(i, j);
+            if (type == BridgeType::None)
+            {
+                continue;
+            }
+            bool found = false;
+            for (Bridge& bridge : bridges_)
+            {
+                if (type != bridge.type || i != bridge.i.back() + 1)
+                {
+                    continue;
+                }
+                if (type == BridgeType::Parallel && bridge.j.back() + 1 == j)
+                {
+                    bridge.i.push_back(i);
+                    bridge.j.push_back(j);
+                    found = true;
+                    break;
+                }
+                if (type == BridgeType::AntiParallel && bridge.j.front() - 1 == j)
+                {
+                    bridge.i.push_back(i);
+                    bridge.j.push_front(j);
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+            {
+                bridges_.push_back({ type, { i }, { j } });
+            }
+        }
+    }
+
+    std::sort(bridges_.begin(), bridges_.end(), [](const Bridge& b1, const Bridge& b2) {
+        return b1.i.front() < b2.i.front();
+    });
+
+    // Link ladders separated by a bulge. DSSP uses unsigned residue
+    // differences here, so a negative difference never passes a bound.
+    auto below = [](int difference, int bound) { return difference >= 0 && difference < bound; };
+    for (size_t bi = 0; bi < bridges_.size(); ++bi)
+    {
+        for (size_t bj = bi + 1; bj < bridges_.size(); ++bj)
+        {
+            Bridge&       first  = bridges_[bi];
+            const Bridge& second = bridges_[bj];
+            const int     ibi    = first.i.front();
+            const int     iei    = first.i.back();
+            const int     jbi    = second.i.front();
+            const int     jei    = second.i.back();
+            const int     ibj    = first.j.front();
+            const int     iej    = first.j.back();
+            const int     jbj    = second.j.front();
+            const int     jej    = second.j.back();
+
+            if (first.type != second.type
+                || residues_[std::min(ibi, jbi)].chainId != residues_[std::max(iei, jei)].chainId
+                || residues_[std::min(ibj, jbj)].chainId != residues_[std::max(iej, jej)].chainId
+                || !below(jbi - iei, 6) || (iei >= jbi && ibi <= jei))
+            {
+                continue;
+            }
+
+            bool bulge;
+            if (first.type == BridgeType::Parallel)
+            {
+                bulge = (below(jbj - iej, 6) && below(jbi - iei, 3)) || below(jbj - iej, 3);
+            }
+            else
+            {
+                bulge = (below(ibj - jej, 6) && below(jbi - iei, 3)) || below(ibj - jej, 3);
+            }
+
+            if (bulge)
+            {
+                first.i.insert(first.i.end(), second.i.begin(), second.i.end());
+                if (first.type == BridgeType::Parallel)
+                {
+                    first.j.insert(first.j.end(), second.j.begin(), second.j.end());
+                }
+                else
+                {
+                    first.j.insert(first.j.begin(), second.j.begin(), second.j.end());
+                }
+                bridges_.erase(bridges_.begin() + bj);
+                --bj;
+            }
+        }
+    }
+
+    for (const Bridge& bridge : bridges_)
+    {
+        const SecondaryStructureType type = (bridge.i.size() > 1) ? SecondaryStructureType::Strand
+                                                                  : SecondaryStructureType::Bridge;
+        for (int i = bridge.i.front(); i <= bridge.i.back(); ++i)
+        {
+            if (secondaryStructure_[i] != SecondaryStructureType::Strand)
+            {
+                secondaryStructure_[i] = type;
+            }
+        }
+        for (int j = bridge.j.front(); j <= bridge.j.back(); ++j)
+        {
+            if (secondaryStructure_[j] != SecondaryStructureType::Strand)
+            {
+                secondaryStructure_[j] = type;
+            }
+        }
+    }
+}
+
+void SecondaryStructureAssigner::calculateHelicesTurnsAndBends()
+{
+    const int nres = residues_.ssize();
+
+    for (int stride = 3; stride <= 5; ++stride)
+    {
+        std::vector<HelixFlag>& flags = helixFlags_[stride - 3];
+        flags.assign(nres, HelixFlag::None);
+        for (int i = 0; i + stride < nres; ++i)
+        {
+            if (testBond(i + stride, i) && noChainBreak(i, i + stride))
+            {
+                flags[i + stride] = HelixFlag::End;
+                for (int j = i + 1; j < i + stride; ++j)
+                {
+                    if (flags[j] == HelixFlag::None)
+                    {
+                        flags[j] = HelixFlag::Middle;
+                    }
+                }
+                flags[i] = (flags[i] == HelixFlag::End) ? HelixFlag::StartEnd : HelixFlag::Start;
+            }
+        }
+    }
+
+    for (int i = 1; i + 4 < nres; ++i)
+    {
+        if (isHelixStart(4, i) && isHelixStart(4, i - 1))
+        {
+            for (int j = i; j <= i + 3; ++j)
+            {
+                secondaryStructure_[j] = SecondaryStructureType::AlphaHelix;
+            }
+        }
+    }
+
+    // 3-10 and pi helices are only assigned to residues that have no higher
+    // priority structure
+    const std::array<SecondaryStructureType, 2> minorHelixTypes = {
+        SecondaryStructureType::Helix310, SecondaryStructureType::HelixPi
+    };
+    for (int stride = 3; stride <= 5; stride += 2)
+    {
+        const SecondaryStructureType helixType = minorHelixTypes[(stride - 3) / 2];
+        for (int i = 1; i + stride < nres; ++i)
+        {
+            if (isHelixStart(stride, i) && isHelixStart(stride, i - 1))
+            {
+                bool empty = true;
+                for (int j = i; empty && j < i + stride; ++j)
+                {
+                    empty = (secondaryStructure_[j] == SecondaryStructureType::Loop
+                             || secondaryStructure_[j] == helixType);
+                }
+                if (empty)
+                {
+                    for (int j = i; j < i + stride; ++j)
+                    {
+                        secondaryStructure_[j] = helixType;
+                    }
+                }
+            }
+        }
+    }
+
+    for (int i = 1; i + 1 < nres; ++i)
+    {
+        if (secondaryStructure_[i] != SecondaryStructureType::Loop)
+        {
+            continue;
+        }
+        bool isTurn = false;
+        for (int stride = 3; stride <= 5 && !isTurn; ++stride)
+        {
+            for (int k = 1; k < stride && !isTurn; ++k)
+            {
+                isTurn = (i >= k) && isHelixStart(stride, i - k);
+            }
+        }
+        if (isTurn)
+        {
+            secondaryStructure_[i] = SecondaryStructureType::Turn;
+        }
+        else if (i >= 2 && i + 2 < nres && noChainBreak(i - 2, i + 2))
+        {
+            rvec before, after;
+            computeDx(caPositions_[i], caPositions_[i - 2], before);
+            computeDx(caPositions_[i + 2], caPositions_[i], after);
+            if (gmx_angle(before, after) * c_rad2Deg > c_minBendAngle)
+            {
+                secondaryStructure_[i] = SecondaryStructureType::Bend;
+            }
+        }
+    }
+}
+
+void SecondaryStructureAssigner::assign(ArrayRef<const BackboneResidue>                 residues,
+                                        const rvec*                                     x,
+                                        const t_pbc*                                    pbc,
+                                        AnalysisNeighborhood*                           nb,
+                                        std::string*                                    result,
+                                        EnumerationArray<SecondaryStructureType, int>* counts)
+{
+    residues_      = residues;
+    x_             = x;
+    pbc_           = pbc;
+    const int nres = residues_.ssize();
+
+    hydrogen_.resize(nres);
+    caPositions_.resize(nres);
+    breakCount_.resize(nres);
+    for (int r = 0; r < nres; ++r)
+    {
+        const BackboneResidue& res = residues_[r];
+        caPositions_[r]            = x_[res.ca];
+        const bool chainBreak =
+                (r == 0 || distance(x_[residues_[r - 1].c], x_[res.n]) > c_maxPeptideBondLength);
+        breakCount_[r] = (r == 0) ? 0 : breakCount_[r - 1] + (chainBreak ? 1 : 0);
+
+        // The amide hydrogen is placed along the C=O direction of the
+        // previous residue, as in DSSP.
+        copy_rvec(x_[res.n], hydrogen_[r]);
+        if (!chainBreak)
+        {
+            const BackboneResidue& prev = residues_[r - 1];
+            rvec                   co;
+            computeDx(x_[prev.c], x_[prev.o], co);
+            unitv(co, co);
+            svmul(c_amideHydrogenDistance, co, co);
+            rvec_inc(hydrogen_[r], co);
+        }
+    }
+
+    calculateHBonds(nb);
+
+    secondaryStructure_.assign(nres, SecondaryStructureType::Loop);
+    calculateBetaSheets();
+    calculateHelicesTurnsAndBends();
+
+    result->clear();
+    std::fill(counts->begin(), counts->end(), 0);
+    for (int r = 0; r < nres; ++r)
+    {
+        if (r > 0 && !noChainBreak(r - 1, r))
+        {
+            result->push_back(c_chainBreakCode);
+        }
+        result->push_back(c_secondaryStructureCodes[secondaryStructure_[r]]);
+        (*counts)[secondaryStructure_[r]]++;
+    }
+}
+
+/*! \brief
+ * Frame-local data needed in secondary structure assignment.
+ */
+class DsspModuleData : public TrajectoryAnalysisModuleData
+{
+public:
+    /*! \brief
+     * Initializes thread-local storage for secondary structure assignment.
+     *
+     * \param[in] module     Module that owns this data.
+     * \param[in] opt        Parallel options.
+     * \param[in] selections Thread-local selection collection.
+     */
+    DsspModuleData(TrajectoryAnalysisModule*          module,
+                   const AnalysisDataParallelOptions& opt,
+                   const SelectionCollection&         selections) :
+        TrajectoryAnalysisModuleData(module, opt, selections)
+    {
+    }
+
+    void finish() override { finishDataHandles(); }
+
+    //! Work arrays for the assignment.
+    SecondaryStructureAssigner assigner_;
+    //! Secondary structure string of the current frame.
+    std::string result_;
+    //! Number of residues of each type in the current frame.
+    EnumerationArray<SecondaryStructureType, int> counts_;
+};
+
+/*! \brief
+ * Implements `gmx dssp` trajectory analysis module.
+ */
+class Dssp : public TrajectoryAnalysisModule
+{
+public:
+    Dssp();
+
+    void initOptions(IOptionsContainer* options, TrajectoryAnalysisSettings* settings) override;
+    void initAnalysis(const TrajectoryAnalysisSettings& settings, const TopologyInformation& top) override;
+
+    TrajectoryAnalysisModuleDataPointer startFrames(const AnalysisDataParallelOptions& opt,
+                                                    const SelectionCollection& selections) override;
+    void                                analyzeFrame(int frnr, const t_trxframe& fr, t_pbc* pbc, TrajectoryAnalysisModuleData* pdata) override;
+
+    void finishAnalysis(int nframes) override;
+    void writeOutput() override;
+
+private:
+    //! Selection of the residues to analyze.
+    Selection sel_;
+    //! Name of the output file with the secondary structure strings.
+    std::string fnSecondaryStructure_;
+    //! Name of the output file with the number of residues per type.
+    std::string fnCounts_;
+    //! Cutoff for the CA-CA distance of residues that can be hydrogen bonded.
+    double cutoff_;
+
+    //! Backbone atom indices of the analyzed residues.
+    std::vector<BackboneResidue> residues_;
+    //! Neighborhood search for the CA atoms.
+    AnalysisNeighborhood nb_;
+    //! Number of residues of each type as a function of time.
+    AnalysisData counts_;
+    //! Protects secondaryStructure_ with frame-parallel analysis.
+    std::mutex secondaryStructureMutex_;
+    //! Secondary structure string of each frame.
+    std::vector<std::string> secondaryStructure_;
+
+    // Copy and assign disallowed by base.
+};
+
+Dssp::Dssp() : cutoff_(0.9)
+{
+    registerAnalysisDataset(&counts_, "counts");
+}
+
+
+void Dssp::initOptions(IOptionsContainer* options, TrajectoryAnalysisSettings* settings)
+{
+    static const char* const desc[] = {
+        "[THISMODULE] assigns secondary structure to the residues of a protein",
+        "using the DSSP algorithm of Kabsch and Sander. In contrast to",
+        "[gmx-do_dssp], the assignment is done in the same process, and no",
+        "external DSSP program or temporary files are needed.[PAR]",
+        "The backbone hydrogen bonds are computed from the electrostatic",
+        "energy between the N-H and C=O groups. Only pairs of residues with C-alpha",
+        "atoms closer than [TT]-cutoff[tt] are considered. The amide hydrogens are",
+        "placed as in DSSP, from the C=O direction of the preceding residue, so",
+        "the hydrogens in the input are not used.[PAR]",
+        "Each residue needs atoms named N, CA, C and O (or OC1 for the C terminus);",
+        "residues in the selection that miss any of these are ignored.",
+        "Consecutive residues with a C-N distance above 0.25 nm are treated as",
+        "a chain break.[PAR]",
+        "[TT]-o[tt] writes one line per frame, with one character per residue:",
+        "H = alpha helix, B = residue in isolated beta bridge, E = extended strand",
+        "in a ladder, G = 3-10 helix, I = pi helix, T = hydrogen-bonded turn,",
+        "S = bend and ~ = loop. Chain breaks are marked with =.[PAR]",
+        "[TT]-num[tt] writes the number of residues of each type as a function of time."
+    };
+
+    settings->setHelpText(desc);
+
+    options->addOption(FileNameOption("o")
+                               .filetype(OptionFileType::GenericData)
+                               .outputFile()
+                               .required()
+                               .store(&fnSecondaryStructure_)
+                               .defaultBasename("dssp")
+                               .description("Secondary structure for each frame"));
+    options->addOption(FileNameOption("num")
+                               .filetype(OptionFileType::Plot)
+                               .outputFile()
+                               .store(&fnCounts_)
+                               .defaultBasename("num")
+                               .description("Number of residues of each secondary structure type"));
+    options->addOption(SelectionOption("sel")
+                               .store(&sel_)
+                               .defaultSelectionText("Protein")
+                               .onlyAtoms()
+                               .onlyStatic()
+                               .description("Residues to assign secondary structure to"));
+    options->addOption(DoubleOption("cutoff").store(&cutoff_).description(
+            "CA-CA distance cutoff (nm) for hydrogen-bonded residue pairs"));
+
+    settings->setFlag(TrajectoryAnalysisSettings::efRequireTop);
+}
+
+
+void Dssp::initAnalysis(const TrajectoryAnalysisSettings& settings, const TopologyInformation& top)
+{
+    if (cutoff_ <= 0)
+    {
+        GMX_THROW(InconsistentInputError("-cutoff should be positive"));
+    }
+    nb_.setCutoff(cutoff_);
+
+    const t_atoms*      atoms       = top.atoms();
+    ArrayRef<const int> atomIndices = sel_.atomIndices();
+    for (size_t a = 0; a < atomIndices.size();)
+    {
+        const int       resind = atoms->atom[atomIndices[a]].resind;
+        BackboneResidue residue = { -1, -1, -1, -1, false, atoms->resinfo[resind].chainid };
+        int             oc1     = -1;
+        for (; a < atomIndices.size() && atoms->atom[atomIndices[a]].resind == resind; ++a)
+        {
+            const int   ai       = atomIndices[a];
+            const char* atomName = *atoms->atomname[ai];
+            if (std::strcmp(atomName, "N") == 0)
+            {
+                residue.n = ai;
+            }
+            else if (std::strcmp(atomName, "CA") == 0)
+            {
+                residue.ca = ai;
+            }
+            else if (std::strcmp(atomName, "C") == 0)
+            {
+                residue.c = ai;
+            }
+            else if (std::strcmp(atomName, "O") == 0)
+            {
+                residue.o = ai;
+            }
+            else if (std::strcmp(atomName, "OC1") == 0)
+            {
+                oc1 = ai;
+            }
+        }
+        if (residue.o < 0)
+        {
+            residue.o = oc1;
+        }
+        if (residue.n >= 0 && residue.ca >= 0 && residue.c >= 0 && residue.o >= 0)
+        {
+            residue.isProline = (std::strcmp(*atoms->resinfo[resind].name, "PRO") == 0);
+            residues_.push_back(residue);
+        }
+    }
+    if (residues_.empty())
+    {
+        GMX_THROW(InconsistentInputError(
+                formatString("Selection '%s' does not contain any residue with N, CA, C and O "
+                             "atoms",
+                             sel_.name())));
+    }
+
+    please_cite(stdout, "Kabsch1983");
+
+    counts_.setColumnCount(0, static_cast<int>(SecondaryStructureType::Count));
+    if (!fnCounts_.empty())
+    {
+        AnalysisDataPlotModulePointer plotm(new AnalysisDataPlotModule(settings.plotSettings()));
+        plotm->setFileName(fnCounts_);
+        plotm->setTitle("Number of residues per secondary structure type");
+        plotm->setXAxisIsTime();
+        plotm->setYLabel("Number of residues");
+        for (const char* name : c_secondaryStructureNames)
+        {
+            plotm->appendLegend(name);
+        }
+        counts_.addModule(plotm);
+    }
+}
+
+
+TrajectoryAnalysisModuleDataPointer Dssp::startFrames(const AnalysisDataParallelOptions& opt,
+                                                      const SelectionCollection&         selections)
+{
+    return TrajectoryAnalysisModuleDataPointer(new DsspModuleData(this, opt, selections));
+}
+
+
+void Dssp::analyzeFrame(int frnr, const t_trxframe& fr, t_pbc* pbc, TrajectoryAnalysisModuleData* pdata)
+{
+    DsspModuleData&    frameData = *static_cast<DsspModuleData*>(pdata);
+    AnalysisDataHandle dh        = pdata->dataHandle(counts_);
+
+    frameData.assigner_.assign(residues_, fr.x, pbc, &nb_, &frameData.result_, &frameData.counts_);
+
+    dh.startFrame(frnr, fr.time);
+    for (int type = 0; type < static_cast<int>(SecondaryStructureType::Count); ++type)
+    {
+        dh.setPoint(type, frameData.counts_[static_cast<SecondaryStructureType>(type)]);
+    }
+    dh.finishFrame();
+
+    std::lock_guard<std::mutex> lock(secondaryStructureMutex_);
+    if (frnr >= static_cast<int>(secondaryStructure_.size()))
+    {
+        secondaryStructure_.resize(frnr + 1);
+    }
+    secondaryStructure_[frnr] = frameData.result_;
+}
+
+
+void Dssp::finishAnalysis(int /*nframes*/) {}
+
+
+void Dssp::writeOutput()
+{
+    TextWriter writer(fnSecondaryStructure_);
+    for (const std::string& frameResult : secondaryStructure_)
+    {
+        writer.writeLine(frameResult);
+    }
+    writer.close();
+}
+
+//! \}
+
+} // namespace
+
+const char DsspInfo::name[]             = "dssp";
+const char DsspInfo::shortDescription[] = "Assign secondary structure with the DSSP algorithm";
+
+TrajectoryAnalysisModulePointer DsspInfo::create()
+{
+    return TrajectoryAnalysisModulePointer(new Dssp);
+}
+
+} // namespace analysismodules
+
+} // namespace gmx
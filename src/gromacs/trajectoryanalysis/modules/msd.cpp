@@ -44,7 +44,6 @@
 
 #include "msd.h"
 
-#include <numeric>
 #include <optional>
 
 #include "gromacs/analysisdata/analysisdata.h"
@@ -95,31 +94,41 @@ constexpr double c_1DdiffusionDimensionFactor = 2.0;
  * observations at formerly observed time differences are added to those columns. Separate time lags
  * will likely have differing total data points.
  *
+ * Only the sum and the number of the data points are stored per column, so the memory use
+ * does not grow with the number of time origins. The points are summed in the order they are
+ * added, which gives the same averages as summing stored points.
+ *
  * Data columns per tau are accessed via operator[], which always guarantees
  * a column is initialized and returns an MsdColumProxy to the column that can push data.
  */
 class MsdData
 {
 public:
-    //! Proxy to a MsdData tau column vector. Supports only push_back.
+    //! Proxy to a MsdData tau column. Supports only push_back.
     class MsdColumnProxy
     {
     public:
-        MsdColumnProxy(std::vector<double>* column) : column_(column) {}
+        MsdColumnProxy(double* sum, int64_t* count) : sum_(sum), count_(count) {}
 
-        void push_back(double value) { column_->push_back(value); }
+        void push_back(double value)
+        {
+            *sum_ += value;
+            (*count_)++;
+        }
 
     private:
-        std::vector<double>* column_;
+        double*  sum_;
+        int64_t* count_;
     };
     //! Returns a proxy to the column for the given tau index. Guarantees that the column is initialized.
     MsdColumnProxy operator[](size_t index)
     {
-        if (msds_.size() <= index)
+        if (msdSums_.size() <= index)
         {
-            msds_.resize(index + 1);
+            msdSums_.resize(index + 1, 0.0);
+            msdCounts_.resize(index + 1, 0);
         }
-        return MsdColumnProxy(&msds_[index]);
+        return MsdColumnProxy(&msdSums_[index], &msdCounts_[index]);
     }
     /*! \brief Compute per-tau MSDs averaged over all added points.
      *
@@ -131,24 +140,25 @@ public:
     [[nodiscard]] std::vector<real> averageMsds() const;
 
 private:
-    //! Results - first indexed by tau, then data points
-    std::vector<std::vector<double>> msds_;
+    //! Sums of the data points, indexed by tau
+    std::vector<double> msdSums_;
+    //! Number of data points, indexed by tau
+    std::vector<int64_t> msdCounts_;
 };
 
 
 std::vector<real> MsdData::averageMsds() const
 {
     std::vector<real> msdSums;
-    msdSums.reserve(msds_.size());
-    for (gmx::ArrayRef<const double> msdValues : msds_)
+    msdSums.reserve(msdSums_.size());
+    for (size_t i = 0; i < msdSums_.size(); i++)
     {
-        if (msdValues.empty())
+        if (msdCounts_[i] == 0)
         {
             msdSums.push_back(0.0);
             continue;
         }
-        msdSums.push_back(std::accumulate(msdValues.begin(), msdValues.end(), 0.0, std::plus<>())
-                          / msdValues.size());
+        msdSums.push_back(msdSums_[i] / msdCounts_[i]);
     }
     return msdSums;
 }
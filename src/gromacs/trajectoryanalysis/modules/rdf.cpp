@@ -104,6 +104,13 @@ enum class Normalization : int
 const EnumerationArray<Normalization, const char*> c_normalizationNames = {
     { "rdf", "number_density", "none" }
 };
+/*! \brief
+ * Maximum number of pairwise distances passed to the histogram in one point set.
+ *
+ * Batching the distances avoids notifying the data modules separately for
+ * each pair.
+ */
+const int c_pairDistanceBatchSize = 256;
 //! Whether to compute RDF wrt. surface of the reference group.
 enum class SurfaceType : int
 {
@@ -158,9 +165,10 @@ private:
     /*! \brief
      * Raw pairwise distance data from which the RDF is computed.
      *
-     * There is a data set for each selection in `sel_`, with a single
-     * column.  Each point set will contain a single pairwise distance
-     * that contributes to the RDF.
+     * There is a data set for each selection in `sel_`, with
+     * c_pairDistanceBatchSize columns.  Each point set contains up to that
+     * many pairwise distances that contribute to the RDF; unused columns
+     * are not present.
      */
     AnalysisData pairDist_;
     /*! \brief
@@ -357,7 +365,7 @@ void Rdf::initAnalysis(const TrajectoryAnalysisSettings& settings, const Topolog
     pairDist_.setDataSetCount(sel_.size());
     for (size_t i = 0; i < sel_.size(); ++i)
     {
-        pairDist_.setColumnCount(i, 1);
+        pairDist_.setColumnCount(i, c_pairDistanceBatchSize);
     }
     plotSettings_ = settings.plotSettings();
     nb_.setXYMode(bXY_);
@@ -531,6 +539,16 @@ void Rdf::analyzeFrame(int frnr, const t_trxframe& fr, t_pbc* pbc, TrajectoryAna
     for (size_t g = 0; g < sel.size(); ++g)
     {
         dh.selectDataSet(g);
+        // Adds a distance to the current batch, and passes full batches on.
+        int        batchCount  = 0;
+        const auto addDistance = [&dh, &batchCount](real r) {
+            dh.setPoint(batchCount, r);
+            if (++batchCount == c_pairDistanceBatchSize)
+            {
+                dh.finishPointSet();
+                batchCount = 0;
+            }
+        };
 
         if (bSurface)
         {
@@ -561,8 +579,7 @@ void Rdf::analyzeFrame(int frnr, const t_trxframe& fr, t_pbc* pbc, TrajectoryAna
                     // surface positions.
                     if (r2 > cut2_ && r2 <= rmax2_)
                     {
-                        dh.setPoint(0, std::sqrt(r2));
-                        dh.finishPointSet();
+                        addDistance(std::sqrt(r2));
                     }
                 }
             }
@@ -578,13 +595,14 @@ void Rdf::analyzeFrame(int frnr, const t_trxframe& fr, t_pbc* pbc, TrajectoryAna
                 const real r2 = pair.distance2();
                 if (r2 > cut2_)
                 {
-                    // TODO: Consider whether the histogramming could be done with
-                    // less overhead (after first measuring the overhead).
-                    dh.setPoint(0, std::sqrt(r2));
-                    dh.finishPointSet();
+                    addDistance(std::sqrt(r2));
                 }
             }
         }
+        if (batchCount > 0)
+        {
+            dh.finishPointSet();
+        }
         // Normalization factor for the number density (only used without
         // -surf, but does not hurt to populate otherwise).
         nh.setPoint(g + 1, sel[g].posCount() * inverseVolume);
@@ -45,6 +45,7 @@
 #include <cstring>
 
 #include <algorithm>
+#include <numeric>
 #include <vector>
 
 #include "gromacs/math/functions.h"
@@ -775,6 +776,8 @@ static void nsc_dclm_pbc(const rvec*                 coords,
     AnalysisNeighborhoodSearch nbsearch(nb->initSearch(pbc, pos));
 
     std::vector<int> wkdot(n_dot);
+    // Indices of the dots of the current atom that are not yet covered.
+    std::vector<int> uncoveredDots(n_dot);
 
     for (int i = 0; i < nat; ++i)
     {
@@ -784,6 +787,7 @@ static void nsc_dclm_pbc(const rvec*                 coords,
         AnalysisNeighborhoodPairSearch pairSearch(nbsearch.startPairSearch(coords[iat]));
         AnalysisNeighborhoodPair       pair;
         std::fill(wkdot.begin(), wkdot.end(), 1);
+        std::iota(uncoveredDots.begin(), uncoveredDots.end(), 0);
         int currDotCount = n_dot;
         while (currDotCount > 0 && pairSearch.findNextPair(&pair))
         {
@@ -805,17 +809,24 @@ static void nsc_dclm_pbc(const rvec*                 coords,
             // resulted in marking the previous dot covered would also cover
             // this dot. This presumably plays together with sorting of the
             // surface dots (done in make_unsp) to avoid some of the looping.
-            // Alternatively, we could keep a skip list here to avoid
-            // repeatedly looping over dots that have already marked as
-            // covered.
-            for (int j = 0; j < n_dot; ++j)
+            //
+            // Only the dots not yet covered are looped over, and the list of
+            // these is compacted in place, so each neighbor costs time
+            // proportional to the remaining dots instead of all dots.
+            int remainingDotCount = 0;
+            for (int k = 0; k < currDotCount; ++k)
             {
-                if (wkdot[j] && iprod(&xus[3 * j], dx) > refdot)
+                const int j = uncoveredDots[k];
+                if (iprod(&xus[3 * j], dx) > refdot)
                 {
-                    --currDotCount;
                     wkdot[j] = 0;
                 }
+                else
+                {
+                    uncoveredDots[remainingDotCount++] = j;
+                }
             }
+            currDotCount = remainingDotCount;
         }
 
         const real a = aisq * dotarea * currDotCount;
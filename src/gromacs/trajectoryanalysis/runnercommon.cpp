@@ -47,6 +47,7 @@
 #include <cstring>
 
 #include <algorithm>
+#include <future>
 #include <string>
 
 #include "gromacs/fileio/oenv.h"
@@ -89,6 +90,8 @@ public:
     void initFirstFrame();
     void initFrameIndexGroup();
     void finishTrajectory();
+    //! Starts reading the frame after \p fr into \p nextFrame_ on a separate thread.
+    void startReadingNextFrame();
 
     // From ITopologyProvider
     gmx_mtop_t* getTopology(bool required) override
@@ -131,6 +134,10 @@ public:
     bool bTrajOpen_;
     //! The current frame, or \p NULL if no frame loaded yet.
     t_trxframe* fr;
+    //! The frame read ahead of \p fr, or \p NULL if no frame was read ahead yet.
+    t_trxframe* nextFrame_;
+    //! Result of reading \p nextFrame_, valid while a read is in progress.
+    std::future<bool> nextFrameRead_;
     gmx_rmpbc_t gpbc_;
     //! Used to store the status variable from read_first_frame().
     t_trxstatus*      status_;
@@ -148,6 +155,7 @@ TrajectoryAnalysisRunnerCommon::Impl::Impl(TrajectoryAnalysisSettings* settings)
     bDeltaTimeSet_(false),
     bTrajOpen_(false),
     fr(nullptr),
+    nextFrame_(nullptr),
     gpbc_(nullptr),
     status_(nullptr),
     oenv_(nullptr)
@@ -155,18 +163,26 @@ TrajectoryAnalysisRunnerCommon::Impl::Impl(TrajectoryAnalysisSettings* settings)
 }
 
 
-TrajectoryAnalysisRunnerCommon::Impl::~Impl()
+//! Frees a frame allocated by the runner, does nothing for \p NULL.
+static void freeFrame(t_trxframe* frame)
 {
-    finishTrajectory();
-    if (fr != nullptr)
+    if (frame != nullptr)
     {
         // There doesn't seem to be a function for freeing frame data
-        sfree(fr->x);
-        sfree(fr->v);
-        sfree(fr->f);
-        sfree(fr->index);
-        sfree(fr);
+        sfree(frame->x);
+        sfree(frame->v);
+        sfree(frame->f);
+        sfree(frame->index);
+        sfree(frame);
     }
+}
+
+
+TrajectoryAnalysisRunnerCommon::Impl::~Impl()
+{
+    finishTrajectory();
+    freeFrame(fr);
+    freeFrame(nextFrame_);
     if (oenv_ != nullptr)
     {
         output_env_done(oenv_);
@@ -290,8 +306,49 @@ void TrajectoryAnalysisRunnerCommon::Impl::initFrameIndexGroup()
     std::copy(trajectoryGroup_.atomIndices().begin(), trajectoryGroup_.atomIndices().end(), fr->index);
 }
 
+void TrajectoryAnalysisRunnerCommon::Impl::startReadingNextFrame()
+{
+    if (!bTrajOpen_ || nextFrameRead_.valid())
+    {
+        return;
+    }
+    if (nextFrame_ == nullptr)
+    {
+        // The frame is set up like fr, but owns its own buffers, which are
+        // then reused by swapping the two frames after each read.
+        snew(nextFrame_, 1);
+        *nextFrame_ = *fr;
+        if (fr->x != nullptr)
+        {
+            snew(nextFrame_->x, fr->natoms);
+        }
+        if (fr->v != nullptr)
+        {
+            snew(nextFrame_->v, fr->natoms);
+        }
+        if (fr->f != nullptr)
+        {
+            snew(nextFrame_->f, fr->natoms);
+        }
+        if (fr->index != nullptr)
+        {
+            snew(nextFrame_->index, trajectoryGroup_.atomCount());
+            std::copy(fr->index, fr->index + trajectoryGroup_.atomCount(), nextFrame_->index);
+        }
+    }
+    // Reading and decoding the next frame overlaps with the analysis of fr.
+    nextFrameRead_ = std::async(
+            std::launch::async, [this]() { return read_next_frame(oenv_, status_, nextFrame_); });
+}
+
 void TrajectoryAnalysisRunnerCommon::Impl::finishTrajectory()
 {
+    if (nextFrameRead_.valid())
+    {
+        // The status can only be closed once the read has finished.
+        nextFrameRead_.wait();
+        nextFrameRead_ = std::future<bool>();
+    }
     if (bTrajOpen_)
     {
         close_trx(status_);
@@ -441,7 +498,15 @@ void TrajectoryAnalysisRunnerCommon::initFrameIndexGroup()
 bool TrajectoryAnalysisRunnerCommon::readNextFrame()
 {
     bool bContinue = false;
-    if (hasTrajectory())
+    if (impl_->nextFrameRead_.valid())
+    {
+        bContinue = impl_->nextFrameRead_.get();
+        if (bContinue)
+        {
+            std::swap(impl_->fr, impl_->nextFrame_);
+        }
+    }
+    else if (hasTrajectory())
     {
         bContinue = read_next_frame(impl_->oenv_, impl_->status_, impl_->fr);
     }
@@ -459,6 +524,7 @@ void TrajectoryAnalysisRunnerCommon::initFrame()
     {
         gmx_rmpbc_trxfr(impl_->gpbc_, impl_->fr);
     }
+    impl_->startReadingNextFrame();
 }
 
 
@@ -115,7 +115,9 @@ public:
     /*! \brief
      * Performs common initialization for the currently loaded frame.
      *
-     * Currently, makes molecules whole if requested.
+     * Currently, makes molecules whole if requested, and then starts
+     * reading the next frame on a separate thread, so that reading
+     * overlaps with the analysis of the current frame.
      */
     void initFrame();
 
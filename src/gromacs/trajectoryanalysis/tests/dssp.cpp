@@ -0,0 +1,92 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for functionality of the "dssp" trajectory analysis module.
+ *
+ * \ingroup module_trajectoryanalysis
+ */
+#include "gmxpre.h"
+
+#include "gromacs/trajectoryanalysis/modules/dssp.h"
+
+#include <gtest/gtest.h>
+
+#include "testutils/cmdlinetest.h"
+#include "testutils/textblockmatchers.h"
+#include "testutils/xvgtest.h"
+
+#include "moduletest.h"
+
+namespace
+{
+
+using gmx::test::CommandLine;
+using gmx::test::ExactTextMatch;
+using gmx::test::XvgMatch;
+
+/********************************************************************
+ * Tests for gmx::analysismodules::Dssp.
+ */
+
+//! Test fixture for the `dssp` analysis module.
+typedef gmx::test::TrajectoryAnalysisModuleTestFixture<gmx::analysismodules::DsspInfo> DsspModuleTest;
+
+TEST_F(DsspModuleTest, AssignsSecondaryStructure)
+{
+    const char* const cmdline[] = { "dssp" };
+    setTopology("lysozyme.pdb");
+    setOutputFile("-o", ".dat", ExactTextMatch());
+    setOutputFile("-num", ".xvg", XvgMatch());
+    runTest(CommandLine(cmdline));
+}
+
+TEST_F(DsspModuleTest, HandlesSelectedResidues)
+{
+    const char* const cmdline[] = { "dssp", "-sel", "resnr 3 to 8" };
+    setTopology("lysozyme.pdb");
+    setOutputFile("-o", ".dat", ExactTextMatch());
+    runTest(CommandLine(cmdline));
+}
+
+TEST_F(DsspModuleTest, HandlesChainBreaks)
+{
+    const char* const cmdline[] = { "dssp", "-sel", "resnr 1 to 4 6 to 10" };
+    setTopology("lysozyme.pdb");
+    setOutputFile("-o", ".dat", ExactTextMatch());
+    runTest(CommandLine(cmdline));
+}
+
+} // namespace
@@ -99,8 +99,8 @@ public:
             doBool(&(values[i]));
         }
     }
-    // Char, UChar and RVec have vector specializations that can be
-    // used instead of the default looping.
+    // Char, UChar, Int, Int64, Float, Double and RVec have vector
+    // specializations that can be used instead of the default looping.
     virtual void doCharArray(char* values, int elements)
     {
         for (int i = 0; i < elements; i++)
@@ -122,7 +122,7 @@ public:
             doUShort(&(values[i]));
         }
     }
-    void doIntArray(int* values, int elements)
+    virtual void doIntArray(int* values, int elements)
     {
         for (int i = 0; i < elements; i++)
         {
@@ -136,21 +136,21 @@ public:
             doInt32(&(values[i]));
         }
     }
-    void doInt64Array(int64_t* values, int elements)
+    virtual void doInt64Array(int64_t* values, int elements)
     {
         for (int i = 0; i < elements; i++)
         {
             doInt64(&(values[i]));
         }
     }
-    void doFloatArray(float* values, int elements)
+    virtual void doFloatArray(float* values, int elements)
     {
         for (int i = 0; i < elements; i++)
         {
             doFloat(&(values[i]));
         }
     }
-    void doDoubleArray(double* values, int elements)
+    virtual void doDoubleArray(double* values, int elements)
     {
         for (int i = 0; i < elements; i++)
         {
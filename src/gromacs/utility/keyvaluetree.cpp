@@ -58,6 +58,52 @@ std::vector<std::string> splitPathElements(const std::string& path)
     return splitDelimitedString(path.substr(1), '/');
 }
 
+//! Whether \p value holds a packed numeric array of type \p T.
+template<typename T>
+bool isPackedArrayOfType(const KeyValueTreeValue& value)
+{
+    return value.isType<std::vector<T>>();
+}
+
+//! Whether \p value holds a packed numeric array of any supported type.
+bool isPackedArray(const KeyValueTreeValue& value)
+{
+    return isPackedArrayOfType<int>(value) || isPackedArrayOfType<int64_t>(value)
+           || isPackedArrayOfType<float>(value) || isPackedArrayOfType<double>(value);
+}
+
+//! Helper function to format the elements of a packed numeric array.
+template<typename T>
+std::string packedArrayOfTypeToString(const KeyValueTreeValue& value)
+{
+    std::string result;
+    for (const T& elem : value.cast<std::vector<T>>())
+    {
+        result += " ";
+        result += toString(elem);
+    }
+    return result;
+}
+
+//! Formats the elements of a packed numeric array, separated by spaces.
+std::string packedArrayToString(const KeyValueTreeValue& value)
+{
+    if (isPackedArrayOfType<int>(value))
+    {
+        return packedArrayOfTypeToString<int>(value);
+    }
+    else if (isPackedArrayOfType<int64_t>(value))
+    {
+        return packedArrayOfTypeToString<int64_t>(value);
+    }
+    else if (isPackedArrayOfType<float>(value))
+    {
+        return packedArrayOfTypeToString<float>(value);
+    }
+    GMX_RELEASE_ASSERT(isPackedArrayOfType<double>(value), "Unknown packed array type");
+    return packedArrayOfTypeToString<double>(value);
+}
+
 } // namespace
 
 /********************************************************************
@@ -134,7 +180,13 @@ void dumpKeyValueTree(TextWriter* writer, const KeyValueTreeObject& tree)
             int indent = writer->wrapperSettings().indent();
             writer->writeString(formatString("%*s", -(33 - indent), prop.key().c_str()));
             writer->writeString(" = ");
-            if (value.isArray())
+            if (isPackedArray(value))
+            {
+                writer->writeString("[");
+                writer->writeString(packedArrayToString(value));
+                writer->writeString(" ]");
+            }
+            else if (value.isArray())
             {
                 writer->writeString("[");
                 for (const auto& elem : value.asArray().values())
@@ -211,6 +263,16 @@ private:
             {
                 GMX_RELEASE_ASSERT(false, "Array comparison not implemented");
             }
+            else if (isPackedArray(value1))
+            {
+                if (!arePackedArraysOfSameTypeEqual(value1, value2))
+                {
+                    writer_->writeString(currentPath_.toString());
+                    writer_->writeLine(formatString(" ([%s ] - [%s ])",
+                                                    packedArrayToString(value1).c_str(),
+                                                    packedArrayToString(value2).c_str()));
+                }
+            }
             else if (!areSimpleValuesOfSameTypeEqual(value1, value2))
             {
                 writer_->writeString(currentPath_.toString());
@@ -237,6 +299,56 @@ private:
         }
     }
 
+    template<typename T>
+    bool arePackedArraysOfTypeEqual(const KeyValueTreeValue& value1,
+                                    const KeyValueTreeValue& value2) const
+    {
+        const auto& values1 = value1.cast<std::vector<T>>();
+        const auto& values2 = value2.cast<std::vector<T>>();
+        if (values1.size() != values2.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < values1.size(); ++i)
+        {
+            if (!areElementsEqual(values1[i], values2[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool areElementsEqual(int value1, int value2) const { return value1 == value2; }
+    bool areElementsEqual(int64_t value1, int64_t value2) const { return value1 == value2; }
+    bool areElementsEqual(float value1, float value2) const
+    {
+        return equal_float(value1, value2, ftol_, abstol_);
+    }
+    bool areElementsEqual(double value1, double value2) const
+    {
+        return equal_double(value1, value2, ftol_, abstol_);
+    }
+
+    bool arePackedArraysOfSameTypeEqual(const KeyValueTreeValue& value1,
+                                        const KeyValueTreeValue& value2) const
+    {
+        GMX_ASSERT(value1.type() == value2.type(), "Caller should ensure that types are equal");
+        if (isPackedArrayOfType<int>(value1))
+        {
+            return arePackedArraysOfTypeEqual<int>(value1, value2);
+        }
+        else if (isPackedArrayOfType<int64_t>(value1))
+        {
+            return arePackedArraysOfTypeEqual<int64_t>(value1, value2);
+        }
+        else if (isPackedArrayOfType<float>(value1))
+        {
+            return arePackedArraysOfTypeEqual<float>(value1, value2);
+        }
+        return arePackedArraysOfTypeEqual<double>(value1, value2);
+    }
+
     bool areSimpleValuesOfSameTypeEqual(const KeyValueTreeValue& value1, const KeyValueTreeValue& value2) const
     {
         GMX_ASSERT(value1.type() == value2.type(), "Caller should ensure that types are equal");
@@ -295,7 +407,7 @@ private:
 
     static std::string formatValueForMissingMessage(const KeyValueTreeValue& value)
     {
-        if (value.isObject() || value.isArray())
+        if (value.isObject() || value.isArray() || isPackedArray(value))
         {
             return "present";
         }
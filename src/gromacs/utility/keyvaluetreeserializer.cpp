@@ -37,6 +37,7 @@
 #include "keyvaluetreeserializer.h"
 
 #include <mutex>
+#include <vector>
 
 #include "gromacs/utility/iserializer.h"
 #include "gromacs/utility/keyvaluetree.h"
@@ -218,6 +219,67 @@ struct SerializationTraits<double>
     }
 };
 
+/*! \brief Serialization of packed numeric arrays.
+ *
+ * A vector of values is stored in a single tree value and written as one
+ * bulk array, instead of as a KeyValueTreeArray that needs a separate tree
+ * value (and type tag) per element.
+ */
+template<typename T>
+struct PackedArraySerializationTraits
+{
+    static void doArray(ISerializer* serializer, int* values, int count)
+    {
+        serializer->doIntArray(values, count);
+    }
+    static void doArray(ISerializer* serializer, int64_t* values, int count)
+    {
+        serializer->doInt64Array(values, count);
+    }
+    static void doArray(ISerializer* serializer, float* values, int count)
+    {
+        serializer->doFloatArray(values, count);
+    }
+    static void doArray(ISerializer* serializer, double* values, int count)
+    {
+        serializer->doDoubleArray(values, count);
+    }
+    static void serialize(const std::vector<T>& values, ISerializer* serializer)
+    {
+        int count = values.size();
+        serializer->doInt(&count);
+        doArray(serializer, const_cast<T*>(values.data()), count);
+    }
+    static void deserialize(KeyValueTreeValueBuilder* builder, ISerializer* serializer)
+    {
+        int count = 0;
+        serializer->doInt(&count);
+        std::vector<T> values(count);
+        doArray(serializer, values.data(), count);
+        builder->setAnyValue(Any::create<std::vector<T>>(std::move(values)));
+    }
+};
+
+template<>
+struct SerializationTraits<std::vector<int>> : public PackedArraySerializationTraits<int>
+{
+};
+
+template<>
+struct SerializationTraits<std::vector<int64_t>> : public PackedArraySerializationTraits<int64_t>
+{
+};
+
+template<>
+struct SerializationTraits<std::vector<float>> : public PackedArraySerializationTraits<float>
+{
+};
+
+template<>
+struct SerializationTraits<std::vector<double>> : public PackedArraySerializationTraits<double>
+{
+};
+
 //! Helper function for serializing values of a certain type.
 template<typename T>
 void serializeValueType(const KeyValueTreeValue& value, ISerializer* serializer)
@@ -250,6 +312,10 @@ void ValueSerializer::initSerializers()
         SERIALIZER('l', int64_t),
         SERIALIZER('f', float),
         SERIALIZER('d', double),
+        SERIALIZER('I', std::vector<int>),
+        SERIALIZER('L', std::vector<int64_t>),
+        SERIALIZER('F', std::vector<float>),
+        SERIALIZER('D', std::vector<double>),
     };
     for (const auto& item : s_serializers)
     {
@@ -0,0 +1,235 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \file
+ * \brief
+ * Implements the benchmarks of the bonded kernels.
+ *
+ * All flavors of the kernels of the common bonded types are timed on a
+ * long helical chain of atoms, so that all interactions have the same,
+ * non-trivial geometry. With multiple threads, the interactions are
+ * divided over the threads in contiguous blocks and each thread
+ * accumulates into its own force buffer, as in mdrun. The reduction
+ * of the buffers is not included.
+ */
+
+#include "gmxpre.h"
+
+#include <cmath>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gromacs/listed_forces/bonded.h"
+#include "gromacs/math/paddedvector.h"
+#include "gromacs/math/units.h"
+#include "gromacs/math/vectypes.h"
+#include "gromacs/pbcutil/ishift.h"
+#include "gromacs/simd/simd.h"
+#include "gromacs/topology/idef.h"
+#include "gromacs/topology/ifunc.h"
+#include "gromacs/utility/alignedallocator.h"
+#include "gromacs/utility/enumerationhelpers.h"
+#include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/real.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+namespace microbenchmark
+{
+namespace
+{
+
+//! The numbers of interactions
+const std::vector<int64_t> c_bondedSizes = { 1000, 100000 };
+
+//! Short names of the kernel flavors, for use in the benchmark names
+const EnumerationArray<BondedKernelFlavor, const char*> c_flavorNames = {
+    { "simd", "nosimd", "energy_virial", "energy" }
+};
+
+//! The data of a bonded benchmark
+struct BondedData
+{
+    //! The interaction type
+    int ftype;
+    //! The interactions, as type followed by the atom indices
+    std::vector<t_iatom> iatoms;
+    //! The parameters, only one set
+    t_iparams iparams;
+    //! The coordinates
+    PaddedVector<RVec> x;
+    //! The force buffer for each thread, in rvec4 layout
+    std::vector<std::vector<real, AlignedAllocator<real>>> forces;
+    //! The shift-force buffer for each thread
+    std::vector<std::vector<RVec>> shiftForces;
+};
+
+//! Returns the parameters of the interactions of type \p ftype
+t_iparams defaultParameters(int ftype)
+{
+    t_iparams iparams = {};
+    switch (ftype)
+    {
+        case F_BONDS:
+            iparams.harmonic = { 0.16, 3e5, 0.16, 3e5 };
+            break;
+        case F_ANGLES:
+            iparams.harmonic = { 100, 400, 100, 400 };
+            break;
+        case F_PDIHS:
+            iparams.pdihs = { 0, 5, 3, 0, 5 };
+            break;
+        case F_RBDIHS:
+            for (int i = 0; i < NR_RBDIHS; i++)
+            {
+                iparams.rbdihs.rbcA[i] = 1 + i;
+                iparams.rbdihs.rbcB[i] = 1 + i;
+            }
+            break;
+        default: GMX_RELEASE_ASSERT(false, "Type not supported by the benchmark");
+    }
+    return iparams;
+}
+
+//! Sets up a chain with \p numInteractions interactions of type \p ftype
+std::shared_ptr<BondedData> makeBondedData(int ftype, int numInteractions, int numThreads)
+{
+    auto data   = std::make_shared<BondedData>();
+    data->ftype = ftype;
+
+    const int numAtomsPerInteraction = NRAL(ftype);
+    const int numAtoms               = numInteractions + numAtomsPerInteraction - 1;
+    for (int i = 0; i < numInteractions; i++)
+    {
+        data->iatoms.push_back(0);
+        for (int a = 0; a < numAtomsPerInteraction; a++)
+        {
+            data->iatoms.push_back(i + a);
+        }
+    }
+    data->iparams = defaultParameters(ftype);
+
+    // A helix with bond lengths of 0.16 nm
+    const real radius       = 0.1;
+    const real risePerAtom  = 0.05;
+    const real anglePerAtom = 100 * c_deg2Rad;
+    data->x.resizeWithPadding(numAtoms);
+    for (int i = 0; i < numAtoms; i++)
+    {
+        data->x[i] = { radius * std::cos(i * anglePerAtom),
+                       radius * std::sin(i * anglePerAtom),
+                       i * risePerAtom };
+    }
+
+    data->forces.resize(numThreads);
+    data->shiftForces.resize(numThreads);
+    for (int t = 0; t < numThreads; t++)
+    {
+        // Padding for the SIMD loads and stores of the last atoms
+        data->forces[t].resize(4 * (numAtoms + GMX_REAL_MAX_SIMD_WIDTH));
+        data->shiftForces[t].resize(c_numShiftVectors);
+    }
+
+    return data;
+}
+
+//! Returns a kernel computing all interactions of \p ftype with \p flavor
+BenchmarkKernel makeBondedKernel(const BenchmarkArguments& arguments,
+                                 int                       ftype,
+                                 BondedKernelFlavor        flavor)
+{
+    std::shared_ptr<BondedData> data = makeBondedData(ftype, arguments.size, arguments.numThreads);
+
+    BenchmarkKernel kernel;
+    kernel.run = [data, flavor, numThreads = arguments.numThreads]() {
+        const int stride          = 1 + NRAL(data->ftype);
+        const int numInteractions = data->iatoms.size() / stride;
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+        for (int t = 0; t < numThreads; t++)
+        {
+            const int begin     = (numInteractions * t) / numThreads;
+            const int end       = (numInteractions * (t + 1)) / numThreads;
+            real      dvdlambda = 0;
+            calculateSimpleBond(data->ftype,
+                                (end - begin) * stride,
+                                data->iatoms.data() + begin * stride,
+                                &data->iparams,
+                                as_rvec_array(data->x.data()),
+                                reinterpret_cast<rvec4*>(data->forces[t].data()),
+                                as_rvec_array(data->shiftForces[t].data()),
+                                nullptr,
+                                0,
+                                &dvdlambda,
+                                {},
+                                nullptr,
+                                nullptr,
+                                nullptr,
+                                nullptr,
+                                flavor);
+        }
+    };
+    kernel.itemsPerRun = arguments.size;
+
+    return kernel;
+}
+
+} // namespace
+
+void registerBondedBenchmarks(BenchmarkRegistry* registry)
+{
+    const std::vector<std::pair<int, std::string>> types = {
+        { F_BONDS, "bonds" }, { F_ANGLES, "angles" }, { F_PDIHS, "pdihs" }, { F_RBDIHS, "rbdihs" }
+    };
+    for (const auto& type : types)
+    {
+        for (const auto flavor : keysOf(c_flavorNames))
+        {
+            const int ftype = type.first;
+            registry->add("bonded_" + type.second + "_" + c_flavorNames[flavor],
+                          c_bondedSizes,
+                          true,
+                          [ftype, flavor](const BenchmarkArguments& arguments) {
+                              return makeBondedKernel(arguments, ftype, flavor);
+                          });
+        }
+    }
+}
+
+} // namespace microbenchmark
+} // namespace gmx
@@ -0,0 +1,384 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \file
+ * \brief
+ * Implements the benchmarks of LINCS and SETTLE.
+ *
+ * The constraints are applied to a lattice of molecules. After the
+ * first call the updated coordinates satisfy the constraints, but
+ * both algorithms do the same amount of work for every call, so the
+ * coordinates do not need to be reset between calls.
+ */
+
+#include "gmxpre.h"
+
+#include <cmath>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gromacs/gmxlib/nrnb.h"
+#include "gromacs/math/paddedvector.h"
+#include "gromacs/math/vectypes.h"
+#include "gromacs/mdlib/constr.h"
+#include "gromacs/mdlib/gmx_omp_nthreads.h"
+#include "gromacs/mdlib/lincs.h"
+#include "gromacs/mdlib/settle.h"
+#include "gromacs/mdrunutility/multisim.h"
+#include "gromacs/mdtypes/commrec.h"
+#include "gromacs/mdtypes/inputrec.h"
+#include "gromacs/topology/idef.h"
+#include "gromacs/topology/ifunc.h"
+#include "gromacs/topology/topology.h"
+#include "gromacs/utility/fatalerror.h"
+#include "gromacs/utility/gmxmpi.h"
+#include "gromacs/utility/listoflists.h"
+#include "gromacs/utility/real.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+namespace microbenchmark
+{
+namespace
+{
+
+//! The numbers of molecules
+const std::vector<int64_t> c_constraintSizes = { 1000, 100000 };
+
+//! The time step, used for the velocity correction
+constexpr real c_timeStep = 0.002;
+
+//! Returns the position of molecule \p index on a cubic lattice of \p numMolecules molecules
+RVec latticePosition(int index, int numMolecules, real spacing)
+{
+    const int numPerDim = static_cast<int>(std::ceil(std::cbrt(numMolecules)));
+    return { (index % numPerDim) * spacing,
+             ((index / numPerDim) % numPerDim) * spacing,
+             (index / (numPerDim * numPerDim)) * spacing };
+}
+
+//! Displaces \p x as an unconstrained update would do
+void perturbCoordinates(ArrayRef<RVec> x)
+{
+    const real deltas[] = { 0.01, -0.01, 0.02, -0.02 };
+    int        i        = 0;
+    for (RVec& xi : x)
+    {
+        for (int d = 0; d < DIM; d++)
+        {
+            xi[d] += deltas[i % 4];
+            i++;
+        }
+    }
+}
+
+//! The data of the SETTLE benchmark
+struct SettleBenchData
+{
+    //! The topology with one water molecule type
+    gmx_mtop_t mtop;
+    //! The local topology
+    std::unique_ptr<InteractionDefinitions> idef;
+    //! The atom masses
+    std::vector<real> masses;
+    //! The inverse atom masses
+    std::vector<real> inverseMasses;
+    //! The reference coordinates
+    PaddedVector<RVec> x;
+    //! The coordinates to constrain
+    PaddedVector<RVec> xPrime;
+    //! The SETTLE setup
+    std::unique_ptr<SettleData> settled;
+};
+
+//! Sets up \p numWaters rigid water molecules
+std::shared_ptr<SettleBenchData> makeSettleData(int numWaters)
+{
+    const real dOH          = 0.09572;
+    const real dHH          = 0.15139;
+    const real oxygenMass   = 15.9994;
+    const real hydrogenMass = 1.008;
+
+    auto data = std::make_shared<SettleBenchData>();
+
+    t_iparams iparams;
+    iparams.settle.doh = dOH;
+    iparams.settle.dhh = dHH;
+    data->mtop.ffparams.iparams.push_back(iparams);
+    data->mtop.moltype.resize(1);
+    data->mtop.molblock.resize(1);
+    data->mtop.molblock[0].type = 0;
+    data->mtop.molblock[0].nmol = 1;
+    std::vector<int>& iatoms    = data->mtop.moltype[0].ilist[F_SETTLE].iatoms;
+    for (int i = 0; i < numWaters; i++)
+    {
+        iatoms.insert(iatoms.end(), { 0, 3 * i, 3 * i + 1, 3 * i + 2 });
+    }
+    data->idef = std::make_unique<InteractionDefinitions>(data->mtop.ffparams);
+    data->idef->il[F_SETTLE].iatoms = iatoms;
+
+    const int numAtoms = 3 * numWaters;
+    data->x.resizeWithPadding(numAtoms);
+    const real height = std::sqrt(dOH * dOH - 0.25 * dHH * dHH);
+    for (int i = 0; i < numWaters; i++)
+    {
+        const RVec oxygen = latticePosition(i, numWaters, 0.31);
+        data->x[3 * i]     = oxygen;
+        data->x[3 * i + 1] = oxygen + RVec(0.5 * dHH, height, 0);
+        data->x[3 * i + 2] = oxygen + RVec(-0.5 * dHH, height, 0);
+        data->masses.insert(data->masses.end(), { oxygenMass, hydrogenMass, hydrogenMass });
+    }
+    for (real mass : data->masses)
+    {
+        data->inverseMasses.push_back(1 / mass);
+    }
+    data->xPrime = data->x;
+    perturbCoordinates(data->xPrime);
+
+    data->settled = std::make_unique<SettleData>(data->mtop);
+    data->settled->setConstraints(
+            data->idef->il[F_SETTLE], numAtoms, data->masses, data->inverseMasses);
+
+    return data;
+}
+
+//! Returns a kernel applying SETTLE to all water molecules
+BenchmarkKernel makeSettleKernel(const BenchmarkArguments& arguments)
+{
+    std::shared_ptr<SettleBenchData> data = makeSettleData(arguments.size);
+
+    BenchmarkKernel kernel;
+    kernel.run = [data, numThreads = arguments.numThreads]() {
+        bool errorHasOccurred = false;
+#pragma omp parallel for num_threads(numThreads) schedule(static) reduction(|| : errorHasOccurred)
+        for (int th = 0; th < numThreads; th++)
+        {
+            tensor virial      = { { 0 } };
+            bool   threadError = false;
+            csettle(*data->settled,
+                    numThreads,
+                    th,
+                    nullptr,
+                    data->x.arrayRefWithPadding(),
+                    data->xPrime.arrayRefWithPadding(),
+                    1 / c_timeStep,
+                    ArrayRefWithPadding<RVec>(),
+                    false,
+                    virial,
+                    &threadError);
+            errorHasOccurred = errorHasOccurred || threadError;
+        }
+        GMX_RELEASE_ASSERT(!errorHasOccurred, "SETTLE should not fail in the benchmark");
+    };
+    kernel.itemsPerRun = arguments.size;
+    // Each molecule reads the reference and updated and writes the updated coordinates
+    kernel.bytesPerRun = arguments.size * 3 * 3 * sizeof(RVec);
+
+    return kernel;
+}
+
+//! The number of atoms in the chain molecules for LINCS
+constexpr int c_chainLength = 4;
+
+//! The data of the LINCS benchmark
+struct LincsBenchData
+{
+    ~LincsBenchData()
+    {
+        if (lincs)
+        {
+            done_lincs(lincs);
+        }
+    }
+
+    //! The topology with one chain molecule type
+    gmx_mtop_t mtop;
+    //! The local topology
+    std::unique_ptr<InteractionDefinitions> idef;
+    //! The inverse atom masses
+    std::vector<real> inverseMasses;
+    //! The reference coordinates
+    PaddedVector<RVec> x;
+    //! The coordinates to constrain
+    PaddedVector<RVec> xPrime;
+    //! The input record with the LINCS settings
+    t_inputrec ir;
+    //! A single-rank communication record
+    t_commrec cr;
+    //! A single-simulation record
+    gmx_multisim_t ms{ 1, 0, MPI_COMM_NULL, MPI_COMM_NULL };
+    //! The flop counters
+    t_nrnb nrnb;
+    //! The LINCS setup
+    Lincs* lincs = nullptr;
+};
+
+//! Sets up \p numMolecules chains of united atoms with constrained bonds and \p numThreads tasks
+std::shared_ptr<LincsBenchData> makeLincsData(int numMolecules, int numThreads)
+{
+    const real bondLength = 0.154;
+    const real halfAngle  = 0.5 * std::acos(-1.0 / 3.0);
+    const real mass       = 14.027;
+
+    auto data = std::make_shared<LincsBenchData>();
+
+    data->ir.eI             = IntegrationAlgorithm::MD;
+    data->ir.efep           = FreeEnergyPerturbationType::No;
+    data->ir.delta_t        = c_timeStep;
+    data->ir.nLincsIter     = 1;
+    data->ir.nProjOrder     = 4;
+    data->ir.LincsWarnAngle = 30;
+
+    data->cr.nnodes = 1;
+    data->cr.dd     = nullptr;
+
+    t_iparams iparams;
+    iparams.constr.dA = bondLength;
+    iparams.constr.dB = bondLength;
+    data->mtop.ffparams.iparams.push_back(iparams);
+
+    gmx_moltype_t molType;
+    molType.atoms.nr = c_chainLength;
+    for (int a = 0; a + 1 < c_chainLength; a++)
+    {
+        std::vector<int>& molIatoms = molType.ilist[F_CONSTR].iatoms;
+        molIatoms.insert(molIatoms.end(), { 0, a, a + 1 });
+    }
+    data->mtop.moltype.push_back(molType);
+    gmx_molblock_t molBlock;
+    molBlock.type = 0;
+    molBlock.nmol = numMolecules;
+    data->mtop.molblock.push_back(molBlock);
+    data->mtop.natoms                      = numMolecules * c_chainLength;
+    data->mtop.bIntermolecularInteractions = false;
+
+    data->idef = std::make_unique<InteractionDefinitions>(data->mtop.ffparams);
+    std::vector<int>& iatoms   = data->idef->il[F_CONSTR].iatoms;
+    const int         numAtoms = data->mtop.natoms;
+    data->x.resizeWithPadding(numAtoms);
+    for (int m = 0; m < numMolecules; m++)
+    {
+        // Zig-zag chains with tetrahedral angles
+        const RVec origin = latticePosition(m, numMolecules, 0.6);
+        for (int a = 0; a < c_chainLength; a++)
+        {
+            const int atom = m * c_chainLength + a;
+            data->x[atom]  = origin
+                            + RVec(a * bondLength * std::sin(halfAngle),
+                                   (a % 2) * bondLength * std::cos(halfAngle),
+                                   0);
+            if (a + 1 < c_chainLength)
+            {
+                iatoms.insert(iatoms.end(), { 0, atom, atom + 1 });
+            }
+        }
+    }
+    data->inverseMasses.assign(numAtoms, 1 / mass);
+    data->xPrime = data->x;
+    perturbCoordinates(data->xPrime);
+
+    std::vector<ListOfLists<int>> atomToConstraints;
+    atomToConstraints.push_back(make_at2con(data->mtop.moltype[0],
+                                            data->mtop.ffparams.iparams,
+                                            flexibleConstraintTreatment(true)));
+    // LINCS divides the constraints over as many tasks as there are threads
+    gmx_omp_nthreads_set(ModuleMultiThread::Lincs, numThreads);
+    data->lincs = init_lincs(nullptr,
+                             data->mtop,
+                             0,
+                             atomToConstraints,
+                             false,
+                             data->ir.nLincsIter,
+                             data->ir.nProjOrder,
+                             nullptr);
+    set_lincs(*data->idef, numAtoms, data->inverseMasses, 0, true, &data->cr, data->lincs);
+
+    return data;
+}
+
+//! Returns a kernel applying LINCS to all chain molecules
+BenchmarkKernel makeLincsKernel(const BenchmarkArguments& arguments)
+{
+    std::shared_ptr<LincsBenchData> data = makeLincsData(arguments.size, arguments.numThreads);
+
+    BenchmarkKernel kernel;
+    kernel.run = [data]() {
+        matrix box         = { { 0 } };
+        tensor virial      = { { 0 } };
+        real   dvdlambda   = 0;
+        int    numWarnings = 0;
+        bool   success     = constrain_lincs(false,
+                                             data->ir,
+                                             0,
+                                             data->lincs,
+                                             data->inverseMasses,
+                                             &data->cr,
+                                             &data->ms,
+                                             data->x.arrayRefWithPadding(),
+                                             data->xPrime.arrayRefWithPadding(),
+                                             {},
+                                             box,
+                                             nullptr,
+                                             false,
+                                             0,
+                                             &dvdlambda,
+                                             1 / c_timeStep,
+                                             {},
+                                             false,
+                                             virial,
+                                             ConstraintVariable::Positions,
+                                             &data->nrnb,
+                                             0,
+                                             &numWarnings);
+        GMX_RELEASE_ASSERT(success && numWarnings == 0, "LINCS should not fail in the benchmark");
+    };
+    kernel.itemsPerRun = arguments.size * (c_chainLength - 1);
+
+    return kernel;
+}
+
+} // namespace
+
+void registerConstraintBenchmarks(BenchmarkRegistry* registry)
+{
+    registry->add("settle", c_constraintSizes, true, makeSettleKernel);
+    registry->add("lincs", c_constraintSizes, true, makeLincsKernel);
+}
+
+} // namespace microbenchmark
+} // namespace gmx
@@ -0,0 +1,158 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \file
+ * \brief
+ * Implements the benchmarks of HashedMap.
+ *
+ * The keys mimic the global atom indices of a domain in domain
+ * decomposition: runs of consecutive indices with gaps in between,
+ * taken from a system that is ten times larger than the domain.
+ */
+
+#include "gmxpre.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gromacs/domdec/hashedmap.h"
+#include "gromacs/random/threefry.h"
+#include "gromacs/random/uniformintdistribution.h"
+#include "gromacs/utility/gmxassert.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+namespace microbenchmark
+{
+namespace
+{
+
+//! The numbers of keys
+const std::vector<int64_t> c_hashedMapSizes = { 1000, 100000, 1000000 };
+
+//! The keys and the map of a benchmark
+struct HashedMapBenchData
+{
+    //! Constructs the map with an estimate of \p numKeys elements
+    explicit HashedMapBenchData(int numKeys) : map(numKeys) {}
+
+    //! The keys to insert or look up
+    std::vector<int> keys;
+    //! The map from the keys to their index in \p keys
+    HashedMap<int> map;
+};
+
+//! Returns the map data with \p numKeys keys, inserted into the map when \p insert is true
+std::shared_ptr<HashedMapBenchData> makeHashedMapData(int numKeys, bool insert)
+{
+    auto data = std::make_shared<HashedMapBenchData>(numKeys);
+
+    // On average 10 consecutive keys, followed by a gap of on average 90 keys
+    DefaultRandomEngine         rng(12345, RandomDomain::Other);
+    UniformIntDistribution<int> runLength(1, 19);
+    UniformIntDistribution<int> gapLength(0, 180);
+    int                         key = 0;
+    while (static_cast<int>(data->keys.size()) < numKeys)
+    {
+        const int length = runLength(rng);
+        for (int i = 0; i < length && static_cast<int>(data->keys.size()) < numKeys; i++)
+        {
+            data->keys.push_back(key++);
+        }
+        key += gapLength(rng);
+    }
+
+    if (insert)
+    {
+        for (int i = 0; i < numKeys; i++)
+        {
+            data->map.insert(data->keys[i], i);
+        }
+    }
+
+    return data;
+}
+
+//! Returns a kernel clearing the map and inserting all keys, as the DD repartitioning does
+BenchmarkKernel makeInsertKernel(const BenchmarkArguments& arguments)
+{
+    std::shared_ptr<HashedMapBenchData> data = makeHashedMapData(arguments.size, false);
+
+    BenchmarkKernel kernel;
+    kernel.run = [data]() {
+        data->map.clear();
+        const int numKeys = data->keys.size();
+        for (int i = 0; i < numKeys; i++)
+        {
+            data->map.insert(data->keys[i], i);
+        }
+    };
+    kernel.itemsPerRun = arguments.size;
+
+    return kernel;
+}
+
+//! Returns a kernel looking up all keys
+BenchmarkKernel makeFindKernel(const BenchmarkArguments& arguments)
+{
+    std::shared_ptr<HashedMapBenchData> data = makeHashedMapData(arguments.size, true);
+
+    BenchmarkKernel kernel;
+    kernel.run = [data]() {
+        // Checking the results avoids that the lookups are optimized away
+        int numFound = 0;
+        for (const int key : data->keys)
+        {
+            numFound += (data->map.find(key) != nullptr ? 1 : 0);
+        }
+        GMX_RELEASE_ASSERT(numFound == data->map.size(), "All keys should be present");
+    };
+    kernel.itemsPerRun = arguments.size;
+
+    return kernel;
+}
+
+} // namespace
+
+void registerHashedMapBenchmarks(BenchmarkRegistry* registry)
+{
+    registry->add("hashedmap_insert", c_hashedMapSizes, false, makeInsertKernel);
+    registry->add("hashedmap_find", c_hashedMapSizes, false, makeFindKernel);
+}
+
+} // namespace microbenchmark
+} // namespace gmx
@@ -0,0 +1,372 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \file
+ * \brief
+ * Implements the microbenchmark harness.
+ */
+
+#include "gmxpre.h"
+
+#include "microbenchmark.h"
+
+#include "config.h"
+
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <regex>
+#include <thread>
+#include <utility>
+
+#include "gromacs/simd/simd.h"
+#include "gromacs/utility/baseversion.h"
+#include "gromacs/utility/fatalerror.h"
+#include "gromacs/utility/stringutil.h"
+#include "gromacs/utility/sysinfo.h"
+
+namespace gmx
+{
+namespace microbenchmark
+{
+
+void BenchmarkRegistry::add(const std::string&   name,
+                            std::vector<int64_t> sizes,
+                            bool                 isMultiThreaded,
+                            BenchmarkFactory     factory)
+{
+    benchmarks_.push_back({ name, std::move(sizes), isMultiThreaded, std::move(factory) });
+}
+
+namespace
+{
+
+//! The clock used for the wall-clock timings
+using Clock = std::chrono::steady_clock;
+
+//! The wall-clock and CPU time of a number of calls of a kernel
+struct KernelTiming
+{
+    //! The wall-clock time in seconds
+    double seconds;
+    //! The CPU time of the process in seconds, summed over all threads
+    double cpuSeconds;
+};
+
+//! Returns the time taken by \p numCalls calls of \p kernel
+KernelTiming timeKernel(const BenchmarkKernel& kernel, int64_t numCalls)
+{
+    const std::clock_t cpuStart = std::clock();
+    const auto         start    = Clock::now();
+    for (int64_t i = 0; i < numCalls; i++)
+    {
+        kernel.run();
+    }
+    const auto         end    = Clock::now();
+    const std::clock_t cpuEnd = std::clock();
+
+    return { std::chrono::duration<double>(end - start).count(),
+             static_cast<double>(cpuEnd - cpuStart) / CLOCKS_PER_SEC };
+}
+
+/*! \brief Returns the number of calls of \p kernel that take at least \p minTime seconds
+ *
+ * As in Google Benchmark, the number of calls is increased geometrically,
+ * aiming at 40% more than the minimum time to avoid another round.
+ * The first rounds also warm up the caches and the OpenMP thread pool.
+ */
+int64_t determineNumCalls(const BenchmarkKernel& kernel, double minTime)
+{
+    int64_t numCalls = 1;
+    double  seconds  = timeKernel(kernel, numCalls).seconds;
+    while (seconds < minTime)
+    {
+        const double factor = (seconds > 0 ? std::clamp(1.4 * minTime / seconds, 2.0, 10.0) : 10.0);
+        numCalls            = static_cast<int64_t>(std::ceil(numCalls * factor));
+        seconds             = timeKernel(kernel, numCalls).seconds;
+    }
+    return numCalls;
+}
+
+//! Returns the mean of \p values
+double mean(ArrayRef<const double> values)
+{
+    return std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+}
+
+//! Returns the median of \p values
+double median(ArrayRef<const double> values)
+{
+    std::vector<double> sorted(values.begin(), values.end());
+    std::sort(sorted.begin(), sorted.end());
+    const size_t half = sorted.size() / 2;
+    return (sorted.size() % 2 == 1 ? sorted[half] : 0.5 * (sorted[half - 1] + sorted[half]));
+}
+
+//! Returns the sample standard deviation of \p values
+double standardDeviation(ArrayRef<const double> values)
+{
+    if (values.size() < 2)
+    {
+        return 0;
+    }
+    const double average = mean(values);
+    double       sum2    = 0;
+    for (double value : values)
+    {
+        sum2 += (value - average) * (value - average);
+    }
+    return std::sqrt(sum2 / (values.size() - 1));
+}
+
+//! Returns the name of a benchmark instance, formatted as in Google Benchmark
+std::string instanceName(const BenchmarkDefinition& definition, const BenchmarkArguments& arguments)
+{
+    std::string name =
+            formatString("%s/%ld", definition.name.c_str(), static_cast<long>(arguments.size));
+    if (definition.isMultiThreaded)
+    {
+        name += formatString("/threads:%d", arguments.numThreads);
+    }
+    return name;
+}
+
+//! The format of the columns of the result table
+const char* const c_tableHeaderFormat = "%-44s %12s %12s %12s %12s %12s\n";
+
+//! Prints the header of the result table
+void printHeader(FILE* fp)
+{
+    fprintf(fp,
+            c_tableHeaderFormat,
+            "Benchmark",
+            "Time (ns)",
+            "StdDev (ns)",
+            "Iterations",
+            "Items/s",
+            "Bytes/s");
+    fprintf(fp, "%s\n", std::string(109, '-').c_str());
+}
+
+//! Prints one line of the result table
+void printResult(FILE* fp, const BenchmarkResult& result)
+{
+    const double seconds = mean(result.secondsPerCall);
+    fprintf(fp,
+            "%-44s %12.4g %12.3g %12ld",
+            result.name.c_str(),
+            1e9 * seconds,
+            1e9 * standardDeviation(result.secondsPerCall),
+            static_cast<long>(result.iterations));
+    fprintf(fp, " %12.4g", result.itemsPerRun / seconds);
+    if (result.bytesPerRun > 0)
+    {
+        fprintf(fp, " %12.4g", result.bytesPerRun / seconds);
+    }
+    fprintf(fp, "\n");
+}
+
+} // namespace
+
+std::vector<BenchmarkResult> runBenchmarks(const BenchmarkRegistry&    registry,
+                                           const BenchmarkRunSettings& settings,
+                                           FILE*                       fp)
+{
+    GMX_RELEASE_ASSERT(settings.numRepetitions > 0, "Need at least one repetition");
+
+    const std::regex filter(settings.filter.empty() ? std::string(".") : settings.filter);
+
+    printHeader(fp);
+    std::vector<BenchmarkResult> results;
+    for (const BenchmarkDefinition& definition : registry.benchmarks())
+    {
+        const std::vector<int> numThreadsList =
+                (definition.isMultiThreaded ? settings.numThreads : std::vector<int>{ 1 });
+        for (int64_t size : definition.sizes)
+        {
+            for (int numThreads : numThreadsList)
+            {
+                const BenchmarkArguments arguments = { size, numThreads };
+                const std::string        name      = instanceName(definition, arguments);
+                if (!std::regex_search(name, filter))
+                {
+                    continue;
+                }
+
+                const BenchmarkKernel kernel   = definition.factory(arguments);
+                const int64_t         numCalls = determineNumCalls(kernel, settings.minTime);
+
+                BenchmarkResult result;
+                result.name        = name;
+                result.baseName    = definition.name;
+                result.arguments   = arguments;
+                result.iterations  = numCalls;
+                result.itemsPerRun = kernel.itemsPerRun;
+                result.bytesPerRun = kernel.bytesPerRun;
+                for (int repetition = 0; repetition < settings.numRepetitions; repetition++)
+                {
+                    const KernelTiming timing = timeKernel(kernel, numCalls);
+                    result.secondsPerCall.push_back(timing.seconds / numCalls);
+                    result.cpuSecondsPerCall.push_back(timing.cpuSeconds / numCalls);
+                }
+                printResult(fp, result);
+                fflush(fp);
+                results.push_back(result);
+            }
+        }
+    }
+
+    return results;
+}
+
+namespace
+{
+
+//! Writes the fields common to all entries of a benchmark instance
+void writeJsonCommonFields(FILE* fp, const BenchmarkResult& result, int numRepetitions)
+{
+    fprintf(fp, "      \"run_name\": \"%s\",\n", result.name.c_str());
+    fprintf(fp, "      \"family_name\": \"%s\",\n", result.baseName.c_str());
+    fprintf(fp, "      \"size\": %ld,\n", static_cast<long>(result.arguments.size));
+    fprintf(fp, "      \"repetitions\": %d,\n", numRepetitions);
+    fprintf(fp, "      \"threads\": %d,\n", result.arguments.numThreads);
+    fprintf(fp, "      \"iterations\": %ld,\n", static_cast<long>(result.iterations));
+}
+
+//! Writes the timings and throughput of one entry, \p seconds is the wall-clock time per call
+void writeJsonTimings(FILE*                  fp,
+                      const BenchmarkResult& result,
+                      double                 seconds,
+                      double                 cpuSeconds,
+                      bool                   isThroughput)
+{
+    fprintf(fp, "      \"real_time\": %.6g,\n", 1e9 * seconds);
+    fprintf(fp, "      \"cpu_time\": %.6g,\n", 1e9 * cpuSeconds);
+    fprintf(fp, "      \"time_unit\": \"ns\"");
+    if (isThroughput)
+    {
+        fprintf(fp, ",\n      \"items_per_second\": %.6g", result.itemsPerRun / seconds);
+        if (result.bytesPerRun > 0)
+        {
+            fprintf(fp, ",\n      \"bytes_per_second\": %.6g", result.bytesPerRun / seconds);
+        }
+    }
+    fprintf(fp, "\n");
+}
+
+} // namespace
+
+void writeBenchmarkResultsJson(const std::string&              fileName,
+                               const BenchmarkRunSettings&     settings,
+                               ArrayRef<const BenchmarkResult> results)
+{
+    FILE* fp = fopen(fileName.c_str(), "w");
+    if (fp == nullptr)
+    {
+        gmx_fatal(FARGS, "Could not open JSON output file '%s'", fileName.c_str());
+    }
+
+    char hostName[256] = "unknown";
+    gmx_gethostname(hostName, sizeof(hostName));
+    const std::time_t now = std::time(nullptr);
+    char              date[64];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"context\": {\n");
+    fprintf(fp, "    \"date\": \"%s\",\n", date);
+    fprintf(fp, "    \"host_name\": \"%s\",\n", hostName);
+    fprintf(fp, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+    fprintf(fp, "    \"gromacs_version\": \"%s\",\n", gmx_version());
+    fprintf(fp, "    \"precision\": \"%s\",\n", GMX_DOUBLE ? "double" : "mixed");
+#if GMX_SIMD_HAVE_REAL
+    fprintf(fp, "    \"simd_real_width\": %d,\n", GMX_SIMD_REAL_WIDTH);
+#else
+    fprintf(fp, "    \"simd_real_width\": 1,\n");
+#endif
+    fprintf(fp, "    \"min_time\": %g\n", settings.minTime);
+    fprintf(fp, "  },\n");
+    fprintf(fp, "  \"benchmarks\": [\n");
+    bool isFirstEntry = true;
+    for (const BenchmarkResult& result : results)
+    {
+        const int numRepetitions = result.secondsPerCall.size();
+        for (int repetition = 0; repetition < numRepetitions; repetition++)
+        {
+            fprintf(fp, "%s    {\n", isFirstEntry ? "" : ",\n");
+            isFirstEntry = false;
+            fprintf(fp, "      \"name\": \"%s\",\n", result.name.c_str());
+            writeJsonCommonFields(fp, result, numRepetitions);
+            fprintf(fp, "      \"run_type\": \"iteration\",\n");
+            fprintf(fp, "      \"repetition_index\": %d,\n", repetition);
+            writeJsonTimings(fp,
+                             result,
+                             result.secondsPerCall[repetition],
+                             result.cpuSecondsPerCall[repetition],
+                             true);
+            fprintf(fp, "    }");
+        }
+
+        // The aggregates Google Benchmark reports for repeated runs
+        const std::vector<std::pair<const char*, double (*)(ArrayRef<const double>)>> aggregates = {
+            { "mean", mean }, { "median", median }, { "stddev", standardDeviation }
+        };
+        for (const auto& aggregate : aggregates)
+        {
+            fprintf(fp, ",\n    {\n");
+            fprintf(fp, "      \"name\": \"%s_%s\",\n", result.name.c_str(), aggregate.first);
+            writeJsonCommonFields(fp, result, numRepetitions);
+            fprintf(fp, "      \"run_type\": \"aggregate\",\n");
+            fprintf(fp, "      \"aggregate_name\": \"%s\",\n", aggregate.first);
+            // The throughput of the standard deviation of the times is not meaningful
+            writeJsonTimings(fp,
+                             result,
+                             aggregate.second(result.secondsPerCall),
+                             aggregate.second(result.cpuSecondsPerCall),
+                             aggregate.first != std::string("stddev"));
+            fprintf(fp, "    }");
+        }
+    }
+    fprintf(fp, "\n  ]\n");
+    fprintf(fp, "}\n");
+
+    fclose(fp);
+}
+
+} // namespace microbenchmark
+} // namespace gmx
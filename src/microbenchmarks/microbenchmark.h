@@ -0,0 +1,189 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \file
+ * \brief
+ * Declares a small harness for microbenchmarks of compute kernels.
+ *
+ * Each benchmark is registered with a name, a list of problem sizes
+ * and a factory that sets up the data for a given size and number of
+ * threads. The factory returns the kernel that is timed; set-up cost
+ * is therefore never part of the timings. The runner repeats each
+ * kernel until a minimum time is reached and reports the time per
+ * call and the throughput, optionally as JSON in the format used by
+ * Google Benchmark, so that the output can be processed with the same
+ * tools.
+ */
+#ifndef GMX_MICROBENCHMARKS_MICROBENCHMARK_H
+#define GMX_MICROBENCHMARKS_MICROBENCHMARK_H
+
+#include <cstdint>
+#include <cstdio>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "gromacs/utility/arrayref.h"
+
+namespace gmx
+{
+namespace microbenchmark
+{
+
+//! The parameters of one instance of a benchmark
+struct BenchmarkArguments
+{
+    //! The problem size, the meaning depends on the benchmark
+    int64_t size;
+    //! The number of OpenMP threads the kernel should use
+    int numThreads;
+};
+
+//! A timed kernel together with the amount of work done per call
+struct BenchmarkKernel
+{
+    //! The function that is timed
+    std::function<void()> run;
+    //! The number of items, e.g. atoms or interactions, processed per call
+    int64_t itemsPerRun = 0;
+    //! The number of bytes read and written per call, 0 when not meaningful
+    int64_t bytesPerRun = 0;
+};
+
+//! Sets up the data for a benchmark instance and returns the kernel to time
+using BenchmarkFactory = std::function<BenchmarkKernel(const BenchmarkArguments&)>;
+
+//! A registered benchmark
+struct BenchmarkDefinition
+{
+    //! The name of the benchmark
+    std::string name;
+    //! The problem sizes to run
+    std::vector<int64_t> sizes;
+    //! Whether the kernel uses the requested number of threads
+    bool isMultiThreaded;
+    //! Creates the kernel for a set of arguments
+    BenchmarkFactory factory;
+};
+
+//! The collection of all benchmarks
+class BenchmarkRegistry
+{
+public:
+    /*! \brief Registers a benchmark
+     *
+     * When \p isMultiThreaded is false, the benchmark is only run
+     * with a single thread.
+     */
+    void add(const std::string&   name,
+             std::vector<int64_t> sizes,
+             bool                 isMultiThreaded,
+             BenchmarkFactory     factory);
+
+    //! Returns all registered benchmarks
+    ArrayRef<const BenchmarkDefinition> benchmarks() const { return benchmarks_; }
+
+private:
+    //! The registered benchmarks
+    std::vector<BenchmarkDefinition> benchmarks_;
+};
+
+//! The settings of a run of the benchmarks
+struct BenchmarkRunSettings
+{
+    //! Only benchmarks with names matching this regular expression are run
+    std::string filter;
+    //! The numbers of threads to run the multi-threaded benchmarks with
+    std::vector<int> numThreads = { 1 };
+    //! The minimum time in seconds each repetition should take
+    double minTime = 0.2;
+    //! The number of timed repetitions
+    int numRepetitions = 3;
+};
+
+//! The timings of a benchmark instance
+struct BenchmarkResult
+{
+    //! The name, including the size and number of threads
+    std::string name;
+    //! The name of the registered benchmark
+    std::string baseName;
+    //! The arguments of the instance
+    BenchmarkArguments arguments;
+    //! The number of kernel calls in each repetition
+    int64_t iterations;
+    //! The wall-clock time per call in seconds for each repetition
+    std::vector<double> secondsPerCall;
+    //! The process CPU time per call in seconds for each repetition
+    std::vector<double> cpuSecondsPerCall;
+    //! The number of items processed per call
+    int64_t itemsPerRun;
+    //! The number of bytes processed per call
+    int64_t bytesPerRun;
+};
+
+//! Registers the benchmarks of the SIMD math functions
+void registerSimdMathBenchmarks(BenchmarkRegistry* registry);
+
+//! Registers the benchmarks of the bonded kernels
+void registerBondedBenchmarks(BenchmarkRegistry* registry);
+
+//! Registers the benchmarks of LINCS and SETTLE
+void registerConstraintBenchmarks(BenchmarkRegistry* registry);
+
+//! Registers the benchmarks of the compressed coordinate I/O
+void registerXdrBenchmarks(BenchmarkRegistry* registry);
+
+//! Registers the benchmarks of HashedMap
+void registerHashedMapBenchmarks(BenchmarkRegistry* registry);
+
+/*! \brief Runs all benchmarks matching the filter in \p settings
+ *
+ * A table with the results is printed to \p fp while the
+ * benchmarks run.
+ */
+std::vector<BenchmarkResult> runBenchmarks(const BenchmarkRegistry&    registry,
+                                           const BenchmarkRunSettings& settings,
+                                           FILE*                       fp);
+
+//! Writes \p results to a file in the JSON format of Google Benchmark
+void writeBenchmarkResultsJson(const std::string&              fileName,
+                               const BenchmarkRunSettings&     settings,
+                               ArrayRef<const BenchmarkResult> results);
+
+} // namespace microbenchmark
+} // namespace gmx
+
+#endif
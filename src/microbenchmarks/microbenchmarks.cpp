@@ -0,0 +1,188 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \file
+ * \brief
+ * Implements the main function of the microbenchmarks of compute kernels.
+ */
+
+#include "gmxpre.h"
+
+#include "config.h"
+
+#include <cstdio>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gromacs/commandline/cmdlineoptionsmodule.h"
+#include "gromacs/options/basicoptions.h"
+#include "gromacs/options/filenameoption.h"
+#include "gromacs/options/ioptionscontainer.h"
+#include "gromacs/utility/fatalerror.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+namespace microbenchmark
+{
+namespace
+{
+
+//! Command-line module that runs the microbenchmarks
+class MicroBenchmarks : public ICommandLineOptionsModule
+{
+public:
+    MicroBenchmarks()
+    {
+        registerSimdMathBenchmarks(&registry_);
+        registerBondedBenchmarks(&registry_);
+        registerConstraintBenchmarks(&registry_);
+        registerXdrBenchmarks(&registry_);
+        registerHashedMapBenchmarks(&registry_);
+    }
+
+    void init(CommandLineModuleSettings* /*settings*/) override {}
+    void initOptions(IOptionsContainer*                 options,
+                     ICommandLineOptionsModuleSettings* settings) override;
+    void optionsFinished() override {}
+    int  run() override;
+
+private:
+    BenchmarkRegistry    registry_;
+    BenchmarkRunSettings settings_;
+    std::string          jsonFileName_;
+    bool                 listOnly_ = false;
+};
+
+void MicroBenchmarks::initOptions(IOptionsContainer*                 options,
+                                  ICommandLineOptionsModuleSettings* settings)
+{
+    std::vector<const char*> desc = {
+        "[THISMODULE] times performance-critical kernels in isolation: the SIMD",
+        "math functions, the bonded force kernel flavors, LINCS and SETTLE,",
+        "the compressed coordinate I/O of xtc files and the HashedMap used",
+        "for the atom lookup in domain decomposition. Each benchmark is run",
+        "for a list of problem sizes and, when it is multi-threaded, for all",
+        "numbers of OpenMP threads given with [TT]-nt[tt].[PAR]",
+        "Each kernel is called repeatedly until a repetition takes at least",
+        "[TT]-mintime[tt] seconds, after which [TT]-repeats[tt] timed",
+        "repetitions are run. The set-up of the data is not timed.",
+        "The benchmark names have the form name/size/threads:n, a subset",
+        "can be selected with a regular expression given with [TT]-filter[tt].",
+        "The results can be written in the JSON format of Google Benchmark",
+        "to the file given with [TT]-json[tt], so that the tools for",
+        "comparing Google Benchmark results can be used to find performance",
+        "regressions."
+    };
+
+    settings->setHelpText(desc);
+
+    options->addOption(FileNameOption("json")
+                               .filetype(OptionFileType::Json)
+                               .outputFile()
+                               .store(&jsonFileName_)
+                               .defaultBasename("microbenchmarks")
+                               .description("Also output all timings in JSON format"));
+    options->addOption(StringOption("filter").store(&settings_.filter).description(
+            "Only run the benchmarks matching this regular expression"));
+    options->addOption(IntegerOption("nt")
+                               .storeVector(&settings_.numThreads)
+                               .multiValue()
+                               .description("The numbers of OpenMP threads to use"));
+    options->addOption(DoubleOption("mintime").store(&settings_.minTime).description(
+            "The minimum time in seconds of each repetition"));
+    options->addOption(IntegerOption("repeats").store(&settings_.numRepetitions).description(
+            "The number of timed repetitions"));
+    options->addOption(
+            BooleanOption("list").store(&listOnly_).description("Only list the benchmarks"));
+}
+
+int MicroBenchmarks::run()
+{
+    if (listOnly_)
+    {
+        for (const BenchmarkDefinition& definition : registry_.benchmarks())
+        {
+            fprintf(stdout,
+                    "%s%s\n",
+                    definition.name.c_str(),
+                    definition.isMultiThreaded ? " (threaded)" : "");
+        }
+        return 0;
+    }
+    for (int numThreads : settings_.numThreads)
+    {
+        if (numThreads < 1 || (!GMX_OPENMP && numThreads > 1))
+        {
+            gmx_fatal(FARGS,
+                      "Invalid number of threads %d%s",
+                      numThreads,
+                      GMX_OPENMP ? "" : ", only 1 thread is supported without OpenMP");
+        }
+    }
+    if (settings_.numRepetitions < 1)
+    {
+        gmx_fatal(FARGS, "The number of repetitions should be at least 1");
+    }
+
+    const std::vector<BenchmarkResult> results = runBenchmarks(registry_, settings_, stdout);
+    if (!jsonFileName_.empty())
+    {
+        writeBenchmarkResultsJson(jsonFileName_, settings_, results);
+    }
+
+    return 0;
+}
+
+//! Creates the command-line module
+ICommandLineOptionsModulePointer createMicroBenchmarks()
+{
+    return ICommandLineOptionsModulePointer(std::make_unique<MicroBenchmarks>());
+}
+
+} // namespace
+} // namespace microbenchmark
+} // namespace gmx
+
+int main(int argc, char* argv[])
+{
+    return gmx::ICommandLineOptionsModule::runAsMain(argc,
+                                                     argv,
+                                                     nullptr,
+                                                     "Microbenchmarks of compute kernels",
+                                                     &gmx::microbenchmark::createMicroBenchmarks);
+}
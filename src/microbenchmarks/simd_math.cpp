@@ -0,0 +1,252 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \file
+ * \brief
+ * Implements the benchmarks of the SIMD math functions.
+ *
+ * Each function is applied to an array of arguments in the range the
+ * function is used for in the kernels. The same functions from the
+ * standard library are also timed, as a reference for the speed-up.
+ */
+
+#include "gmxpre.h"
+
+#include <cmath>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gromacs/simd/simd.h"
+#include "gromacs/simd/simd_math.h"
+#include "gromacs/utility/alignedallocator.h"
+#include "gromacs/utility/basedefinitions.h"
+#include "gromacs/utility/real.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+namespace microbenchmark
+{
+namespace
+{
+
+//! The numbers of values the functions are applied to
+const std::vector<int64_t> c_mathSizes = { 1024, 65536, 1048576 };
+
+//! The input and output values of a math benchmark
+struct MathData
+{
+    //! The arguments
+    std::vector<real, AlignedAllocator<real>> input;
+    //! The results
+    std::vector<real, AlignedAllocator<real>> output;
+};
+
+/*! \brief Returns values spread deterministically over [\p minValue, \p maxValue)
+ *
+ * The values are ordered irregularly, using the golden ratio, so that
+ * the branches in the functions are not trivially predicted.
+ */
+std::shared_ptr<MathData> makeMathData(int64_t size, real minValue, real maxValue)
+{
+    auto data = std::make_shared<MathData>();
+    data->input.resize(size);
+    data->output.resize(size);
+    for (int64_t i = 0; i < size; i++)
+    {
+        const double fraction = std::fmod(i * 0.6180339887498949, 1.0);
+        data->input[i]        = minValue + fraction * (maxValue - minValue);
+    }
+    return data;
+}
+
+//! Returns a kernel applying \p function to all values, using standard C++
+template<typename Function>
+BenchmarkKernel makeScalarKernel(const BenchmarkArguments& arguments,
+                                 real                      minValue,
+                                 real                      maxValue,
+                                 Function                  function)
+{
+    std::shared_ptr<MathData> data = makeMathData(arguments.size, minValue, maxValue);
+
+    BenchmarkKernel kernel;
+    kernel.run = [data, function, numThreads = arguments.numThreads]() {
+        const real*   input  = data->input.data();
+        real*         output = data->output.data();
+        const int64_t size   = data->input.size();
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+        for (int64_t i = 0; i < size; i++)
+        {
+            output[i] = function(input[i]);
+        }
+    };
+    kernel.itemsPerRun = arguments.size;
+    kernel.bytesPerRun = 2 * arguments.size * sizeof(real);
+
+    return kernel;
+}
+
+#if GMX_SIMD_HAVE_REAL
+
+//! Returns a kernel applying the SIMD \p function to all values
+template<typename Function>
+BenchmarkKernel makeSimdKernel(const BenchmarkArguments& arguments,
+                               real                      minValue,
+                               real                      maxValue,
+                               Function                  function)
+{
+    // Round up to a multiple of the SIMD width, the sizes are powers of two
+    const int64_t paddedSize =
+            (arguments.size + GMX_SIMD_REAL_WIDTH - 1) / GMX_SIMD_REAL_WIDTH * GMX_SIMD_REAL_WIDTH;
+    std::shared_ptr<MathData> data = makeMathData(paddedSize, minValue, maxValue);
+
+    BenchmarkKernel kernel;
+    kernel.run = [data, function, numThreads = arguments.numThreads]() {
+        const real*   input  = data->input.data();
+        real*         output = data->output.data();
+        const int64_t size   = data->input.size();
+#    pragma omp parallel for num_threads(numThreads) schedule(static)
+        for (int64_t i = 0; i < size; i += GMX_SIMD_REAL_WIDTH)
+        {
+            store(output + i, function(load<SimdReal>(input + i)));
+        }
+    };
+    kernel.itemsPerRun = paddedSize;
+    kernel.bytesPerRun = 2 * paddedSize * sizeof(real);
+
+    return kernel;
+}
+
+#endif // GMX_SIMD_HAVE_REAL
+
+/*! \brief Registers the scalar and SIMD benchmarks of a math function
+ *
+ * \param[in,out] registry      The registry
+ * \param[in]     name          The name of the function
+ * \param[in]     minValue      The lower bound of the arguments
+ * \param[in]     maxValue      The upper bound of the arguments
+ * \param[in]     scalarFunc    The function in plain C++
+ * \param[in]     simdFunc      The SIMD function
+ */
+template<typename ScalarFunction, typename SimdFunction>
+void registerMathBenchmark(BenchmarkRegistry*      registry,
+                           const std::string&      name,
+                           real                    minValue,
+                           real                    maxValue,
+                           ScalarFunction          scalarFunc,
+                           SimdFunction gmx_unused simdFunc)
+{
+    registry->add("scalar_" + name, c_mathSizes, true, [=](const BenchmarkArguments& arguments) {
+        return makeScalarKernel(arguments, minValue, maxValue, scalarFunc);
+    });
+#if GMX_SIMD_HAVE_REAL
+    registry->add("simd_" + name, c_mathSizes, true, [=](const BenchmarkArguments& arguments) {
+        return makeSimdKernel(arguments, minValue, maxValue, simdFunc);
+    });
+#endif
+}
+
+} // namespace
+
+void registerSimdMathBenchmarks(BenchmarkRegistry* registry)
+{
+    // The ranges cover the arguments in the nonbonded and PME kernels
+    registerMathBenchmark(
+            registry,
+            "invsqrt",
+            0.01,
+            100,
+            [](real x) { return 1 / std::sqrt(x); },
+            [](auto x) { return invsqrt(x); });
+    registerMathBenchmark(
+            registry,
+            "sqrt",
+            0.01,
+            100,
+            [](real x) { return std::sqrt(x); },
+            [](auto x) { return sqrt(x); });
+    registerMathBenchmark(
+            registry,
+            "exp",
+            -20,
+            20,
+            [](real x) { return std::exp(x); },
+            [](auto x) { return exp(x); });
+    registerMathBenchmark(
+            registry,
+            "log",
+            0.01,
+            100,
+            [](real x) { return std::log(x); },
+            [](auto x) { return log(x); });
+    registerMathBenchmark(
+            registry,
+            "sin",
+            -10,
+            10,
+            [](real x) { return std::sin(x); },
+            [](auto x) { return sin(x); });
+    registerMathBenchmark(
+            registry,
+            "erf",
+            -4,
+            4,
+            [](real x) { return std::erf(x); },
+            [](auto x) { return erf(x); });
+    registerMathBenchmark(
+            registry,
+            "erfc",
+            0,
+            4,
+            [](real x) { return std::erfc(x); },
+            [](auto x) { return erfc(x); });
+    // The analytical Ewald force correction of the nonbonded kernels,
+    // with the reference implementation of the unit tests
+    registerMathBenchmark(
+            registry,
+            "pmeForceCorrection",
+            0.15,
+            4,
+            [](real z2) {
+                const real z = std::sqrt(z2);
+                return (2 * std::exp(-z2) / std::sqrt(M_PI) * z - std::erf(z)) / (z2 * z);
+            },
+            [](auto z2) { return pmeForceCorrection(z2); });
+}
+
+} // namespace microbenchmark
+} // namespace gmx
@@ -0,0 +1,171 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \file
+ * \brief
+ * Implements the benchmarks of the compressed coordinate I/O.
+ *
+ * The coordinates are compressed with xdr3dfcoord(), as for xtc
+ * frames, into a temporary file, which normally stays in the page
+ * cache, so mostly the cost of the compression is timed.
+ */
+
+#include "gmxpre.h"
+
+#include <cmath>
+#include <cstdio>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gromacs/fileio/xdrf.h"
+#include "gromacs/math/vectypes.h"
+#include "gromacs/utility/exceptions.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+namespace microbenchmark
+{
+namespace
+{
+
+//! The numbers of atoms per frame
+const std::vector<int64_t> c_xdrSizes = { 3000, 300000 };
+
+//! The precision of the compressed coordinates, as the default of mdrun
+constexpr float c_precision = 1000;
+
+//! A temporary file with an XDR stream for compressed coordinates
+struct XdrBenchData
+{
+    ~XdrBenchData()
+    {
+        if (fp != nullptr)
+        {
+            xdr_destroy(&xdr);
+            fclose(fp);
+        }
+    }
+
+    //! The coordinates to write, or the buffer to read into
+    std::vector<gmx::BasicVector<float>> x;
+    //! The temporary file
+    FILE* fp = nullptr;
+    //! The XDR stream
+    XDR xdr;
+};
+
+/*! \brief Sets up a frame of \p numAtoms atoms with the structure of liquid water
+ *
+ * Molecules are placed on a lattice with a density similar to water,
+ * with the hydrogens displaced irregularly, so that the compression
+ * has to deal with the typical small distances within molecules.
+ */
+std::shared_ptr<XdrBenchData> makeXdrData(int numAtoms, xdr_op mode)
+{
+    auto data = std::make_shared<XdrBenchData>();
+
+    const int numMolecules = (numAtoms + 2) / 3;
+    const int numPerDim    = static_cast<int>(std::ceil(std::cbrt(numMolecules)));
+    data->x.resize(numAtoms);
+    for (int i = 0; i < numAtoms; i++)
+    {
+        const int   m = i / 3;
+        const float f = std::fmod(i * 0.6180339887498949, 1.0);
+        data->x[i]    = { (m % numPerDim) * 0.31F + (i % 3) * 0.1F * f,
+                       ((m / numPerDim) % numPerDim) * 0.31F + (i % 3) * 0.1F * (1 - f),
+                       (m / (numPerDim * numPerDim)) * 0.31F };
+    }
+
+    data->fp = tmpfile();
+    if (data->fp == nullptr)
+    {
+        GMX_THROW(FileIOError("Could not open a temporary file for the XDR benchmarks"));
+    }
+    if (mode == XDR_DECODE)
+    {
+        // Write the frame once, so there is something to read
+        xdrstdio_create(&data->xdr, data->fp, XDR_ENCODE);
+        float precision = c_precision;
+        if (!xdr3dfcoord(&data->xdr, data->x[0], &numAtoms, &precision))
+        {
+            GMX_THROW(FileIOError("Writing the compressed coordinates failed"));
+        }
+        xdr_destroy(&data->xdr);
+        fflush(data->fp);
+    }
+    xdrstdio_create(&data->xdr, data->fp, mode);
+
+    return data;
+}
+
+//! Returns a kernel writing or reading one compressed frame
+BenchmarkKernel makeXdrKernel(const BenchmarkArguments& arguments, xdr_op mode)
+{
+    std::shared_ptr<XdrBenchData> data = makeXdrData(arguments.size, mode);
+
+    BenchmarkKernel kernel;
+    kernel.run = [data]() {
+        int   numAtoms  = data->x.size();
+        float precision = c_precision;
+        xdr_setpos(&data->xdr, 0);
+        if (!xdr3dfcoord(&data->xdr, data->x[0], &numAtoms, &precision))
+        {
+            GMX_THROW(FileIOError("Compressing or decompressing the coordinates failed"));
+        }
+    };
+    kernel.itemsPerRun = arguments.size;
+    // The size of the uncompressed coordinates
+    kernel.bytesPerRun = arguments.size * DIM * sizeof(float);
+
+    return kernel;
+}
+
+} // namespace
+
+void registerXdrBenchmarks(BenchmarkRegistry* registry)
+{
+    registry->add("xtc_compress", c_xdrSizes, false, [](const BenchmarkArguments& arguments) {
+        return makeXdrKernel(arguments, XDR_ENCODE);
+    });
+    registry->add("xtc_decompress", c_xdrSizes, false, [](const BenchmarkArguments& arguments) {
+        return makeXdrKernel(arguments, XDR_DECODE);
+    });
+}
+
+} // namespace microbenchmark
+} // namespace gmx
@@ -71,6 +71,7 @@
 
 #include "mdrun/mdrun_main.h"
 #include "mdrun/nonbonded_bench.h"
+#include "mdrun/pme_bench.h"
 #include "view/view.h"
 
 namespace
@@ -193,6 +194,10 @@ void registerLegacyModules(gmx::CommandLineModuleManager* manager)
                                                           gmx::NonbondedBenchmarkInfo::name,
                                                           gmx::NonbondedBenchmarkInfo::shortDescription,
                                                           &gmx::NonbondedBenchmarkInfo::create);
+    gmx::ICommandLineOptionsModule::registerModuleFactory(manager,
+                                                          gmx::PmeBenchmarkInfo::name,
+                                                          gmx::PmeBenchmarkInfo::shortDescription,
+                                                          &gmx::PmeBenchmarkInfo::create);
 
     gmx::ICommandLineOptionsModule::registerModuleFactory(manager,
                                                           gmx::InsertMoleculesInfo::name(),
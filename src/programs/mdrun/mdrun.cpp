@@ -71,10 +71,80 @@
 #include "gromacs/utility/physicalnodecommunicator.h"
 
 #include "mdrun_main.h"
+#include "runconfigurationtuning.h"
 
 namespace gmx
 {
 
+namespace
+{
+
+//! Runs mdrun with the parsed \p options and returns the exit code
+int runMdrun(MPI_Comm communicator, const gmx_hw_info_t& hwinfo, LegacyMdrunOptions* options)
+{
+    ArrayRef<const std::string> multiSimDirectoryNames =
+            opt2fnsIfOptionSet("-multidir", ssize(options->filenames), options->filenames.data());
+
+    // The SimulationContext is necessary with gmxapi so that
+    // resources owned by the client code can have suitable
+    // lifetime. The gmx wrapper binary uses the same infrastructure,
+    // but the lifetime is now trivially that of the invocation of the
+    // wrapper binary.
+    SimulationContext simulationContext(communicator, multiSimDirectoryNames);
+
+    StartingBehavior startingBehavior        = StartingBehavior::NewSimulation;
+    LogFilePtr       logFileGuard            = nullptr;
+    gmx_multisim_t*  ms                      = simulationContext.multiSimulation_.get();
+    std::tie(startingBehavior, logFileGuard) =
+            handleRestart(findIsSimulationMasterRank(ms, communicator),
+                          communicator,
+                          ms,
+                          options->mdrunOptions.appendingBehavior,
+                          ssize(options->filenames),
+                          options->filenames.data());
+
+    /* The named components for the builder exposed here are descriptive of the
+     * state of mdrun at implementation and are not intended to be prescriptive
+     * of future design. (Note the ICommandLineOptions... framework used elsewhere.)
+     * The modules should ultimately take part in composing the Director code
+     * for an extensible Builder.
+     *
+     * In the near term, we assume that resources like domain decomposition and
+     * neighbor lists must be reinitialized between simulation segments.
+     * We would prefer to rebuild resources only as necessary, but we defer such
+     * details to future optimizations.
+     */
+    auto builder = MdrunnerBuilder(std::make_unique<MDModules>(),
+                                   compat::not_null<SimulationContext*>(&simulationContext));
+    builder.addHardwareDetectionResult(&hwinfo);
+    builder.addSimulationMethod(options->mdrunOptions, options->pforce, startingBehavior);
+    builder.addDomainDecomposition(options->domdecOptions);
+    // \todo pass by value
+    builder.addNonBonded(options->nbpu_opt_choices[0]);
+    // \todo pass by value
+    builder.addElectrostatics(options->pme_opt_choices[0], options->pme_fft_opt_choices[0]);
+    builder.addBondedTaskAssignment(options->bonded_opt_choices[0]);
+    builder.addUpdateTaskAssignment(options->update_opt_choices[0]);
+    builder.addNeighborList(options->nstlist_cmdline);
+    builder.addReplicaExchange(options->replExParams);
+    // Need to establish run-time values from various inputs to provide a resource handle to Mdrunner
+    builder.addHardwareOptions(options->hw_opt);
+    // \todo File names are parameters that should be managed modularly through further factoring.
+    builder.addFilenames(options->filenames);
+    builder.addInput(makeSimulationInput(*options));
+    // Note: The gmx_output_env_t life time is not managed after the call to parse_common_args.
+    // \todo Implement lifetime management for gmx_output_env_t.
+    // \todo Output environment should be configured outside of Mdrunner and provided as a resource.
+    builder.addOutputEnvironment(options->oenv);
+    builder.addLogFile(logFileGuard.get());
+
+    auto runner = builder.build();
+
+    return runner.mdrunner();
+}
+
+} // namespace
+
 int gmx_mdrun(int argc, char* argv[])
 {
     // Set up the communicator, where possible (see docs for
@@ -87,8 +157,6 @@ int gmx_mdrun(int argc, char* argv[])
 
 int gmx_mdrun(MPI_Comm communicator, const gmx_hw_info_t& hwinfo, int argc, char* argv[])
 {
-    auto mdModules = std::make_unique<MDModules>();
-
     std::vector<const char*> desc = {
         "[THISMODULE] is the main computational chemistry engine",
         "within GROMACS. Obviously, it performs Molecular Dynamics simulations,",
@@ -213,9 +281,27 @@ int gmx_mdrun(MPI_Comm communicator, const gmx_hw_info_t& hwinfo, int argc, char
         "IMD remote can be turned on by [TT]-imdpull[tt].",
         "The port [TT]mdrun[tt] listens to can be altered by [TT]-imdport[tt].The",
         "file pointed to by [TT]-if[tt] contains atom indices and forces if IMD",
-        "pulling is used."
+        "pulling is used.",
+        "[PAR]",
+        "With option [TT]-perf[tt] the cycle counters of all ranks and the GPU",
+        "timings of the performance report at the end of the log file are also",
+        "written to a versioned JSON file, intended for automated analysis.",
+        "[PAR]",
+        "With option [TT]-tune[tt] no simulation is run, instead [TT]mdrun[tt]",
+        "runs [TT]-tunesteps[tt] steps, timed over the second half, for a sequence",
+        "of setups. It varies the number of thread-MPI ranks and OpenMP threads,",
+        "the GPU offload of the non-bonded, PME, bonded and update tasks and",
+        "the number of separate PME ranks one at a time, keeping the fastest",
+        "choice of the earlier ones. Options that are set on the command line",
+        "are not varied. The output of each trial is written to files with",
+        "[TT]_tune[tt] and the trial number added to their names, of which",
+        "only the log files are kept. The fastest setup is printed and written",
+        "as [TT]mdrun[tt] arguments to [TT]-tuneout[tt]."
     };
 
+    /* Keep the original arguments, since parsing changes them */
+    const std::vector<std::string> arguments(argv, argv + argc);
+
     LegacyMdrunOptions options;
 
     if (options.updateFromCommandLine(argc, argv, desc) == 0)
@@ -223,64 +309,15 @@ int gmx_mdrun(MPI_Comm communicator, const gmx_hw_info_t& hwinfo, int argc, char
         return 0;
     }
 
-    ArrayRef<const std::string> multiSimDirectoryNames =
-            opt2fnsIfOptionSet("-multidir", ssize(options.filenames), options.filenames.data());
-
-    // The SimulationContext is necessary with gmxapi so that
-    // resources owned by the client code can have suitable
-    // lifetime. The gmx wrapper binary uses the same infrastructure,
-    // but the lifetime is now trivially that of the invocation of the
-    // wrapper binary.
-    SimulationContext simulationContext(communicator, multiSimDirectoryNames);
-
-    StartingBehavior startingBehavior        = StartingBehavior::NewSimulation;
-    LogFilePtr       logFileGuard            = nullptr;
-    gmx_multisim_t*  ms                      = simulationContext.multiSimulation_.get();
-    std::tie(startingBehavior, logFileGuard) = handleRestart(findIsSimulationMasterRank(ms, communicator),
-                                                             communicator,
-                                                             ms,
-                                                             options.mdrunOptions.appendingBehavior,
-                                                             ssize(options.filenames),
-                                                             options.filenames.data());
-
-    /* The named components for the builder exposed here are descriptive of the
-     * state of mdrun at implementation and are not intended to be prescriptive
-     * of future design. (Note the ICommandLineOptions... framework used elsewhere.)
-     * The modules should ultimately take part in composing the Director code
-     * for an extensible Builder.
-     *
-     * In the near term, we assume that resources like domain decomposition and
-     * neighbor lists must be reinitialized between simulation segments.
-     * We would prefer to rebuild resources only as necessary, but we defer such
-     * details to future optimizations.
-     */
-    auto builder = MdrunnerBuilder(std::move(mdModules),
-                                   compat::not_null<SimulationContext*>(&simulationContext));
-    builder.addHardwareDetectionResult(&hwinfo);
-    builder.addSimulationMethod(options.mdrunOptions, options.pforce, startingBehavior);
-    builder.addDomainDecomposition(options.domdecOptions);
-    // \todo pass by value
-    builder.addNonBonded(options.nbpu_opt_choices[0]);
-    // \todo pass by value
-    builder.addElectrostatics(options.pme_opt_choices[0], options.pme_fft_opt_choices[0]);
-    builder.addBondedTaskAssignment(options.bonded_opt_choices[0]);
-    builder.addUpdateTaskAssignment(options.update_opt_choices[0]);
-    builder.addNeighborList(options.nstlist_cmdline);
-    builder.addReplicaExchange(options.replExParams);
-    // Need to establish run-time values from various inputs to provide a resource handle to Mdrunner
-    builder.addHardwareOptions(options.hw_opt);
-    // \todo File names are parameters that should be managed modularly through further factoring.
-    builder.addFilenames(options.filenames);
-    builder.addInput(makeSimulationInput(options));
-    // Note: The gmx_output_env_t life time is not managed after the call to parse_common_args.
-    // \todo Implement lifetime management for gmx_output_env_t.
-    // \todo Output environment should be configured outside of Mdrunner and provided as a resource.
-    builder.addOutputEnvironment(options.oenv);
-    builder.addLogFile(logFileGuard.get());
-
-    auto runner = builder.build();
+    if (options.tuneRunConfiguration)
+    {
+        auto runTrial = [communicator, &hwinfo](LegacyMdrunOptions* trialOptions) {
+            return runMdrun(communicator, hwinfo, trialOptions);
+        };
+        return tuneRunConfiguration(communicator, hwinfo, arguments, desc, options, runTrial);
+    }
 
-    return runner.mdrunner();
+    return runMdrun(communicator, hwinfo, &options);
 }
 
 } // namespace gmx
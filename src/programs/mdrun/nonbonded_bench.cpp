@@ -152,7 +152,17 @@ void NonbondedBenchmark::initOptions(IOptionsContainer* options, ICommandLineOpt
         "In the MD engine, any clusters where at most half of the atoms",
         "have LJ interactions will automatically use this kernel.",
         "And finally, the [TT]-energy[tt] option selects the computation",
-        "of energies, which are usually only needed infrequently."
+        "of energies, which are usually only needed infrequently.[PAR]",
+        "With [TT]-search[tt], the tool also times, for each kernel setup,",
+        "putting the atoms on the grid together with the pairlist search,",
+        "the conversion of the coordinates to the non-bonded layout",
+        "and the reduction of the non-bonded forces. For the search",
+        "the pairs in the list per time unit are reported, for the buffer",
+        "operations an estimate of the memory traffic per time unit.",
+        "All timings can be written in JSON format to the file given",
+        "with [TT]-json[tt], which is intended for automated performance",
+        "regression testing. When the cycle counter can be calibrated,",
+        "the JSON file also contains times in seconds and rates per second."
     };
 
     settings->setHelpText(desc);
@@ -208,14 +218,25 @@ void NonbondedBenchmark::initOptions(IOptionsContainer* options, ICommandLineOpt
     options->addOption(BooleanOption("cycles")
                                .store(&benchmarkOptions_.cyclesPerPair)
                                .description("Report cycles/pair instead of pairs/cycle"));
-    options->addOption(
-            BooleanOption("time").store(&benchmarkOptions_.reportTime).description("Report micro-seconds instead of cycles"));
+    options->addOption(BooleanOption("time")
+                               .store(&benchmarkOptions_.reportTime)
+                               .description("Report micro-seconds instead of cycles, when the "
+                                            "cycle counter can be calibrated"));
+    options->addOption(BooleanOption("search")
+                               .store(&benchmarkOptions_.benchmarkSearchAndBufferOps)
+                               .description("Also time the pairlist search and buffer operations"));
     options->addOption(FileNameOption("o")
                                .filetype(OptionFileType::Csv)
                                .outputFile()
                                .store(&benchmarkOptions_.outputFile)
                                .defaultBasename("nonbonded-benchmark")
                                .description("Also output results in csv format"));
+    options->addOption(FileNameOption("json")
+                               .filetype(OptionFileType::Json)
+                               .outputFile()
+                               .store(&benchmarkOptions_.jsonOutputFile)
+                               .defaultBasename("nonbonded-benchmark")
+                               .description("Also output all timings in JSON format"));
 }
 
 void NonbondedBenchmark::optionsFinished()
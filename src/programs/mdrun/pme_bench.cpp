@@ -0,0 +1,618 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief This file contains the PME benchmarking tool
+ */
+
+#include "gmxpre.h"
+
+#include "pme_bench.h"
+
+#include "config.h"
+
+#include <cmath>
+#include <cstdio>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gromacs/commandline/cmdlineoptionsmodule.h"
+#include "gromacs/domdec/domdec.h"
+#include "gromacs/ewald/ewald_utils.h"
+#include "gromacs/ewald/pme.h"
+#include "gromacs/fft/calcgrid.h"
+#include "gromacs/fileio/tpxio.h"
+#include "gromacs/gmxlib/nrnb.h"
+#include "gromacs/math/vec.h"
+#include "gromacs/mdtypes/inputrec.h"
+#include "gromacs/mdtypes/simulation_workload.h"
+#include "gromacs/mdtypes/state.h"
+#include "gromacs/options/basicoptions.h"
+#include "gromacs/options/filenameoption.h"
+#include "gromacs/options/ioptionscontainer.h"
+#include "gromacs/random/threefry.h"
+#include "gromacs/random/uniformrealdistribution.h"
+#include "gromacs/timing/cyclecounter.h"
+#include "gromacs/timing/wallcycle.h"
+#include "gromacs/topology/mtop_util.h"
+#include "gromacs/topology/topology.h"
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/enumerationhelpers.h"
+#include "gromacs/utility/fatalerror.h"
+#include "gromacs/utility/logger.h"
+#include "gromacs/utility/real.h"
+
+namespace gmx
+{
+
+namespace
+{
+
+//! The PME stages that are timed separately
+enum class PmeBenchStage : int
+{
+    Spread,
+    Fft,
+    Solve,
+    Gather,
+    Count
+};
+
+//! The names of the stages
+const EnumerationArray<PmeBenchStage, const char*> c_stageNames = { { "spread",
+                                                                      "fft",
+                                                                      "solve",
+                                                                      "gather" } };
+
+//! The cycle counters gmx_pme_do() uses for each of the stages
+const EnumerationArray<PmeBenchStage, WallCycleCounter> c_stageCounters = {
+    { WallCycleCounter::PmeSpread,
+      WallCycleCounter::PmeFft,
+      WallCycleCounter::PmeSolve,
+      WallCycleCounter::PmeGather }
+};
+
+//! The atom density of the generated system, the same as for water, in atoms/nm^3
+constexpr real c_atomDensity = 100;
+
+//! The coordinates, charges and box of the benchmark system
+struct PmeBenchSystem
+{
+    //! The coordinates
+    std::vector<RVec> coordinates;
+    //! The charges
+    std::vector<real> charges;
+    //! The box
+    matrix box = { { 0 } };
+    //! The Coulomb cut-off, used for the Ewald coefficient
+    real coulombCutoff = 1.0;
+    //! The relative tolerance of the direct space sum at the cut-off
+    real ewaldRTol = 1e-5;
+};
+
+//! The settings of a benchmark instance
+struct PmeBenchInstance
+{
+    //! The number of OpenMP threads
+    int numThreads;
+    //! The interpolation order
+    int pmeOrder;
+    //! The requested grid spacing
+    real gridSpacing;
+};
+
+//! The timings and work of a stage
+struct PmeBenchStageResult
+{
+    //! The number of cycles over all timed iterations
+    double cycles = 0;
+    //! The number of floating point operations, estimated from the flop accounting
+    double flops = 0;
+    //! The memory traffic, estimated from the minimal number of grid and atom accesses
+    double bytes = 0;
+};
+
+//! The settings and results of a benchmark instance
+struct PmeBenchResult
+{
+    //! The settings
+    PmeBenchInstance instance;
+    //! The grid size
+    IVec gridSize;
+    //! The results per stage
+    EnumerationArray<PmeBenchStage, PmeBenchStageResult> stages;
+};
+
+//! Generates a system of \p numAtoms neutral water-like atoms at random positions
+PmeBenchSystem generateSystem(int numAtoms)
+{
+    PmeBenchSystem system;
+
+    const real boxSize = std::cbrt(numAtoms / c_atomDensity);
+    for (int d = 0; d < DIM; d++)
+    {
+        system.box[d][d] = boxSize;
+    }
+
+    DefaultRandomEngine           rng(1234);
+    UniformRealDistribution<real> dist(0, boxSize);
+    system.coordinates.resize(numAtoms);
+    system.charges.resize(numAtoms);
+    for (int i = 0; i < numAtoms; i++)
+    {
+        for (int d = 0; d < DIM; d++)
+        {
+            system.coordinates[i][d] = dist(rng);
+        }
+        // Use TIP3P charges, so groups of three atoms are neutral
+        system.charges[i] = (i % 3 == 0) ? -0.834 : 0.417;
+    }
+
+    return system;
+}
+
+//! Reads the coordinates, charges and box from \p tprFileName
+PmeBenchSystem readSystem(const std::string& tprFileName)
+{
+    PmeBenchSystem system;
+
+    t_inputrec ir;
+    t_state    state;
+    gmx_mtop_t mtop;
+    read_tpx_state(tprFileName.c_str(), &ir, &state, &mtop);
+
+    system.coordinates.assign(state.x.begin(), state.x.end());
+    for (const AtomProxy atomP : AtomRange(mtop))
+    {
+        system.charges.push_back(atomP.atom().q);
+    }
+    copy_mat(state.box, system.box);
+    if (EEL_PME(ir.coulombtype))
+    {
+        system.coulombCutoff = ir.rcoulomb;
+        system.ewaldRTol     = ir.ewald_rtol;
+    }
+
+    return system;
+}
+
+//! Runs \p numIterations PME force calculations
+void runPme(gmx_pme_t*            pme,
+            const PmeBenchSystem& system,
+            ArrayRef<RVec>        forces,
+            int                   numIterations,
+            const StepWorkload&   stepWork,
+            t_nrnb*               nrnb,
+            gmx_wallcycle*        wcycle)
+{
+    matrix virial;
+    real   energy      = 0;
+    real   dvdlambda   = 0;
+    matrix virialLJ    = { { 0 } };
+    real   energyLJ    = 0;
+    real   dvdlambdaLJ = 0;
+    for (int iter = 0; iter < numIterations; iter++)
+    {
+        clear_mat(virial);
+        gmx_pme_do(pme,
+                   system.coordinates,
+                   forces,
+                   system.charges,
+                   {},
+                   {},
+                   {},
+                   {},
+                   {},
+                   system.box,
+                   nullptr,
+                   0,
+                   0,
+                   nrnb,
+                   wcycle,
+                   virial,
+                   virialLJ,
+                   &energy,
+                   &energyLJ,
+                   0,
+                   0,
+                   &dvdlambda,
+                   &dvdlambdaLJ,
+                   stepWork);
+    }
+}
+
+//! Sets up PME for \p instance, times it and returns the results
+PmeBenchResult runInstance(const PmeBenchSystem&   system,
+                           const PmeBenchInstance& instance,
+                           int                     numIterations,
+                           int                     numWarmupIterations,
+                           bool                    computeEnergyAndVirial,
+                           gmx_wallcycle*          wcycle)
+{
+    t_inputrec ir;
+    ir.coulombtype     = CoulombInteractionType::Pme;
+    ir.epsilon_r       = 1.0;
+    ir.pme_order       = instance.pmeOrder;
+    ir.fourier_spacing = instance.gridSpacing;
+    calcFftGrid(nullptr,
+                system.box,
+                instance.gridSpacing,
+                minimalPmeGridSize(instance.pmeOrder),
+                &ir.nkx,
+                &ir.nky,
+                &ir.nkz);
+
+    const real          ewaldCoeff    = calc_ewaldcoeff_q(system.coulombCutoff, system.ewaldRTol);
+    const NumPmeDomains numPmeDomains = { 1, 1 };
+    const MDLogger      dummyLogger;
+    gmx_pme_t*          pme = gmx_pme_init(nullptr,
+                                           numPmeDomains,
+                                           &ir,
+                                           system.box,
+                                           0,
+                                           false,
+                                           false,
+                                           false,
+                                           ewaldCoeff,
+                                           0,
+                                           instance.numThreads,
+                                           PmeRunMode::CPU,
+                                           nullptr,
+                                           nullptr,
+                                           nullptr,
+                                           nullptr,
+                                           dummyLogger);
+    gmx_pme_reinit_atoms(pme, system.coordinates.size(), system.charges, {});
+
+    StepWorkload stepWork;
+    stepWork.computeForces = true;
+    stepWork.computeVirial = computeEnergyAndVirial;
+    stepWork.computeEnergy = computeEnergyAndVirial;
+
+    std::vector<RVec> forces(system.coordinates.size(), { 0, 0, 0 });
+    t_nrnb            nrnb;
+
+    // The first call also allocates the thread-local spline and grid data
+    runPme(pme, system, forces, std::max(numWarmupIterations, 1), stepWork, &nrnb, wcycle);
+
+    clear_nrnb(&nrnb);
+    wallcycle_reset_all(wcycle);
+    runPme(pme, system, forces, numIterations, stepWork, &nrnb, wcycle);
+
+    PmeBenchResult result;
+    result.instance = instance;
+    result.gridSize = { ir.nkx, ir.nky, ir.nkz };
+    for (auto stage : keysOf(result.stages))
+    {
+        int    numCalls = 0;
+        double cycles   = 0;
+        wallcycle_get(wcycle, c_stageCounters[stage], &numCalls, &cycles);
+        result.stages[stage].cycles = cycles;
+    }
+
+    // Flops from the flop accounting in gmx_pme_do()
+    auto flops = [&nrnb](int enr) { return nrnb.n[enr] * cost_nrnb(enr); };
+    result.stages[PmeBenchStage::Spread].flops = flops(eNR_WEIGHTS) + flops(eNR_SPREADBSP);
+    result.stages[PmeBenchStage::Fft].flops    = flops(eNR_FFT);
+    result.stages[PmeBenchStage::Solve].flops  = flops(eNR_SOLVEPME);
+    result.stages[PmeBenchStage::Gather].flops = flops(eNR_GATHERFBSP);
+
+    // Minimal memory traffic: spread reads and writes and gather reads order^3 grid
+    // points per atom, each FFT reads and writes the real and the complex grid and
+    // the solve reads and writes the complex grid.
+    const double numAtoms         = system.coordinates.size();
+    const double numGridPoints    = ir.nkx * ir.nky * static_cast<double>(ir.nkz);
+    const double numComplexPoints = ir.nkx * ir.nky * static_cast<double>(ir.nkz / 2 + 1);
+    const double order3           = instance.pmeOrder * instance.pmeOrder * instance.pmeOrder;
+    const double atomBytes        = numAtoms * (DIM + 1) * sizeof(real);
+    result.stages[PmeBenchStage::Spread].bytes =
+            numIterations * (atomBytes + 2 * numAtoms * order3 * sizeof(real));
+    result.stages[PmeBenchStage::Fft].bytes =
+            numIterations * 2 * (numGridPoints + 2 * numComplexPoints) * sizeof(real);
+    result.stages[PmeBenchStage::Solve].bytes =
+            numIterations * 2 * 2 * numComplexPoints * sizeof(real);
+    result.stages[PmeBenchStage::Gather].bytes =
+            numIterations
+            * (atomBytes + numAtoms * DIM * sizeof(real) + numAtoms * order3 * sizeof(real));
+
+    gmx_pme_destroy(pme);
+
+    return result;
+}
+
+//! Prints the results of all instances to stdout
+void printResults(ArrayRef<const PmeBenchResult> results, int numIterations, double secondsPerCycle)
+{
+    // With a calibrated cycle counter we report time and rates per second,
+    // otherwise cycles and rates per cycle
+    const bool haveTime = (secondsPerCycle > 0);
+    fprintf(stdout,
+            "threads order spacing grid         stage  %s  %s  %s\n",
+            haveTime ? " usec/it." : "Mcycles/it.",
+            haveTime ? "GFlop/s" : "flop/cycle",
+            haveTime ? "  GB/s" : "bytes/cycle");
+    for (const auto& result : results)
+    {
+        for (auto stage : keysOf(result.stages))
+        {
+            const PmeBenchStageResult& stageResult = result.stages[stage];
+            const double units = stageResult.cycles * (haveTime ? secondsPerCycle : 1.0);
+            fprintf(stdout,
+                    "%7d %5d %7.3f %3dx%3dx%3d  %-6s %11.3f %9.3f %9.3f\n",
+                    result.instance.numThreads,
+                    result.instance.pmeOrder,
+                    result.instance.gridSpacing,
+                    result.gridSize[XX],
+                    result.gridSize[YY],
+                    result.gridSize[ZZ],
+                    c_stageNames[stage],
+                    units / numIterations * (haveTime ? 1e6 : 1e-6),
+                    units > 0 ? stageResult.flops / units * (haveTime ? 1e-9 : 1.0) : 0.0,
+                    units > 0 ? stageResult.bytes / units * (haveTime ? 1e-9 : 1.0) : 0.0);
+        }
+    }
+}
+
+/*! \brief Writes the settings and timings of all instances to a JSON file
+ *
+ * Times and rates per second are only written when the cycle counter could be
+ * calibrated, i.e. when \p secondsPerCycle > 0.
+ */
+void writeJsonResults(const std::string&             fileName,
+                      const PmeBenchSystem&          system,
+                      ArrayRef<const PmeBenchResult> results,
+                      int                            numIterations,
+                      bool                           computeEnergyAndVirial,
+                      double                         secondsPerCycle)
+{
+    FILE* fp = fopen(fileName.c_str(), "w");
+    if (fp == nullptr)
+    {
+        gmx_fatal(FARGS, "Could not open JSON output file '%s'", fileName.c_str());
+    }
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"atoms\": %zu,\n", system.coordinates.size());
+    fprintf(fp, "  \"iterations\": %d,\n", numIterations);
+    fprintf(fp, "  \"computeEnergies\": %s,\n", computeEnergyAndVirial ? "true" : "false");
+    fprintf(fp, "  \"benchmarks\": [\n");
+    for (gmx::index i = 0; i < results.ssize(); i++)
+    {
+        const PmeBenchResult& result = results[i];
+        fprintf(fp, "    {\n");
+        fprintf(fp, "      \"threads\": %d,\n", result.instance.numThreads);
+        fprintf(fp, "      \"order\": %d,\n", result.instance.pmeOrder);
+        fprintf(fp, "      \"spacing\": %g,\n", result.instance.gridSpacing);
+        fprintf(fp,
+                "      \"grid\": [%d, %d, %d],\n",
+                result.gridSize[XX],
+                result.gridSize[YY],
+                result.gridSize[ZZ]);
+        fprintf(fp, "      \"stages\": [\n");
+        for (auto stage : keysOf(result.stages))
+        {
+            const PmeBenchStageResult& stageResult = result.stages[stage];
+            fprintf(fp,
+                    "        { \"name\": \"%s\", \"cycles\": %.0f, \"flops\": %.6g, "
+                    "\"bytes\": %.6g",
+                    c_stageNames[stage],
+                    stageResult.cycles,
+                    stageResult.flops,
+                    stageResult.bytes);
+            if (secondsPerCycle > 0 && stageResult.cycles > 0)
+            {
+                const double seconds = stageResult.cycles * secondsPerCycle;
+                fprintf(fp, ", \"seconds\": %.6g", seconds);
+                fprintf(fp, ", \"flopsPerSecond\": %.6g", stageResult.flops / seconds);
+                fprintf(fp, ", \"bytesPerSecond\": %.6g", stageResult.bytes / seconds);
+            }
+            fprintf(fp, " }%s\n", stage != PmeBenchStage::Gather ? "," : "");
+        }
+        fprintf(fp, "      ]\n");
+        fprintf(fp, "    }%s\n", i + 1 < results.ssize() ? "," : "");
+    }
+    fprintf(fp, "  ]\n");
+    fprintf(fp, "}\n");
+
+    fclose(fp);
+}
+
+class PmeBenchmark : public ICommandLineOptionsModule
+{
+public:
+    PmeBenchmark() {}
+
+    // From ICommandLineOptionsModule
+    void init(CommandLineModuleSettings* /*settings*/) override {}
+    void initOptions(IOptionsContainer* options, ICommandLineOptionsModuleSettings* settings) override;
+    void optionsFinished() override {}
+    int  run() override;
+
+private:
+    std::string       tprFileName_;
+    std::string       jsonFileName_;
+    int               sizeFactor_          = 1;
+    std::vector<int>  numThreads_          = { 1 };
+    std::vector<int>  pmeOrders_           = { 4 };
+    std::vector<real> gridSpacings_        = { 0.12 };
+    int               numIterations_       = 100;
+    int               numWarmupIterations_ = 10;
+    bool              computeEnergy_       = false;
+};
+
+void PmeBenchmark::initOptions(IOptionsContainer* options, ICommandLineOptionsModuleSettings* settings)
+{
+    std::vector<const char*> desc = {
+        "[THISMODULE] times the stages of the CPU PME mesh part:",
+        "spreading the charges on the grid, including the computation of",
+        "the splines, the forward and backward 3D-FFTs, solving in reciprocal",
+        "space and gathering the forces. The same code path as in",
+        "[gmx-mdrun] is used, so the timings can be used to choose the",
+        "grid spacing, interpolation order and number of threads for PME",
+        "on a given machine without running simulations.[PAR]",
+        "The system is read from the run input file given with [TT]-s[tt].",
+        "Otherwise a system of 3000 times [TT]-size[tt] atoms with water",
+        "density, random positions and neutral groups of three charges",
+        "is generated. All combinations of the values given with",
+        "[TT]-nt[tt], [TT]-order[tt] and [TT]-spacing[tt] are run.",
+        "The grid sizes are chosen from the spacing as in [gmx-grompp].[PAR]",
+        "Each setup is run for [TT]-warmup[tt] untimed iterations, followed",
+        "by [TT]-iter[tt] timed iterations. For each stage the time per",
+        "iteration and estimates of the floating point and memory throughput",
+        "are reported. The flop counts are those of the flop accounting of",
+        "[gmx-mdrun], the memory traffic assumes that each grid point",
+        "and atom is accessed only as often as needed.",
+        "Times are reported in cycles when the cycle counter cannot be",
+        "calibrated. All timings can be written in JSON format to the file",
+        "given with [TT]-json[tt], which is intended for automated",
+        "performance regression testing.[PAR]",
+        "Thread affinity is important for the results. Affinities can be set",
+        "through the OpenMP library using, e.g., the OMP_PROC_BIND environment",
+        "variable."
+    };
+
+    settings->setHelpText(desc);
+
+    options->addOption(FileNameOption("s")
+                               .filetype(OptionFileType::RunInput)
+                               .inputFile()
+                               .store(&tprFileName_)
+                               .description("Run input file to take the system from"));
+    options->addOption(FileNameOption("json")
+                               .filetype(OptionFileType::Json)
+                               .outputFile()
+                               .store(&jsonFileName_)
+                               .defaultBasename("pme-benchmark")
+                               .description("Also output all timings in JSON format"));
+    options->addOption(IntegerOption("size").store(&sizeFactor_).description(
+            "The generated system size is 3000 atoms times this value"));
+    options->addOption(IntegerOption("nt").storeVector(&numThreads_).multiValue().description(
+            "The numbers of OpenMP threads to use"));
+    options->addOption(IntegerOption("order").storeVector(&pmeOrders_).multiValue().description(
+            "The PME interpolation orders"));
+    options->addOption(RealOption("spacing").storeVector(&gridSpacings_).multiValue().description(
+            "The maximum PME grid spacings"));
+    options->addOption(IntegerOption("iter").store(&numIterations_).description(
+            "The number of timed iterations for each setup"));
+    options->addOption(IntegerOption("warmup").store(&numWarmupIterations_).description(
+            "The number of untimed iterations before the timed iterations"));
+    options->addOption(BooleanOption("energy").store(&computeEnergy_).description(
+            "Compute the energy and virial in addition to the forces"));
+}
+
+int PmeBenchmark::run()
+{
+    if (!wallcycle_have_counter())
+    {
+        gmx_fatal(FARGS, "The PME benchmark requires a cycle counter, which is not available");
+    }
+    for (int numThreads : numThreads_)
+    {
+        if (numThreads < 1 || (!GMX_OPENMP && numThreads > 1))
+        {
+            gmx_fatal(FARGS,
+                      "Invalid number of threads %d%s",
+                      numThreads,
+                      GMX_OPENMP ? "" : ", only 1 thread is supported without OpenMP");
+        }
+    }
+    for (int pmeOrder : pmeOrders_)
+    {
+        // Orders above the maximum are rejected by gmx_pme_init()
+        if (pmeOrder < 3)
+        {
+            gmx_fatal(FARGS, "The PME order should be at least 3");
+        }
+    }
+
+    const PmeBenchSystem system =
+            tprFileName_.empty() ? generateSystem(3000 * sizeFactor_) : readSystem(tprFileName_);
+
+    fprintf(stdout, "System size:          %zu atoms\n", system.coordinates.size());
+    fprintf(stdout,
+            "Box:                  %g x %g x %g nm\n",
+            norm(system.box[XX]),
+            norm(system.box[YY]),
+            norm(system.box[ZZ]));
+    fprintf(stdout, "Number of iterations: %d\n", numIterations_);
+    fprintf(stdout, "Compute energies:     %s\n", computeEnergy_ ? "yes" : "no");
+    fprintf(stdout, "\n");
+
+    std::unique_ptr<gmx_wallcycle> wcycle = wallcycle_init(nullptr, 0, nullptr);
+
+    std::vector<PmeBenchResult> results;
+    for (int numThreads : numThreads_)
+    {
+        for (int pmeOrder : pmeOrders_)
+        {
+            for (real gridSpacing : gridSpacings_)
+            {
+                results.push_back(runInstance(system,
+                                              { numThreads, pmeOrder, gridSpacing },
+                                              numIterations_,
+                                              numWarmupIterations_,
+                                              computeEnergy_,
+                                              wcycle.get()));
+            }
+        }
+    }
+
+    // Returns a negative value when calibration is not supported
+    const double secondsPerCycle = gmx_cycles_calibrate(1.0);
+
+    printResults(results, numIterations_, secondsPerCycle);
+    if (!jsonFileName_.empty())
+    {
+        writeJsonResults(
+                jsonFileName_, system, results, numIterations_, computeEnergy_, secondsPerCycle);
+    }
+
+    return 0;
+}
+
+} // namespace
+
+const char PmeBenchmarkInfo::name[]             = "pme-benchmark";
+const char PmeBenchmarkInfo::shortDescription[] = "Benchmarking tool for the PME mesh part.";
+
+ICommandLineOptionsModulePointer PmeBenchmarkInfo::create()
+{
+    return ICommandLineOptionsModulePointer(std::make_unique<PmeBenchmark>());
+}
+
+} // namespace gmx
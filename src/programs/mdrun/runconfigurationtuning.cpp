@@ -0,0 +1,467 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Implements the tuning of the run configuration with mdrun -tune
+ *
+ * \ingroup module_mdrun
+ */
+#include "gmxpre.h"
+
+#include "runconfigurationtuning.h"
+
+#include "config.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "gromacs/commandline/filenm.h"
+#include "gromacs/domdec/options.h"
+#include "gromacs/hardware/hw_info.h"
+#include "gromacs/mdrun/legacymdrunoptions.h"
+#include "gromacs/utility/basedefinitions.h"
+#include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/path.h"
+#include "gromacs/utility/stringutil.h"
+#include "gromacs/utility/textreader.h"
+#include "gromacs/utility/textwriter.h"
+
+namespace gmx
+{
+
+namespace
+{
+
+//! The largest number of thread-MPI ranks that is tried
+constexpr int c_maxNumThreadMpiRanks = 64;
+
+//! Returns the configuration given by the user options
+RunConfiguration userRunConfiguration(const LegacyMdrunOptions& options)
+{
+    return { options.hw_opt.nthreads_tmpi,    options.hw_opt.nthreads_omp,
+             options.domdecOptions.numPmeRanks, options.nbpu_opt_choices[0],
+             options.pme_opt_choices[0],        options.bonded_opt_choices[0],
+             options.update_opt_choices[0] };
+}
+
+/*! \brief Returns the performance in ns/day reported in the log file \p logFileName
+ *
+ * Returns 0 when the log file does not report the performance.
+ */
+double readPerformance(const std::string& logFileName)
+{
+    double performance = 0;
+    const std::string logFileContents = TextReader::readFileToString(logFileName);
+    for (const std::string& line : splitDelimitedString(logFileContents, '\n'))
+    {
+        const std::vector<std::string> fields = splitString(line);
+        /* The ns/day value is the second last entry, also with GMX_DETAILED_PERF_STATS */
+        if (fields.size() >= 3 && fields[0] == "Performance:")
+        {
+            performance = std::stod(fields[fields.size() - 2]);
+        }
+    }
+    return performance;
+}
+
+//! Generates the candidate configurations of a tuning stage from the best configuration so far
+using CandidateGenerator =
+        std::function<std::vector<RunConfiguration>(const RunConfiguration& best)>;
+
+/*! \brief Returns the tuning stages, each varies one aspect of the configuration
+ *
+ * Aspects that the user set explicitly, or which are not available, are not varied.
+ */
+std::vector<CandidateGenerator> tuningStages(MPI_Comm                  communicator,
+                                             const gmx_hw_info_t&      hwinfo,
+                                             const LegacyMdrunOptions& userOptions)
+{
+    std::vector<CandidateGenerator> stages;
+
+    const gmx_hw_opt_t& hw_opt = userOptions.hw_opt;
+    if (GMX_THREAD_MPI && hw_opt.nthreads_tmpi == 0 && hw_opt.nthreads_omp == 0)
+    {
+        const int numThreads =
+                (hw_opt.nthreads_tot > 0 ? hw_opt.nthreads_tot : hwinfo.nthreads_hw_avail);
+        stages.emplace_back([numThreads](const RunConfiguration& best) {
+            std::vector<RunConfiguration> candidates;
+            const int maxNumRanks = std::min(numThreads, c_maxNumThreadMpiRanks);
+            for (int numRanks = 1; numRanks <= maxNumRanks; numRanks *= 2)
+            {
+                if (numThreads % numRanks == 0)
+                {
+                    RunConfiguration candidate  = best;
+                    candidate.numThreadMpiRanks = numRanks;
+                    candidate.numOpenMPThreads  = numThreads / numRanks;
+                    candidates.push_back(candidate);
+                }
+            }
+            return candidates;
+        });
+    }
+
+    if (hwinfo.ngpu_compatible_tot > 0)
+    {
+        if (std::string(userOptions.nbpu_opt_choices[0]) == "auto")
+        {
+            stages.emplace_back([](const RunConfiguration& best) {
+                /* The other tasks can only be offloaded together with the nonbondeds */
+                RunConfiguration onCpu = best;
+                onCpu.nonbonded        = "cpu";
+                onCpu.pme              = "cpu";
+                onCpu.bonded           = "cpu";
+                onCpu.update           = "cpu";
+                RunConfiguration onGpu = best;
+                onGpu.nonbonded        = "gpu";
+                return std::vector<RunConfiguration>{ onGpu, onCpu };
+            });
+        }
+        const std::array<std::pair<const char*, std::string RunConfiguration::*>, 3> tasks = {
+            { { userOptions.pme_opt_choices[0], &RunConfiguration::pme },
+              { userOptions.bonded_opt_choices[0], &RunConfiguration::bonded },
+              { userOptions.update_opt_choices[0], &RunConfiguration::update } }
+        };
+        for (const auto& task : tasks)
+        {
+            if (std::string(task.first) != "auto")
+            {
+                continue;
+            }
+            const auto member = task.second;
+            stages.emplace_back([member](const RunConfiguration& best) {
+                std::vector<RunConfiguration> candidates;
+                if (best.nonbonded != "cpu")
+                {
+                    for (const char* choice : { "gpu", "cpu" })
+                    {
+                        RunConfiguration candidate = best;
+                        candidate.*member          = choice;
+                        candidates.push_back(candidate);
+                    }
+                }
+                return candidates;
+            });
+        }
+    }
+
+    if (userOptions.domdecOptions.numPmeRanks == -1)
+    {
+        int numRanks = 1;
+#if GMX_LIB_MPI
+        MPI_Comm_size(communicator, &numRanks);
+#else
+        GMX_UNUSED_VALUE(communicator);
+#endif
+        stages.emplace_back([numRanks](const RunConfiguration& best) {
+            std::vector<RunConfiguration> candidates;
+            const int numRanksOfBest = (GMX_THREAD_MPI ? best.numThreadMpiRanks : numRanks);
+            if (numRanksOfBest > 1)
+            {
+                for (const int numPmeRanks : { 0, 1, numRanksOfBest / 4 })
+                {
+                    RunConfiguration candidate = best;
+                    candidate.numPmeRanks      = numPmeRanks;
+                    candidates.push_back(candidate);
+                }
+            }
+            return candidates;
+        });
+    }
+
+    return stages;
+}
+
+} // namespace
+
+std::string mdrunArguments(const RunConfiguration& configuration)
+{
+    std::string arguments;
+    if (configuration.numThreadMpiRanks > 0)
+    {
+        arguments += formatString("-ntmpi %d ", configuration.numThreadMpiRanks);
+    }
+    if (configuration.numOpenMPThreads > 0)
+    {
+        arguments += formatString("-ntomp %d ", configuration.numOpenMPThreads);
+    }
+    arguments += formatString("-npme %d -nb %s -pme %s -bonded %s -update %s",
+                              configuration.numPmeRanks,
+                              configuration.nonbonded.c_str(),
+                              configuration.pme.c_str(),
+                              configuration.bonded.c_str(),
+                              configuration.update.c_str());
+    return arguments;
+}
+
+std::string checkRunConfiguration(const RunConfiguration& configuration, const int numMpiRanks)
+{
+    if (!GMX_THREAD_MPI && configuration.numThreadMpiRanks > 0)
+    {
+        return "setting the number of thread-MPI ranks requires thread-MPI";
+    }
+    if (!GMX_OPENMP && configuration.numOpenMPThreads > 1)
+    {
+        return "more than one OpenMP thread requires OpenMP support";
+    }
+    if (configuration.nonbonded == "cpu"
+        && (configuration.pme == "gpu" || configuration.bonded == "gpu"
+            || configuration.update == "gpu"))
+    {
+        return "PME, bonded and update can only run on a GPU together with the nonbonded "
+               "interactions";
+    }
+    if (GMX_THREAD_MPI && configuration.numThreadMpiRanks <= 0)
+    {
+        /* The number of ranks is only known after the automated setup */
+        return configuration.numPmeRanks > 0
+                       ? "separate PME ranks require setting the number of thread-MPI ranks"
+                       : "";
+    }
+    const int numRanks = (GMX_THREAD_MPI ? configuration.numThreadMpiRanks : numMpiRanks);
+    if (configuration.numPmeRanks > numRanks - configuration.numPmeRanks)
+    {
+        return formatString("%d separate PME ranks are more than the %d PP ranks",
+                            configuration.numPmeRanks,
+                            numRanks - configuration.numPmeRanks);
+    }
+    if (configuration.pme == "gpu"
+        && ((numRanks > 1 && configuration.numPmeRanks == 0) || configuration.numPmeRanks > 1))
+    {
+        return "PME on a GPU requires a single rank or a single separate PME rank";
+    }
+    if (configuration.update == "gpu" && configuration.numPmeRanks > 0
+        && configuration.pme == "cpu")
+    {
+        return "update on a GPU with separate PME ranks requires PME on a GPU";
+    }
+    return "";
+}
+
+int tuneRunConfiguration(MPI_Comm                    communicator,
+                         const gmx_hw_info_t&        hwinfo,
+                         ArrayRef<const std::string> arguments,
+                         ArrayRef<const char*>       desc,
+                         const LegacyMdrunOptions&   userOptions,
+                         const MdrunFunction&        runMdrun)
+{
+    int rank     = 0;
+    int numRanks = 1;
+#if GMX_LIB_MPI
+    MPI_Comm_rank(communicator, &rank);
+    MPI_Comm_size(communicator, &numRanks);
+#endif
+    const bool isMaster = (rank == 0);
+
+    if (opt2bSet("-multidir", ssize(userOptions.filenames), userOptions.filenames.data())
+        || userOptions.mdrunOptions.rerun)
+    {
+        GMX_THROW(InconsistentInputError("mdrun -tune is not supported with -multidir or -rerun"));
+    }
+
+    /* The performance of each configuration that was run, indexed by its arguments */
+    std::map<std::string, double> performances;
+    std::vector<std::string>      trials;
+
+    auto runTrial = [&](const RunConfiguration& configuration) {
+        const std::string configurationArguments = mdrunArguments(configuration);
+        const auto        previousResult         = performances.find(configurationArguments);
+        if (previousResult != performances.end())
+        {
+            return previousResult->second;
+        }
+        const int trial = ssize(trials);
+        trials.push_back(configurationArguments);
+
+        /* Invalid configurations would give fatal errors, which can not be recovered from */
+        const std::string invalidReason = checkRunConfiguration(configuration, numRanks);
+        if (!invalidReason.empty())
+        {
+            if (isMaster)
+            {
+                fprintf(stderr,
+                        "\nTuning trial %d skipped: %s: %s\n",
+                        trial,
+                        configurationArguments.c_str(),
+                        invalidReason.c_str());
+            }
+            performances[configurationArguments] = 0;
+            return 0.0;
+        }
+
+        if (isMaster)
+        {
+            fprintf(stderr, "\nTuning trial %d: %s\n", trial, configurationArguments.c_str());
+        }
+        std::vector<std::string> otherOutputFileNames;
+        double                   performance = 0;
+        bool                     failed      = false;
+        try
+        {
+            /* Parse the arguments again, since the options can only be filled by parsing.
+             * The parsing changes the arguments, so it is given a copy.
+             */
+            std::vector<std::string> argumentsCopy(arguments.begin(), arguments.end());
+            std::vector<char*>       argv;
+            for (std::string& argument : argumentsCopy)
+            {
+                argv.push_back(argument.data());
+            }
+            argv.push_back(nullptr);
+            LegacyMdrunOptions options;
+            options.updateFromCommandLine(ssize(argumentsCopy), argv.data(), desc);
+            options.hw_opt.nthreads_tmpi                    = configuration.numThreadMpiRanks;
+            options.hw_opt.nthreads_omp                     = configuration.numOpenMPThreads;
+            options.mdrunOptions.ntompOptionIsSet           = (configuration.numOpenMPThreads > 0);
+            options.domdecOptions.numPmeRanks               = configuration.numPmeRanks;
+            options.nbpu_opt_choices[0]                     = configuration.nonbonded.c_str();
+            options.pme_opt_choices[0]                      = configuration.pme.c_str();
+            options.bonded_opt_choices[0]                   = configuration.bonded.c_str();
+            options.update_opt_choices[0]                   = configuration.update.c_str();
+            options.mdrunOptions.numStepsCommandline        = userOptions.tuneNumSteps;
+            options.mdrunOptions.timingOptions.resetHalfway = true;
+            options.mdrunOptions.writeConfout               = false;
+            options.mdrunOptions.checkpointOptions.period   = -1;
+
+            /* Start from the run input file and write all output to files of this trial */
+            std::string logFileName;
+            for (t_filenm& filename : options.filenames)
+            {
+                if (filename.opt != nullptr && std::strcmp(filename.opt, "-cpi") == 0)
+                {
+                    filename.flag &= ~(ffSET);
+                    filename.filenames.clear();
+                }
+                else if (is_output(&filename) && (!is_optional(&filename) || is_set(&filename))
+                         && std::strcmp(filename.opt, "-tuneout") != 0)
+                {
+                    const std::string name = Path::concatenateBeforeExtension(
+                            filename.filenames[0], formatString("_tune%d", trial));
+                    filename.filenames = { name };
+                    filename.flag |= ffSET;
+                    if (std::strcmp(filename.opt, "-g") == 0)
+                    {
+                        logFileName = name;
+                    }
+                    else
+                    {
+                        otherOutputFileNames.push_back(name);
+                    }
+                }
+            }
+
+            failed = (runMdrun(&options) != 0);
+            if (!failed && isMaster)
+            {
+                performance = readPerformance(logFileName);
+            }
+        }
+        catch (const std::exception& ex)
+        {
+            fprintf(stderr, "Tuning trial %d failed on rank %d: %s\n", trial, rank, ex.what());
+            failed = true;
+        }
+        /* The ranks need to agree on the outcome, since a trial can fail on only some ranks */
+        std::array<double, 2> outcome = { { performance, failed ? 1.0 : 0.0 } };
+#if GMX_LIB_MPI
+        MPI_Allreduce(
+                MPI_IN_PLACE, outcome.data(), outcome.size(), MPI_DOUBLE, MPI_MAX, communicator);
+#endif
+        performance = (outcome[1] > 0 ? 0 : outcome[0]);
+        if (isMaster)
+        {
+            for (const std::string& name : otherOutputFileNames)
+            {
+                std::remove(name.c_str());
+            }
+        }
+
+        performances[configurationArguments] = performance;
+        return performance;
+    };
+
+    RunConfiguration best            = userRunConfiguration(userOptions);
+    double           bestPerformance = runTrial(best);
+    for (const CandidateGenerator& stage : tuningStages(communicator, hwinfo, userOptions))
+    {
+        for (const RunConfiguration& candidate : stage(best))
+        {
+            const double performance = runTrial(candidate);
+            if (performance > bestPerformance)
+            {
+                best            = candidate;
+                bestPerformance = performance;
+            }
+        }
+    }
+
+    if (bestPerformance <= 0)
+    {
+        GMX_THROW(InternalError(
+                "None of the mdrun -tune trials reported a performance, see their log files"));
+    }
+
+    if (isMaster)
+    {
+        fprintf(stderr,
+                "\nTuning results over %d steps per trial, timed over the second half:\n",
+                userOptions.tuneNumSteps);
+        fprintf(stderr, "%5s %10s  %s\n", "Trial", "ns/day", "mdrun arguments");
+        for (size_t trial = 0; trial < trials.size(); trial++)
+        {
+            fprintf(stderr,
+                    "%5zu %10.3f  %s\n",
+                    trial,
+                    performances[trials[trial]],
+                    trials[trial].c_str());
+        }
+        const std::string bestArguments = mdrunArguments(best);
+        fprintf(stderr, "\nThe fastest configuration is:\n  %s\n", bestArguments.c_str());
+        const char* tuneOutputFileName =
+                opt2fn("-tuneout", ssize(userOptions.filenames), userOptions.filenames.data());
+        TextWriter::writeFileFromString(tuneOutputFileName, bestArguments + "\n");
+        fprintf(stderr, "The mdrun arguments have been written to %s\n", tuneOutputFileName);
+    }
+
+    return 0;
+}
+
+} // namespace gmx
@@ -0,0 +1,127 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Declares the tuning of the run configuration with mdrun -tune
+ *
+ * \ingroup module_mdrun
+ */
+#ifndef GMX_PROGRAMS_MDRUN_RUNCONFIGURATIONTUNING_H
+#define GMX_PROGRAMS_MDRUN_RUNCONFIGURATIONTUNING_H
+
+#include <functional>
+#include <string>
+
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/gmxmpi.h"
+
+struct gmx_hw_info_t;
+
+namespace gmx
+{
+
+class LegacyMdrunOptions;
+
+//! A configuration of the run that is varied by the tuning
+struct RunConfiguration
+{
+    //! The number of thread-MPI ranks, 0 is automatic
+    int numThreadMpiRanks;
+    //! The number of OpenMP threads per rank, 0 is automatic
+    int numOpenMPThreads;
+    //! The number of separate PME ranks, -1 is automatic
+    int numPmeRanks;
+    //! Where to compute the nonbonded interactions
+    std::string nonbonded;
+    //! Where to compute PME
+    std::string pme;
+    //! Where to compute the bonded interactions
+    std::string bonded;
+    //! Where to compute update and constraints
+    std::string update;
+};
+
+//! Returns the mdrun command-line arguments for \p configuration
+std::string mdrunArguments(const RunConfiguration& configuration);
+
+/*! \brief Checks whether mdrun can run with \p configuration
+ *
+ * Detects the combinations that mdrun rejects with a fatal error, which
+ * would abort the whole tuning instead of only the trial.
+ * Settings that are automatic are assumed to be resolved consistently.
+ *
+ * \param[in] configuration  The configuration to check
+ * \param[in] numMpiRanks    The number of MPI ranks, not used with thread-MPI
+ * \returns an empty string when the configuration is valid, the reason otherwise
+ */
+std::string checkRunConfiguration(const RunConfiguration& configuration, int numMpiRanks);
+
+//! Runs mdrun in this process with the parsed options and returns the exit code
+using MdrunFunction = std::function<int(LegacyMdrunOptions* options)>;
+
+/*! \brief Tunes the thread, rank and GPU offload setup with short mdrun runs
+ *
+ * Runs \p runMdrun for a sequence of candidate configurations, varying
+ * the thread-MPI and OpenMP thread counts, the offload of the nonbonded,
+ * PME, bonded and update tasks and the number of separate PME ranks
+ * one at a time, while keeping the fastest choice of the earlier ones.
+ * Options the user set explicitly are not varied. Configurations that
+ * checkRunConfiguration() rejects are not run. A trial that throws on
+ * any rank counts as failed on all ranks. Each run is
+ * started from freshly parsed \p arguments, writes its output files with
+ * _tune<trial> added to their names and is timed over the second half of
+ * its steps. All output files except the log file are removed afterwards.
+ * The performance of each run is read from its log file. The fastest
+ * configuration is printed and written as mdrun arguments to the
+ * file of the -tuneout option.
+ *
+ * \param[in] communicator  The communicator of all mdrun processes
+ * \param[in] hwinfo        The detected hardware
+ * \param[in] arguments     The command-line arguments of mdrun
+ * \param[in] desc          The mdrun help text, needed for parsing
+ * \param[in] userOptions   The options parsed from \p arguments
+ * \param[in] runMdrun      Function that runs mdrun with parsed options
+ * \returns the exit code for mdrun
+ */
+int tuneRunConfiguration(MPI_Comm                    communicator,
+                         const gmx_hw_info_t&        hwinfo,
+                         ArrayRef<const std::string> arguments,
+                         ArrayRef<const char*>       desc,
+                         const LegacyMdrunOptions&   userOptions,
+                         const MdrunFunction&        runMdrun);
+
+} // namespace gmx
+
+#endif
@@ -48,6 +48,7 @@
 
 #include "testutils/refdata.h"
 #include "testutils/testasserts.h"
+#include "testutils/testfilemanager.h"
 
 #include "moduletest.h"
 
@@ -68,6 +69,40 @@ TEST(NonbondedBenchTest, BasicEndToEndTest)
                       &gmx::NonbondedBenchmarkInfo::create, &cmdline));
 }
 
+TEST(NonbondedBenchTest, ReportsTimeOrFallsBackToCycles)
+{
+    const char* const command[] = { "nonbonded-benchmark" };
+    CommandLine       cmdline(command);
+    cmdline.addOption("-iter", 1);
+    cmdline.addOption("-time");
+    cmdline.addOption("-search");
+    EXPECT_EQ(0,
+              gmx::test::CommandLineTestHelper::runModuleFactory(
+                      &gmx::NonbondedBenchmarkInfo::create, &cmdline));
+}
+
+TEST(NonbondedBenchTest, SearchAndBufferOpsWithJsonOutput)
+{
+    TestFileManager   fileManager;
+    const std::string jsonFileName = fileManager.getTemporaryFilePath(".json");
+
+    const char* const command[] = { "nonbonded-benchmark" };
+    CommandLine       cmdline(command);
+    cmdline.addOption("-iter", 1);
+    cmdline.addOption("-search");
+    cmdline.addOption("-json", jsonFileName);
+    EXPECT_EQ(0,
+              gmx::test::CommandLineTestHelper::runModuleFactory(
+                      &gmx::NonbondedBenchmarkInfo::create, &cmdline));
+
+    const std::string json = TextReader::readFileToString(jsonFileName);
+    for (const char* stage : { "kernel", "search", "x-buffer-ops", "f-buffer-ops" })
+    {
+        EXPECT_NE(json.find(formatString("\"name\": \"%s\"", stage)), std::string::npos)
+                << "JSON output should contain stage " << stage;
+    }
+}
+
 } // namespace
 } // namespace test
 } // namespace gmx
@@ -0,0 +1,98 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2021, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * This implements basic PME bench tests.
+ *
+ * \ingroup module_mdrun_integration_tests
+ */
+#include "gmxpre.h"
+
+#include "programs/mdrun/pme_bench.h"
+
+#include "gromacs/utility/stringutil.h"
+#include "gromacs/utility/textreader.h"
+
+#include "testutils/cmdlinetest.h"
+#include "testutils/testasserts.h"
+#include "testutils/testfilemanager.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+TEST(PmeBenchTest, BasicEndToEndTest)
+{
+    const char* const command[] = { "pme-benchmark" };
+    CommandLine       cmdline(command);
+    cmdline.addOption("-iter", 1);
+    cmdline.addOption("-warmup", 0);
+    EXPECT_EQ(0,
+              gmx::test::CommandLineTestHelper::runModuleFactory(&gmx::PmeBenchmarkInfo::create,
+                                                                 &cmdline));
+}
+
+TEST(PmeBenchTest, SweepWithJsonOutput)
+{
+    TestFileManager   fileManager;
+    const std::string jsonFileName = fileManager.getTemporaryFilePath(".json");
+
+    const char* const command[] = {
+        "pme-benchmark", "-order", "4", "5", "-spacing", "0.12", "0.16"
+    };
+    CommandLine       cmdline(command);
+    cmdline.addOption("-iter", 1);
+    cmdline.addOption("-warmup", 0);
+    cmdline.addOption("-json", jsonFileName);
+    EXPECT_EQ(0,
+              gmx::test::CommandLineTestHelper::runModuleFactory(&gmx::PmeBenchmarkInfo::create,
+                                                                 &cmdline));
+
+    const std::string json = TextReader::readFileToString(jsonFileName);
+    for (const char* stage : { "spread", "fft", "solve", "gather" })
+    {
+        EXPECT_NE(json.find(formatString("\"name\": \"%s\"", stage)), std::string::npos)
+                << "JSON output should contain stage " << stage;
+    }
+    EXPECT_NE(json.find("\"order\": 5"), std::string::npos);
+    EXPECT_NE(json.find("\"spacing\": 0.16"), std::string::npos);
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
@@ -0,0 +1,251 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright (c) 2022, by the GROMACS development team, led by
+ * Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+ * and including many others, as listed in the AUTHORS file in the
+ * top-level source directory and at http://www.gromacs.org.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * http://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at http://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out http://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests the run configuration tuning of mdrun -tune
+ *
+ * \ingroup module_mdrun
+ */
+#include "gmxpre.h"
+
+#include "programs/mdrun/runconfigurationtuning.h"
+
+#include "config.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/commandline/filenm.h"
+#include "gromacs/hardware/cpuinfo.h"
+#include "gromacs/hardware/hardwaretopology.h"
+#include "gromacs/hardware/hw_info.h"
+#include "gromacs/mdrun/legacymdrunoptions.h"
+#include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/stringutil.h"
+#include "gromacs/utility/textreader.h"
+#include "gromacs/utility/textwriter.h"
+
+#include "testutils/cmdlinetest.h"
+#include "testutils/testasserts.h"
+#include "testutils/testfilemanager.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+/*! \brief Returns a configuration with \p numRanks ranks of which \p numPmeRanks do only PME
+ *
+ * The number of ranks is set as thread-MPI ranks only with thread-MPI,
+ * otherwise it is passed to checkRunConfiguration() as the number of MPI ranks.
+ */
+RunConfiguration configurationWithRanks(int numRanks, int numPmeRanks)
+{
+    return { GMX_THREAD_MPI ? numRanks : 0, 0, numPmeRanks, "auto", "auto", "auto", "auto" };
+}
+
+TEST(RunConfigurationTest, ArgumentsContainOnlyTheSetThreadCounts)
+{
+    EXPECT_EQ("-npme -1 -nb auto -pme auto -bonded auto -update auto",
+              mdrunArguments({ 0, 0, -1, "auto", "auto", "auto", "auto" }));
+    EXPECT_EQ("-ntmpi 2 -ntomp 4 -npme 1 -nb gpu -pme gpu -bonded cpu -update gpu",
+              mdrunArguments({ 2, 4, 1, "gpu", "gpu", "cpu", "gpu" }));
+}
+
+TEST(RunConfigurationTest, AcceptsValidConfigurations)
+{
+    EXPECT_EQ("", checkRunConfiguration({ 0, 0, -1, "auto", "auto", "auto", "auto" }, 1));
+    EXPECT_EQ("", checkRunConfiguration(configurationWithRanks(1, 0), 1));
+    EXPECT_EQ("", checkRunConfiguration(configurationWithRanks(2, 1), 2));
+    EXPECT_EQ("", checkRunConfiguration(configurationWithRanks(8, 2), 8));
+    EXPECT_EQ("", checkRunConfiguration({ 0, 0, 0, "cpu", "cpu", "cpu", "cpu" }, 1));
+    RunConfiguration pmeOnGpu = configurationWithRanks(4, 1);
+    pmeOnGpu.nonbonded        = "gpu";
+    pmeOnGpu.pme              = "gpu";
+    pmeOnGpu.update           = "gpu";
+    EXPECT_EQ("", checkRunConfiguration(pmeOnGpu, 4));
+}
+
+TEST(RunConfigurationTest, RejectsOffloadWithoutNonbondedOnGpu)
+{
+    EXPECT_NE("", checkRunConfiguration({ 0, 0, -1, "cpu", "gpu", "auto", "auto" }, 1));
+    EXPECT_NE("", checkRunConfiguration({ 0, 0, -1, "cpu", "auto", "gpu", "auto" }, 1));
+    EXPECT_NE("", checkRunConfiguration({ 0, 0, -1, "cpu", "auto", "auto", "gpu" }, 1));
+}
+
+TEST(RunConfigurationTest, RejectsMorePmeRanksThanPpRanks)
+{
+    EXPECT_NE("", checkRunConfiguration(configurationWithRanks(1, 1), 1));
+    EXPECT_NE("", checkRunConfiguration(configurationWithRanks(4, 3), 4));
+}
+
+TEST(RunConfigurationTest, RejectsPmeOnGpuWithMultiplePmeRanks)
+{
+    RunConfiguration configuration = configurationWithRanks(4, 2);
+    configuration.nonbonded        = "gpu";
+    configuration.pme              = "gpu";
+    EXPECT_NE("", checkRunConfiguration(configuration, 4));
+    configuration.numPmeRanks = 0;
+    EXPECT_NE("", checkRunConfiguration(configuration, 4));
+}
+
+TEST(RunConfigurationTest, RejectsUpdateOnGpuWithPmeRanksOnCpu)
+{
+    RunConfiguration configuration = configurationWithRanks(4, 1);
+    configuration.nonbonded        = "gpu";
+    configuration.pme              = "cpu";
+    configuration.update           = "gpu";
+    EXPECT_NE("", checkRunConfiguration(configuration, 4));
+}
+
+TEST(RunConfigurationTest, RejectsThreadCountsThatTheBuildDoesNotSupport)
+{
+    if (!GMX_THREAD_MPI)
+    {
+        EXPECT_NE("", checkRunConfiguration({ 2, 0, -1, "auto", "auto", "auto", "auto" }, 2));
+    }
+    if (!GMX_OPENMP)
+    {
+        EXPECT_NE("", checkRunConfiguration({ 0, 2, -1, "auto", "auto", "auto", "auto" }, 1));
+    }
+    if (GMX_THREAD_MPI)
+    {
+        EXPECT_NE("", checkRunConfiguration({ 0, 0, 1, "auto", "auto", "auto", "auto" }, 1));
+    }
+}
+
+//! Test fixture that runs the tuning with an mdrun that only writes a log file
+class TuneRunConfigurationTest : public ::testing::Test
+{
+public:
+    TuneRunConfigurationTest() :
+        hwinfo_(std::unique_ptr<CpuInfo>(), std::unique_ptr<HardwareTopology>()),
+        tuneOutputFileName_(fileManager_.getTemporaryFilePath("tune.out"))
+    {
+        hwinfo_.nthreads_hw_avail   = 4;
+        hwinfo_.ngpu_compatible_tot = 0;
+
+        const std::string tprFileName = fileManager_.getTemporaryFilePath("topol.tpr");
+        TextWriter::writeFileFromString(tprFileName, "");
+        arguments_ = { "mdrun",
+                       "-s",
+                       tprFileName,
+                       "-deffnm",
+                       fileManager_.getTemporaryFilePath("tune"),
+                       "-tune",
+                       "-tuneout",
+                       tuneOutputFileName_ };
+    }
+
+    /*! \brief Tunes with \p extraArguments added, with \p performance giving the
+     * ns/day of a trial and throwing for trials that fail
+     */
+    void tune(const std::vector<std::string>&                       extraArguments,
+              const std::function<double(const RunConfiguration&)>& performance)
+    {
+        arguments_.insert(arguments_.end(), extraArguments.begin(), extraArguments.end());
+        CommandLine        commandLine(arguments_);
+        LegacyMdrunOptions userOptions;
+        ASSERT_EQ(1, userOptions.updateFromCommandLine(commandLine.argc(), commandLine.argv(), {}));
+
+        auto runMdrun = [this, &performance](LegacyMdrunOptions* options) {
+            const RunConfiguration configuration = { options->hw_opt.nthreads_tmpi,
+                                                     options->hw_opt.nthreads_omp,
+                                                     options->domdecOptions.numPmeRanks,
+                                                     options->nbpu_opt_choices[0],
+                                                     options->pme_opt_choices[0],
+                                                     options->bonded_opt_choices[0],
+                                                     options->update_opt_choices[0] };
+            EXPECT_EQ("", checkRunConfiguration(configuration, 1));
+            runConfigurations_.push_back(mdrunArguments(configuration));
+            const char* logFileName =
+                    opt2fn("-g", ssize(options->filenames), options->filenames.data());
+            TextWriter::writeFileFromString(
+                    logFileName,
+                    formatString("Performance:   %.3f   %.3f\n", performance(configuration), 1.0));
+            return 0;
+        };
+        tuneRunConfiguration(MPI_COMM_WORLD, hwinfo_, arguments_, {}, userOptions, runMdrun);
+    }
+
+    //! Manages the temporary files
+    TestFileManager fileManager_;
+    //! The hardware seen by the tuning
+    gmx_hw_info_t hwinfo_;
+    //! The file the tuning writes the fastest configuration to
+    std::string tuneOutputFileName_;
+    //! The mdrun command line
+    std::vector<std::string> arguments_;
+    //! The mdrun arguments of the configurations that were run
+    std::vector<std::string> runConfigurations_;
+};
+
+TEST_F(TuneRunConfigurationTest, FindsTheFastestConfigurationDespiteFailedTrials)
+{
+    if (!GMX_THREAD_MPI || !GMX_OPENMP)
+    {
+        GTEST_SKIP() << "Tuning the thread counts requires thread-MPI and OpenMP";
+    }
+    tune({}, [](const RunConfiguration& configuration) {
+        if (configuration.numThreadMpiRanks == 4)
+        {
+            GMX_THROW(InconsistentInputError("Too many ranks"));
+        }
+        return configuration.numThreadMpiRanks * 10.0 + (configuration.numPmeRanks == 1 ? 5 : 0);
+    });
+
+    EXPECT_EQ("-ntmpi 2 -ntomp 2 -npme 1 -nb auto -pme auto -bonded auto -update auto\n",
+              TextReader::readFileToString(tuneOutputFileName_));
+    /* The configuration of the user, three rank counts and two new PME rank counts */
+    EXPECT_EQ(6, ssize(runConfigurations_));
+}
+
+TEST_F(TuneRunConfigurationTest, DoesNotRunInvalidConfigurations)
+{
+    EXPECT_THROW_GMX(
+            tune({ "-ntmpi", "1", "-npme", "1" }, [](const RunConfiguration&) { return 1.0; }),
+            InternalError);
+    EXPECT_TRUE(runConfigurations_.empty());
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
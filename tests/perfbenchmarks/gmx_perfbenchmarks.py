@@ -0,0 +1,293 @@
+#
+# This file is part of the GROMACS molecular simulation package.
+#
+# Copyright (c) 2021, by the GROMACS development team, led by
+# Mark Abraham, David van der Spoel, Berk Hess, and Erik Lindahl,
+# and including many others, as listed in the AUTHORS file in the
+# top-level source directory and at http://www.gromacs.org.
+#
+# GROMACS is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public License
+# as published by the Free Software Foundation; either version 2.1
+# of the License, or (at your option) any later version.
+#
+# GROMACS is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with GROMACS; if not, see
+# http://www.gnu.org/licenses, or write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+#
+# If you want to redistribute modifications to GROMACS, please
+# consider that scientific software is very special. Version
+# control is crucial - bugs must be traceable. We will be happy to
+# consider code for inclusion in the official version, but we are
+# not obligated to accept it.  Commercially, this program is
+# distributed under the terms of the GNU Lesser General Public License
+# version 2.1 or later.
+#
+# To help us fund GROMACS development, we humbly ask that you cite
+# the research papers on the package. Check out http://www.gromacs.org.
+
+"""Performance regression benchmarks for GROMACS mdrun.
+
+Builds a set of benchmark systems from the inputs of the physical
+validation suite, runs each of them a number of times with the
+performance counters reset halfway (mdrun -resethway), and collects
+the ns/day reported in the log files. The results are written to a
+json file and, optionally, compared against a stored baseline. A
+system counts as regressed when its mean performance dropped by more
+than the relative tolerance and by more than the requested number of
+standard errors of the difference.
+"""
+
+import sys
+import os
+import shutil
+import json
+import argparse
+import math
+import re
+import socket
+import subprocess
+
+
+def run_gmx(gmx, args, cwd, verbose=False):
+    command = [gmx] + args
+    if verbose:
+        print(' '.join(command))
+    result = subprocess.run(command, cwd=cwd,
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            universal_newlines=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout)
+        raise RuntimeError('Command failed: ' + ' '.join(command))
+    return result.stdout
+
+
+def scale_molecule_counts(top_file, factor):
+    """Multiplies all molecule counts in the [ molecules ] section by factor."""
+    with open(top_file) as f:
+        lines = f.readlines()
+    in_molecules = False
+    for i, line in enumerate(lines):
+        stripped = line.split(';')[0].strip()
+        if stripped.startswith('['):
+            in_molecules = (stripped.replace(' ', '') == '[molecules]')
+            continue
+        if in_molecules and stripped:
+            name, count = stripped.split()[:2]
+            lines[i] = '{:s} {:d}\n'.format(name, int(count) * factor)
+    with open(top_file, 'w') as f:
+        f.writelines(lines)
+
+
+def write_benchmark_mdp(input_mdp, output_mdp, nsteps):
+    """Copies input_mdp with the run length set and with output reduced to a minimum."""
+    overrides = {
+        'nsteps': str(nsteps),
+        'nstcalcenergy': '100',
+        'nstenergy': '0',
+        'nstlog': '0',
+        'nstxout': '0',
+        'nstvout': '0',
+        'nstfout': '0',
+        'nstxout-compressed': '0',
+    }
+    with open(input_mdp) as f:
+        lines = f.readlines()
+    with open(output_mdp, 'w') as f:
+        for line in lines:
+            key = line.split('=')[0].strip().replace('_', '-')
+            if key not in overrides:
+                f.write(line)
+        for key, value in overrides.items():
+            f.write('{:24s} = {:s}\n'.format(key, value))
+
+
+def parse_performance(log_file):
+    """Returns the ns/day reported in an mdrun log file."""
+    with open(log_file) as f:
+        for line in f:
+            match = re.match(r'^Performance:\s+([0-9.eE+-]+)', line)
+            if match:
+                return float(match.group(1))
+    raise RuntimeError('No performance report found in ' + log_file)
+
+
+def parse_version(version_output):
+    """Returns the version line of the output of gmx --version."""
+    for line in version_output.split('\n'):
+        if line.startswith('GROMACS version:'):
+            return line.split(':', 1)[1].strip()
+    return 'unknown'
+
+
+def mean_and_stddev(values):
+    mean = sum(values) / len(values)
+    if len(values) < 2:
+        return mean, 0.0
+    variance = sum((v - mean)**2 for v in values) / (len(values) - 1)
+    return mean, math.sqrt(variance)
+
+
+def prepare_system(gmx, system, source_path, target_dir, verbose):
+    if os.path.exists(target_dir):
+        shutil.rmtree(target_dir)
+    os.makedirs(target_dir)
+    input_dir = os.path.join(source_path, system['dir'], 'input')
+    for suffix in ['mdp', 'gro', 'top']:
+        shutil.copy2(os.path.join(input_dir, 'system.' + suffix), target_dir)
+
+    nbox = system.get('nbox', [1, 1, 1])
+    factor = nbox[0] * nbox[1] * nbox[2]
+    if factor > 1:
+        run_gmx(gmx, ['genconf', '-f', 'system.gro', '-o', 'system.gro',
+                      '-nbox'] + [str(n) for n in nbox], target_dir, verbose)
+        scale_molecule_counts(os.path.join(target_dir, 'system.top'), factor)
+
+    write_benchmark_mdp(os.path.join(target_dir, 'system.mdp'),
+                        os.path.join(target_dir, 'bench.mdp'), system['nsteps'])
+    run_gmx(gmx, ['grompp', '-f', 'bench.mdp', '-p', 'system.top', '-c', 'system.gro',
+                  '-o', 'bench.tpr', '-po', 'mdout.mdp'], target_dir, verbose)
+
+
+def run_system(gmx, target_dir, repeats, mdrun_args, verbose):
+    performance = []
+    for n in range(repeats):
+        deffnm = 'bench_{:d}'.format(n)
+        run_gmx(gmx, ['mdrun', '-s', 'bench.tpr', '-deffnm', deffnm,
+                      '-resethway', '-noconfout'] + mdrun_args, target_dir, verbose)
+        performance.append(parse_performance(os.path.join(target_dir, deffnm + '.log')))
+    return performance
+
+
+def compare_to_baseline(results, baseline, tolerance, sigma):
+    """Prints a comparison of results with baseline and returns the names of regressed systems."""
+    regressed = []
+    print('{:20s} {:>12s} {:>12s} {:>9s}'.format('system', 'baseline', 'current', 'change'))
+    for name, result in results['systems'].items():
+        if name not in baseline['systems']:
+            print('{:20s} {:>12s} {:12.3f}'.format(name, '-', result['mean']))
+            continue
+        base = baseline['systems'][name]
+        change = (result['mean'] - base['mean']) / base['mean']
+        stderr = math.sqrt(base['stddev']**2 / len(base['ns_per_day'])
+                           + result['stddev']**2 / len(result['ns_per_day']))
+        drop = base['mean'] - result['mean']
+        is_regressed = (-change > tolerance and drop > sigma * stderr)
+        print('{:20s} {:12.3f} {:12.3f} {:8.1f}%{:s}'.format(
+            name, base['mean'], result['mean'], 100 * change,
+            '  REGRESSION' if is_regressed else ''))
+        if is_regressed:
+            regressed.append(name)
+    return regressed
+
+
+def main(args):
+    parser = argparse.ArgumentParser(
+        description='Performance regression benchmarks for GROMACS mdrun.',
+        prog='gmx_perfbenchmarks.py',
+        formatter_class=argparse.RawTextHelpFormatter
+    )
+    parser.add_argument('--json', type=str, metavar='systems.json',
+                        default=os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                                             'systems.json'),
+                        help='Json file containing the benchmark systems.')
+    parser.add_argument('--gmx', type=str, metavar='exe', default=None,
+                        help='GROMACS executable. Default: Trying to use \'gmx\'.')
+    parser.add_argument('--bindir', type=str, metavar='dir', default=None,
+                        help=('GROMACS binary directory.\n' +
+                              'If set, trying to use \'bindir/gmx\' instead of plain \'gmx\'\n' +
+                              'Note: If --gmx is set, --bindir and --suffix are ignored.'))
+    parser.add_argument('--suffix', type=str, metavar='_s', default=None,
+                        help=('Suffix of the GROMACS executable.\n' +
+                              'If set, trying to use \'gmx_s\' instead of plain \'gmx\'\n' +
+                              'Note: If --gmx is set, --bindir and --suffix are ignored.'))
+    parser.add_argument('-s', '--system', action='append', dest='systems', metavar='system',
+                        help=('Specify which system to run. Several systems can be specified\n' +
+                              'by chaining several \'-s\' arguments. Default: all systems.'))
+    parser.add_argument('-n', '--repeats', type=int, metavar='n', default=3,
+                        help='Number of runs per system. Default: 3.')
+    parser.add_argument('--mdrun-args', type=str, metavar='args', default='',
+                        help='Extra arguments passed to mdrun, e.g. \'-nb gpu -ntomp 8\'.')
+    parser.add_argument('-o', '--output', type=str, metavar='results.json',
+                        default='perfbenchmarks.json',
+                        help='File to write the results to. Default: perfbenchmarks.json.')
+    parser.add_argument('-b', '--baseline', type=str, metavar='baseline.json', default=None,
+                        help='Results of an earlier run to compare against.')
+    parser.add_argument('-t', '--tolerance', type=float, default=0.05,
+                        help='Relative drop in ns/day counted as regression. Default: 0.05.')
+    parser.add_argument('--sigma', type=float, default=2.0,
+                        help=('Number of standard errors the drop needs to exceed\n' +
+                              'to count as regression. Default: 2.'))
+    parser.add_argument('--wd', '--working_dir', type=str, metavar='dir', default=None,
+                        help='Working directory (default: current directory)')
+    parser.add_argument('-v', '--verbose', default=False, action='store_true',
+                        help='Print the commands that are run.')
+
+    args = parser.parse_args(args)
+
+    # the input files of the physical validation suite are reused
+    source_path = os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                               os.pardir, 'physicalvalidation', 'systems')
+    target_path = os.getcwd() if args.wd is None else args.wd
+
+    if args.gmx:
+        gmx = args.gmx
+    else:
+        gmx = 'gmx'
+        if args.suffix:
+            gmx += args.suffix
+        if args.bindir:
+            gmx = os.path.join(args.bindir, gmx)
+        gmx = os.path.abspath(gmx) if os.path.dirname(gmx) else gmx
+
+    with open(args.json) as f:
+        systems = json.load(f)
+    if args.systems:
+        systems = [s for s in systems
+                   if any(re.match(pattern + '$', s['name']) for pattern in args.systems)]
+        if not systems:
+            raise ValueError('No system matching ' + ', '.join(args.systems))
+
+    results = {
+        'host': socket.gethostname(),
+        'version': parse_version(run_gmx(gmx, ['--version'], os.getcwd())),
+        'mdrun_args': args.mdrun_args,
+        'systems': {}
+    }
+    for system in systems:
+        print('Running benchmark ' + system['name'] + '... ', end='')
+        sys.stdout.flush()
+        target_dir = os.path.join(target_path, system['name'])
+        prepare_system(gmx, system, source_path, target_dir, args.verbose)
+        performance = run_system(gmx, target_dir, args.repeats, args.mdrun_args.split(),
+                                 args.verbose)
+        mean, stddev = mean_and_stddev(performance)
+        results['systems'][system['name']] = {
+            'ns_per_day': performance,
+            'mean': mean,
+            'stddev': stddev
+        }
+        print('{:.3f} +/- {:.3f} ns/day'.format(mean, stddev))
+
+    with open(args.output, 'w') as f:
+        json.dump(results, f, indent=2)
+    print('Results written to ' + args.output)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressed = compare_to_baseline(results, baseline, args.tolerance, args.sigma)
+        if regressed:
+            print('Performance regression in: ' + ', '.join(regressed))
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))